@@ -35,9 +35,15 @@ onnxruntime_add_static_library(onnxruntime_mlas
   ${MLAS_SRC_DIR}/threading.cpp
   ${MLAS_SRC_DIR}/sgemm.cpp
   ${MLAS_SRC_DIR}/halfgemm.cpp
+  ${MLAS_SRC_DIR}/bf16gemm.cpp
+  ${MLAS_SRC_DIR}/q4bitgemm.cpp
+  ${MLAS_SRC_DIR}/flashattn.cpp
+  ${MLAS_SRC_DIR}/layernorm.cpp
+  ${MLAS_SRC_DIR}/reduce.cpp
   ${MLAS_SRC_DIR}/qgemm.cpp
   ${MLAS_SRC_DIR}/qdwconv.cpp
   ${MLAS_SRC_DIR}/convolve.cpp
+  ${MLAS_SRC_DIR}/convwinograd.cpp
   ${MLAS_SRC_DIR}/convsym.cpp
   ${MLAS_SRC_DIR}/pooling.cpp
   ${MLAS_SRC_DIR}/transpose.cpp
@@ -165,15 +171,28 @@ function(setup_mlas_source_for_windows)
     )
     set_source_files_properties(${mlas_platform_srcs_avx2} PROPERTIES COMPILE_FLAGS "/arch:AVX2")
 
+    set_source_files_properties(${MLAS_SRC_DIR}/halfgemm_kernel_avx2.cpp PROPERTIES COMPILE_FLAGS "/arch:AVX2")
+    set_source_files_properties(${MLAS_SRC_DIR}/bf16gemm_kernel_avx2.cpp PROPERTIES COMPILE_FLAGS "/arch:AVX2")
+    set_source_files_properties(${MLAS_SRC_DIR}/q4bitgemm_kernel_avx2.cpp PROPERTIES COMPILE_FLAGS "/arch:AVX2")
+
     target_sources(onnxruntime_mlas PRIVATE
       ${MLAS_SRC_DIR}/dgemm.cpp
       ${mlas_platform_srcs_avx}
       ${mlas_platform_srcs_avx2}
+      ${MLAS_SRC_DIR}/halfgemm_kernel_avx2.cpp
+      ${MLAS_SRC_DIR}/bf16gemm_kernel_avx2.cpp
+      ${MLAS_SRC_DIR}/bf16gemm_kernel_avx512bf16.cpp
+      ${MLAS_SRC_DIR}/bf16gemm_kernel_amx.cpp
+      ${MLAS_SRC_DIR}/q4bitgemm_kernel_avx2.cpp
+      ${MLAS_SRC_DIR}/q4bitgemm_kernel_avx512.cpp
       ${MLAS_SRC_DIR}/qgemm_kernel_amx.cpp
       ${MLAS_SRC_DIR}/qgemm_kernel_avx2.cpp
       ${MLAS_SRC_DIR}/qgemm_kernel_sse.cpp
       ${MLAS_SRC_DIR}/qgemm_kernel_sse41.cpp
       ${MLAS_SRC_DIR}/intrinsics/avx512/quantize_avx512f.cpp
+      ${MLAS_SRC_DIR}/intrinsics/avx512/layernorm_avx512f.cpp
+      ${MLAS_SRC_DIR}/intrinsics/avx512/reduce_avx512f.cpp
+      ${MLAS_SRC_DIR}/intrinsics/avx512/sgemm_smallm_avx512f.cpp
       ${MLAS_SRC_DIR}/amd64/QgemmU8S8KernelAmx.asm
       ${MLAS_SRC_DIR}/amd64/QgemmU8S8KernelAvx2.asm
       ${MLAS_SRC_DIR}/amd64/QgemmU8U8KernelAvx2.asm
@@ -516,6 +535,9 @@ else()
           ${MLAS_SRC_DIR}/x86_64/ErfKernelFma3.S
           ${MLAS_SRC_DIR}/intrinsics/avx2/qladd_avx2.cpp
           ${MLAS_SRC_DIR}/intrinsics/avx2/qdwconv_avx2.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx2/layernorm_avx2.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx2/reduce_avx2.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx2/sgemm_smallm_avx2.cpp
         )
         set_source_files_properties(${mlas_platform_srcs_avx2} PROPERTIES COMPILE_FLAGS "-mavx2 -mfma")
 
@@ -526,6 +548,9 @@ else()
           ${MLAS_SRC_DIR}/x86_64/SpoolKernelAvx512F.S
           ${MLAS_SRC_DIR}/x86_64/TransKernelAvx512F.S
           ${MLAS_SRC_DIR}/intrinsics/avx512/quantize_avx512f.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx512/layernorm_avx512f.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx512/reduce_avx512f.cpp
+          ${MLAS_SRC_DIR}/intrinsics/avx512/sgemm_smallm_avx512f.cpp
         )
         set_source_files_properties(${mlas_platform_srcs_avx512f} PROPERTIES COMPILE_FLAGS "-mavx512f")
 
@@ -537,11 +562,20 @@ else()
         )
         set_source_files_properties(${mlas_platform_srcs_avx512core} PROPERTIES COMPILE_FLAGS "-mavx512bw -mavx512dq -mavx512vl")
 
+        set_source_files_properties(${MLAS_SRC_DIR}/halfgemm_kernel_avx2.cpp PROPERTIES COMPILE_FLAGS "-mavx2 -mfma -mf16c")
+        set_source_files_properties(${MLAS_SRC_DIR}/bf16gemm_kernel_avx2.cpp PROPERTIES COMPILE_FLAGS "-mavx2 -mfma")
+        set_source_files_properties(${MLAS_SRC_DIR}/q4bitgemm_kernel_avx2.cpp PROPERTIES COMPILE_FLAGS "-mavx2 -mfma")
+        set_source_files_properties(${MLAS_SRC_DIR}/q4bitgemm_kernel_avx512.cpp PROPERTIES COMPILE_FLAGS "-mfma -mavx512f -mavx512bw -mavx512dq -mavx512vl -mavx512vnni")
+
         set(mlas_platform_srcs
           ${MLAS_SRC_DIR}/activate_fp16.cpp
           ${MLAS_SRC_DIR}/dwconv.cpp
           ${MLAS_SRC_DIR}/dgemm.cpp
           ${MLAS_SRC_DIR}/pooling_fp16.cpp
+          ${MLAS_SRC_DIR}/halfgemm_kernel_avx2.cpp
+          ${MLAS_SRC_DIR}/bf16gemm_kernel_avx2.cpp
+          ${MLAS_SRC_DIR}/q4bitgemm_kernel_avx2.cpp
+          ${MLAS_SRC_DIR}/q4bitgemm_kernel_avx512.cpp
           ${MLAS_SRC_DIR}/qgemm_kernel_avx2.cpp
           ${mlas_platform_srcs_sse2}
           ${mlas_platform_srcs_avx}
@@ -550,14 +584,41 @@ else()
           ${mlas_platform_srcs_avx512core}
         )
 
+        # AVX512-FP16 needs both compiler and assembler support.
+        include(CheckCXXSourceCompiles)
+        set(CMAKE_REQUIRED_FLAGS "-mavx512fp16")
+        check_cxx_source_compiles("
+          #include <immintrin.h>
+          int main() {
+            __m512h acc = _mm512_setzero_ph();
+            acc = _mm512_fmadd_ph(acc, acc, acc);
+            return _mm512_cvtsh_h(acc) == 0 ? 0 : 1;
+          }"
+          MLAS_AVX512FP16_SUPPORTED
+        )
+        unset(CMAKE_REQUIRED_FLAGS)
+
+        if(MLAS_AVX512FP16_SUPPORTED)
+          set(mlas_platform_srcs
+            ${mlas_platform_srcs}
+            ${MLAS_SRC_DIR}/halfgemm_kernel_avx512fp16.cpp
+          )
+          set_source_files_properties(${MLAS_SRC_DIR}/halfgemm_kernel_avx512fp16.cpp PROPERTIES COMPILE_FLAGS "-mavx512fp16 -mavx512bw -mavx512dq -mavx512vl")
+          target_compile_definitions(onnxruntime_mlas PRIVATE MLAS_AVX512FP16_SUPPORTED)
+        endif()
+
         if(MLAS_AMX_SUPPORTED)
           set(mlas_platform_srcs
             ${mlas_platform_srcs}
             ${MLAS_SRC_DIR}/qgemm_kernel_amx.cpp
             ${MLAS_SRC_DIR}/x86_64/QgemmU8S8KernelAmx.S
+            ${MLAS_SRC_DIR}/bf16gemm_kernel_avx512bf16.cpp
+            ${MLAS_SRC_DIR}/bf16gemm_kernel_amx.cpp
           )
           set_source_files_properties(${MLAS_SRC_DIR}/qgemm_kernel_amx.cpp PROPERTIES COMPILE_FLAGS "-mamx-tile -mamx-int8 -mavx2 -mavx512bw -mavx512dq -mavx512vl")
           set_source_files_properties(${MLAS_SRC_DIR}/x86_64/QgemmU8S8KernelAmx.S PROPERTIES COMPILE_FLAGS "-mamx-tile -mamx-int8 -mavx2 -mavx512bw -mavx512dq -mavx512vl")
+          set_source_files_properties(${MLAS_SRC_DIR}/bf16gemm_kernel_avx512bf16.cpp PROPERTIES COMPILE_FLAGS "-mavx512bf16 -mavx512bw -mavx512dq -mavx512vl")
+          set_source_files_properties(${MLAS_SRC_DIR}/bf16gemm_kernel_amx.cpp PROPERTIES COMPILE_FLAGS "-mamx-tile -mamx-bf16 -mavx512bf16 -mavx512bw -mavx512dq -mavx512vl")
         endif()
 
         if(ONNXRUNTIME_MLAS_MULTI_ARCH)
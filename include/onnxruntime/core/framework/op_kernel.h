@@ -132,6 +132,24 @@ class OpKernel {
     return Status::OK();
   }
 
+  // Override this function to allow the pre-packed weights stored in an ORT format model to be used instead of
+  // calling PrePack() for the tensor.
+  // The kernel should perform the same checks and set the same metadata as PrePack() does for the tensor, but
+  // without allocating or packing any buffers. If is_restored is set to true, UseSharedPrePackedBuffers() will be
+  // called next with the stored buffers, which are in the same order that PrePack() produced them.
+  // If is_restored is left as false, the stored buffers are ignored and PrePack() is called as usual.
+  // @param tensor: The initialized constant tensor
+  // @param input_idx: The input index of the tensor in this kernel
+  // @param prepacked_buffer_sizes: The sizes in bytes of the stored pre-packed buffers. The kernel should check that
+  //                                these match what PrePack() would produce for the tensor.
+  // @param is_restored: Set it to true if the kernel can use the stored pre-packed buffers.
+  virtual Status RestorePrePackState(const Tensor& /*tensor*/, int /*input_idx*/,
+                                     gsl::span<const size_t> /*prepacked_buffer_sizes*/,
+                                     /*out*/ bool& is_restored) {
+    is_restored = false;
+    return Status::OK();
+  }
+
   const OrtMemoryInfo& Allocator(OrtMemType mem_type) const;
   const OpKernelInfo& Info() const {
     return *op_kernel_info_;
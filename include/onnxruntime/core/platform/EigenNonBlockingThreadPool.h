@@ -32,7 +32,9 @@
 #pragma warning(disable : 4127)
 #pragma warning(disable : 4805)
 #endif
+#include <algorithm>
 #include <memory>
+#include <vector>
 #include "unsupported/Eigen/CXX11/ThreadPool"
 
 #if defined(__GNUC__)
@@ -762,6 +764,24 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
       ComputeCoprimes(i, &all_coprimes_.back());
     }
 
+    // Group the workers by NUMA node if the node of each worker is known.
+    if (std::any_of(thread_options.numa_nodes.begin(), thread_options.numa_nodes.end(),
+                    [](int numa_node) { return numa_node >= 0; })) {
+      ORT_ENFORCE(thread_options.numa_nodes.size() >= num_threads_,
+                  "The NUMA node of each thread must be specified");
+      worker_numa_node_.assign(thread_options.numa_nodes.begin(), thread_options.numa_nodes.begin() + num_threads_);
+      for (auto i = 0u; i < num_threads_; i++) {
+        const int numa_node = worker_numa_node_[i];
+        if (numa_node < 0) {
+          continue;
+        }
+        if (static_cast<size_t>(numa_node) >= numa_node_workers_.size()) {
+          numa_node_workers_.resize(static_cast<size_t>(numa_node) + 1);
+        }
+        numa_node_workers_[numa_node].push_back(i);
+      }
+    }
+
     // Eigen::MaxSizeVector has neither essential exception safety features
     // such as swap, nor it is movable. So we have to join threads right here
     // on exception
@@ -789,7 +809,9 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
 
   void Schedule(std::function<void()> fn) override {
     PerThread* pt = GetPerThread();
-    int q_idx = Rand(&pt->rand) % num_threads_;
+    const auto* node_workers = GetNumaNodeWorkers(pt->numa_node);
+    int q_idx = node_workers ? (*node_workers)[Rand(&pt->rand) % node_workers->size()]
+                             : Rand(&pt->rand) % num_threads_;
     WorkerData& td = worker_data_[q_idx];
     Queue& q = td.queue;
     fn = q.PushBack(std::move(fn));
@@ -923,6 +945,17 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     EndParallelSectionInternal(*pt, ps);
   }
 
+  // Set the NUMA node that work submitted by the calling thread is
+  // bound to, returning the previous value.  -1 removes the binding.
+  // The binding applies to any pool with workers on that node.
+
+  static int SetCurrentThreadNumaNode(int numa_node) {
+    PerThread* pt = GetPerThread();
+    int previous_numa_node = pt->numa_node;
+    pt->numa_node = numa_node;
+    return previous_numa_node;
+  }
+
   //----------------------------------------------------------------------
   //
   // Preferred workers
@@ -1024,8 +1057,16 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   //   From that point onwards, the two main threads will dispatch tasks
   //   to separate workers, avoiding the need for further work stealing.
 
-  void InitializePreferredWorkers(InlinedVector<int>& preferred_workers) {
+  void InitializePreferredWorkers(PerThread& pt) {
     static std::atomic<unsigned> next_worker{0};
+    auto& preferred_workers = pt.preferred_workers;
+
+    // If the thread has been bound to a different NUMA node since the
+    // hints were recorded then start over with workers on the new node.
+    if (pt.preferred_workers_numa_node != pt.numa_node) {
+      preferred_workers.clear();
+      pt.preferred_workers_numa_node = pt.numa_node;
+    }
 
     // preferred_workers[0] isn't supposed to be used, so initializing it with -1 to:
     // a) fault if inappropriately accessed
@@ -1036,8 +1077,13 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
 
     // preferred_workers maps from a par_idx to a q_idx, hence we
     // initialize slots in the range [0,num_threads_]
+    const auto* node_workers = GetNumaNodeWorkers(pt.numa_node);
     while (preferred_workers.size() <= num_threads_) {
-      preferred_workers.push_back(next_worker++ % num_threads_);
+      if (node_workers) {
+        preferred_workers.push_back((*node_workers)[next_worker++ % node_workers->size()]);
+      } else {
+        preferred_workers.push_back(next_worker++ % num_threads_);
+      }
     }
   }
 
@@ -1087,7 +1133,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
         ps.tasks.push_back({q_idx, w_idx});
         td.EnsureAwake();
         if (push_status == PushResult::ACCEPTED_BUSY) {
-          worker_data_[Rand(&pt.rand) % num_threads_].EnsureAwake();
+          worker_data_[RandomWorkerNear(pt, q_idx)].EnsureAwake();
         }
       }
     }
@@ -1134,8 +1180,8 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     // the size of the vector and recording the locations that tasks run
     // in as they complete.
     assert(new_dop <= (unsigned)(num_threads_ + 1));
+    InitializePreferredWorkers(pt);
     auto& preferred_workers = pt.preferred_workers;
-    InitializePreferredWorkers(preferred_workers);
 
     // current_dop is the degree of parallelism via any workers already
     // participating in the current parallel section.  Usually, for
@@ -1190,7 +1236,7 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
         if (push_status == PushResult::ACCEPTED_IDLE || push_status == PushResult::ACCEPTED_BUSY) {
           dispatch_td.EnsureAwake();
           if (push_status == PushResult::ACCEPTED_BUSY) {
-            worker_data_[Rand(&pt.rand) % num_threads_].EnsureAwake();
+            worker_data_[RandomWorkerNear(pt, ps.dispatch_q_idx)].EnsureAwake();
           }
         } else {
           ps.dispatch_q_idx = -1;  // failed to enqueue dispatch_task
@@ -1347,6 +1393,8 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     int thread_id{-1};                // Worker thread index in pool.
     Tag tag{};                        // Work item tag used to identify this thread.
     bool leading_par_section{false};  // Leading a parallel section (used only for asserts)
+    int numa_node{-1};                // NUMA node that work from this thread is bound to, or -1.
+    int preferred_workers_numa_node{-1};  // NUMA node that preferred_workers were selected for.
 
     // When this thread is entering a parallel section, it will
     // initially push work to this set of workers.  The aim is to
@@ -1470,6 +1518,11 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
   std::atomic<unsigned> blocked_;  // Count of blocked workers, used as a termination condition
   std::atomic<bool> done_;
 
+  // NUMA node of each worker, and the workers on each node.  Both are
+  // empty if the pool is not NUMA-aware.
+  std::vector<int> worker_numa_node_;
+  std::vector<std::vector<unsigned>> numa_node_workers_;
+
   // SpinLoopStatus indicates whether the main worker spinning (inner) loop should exit immediately when there is
   // no work available (kIdle) or whether it should follow the configured spin-then-block policy (kBusy).
   // This lets the ORT session layer hint to the thread pool that it should stop spinning in between
@@ -1501,6 +1554,10 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     bool should_exit = false;
     pt->pool = this;
     pt->thread_id = thread_id;
+    if (!worker_numa_node_.empty()) {
+      // Work submitted from within a worker stays on its node
+      pt->numa_node = worker_numa_node_[thread_id];
+    }
 
     assert(td.GetStatus() == WorkerData::ThreadStatus::Spinning);
 
@@ -1610,15 +1667,70 @@ class ThreadPoolTempl : public onnxruntime::concurrency::ExtendedThreadPoolInter
     }
   }
 
+  // Returns the workers on the given NUMA node, or nullptr if the pool
+  // is not NUMA-aware or has no workers on the node.
+
+  const std::vector<unsigned>* GetNumaNodeWorkers(int numa_node) const {
+    if (numa_node < 0 || static_cast<size_t>(numa_node) >= numa_node_workers_.size() ||
+        numa_node_workers_[numa_node].empty()) {
+      return nullptr;
+    }
+    return &numa_node_workers_[numa_node];
+  }
+
+  // Pick a random worker on the same NUMA node as worker q_idx, or any
+  // worker if the node is not known.
+
+  unsigned RandomWorkerNear(PerThread& pt, unsigned q_idx) {
+    const auto* node_workers = worker_numa_node_.empty() ? nullptr : GetNumaNodeWorkers(worker_numa_node_[q_idx]);
+    if (node_workers) {
+      return (*node_workers)[Rand(&pt.rand) % node_workers->size()];
+    }
+    return Rand(&pt.rand) % num_threads_;
+  }
+
   // Steal tries to steal work from other worker threads in a
   // best-effort manner.  We steal only from threads that are running
   // in user code (ThreadStatus::Active).  The intuition behind this
   // is that the thread is busy with other work, and we will avoid
   // "snatching" work from a thread which is just about to notice the
   // work itself.
+  //
+  // In a NUMA-aware pool we first try to steal from workers on the
+  // same node as the caller, avoiding remote memory traffic for the
+  // stolen task.  Spinning workers (TRY_ONE) only steal from their own
+  // node; a worker that has just woken up (TRY_ALL) will fall back to
+  // stealing from any node.
 
   Task Steal(StealAttemptKind steal_kind) {
     PerThread* pt = GetPerThread();
+    const auto* node_workers = GetNumaNodeWorkers(pt->numa_node);
+    if (node_workers) {
+      unsigned size = static_cast<unsigned>(node_workers->size());
+      unsigned num_attempts = (steal_kind == StealAttemptKind::TRY_ALL) ? size : 1;
+      unsigned r = Rand(&pt->rand);
+      unsigned inc = all_coprimes_[size - 1][r % all_coprimes_[size - 1].size()];
+      unsigned victim = r % size;
+
+      for (unsigned i = 0; i < num_attempts; i++) {
+        WorkerData& td = worker_data_[(*node_workers)[victim]];
+        if (td.GetStatus() == WorkerData::ThreadStatus::Active) {
+          Task t = td.queue.PopBack();
+          if (t) {
+            return t;
+          }
+        }
+        victim += inc;
+        if (victim >= size) {
+          victim -= size;
+        }
+      }
+
+      if (steal_kind != StealAttemptKind::TRY_ALL) {
+        return Task();
+      }
+    }
+
     unsigned size = num_threads_;
     unsigned num_attempts = (steal_kind == StealAttemptKind::TRY_ALL) ? size : 1;
     unsigned r = Rand(&pt->rand);
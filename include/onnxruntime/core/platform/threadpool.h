@@ -214,6 +214,24 @@ class ThreadPool {
     ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ParallelSection);
   };
 
+  // Binds the work submitted by the calling thread to the threads on the given NUMA node for the
+  // lifetime of the object.  This only has an effect on thread pools that were created with the
+  // NUMA node of each thread (see ThreadOptions::numa_nodes), and on which the node has threads.
+  // Work submitted by an unbound thread is distributed across all the threads in the pool.
+  //
+  // A negative numa_node leaves the current binding unchanged.  Bindings may be nested.
+
+  class NumaNodeBinding {
+  public:
+    explicit NumaNodeBinding(int numa_node);
+    ~NumaNodeBinding();
+
+  private:
+    const bool active_;
+    int previous_numa_node_{-1};
+    ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NumaNodeBinding);
+  };
+
   // The below API allows to disable spinning
   // This is used to support real-time scenarios where
   // spinning between relatively infrequent requests
@@ -280,6 +280,7 @@ ORT_RUNTIME_CLASS(DnnlProviderOptions);
 ORT_RUNTIME_CLASS(Op);
 ORT_RUNTIME_CLASS(OpAttr);
 ORT_RUNTIME_CLASS(Logger);
+ORT_RUNTIME_CLASS(PreparedRun);
 
 #ifdef _WIN32
 typedef _Return_type_success_(return == 0) OrtStatus* OrtStatusPtr;
@@ -657,6 +658,17 @@ typedef void (*OrtCustomJoinThreadFn)(OrtCustomThreadHandle ort_custom_thread_ha
 
 typedef OrtStatus*(ORT_API_CALL* RegisterCustomOpsFn)(OrtSessionOptions* options, const OrtApiBase* api);
 
+/** \brief Callback function for OrtApi::RunAsync
+ *
+ * \param[in] user_data The user_data passed to OrtApi::RunAsync
+ * \param[in] outputs On success, the ::OrtValue%s of the outputs in the order of the output names. nullptr on error.
+ *     Values that were allocated by ONNX Runtime must be released with OrtApi::ReleaseValue
+ * \param[in] num_outputs Number of elements in the outputs array. Zero on error.
+ * \param[in] status nullptr on success, otherwise the error. Must be released with OrtApi::ReleaseStatus
+ */
+typedef void(ORT_API_CALL* RunAsyncCallbackFn)(void* user_data, OrtValue** outputs, size_t num_outputs,
+                                               OrtStatusPtr status);
+
 /** \brief The C API
  *
  * All C API functions are defined inside this structure as pointers to functions.
@@ -2710,6 +2722,12 @@ struct OrtApi {
    *  Only relevant if arena strategy is `kNextPowerOfTwo`. Use -1 to allow ORT to choose the default.
    *  Ultimately, the allocation size is determined by the allocation memory request.
    *  Further allocation sizes are governed by the arena extend strategy.
+   * "thread_cache_size_bytes": Maximum number of bytes of freed memory each per-thread cache of the arena can hold.
+   *  Allocations smaller than 1MB that are freed are kept in the cache of the freeing thread and reused by later
+   *  allocations on that thread without taking the arena lock. This reduces contention when many threads share
+   *  the arena, e.g. concurrent Run() calls on a session using a shared CPU arena.
+   *  While the cache is enabled each allocation uses 256 additional bytes, and the cache is only used by CPU arenas.
+   *  Use -1 to allow ORT to choose the default. Default is 0, which disables the cache.
    *
    * \param[in] arena_config_keys Keys to configure the arena
    * \param[in] arena_config_values Values to configure the arena
@@ -4151,6 +4169,138 @@ struct OrtApi {
    */
   ORT_API2_STATUS(GetOptionalContainedTypeInfo, _In_ const OrtOptionalTypeInfo* optional_type_info,
                   _Outptr_ OrtTypeInfo** out);
+
+  /// \name OrtPreparedRun
+  /// @{
+
+  /** \brief Create an ::OrtPreparedRun instance
+   *
+   * An OrtPreparedRun binds a set of input and output names to a session ahead of time.
+   * The names are validated and resolved once, so OrtApi::RunPrepared only needs the input and output values.
+   * This avoids the per call name lookups done by OrtApi::Run, which matters for small models run at a high rate.
+   *
+   * An OrtPreparedRun holds per run state, so it must not be used by concurrent OrtApi::RunPrepared calls.
+   * Create one instance per thread if the session is run concurrently.
+   * It must be released before the session that created it.
+   *
+   * \param[in] session
+   * \param[in] input_names Array of null terminated UTF8 encoded strings of the input names
+   * \param[in] input_len Number of elements in the input_names array
+   * \param[in] output_names Array of null terminated UTF8 encoded strings of the output names
+   * \param[in] output_names_len Number of elements in the output_names array
+   * \param[out] out Newly created ::OrtPreparedRun. Must be released with OrtApi::ReleasePreparedRun
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.15.
+   */
+  ORT_API2_STATUS(CreatePreparedRun, _Inout_ OrtSession* session,
+                  _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  _Outptr_ OrtPreparedRun** out);
+
+  /** \brief Run the model with the inputs and outputs bound by an ::OrtPreparedRun
+   *
+   * \see OrtApi::Run
+   *
+   * \param[in] session The session that created prepared_run
+   * \param[in] run_options If nullptr, will use a default ::OrtRunOptions
+   * \param[in] prepared_run
+   * \param[in] inputs Array of ::OrtValue%s of the input values, in the order of the input names prepared_run
+   *     was created with
+   * \param[in] input_len Number of elements in the inputs array
+   * \param[out] outputs Array of ::OrtValue%s that the outputs are stored in, in the order of the output names
+   *     prepared_run was created with. This can also be an array of nullptr values, in this case ::OrtValue
+   *     objects will be allocated and pointers to them will be set into the `outputs` array.
+   * \param[in] output_len Number of elements in the outputs array
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.15.
+   */
+  ORT_API2_STATUS(RunPrepared, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                  _Inout_ OrtPreparedRun* prepared_run,
+                  _In_reads_(input_len) const OrtValue* const* inputs, size_t input_len,
+                  _Inout_updates_all_(output_len) OrtValue** outputs, size_t output_len);
+
+  /** \brief Release an ::OrtPreparedRun obtained from OrtApi::CreatePreparedRun
+   *
+   * \since Version 1.15.
+   */
+  ORT_CLASS_RELEASE(PreparedRun);
+
+  /// @}
+  /// \name OrtPrepackedWeightsContainer
+  /// @{
+
+  /** \brief Create an ::OrtPrepackedWeightsContainer that shares pre-packed weights across processes
+   *
+   * Behaves as the container created by OrtApi::CreatePrepackedWeightsContainer, and additionally publishes each
+   * pre-packed weight to a file in the given directory. The file name is based on a hash of the pre-packed weight.
+   * If another process has already published an identical pre-packed weight, the existing file is used instead.
+   * The files are memory mapped and read from directly, so the physical memory for the pre-packed weights is shared
+   * by all processes on the host that use the same directory.
+   *
+   * Processes must use the same ONNX Runtime build and be on the same kind of hardware for the pre-packed weights to
+   * match. The content of a file is verified before it is used, and if it doesn't match the pre-packed weight is
+   * only shared within the process.
+   * The files are not removed when the container is released.
+   *
+   * \param[in] shared_directory Directory for the shared pre-packed weight files. Created if it doesn't exist.
+   * \param[out] out Newly created ::OrtPrepackedWeightsContainer. Must be freed with OrtApi::ReleasePrepackedWeightsContainer
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.15.
+   */
+  ORT_API2_STATUS(CreatePrepackedWeightsContainerWithSharedDirectory, _In_ const ORTCHAR_T* shared_directory,
+                  _Outptr_ OrtPrepackedWeightsContainer** out);
+
+  /// @}
+  /// \name Asynchronous Run
+  /// @{
+
+  /** \brief Run the model asynchronously
+   *
+   * Queues the run and returns without waiting for it. The run executes on a thread of the session, and
+   * run_async_callback is called from that thread when it completes. The inputs are referenced until then, so they
+   * may be released as soon as this function returns.
+   *
+   * The run executes on the threads of a dedicated thread pool if "session.async_run.num_threads" is set in the
+   * session options, otherwise on the threads of the intra op thread pool, which must have at least one thread in
+   * addition to the caller.
+   * If "session.async_run.max_in_flight" is set this function blocks while that many runs are in flight, so callers
+   * producing requests faster than the session can process them are throttled.
+   *
+   * Releasing the session waits for runs in flight. A run is no longer in flight when run_async_callback is called,
+   * so the callback may release the session, once this function has returned.
+   *
+   * \see OrtApi::Run
+   *
+   * \param[in] session
+   * \param[in] run_options If nullptr, will use a default ::OrtRunOptions
+   * \param[in] input_names Array of null terminated UTF8 encoded strings of the input names
+   * \param[in] input Array of ::OrtValue%s of the input values
+   * \param[in] input_len Number of elements in the input_names and inputs arrays
+   * \param[in] output_names Array of null terminated UTF8 encoded strings of the output names
+   * \param[in] output_names_len Number of elements in the output_names and outputs array
+   * \param[in] output Array of ::OrtValue%s used as pre-allocated outputs, or nullptr for the outputs to be
+   *     allocated. The array is copied, and the pre-allocated ::OrtValue%s must stay valid until the callback.
+   * \param[in] run_async_callback Called once when the run completes, unless this function returns an error.
+   * \param[in] user_data Passed to run_async_callback
+   *
+   * \snippet{doc} snippets.dox OrtStatus Return Value
+   *
+   * \since Version 1.15.
+   */
+  ORT_API2_STATUS(RunAsync, _Inout_ OrtSession* session, _In_opt_ const OrtRunOptions* run_options,
+                  _In_reads_(input_len) const char* const* input_names,
+                  _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                  _In_reads_(output_names_len) const char* const* output_names, size_t output_names_len,
+                  _Inout_updates_all_(output_names_len) OrtValue** output,
+                  _In_ RunAsyncCallbackFn run_async_callback, _In_opt_ void* user_data);
+
+  /// @}
 };
 
 /*
@@ -27,6 +27,7 @@
 #include <cstddef>
 #include <cstdio>
 #include <array>
+#include <future>
 #include <memory>
 #include <stdexcept>
 #include <string>
@@ -229,6 +230,7 @@ ORT_DEFINE_RELEASE(Status);
 ORT_DEFINE_RELEASE(OpAttr);
 ORT_DEFINE_RELEASE(Op);
 ORT_DEFINE_RELEASE(KernelInfo);
+ORT_DEFINE_RELEASE(PreparedRun);
 
 #undef ORT_DEFINE_RELEASE
 
@@ -691,6 +693,7 @@ struct ModelMetadata : detail::Base<OrtModelMetadata> {
 };
 
 struct IoBinding;
+struct PreparedRun;
 
 namespace detail {
 
@@ -773,6 +776,64 @@ struct SessionImpl : ConstSessionImpl<T> {
 
   void Run(const RunOptions& run_options, const IoBinding&);  ///< Wraps OrtApi::RunWithBinding
 
+  /** \brief Run the model with the inputs and outputs bound by a PreparedRun, returning results in an Ort allocated vector.
+   *
+   * Wraps OrtApi::RunPrepared
+   *
+   * \param[in] run_options
+   * \param[in] prepared_run PreparedRun created for this session
+   * \param[in] input_values Array of Value objects of length input_count, in the order of the input names the
+   *     PreparedRun was created with
+   * \param[in] input_count Number of inputs
+   * \param[in] output_count Number of outputs the PreparedRun was created with
+   * \return A std::vector of Value objects in the order of the output names the PreparedRun was created with
+   */
+  std::vector<Value> Run(const RunOptions& run_options, PreparedRun& prepared_run,
+                         const Value* input_values, size_t input_count, size_t output_count);
+
+  /** \brief Run the model with the inputs and outputs bound by a PreparedRun, returning results in user provided outputs
+   * Same as Run(const RunOptions&, PreparedRun&, const Value*, size_t, size_t)
+   */
+  void Run(const RunOptions& run_options, PreparedRun& prepared_run, const Value* input_values, size_t input_count,
+           Value* output_values, size_t output_count);
+
+  /** \brief Run the model asynchronously, calling a callback when it completes.
+   *
+   * Wraps OrtApi::RunAsync
+   *
+   * \param[in] run_options
+   * \param[in] input_names Array of null terminated strings of length input_count that is the list of input names
+   * \param[in] input_values Array of Value objects of length input_count that is the list of input values
+   * \param[in] input_count Number of inputs (the size of the input_names & input_values arrays)
+   * \param[in] output_names Array of C style strings of length output_count that is the list of output names
+   * \param[in] output_values Array of Value objects of length output_count. Empty Value objects are allocated and
+   *     passed to the callback, which owns them.
+   * \param[in] output_count Number of outputs (the size of the output_names & output_values arrays)
+   * \param[in] callback Called once from a thread of the session when the run completes
+   * \param[in] user_data Passed to callback
+   */
+  void RunAsync(const RunOptions& run_options, const char* const* input_names, const Value* input_values,
+                size_t input_count, const char* const* output_names, Value* output_values, size_t output_count,
+                RunAsyncCallbackFn callback, void* user_data);
+
+#ifndef ORT_NO_EXCEPTIONS
+  /** \brief Run the model asynchronously, returning a future for the outputs.
+   *
+   * Wraps OrtApi::RunAsync. If the run fails, the future throws an Ort::Exception from get().
+   *
+   * \param[in] run_options
+   * \param[in] input_names Array of null terminated strings of length input_count that is the list of input names
+   * \param[in] input_values Array of Value objects of length input_count that is the list of input values
+   * \param[in] input_count Number of inputs (the size of the input_names & input_values arrays)
+   * \param[in] output_names Array of C style strings of length output_count that is the list of output names
+   * \param[in] output_count Number of outputs (the size of the output_names array)
+   * \return A future for the Value objects that directly map to the output_names array
+   */
+  std::future<std::vector<Value>> RunAsync(const RunOptions& run_options, const char* const* input_names,
+                                           const Value* input_values, size_t input_count,
+                                           const char* const* output_names, size_t output_count);
+#endif
+
   /** \brief End profiling and return a copy of the profiling file name.
    *
    * \param allocator to allocate memory for the copy of the string returned
@@ -1486,6 +1547,15 @@ struct IoBinding : detail::IoBindingImpl<OrtIoBinding> {
   UnownedIoBinding GetUnowned() const { return UnownedIoBinding{this->p_}; }
 };
 
+/** \brief Wrapper around ::OrtPreparedRun
+ *
+ */
+struct PreparedRun : detail::Base<OrtPreparedRun> {
+  explicit PreparedRun(std::nullptr_t) {}  ///< Create an empty object for convenience. Sometimes, we want to initialize members later.
+  PreparedRun(Session& session, const char* const* input_names, size_t input_count,
+              const char* const* output_names, size_t output_count);  ///< Wraps OrtApi::CreatePreparedRun
+};
+
 /*! \struct Ort::ArenaCfg
  * \brief it is a structure that represents the configuration of an arena based allocator
  * \details Please see docs/C_API.md for details
@@ -372,6 +372,11 @@ inline IoBinding::IoBinding(Session& session) {
   ThrowOnError(GetApi().CreateIoBinding(session, &this->p_));
 }
 
+inline PreparedRun::PreparedRun(Session& session, const char* const* input_names, size_t input_count,
+                                const char* const* output_names, size_t output_count) {
+  ThrowOnError(GetApi().CreatePreparedRun(session, input_names, input_count, output_names, output_count, &this->p_));
+}
+
 inline ArenaCfg::ArenaCfg(size_t max_mem, int arena_extend_strategy, int initial_chunk_size_bytes, int max_dead_bytes_per_chunk) {
   ThrowOnError(GetApi().CreateArenaCfg(max_mem, arena_extend_strategy, initial_chunk_size_bytes, max_dead_bytes_per_chunk, &p_));
 }
@@ -914,6 +919,81 @@ inline void SessionImpl<T>::Run(const RunOptions& run_options, const IoBinding&
   ThrowOnError(GetApi().RunWithBinding(this->p_, run_options, io_binding));
 }
 
+template <typename T>
+inline std::vector<Value> SessionImpl<T>::Run(const RunOptions& run_options, PreparedRun& prepared_run,
+                                              const Value* input_values, size_t input_count,
+                                              size_t output_count) {
+  std::vector<Value> output_values;
+  output_values.reserve(output_count);
+  for (size_t i = 0; i < output_count; i++)
+    output_values.emplace_back(nullptr);
+  Run(run_options, prepared_run, input_values, input_count, output_values.data(), output_count);
+  return output_values;
+}
+
+template <typename T>
+inline void SessionImpl<T>::Run(const RunOptions& run_options, PreparedRun& prepared_run,
+                                const Value* input_values, size_t input_count,
+                                Value* output_values, size_t output_count) {
+  static_assert(sizeof(Value) == sizeof(OrtValue*), "Value is really just an array of OrtValue* in memory, so we can reinterpret_cast safely");
+  auto ort_input_values = reinterpret_cast<const OrtValue* const*>(input_values);
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values);
+  ThrowOnError(GetApi().RunPrepared(this->p_, run_options, prepared_run, ort_input_values, input_count,
+                                    ort_output_values, output_count));
+}
+
+template <typename T>
+inline void SessionImpl<T>::RunAsync(const RunOptions& run_options, const char* const* input_names,
+                                     const Value* input_values, size_t input_count, const char* const* output_names,
+                                     Value* output_values, size_t output_count, RunAsyncCallbackFn callback,
+                                     void* user_data) {
+  static_assert(sizeof(Value) == sizeof(OrtValue*), "Value is really just an array of OrtValue* in memory, so we can reinterpret_cast safely");
+  auto ort_input_values = reinterpret_cast<const OrtValue* const*>(input_values);
+  auto ort_output_values = reinterpret_cast<OrtValue**>(output_values);
+  ThrowOnError(GetApi().RunAsync(this->p_, run_options, input_names, ort_input_values, input_count, output_names,
+                                 output_count, ort_output_values, callback, user_data));
+}
+
+#ifndef ORT_NO_EXCEPTIONS
+template <typename T>
+inline std::future<std::vector<Value>> SessionImpl<T>::RunAsync(const RunOptions& run_options,
+                                                                const char* const* input_names,
+                                                                const Value* input_values, size_t input_count,
+                                                                const char* const* output_names,
+                                                                size_t output_count) {
+  using Promise = std::promise<std::vector<Value>>;
+  auto promise = std::make_unique<Promise>();
+  auto future = promise->get_future();
+
+  RunAsyncCallbackFn callback = [](void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status) {
+    std::unique_ptr<Promise> promise{static_cast<Promise*>(user_data)};
+    Status run_status{status};
+    if (!run_status.IsOK()) {
+      promise->set_exception(std::make_exception_ptr(Exception(run_status.GetErrorMessage(),
+                                                               run_status.GetErrorCode())));
+      return;
+    }
+
+    std::vector<Value> output_values;
+    output_values.reserve(num_outputs);
+    for (size_t i = 0; i < num_outputs; i++) {
+      output_values.emplace_back(outputs[i]);
+    }
+
+    promise->set_value(std::move(output_values));
+  };
+
+  // all outputs are allocated, and owned by the Value objects passed to the promise
+  std::vector<OrtValue*> ort_output_values(output_count, nullptr);
+  auto ort_input_values = reinterpret_cast<const OrtValue* const*>(input_values);
+  ThrowOnError(GetApi().RunAsync(this->p_, run_options, input_names, ort_input_values, input_count, output_names,
+                                 output_count, ort_output_values.data(), callback, promise.get()));
+  // owned by the callback from here on
+  promise.release();
+  return future;
+}
+#endif
+
 template <typename T>
 inline AllocatedStringPtr SessionImpl<T>::EndProfilingAllocated(OrtAllocator* allocator) {
   char* out = nullptr;
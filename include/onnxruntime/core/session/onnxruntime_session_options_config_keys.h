@@ -32,6 +32,16 @@ static const char* const kOrtSessionOptionsConfigLoadModelFormat = "session.load
 // If unset, format will default to ONNX unless optimized_model_filepath ends in '.ort'.
 static const char* const kOrtSessionOptionsConfigSaveModelFormat = "session.save_model_format";
 
+// Set to "1" to store the pre-packed weights of CPU EP kernels when saving an optimized model in ORT format.
+// When the model is loaded on a platform with the same ORT version and CPU features, kernels that support it will use
+// the stored pre-packed weights instead of packing the initializers again, which reduces session creation time.
+// The pre-packed weights are ignored if the platform does not match.
+// The ORT format model will be larger as both the original initializers and the pre-packed weights are stored.
+// If "session.use_ort_model_bytes_for_initializers" is also set when loading, the pre-packed weights are used
+// directly from the model bytes where possible.
+// The default is "0".
+static const char* const kOrtSessionOptionsConfigSavePrePackedWeights = "session.save_prepacked_weights";
+
 // If a value is "1", flush-to-zero and denormal-as-zero are applied. The default is "0".
 // When multiple sessions are created, a main thread doesn't override changes from succeeding session options,
 // but threads in session thread pools follow option changes.
@@ -185,6 +195,79 @@ static const char* const kNodePartitionConfigFile = "session.node_partition_conf
 //    Hence 64-65 is an invalid configuration, because a windows thread cannot be attached to processors across group boundary.
 static const char* const kOrtSessionOptionsConfigIntraOpThreadAffinities = "session.intra_op_thread_affinities";
 
+// Set to "1" to make the intra op thread pool NUMA-aware. The threads are grouped by NUMA node. Idle threads prefer
+// to steal work from threads on the same node, and work submitted by a Run that is bound to a node (see
+// "session.numa_node") is queued on the threads of that node.
+// Threads are distributed across the nodes in proportion to the number of processors on each node and are restricted
+// to the processors of their node, unless "session.intra_op_thread_affinities" is set in which case each thread is
+// assigned to the node of the first processor in its affinity.
+// Only applies to per session thread pools. Has no effect if the system has a single NUMA node.
+// The default is "0".
+static const char* const kOrtSessionOptionsConfigIntraOpNumaAware = "session.intra_op.numa_aware";
+
+// The NUMA topology to use instead of the one discovered from the system.
+// The format is "<node 0 processors>;<node 1 processors>;...", where the processors of a node use the Linux cpulist
+// format with processor ids starting from 0. e.g. "0-3;4-7" describes two nodes with four processors each.
+// This allows NUMA behavior to be emulated on a single node system, e.g. for testing.
+static const char* const kOrtSessionOptionsConfigNumaTopology = "session.numa_topology";
+
+// The id of the NUMA node to bind the session to.
+// Session initialization runs on the processors of the node, so the initializers and pre-packed weights are allocated
+// in the node's local memory. Each Run also executes on the processors of the node and its intra op work is queued
+// on the threads of that node if the intra op thread pool is NUMA-aware.
+// The default is "-1", which does not bind the session.
+static const char* const kOrtSessionOptionsConfigNumaNode = "session.numa_node";
+
+// The number of threads of a dedicated thread pool that executes the runs started with OrtApi::RunAsync.
+// If "0", the runs are executed on the threads of the intra op thread pool, which must then have at least one thread
+// in addition to the caller.
+// The default is "0".
+static const char* const kOrtSessionOptionsConfigAsyncRunNumThreads = "session.async_run.num_threads";
+
+// The maximum number of runs started with OrtApi::RunAsync that may be in flight at the same time.
+// OrtApi::RunAsync blocks the caller until a run completes if the limit is reached.
+// The default is "0", which does not limit the number of runs in flight.
+static const char* const kOrtSessionOptionsConfigAsyncRunMaxInFlight = "session.async_run.max_in_flight";
+
+// The maximum number of memory patterns cached per graph, one for each distinct set of input shapes seen by Run.
+// The least recently used pattern is evicted when the limit is reached, which bounds the memory used by the cache for
+// models with dynamic input shapes. Only applies if the memory pattern optimization is enabled.
+// The default is "0", which does not limit the number of cached patterns.
+static const char* const kOrtSessionOptionsConfigMemoryPatternCacheSize = "session.memory_pattern_cache_size";
+
+// Comma separated, strictly ascending sizes that input dims are rounded up to when looking up the memory pattern cache,
+// e.g. "16,32,64,128". Runs whose input dims round up to the same buckets share a memory pattern, so the number of
+// patterns that are generated for e.g. variable sequence lengths is bounded by the number of buckets.
+// Dims larger than the last bucket are used as-is. The input tensors themselves are not padded.
+// The default is "", which caches a pattern for each distinct set of input shapes.
+static const char* const kOrtSessionOptionsConfigMemoryPatternDimBuckets = "session.memory_pattern_dim_buckets";
+
+// Set to "1" to disable the critical path scheduler used by ExecutionMode::ORT_PARALLEL for graphs that run entirely
+// on the CPU. The scheduler runs the nodes on the inter op thread pool as soon as their inputs are ready, prioritizing
+// the nodes with the longest path of remaining work. Otherwise such a graph has a single execution stream and its
+// nodes run one after the other.
+// The default is "0".
+static const char* const kOrtSessionOptionsConfigDisableCriticalPathScheduler =
+    "session.disable_critical_path_scheduler";
+
+// Comma separated upper bounds of the symbolic dims of the model, e.g. "batch:8,sequence:512".
+// If set, the memory pattern is planned statically when the session is initialized, using the bounds to size the
+// intermediate values, instead of being traced by the first Run for each set of input shapes. Each Run then allocates
+// a single buffer per device and places the values at fixed offsets in it. Values whose shape depends on dims without
+// a bound, or that are larger than their bound at runtime, are allocated individually.
+// Only applies if the memory pattern optimization is enabled and the graph has a single execution stream.
+// The default is "", which traces the memory patterns at runtime.
+static const char* const kOrtSessionOptionsConfigStaticMemoryPlanDimBounds = "session.static_memory_plan.dim_bounds";
+
+// Set to "1" to return the outputs of the ZipMap nodes in columnar form instead of as a sequence of maps.
+// Each such output becomes the float tensor of probabilities that is the input of ZipMap, and a graph output named
+// "<output>_labels" is added after the outputs of the model, holding the class labels of its columns as a 1-D string
+// or int64 tensor. This avoids building a map per row, e.g. for scikit-learn classifiers converted with ZipMap.
+// Only applies to a ZipMap output that is a graph output of the main graph and has no consumer in the model.
+// The outputs reported by the session, e.g. by SessionGetOutputTypeInfo, describe the columnar form.
+// The default is "0".
+static const char* const kOrtSessionOptionsConfigZipMapColumnarOutput = "session.zipmap_columnar_output";
+
 // This option will dump out the model to assist debugging any issues with layout transformation,
 // and is primarily intended for developer usage. It is only relevant if an execution provider that requests
 // NHWC layout is enabled such as NNAPI, XNNPACK or QNN.
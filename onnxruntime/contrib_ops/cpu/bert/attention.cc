@@ -55,6 +55,7 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
     float,
     kCpuExecutionProvider,
     KernelDefBuilder()
+        .MayInplace(4, 1)
         .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
     Attention<float>);
 
@@ -199,6 +200,7 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
   const Tensor* mask_index = context->Input<Tensor>(3);
   const Tensor* past = context->Input<Tensor>(4);
   const Tensor* relative_position_bias = context->Input<Tensor>(5);
+  const Tensor* past_seq_len = context->Input<Tensor>(6);
 
   const TensorShape& weights_shape = (weights ? weights->Shape() : weight_shape_);
 
@@ -209,7 +211,8 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
                                   mask_index,
                                   past,
                                   relative_position_bias,
-                                  &parameters));
+                                  &parameters,
+                                  past_seq_len));
 
   const int batch_size = parameters.batch_size;
   const int sequence_length = parameters.sequence_length;
@@ -331,7 +334,7 @@ Status Attention<T>::Compute(OpKernelContext* context) const {
   return ApplyAttention(Q, K, V, mask_index, past, output,
                         batch_size, sequence_length,
                         parameters.head_size, parameters.v_head_size, parameters.v_hidden_size,
-                        relative_position_bias, context);
+                        relative_position_bias, context, past_seq_len);
 }
 }  // namespace contrib
 }  // namespace onnxruntime
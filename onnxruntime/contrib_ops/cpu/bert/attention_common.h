@@ -100,6 +100,13 @@ constexpr const char* kDisableMemoryEfficientAttention = "ORT_DISABLE_MEMORY_EFF
 // Minimum sequence length to enable memory efficient attention in FP32.
 constexpr int kMinSequenceLengthForMemoryEfficientAttentionFp32 = 256;
 
+// Environment variable to set the minimum number of attention scores of a head (sequence_length x
+// total_sequence_length) from which the CPU Attention kernel uses fused flash attention. A negative value disables it.
+constexpr const char* kMinScoreSizeForCpuFlashAttention = "ORT_CPU_FLASH_ATTENTION_MIN_SCORE_SIZE";
+
+// Default minimum number of attention scores of a head to use fused flash attention on CPU.
+constexpr int kDefaultMinScoreSizeForCpuFlashAttention = 512 * 512;
+
 }  // namespace attention
 
 }  // namespace contrib
@@ -6,9 +6,12 @@
 #include "attention_base.h"
 #include "attention_helper.h"
 
+#include <type_traits>
+
 #include "core/common/common.h"
 #include "core/common/safeint.h"
 #include "core/framework/op_kernel.h"
+#include "core/platform/env_var_utils.h"
 
 namespace onnxruntime {
 namespace contrib {
@@ -16,7 +19,10 @@ namespace contrib {
 class AttentionCPUBase : public AttentionBase {
  protected:
   AttentionCPUBase(const OpKernelInfo& info, bool require_same_hidden_size)
-  : AttentionBase(info, require_same_hidden_size) {}
+  : AttentionBase(info, require_same_hidden_size) {
+    min_score_size_for_flash_attention_ = ParseEnvironmentVariableWithDefault<int>(
+        attention::kMinScoreSizeForCpuFlashAttention, attention::kDefaultMinScoreSizeForCpuFlashAttention);
+  }
 
   template <typename T>
   Status ApplyAttention(const T* Q,                           // Q data with shape BxNxSxH
@@ -31,7 +37,8 @@ class AttentionCPUBase : public AttentionBase {
                         int v_head_size,                      // head size of V (H_v)
                         int v_hidden_size,                    // hidden size of V (D_v)
                         const Tensor* relative_position_bias, // bias addition in QK. Its size is BxNxSxT
-                        OpKernelContext* context) const {
+                        OpKernelContext* context,
+                        const Tensor* past_seq_len = nullptr) const { // past sequence length when sharing buffer
     const int kv_sequence_length = sequence_length;
 
     AllocatorPtr allocator;
@@ -40,18 +47,40 @@ class AttentionCPUBase : public AttentionBase {
     auto* tp = context->GetOperatorThreadPool();
 
     int past_sequence_length = 0;
-    Tensor* present = GetPresent(context, past, batch_size, v_head_size, sequence_length, past_sequence_length);
+    int max_sequence_length = 0;  // sequence length of the present buffer shared with past, 0 if not shared
+    Tensor* present = nullptr;
+    if (past_present_share_buffer_ && past != nullptr) {
+      // Present is the max length buffer of past, and K and V of the inputs are appended in place after
+      // past_sequence_length positions instead of concatenating the whole past state.
+      ORT_RETURN_IF(past_seq_len == nullptr, "past_sequence_length is required when past_present_share_buffer is set");
+      past_sequence_length = *past_seq_len->Data<int32_t>();
+      max_sequence_length = static_cast<int>(past->Shape().GetDims()[3]);
+      present = context->Output(1, past->Shape());
+      ORT_RETURN_IF(present == nullptr, "Expect to have present state output when past state input is given");
+    } else {
+      present = GetPresent(context, past, batch_size, v_head_size, sequence_length, past_sequence_length);
+    }
 
     // Total sequence length including that of past state: T = P + L
     const int total_sequence_length = past_sequence_length + kv_sequence_length;
 
+    bool has_unidirectional = (is_unidirectional_ && sequence_length > 1);
+
+    // Long sequences use the fused kernel, which does not materialize the BxNxSxT attention probabilities.
+    if constexpr (std::is_same<T, float>::value) {
+      if (UseFlashAttention(sequence_length, total_sequence_length, mask_index)) {
+        return ApplyFlashAttention(Q, K, V, mask_index, past, present, output,
+                                   batch_size, sequence_length, past_sequence_length, max_sequence_length,
+                                   qk_head_size == 0 ? v_head_size : qk_head_size, v_head_size,
+                                   has_unidirectional, relative_position_bias, allocator, tp);
+      }
+    }
+
     // Compute the attention score.
     size_t bytes = SafeInt<size_t>(batch_size) * num_heads_ * sequence_length * total_sequence_length * sizeof(T);
     auto attention_probs = allocator->Alloc(bytes);
     BufferUniquePtr scratch_buffer(attention_probs, BufferDeleter(allocator));
 
-    bool has_unidirectional = (is_unidirectional_ && sequence_length > 1);
-
     void* mask_data = nullptr;
     if (mask_index != nullptr || has_unidirectional) {
       size_t mask_data_bytes = SafeInt<size_t>(batch_size) * sequence_length * total_sequence_length * sizeof(T);
@@ -74,7 +103,7 @@ class AttentionCPUBase : public AttentionBase {
 
     ComputeAttentionProbs<T>(static_cast<T*>(attention_probs), Q, K,
                              mask_index_data, mask_index_dims, static_cast<T*>(mask_data), has_unidirectional,
-                             batch_size, sequence_length, past_sequence_length,
+                             batch_size, sequence_length, past_sequence_length, max_sequence_length,
                              qk_head_size == 0 ? v_head_size : qk_head_size,
                              past_data, present_data, tp, relative_position_bias_data);
 
@@ -86,13 +115,145 @@ class AttentionCPUBase : public AttentionBase {
     ComputeVxAttentionScore(output->MutableData<T>(), static_cast<T*>(out_tmp_data),
                             static_cast<T*>(attention_probs), V,
                             batch_size, sequence_length, kv_sequence_length, past_sequence_length,
-                            v_head_size, v_hidden_size,
+                            max_sequence_length, v_head_size, v_hidden_size,
                             past_data, present_data, tp);
 
     return Status::OK();
   }
 
  private:
+  int min_score_size_for_flash_attention_;  // minimum S x T of a head to use the fused kernel, negative to disable it
+
+  bool UseFlashAttention(int sequence_length, int total_sequence_length, const Tensor* mask_index) const {
+    // 4D mask is not supported by the fused kernel.
+    if (mask_index != nullptr && mask_index->Shape().NumDimensions() == 4) {
+      return false;
+    }
+    return min_score_size_for_flash_attention_ >= 0 &&
+           static_cast<int64_t>(sequence_length) * total_sequence_length >= min_score_size_for_flash_attention_;
+  }
+
+  // Computes the attention with MlasFlashAttention, tiling the queries against blocks of keys with an online
+  // softmax. The mask is converted to an additive mask of (Bx)T for key padding or (Bx)SxT for a 3D mask, and the
+  // unidirectional mask is applied by the kernel.
+  Status ApplyFlashAttention(const float* Q,                        // Q data with shape BxNxSxH
+                             const float* K,                        // K data with shape BxNxLxH
+                             const float* V,                        // V value with size BxNxLxH_v
+                             const Tensor* mask_index,              // mask index. nullptr if no mask
+                             const Tensor* past,                    // past state
+                             Tensor* present,                       // present state
+                             Tensor* output,                        // output tensor with shape BxSxNxH_v
+                             int batch_size,                        // batch size (B)
+                             int sequence_length,                   // sequence length (S)
+                             int past_sequence_length,              // sequence length of past state (P)
+                             int max_sequence_length,               // sequence length of shared present (M) or 0
+                             int qk_head_size,                      // head size of Q or K (H)
+                             int v_head_size,                       // head size of V (H_v)
+                             bool has_unidirectional,               // has unidirectional mask
+                             const Tensor* relative_position_bias,  // bias addition in QK. Its size is (B or 1)xNxSxT
+                             AllocatorPtr allocator,
+                             ThreadPool* tp) const {
+    const int total_sequence_length = past_sequence_length + sequence_length;  // T = P + L
+    const std::ptrdiff_t loop_len = SafeInt<std::ptrdiff_t>(batch_size) * num_heads_;
+
+    const float* k = K;
+    const float* v = V;
+    if (present != nullptr) {
+      // Concatenate past and current K and V: (BxNx)PxH, (BxNx)LxH -> (BxNx)TxH, or append current K and V to
+      // the shared buffer: (BxNx)LxH -> (BxNx)MxH at position P
+      const bool share_buffer = max_sequence_length > 0;
+      const int buffer_sequence_length = share_buffer ? max_sequence_length : total_sequence_length;
+      const int past_buffer_sequence_length = share_buffer ? max_sequence_length : past_sequence_length;
+
+      const float* past_data = past != nullptr ? past->Data<float>() : nullptr;
+      float* present_data = present->MutableData<float>();
+      const float* past_v = past_data != nullptr ? past_data + loop_len * past_buffer_sequence_length * v_head_size
+                                                 : nullptr;
+      float* present_v = present_data + loop_len * buffer_sequence_length * v_head_size;
+
+      const size_t past_k_chunk_length = static_cast<size_t>(past_sequence_length) * qk_head_size;
+      const size_t past_v_chunk_length = static_cast<size_t>(past_sequence_length) * v_head_size;
+      const size_t input_k_chunk_length = static_cast<size_t>(sequence_length) * qk_head_size;
+      const size_t input_v_chunk_length = static_cast<size_t>(sequence_length) * v_head_size;
+      const size_t max_k_chunk_length = static_cast<size_t>(max_sequence_length) * qk_head_size;
+      const size_t max_v_chunk_length = static_cast<size_t>(max_sequence_length) * v_head_size;
+
+      const double cost = static_cast<double>(share_buffer ? sequence_length : total_sequence_length) *
+                          (qk_head_size + v_head_size);
+      ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+        for (std::ptrdiff_t i = begin; i != end; ++i) {
+          if (share_buffer) {
+            AppendStateChunk(past_data, K + input_k_chunk_length * i, present_data,
+                             past_k_chunk_length, input_k_chunk_length, max_k_chunk_length, i);
+            AppendStateChunk(past_v, V + input_v_chunk_length * i, present_v,
+                             past_v_chunk_length, input_v_chunk_length, max_v_chunk_length, i);
+          } else {
+            ConcatStateChunk(past_data, K + input_k_chunk_length * i, present_data,
+                             past_k_chunk_length, past_k_chunk_length + input_k_chunk_length, i);
+            ConcatStateChunk(past_v, V + input_v_chunk_length * i, present_v,
+                             past_v_chunk_length, past_v_chunk_length + input_v_chunk_length, i);
+          }
+        }
+      });
+
+      k = present_data;
+      v = present_v;
+    }
+
+    MLAS_FLASH_ATTENTION_PARAMS params;
+    params.BatchSize = static_cast<size_t>(batch_size);
+    params.NumHeads = static_cast<size_t>(num_heads_);
+    params.SequenceLength = static_cast<size_t>(sequence_length);
+    params.KvSequenceLength = static_cast<size_t>(total_sequence_length);
+    params.QkHeadSize = static_cast<size_t>(qk_head_size);
+    params.VHeadSize = static_cast<size_t>(v_head_size);
+    params.Scale = scale_ == 0.0f ? 1.0f / sqrt(static_cast<float>(qk_head_size)) : scale_;
+    params.Query = Q;
+    params.Key = k;
+    params.Value = v;
+    params.KvBufferSequenceLength = (present != nullptr) ? static_cast<size_t>(max_sequence_length) : 0;
+    params.Causal = has_unidirectional;
+    params.CausalMaskValue = mask_filter_value_;
+    params.Output = output->MutableData<float>();
+
+    void* mask_data = nullptr;
+    if (mask_index != nullptr) {
+      gsl::span<const int64_t> mask_index_dims = mask_index->Shape().GetDims();
+      if (mask_index_dims.size() == 3) {
+        size_t mask_data_bytes = SafeInt<size_t>(batch_size) * sequence_length * total_sequence_length * sizeof(float);
+        mask_data = allocator->Alloc(mask_data_bytes);
+        memset(mask_data, 0, mask_data_bytes);
+        PrepareMask(mask_index->Data<int32_t>(), mask_index_dims, static_cast<float*>(mask_data),
+                    false, batch_size, sequence_length, past_sequence_length, mask_filter_value_);
+        params.MaskBatchStride = static_cast<size_t>(sequence_length) * total_sequence_length;
+        params.MaskRowStride = static_cast<size_t>(total_sequence_length);
+      } else {
+        // The key padding mask is the same for all queries: build one row per batch, as for a single query
+        // at the last position.
+        size_t mask_data_bytes = SafeInt<size_t>(batch_size) * total_sequence_length * sizeof(float);
+        mask_data = allocator->Alloc(mask_data_bytes);
+        memset(mask_data, 0, mask_data_bytes);
+        PrepareMask(mask_index->Data<int32_t>(), mask_index_dims, static_cast<float*>(mask_data),
+                    false, batch_size, 1, total_sequence_length - 1, mask_filter_value_);
+        params.MaskBatchStride = static_cast<size_t>(total_sequence_length);
+        params.MaskRowStride = 0;
+      }
+      params.Mask = static_cast<const float*>(mask_data);
+    }
+    BufferUniquePtr mask_data_buffer(mask_data, BufferDeleter(std::move(allocator)));
+
+    if (relative_position_bias != nullptr) {
+      params.Bias = relative_position_bias->Data<float>();
+      params.BiasBatchStride = relative_position_bias->Shape()[0] == 1
+                                   ? 0
+                                   : static_cast<size_t>(num_heads_) * sequence_length * total_sequence_length;
+    }
+
+    MlasFlashAttention(&params, tp);
+
+    return Status::OK();
+  }
+
   // Helper function to compute the attention probs. It does 2 things:
   //  attention_probs(B, N, S, T) = 1/sqrt(H) x Q(B, N, S, H) x K'(B, N, T, H -> B, N, H, T) +
   //                                1 x mask_data(B, N, S, T)
@@ -108,6 +269,7 @@ class AttentionCPUBase : public AttentionBase {
                              int batch_size,                            // batch size of self-attention
                              int sequence_length,                       // sequence length of self-attention
                              int past_sequence_length,                  // sequence length of past state
+                             int max_sequence_length,                   // sequence length of shared present or 0
                              int head_size,                             // head size of self-attention
                              const T* past,                             // past state
                              T* present,                                // present state
@@ -118,6 +280,7 @@ class AttentionCPUBase : public AttentionBase {
     const size_t past_chunk_length = static_cast<size_t>(past_sequence_length) * head_size;  // P x H
     const size_t input_chunk_length = static_cast<size_t>(sequence_length) * head_size;      // L x H
     const size_t present_chunk_length = past_chunk_length + input_chunk_length;              // T x H
+    const size_t max_chunk_length = static_cast<size_t>(max_sequence_length) * head_size;    // M x H
 
     {
       // mask_data is nullptr when mask_index is nullptr and not unidirectional, otherwise its shape is BxSxT
@@ -151,7 +314,10 @@ class AttentionCPUBase : public AttentionBase {
           }
 
           const T* k = K + input_chunk_length * i;
-          if (nullptr != present) {
+          if (nullptr != present && max_sequence_length > 0) {
+            // Append K to the shared buffer: (BxNx)LxH -> (BxNx)MxH at position P
+            k = AppendStateChunk(past, k, present, past_chunk_length, input_chunk_length, max_chunk_length, i);
+          } else if (nullptr != present) {
             // Concatenate past_K and K : (BxNx)PxH, (BxNx)LxH -> (BxNx)TxH
             k = ConcatStateChunk(past, k, present, past_chunk_length, present_chunk_length, i);
           }
@@ -201,6 +367,7 @@ class AttentionCPUBase : public AttentionBase {
                                int sequence_length,       // sequence length
                                int kv_sequence_length,    // sequence length of K or V
                                int past_sequence_length,  // sequence length in past state
+                               int max_sequence_length,   // sequence length of shared present state or 0
                                int v_head_size,           // head size of V (H_v)
                                int v_hidden_size,         // hidden size of V (D_v)
                                const T* past,             // past state
@@ -210,13 +377,17 @@ class AttentionCPUBase : public AttentionBase {
     const ptrdiff_t past_chunk_length = SafeInt<ptrdiff_t>(past_sequence_length) * v_head_size;  // P x H_v
     const ptrdiff_t input_chunk_length = SafeInt<ptrdiff_t>(kv_sequence_length) * v_head_size;   // L x H_v
     const ptrdiff_t present_chunk_length = past_chunk_length + input_chunk_length;               // T x H_v
+    const ptrdiff_t max_chunk_length = SafeInt<ptrdiff_t>(max_sequence_length) * v_head_size;    // M x H_v
 
     // Move the pointer of past and present to start of v values.
+    const bool share_buffer = max_sequence_length > 0;
     if (nullptr != past) {
-      past += SafeInt<ptrdiff_t>(batch_size) * num_heads_ * past_sequence_length * v_head_size;
+      past += SafeInt<ptrdiff_t>(batch_size) * num_heads_ * (share_buffer ? max_sequence_length : past_sequence_length) *
+              v_head_size;
     }
     if (nullptr != present) {
-      present += SafeInt<ptrdiff_t>(batch_size) * num_heads_ * total_sequence_length * v_head_size;
+      present += SafeInt<ptrdiff_t>(batch_size) * num_heads_ *
+                 (share_buffer ? max_sequence_length : total_sequence_length) * v_head_size;
     }
 
     const double cost =
@@ -225,7 +396,10 @@ class AttentionCPUBase : public AttentionBase {
     ThreadPool::TryParallelFor(tp, SafeInt<ptrdiff_t>(batch_size) * num_heads_, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
       for (std::ptrdiff_t i = begin; i != end; ++i) {
         const T* v = V + input_chunk_length * i;
-        if (nullptr != present) {
+        if (nullptr != present && share_buffer) {
+          // Append V to the shared buffer: (BxNx)LxH_v -> (BxNx)MxH_v at position P
+          v = AppendStateChunk(past, v, present, past_chunk_length, input_chunk_length, max_chunk_length, i);
+        } else if (nullptr != present) {
           // Concatenate past_V and V: (BxNx)PxH_v, (BxNx)LxH_v -> (BxNx)TxH_v
           v = ConcatStateChunk(past, v, present, past_chunk_length, present_chunk_length, i);
         }
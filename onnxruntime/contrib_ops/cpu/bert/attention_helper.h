@@ -173,5 +173,26 @@ T* ConcatStateChunk(const T* past,
   return start;
 }
 
+// Append an input state chunk LxH at position P of a present state chunk MxH, where M is the max sequence length of
+// a present state buffer shared with the past state. Past state is only copied when it is not the same buffer.
+// Returns a pointer to the start of present state chunk.
+template <typename T>
+T* AppendStateChunk(const T* past,
+                    const T* chunk,
+                    T* present,
+                    size_t past_chunk_length,
+                    size_t input_chunk_length,
+                    size_t max_chunk_length,
+                    std::ptrdiff_t i) {
+  T* start = present + i * max_chunk_length;
+
+  if (nullptr != past && past != present) {
+    memcpy(start, past + i * max_chunk_length, max_chunk_length * sizeof(T));
+  }
+
+  memcpy(start + past_chunk_length, chunk, input_chunk_length * sizeof(T));
+  return start;
+}
+
 }  // namespace contrib
 }  // namespace onnxruntime
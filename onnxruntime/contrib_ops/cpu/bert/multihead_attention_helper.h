@@ -213,6 +213,10 @@ Status CheckInputs(const T* query,
       }
     } else if (mask_dims.size() == 2 && mask_dims[0] == static_cast<int64_t>(batch_size) && mask_dims[1] == static_cast<int64_t>(kv_sequence_length)) {
       mask_type = AttentionMaskType::MASK_2D_KEY_PADDING;
+    } else if (mask_dims.size() == 2 && past_present_share_buffer && mask_dims[0] == static_cast<int64_t>(batch_size) &&
+               mask_dims[1] == static_cast<int64_t>(past_sequence_length) + kv_sequence_length) {
+      // When past and present share buffer, the key padding mask covers the past state as well.
+      mask_type = AttentionMaskType::MASK_2D_KEY_PADDING;
     }
 
     if (mask_type == AttentionMaskType::MASK_UNKNOWN) {
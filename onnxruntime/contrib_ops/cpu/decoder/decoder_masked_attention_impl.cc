@@ -0,0 +1,152 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/decoder/decoder_masked_attention_impl.h"
+
+#include <cmath>
+
+#include "core/common/safeint.h"
+#include "core/mlas/inc/mlas.h"
+
+using onnxruntime::concurrency::ThreadPool;
+
+namespace onnxruntime {
+namespace contrib {
+
+namespace {
+
+// Calls fn(source_batch_index, start, length) for each run of cache positions [0, T) of a batch entry that are read
+// from the same beam, so that every run is a contiguous block of rows in the caches.
+// Without cache indirection, there is a single run from the batch entry itself. With it, position t < P comes from
+// the beam given by the cache indirection, and the new token at position P always comes from the entry itself.
+template <typename Fn>
+void ForEachCacheRun(const DecoderMaskedAttentionData& data, int batch_index, int past_sequence_length,
+                     int total_sequence_length, int max_sequence_length, Fn&& fn) {
+  if (data.cache_indir == nullptr || data.is_cross_attention) {
+    fn(batch_index, 0, total_sequence_length);
+    return;
+  }
+
+  const int32_t* beams = data.cache_indir + static_cast<ptrdiff_t>(batch_index) * max_sequence_length;
+  const int first_beam_index = (batch_index / data.beam_width) * data.beam_width;
+
+  int start = 0;
+  while (start < past_sequence_length) {
+    int end = start + 1;
+    while (end < past_sequence_length && beams[end] == beams[start]) {
+      end++;
+    }
+    fn(first_beam_index + beams[start], start, end - start);
+    start = end;
+  }
+
+  fn(batch_index, past_sequence_length, total_sequence_length - past_sequence_length);
+}
+
+}  // namespace
+
+Status ComputeDecoderMaskedAttention(const AttentionParameters& parameters,
+                                     const DecoderMaskedAttentionData& data,
+                                     AllocatorPtr allocator,
+                                     ThreadPool* tp) {
+  const int batch_size = parameters.batch_size;
+  const int num_heads = parameters.num_heads;
+  const int head_size = parameters.head_size;
+  const int v_head_size = parameters.v_head_size;
+  const int past_sequence_length = data.is_cross_attention ? 0 : parameters.past_sequence_length;
+  const int total_sequence_length = parameters.total_sequence_length;
+  const int max_sequence_length = parameters.max_sequence_length;
+  const float scale = parameters.scale == 0.0f ? 1.0f / std::sqrt(static_cast<float>(head_size)) : parameters.scale;
+
+  if (data.cache_indir != nullptr && !data.is_cross_attention) {
+    for (int b = 0; b < batch_size; b++) {
+      const int32_t* beams = data.cache_indir + static_cast<ptrdiff_t>(b) * max_sequence_length;
+      for (int t = 0; t < past_sequence_length; t++) {
+        if (beams[t] < 0 || beams[t] >= data.beam_width) {
+          return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                                 "cache_indirection value ", beams[t], " is out of range of beam width ",
+                                 data.beam_width);
+        }
+      }
+    }
+  }
+
+  // Scores of the cached tokens, one row of T for each batch and head.
+  const std::ptrdiff_t loop_len = SafeInt<std::ptrdiff_t>(batch_size) * num_heads;
+  auto scores_data = allocator->Alloc(SafeInt<size_t>(loop_len) * total_sequence_length * sizeof(float));
+  BufferUniquePtr scores_buffer(scores_data, BufferDeleter(std::move(allocator)));
+
+  const size_t k_chunk_length = static_cast<size_t>(max_sequence_length) * head_size;    // M x H
+  const size_t v_chunk_length = static_cast<size_t>(max_sequence_length) * v_head_size;  // M x H_v
+
+  const double cost = static_cast<double>(total_sequence_length) * (head_size + v_head_size);
+
+  ThreadPool::TryParallelFor(tp, loop_len, cost, [&](std::ptrdiff_t begin, std::ptrdiff_t end) {
+    for (std::ptrdiff_t i = begin; i != end; ++i) {
+      const int batch_index = static_cast<int>(i / num_heads);
+      const int head_index = static_cast<int>(i % num_heads);
+
+      const float* q = data.q + i * head_size;
+      float* output = data.output + i * v_head_size;
+      float* scores = static_cast<float*>(scores_data) + i * total_sequence_length;
+
+      // Write K and V of the new token in place at position P: (BxN)xH -> (BxNx)MxH
+      if (!data.is_cross_attention) {
+        memcpy(data.k_cache + i * k_chunk_length + static_cast<size_t>(past_sequence_length) * head_size,
+               data.k + i * head_size, head_size * sizeof(float));
+        memcpy(data.v_cache + i * v_chunk_length + static_cast<size_t>(past_sequence_length) * v_head_size,
+               data.v + i * v_head_size, v_head_size * sizeof(float));
+      }
+
+      // scores(1, T) = scale x q(1, H) x K'(H, T), one GEMV for each run of keys from the same beam.
+      ForEachCacheRun(data, batch_index, past_sequence_length, total_sequence_length, max_sequence_length,
+                      [&](int source_batch_index, int start, int length) {
+                        const float* k = data.k_cache +
+                                         (static_cast<size_t>(source_batch_index) * num_heads + head_index) *
+                                             k_chunk_length +
+                                         static_cast<size_t>(start) * head_size;
+                        MlasGemm(CblasNoTrans, CblasTrans, 1, length, head_size,
+                                 scale, q, head_size, k, head_size,
+                                 0.0f, scores + start, length, nullptr);
+                      });
+
+      if (data.mask != nullptr) {
+        const int32_t* mask = data.mask + static_cast<ptrdiff_t>(batch_index) * total_sequence_length;
+        for (int t = 0; t < total_sequence_length; t++) {
+          if (mask[t] == 0) {
+            scores[t] += parameters.mask_filter_value;
+          }
+        }
+      }
+
+      if (data.relative_position_bias != nullptr) {
+        const float* bias = data.relative_position_bias +
+                            (parameters.broadcast_res_pos_bias ? head_index : i) * total_sequence_length;
+        for (int t = 0; t < total_sequence_length; t++) {
+          scores[t] += bias[t];
+        }
+      }
+
+      MlasComputeSoftmax(scores, scores, 1, total_sequence_length, false, nullptr);
+
+      // output(1, H_v) = scores(1, T) x V(T, H_v), accumulated over the runs of values from the same beam.
+      bool first_run = true;
+      ForEachCacheRun(data, batch_index, past_sequence_length, total_sequence_length, max_sequence_length,
+                      [&](int source_batch_index, int start, int length) {
+                        const float* v = data.v_cache +
+                                         (static_cast<size_t>(source_batch_index) * num_heads + head_index) *
+                                             v_chunk_length +
+                                         static_cast<size_t>(start) * v_head_size;
+                        MlasGemm(CblasNoTrans, CblasNoTrans, 1, v_head_size, length,
+                                 1.0f, scores + start, length, v, v_head_size,
+                                 first_run ? 0.0f : 1.0f, output, v_head_size, nullptr);
+                        first_run = false;
+                      });
+    }
+  });
+
+  return Status::OK();
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
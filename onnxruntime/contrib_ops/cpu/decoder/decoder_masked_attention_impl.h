@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/allocator.h"
+#include "core/platform/threadpool.h"
+#include "contrib_ops/cpu/bert/attention_common.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+// Inputs and outputs of the single token attention of DecoderMaskedSelfAttention and DecoderMaskedMultiHeadAttention.
+// Unlike CUDA, the key cache is not reordered, so the caches have the same layout as the past state.
+struct DecoderMaskedAttentionData {
+  const float* q = nullptr;                       // query with shape (B, 1, N x H)
+  const float* k = nullptr;                       // key of the new token with shape (B, 1, N x H), or nullptr
+  const float* v = nullptr;                       // value of the new token with shape (B, 1, N x H_v), or nullptr
+  float* k_cache = nullptr;                       // key cache with shape (B, N, M, H)
+  float* v_cache = nullptr;                       // value cache with shape (B, N, M, H_v)
+  const int32_t* mask = nullptr;                  // raw attention mask with shape (B, T), 0 for a hidden key
+  const float* relative_position_bias = nullptr;  // bias with shape (B or 1, N, 1, T)
+  const int32_t* cache_indir = nullptr;           // source beam of each cache position with shape (B / W, W, M)
+  int beam_width = 1;                             // beam width (W)
+  bool is_cross_attention = false;                // whether the caches are the key and value of the encoder
+  float* output = nullptr;                        // output with shape (B, 1, N x H_v)
+};
+
+// Appends the key and value of the new token to the caches at past_sequence_length, unless it is cross attention,
+// then computes the attention of the query with the T = past_sequence_length + 1 cached tokens. Work is partitioned
+// across batches and heads.
+Status ComputeDecoderMaskedAttention(const AttentionParameters& parameters,
+                                     const DecoderMaskedAttentionData& data,
+                                     AllocatorPtr allocator,
+                                     concurrency::ThreadPool* tp);
+
+}  // namespace contrib
+}  // namespace onnxruntime
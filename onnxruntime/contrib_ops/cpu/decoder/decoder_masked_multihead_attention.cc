@@ -0,0 +1,191 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/decoder/decoder_masked_multihead_attention.h"
+#include "contrib_ops/cpu/decoder/decoder_masked_attention_impl.h"
+#include "contrib_ops/cpu/bert/multihead_attention_helper.h"
+#include "core/common/safeint.h"
+
+using onnxruntime::concurrency::ThreadPool;
+
+namespace onnxruntime {
+namespace contrib {
+
+static constexpr int kPastSequenceLengthInputIndex = 7;
+static constexpr int kBeamWidthInputIndex = 8;
+static constexpr int kCacheIndirectionInputIndex = 9;
+static constexpr int kPastInputIndex = 5;
+static constexpr int kPresentOutputIndex = 1;
+
+// These ops are internal-only, so register outside of onnx
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    DecoderMaskedMultiHeadAttention,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .MayInplace(kPastInputIndex, kPresentOutputIndex)
+        .MayInplace(kPastInputIndex + 1, kPresentOutputIndex + 1)
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    DecoderMaskedMultiHeadAttention<float>);
+
+template <typename T>
+DecoderMaskedMultiHeadAttention<T>::DecoderMaskedMultiHeadAttention(const OpKernelInfo& info) : OpKernel(info) {
+  int64_t num_heads = 0;
+  ORT_ENFORCE(info.GetAttr("num_heads", &num_heads).IsOK() && num_heads > 0);
+  num_heads_ = static_cast<int>(num_heads);
+  mask_filter_value_ = info.GetAttrOrDefault<float>("mask_filter_value", -10000.0f);
+  scale_ = info.GetAttrOrDefault<float>("scale", 0.0f);
+  past_present_share_buffer_ = info.GetAttrOrDefault<int64_t>("past_present_share_buffer", 0LL);
+}
+
+template <typename T>
+Status DecoderMaskedMultiHeadAttention<T>::Compute(OpKernelContext* context) const {
+  const Tensor* query = context->Input<Tensor>(0);
+  const Tensor* key = context->Input<Tensor>(1);
+  const Tensor* value = context->Input<Tensor>(2);
+  const Tensor* mask_index = context->Input<Tensor>(3);
+  const Tensor* relative_position_bias = context->Input<Tensor>(4);
+  const Tensor* past_key = context->Input<Tensor>(kPastInputIndex);
+  const Tensor* past_value = context->Input<Tensor>(kPastInputIndex + 1);
+  const Tensor* past_seq_len = context->Input<Tensor>(kPastSequenceLengthInputIndex);
+  const Tensor* beam_width = context->Input<Tensor>(kBeamWidthInputIndex);
+  const Tensor* cache_indir = context->Input<Tensor>(kCacheIndirectionInputIndex);
+
+  AttentionParameters parameters;
+  ORT_RETURN_IF_ERROR(multihead_attention_helper::CheckInputs<Tensor>(query,
+                                                                      key,
+                                                                      value,
+                                                                      nullptr,  // bias
+                                                                      mask_index,
+                                                                      relative_position_bias,
+                                                                      past_key,
+                                                                      past_value,
+                                                                      past_seq_len,
+                                                                      &parameters,
+                                                                      num_heads_,
+                                                                      mask_filter_value_,
+                                                                      scale_,
+                                                                      past_present_share_buffer_,
+                                                                      0));
+
+  // This kernel is for decoding only (i.e.) sequence length has to be 1
+  if (parameters.sequence_length != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input sequence length should be 1 to use DecoderMaskedMultiHeadAttention");
+  }
+
+  if (parameters.mask_type != AttentionMaskType::MASK_2D_KEY_PADDING &&
+      parameters.mask_type != AttentionMaskType::MASK_NONE) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "DecoderMaskedMultiHeadAttention only supports no mask or 2D key "
+                           "padding mask of shape [batch, total_seq_length] currently");
+  }
+
+  TensorShapeVector output_shape(3);
+  output_shape[0] = static_cast<int64_t>(parameters.batch_size);
+  output_shape[1] = static_cast<int64_t>(parameters.sequence_length);
+  output_shape[2] = static_cast<int64_t>(parameters.v_hidden_size);
+  Tensor* output = context->Output(0, output_shape);
+
+  DecoderMaskedAttentionData data;
+  data.q = query->Data<T>();
+  data.output = output->MutableData<T>();
+
+  if (relative_position_bias != nullptr) {
+    data.relative_position_bias = relative_position_bias->Data<T>();
+  }
+
+  // Decoder cross-attention
+  if (past_key == nullptr) {
+    if (!parameters.pass_past_in_kv) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "DecoderMaskedMultiHeadAttention requires past_key and past_value for self-attention, "
+                             "or key and value of shape (batch_size, num_heads, kv_sequence_length, head_size) "
+                             "for cross-attention");
+    }
+
+    if (relative_position_bias != nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                             "DecoderMaskedMultiHeadAttention does not support relative position bias for cross-attention");
+    }
+
+    parameters.total_sequence_length = parameters.kv_sequence_length;
+    parameters.max_sequence_length = parameters.kv_sequence_length;
+    data.is_cross_attention = true;
+    data.k_cache = const_cast<T*>(key->Data<T>());
+    data.v_cache = const_cast<T*>(value->Data<T>());
+  } else {
+    if (!past_present_share_buffer_ || past_value == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "DecoderMaskedMultiHeadAttention requires past_key and past_value to share buffer "
+                             "with present_key and present_value for self-attention");
+    }
+
+    // Present key and value have the same shape as past key and value
+    Tensor* present_key = context->Output(kPresentOutputIndex, past_key->Shape());
+    Tensor* present_value = context->Output(kPresentOutputIndex + 1, past_value->Shape());
+    if (present_key == nullptr || present_value == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "DecoderMaskedMultiHeadAttention requires present_key and present_value for self-attention");
+    }
+
+    auto* present_key_data = present_key->MutableData<T>();
+    auto* present_value_data = present_value->MutableData<T>();
+    const auto* past_key_data = past_key->Data<T>();
+    const auto* past_value_data = past_value->Data<T>();
+
+    // No production use-case will incur this copy cost as the implementation of
+    // GreedySearch/BeamSearch is written in such a way that the past and present buffers
+    // will be shared.
+    // This is just to circumvent the OpTester's limitation of not being able to bind a specific
+    // buffer to inputs/outputs.
+    if (present_key_data != past_key_data) {
+      memcpy(present_key_data, past_key_data, past_key->SizeInBytes());
+    }
+    if (present_value_data != past_value_data) {
+      memcpy(present_value_data, past_value_data, past_value->SizeInBytes());
+    }
+
+    data.k = key->Data<T>();
+    data.v = value->Data<T>();
+    data.k_cache = present_key_data;
+    data.v_cache = present_value_data;
+  }
+
+  if (parameters.mask_type == AttentionMaskType::MASK_2D_KEY_PADDING) {
+    data.mask = mask_index->Data<int32_t>();
+  }
+
+  // Beam width (in case we are using this op inside BeamSearch)
+  if (beam_width != nullptr) {
+    data.beam_width = static_cast<int>(*beam_width->Data<int32_t>());
+  }
+
+  // Cache indirection (in case we are using this op inside BeamSearch)
+  if (data.beam_width > 1) {
+    // If beam width > 1, then cache indirection buffer MUST be present
+    if (cache_indir == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "If beam width is greater than 1, then cache indirection buffer MUST be present");
+    }
+
+    if (!data.is_cross_attention &&
+        cache_indir->Shape().Size() != static_cast<int64_t>(parameters.batch_size) * parameters.max_sequence_length) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'cache_indirection' is expected to have shape (batch_size / beam_width, "
+                             "beam_width, max_sequence_length), got ", cache_indir->Shape());
+    }
+
+    data.cache_indir = cache_indir->Data<int32_t>();
+  }
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  return ComputeDecoderMaskedAttention(parameters, data, allocator, context->GetOperatorThreadPool());
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,190 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "contrib_ops/cpu/decoder/decoder_masked_self_attention.h"
+#include "contrib_ops/cpu/decoder/decoder_masked_attention_impl.h"
+#include "core/common/safeint.h"
+#include "core/util/math.h"
+#include "core/util/math_cpuonly.h"
+
+using onnxruntime::concurrency::ThreadPool;
+
+namespace onnxruntime {
+namespace contrib {
+
+static constexpr int kPastSequenceLengthInputIndex = 6;
+static constexpr int kBeamWidthInputIndex = 7;
+static constexpr int kCacheIndirectionInputIndex = 8;
+static constexpr int kPastInputIndex = 4;
+static constexpr int kPresentOutputIndex = 1;
+
+// These ops are internal-only, so register outside of onnx
+ONNX_OPERATOR_TYPED_KERNEL_EX(
+    DecoderMaskedSelfAttention,
+    kMSDomain,
+    1,
+    float,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .MayInplace(kPastInputIndex, kPresentOutputIndex)
+        .TypeConstraint("T", DataTypeImpl::GetTensorType<float>()),
+    DecoderMaskedSelfAttention<float>);
+
+template <typename T>
+Status DecoderMaskedSelfAttention<T>::Compute(OpKernelContext* context) const {
+  const Tensor* input = context->Input<Tensor>(0);
+  const Tensor* weights = context->Input<Tensor>(1);
+  const Tensor* bias = context->Input<Tensor>(2);
+  const Tensor* mask_index = context->Input<Tensor>(3);
+  const Tensor* past = context->Input<Tensor>(kPastInputIndex);
+  const Tensor* relative_position_bias = context->Input<Tensor>(5);
+  const Tensor* past_seq_len = context->Input<Tensor>(kPastSequenceLengthInputIndex);
+  const Tensor* beam_width = context->Input<Tensor>(kBeamWidthInputIndex);
+  const Tensor* cache_indir = context->Input<Tensor>(kCacheIndirectionInputIndex);
+
+  AttentionParameters parameters;
+  ORT_RETURN_IF_ERROR(CheckInputs(input->Shape(),
+                                  weights->Shape(),
+                                  bias->Shape(),
+                                  mask_index,
+                                  past,
+                                  relative_position_bias,
+                                  &parameters,
+                                  past_seq_len));
+
+  if (!past_present_share_buffer_ || past == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "DecoderMaskedSelfAttention requires past to share buffer with present");
+  }
+
+  const int batch_size = parameters.batch_size;
+  const int sequence_length = parameters.sequence_length;
+
+  // This kernel is for decoding only (i.e.) sequence length has to be 1
+  if (sequence_length != 1) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                           "Input sequence length should be 1 to use DecoderMaskedSelfAttention");
+  }
+
+  if (parameters.mask_type != AttentionMaskType::MASK_2D_KEY_PADDING &&
+      parameters.mask_type != AttentionMaskType::MASK_NONE) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED,
+                           "DecoderMaskedSelfAttention only supports no mask or 2D key "
+                           "padding mask of shape [batch, total_seq_length] currently");
+  }
+
+  TensorShapeVector output_shape(3);
+  output_shape[0] = static_cast<int64_t>(batch_size);
+  output_shape[1] = static_cast<int64_t>(sequence_length);
+  output_shape[2] = static_cast<int64_t>(parameters.v_hidden_size);
+  Tensor* output = context->Output(0, output_shape);
+
+  // Present input will have the same shape as the past input
+  Tensor* present = context->Output(kPresentOutputIndex, past->Shape());
+
+  auto* present_data = present->MutableData<T>();
+  const auto* past_data = past->Data<T>();
+
+  // No production use-case will incur this copy cost as the implementation of
+  // GreedySearch/BeamSearch is written in such a way that the past and present buffers
+  // will be shared.
+  // This is just to circumvent the OpTester's limitation of not being able to bind a specific
+  // buffer to inputs/outputs.
+  if (present_data != past_data) {
+    memcpy(present_data, past_data, past->SizeInBytes());
+  }
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&allocator));
+
+  auto* tp = context->GetOperatorThreadPool();
+
+  // Compute Q, K, V of the new token
+  // qkv(B, D_t) = input(B, D_i) x weights(D_i, D_t) + bias(D_t), where D_t = D + D + D_v
+  const int hidden_sizes[3] = {parameters.hidden_size, parameters.hidden_size, parameters.v_hidden_size};
+  const int qkv_hidden_size = hidden_sizes[0] + hidden_sizes[1] + hidden_sizes[2];
+  auto qkv_data = allocator->Alloc(SafeInt<size_t>(batch_size) * qkv_hidden_size * sizeof(T));
+  BufferUniquePtr qkv_buffer(qkv_data, BufferDeleter(allocator));
+
+  const T* input_data = input->Data<T>();
+  const T* weights_data = weights->Data<T>();
+  const T* bias_data = bias->Data<T>();
+
+  T* QKV[3];
+  T* qkv_dest = reinterpret_cast<T*>(qkv_data);
+  int qkv_offset = 0;
+  for (int qkv_index = 0; qkv_index < 3; qkv_index++) {
+    const int hidden_size = hidden_sizes[qkv_index];
+    QKV[qkv_index] = qkv_dest;
+
+    // broadcast D -> (B.)D
+    for (int batch_index = 0; batch_index < batch_size; batch_index++) {
+      memcpy(qkv_dest + static_cast<size_t>(batch_index) * hidden_size, bias_data + qkv_offset,
+             hidden_size * sizeof(T));
+    }
+
+    math::GemmEx<float, ThreadPool>(
+        CblasNoTrans,                 // TransA = no
+        CblasNoTrans,                 // TransB = no
+        batch_size,                   // M      = B
+        hidden_size,                  // N      = D
+        parameters.input_hidden_size, // K      = D_i
+        1.0f,                         // alpha
+        input_data,                   // A
+        parameters.input_hidden_size, // lda    = D_i
+        weights_data + qkv_offset,    // B
+        qkv_hidden_size,              // ldb    = D + D + D_v
+        1.0f,                         // beta
+        qkv_dest,                     // C
+        hidden_size,                  // ldc
+        tp);
+
+    qkv_dest += static_cast<size_t>(batch_size) * hidden_size;
+    qkv_offset += hidden_size;
+  }
+
+  DecoderMaskedAttentionData data;
+  data.q = QKV[0];
+  data.k = QKV[1];
+  data.v = QKV[2];
+
+  // Half of the past/present buffer correspond to K - the other half is V.
+  data.k_cache = present_data;
+  data.v_cache = present_data + present->Shape().Size() / 2;
+  data.output = output->MutableData<T>();
+
+  if (relative_position_bias != nullptr) {
+    data.relative_position_bias = relative_position_bias->Data<T>();
+  }
+
+  if (parameters.mask_type == AttentionMaskType::MASK_2D_KEY_PADDING) {
+    data.mask = mask_index->Data<int32_t>();
+  }
+
+  // Beam width (in case we are using this op inside BeamSearch)
+  if (beam_width != nullptr) {
+    data.beam_width = static_cast<int>(*beam_width->Data<int32_t>());
+  }
+
+  // Cache indirection (in case we are using this op inside BeamSearch)
+  if (data.beam_width > 1) {
+    // If beam width > 1, then cache indirection buffer MUST be present
+    if (cache_indir == nullptr) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "If beam width is greater than 1, then cache indirection buffer MUST be present");
+    }
+
+    if (cache_indir->Shape().Size() != static_cast<int64_t>(batch_size) * parameters.max_sequence_length) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT,
+                             "Input 'cache_indirection' is expected to have shape (batch_size / beam_width, "
+                             "beam_width, max_sequence_length), got ", cache_indir->Shape());
+    }
+
+    data.cache_indir = cache_indir->Data<int32_t>();
+  }
+
+  return ComputeDecoderMaskedAttention(parameters, data, allocator, tp);
+}
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/common/common.h"
+#include "core/framework/op_kernel.h"
+#include "contrib_ops/cpu/bert/attention_base.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+template <typename T>
+class DecoderMaskedSelfAttention final : public OpKernel, public AttentionBase {
+ public:
+  explicit DecoderMaskedSelfAttention(const OpKernelInfo& info) : OpKernel(info), AttentionBase(info, true) {}
+  Status Compute(OpKernelContext* context) const override;
+};
+
+}  // namespace contrib
+}  // namespace onnxruntime
@@ -0,0 +1,115 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/narrow.h"
+#include "core/common/safeint.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+
+namespace onnxruntime {
+namespace contrib {
+
+class MatMulNBits final : public OpKernel {
+ public:
+  MatMulNBits(const OpKernelInfo& info)
+      : OpKernel(info),
+        K_{narrow<size_t>(info.GetAttr<int64_t>("K"))},
+        N_{narrow<size_t>(info.GetAttr<int64_t>("N"))},
+        block_size_{narrow<size_t>(info.GetAttr<int64_t>("block_size"))},
+        nbits_{narrow<size_t>(info.GetAttrOrDefault<int64_t>("bits", 4))},
+        accuracy_level_{info.GetAttrOrDefault<int64_t>("accuracy_level", 0)} {
+    ORT_ENFORCE(nbits_ == 4, "Only 4b quantization is supported for MatMulNBits op, additional bits support is planned.");
+    ORT_ENFORCE(block_size_ >= 16 && block_size_ <= 256 && (block_size_ & (block_size_ - 1)) == 0,
+                "block_size must be a power of 2 in [16, 256], got ", block_size_);
+    ORT_ENFORCE(accuracy_level_ >= 0 && accuracy_level_ <= 4,
+                "accuracy_level must be in [0, 4], got ", accuracy_level_);
+
+    // Level 4 is the only one that trades accuracy for speed: the activations are quantized to int8 per block.
+    compute_type_ = accuracy_level_ == 4 ? MlasQ4BitCompInt8 : MlasQ4BitCompFp32;
+  }
+
+  Status Compute(OpKernelContext* context) const override;
+
+ private:
+  const size_t K_;
+  const size_t N_;
+  const size_t block_size_;
+  const size_t nbits_;
+  const int64_t accuracy_level_;
+  MLAS_Q4BIT_COMPUTE_TYPE compute_type_;
+};
+
+Status MatMulNBits::Compute(OpKernelContext* ctx) const {
+  const Tensor* a = ctx->Input<Tensor>(0);
+  const Tensor* b = ctx->Input<Tensor>(1);
+  const Tensor* scales = ctx->Input<Tensor>(2);
+  const Tensor* zero_points = ctx->Input<Tensor>(3);
+
+  const TensorShape& a_shape = a->Shape();
+  ORT_RETURN_IF_NOT(a_shape.NumDimensions() >= 1, "Input A must have rank >= 1");
+  ORT_RETURN_IF_NOT(narrow<size_t>(a_shape[a_shape.NumDimensions() - 1]) == K_,
+                    "The last dimension of input A must equal the attribute K: ", K_);
+
+  const size_t k_blocks = (K_ + block_size_ - 1) / block_size_;
+  const size_t blob_size = block_size_ * nbits_ / 8;
+
+  ORT_RETURN_IF_NOT(narrow<size_t>(b->Shape().Size()) == SafeInt<size_t>(N_) * k_blocks * blob_size,
+                    "Input B must have shape [N, k_blocks, blob_size]: [", N_, ", ", k_blocks, ", ", blob_size,
+                    "], got ", b->Shape());
+  ORT_RETURN_IF_NOT(narrow<size_t>(scales->Shape().Size()) == SafeInt<size_t>(N_) * k_blocks,
+                    "Input scales must have N * k_blocks elements: ", N_ * k_blocks, ", got ", scales->Shape());
+  if (zero_points != nullptr) {
+    const size_t zero_point_stride = (k_blocks * nbits_ + 7) / 8;
+    ORT_RETURN_IF_NOT(narrow<size_t>(zero_points->Shape().Size()) == SafeInt<size_t>(N_) * zero_point_stride,
+                      "Input zero_points must have N * ceil(k_blocks * bits / 8) elements: ", N_ * zero_point_stride,
+                      ", got ", zero_points->Shape());
+  }
+
+  TensorShape y_shape(a_shape);
+  y_shape[y_shape.NumDimensions() - 1] = static_cast<int64_t>(N_);
+  Tensor* y = ctx->Output(0, y_shape);
+
+  // Bail out early if the output is going to be empty
+  if (y_shape.Size() == 0) {
+    return Status::OK();
+  }
+
+  const size_t M = narrow<size_t>(a_shape.SizeToDimension(a_shape.NumDimensions() - 1));
+
+  AllocatorPtr allocator;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&allocator));
+
+  const size_t workspace_size = MlasQ4BitGemmBatchWorkspaceSize(M, N_, K_, 1, block_size_, compute_type_);
+  IAllocatorUniquePtr<uint8_t> workspace;
+  if (workspace_size > 0) {
+    workspace = IAllocator::MakeUniquePtr<uint8_t>(allocator, workspace_size);
+  }
+
+  MLAS_Q4BIT_GEMM_DATA_PARAMS data;
+  data.A = a->Data<float>();
+  data.lda = K_;
+  data.QuantBData = b->Data<uint8_t>();
+  data.QuantBScale = scales->Data<float>();
+  data.QuantBZeroPoint = zero_points == nullptr ? nullptr : zero_points->Data<uint8_t>();
+  data.Bias = nullptr;
+  data.C = y->MutableData<float>();
+  data.ldc = N_;
+
+  MlasQ4BitGemmBatch(M, N_, K_, 1, block_size_, compute_type_, &data, workspace.get(),
+                     ctx->GetOperatorThreadPool());
+
+  return Status::OK();
+}
+
+ONNX_OPERATOR_KERNEL_EX(
+    MatMulNBits,
+    kMSDomain,
+    1,
+    kCpuExecutionProvider,
+    KernelDefBuilder()
+        .TypeConstraint("T1", DataTypeImpl::GetTensorType<float>())
+        .TypeConstraint("T2", DataTypeImpl::GetTensorType<uint8_t>()),
+    MatMulNBits);
+
+}  // namespace contrib
+}  // namespace onnxruntime
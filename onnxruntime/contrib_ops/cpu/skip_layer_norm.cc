@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 
 #include "core/framework/tensor.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/util/math_cpuonly.h"
 #include "core/providers/common.h"
 #include "core/platform/threadpool.h"
@@ -23,6 +24,7 @@ namespace contrib {
 
 REGISTER_KERNEL_TYPED(float)
 REGISTER_KERNEL_TYPED(double)
+REGISTER_KERNEL_TYPED(MLFloat16)
 
 template <typename T>
 SkipLayerNorm<T>::SkipLayerNorm(const OpKernelInfo& op_kernel_info)
@@ -106,47 +108,65 @@ Status SkipLayerNorm<T>::Compute(OpKernelContext* p_ctx) const {
   // of the input and skip tensors
   T* skip_input_bias_add_output_data = skip_input_bias_add_output != nullptr ? skip_input_bias_add_output->MutableData<T>() : nullptr;
 
-  concurrency::ThreadPool::TryBatchParallelFor(
-      p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(task_count),
-      [&](ptrdiff_t task_idx) {
-        auto offset = task_idx * hidden_size;
-
-        const T* p_input = input_data + offset;
-        const T* p_skip = skip_data + offset;
-        T* p_output = output_data + offset;
-        T* p_skip_input_bias_add_output_data = skip_input_bias_add_output_data != nullptr ? skip_input_bias_add_output_data + offset : nullptr;
-
-        T mean = 0;
-        T mean_square = 0;
-
-        for (int64_t h = 0; h < hidden_size; h++) {
-          T value = p_input[h] + p_skip[h];
-
-          if (nullptr != bias_data) {
-            value += bias_data[h];
+  if constexpr (std::is_same_v<T, float> || std::is_same_v<T, MLFloat16>) {
+    // The skip and bias additions are fused with the statistics of each row,
+    // and MLFloat16 rows are normalized in float.
+    MLAS_LAYER_NORM_PARAMS<T> params;
+    params.RowCount = static_cast<size_t>(task_count);
+    params.RowSize = static_cast<size_t>(hidden_size);
+    params.Epsilon = epsilon_;
+    params.Input = input_data;
+    params.Skip = skip_data;
+    params.Bias = bias_data;
+    params.Scale = gamma_data;
+    params.Shift = beta_data;
+    params.Output = output_data;
+    params.SkipOutput = skip_input_bias_add_output_data;
+    MlasLayerNorm(&params, p_ctx->GetOperatorThreadPool());
+    return Status::OK();
+  } else {
+    concurrency::ThreadPool::TryBatchParallelFor(
+        p_ctx->GetOperatorThreadPool(), static_cast<int32_t>(task_count),
+        [&](ptrdiff_t task_idx) {
+          auto offset = task_idx * hidden_size;
+
+          const T* p_input = input_data + offset;
+          const T* p_skip = skip_data + offset;
+          T* p_output = output_data + offset;
+          T* p_skip_input_bias_add_output_data = skip_input_bias_add_output_data != nullptr ? skip_input_bias_add_output_data + offset : nullptr;
+
+          T mean = 0;
+          T mean_square = 0;
+
+          for (int64_t h = 0; h < hidden_size; h++) {
+            T value = p_input[h] + p_skip[h];
+
+            if (nullptr != bias_data) {
+              value += bias_data[h];
+            }
+
+            if (nullptr != p_skip_input_bias_add_output_data) {
+              p_skip_input_bias_add_output_data[h] = value;
+            }
+
+            p_output[h] = value;
+            mean += value;
+            mean_square += value * value;
           }
 
-          if (nullptr != p_skip_input_bias_add_output_data) {
-            p_skip_input_bias_add_output_data[h] = value;
-          }
-
-          p_output[h] = value;
-          mean += value;
-          mean_square += value * value;
-        }
+          mean = mean / hidden_size;
+          mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon_);
 
-        mean = mean / hidden_size;
-        mean_square = sqrt(mean_square / hidden_size - mean * mean + epsilon_);
-
-        for (int64_t h = 0; h < hidden_size; h++) {
-          if (nullptr == beta_data) {
-            p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h];
-          } else {
-            p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h] + beta_data[h];
+          for (int64_t h = 0; h < hidden_size; h++) {
+            if (nullptr == beta_data) {
+              p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h];
+            } else {
+              p_output[h] = (p_output[h] - mean) / mean_square * gamma_data[h] + beta_data[h];
+            }
           }
-        }
-      },
-      0);
+        },
+        0);
+  }
 
   return Status::OK();
 }
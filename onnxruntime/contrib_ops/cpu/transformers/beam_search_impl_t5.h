@@ -57,7 +57,7 @@ class BeamSearchT5 : public BeamSearchBase<T> {
         expand_buffer_float16_func_(expand_buffer_float16_func),
         cuda_device_prop_(cuda_device_prop),
         cuda_device_arch_(cuda_device_arch) {
-    if (decoder_subgraph_.has_decoder_masked_attention_) {
+    if (decoder_subgraph_.has_decoder_masked_attention_ && this->IsCuda()) {
       ORT_ENFORCE(cuda_device_arch_ >= 530,
                   "Decoder masked multihead attention can only be used on "
                   "GPU cards of compute capability 5.3 or higher. "
@@ -275,7 +275,8 @@ Status BeamSearchT5<T>::Execute(const FeedsFetchesManager& encoder_feeds_fetches
       }
     }
 
-    if (decoder_subgraph_.has_decoder_masked_attention_) {
+    // There is no reorder helper on CPU, where the kernel reads the past state in its original layout.
+    if (decoder_subgraph_.has_decoder_masked_attention_ && reorder_past_state_func_) {
       size_t offset = static_cast<size_t>(decoder_subgraph_.GetFirstPastInputIndex());
       // Here we only need to reorder the past key for self-attention and cross-attention.
       for (size_t i = 0; i < 2 * static_cast<size_t>(decoder_subgraph_.num_layers); ++i) {
@@ -596,6 +596,38 @@ void PickGptPastState(const std::vector<OrtValue>& last_outputs,
   }
 }
 
+// Update the cache indirection of DecoderMaskedSelfAttention and DecoderMaskedMultiHeadAttention after the beams of
+// this step are selected. Each position of a beam refers to the beam that holds its key and value in the caches.
+static void UpdateDecoderMaskedMultiHeadAttentionCacheIndirection(int32_t* tgt_indir_cache,
+                                                                  const int32_t* src_indir_cache,
+                                                                  gsl::span<const int32_t> beam_ids,
+                                                                  int batch_size,
+                                                                  int beam_width,
+                                                                  int input_seq_length,
+                                                                  int max_seq_length,
+                                                                  int current_length) {
+  for (int bb_id = 0; bb_id < batch_size * beam_width; bb_id++) {
+    const int batch_id = bb_id / beam_width;
+    const int beam_id = bb_id % beam_width;
+    const int src_beam = beam_ids[bb_id] % beam_width;
+
+    int32_t* tgt = tgt_indir_cache + static_cast<ptrdiff_t>(bb_id) * max_seq_length;
+    const int32_t* src = src_indir_cache + (static_cast<ptrdiff_t>(batch_id) * beam_width + src_beam) * max_seq_length;
+
+    for (int time_step = 0; time_step < current_length; time_step++) {
+      if (time_step < input_seq_length) {
+        // The input sequence is the same for all the beams, so it always comes from beam 0.
+        tgt[time_step] = 0;
+      } else if (time_step == current_length - 1) {
+        // The newly generated token is written to the caches of the beam itself.
+        tgt[time_step] = beam_id;
+      } else {
+        tgt[time_step] = src[time_step];
+      }
+    }
+  }
+}
+
 template <typename T>
 Status UpdateGptFeeds(
     AllocatorPtr allocator,
@@ -619,8 +651,6 @@ Status UpdateGptFeeds(
   // next_inputs: input_ids, position_id, attention_mask, past_0, past_1
   ORT_UNUSED_PARAMETER(stream);
   ORT_UNUSED_PARAMETER(beam_indices_gpu);
-  ORT_UNUSED_PARAMETER(input_sequence_len);
-  ORT_UNUSED_PARAMETER(need_cache_indir);
 
   // The following updates inputs for subgraph
 
@@ -664,8 +694,37 @@ Status UpdateGptFeeds(
   next_inputs[2] = attention_mask;
 
   if (past_present_share_buffer) {
-    int32_t* past_seq_len_data = const_cast<int32_t*>(next_inputs.back().Get<Tensor>().Data<int32_t>());
-    *past_seq_len_data = past_sequence_len;
+    // Update past sequence length input
+    const int past_sequence_length_idx = (static_cast<int>(last_outputs.size()) - gpt_subgraph_first_present_output_idx) +
+                                         gpt_subgraph_first_past_input_idx;
+    *(next_inputs[past_sequence_length_idx].GetMutable<Tensor>()->MutableData<int32_t>()) = past_sequence_len;
+
+    // Update beam search specific input for DecoderMaskedSelfAttention (cache indirection) if present
+    if (need_cache_indir) {
+      // The cache indirection feed comes 2 feeds after the `past_sequence_length` feed
+      const OrtValue& old_cache_indirection = next_inputs[past_sequence_length_idx + 2];
+
+      // New cache indirection updated for next decoding run
+      OrtValue cache_indirection;
+      Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(), old_cache_indirection.Get<Tensor>().Shape(), allocator,
+                           cache_indirection);
+
+      // The third index of the past/present tensor is the max_sequence_length
+      int max_sequence_length =
+          static_cast<int>(last_outputs[gpt_subgraph_first_present_output_idx].Get<Tensor>().Shape()[3]);
+
+      UpdateDecoderMaskedMultiHeadAttentionCacheIndirection(cache_indirection.GetMutable<Tensor>()->MutableData<int32_t>(),
+                                                            old_cache_indirection.Get<Tensor>().Data<int32_t>(),
+                                                            beam_indices_cpu,
+                                                            batch_beam_size / num_beams,
+                                                            num_beams,
+                                                            input_sequence_len,
+                                                            max_sequence_length,
+                                                            current_length);
+
+      // Update cache indirection for next decoding run
+      next_inputs[past_sequence_length_idx + 2] = cache_indirection;
+    }
     return Status::OK();
   }
 
@@ -813,9 +872,6 @@ Status UpdateDecoderFeeds(
     const transformers::IConsoleDumper* dumper) {
   ORT_UNUSED_PARAMETER(stream);
   ORT_UNUSED_PARAMETER(beam_indices_gpu);
-  ORT_UNUSED_PARAMETER(input_sequence_len);
-  ORT_UNUSED_PARAMETER(past_present_share_buffer);
-  ORT_UNUSED_PARAMETER(need_cache_indir);
   // last_outputs: logits, present_key_self_0, present_value_self_0, ...
   // next_inputs: input_ids,
   //              encoder_attention_mask, encoder_hidden_states(optional),
@@ -856,6 +912,42 @@ Status UpdateDecoderFeeds(
 
   // Update past state
   ORT_ENFORCE(last_outputs.size() >= static_cast<size_t>(1) + num_present_tensors);
+
+  if (past_present_share_buffer) {
+    // Update past sequence length input
+    const int past_sequence_length_idx = 2 * (static_cast<int>(last_outputs.size()) - t5_decoder_first_present_output_idx) +
+                                         t5_decoder_first_past_input_idx;
+    *(next_inputs[past_sequence_length_idx].GetMutable<Tensor>()->MutableData<int32_t>()) = current_length - 1;
+
+    // Update beam search specific input for DecoderMaskedMultiHeadAttention (cache indirection) if present
+    if (need_cache_indir) {
+      // The cache indirection feed comes 2 feeds after the `past_sequence_length` feed
+      const OrtValue& old_cache_indirection = next_inputs[past_sequence_length_idx + 2];
+
+      // New cache indirection updated for next decoding run
+      OrtValue cache_indirection;
+      Tensor::InitOrtValue(DataTypeImpl::GetType<int32_t>(), old_cache_indirection.Get<Tensor>().Shape(), allocator,
+                           cache_indirection);
+
+      // The third index of the past/present tensor is the max_sequence_length
+      int max_sequence_length =
+          static_cast<int>(last_outputs[t5_decoder_first_present_output_idx].Get<Tensor>().Shape()[2]);
+
+      UpdateDecoderMaskedMultiHeadAttentionCacheIndirection(cache_indirection.GetMutable<Tensor>()->MutableData<int32_t>(),
+                                                            old_cache_indirection.Get<Tensor>().Data<int32_t>(),
+                                                            beam_indices,
+                                                            batch_beam_size / num_beams,
+                                                            num_beams,
+                                                            input_sequence_len,
+                                                            max_sequence_length,
+                                                            current_length);
+
+      // Update cache indirection for next decoding run
+      next_inputs[past_sequence_length_idx + 2] = cache_indirection;
+    }
+    return Status::OK();
+  }
+
   // TODO(tianleiwu): remove num_beams==1 once GreedySearch operator is available.
   if (num_beams == 1) {
     // feed present_* output to past_* inputs one by one
@@ -65,7 +65,7 @@ class GreedySearchGpt : public GreedySearchBase<T, ParametersT> {
         update_feeds_func_(update_feeds_func),
         cuda_device_prop_(cuda_device_prop),
         cuda_device_arch_(cuda_device_arch) {
-    if (gpt_subgraph_.has_decoder_masked_attention_) {
+    if (gpt_subgraph_.has_decoder_masked_attention_ && this->IsCuda()) {
       ORT_ENFORCE(cuda_device_arch_ >= 530,
                   "Decoder masked self attention can only be used on "
                   "GPU cards of compute capability 5.3 or higher. "
@@ -330,8 +330,9 @@ Status GreedySearchGpt<T, ParametersT>::Execute(const FeedsFetchesManager* init_
     ++current_length;
 
     // Reorder past state after first run if the GPT subgraph (the one used after the first iteration)
-    // contains DecoderMaskedSelfAttention nodes
-    if (iteration_counter == 1 && gpt_subgraph_.has_decoder_masked_attention_) {
+    // contains DecoderMaskedSelfAttention nodes. There is no reorder helper on CPU, where the kernel reads
+    // the past state in its original layout.
+    if (iteration_counter == 1 && gpt_subgraph_.has_decoder_masked_attention_ && reorder_past_state_func_) {
       size_t offset = static_cast<size_t>(gpt_subgraph_.GetFirstPresentOutputIndex());
       // We will use the same staging buffer while transposing all the layers' past state
       // and this is okay because we use the same stream to do the staging copy and the transpose
@@ -0,0 +1,213 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/gsl.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+/**
+ * A hash table from keys to values that is filled once, typically when a kernel is created, and then only read,
+ * possibly from several threads at the same time.
+ *
+ * The table uses open addressing with linear probing over a power of two array of 8 byte slots. A slot holds 32 bits
+ * of the hash of its key and the index of its entry, so that a lookup usually reads a single cache line and only
+ * compares keys when the hashes match. The entries are stored contiguously in insertion order, std::string keys as
+ * one buffer of characters, and are looked up with std::string_view.
+ *
+ * Floating point keys compare with ==, so 0 and -0 are the same key and NaN is never found.
+ */
+template <typename TKey, typename TValue>
+class FlatHashTable {
+ public:
+  using KeyView = std::conditional_t<std::is_same_v<TKey, std::string>, std::string_view, TKey>;
+
+  static constexpr size_t npos = std::numeric_limits<size_t>::max();
+
+  FlatHashTable() = default;
+
+  /**
+   * Reserves room for count entries.
+   */
+  void Reserve(size_t count) {
+    values_.reserve(count);
+    if constexpr (kIsString) {
+      key_offsets_.reserve(count + 1);
+    } else {
+      keys_.reserve(count);
+    }
+    if (count * 2 > slots_.size()) {
+      Rehash(count * 2);
+    }
+  }
+
+  /**
+   * Inserts key with value. If the key is already in the table its value is replaced.
+   * @return The index of the entry of the key.
+   */
+  size_t Insert(KeyView key, TValue value) {
+    size_t index = FindIndex(key);
+    if (index != npos) {
+      values_[index] = std::move(value);
+      return index;
+    }
+
+    index = values_.size();
+    ORT_ENFORCE(index < std::numeric_limits<uint32_t>::max(), "Too many entries in FlatHashTable");
+    if ((index + 1) * 2 > slots_.size()) {
+      Rehash(std::max<size_t>(16, slots_.size() * 2));
+    }
+
+    if constexpr (kIsString) {
+      chars_.append(key.data(), key.size());
+      key_offsets_.push_back(chars_.size());
+    } else {
+      keys_.push_back(key);
+    }
+    values_.push_back(std::move(value));
+    Place(Hash(key), index);
+    return index;
+  }
+
+  /**
+   * @return The index of the entry of key, or npos if the key is not in the table.
+   */
+  size_t FindIndex(KeyView key) const {
+    if (values_.empty()) {
+      return npos;
+    }
+    const uint64_t hash = Hash(key);
+    const uint32_t tag = static_cast<uint32_t>(hash >> 32);
+    for (size_t pos = hash & mask_;; pos = (pos + 1) & mask_) {
+      const Slot& slot = slots_[pos];
+      if (slot.index == 0) {
+        return npos;
+      }
+      if (slot.tag == tag && KeyAt(slot.index - 1) == key) {
+        return slot.index - 1;
+      }
+    }
+  }
+
+  /**
+   * @return The value of key, or nullptr if the key is not in the table.
+   */
+  const TValue* Find(KeyView key) const {
+    const size_t index = FindIndex(key);
+    return index == npos ? nullptr : &values_[index];
+  }
+
+  /**
+   * Looks up every key of a batch.
+   * @param keys The keys to look up, any type convertible to KeyView.
+   * @param default_value The value written for the keys that are not in the table.
+   * @param out The values of the keys, same size as keys.
+   * @param thread_pool The thread pool the lookups are split over, may be nullptr.
+   */
+  template <typename TIn>
+  void FindBatch(gsl::span<const TIn> keys, const TValue& default_value, gsl::span<TValue> out,
+                 concurrency::ThreadPool* thread_pool) const {
+    ORT_ENFORCE(keys.size() == out.size(), "FindBatch: keys and out must have the same size");
+    const TensorOpCost cost{static_cast<double>(sizeof(TIn)), static_cast<double>(sizeof(TValue)),
+                            kIsString ? 64.0 : 16.0};
+    concurrency::ThreadPool::TryParallelFor(
+        thread_pool, static_cast<std::ptrdiff_t>(keys.size()), cost,
+        [this, &keys, &default_value, &out](std::ptrdiff_t first, std::ptrdiff_t last) {
+          for (std::ptrdiff_t i = first; i < last; ++i) {
+            const size_t index = FindIndex(KeyView(keys[static_cast<size_t>(i)]));
+            out[static_cast<size_t>(i)] = index == npos ? default_value : values_[index];
+          }
+        });
+  }
+
+  size_t Size() const { return values_.size(); }
+
+  bool Empty() const { return values_.empty(); }
+
+  KeyView KeyAt(size_t index) const {
+    if constexpr (kIsString) {
+      return std::string_view(chars_.data() + key_offsets_[index], key_offsets_[index + 1] - key_offsets_[index]);
+    } else {
+      return keys_[index];
+    }
+  }
+
+  const TValue& ValueAt(size_t index) const { return values_[index]; }
+
+ private:
+  static constexpr bool kIsString = std::is_same_v<TKey, std::string>;
+
+  struct Slot {
+    uint32_t tag;
+    uint32_t index;  // index of the entry + 1, 0 - means an empty slot
+  };
+
+  static uint64_t Hash(KeyView key) {
+    uint64_t hash;
+    if constexpr (kIsString) {
+      hash = std::hash<std::string_view>{}(key);
+    } else if constexpr (std::is_floating_point_v<KeyView>) {
+      if (key == 0) {
+        key = 0;  // -0 and 0 are the same key
+      }
+      hash = 0;
+      std::memcpy(&hash, &key, sizeof(key));
+    } else {
+      hash = static_cast<uint64_t>(key);
+    }
+    // Finalizer of splitmix64, so that consecutive keys do not fill consecutive slots and the
+    // tag bits depend on the whole key.
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    return hash;
+  }
+
+  void Place(uint64_t hash, size_t index) {
+    size_t pos = hash & mask_;
+    while (slots_[pos].index != 0) {
+      pos = (pos + 1) & mask_;
+    }
+    slots_[pos] = Slot{static_cast<uint32_t>(hash >> 32), static_cast<uint32_t>(index + 1)};
+  }
+
+  void Rehash(size_t min_slots) {
+    size_t slot_count = 16;
+    while (slot_count < min_slots) {
+      slot_count *= 2;
+    }
+    slots_.assign(slot_count, Slot{0, 0});
+    mask_ = slot_count - 1;
+    for (size_t i = 0; i < values_.size(); ++i) {
+      Place(Hash(KeyAt(i)), i);
+    }
+  }
+
+  std::vector<Slot> slots_;
+  size_t mask_ = 0;
+
+  // std::string keys: entry i is chars_[key_offsets_[i], key_offsets_[i + 1]).
+  std::string chars_;
+  std::vector<size_t> key_offsets_{0};
+  // other keys
+  std::vector<TKey> keys_;
+
+  std::vector<TValue> values_;
+};
+
+}  // namespace onnxruntime
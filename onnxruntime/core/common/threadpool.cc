@@ -389,6 +389,12 @@ ThreadPool::ThreadPool(Env* env,
       assert(thread_options_.affinities.size() >= size_t(threads_to_create));
     }
 
+    if (!thread_options_.numa_nodes.empty()) {
+      // As above, the first element is for the caller thread
+      thread_options_.numa_nodes.erase(thread_options_.numa_nodes.begin());
+      assert(thread_options_.numa_nodes.size() >= size_t(threads_to_create));
+    }
+
     extended_eigen_threadpool_ =
         std::make_unique<ThreadPoolTempl<Env> >(name,
                                                 threads_to_create,
@@ -663,6 +669,18 @@ std::string ThreadPool::StopProfiling(concurrency::ThreadPool* tp) {
   }
 }
 
+ThreadPool::NumaNodeBinding::NumaNodeBinding(int numa_node) : active_(numa_node >= 0) {
+  if (active_) {
+    previous_numa_node_ = ThreadPoolTempl<Env>::SetCurrentThreadNumaNode(numa_node);
+  }
+}
+
+ThreadPool::NumaNodeBinding::~NumaNodeBinding() {
+  if (active_) {
+    ThreadPoolTempl<Env>::SetCurrentThreadNumaNode(previous_numa_node_);
+  }
+}
+
 void ThreadPool::EnableSpinning() {
   if (extended_eigen_threadpool_) {
     extended_eigen_threadpool_->EnableSpinning();
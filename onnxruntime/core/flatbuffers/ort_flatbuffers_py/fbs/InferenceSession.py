@@ -53,8 +53,20 @@ class InferenceSession(object):
             return obj
         return None
 
-def InferenceSessionStart(builder): builder.StartObject(4)
+    # InferenceSession
+    def PrepackedWeights(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(12))
+        if o != 0:
+            x = self._tab.Indirect(o + self._tab.Pos)
+            from ort_flatbuffers_py.fbs.PrePackedWeightsInfo import PrePackedWeightsInfo
+            obj = PrePackedWeightsInfo()
+            obj.Init(self._tab.Bytes, x)
+            return obj
+        return None
+
+def InferenceSessionStart(builder): builder.StartObject(5)
 def InferenceSessionAddOrtVersion(builder, ortVersion): builder.PrependUOffsetTRelativeSlot(0, flatbuffers.number_types.UOffsetTFlags.py_type(ortVersion), 0)
 def InferenceSessionAddModel(builder, model): builder.PrependUOffsetTRelativeSlot(1, flatbuffers.number_types.UOffsetTFlags.py_type(model), 0)
 def InferenceSessionAddKernelTypeStrResolver(builder, kernelTypeStrResolver): builder.PrependUOffsetTRelativeSlot(3, flatbuffers.number_types.UOffsetTFlags.py_type(kernelTypeStrResolver), 0)
+def InferenceSessionAddPrepackedWeights(builder, prepackedWeights): builder.PrependUOffsetTRelativeSlot(4, flatbuffers.number_types.UOffsetTFlags.py_type(prepackedWeights), 0)
 def InferenceSessionEnd(builder): return builder.EndObject()
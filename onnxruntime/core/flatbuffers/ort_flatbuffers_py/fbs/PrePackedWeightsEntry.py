@@ -0,0 +1,95 @@
+# automatically generated by the FlatBuffers compiler, do not modify
+
+# namespace: fbs
+
+import flatbuffers
+from flatbuffers.compat import import_numpy
+np = import_numpy()
+
+class PrePackedWeightsEntry(object):
+    __slots__ = ['_tab']
+
+    @classmethod
+    def GetRootAsPrePackedWeightsEntry(cls, buf, offset):
+        n = flatbuffers.encode.Get(flatbuffers.packer.uoffset, buf, offset)
+        x = PrePackedWeightsEntry()
+        x.Init(buf, n + offset)
+        return x
+
+    @classmethod
+    def PrePackedWeightsEntryBufferHasIdentifier(cls, buf, offset, size_prefixed=False):
+        return flatbuffers.util.BufferHasIdentifier(buf, offset, b"\x4F\x52\x54\x4D", size_prefixed=size_prefixed)
+
+    # PrePackedWeightsEntry
+    def Init(self, buf, pos):
+        self._tab = flatbuffers.table.Table(buf, pos)
+
+    # PrePackedWeightsEntry
+    def GraphId(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(4))
+        if o != 0:
+            return self._tab.String(o + self._tab.Pos)
+        return None
+
+    # PrePackedWeightsEntry
+    def NodeIndex(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(6))
+        if o != 0:
+            return self._tab.Get(flatbuffers.number_types.Uint32Flags, o + self._tab.Pos)
+        return 0
+
+    # PrePackedWeightsEntry
+    def OpId(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(8))
+        if o != 0:
+            return self._tab.String(o + self._tab.Pos)
+        return None
+
+    # PrePackedWeightsEntry
+    def InputIndex(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(10))
+        if o != 0:
+            return self._tab.Get(flatbuffers.number_types.Int32Flags, o + self._tab.Pos)
+        return 0
+
+    # PrePackedWeightsEntry
+    def InitializerName(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(12))
+        if o != 0:
+            return self._tab.String(o + self._tab.Pos)
+        return None
+
+    # PrePackedWeightsEntry
+    def Buffers(self, j):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(14))
+        if o != 0:
+            x = self._tab.Vector(o)
+            x += flatbuffers.number_types.UOffsetTFlags.py_type(j) * 4
+            x = self._tab.Indirect(x)
+            from ort_flatbuffers_py.fbs.PrePackedBuffer import PrePackedBuffer
+            obj = PrePackedBuffer()
+            obj.Init(self._tab.Bytes, x)
+            return obj
+        return None
+
+    # PrePackedWeightsEntry
+    def BuffersLength(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(14))
+        if o != 0:
+            return self._tab.VectorLen(o)
+        return 0
+
+    # PrePackedWeightsEntry
+    def BuffersIsNone(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(14))
+        return o == 0
+
+def PrePackedWeightsEntryStart(builder): builder.StartObject(6)
+def PrePackedWeightsEntryAddGraphId(builder, graphId): builder.PrependUOffsetTRelativeSlot(0, flatbuffers.number_types.UOffsetTFlags.py_type(graphId), 0)
+def PrePackedWeightsEntryAddNodeIndex(builder, nodeIndex): builder.PrependUint32Slot(1, nodeIndex, 0)
+def PrePackedWeightsEntryAddOpId(builder, opId): builder.PrependUOffsetTRelativeSlot(2, flatbuffers.number_types.UOffsetTFlags.py_type(opId), 0)
+def PrePackedWeightsEntryAddInputIndex(builder, inputIndex): builder.PrependInt32Slot(3, inputIndex, 0)
+def PrePackedWeightsEntryAddInitializerName(builder, initializerName): builder.PrependUOffsetTRelativeSlot(4, flatbuffers.number_types.UOffsetTFlags.py_type(initializerName), 0)
+def PrePackedWeightsEntryAddBuffers(builder, buffers): builder.PrependUOffsetTRelativeSlot(5, flatbuffers.number_types.UOffsetTFlags.py_type(buffers), 0)
+def PrePackedWeightsEntryStartBuffersVector(builder, numElems): return builder.StartVector(4, numElems, 4)
+def PrePackedWeightsEntryEnd(builder): return builder.EndObject()
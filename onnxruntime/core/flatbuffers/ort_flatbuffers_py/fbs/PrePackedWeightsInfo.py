@@ -0,0 +1,63 @@
+# automatically generated by the FlatBuffers compiler, do not modify
+
+# namespace: fbs
+
+import flatbuffers
+from flatbuffers.compat import import_numpy
+np = import_numpy()
+
+class PrePackedWeightsInfo(object):
+    __slots__ = ['_tab']
+
+    @classmethod
+    def GetRootAsPrePackedWeightsInfo(cls, buf, offset):
+        n = flatbuffers.encode.Get(flatbuffers.packer.uoffset, buf, offset)
+        x = PrePackedWeightsInfo()
+        x.Init(buf, n + offset)
+        return x
+
+    @classmethod
+    def PrePackedWeightsInfoBufferHasIdentifier(cls, buf, offset, size_prefixed=False):
+        return flatbuffers.util.BufferHasIdentifier(buf, offset, b"\x4F\x52\x54\x4D", size_prefixed=size_prefixed)
+
+    # PrePackedWeightsInfo
+    def Init(self, buf, pos):
+        self._tab = flatbuffers.table.Table(buf, pos)
+
+    # PrePackedWeightsInfo
+    def PlatformFingerprint(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(4))
+        if o != 0:
+            return self._tab.String(o + self._tab.Pos)
+        return None
+
+    # PrePackedWeightsInfo
+    def Entries(self, j):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(6))
+        if o != 0:
+            x = self._tab.Vector(o)
+            x += flatbuffers.number_types.UOffsetTFlags.py_type(j) * 4
+            x = self._tab.Indirect(x)
+            from ort_flatbuffers_py.fbs.PrePackedWeightsEntry import PrePackedWeightsEntry
+            obj = PrePackedWeightsEntry()
+            obj.Init(self._tab.Bytes, x)
+            return obj
+        return None
+
+    # PrePackedWeightsInfo
+    def EntriesLength(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(6))
+        if o != 0:
+            return self._tab.VectorLen(o)
+        return 0
+
+    # PrePackedWeightsInfo
+    def EntriesIsNone(self):
+        o = flatbuffers.number_types.UOffsetTFlags.py_type(self._tab.Offset(6))
+        return o == 0
+
+def PrePackedWeightsInfoStart(builder): builder.StartObject(2)
+def PrePackedWeightsInfoAddPlatformFingerprint(builder, platformFingerprint): builder.PrependUOffsetTRelativeSlot(0, flatbuffers.number_types.UOffsetTFlags.py_type(platformFingerprint), 0)
+def PrePackedWeightsInfoAddEntries(builder, entries): builder.PrependUOffsetTRelativeSlot(1, flatbuffers.number_types.UOffsetTFlags.py_type(entries), 0)
+def PrePackedWeightsInfoStartEntriesVector(builder, numElems): return builder.StartVector(4, numElems, 4)
+def PrePackedWeightsInfoEnd(builder): return builder.EndObject()
@@ -98,6 +98,15 @@ struct OpIdKernelTypeStrArgsEntryBuilder;
 struct KernelTypeStrResolver;
 struct KernelTypeStrResolverBuilder;
 
+struct PrePackedBuffer;
+struct PrePackedBufferBuilder;
+
+struct PrePackedWeightsEntry;
+struct PrePackedWeightsEntryBuilder;
+
+struct PrePackedWeightsInfo;
+struct PrePackedWeightsInfoBuilder;
+
 struct InferenceSession;
 struct InferenceSessionBuilder;
 
@@ -2967,12 +2976,251 @@ inline flatbuffers::Offset<KernelTypeStrResolver> CreateKernelTypeStrResolverDir
       op_kernel_type_str_args__);
 }
 
+struct PrePackedBuffer FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef PrePackedBufferBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_DATA = 4
+  };
+  const flatbuffers::Vector<uint8_t> *data() const {
+    return GetPointer<const flatbuffers::Vector<uint8_t> *>(VT_DATA);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffset(verifier, VT_DATA) &&
+           verifier.VerifyVector(data()) &&
+           verifier.EndTable();
+  }
+};
+
+struct PrePackedBufferBuilder {
+  typedef PrePackedBuffer Table;
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_data(flatbuffers::Offset<flatbuffers::Vector<uint8_t>> data) {
+    fbb_.AddOffset(PrePackedBuffer::VT_DATA, data);
+  }
+  explicit PrePackedBufferBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  PrePackedBufferBuilder &operator=(const PrePackedBufferBuilder &);
+  flatbuffers::Offset<PrePackedBuffer> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<PrePackedBuffer>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<PrePackedBuffer> CreatePrePackedBuffer(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    flatbuffers::Offset<flatbuffers::Vector<uint8_t>> data = 0) {
+  PrePackedBufferBuilder builder_(_fbb);
+  builder_.add_data(data);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<PrePackedBuffer> CreatePrePackedBufferDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    const std::vector<uint8_t> *data = nullptr) {
+  auto data__ = data ? _fbb.CreateVector<uint8_t>(*data) : 0;
+  return onnxruntime::fbs::CreatePrePackedBuffer(
+      _fbb,
+      data__);
+}
+
+struct PrePackedWeightsEntry FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef PrePackedWeightsEntryBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_GRAPH_ID = 4,
+    VT_NODE_INDEX = 6,
+    VT_OP_ID = 8,
+    VT_INPUT_INDEX = 10,
+    VT_INITIALIZER_NAME = 12,
+    VT_BUFFERS = 14
+  };
+  const flatbuffers::String *graph_id() const {
+    return GetPointer<const flatbuffers::String *>(VT_GRAPH_ID);
+  }
+  uint32_t node_index() const {
+    return GetField<uint32_t>(VT_NODE_INDEX, 0);
+  }
+  const flatbuffers::String *op_id() const {
+    return GetPointer<const flatbuffers::String *>(VT_OP_ID);
+  }
+  int32_t input_index() const {
+    return GetField<int32_t>(VT_INPUT_INDEX, 0);
+  }
+  const flatbuffers::String *initializer_name() const {
+    return GetPointer<const flatbuffers::String *>(VT_INITIALIZER_NAME);
+  }
+  const flatbuffers::Vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedBuffer>> *buffers() const {
+    return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedBuffer>> *>(VT_BUFFERS);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffset(verifier, VT_GRAPH_ID) &&
+           verifier.VerifyString(graph_id()) &&
+           VerifyField<uint32_t>(verifier, VT_NODE_INDEX) &&
+           VerifyOffset(verifier, VT_OP_ID) &&
+           verifier.VerifyString(op_id()) &&
+           VerifyField<int32_t>(verifier, VT_INPUT_INDEX) &&
+           VerifyOffset(verifier, VT_INITIALIZER_NAME) &&
+           verifier.VerifyString(initializer_name()) &&
+           VerifyOffset(verifier, VT_BUFFERS) &&
+           verifier.VerifyVector(buffers()) &&
+           verifier.VerifyVectorOfTables(buffers()) &&
+           verifier.EndTable();
+  }
+};
+
+struct PrePackedWeightsEntryBuilder {
+  typedef PrePackedWeightsEntry Table;
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_graph_id(flatbuffers::Offset<flatbuffers::String> graph_id) {
+    fbb_.AddOffset(PrePackedWeightsEntry::VT_GRAPH_ID, graph_id);
+  }
+  void add_node_index(uint32_t node_index) {
+    fbb_.AddElement<uint32_t>(PrePackedWeightsEntry::VT_NODE_INDEX, node_index, 0);
+  }
+  void add_op_id(flatbuffers::Offset<flatbuffers::String> op_id) {
+    fbb_.AddOffset(PrePackedWeightsEntry::VT_OP_ID, op_id);
+  }
+  void add_input_index(int32_t input_index) {
+    fbb_.AddElement<int32_t>(PrePackedWeightsEntry::VT_INPUT_INDEX, input_index, 0);
+  }
+  void add_initializer_name(flatbuffers::Offset<flatbuffers::String> initializer_name) {
+    fbb_.AddOffset(PrePackedWeightsEntry::VT_INITIALIZER_NAME, initializer_name);
+  }
+  void add_buffers(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedBuffer>>> buffers) {
+    fbb_.AddOffset(PrePackedWeightsEntry::VT_BUFFERS, buffers);
+  }
+  explicit PrePackedWeightsEntryBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  PrePackedWeightsEntryBuilder &operator=(const PrePackedWeightsEntryBuilder &);
+  flatbuffers::Offset<PrePackedWeightsEntry> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<PrePackedWeightsEntry>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<PrePackedWeightsEntry> CreatePrePackedWeightsEntry(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    flatbuffers::Offset<flatbuffers::String> graph_id = 0,
+    uint32_t node_index = 0,
+    flatbuffers::Offset<flatbuffers::String> op_id = 0,
+    int32_t input_index = 0,
+    flatbuffers::Offset<flatbuffers::String> initializer_name = 0,
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedBuffer>>> buffers = 0) {
+  PrePackedWeightsEntryBuilder builder_(_fbb);
+  builder_.add_buffers(buffers);
+  builder_.add_initializer_name(initializer_name);
+  builder_.add_input_index(input_index);
+  builder_.add_op_id(op_id);
+  builder_.add_node_index(node_index);
+  builder_.add_graph_id(graph_id);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<PrePackedWeightsEntry> CreatePrePackedWeightsEntryDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    const char *graph_id = nullptr,
+    uint32_t node_index = 0,
+    const char *op_id = nullptr,
+    int32_t input_index = 0,
+    const char *initializer_name = nullptr,
+    const std::vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedBuffer>> *buffers = nullptr) {
+  auto graph_id__ = graph_id ? _fbb.CreateString(graph_id) : 0;
+  auto op_id__ = op_id ? _fbb.CreateString(op_id) : 0;
+  auto initializer_name__ = initializer_name ? _fbb.CreateString(initializer_name) : 0;
+  auto buffers__ = buffers ? _fbb.CreateVector<flatbuffers::Offset<onnxruntime::fbs::PrePackedBuffer>>(*buffers) : 0;
+  return onnxruntime::fbs::CreatePrePackedWeightsEntry(
+      _fbb,
+      graph_id__,
+      node_index,
+      op_id__,
+      input_index,
+      initializer_name__,
+      buffers__);
+}
+
+struct PrePackedWeightsInfo FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
+  typedef PrePackedWeightsInfoBuilder Builder;
+  enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
+    VT_PLATFORM_FINGERPRINT = 4,
+    VT_ENTRIES = 6
+  };
+  const flatbuffers::String *platform_fingerprint() const {
+    return GetPointer<const flatbuffers::String *>(VT_PLATFORM_FINGERPRINT);
+  }
+  const flatbuffers::Vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedWeightsEntry>> *entries() const {
+    return GetPointer<const flatbuffers::Vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedWeightsEntry>> *>(VT_ENTRIES);
+  }
+  bool Verify(flatbuffers::Verifier &verifier) const {
+    return VerifyTableStart(verifier) &&
+           VerifyOffset(verifier, VT_PLATFORM_FINGERPRINT) &&
+           verifier.VerifyString(platform_fingerprint()) &&
+           VerifyOffset(verifier, VT_ENTRIES) &&
+           verifier.VerifyVector(entries()) &&
+           verifier.VerifyVectorOfTables(entries()) &&
+           verifier.EndTable();
+  }
+};
+
+struct PrePackedWeightsInfoBuilder {
+  typedef PrePackedWeightsInfo Table;
+  flatbuffers::FlatBufferBuilder &fbb_;
+  flatbuffers::uoffset_t start_;
+  void add_platform_fingerprint(flatbuffers::Offset<flatbuffers::String> platform_fingerprint) {
+    fbb_.AddOffset(PrePackedWeightsInfo::VT_PLATFORM_FINGERPRINT, platform_fingerprint);
+  }
+  void add_entries(flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedWeightsEntry>>> entries) {
+    fbb_.AddOffset(PrePackedWeightsInfo::VT_ENTRIES, entries);
+  }
+  explicit PrePackedWeightsInfoBuilder(flatbuffers::FlatBufferBuilder &_fbb)
+        : fbb_(_fbb) {
+    start_ = fbb_.StartTable();
+  }
+  PrePackedWeightsInfoBuilder &operator=(const PrePackedWeightsInfoBuilder &);
+  flatbuffers::Offset<PrePackedWeightsInfo> Finish() {
+    const auto end = fbb_.EndTable(start_);
+    auto o = flatbuffers::Offset<PrePackedWeightsInfo>(end);
+    return o;
+  }
+};
+
+inline flatbuffers::Offset<PrePackedWeightsInfo> CreatePrePackedWeightsInfo(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    flatbuffers::Offset<flatbuffers::String> platform_fingerprint = 0,
+    flatbuffers::Offset<flatbuffers::Vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedWeightsEntry>>> entries = 0) {
+  PrePackedWeightsInfoBuilder builder_(_fbb);
+  builder_.add_entries(entries);
+  builder_.add_platform_fingerprint(platform_fingerprint);
+  return builder_.Finish();
+}
+
+inline flatbuffers::Offset<PrePackedWeightsInfo> CreatePrePackedWeightsInfoDirect(
+    flatbuffers::FlatBufferBuilder &_fbb,
+    const char *platform_fingerprint = nullptr,
+    const std::vector<flatbuffers::Offset<onnxruntime::fbs::PrePackedWeightsEntry>> *entries = nullptr) {
+  auto platform_fingerprint__ = platform_fingerprint ? _fbb.CreateString(platform_fingerprint) : 0;
+  auto entries__ = entries ? _fbb.CreateVector<flatbuffers::Offset<onnxruntime::fbs::PrePackedWeightsEntry>>(*entries) : 0;
+  return onnxruntime::fbs::CreatePrePackedWeightsInfo(
+      _fbb,
+      platform_fingerprint__,
+      entries__);
+}
+
 struct InferenceSession FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   typedef InferenceSessionBuilder Builder;
   enum FlatBuffersVTableOffset FLATBUFFERS_VTABLE_UNDERLYING_TYPE {
     VT_ORT_VERSION = 4,
     VT_MODEL = 6,
-    VT_KERNEL_TYPE_STR_RESOLVER = 10
+    VT_KERNEL_TYPE_STR_RESOLVER = 10,
+    VT_PREPACKED_WEIGHTS = 12
   };
   const flatbuffers::String *ort_version() const {
     return GetPointer<const flatbuffers::String *>(VT_ORT_VERSION);
@@ -2983,6 +3231,9 @@ struct InferenceSession FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
   const onnxruntime::fbs::KernelTypeStrResolver *kernel_type_str_resolver() const {
     return GetPointer<const onnxruntime::fbs::KernelTypeStrResolver *>(VT_KERNEL_TYPE_STR_RESOLVER);
   }
+  const onnxruntime::fbs::PrePackedWeightsInfo *prepacked_weights() const {
+    return GetPointer<const onnxruntime::fbs::PrePackedWeightsInfo *>(VT_PREPACKED_WEIGHTS);
+  }
   bool Verify(flatbuffers::Verifier &verifier) const {
     return VerifyTableStart(verifier) &&
            VerifyOffset(verifier, VT_ORT_VERSION) &&
@@ -2991,6 +3242,8 @@ struct InferenceSession FLATBUFFERS_FINAL_CLASS : private flatbuffers::Table {
            verifier.VerifyTable(model()) &&
            VerifyOffset(verifier, VT_KERNEL_TYPE_STR_RESOLVER) &&
            verifier.VerifyTable(kernel_type_str_resolver()) &&
+           VerifyOffset(verifier, VT_PREPACKED_WEIGHTS) &&
+           verifier.VerifyTable(prepacked_weights()) &&
            verifier.EndTable();
   }
 };
@@ -3008,6 +3261,9 @@ struct InferenceSessionBuilder {
   void add_kernel_type_str_resolver(flatbuffers::Offset<onnxruntime::fbs::KernelTypeStrResolver> kernel_type_str_resolver) {
     fbb_.AddOffset(InferenceSession::VT_KERNEL_TYPE_STR_RESOLVER, kernel_type_str_resolver);
   }
+  void add_prepacked_weights(flatbuffers::Offset<onnxruntime::fbs::PrePackedWeightsInfo> prepacked_weights) {
+    fbb_.AddOffset(InferenceSession::VT_PREPACKED_WEIGHTS, prepacked_weights);
+  }
   explicit InferenceSessionBuilder(flatbuffers::FlatBufferBuilder &_fbb)
         : fbb_(_fbb) {
     start_ = fbb_.StartTable();
@@ -3024,8 +3280,10 @@ inline flatbuffers::Offset<InferenceSession> CreateInferenceSession(
     flatbuffers::FlatBufferBuilder &_fbb,
     flatbuffers::Offset<flatbuffers::String> ort_version = 0,
     flatbuffers::Offset<onnxruntime::fbs::Model> model = 0,
-    flatbuffers::Offset<onnxruntime::fbs::KernelTypeStrResolver> kernel_type_str_resolver = 0) {
+    flatbuffers::Offset<onnxruntime::fbs::KernelTypeStrResolver> kernel_type_str_resolver = 0,
+    flatbuffers::Offset<onnxruntime::fbs::PrePackedWeightsInfo> prepacked_weights = 0) {
   InferenceSessionBuilder builder_(_fbb);
+  builder_.add_prepacked_weights(prepacked_weights);
   builder_.add_kernel_type_str_resolver(kernel_type_str_resolver);
   builder_.add_model(model);
   builder_.add_ort_version(ort_version);
@@ -3036,13 +3294,15 @@ inline flatbuffers::Offset<InferenceSession> CreateInferenceSessionDirect(
     flatbuffers::FlatBufferBuilder &_fbb,
     const char *ort_version = nullptr,
     flatbuffers::Offset<onnxruntime::fbs::Model> model = 0,
-    flatbuffers::Offset<onnxruntime::fbs::KernelTypeStrResolver> kernel_type_str_resolver = 0) {
+    flatbuffers::Offset<onnxruntime::fbs::KernelTypeStrResolver> kernel_type_str_resolver = 0,
+    flatbuffers::Offset<onnxruntime::fbs::PrePackedWeightsInfo> prepacked_weights = 0) {
   auto ort_version__ = ort_version ? _fbb.CreateString(ort_version) : 0;
   return onnxruntime::fbs::CreateInferenceSession(
       _fbb,
       ort_version__,
       model,
-      kernel_type_str_resolver);
+      kernel_type_str_resolver,
+      prepacked_weights);
 }
 
 inline bool VerifyTypeInfoValue(flatbuffers::Verifier &verifier, const void *obj, TypeInfoValue type) {
@@ -1701,7 +1701,9 @@ class PlannerImpl {
             break;
           }
         }
-        if (is_all_consumer_same_stream) {
+        // in parallel execution mode the nodes of a stream may not run in the order of the stream
+        // (see CriticalPathScheduler), so the last consumer to run is only known at runtime.
+        if (is_all_consumer_same_stream && !context_->IsParallelExecutionEnabled()) {
           // all the consumers are on the same stream, so the first element is the last consumer int the stream.
           process_consumer(release_action_idx, value_consumers[i][0]);
         } else {
@@ -22,6 +22,9 @@ struct AllocatorStats {
                                   // is known. Certain allocator may return 0 to indicate the limit is
                                   // unknown.
   int64_t bytes_limit;
+  int64_t num_cache_hits;         // Number of allocations served by the per-thread cache (Relevant only for arena based allocators)
+  int64_t num_cache_misses;       // Number of cacheable allocations that had to go to the arena
+                                  // (Relevant only for arena based allocators)
 
   AllocatorStats() { Clear(); }
 
@@ -35,6 +38,8 @@ struct AllocatorStats {
     this->max_alloc_size = 0;
     this->bytes_limit = 0;
     this->total_allocated_bytes = 0;
+    this->num_cache_hits = 0;
+    this->num_cache_misses = 0;
   }
 
   std::string DebugString() const {
@@ -47,7 +52,9 @@ struct AllocatorStats {
        << "NumReserves:              " << this->num_reserves << "\n"
        << "NumArenaExtensions:       " << this->num_arena_extensions << "\n"
        << "NumArenaShrinkages:       " << this->num_arena_shrinkages << "\n"
-       << "MaxAllocSize:             " << this->max_alloc_size << "\n";
+       << "MaxAllocSize:             " << this->max_alloc_size << "\n"
+       << "NumCacheHits:             " << this->num_cache_hits << "\n"
+       << "NumCacheMisses:           " << this->num_cache_misses << "\n";
     return ss.str();
   }
 };
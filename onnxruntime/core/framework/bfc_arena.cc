@@ -3,15 +3,23 @@
 
 #include "core/framework/allocator.h"
 #include "core/framework/bfc_arena.h"
+#include <algorithm>
+#include <atomic>
 #include <type_traits>
 
 namespace onnxruntime {
+
+namespace {
+std::atomic<uint64_t> next_thread_cache_arena_id{1};
+}  // namespace
+
 BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
                    size_t total_memory,
                    ArenaExtendStrategy arena_extend_strategy,
                    int initial_chunk_size_bytes,
                    int max_dead_bytes_per_chunk,
-                   int initial_growth_chunk_size_bytes)
+                   int initial_growth_chunk_size_bytes,
+                   int thread_cache_size_bytes)
     : IAllocator(OrtMemoryInfo(resource_allocator->Info().name,
                                OrtAllocatorType::OrtArenaAllocator,
                                resource_allocator->Info().device,
@@ -23,13 +31,16 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       next_allocation_id_(1),
       initial_chunk_size_bytes_(initial_chunk_size_bytes),
       max_dead_bytes_per_chunk_(max_dead_bytes_per_chunk),
-      initial_growth_chunk_size_bytes_(initial_growth_chunk_size_bytes) {
+      initial_growth_chunk_size_bytes_(initial_growth_chunk_size_bytes),
+      thread_cache_size_bytes_(thread_cache_size_bytes > 0 ? static_cast<size_t>(thread_cache_size_bytes) : 0),
+      thread_cache_arena_id_(next_thread_cache_arena_id.fetch_add(1, std::memory_order_relaxed)) {
   LOGS_DEFAULT(INFO) << "Creating BFCArena for " << device_allocator_->Info().name
                      << " with following configs: initial_chunk_size_bytes: " << initial_chunk_size_bytes_
                      << " max_dead_bytes_per_chunk: " << max_dead_bytes_per_chunk_
                      << " initial_growth_chunk_size_bytes: " << initial_growth_chunk_size_bytes_
                      << " memory limit: " << total_memory
-                     << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy);
+                     << " arena_extend_strategy: " << static_cast<int32_t>(arena_extend_strategy)
+                     << " thread_cache_size_bytes: " << thread_cache_size_bytes_;
 
   // static_cast<std::underlying_type_t<ArenaExtendStrategy>>(arena_extend_strategy); doesn't work on this compiler
 
@@ -72,9 +83,30 @@ BFCArena::BFCArena(std::unique_ptr<IAllocator> resource_allocator,
       ORT_ENFORCE(BinForSize(bin_size * 2) != BinFromIndex(b));
     }
   }
+
+  if (thread_cache_size_bytes_ > 0 && device_allocator_->Info().device.Type() != OrtDevice::CPU) {
+    LOGS_DEFAULT(WARNING) << "The per-thread cache of BFCArena writes to the allocated memory, it is disabled for "
+                          << device_allocator_->Info().name;
+    thread_cache_size_bytes_ = 0;
+  }
+
+  if (thread_cache_size_bytes_ > 0) {
+    // only cache allocations whose rounded size fits in the cache of a thread
+    max_thread_cache_alloc_size_ = std::min(kMaxThreadCacheAllocationSize,
+                                            (thread_cache_size_bytes_ / kMinAllocationSize) * kMinAllocationSize + 1);
+  }
 }
 
 BFCArena::~BFCArena() {
+  {
+    // the threads that still have a cache of this arena must not return it when they exit.
+    // the chunks they hold are freed with the regions.
+    std::lock_guard<OrtMutex> lock(ThreadCacheRegistryMutex());
+    for (auto& cache : thread_caches_) {
+      cache->arena = nullptr;
+    }
+  }
+
   for (const auto& region : region_manager_.regions()) {
     device_allocator_->Free(region.ptr());
   }
@@ -261,6 +293,10 @@ size_t BFCArena::RoundedBytes(size_t bytes) {
 }
 
 void* BFCArena::Alloc(size_t size) {
+  if (thread_cache_size_bytes_ > 0) {
+    return AllocWithThreadCache(size);
+  }
+
   return AllocateRawInternal(size, false, nullptr, false, nullptr);
 }
 
@@ -272,6 +308,10 @@ void* BFCArena::Reserve(size_t size) {
 
   LOGS_DEFAULT(INFO) << "Reserving memory in BFCArena for " << device_allocator_->Info().name << " size: " << size;
 
+  // Free() reads the header of the per-thread cache in front of any pointer
+  const size_t header_size = thread_cache_size_bytes_ > 0 ? kThreadCacheHeaderSize : 0;
+  size += header_size;
+
   void* ptr = device_allocator_->Alloc(size);
   ORT_ENFORCE(reserved_chunks_.find(ptr) == reserved_chunks_.end());
   reserved_chunks_.insert(std::pair<void*, size_t>(ptr, size));
@@ -281,23 +321,29 @@ void* BFCArena::Reserve(size_t size) {
   stats_.max_alloc_size = std::max<size_t>(static_cast<size_t>(stats_.max_alloc_size), size);
   stats_.max_bytes_in_use = std::max<int64_t>(static_cast<int64_t>(stats_.max_bytes_in_use), stats_.bytes_in_use);
   stats_.total_allocated_bytes += size;
+  if (header_size > 0) {
+    auto* header = static_cast<ThreadCacheChunkHeader*>(ptr);
+    header->cached_size = 0;
+    header->next = nullptr;
+    return static_cast<char*>(ptr) + header_size;
+  }
   return ptr;
 }
 
 size_t BFCArena::RequestedSize(const void* ptr) {
   std::lock_guard<OrtMutex> lock(lock_);
-  BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
+  BFCArena::ChunkHandle h = region_manager_.get_handle(ArenaPtr(ptr));
   ORT_ENFORCE(h != kInvalidChunkHandle);
   BFCArena::Chunk* c = ChunkFromHandle(h);
-  return c->requested_size;
+  return c->requested_size - (thread_cache_size_bytes_ > 0 ? kThreadCacheHeaderSize : 0);
 }
 
 size_t BFCArena::AllocatedSize(const void* ptr) {
   std::lock_guard<OrtMutex> lock(lock_);
-  BFCArena::ChunkHandle h = region_manager_.get_handle(ptr);
+  BFCArena::ChunkHandle h = region_manager_.get_handle(ArenaPtr(ptr));
   ORT_ENFORCE(h != kInvalidChunkHandle);
   BFCArena::Chunk* c = ChunkFromHandle(h);
-  return c->size;
+  return c->size - (thread_cache_size_bytes_ > 0 ? kThreadCacheHeaderSize : 0);
 }
 
 void* BFCArena::AllocateRawInternal(size_t num_bytes,
@@ -371,6 +417,190 @@ void* BFCArena::AllocateRawInternal(size_t num_bytes,
 void BFCArena::GetStats(AllocatorStats* stats) {
   std::lock_guard<OrtMutex> lock(lock_);
   *stats = stats_;
+  for (const auto& cache : thread_caches_) {
+    stats->num_cache_hits += cache->num_hits.load(std::memory_order_relaxed);
+    stats->num_cache_misses += cache->num_misses.load(std::memory_order_relaxed);
+  }
+}
+
+namespace {
+// State of the ThreadCacheOwner of the thread. It is trivially destructible, so it can still be read by a Free() from
+// the destructor of another thread_local or static object once the owner has been destroyed.
+enum class ThreadCacheOwnerState : uint8_t {
+  kNotCreated,
+  kAlive,
+  kDestroyed,
+};
+
+thread_local ThreadCacheOwnerState thread_cache_owner_state = ThreadCacheOwnerState::kNotCreated;
+}  // namespace
+
+class BFCArena::ThreadCacheOwner {
+ public:
+  ThreadCacheOwner() { thread_cache_owner_state = ThreadCacheOwnerState::kAlive; }
+
+  ~ThreadCacheOwner() {
+    thread_cache_owner_state = ThreadCacheOwnerState::kDestroyed;
+    std::lock_guard<OrtMutex> lock(ThreadCacheRegistryMutex());
+    for (auto& cache : caches_) {
+      if (cache->arena != nullptr) {
+        cache->arena->ReleaseThreadCache(*cache);
+      }
+    }
+  }
+
+  ThreadCache* Find(uint64_t arena_id) {
+    if (last_ != nullptr && last_->arena_id == arena_id) {
+      return last_;
+    }
+
+    for (auto& cache : caches_) {
+      if (cache->arena_id == arena_id) {
+        last_ = cache.get();
+        return last_;
+      }
+    }
+
+    return nullptr;
+  }
+
+  ThreadCache& Add(std::shared_ptr<ThreadCache> cache) {
+    {
+      // drop the caches of the arenas that were destroyed
+      std::lock_guard<OrtMutex> lock(ThreadCacheRegistryMutex());
+      caches_.erase(std::remove_if(caches_.begin(), caches_.end(),
+                                   [](const std::shared_ptr<ThreadCache>& c) { return c->arena == nullptr; }),
+                    caches_.end());
+    }
+
+    caches_.push_back(std::move(cache));
+    last_ = caches_.back().get();
+    return *last_;
+  }
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(ThreadCacheOwner);
+
+  std::vector<std::shared_ptr<ThreadCache>> caches_;
+  // The cache found by the last call, a thread usually allocates from the same arena.
+  ThreadCache* last_ = nullptr;
+};
+
+OrtMutex& BFCArena::ThreadCacheRegistryMutex() {
+  // never destroyed, as threads may exit after the static objects are destroyed
+  static auto* mutex = new OrtMutex();
+  return *mutex;
+}
+
+BFCArena::ThreadCache* BFCArena::CurrentThreadCache() {
+  if (thread_cache_owner_state == ThreadCacheOwnerState::kDestroyed) {
+    return nullptr;
+  }
+
+  thread_local ThreadCacheOwner owner;
+  ThreadCache* cache = owner.Find(thread_cache_arena_id_);
+  if (cache != nullptr) {
+    return cache;
+  }
+
+  auto new_cache = std::make_shared<ThreadCache>(this, thread_cache_arena_id_);
+  {
+    std::lock_guard<OrtMutex> lock(lock_);
+    thread_caches_.push_back(new_cache);
+  }
+
+  return &owner.Add(std::move(new_cache));
+}
+
+void* BFCArena::AllocWithThreadCache(size_t num_bytes) {
+  if (num_bytes == 0) {
+    return nullptr;
+  }
+
+  const size_t rounded_bytes = RoundedBytes(num_bytes);
+  ThreadCache* cache = rounded_bytes < max_thread_cache_alloc_size_ ? CurrentThreadCache() : nullptr;
+  const bool cacheable = cache != nullptr;
+  if (cacheable) {
+    // the most recently freed chunks are first, they are the most likely to still be in the CPU caches
+    ThreadCacheChunkHeader** link = &cache->free_lists[BinNumForSize(rounded_bytes)];
+    for (int i = 0; *link != nullptr && i < kMaxThreadCacheScan; ++i, link = &(*link)->next) {
+      ThreadCacheChunkHeader* header = *link;
+      if (header->cached_size >= rounded_bytes) {
+        *link = header->next;
+        cache->cached_bytes -= header->cached_size;
+        // only this thread writes the counters
+        cache->num_hits.store(cache->num_hits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return reinterpret_cast<char*>(header) + kThreadCacheHeaderSize;
+      }
+    }
+
+    cache->num_misses.store(cache->num_misses.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  }
+
+  void* ptr = nullptr;
+  ORT_TRY {
+    ptr = AllocateRawInternal(num_bytes + kThreadCacheHeaderSize, false, nullptr, false, nullptr);
+  }
+  ORT_CATCH(const OnnxRuntimeException&) {
+    // the chunks held by the cache of this thread may be enough to satisfy the request
+    ORT_HANDLE_EXCEPTION([&]() {
+      if (ThreadCache* current_cache = CurrentThreadCache()) {
+        FlushThreadCache(*current_cache);
+      }
+      ptr = AllocateRawInternal(num_bytes + kThreadCacheHeaderSize, false, nullptr, false, nullptr);
+    });
+  }
+
+  auto* header = static_cast<ThreadCacheChunkHeader*>(ptr);
+  header->cached_size = cacheable ? rounded_bytes : 0;
+  header->next = nullptr;
+  return static_cast<char*>(ptr) + kThreadCacheHeaderSize;
+}
+
+void BFCArena::FreeToThreadCache(ThreadCacheChunkHeader& header) {
+  ThreadCache* cache = CurrentThreadCache();
+  if (cache == nullptr) {
+    // the caches of the thread were destroyed, the chunk goes back to the arena
+    std::lock_guard<OrtMutex> lock(lock_);
+    DeallocateRawInternal(&header);
+    return;
+  }
+
+  if (cache->cached_bytes + header.cached_size > thread_cache_size_bytes_) {
+    FlushThreadCache(*cache);
+  }
+
+  auto& free_list = cache->free_lists[BinNumForSize(header.cached_size)];
+  header.next = free_list;
+  free_list = &header;
+  cache->cached_bytes += header.cached_size;
+}
+
+void BFCArena::FlushThreadCache(ThreadCache& cache) {
+  if (cache.cached_bytes == 0) {
+    return;
+  }
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  for (auto& free_list : cache.free_lists) {
+    while (free_list != nullptr) {
+      ThreadCacheChunkHeader* next = free_list->next;
+      DeallocateRawInternal(free_list);
+      free_list = next;
+    }
+  }
+
+  cache.cached_bytes = 0;
+}
+
+void BFCArena::ReleaseThreadCache(ThreadCache& cache) {
+  FlushThreadCache(cache);
+
+  std::lock_guard<OrtMutex> lock(lock_);
+  stats_.num_cache_hits += cache.num_hits.load(std::memory_order_relaxed);
+  stats_.num_cache_misses += cache.num_misses.load(std::memory_order_relaxed);
+  thread_caches_.erase(std::find_if(thread_caches_.begin(), thread_caches_.end(),
+                                    [&cache](const std::shared_ptr<ThreadCache>& c) { return c.get() == &cache; }));
 }
 
 BFCArena::Chunk* BFCArena::SplitFreeChunkFromBin(BFCArena::Bin::FreeChunkSet* free_chunks,
@@ -488,6 +718,17 @@ void BFCArena::Free(void* p) {
   if (p == nullptr) {
     return;
   }
+
+  if (thread_cache_size_bytes_ > 0) {
+    ThreadCacheChunkHeader* header = HeaderFromPtr(p);
+    if (header->cached_size != 0) {
+      FreeToThreadCache(*header);
+      return;
+    }
+
+    p = header;
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
   auto it = reserved_chunks_.find(p);
   if (it != reserved_chunks_.end()) {
@@ -501,6 +742,12 @@ void BFCArena::Free(void* p) {
 }
 
 Status BFCArena::Shrink() {
+  if (thread_cache_size_bytes_ > 0) {
+    if (ThreadCache* cache = CurrentThreadCache()) {
+      FlushThreadCache(*cache);
+    }
+  }
+
   std::lock_guard<OrtMutex> lock(lock_);
   auto num_regions = region_manager_.regions().size();
   std::vector<void*> region_ptrs;
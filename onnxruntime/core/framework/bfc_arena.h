@@ -16,9 +16,12 @@ limitations under the License.
 
 #pragma once
 #include <array>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <sstream>
+#include <unordered_map>
+#include <vector>
 
 #include "onnxruntime_config.h"
 
@@ -60,6 +63,9 @@ class BFCArena : public IAllocator {
   static const int DEFAULT_MAX_DEAD_BYTES_PER_CHUNK = 128 * 1024 * 1024;
   static const int DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES = 2 * 1024 * 1024;
   static const size_t DEFAULT_MAX_MEM = std::numeric_limits<size_t>::max();
+  static const int DEFAULT_THREAD_CACHE_SIZE_BYTES = 0;
+  // Bytes in front of each allocation while the per-thread cache is enabled, a multiple of the chunk alignment.
+  static constexpr size_t kThreadCacheHeaderSize = 256;
 
   enum ArenaType {
     BaseArena,
@@ -71,7 +77,8 @@ class BFCArena : public IAllocator {
            ArenaExtendStrategy arena_extend_strategy = DEFAULT_ARENA_EXTEND_STRATEGY,
            int initial_chunk_size_bytes = DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
            int max_dead_bytes_per_chunk = DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
-           int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES);
+           int initial_growth_chunk_size_bytes = DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+           int thread_cache_size_bytes = DEFAULT_THREAD_CACHE_SIZE_BYTES);
 
   ~BFCArena() override;
 
@@ -84,6 +91,8 @@ class BFCArena : public IAllocator {
   void Free(void* p) override;
 
   // Frees all allocation regions in which no chunk is in use.
+  // Chunks held by the per-thread cache of the calling thread are returned to the arena first. The caches of
+  // other threads are not, each holds at most thread_cache_size_bytes.
   // Does not free any reserved chunks.
   // Resets the size that the arena will grow by in the next allocation to
   // `initial_growth_chunk_size_bytes_` but ultimately all
@@ -95,6 +104,8 @@ class BFCArena : public IAllocator {
 
   void GetStats(AllocatorStats* stats) override;
 
+  // For a chunk served from the per-thread cache this is the size requested when the chunk was first
+  // taken from the arena. The sizes do not include the header of the per-thread cache.
   size_t RequestedSize(const void* ptr);
 
   size_t AllocatedSize(const void* ptr);
@@ -428,6 +439,69 @@ class BFCArena : public IAllocator {
   // Computes and returns a BinDebugInfo for each Bin.
   std::array<BinDebugInfo, kNumBins> get_bin_debug_info();
 
+  // Optional per-thread cache in front of the arena. While it is enabled, each pointer returned by Alloc() and
+  // Reserve() is preceded by a ThreadCacheChunkHeader. Free() reads the header, without taking lock_, and pushes a
+  // chunk small enough for the cache onto the free list of the calling thread. The free lists are linked through the
+  // headers, so the cache does not allocate, and only the owning thread uses them, so Alloc() and Free() take no lock
+  // when they are served by the cache. A thread's cache is returned to the arena under a single lock when it would
+  // hold more than thread_cache_size_bytes_, when Shrink() or an allocation that fails is called on the thread, and
+  // when the thread exits. The headers are in the allocated memory, so the cache is only used by CPU arenas.
+  // Size classes match bins 0 to kNumThreadCacheClasses - 1, so allocations smaller than 1MB are cached.
+  static const int kNumThreadCacheClasses = 12;
+  static constexpr size_t kMaxThreadCacheAllocationSize = kMinAllocationSize << kNumThreadCacheClasses;
+  // The number of cached chunks of a size class that an allocation looks at for one that is large enough.
+  static const int kMaxThreadCacheScan = 8;
+
+  struct ThreadCacheChunkHeader {
+    // Rounded size of the chunk without the header if Free() gives it to the per-thread cache, else 0.
+    size_t cached_size;
+    // Next chunk in a free list of the per-thread cache.
+    ThreadCacheChunkHeader* next;
+  };
+
+  // Per-thread cache of one arena. Only the owning thread uses the free lists, the arena reads the counters.
+  struct ThreadCache {
+    ThreadCache(BFCArena* owner, uint64_t owner_id) : arena(owner), arena_id(owner_id) {}
+
+    std::array<ThreadCacheChunkHeader*, kNumThreadCacheClasses> free_lists{};
+    size_t cached_bytes = 0;
+    std::atomic<int64_t> num_hits{0};
+    std::atomic<int64_t> num_misses{0};
+    // Cleared when the arena is destroyed. Guarded by ThreadCacheRegistryMutex().
+    BFCArena* arena;
+    const uint64_t arena_id;
+  };
+
+  // Owns the per-thread caches of a thread, and returns them to their arenas when the thread exits.
+  class ThreadCacheOwner;
+
+  static OrtMutex& ThreadCacheRegistryMutex();
+
+  // Returns the cache of the calling thread, creating it on the first call of the thread. Returns nullptr once the
+  // caches of the thread were destroyed, e.g. for a Free() from a static destructor, the arena is then used directly.
+  ThreadCache* CurrentThreadCache();
+
+  void* AllocWithThreadCache(size_t num_bytes);
+
+  // Adds a chunk whose header has a cached_size to the cache of the calling thread.
+  void FreeToThreadCache(ThreadCacheChunkHeader& header);
+
+  // Returns the chunks held by 'cache' to the arena. Must be called by the owning thread, or once it has exited.
+  void FlushThreadCache(ThreadCache& cache);
+
+  // Flushes 'cache' and stops tracking it, once its thread has exited.
+  void ReleaseThreadCache(ThreadCache& cache);
+
+  static ThreadCacheChunkHeader* HeaderFromPtr(const void* p) {
+    return reinterpret_cast<ThreadCacheChunkHeader*>(const_cast<char*>(static_cast<const char*>(p)) -
+                                                     kThreadCacheHeaderSize);
+  }
+
+  // Returns the pointer the arena knows for a pointer returned by Alloc() or Reserve().
+  const void* ArenaPtr(const void* p) const {
+    return thread_cache_size_bytes_ > 0 ? static_cast<const char*>(p) - kThreadCacheHeaderSize : p;
+  }
+
   // Structures immutable after construction
   size_t memory_limit_ = 0;
   ArenaExtendStrategy arena_extend_strategy_ = ArenaExtendStrategy::kNextPowerOfTwo;
@@ -512,6 +586,15 @@ class BFCArena : public IAllocator {
   // is to be considered for shrinkage or not.
   bool consider_first_allocation_region_for_shrinkage_;
 
+  // 0 if the per-thread cache is disabled.
+  size_t thread_cache_size_bytes_;
+  // Allocations of this size or larger bypass the per-thread cache.
+  size_t max_thread_cache_alloc_size_ = 0;
+  // Identifies the arena in the per-thread caches, unlike its address it is never reused.
+  const uint64_t thread_cache_arena_id_;
+  // The caches of the threads that use the arena. Guarded by lock_.
+  std::vector<std::shared_ptr<ThreadCache>> thread_caches_;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BFCArena);
 };
 #ifdef ORT_ENABLE_STREAM
@@ -0,0 +1,374 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/critical_path_scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <queue>
+
+#include "core/framework/sequential_executor.h"
+#include "core/framework/session_state.h"
+#include "core/framework/stream_execution_context.h"
+#include "core/graph/graph_viewer.h"
+#include "core/platform/threadpool.h"
+
+namespace onnxruntime {
+
+namespace {
+
+// the priorities are refreshed from the measured kernel times after the first run and every
+// kPriorityUpdateInterval runs after that.
+constexpr uint64_t kPriorityUpdateInterval = 16;
+
+// number of elements of a value, with unknown dims counted as 1. returns 0 if the shape is unknown.
+double NumElements(const NodeArg* arg) {
+  if (arg == nullptr || !arg->Exists() || arg->Shape() == nullptr) {
+    return 0.;
+  }
+
+  double num_elements = 1.;
+  for (const auto& dim : arg->Shape()->dim()) {
+    if (dim.has_dim_value() && dim.dim_value() > 0) {
+      num_elements *= static_cast<double>(dim.dim_value());
+    }
+  }
+  return num_elements;
+}
+
+// size of a dim of a value. returns 1 if the dim is unknown.
+double DimValue(const NodeArg* arg, int axis) {
+  if (arg == nullptr || !arg->Exists() || arg->Shape() == nullptr) {
+    return 1.;
+  }
+
+  const auto& shape = *arg->Shape();
+  const int rank = shape.dim_size();
+  if (axis < 0) {
+    axis += rank;
+  }
+  if (axis < 0 || axis >= rank || !shape.dim(axis).has_dim_value() || shape.dim(axis).dim_value() <= 0) {
+    return 1.;
+  }
+  return static_cast<double>(shape.dim(axis).dim_value());
+}
+
+}  // namespace
+
+struct CriticalPathScheduler::RunState {
+  OrtMutex mutex;
+  OrtCondVar cond_var;
+
+  // ready nodes as (priority, position) pairs. the highest priority is on top.
+  std::priority_queue<std::pair<double, size_t>> ready;
+  std::vector<int> num_pending_predecessors;
+  std::shared_ptr<const std::vector<double>> priorities;
+
+  size_t num_remaining = 0;
+  size_t num_in_flight = 0;
+  Status status;
+
+  // total time the workers spent executing kernels
+  int64_t busy_time_ns = 0;
+
+  bool Done() const { return num_remaining == 0 || !status.IsOK(); }
+};
+
+CriticalPathScheduler::CriticalPathScheduler(size_t stream_idx, InlinedVector<NodeIndex> nodes)
+    : stream_idx_(stream_idx),
+      nodes_(std::move(nodes)),
+      successors_(nodes_.size()),
+      num_predecessors_(nodes_.size(), 0),
+      measured_time_ns_(std::make_unique<std::atomic<int64_t>[]>(nodes_.size())) {
+  for (size_t i = 0; i < nodes_.size(); ++i) {
+    measured_time_ns_[i] = 0;
+  }
+}
+
+std::unique_ptr<CriticalPathScheduler> CriticalPathScheduler::Create(const GraphViewer& graph_viewer,
+                                                                     const SequentialExecutionPlan& plan) {
+  const SequentialExecutionPlan::LogicStream* cpu_stream = nullptr;
+  size_t stream_idx = 0;
+  for (size_t i = 0; i < plan.execution_plan.size(); ++i) {
+    const auto& logic_stream = plan.execution_plan[i];
+    if (logic_stream && !logic_stream->steps_.empty()) {
+      if (cpu_stream != nullptr) {
+        return nullptr;
+      }
+      cpu_stream = logic_stream.get();
+      stream_idx = i;
+    }
+  }
+
+  // with a single stream the plan doesn't need any synchronization steps, so every step launches the kernel of
+  // a node. check that anyway so that a plan with other steps keeps using the stream based executor.
+  if (cpu_stream == nullptr || cpu_stream->device_.Type() != OrtDevice::CPU ||
+      cpu_stream->steps_.size() != static_cast<size_t>(graph_viewer.NumberOfNodes())) {
+    return nullptr;
+  }
+
+  InlinedVector<NodeIndex> nodes;
+  nodes.reserve(cpu_stream->steps_.size());
+  InlinedHashMap<NodeIndex, size_t> node_pos;
+  node_pos.reserve(cpu_stream->steps_.size());
+  for (const auto& step : cpu_stream->steps_) {
+    const NodeIndex node_index = step->GetNodeIndex();
+    if (graph_viewer.GetNode(node_index) == nullptr || !node_pos.emplace(node_index, nodes.size()).second) {
+      return nullptr;
+    }
+    nodes.push_back(node_index);
+  }
+
+  std::unique_ptr<CriticalPathScheduler> scheduler{new CriticalPathScheduler(stream_idx, std::move(nodes))};
+  auto& successors = scheduler->successors_;
+  auto& num_predecessors = scheduler->num_predecessors_;
+
+  std::vector<double> costs;
+  costs.reserve(scheduler->nodes_.size());
+  for (size_t pos = 0; pos < scheduler->nodes_.size(); ++pos) {
+    const Node& node = *graph_viewer.GetNode(scheduler->nodes_[pos]);
+    costs.push_back(EstimateNodeCost(node));
+
+    // a node may consume several outputs of the same producer, but only waits for it once
+    InlinedHashSet<size_t> producers;
+    for (auto it = node.InputNodesBegin(), end = node.InputNodesEnd(); it != end; ++it) {
+      auto producer = node_pos.find(it->Index());
+      if (producer == node_pos.end()) {
+        continue;
+      }
+
+      // the plan is topologically sorted. if it's not, the node would never become ready.
+      if (producer->second >= pos) {
+        return nullptr;
+      }
+
+      if (producers.insert(producer->second).second) {
+        successors[producer->second].push_back(pos);
+        ++num_predecessors[pos];
+      }
+    }
+  }
+
+  scheduler->priorities_ = scheduler->ComputePriorities(costs);
+  return scheduler;
+}
+
+double CriticalPathScheduler::EstimateNodeCost(const Node& node) {
+  const auto& op_type = node.OpType();
+  const auto inputs = node.InputDefs();
+
+  double num_output_elements = 0.;
+  for (const auto* output : node.OutputDefs()) {
+    num_output_elements += NumElements(output);
+  }
+
+  double cost = num_output_elements;
+  if (op_type == "MatMul" || op_type == "MatMulInteger" || op_type == "FusedMatMul" ||
+      op_type == "Gemm" || op_type == "FusedGemm") {
+    // 2 * M * N * K, where the output is M x N and K is the inner dim of the first input
+    bool trans_a = false;
+    if (op_type == "Gemm" || op_type == "FusedGemm") {
+      const auto& attrs = node.GetAttributes();
+      auto attr = attrs.find("transA");
+      trans_a = attr != attrs.end() && attr->second.i() != 0;
+    }
+    if (!inputs.empty()) {
+      cost = 2. * num_output_elements * DimValue(inputs[0], trans_a ? 0 : -1);
+    }
+  } else if (op_type == "Conv" || op_type == "FusedConv" || op_type == "NhwcConv" || op_type == "ConvInteger" ||
+             op_type == "QLinearConv") {
+    // 2 * output elements * (input channels per group * kernel size), from the weight shape [M, C/group, k...]
+    const size_t weight_idx = op_type == "QLinearConv" ? 3 : 1;
+    if (inputs.size() > weight_idx) {
+      const double weight_elements = NumElements(inputs[weight_idx]);
+      const double num_filters = DimValue(inputs[weight_idx], 0);
+      if (weight_elements > 0.) {
+        cost = 2. * num_output_elements * (weight_elements / num_filters);
+      }
+    }
+  }
+
+  return std::max(cost, 1.);
+}
+
+std::shared_ptr<const std::vector<double>> CriticalPathScheduler::ComputePriorities(
+    gsl::span<const double> costs) const {
+  auto priorities = std::make_shared<std::vector<double>>(nodes_.size(), 0.);
+  for (size_t pos = nodes_.size(); pos-- > 0;) {
+    double longest_successor_path = 0.;
+    for (size_t successor : successors_[pos]) {
+      longest_successor_path = std::max(longest_successor_path, (*priorities)[successor]);
+    }
+    (*priorities)[pos] = costs[pos] + longest_successor_path;
+  }
+  return priorities;
+}
+
+std::shared_ptr<const std::vector<double>> CriticalPathScheduler::GetPriorities() const {
+  std::lock_guard<OrtMutex> lock(priorities_mutex_);
+  return priorities_;
+}
+
+void CriticalPathScheduler::RecordNodeTime(size_t node_pos, int64_t duration_ns) const {
+  // exponential moving average with a weight of 1/4 for the new measurement
+  duration_ns = std::max<int64_t>(duration_ns, 1);
+  const int64_t average = measured_time_ns_[node_pos].load(std::memory_order_relaxed);
+  measured_time_ns_[node_pos].store(average == 0 ? duration_ns : (3 * average + duration_ns) / 4,
+                                    std::memory_order_relaxed);
+}
+
+void CriticalPathScheduler::UpdatePriorities() const {
+  std::vector<double> costs;
+  costs.reserve(nodes_.size());
+  for (size_t pos = 0; pos < nodes_.size(); ++pos) {
+    const int64_t time_ns = measured_time_ns_[pos].load(std::memory_order_relaxed);
+    // all the nodes were measured if the run completed. keep the current priorities if it didn't.
+    if (time_ns == 0) {
+      return;
+    }
+    costs.push_back(static_cast<double>(time_ns));
+  }
+
+  auto priorities = ComputePriorities(costs);
+  std::lock_guard<OrtMutex> lock(priorities_mutex_);
+  priorities_ = std::move(priorities);
+}
+
+void CriticalPathScheduler::WorkerLoop(const CriticalPathScheduler& scheduler, RunState& state,
+                                       StreamExecutionContext& ctx, SessionScope& session_scope,
+                                       const bool& terminate_flag) {
+  std::unique_lock<OrtMutex> lock(state.mutex);
+  for (;;) {
+    state.cond_var.wait(lock, [&state]() { return state.Done() || !state.ready.empty(); });
+    if (state.Done()) {
+      return;
+    }
+
+    const size_t pos = state.ready.top().second;
+    state.ready.pop();
+    ++state.num_in_flight;
+    lock.unlock();
+
+    Status status;
+    const auto start = std::chrono::steady_clock::now();
+    if (terminate_flag) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Exiting due to terminate flag being set to true.");
+    } else {
+      ORT_TRY {
+        status = ExecuteKernel(ctx, scheduler.nodes_[pos], scheduler.stream_idx_, terminate_flag, session_scope);
+      }
+      ORT_CATCH(const std::exception& ex) {
+        ORT_HANDLE_EXCEPTION([&]() {
+          status = ORT_MAKE_STATUS(ONNXRUNTIME, RUNTIME_EXCEPTION, ex.what());
+        });
+      }
+    }
+    const int64_t duration_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    if (status.IsOK()) {
+      scheduler.RecordNodeTime(pos, duration_ns);
+    }
+
+    lock.lock();
+    --state.num_in_flight;
+    state.busy_time_ns += duration_ns;
+    if (!status.IsOK()) {
+      if (state.status.IsOK()) {
+        state.status = status;
+      }
+      state.cond_var.notify_all();
+      continue;
+    }
+
+    --state.num_remaining;
+    size_t num_ready = 0;
+    for (size_t successor : scheduler.successors_[pos]) {
+      if (--state.num_pending_predecessors[successor] == 0) {
+        state.ready.emplace((*state.priorities)[successor], successor);
+        ++num_ready;
+      }
+    }
+
+    // this worker takes one of the ready nodes itself
+    if (state.Done()) {
+      state.cond_var.notify_all();
+    } else {
+      for (size_t i = 1; i < num_ready; ++i) {
+        state.cond_var.notify_one();
+      }
+    }
+  }
+}
+
+Status CriticalPathScheduler::Execute(StreamExecutionContext& ctx, SessionScope& session_scope,
+                                      const bool& terminate_flag, concurrency::ThreadPool* thread_pool) const {
+  if (nodes_.empty()) {
+    return Status::OK();
+  }
+
+  auto& profiler = ctx.GetSessionState().Profiler();
+  TimePoint profile_start;
+  if (profiler.IsEnabled()) {
+    profile_start = profiler.Start();
+  }
+  const auto start = std::chrono::steady_clock::now();
+
+  // the state is shared with the helper tasks as one may only start after the run has completed.
+  // it must not touch ctx in that case, which it doesn't as there are no nodes left to run.
+  auto state = std::make_shared<RunState>();
+  state->priorities = GetPriorities();
+  state->num_pending_predecessors = num_predecessors_;
+  state->num_remaining = nodes_.size();
+  for (size_t pos = 0; pos < nodes_.size(); ++pos) {
+    if (num_predecessors_[pos] == 0) {
+      state->ready.emplace((*state->priorities)[pos], pos);
+    }
+  }
+
+  // the number of nodes that can run concurrently is bounded by the number of nodes
+  const int num_workers = static_cast<int>(std::min<size_t>(
+      static_cast<size_t>(concurrency::ThreadPool::DegreeOfParallelism(thread_pool)), nodes_.size()));
+  for (int i = 1; i < num_workers; ++i) {
+    concurrency::ThreadPool::Schedule(thread_pool, [this, state, &ctx, &session_scope, &terminate_flag]() {
+      WorkerLoop(*this, *state, ctx, session_scope, terminate_flag);
+    });
+  }
+
+  WorkerLoop(*this, *state, ctx, session_scope, terminate_flag);
+
+  Status status;
+  int64_t busy_time_ns = 0;
+  {
+    // the nodes that were started must complete before the execution frame can be released
+    std::unique_lock<OrtMutex> lock(state->mutex);
+    state->cond_var.wait(lock, [&state]() { return state->num_in_flight == 0; });
+    status = state->status;
+    busy_time_ns = state->busy_time_ns;
+  }
+
+  if (status.IsOK()) {
+    const uint64_t num_runs = ++num_runs_;
+    if (num_runs == 1 || num_runs % kPriorityUpdateInterval == 0) {
+      UpdatePriorities();
+    }
+  }
+
+  if (profiler.IsEnabled()) {
+    const int64_t wall_time_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    const int64_t idle_time_ns = std::max<int64_t>(wall_time_ns * num_workers - busy_time_ns, 0);
+    const double achieved_parallelism =
+        wall_time_ns > 0 ? static_cast<double>(busy_time_ns) / static_cast<double>(wall_time_ns) : 0.;
+    profiler.EndTimeAndRecordEvent(
+        profiling::SESSION_EVENT, "CriticalPathScheduler::Execute", profile_start,
+        {{"num_workers", std::to_string(num_workers)},
+         {"num_nodes", std::to_string(nodes_.size())},
+         {"achieved_parallelism", std::to_string(achieved_parallelism)},
+         {"busy_time_us", std::to_string(busy_time_ns / 1000)},
+         {"idle_time_us", std::to_string(idle_time_ns / 1000)}});
+  }
+
+  return status;
+}
+
+}  // namespace onnxruntime
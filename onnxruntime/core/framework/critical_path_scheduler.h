@@ -0,0 +1,102 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/graph/basic_types.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+class GraphViewer;
+class Node;
+class SessionScope;
+class StreamExecutionContext;
+
+namespace concurrency {
+class ThreadPool;
+}
+
+/**
+ * List scheduler for ORT_PARALLEL execution of a CPU only graph.
+ *
+ * The execution plan of a graph that runs entirely on the CPU has a single logic stream, so the stream based
+ * executor runs its nodes one after the other. This scheduler instead dispatches the nodes to the inter op
+ * thread pool as soon as their inputs are available. When more nodes are ready than there are workers, the node
+ * with the longest path of remaining work to the end of the graph (its critical path) runs first.
+ *
+ * The cost of a node is initially a static estimate of its FLOP count from the shapes in the graph. After a run
+ * the measured kernel times are used instead, and the priorities are refreshed periodically from a moving average
+ * of the measurements, so the schedule adapts to the actual input shapes.
+ *
+ * If profiling is enabled, each run records the achieved parallelism and the idle time of the workers.
+ */
+class CriticalPathScheduler {
+ public:
+  /**
+   * Create the scheduler for the execution plan of a graph.
+   * @return the scheduler, or nullptr if the plan has more than one logic stream or does not run on the CPU.
+   */
+  static std::unique_ptr<CriticalPathScheduler> Create(const GraphViewer& graph_viewer,
+                                                       const SequentialExecutionPlan& plan);
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(CriticalPathScheduler);
+
+  /**
+   * Execute all the nodes of the graph. The calling thread executes nodes, and up to
+   * DegreeOfParallelism(thread_pool) - 1 threads of the pool help it.
+   * Returns once all nodes have completed, or once the nodes that were started have completed after a failure.
+   */
+  Status Execute(StreamExecutionContext& ctx, SessionScope& session_scope, const bool& terminate_flag,
+                 concurrency::ThreadPool* thread_pool) const;
+
+  // priority of each node in the order of the execution plan. the priority is the cost of the longest path from
+  // the node to the end of the graph, including the cost of the node.
+  std::shared_ptr<const std::vector<double>> GetPriorities() const;
+
+  gsl::span<const NodeIndex> GetNodes() const { return nodes_; }
+
+  // static cost estimate of a node, based on the FLOP count of common compute bound ops and the number of
+  // output elements of the others. unknown dims count as 1.
+  static double EstimateNodeCost(const Node& node);
+
+ private:
+  struct RunState;
+
+  CriticalPathScheduler(size_t stream_idx, InlinedVector<NodeIndex> nodes);
+
+  static void WorkerLoop(const CriticalPathScheduler& scheduler, RunState& state, StreamExecutionContext& ctx,
+                         SessionScope& session_scope, const bool& terminate_flag);
+
+  // compute the priorities from the costs, in reverse order of the plan which is topologically sorted
+  std::shared_ptr<const std::vector<double>> ComputePriorities(gsl::span<const double> costs) const;
+
+  void RecordNodeTime(size_t node_pos, int64_t duration_ns) const;
+
+  void UpdatePriorities() const;
+
+  // index of the logic stream of the nodes in the execution plan
+  const size_t stream_idx_;
+
+  // nodes in the order of the execution plan
+  InlinedVector<NodeIndex> nodes_;
+
+  // positions of the consumers of each node, and the number of distinct producers each node waits for
+  std::vector<InlinedVector<size_t>> successors_;
+  std::vector<int> num_predecessors_;
+
+  // moving average of the measured kernel time of each node. 0 if the node has not been measured.
+  std::unique_ptr<std::atomic<int64_t>[]> measured_time_ns_;
+  mutable std::atomic<uint64_t> num_runs_{0};
+
+  mutable OrtMutex priorities_mutex_;
+  mutable std::shared_ptr<const std::vector<double>> priorities_;
+};
+
+}  // namespace onnxruntime
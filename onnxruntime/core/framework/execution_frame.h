@@ -10,6 +10,7 @@
 #include "core/common/logging/logging.h"
 #include "core/common/status.h"
 #include "core/framework/iexecutor.h"
+#include "core/framework/memory_pattern_cache.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/ort_value_pattern_planner.h"
@@ -221,7 +222,9 @@ class ExecutionFrame final : public IExecutionFrame {
   // If we already have cached memory pattern on these input shapes
   // Use this mem pattern that create a big chunk for all the internal
   // kernel's input/output tensors.
-  const MemoryPatternGroup* mem_patterns_;
+  // mem_pattern_entry_ keeps the cache entry alive if it's evicted during execution.
+  std::shared_ptr<const MemoryPatternCache::Entry> mem_pattern_entry_;
+  const MemoryPatternGroup* mem_patterns_{nullptr};
 
   // If no cached memory pattern, and we enable the memory pattern optimization
   // use this planner_ to trace the memory allocation in current executor.
@@ -233,7 +236,7 @@ class ExecutionFrame final : public IExecutionFrame {
   // Given the input shapes of the executed graph, ExecutionFrame tries inferring
   // all symbolic shapes. inferred_shapes_[i] is the shape of OrtValue indexed
   // by i, if the key i exists.
-  // inferred_shapes_ is generated together with mem_patterns_.
+  // inferred_shapes_ is generated together with mem_patterns_, and is owned by mem_pattern_entry_.
   // It is never updated after creation
   const InlinedHashMap<int, TensorShape>* inferred_shapes_{nullptr};
 
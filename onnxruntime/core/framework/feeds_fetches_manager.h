@@ -99,10 +99,20 @@ class FeedsFetchesManager {
   const DeviceCopyChecks& GetDeviceCopyChecks() const { return device_copy_checks_; }
   void SetDeviceCopyChecks(DeviceCopyCheck input_copy_needed, DeviceCopyCheck output_copy_needed);
 
+  // Reset the device copy checks so they are re-evaluated for the feeds and fetches of the next execution.
+  // Used when the same instance is reused across executions.
+  void ResetDeviceCopyChecks() { device_copy_checks_ = {}; }
+
+  // The static copy info only depends on the session state, so an instance that is reused across executions only
+  // needs utils::InitializeFeedFetchCopyInfo to be called once.
+  bool IsStaticCopyInfoInitialized() const { return static_copy_info_initialized_; }
+  void SetStaticCopyInfoInitialized() { static_copy_info_initialized_ = true; }
+
  private:
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(FeedsFetchesManager);
 
   DeviceCopyChecks device_copy_checks_ = {};
+  bool static_copy_info_initialized_ = false;
 
   FeedsFetchesInfo feeds_fetches_info_;
 
@@ -0,0 +1,161 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/memory_pattern_cache.h"
+
+#include <algorithm>
+#include <functional>
+
+#include "core/common/parse_string.h"
+#include "core/common/string_utils.h"
+#include "core/framework/tensor.h"
+
+namespace onnxruntime {
+
+MemoryPatternCache::MemoryPatternCache(size_t max_entries, std::vector<int64_t> dim_buckets)
+    : max_entries_(max_entries), dim_buckets_(std::move(dim_buckets)) {
+  ORT_ENFORCE(std::is_sorted(dim_buckets_.begin(), dim_buckets_.end()), "Dim buckets must be in ascending order.");
+}
+
+Status MemoryPatternCache::ParseDimBuckets(std::string_view str, std::vector<int64_t>& dim_buckets) {
+  dim_buckets.clear();
+  if (str.empty()) {
+    return Status::OK();
+  }
+
+  for (const auto& bucket_str : utils::SplitString(str, ",", true)) {
+    int64_t bucket = 0;
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(bucket_str, bucket) && bucket > 0,
+                      "Invalid dim bucket '", bucket_str, "' in '", str, "'. Dim buckets must be positive integers.");
+    ORT_RETURN_IF_NOT(dim_buckets.empty() || bucket > dim_buckets.back(),
+                      "Dim buckets must be in strictly ascending order: '", str, "'");
+    dim_buckets.push_back(bucket);
+  }
+
+  return Status::OK();
+}
+
+size_t MemoryPatternCache::KeyHash::operator()(const Key& key) const noexcept {
+  // boost::hash_combine
+  size_t hash = key.size();
+  for (int64_t value : key) {
+    hash ^= std::hash<int64_t>{}(value) + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+  }
+  return hash;
+}
+
+int64_t MemoryPatternCache::BucketDim(int64_t dim) const {
+  auto bucket = std::lower_bound(dim_buckets_.begin(), dim_buckets_.end(), dim);
+  return bucket == dim_buckets_.end() ? dim : *bucket;
+}
+
+MemoryPatternCache::Key MemoryPatternCache::MakeKey(gsl::span<const OrtValue> tensor_inputs) const {
+  Key key;
+  for (const auto& input : tensor_inputs) {
+    const auto dims = input.Get<Tensor>().Shape().GetDims();
+    // include the rank so that e.g. shapes {2, 3} + {4} and {2} + {3, 4} differ
+    key.push_back(static_cast<int64_t>(dims.size()));
+    for (int64_t dim : dims) {
+      key.push_back(BucketDim(dim));
+    }
+  }
+  return key;
+}
+
+bool MemoryPatternCache::Covers(const Entry& entry, gsl::span<const OrtValue> tensor_inputs) {
+  if (entry.input_shapes.size() != tensor_inputs.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < tensor_inputs.size(); ++i) {
+    const auto entry_dims = entry.input_shapes[i].GetDims();
+    const auto dims = tensor_inputs[i].Get<Tensor>().Shape().GetDims();
+    if (entry_dims.size() != dims.size()) {
+      return false;
+    }
+
+    for (size_t j = 0; j < dims.size(); ++j) {
+      if (entry_dims[j] < dims[j]) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+bool MemoryPatternCache::HasExactShapes(const Entry& entry, gsl::span<const OrtValue> tensor_inputs) {
+  if (entry.input_shapes.size() != tensor_inputs.size()) {
+    return false;
+  }
+
+  for (size_t i = 0; i < tensor_inputs.size(); ++i) {
+    if (entry.input_shapes[i] != tensor_inputs[i].Get<Tensor>().Shape()) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::shared_ptr<const MemoryPatternCache::Entry> MemoryPatternCache::Find(gsl::span<const OrtValue> tensor_inputs) {
+  const Key key = MakeKey(tensor_inputs);
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(key);
+  // without dim buckets the key contains the exact dims, so the entry always covers the inputs
+  if (it == entries_.end() || (!dim_buckets_.empty() && !Covers(*it->second->second, tensor_inputs))) {
+    ++stats_.misses;
+    return nullptr;
+  }
+
+  ++stats_.hits;
+  lru_.splice(lru_.begin(), lru_, it->second);
+  return it->second->second;
+}
+
+std::shared_ptr<const MemoryPatternCache::Entry> MemoryPatternCache::Insert(
+    gsl::span<const OrtValue> tensor_inputs,
+    MemoryPatternGroup mem_patterns,
+    InlinedHashMap<int, TensorShape> inferred_shapes) {
+  Key key = MakeKey(tensor_inputs);
+
+  auto entry = std::make_shared<Entry>();
+  entry->mem_patterns = std::move(mem_patterns);
+  entry->inferred_shapes = std::move(inferred_shapes);
+  entry->input_shapes.reserve(tensor_inputs.size());
+  for (const auto& input : tensor_inputs) {
+    entry->input_shapes.push_back(input.Get<Tensor>().Shape());
+  }
+
+  std::lock_guard<OrtMutex> lock(mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end()) {
+    // another run may have added an entry since the lookup. keep it unless it's too small for these inputs.
+    if (!Covers(*it->second->second, tensor_inputs)) {
+      it->second->second = std::move(entry);
+    }
+
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return it->second->second;
+  }
+
+  if (max_entries_ != 0 && entries_.size() >= max_entries_) {
+    entries_.erase(lru_.back().first);
+    lru_.pop_back();
+    ++stats_.evictions;
+  }
+
+  lru_.emplace_front(key, std::move(entry));
+  entries_.emplace(std::move(key), lru_.begin());
+  return lru_.front().second;
+}
+
+MemoryPatternCache::Stats MemoryPatternCache::GetStats() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  Stats stats = stats_;
+  stats.num_entries = entries_.size();
+  return stats;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,120 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <list>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/mem_pattern.h"
+#include "core/framework/ort_value.h"
+#include "core/framework/tensor_shape.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+
+/**
+ * Cache of the memory patterns generated for the input shapes of a graph, with least recently used eviction.
+ *
+ * The key is the full shape signature of the inputs (rank and dims of each input), so inputs with different shapes
+ * never share an entry. If dim buckets are configured each input dim is rounded up to the smallest bucket it fits in
+ * before it is used in the key, so e.g. all sequence lengths in (32, 64] share one entry. The entry of a bucket is
+ * only used if it was generated for input dims at least as large as those of the request, so every block in the
+ * pattern is large enough for the value that is allocated in it. Otherwise the lookup is a miss, and the pattern
+ * generated for the request replaces the entry.
+ *
+ * Entries are handed out as shared pointers so an entry that is evicted or replaced remains valid for the execution
+ * frames that are still using it.
+ *
+ * All methods are thread safe.
+ */
+class MemoryPatternCache {
+ public:
+  struct Entry {
+    MemoryPatternGroup mem_patterns;
+
+    // shapes of the values that could be resolved statically. only generated in training builds. see
+    // SessionState::GeneratePatternGroupCache.
+    InlinedHashMap<int, TensorShape> inferred_shapes;
+
+    // shapes of the inputs the entry was generated for
+    InlinedVector<TensorShape> input_shapes;
+  };
+
+  struct Stats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t num_entries = 0;
+  };
+
+  /**
+   * @param max_entries maximum number of entries. 0 does not limit the number of entries.
+   * @param dim_buckets ascending bucket sizes that input dims are rounded up to. dims larger than the last bucket are
+   *        used as-is. empty to key the entries on the exact input dims.
+   */
+  explicit MemoryPatternCache(size_t max_entries = 0, std::vector<int64_t> dim_buckets = {});
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(MemoryPatternCache);
+
+  /**
+   * Parse a comma separated list of positive, strictly ascending dim bucket sizes, e.g. "16,32,64,128".
+   */
+  static Status ParseDimBuckets(std::string_view str, std::vector<int64_t>& dim_buckets);
+
+  /**
+   * Find the entry for the shapes of the tensor_inputs, and mark it as the most recently used.
+   * @return the entry, or nullptr if there is no entry that can be used for the input shapes.
+   */
+  std::shared_ptr<const Entry> Find(gsl::span<const OrtValue> tensor_inputs);
+
+  /**
+   * Add the entry for the shapes of the tensor_inputs. An existing entry for the same key is only replaced if it can
+   * not be used for the input shapes. Evicts the least recently used entry if the cache is full.
+   * @return the entry for the key after the insertion.
+   */
+  std::shared_ptr<const Entry> Insert(gsl::span<const OrtValue> tensor_inputs,
+                                      MemoryPatternGroup mem_patterns,
+                                      InlinedHashMap<int, TensorShape> inferred_shapes = {});
+
+  Stats GetStats() const;
+
+  size_t MaxEntries() const { return max_entries_; }
+
+  const std::vector<int64_t>& DimBuckets() const { return dim_buckets_; }
+
+  // returns true if the entry was generated for the exact shapes of the tensor_inputs
+  static bool HasExactShapes(const Entry& entry, gsl::span<const OrtValue> tensor_inputs);
+
+ private:
+  using Key = std::vector<int64_t>;
+
+  struct KeyHash {
+    size_t operator()(const Key& key) const noexcept;
+  };
+
+  using LruList = std::list<std::pair<Key, std::shared_ptr<const Entry>>>;
+
+  Key MakeKey(gsl::span<const OrtValue> tensor_inputs) const;
+
+  int64_t BucketDim(int64_t dim) const;
+
+  // returns true if every dim of the inputs the entry was generated for is at least as large as those of the inputs
+  static bool Covers(const Entry& entry, gsl::span<const OrtValue> tensor_inputs);
+
+  const size_t max_entries_;
+  const std::vector<int64_t> dim_buckets_;
+
+  mutable OrtMutex mutex_;
+  // most recently used entry at the front
+  LruList lru_;
+  std::unordered_map<Key, LruList::iterator, KeyHash> entries_;
+  Stats stats_;
+};
+
+}  // namespace onnxruntime
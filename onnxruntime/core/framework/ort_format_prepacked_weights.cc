@@ -0,0 +1,225 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/ort_format_prepacked_weights.h"
+
+#include <cstring>
+#include <sstream>
+#include <vector>
+
+#include "core/common/cpuid_info.h"
+#include "core/common/gsl.h"
+#include "core/flatbuffers/schema/ort.fbs.h"
+#include "core/framework/config_options.h"
+#include "core/graph/graph.h"
+#include "core/graph/op_identifier_utils.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "onnxruntime_config.h"
+
+namespace fb = flatbuffers;
+
+namespace onnxruntime {
+
+namespace {
+// alignment of the saved pre-packed buffers. matches the alignment of the CPU allocator so that the buffers can be
+// used in place if the ORT format model bytes are suitably aligned as well.
+constexpr size_t kPrePackedBufferAlignment = 64;
+}  // namespace
+
+std::string OrtFormatPrePackedWeights::GetPlatformFingerprint(const ConfigOptions& config_options) {
+  std::ostringstream ss;
+  ss << "ort:" << ORT_VERSION;
+
+#if defined(CPUIDINFO_ARCH_X86)
+  ss << ";arch:x86_" << sizeof(void*) * 8;
+#elif defined(CPUIDINFO_ARCH_ARM)
+  ss << ";arch:arm_" << sizeof(void*) * 8;
+#else
+  ss << ";arch:other_" << sizeof(void*) * 8;
+#endif
+
+  // the MLAS kernels, and therefore the packed layouts, are selected based on these features
+  const auto& cpuid_info = CPUIDInfo::GetCPUIDInfo();
+  ss << ";isa:"
+     << cpuid_info.HasSSE3()
+     << cpuid_info.HasSSE4_1()
+     << cpuid_info.HasAVX()
+     << cpuid_info.HasAVX2()
+     << cpuid_info.HasF16C()
+     << cpuid_info.HasAVX512f()
+     << cpuid_info.HasAVX512Skylake()
+     << cpuid_info.HasAVX512_BF16()
+     << cpuid_info.HasAMX_BF16()
+     << cpuid_info.HasArmNeonDot()
+     << cpuid_info.HasFp16VectorAcceleration();
+
+  // affects which quantized GEMM kernels are used
+  ss << ";x64quantprecision:"
+     << config_options.GetConfigOrDefault(kOrtSessionOptionsAvx2PrecisionMode, "0");
+
+  return ss.str();
+}
+
+std::string OrtFormatPrePackedWeights::GetSubgraphId(const std::string& parent_graph_id, NodeIndex parent_node_index,
+                                                     const std::string& attribute_name) {
+  return MakeString(parent_graph_id, "/", parent_node_index, ":", attribute_name);
+}
+
+std::string OrtFormatPrePackedWeights::MakeKey(const std::string& graph_id, NodeIndex node_index, int input_idx) {
+  return MakeString(graph_id, "|", node_index, "|", input_idx);
+}
+
+const OrtFormatPrePackedWeights::Entry* OrtFormatPrePackedWeights::GetEntry(
+    const std::string& graph_id, const Node& node, int input_idx, const std::string& initializer_name) const {
+  const auto it = entries_.find(MakeKey(graph_id, node.Index(), input_idx));
+  if (it == entries_.end()) {
+    return nullptr;
+  }
+
+  // the graph may differ from the one that was saved, e.g. if runtime optimizations were applied after loading.
+  // only use the entry if it is for the same operator and initializer.
+  const Entry& entry = it->second;
+  if (entry.initializer_name != initializer_name || !(entry.op_id == utils::MakeOpId(node))) {
+    return nullptr;
+  }
+
+  return &entry;
+}
+
+const PrePackedWeights& OrtFormatPrePackedWeights::AddEntry(const std::string& graph_id, const Node& node,
+                                                            int input_idx, const std::string& initializer_name,
+                                                            PrePackedWeights&& prepacked_weights,
+                                                            bool save) {
+  if (!save) {
+    unsaved_weights_.push_back(std::make_unique<PrePackedWeights>(std::move(prepacked_weights)));
+    return *unsaved_weights_.back();
+  }
+
+  Entry& entry = entries_[MakeKey(graph_id, node.Index(), input_idx)];
+  entry.graph_id = graph_id;
+  entry.node_index = node.Index();
+  entry.input_idx = input_idx;
+  entry.op_id = utils::MakeOpId(node);
+  entry.initializer_name = initializer_name;
+  entry.weights = std::move(prepacked_weights);
+  return entry.weights;
+}
+
+#if !defined(ORT_MINIMAL_BUILD)
+Status OrtFormatPrePackedWeights::SaveToOrtFormat(
+    fb::FlatBufferBuilder& builder, const ConfigOptions& config_options,
+    fb::Offset<fbs::PrePackedWeightsInfo>& fbs_prepacked_weights) const {
+  std::vector<fb::Offset<fbs::PrePackedWeightsEntry>> fbs_entries;
+  fbs_entries.reserve(entries_.size());
+
+  for (const auto& key_and_entry : entries_) {
+    const Entry& entry = key_and_entry.second;
+    const auto& weights = entry.weights;
+    ORT_RETURN_IF_NOT(weights.buffers_.size() == weights.buffer_sizes_.size(),
+                      "Mismatch in the number of pre-packed buffers and buffer sizes for ", entry.initializer_name);
+
+    std::vector<fb::Offset<fbs::PrePackedBuffer>> fbs_buffers;
+    fbs_buffers.reserve(weights.buffers_.size());
+    for (size_t i = 0, end = weights.buffers_.size(); i < end; ++i) {
+      // some pre-packed buffers may be null if they are place-holders occupying an index. save them as empty.
+      const size_t size = weights.buffers_[i] ? weights.buffer_sizes_[i] : 0;
+      builder.ForceVectorAlignment(size, sizeof(uint8_t), kPrePackedBufferAlignment);
+      auto fbs_data = builder.CreateVector(static_cast<const uint8_t*>(weights.buffers_[i].get()), size);
+      fbs_buffers.push_back(fbs::CreatePrePackedBuffer(builder, fbs_data));
+    }
+
+    fb::Offset<fb::String> fbs_op_id;
+    ORT_RETURN_IF_ERROR(fbs::utils::SaveOpIdentifierOrtFormat(builder, entry.op_id, fbs_op_id));
+
+    fbs_entries.push_back(fbs::CreatePrePackedWeightsEntry(
+        builder,
+        builder.CreateSharedString(entry.graph_id),
+        gsl::narrow<uint32_t>(entry.node_index),
+        fbs_op_id,
+        gsl::narrow<int32_t>(entry.input_idx),
+        builder.CreateSharedString(entry.initializer_name),
+        builder.CreateVector(fbs_buffers)));
+  }
+
+  fbs_prepacked_weights = fbs::CreatePrePackedWeightsInfo(
+      builder,
+      builder.CreateString(GetPlatformFingerprint(config_options)),
+      builder.CreateVector(fbs_entries));
+
+  return Status::OK();
+}
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
+bool OrtFormatPrePackedWeights::IsCompatible(const fbs::PrePackedWeightsInfo& fbs_prepacked_weights,
+                                             const ConfigOptions& config_options) {
+  const auto* fbs_fingerprint = fbs_prepacked_weights.platform_fingerprint();
+  return fbs_fingerprint != nullptr && fbs_fingerprint->str() == GetPlatformFingerprint(config_options);
+}
+
+Status OrtFormatPrePackedWeights::LoadFromOrtFormat(const fbs::PrePackedWeightsInfo& fbs_prepacked_weights,
+                                                    bool can_use_flatbuffer_for_buffers) {
+  entries_.clear();
+
+  const auto* fbs_entries = fbs_prepacked_weights.entries();
+  if (fbs_entries == nullptr) {
+    return Status::OK();
+  }
+
+  for (const auto* fbs_entry : *fbs_entries) {
+    ORT_RETURN_IF(nullptr == fbs_entry, "PrePackedWeightsEntry is null. Invalid ORT format model.");
+
+    const auto* fbs_op_id = fbs_entry->op_id();
+    const auto* fbs_initializer_name = fbs_entry->initializer_name();
+    const auto* fbs_buffers = fbs_entry->buffers();
+    ORT_RETURN_IF(nullptr == fbs_op_id || nullptr == fbs_initializer_name || nullptr == fbs_buffers,
+                  "Missing required field in PrePackedWeightsEntry. Invalid ORT format model.");
+
+    Entry entry;
+    entry.graph_id = fbs_entry->graph_id() ? fbs_entry->graph_id()->str() : std::string{};
+    entry.node_index = fbs_entry->node_index();
+    entry.input_idx = fbs_entry->input_index();
+    ORT_RETURN_IF_ERROR(fbs::utils::LoadOpIdentifierOrtFormat(*fbs_op_id, entry.op_id));
+    entry.initializer_name = fbs_initializer_name->str();
+
+    auto& weights = entry.weights;
+    weights.buffers_.reserve(fbs_buffers->size());
+    weights.buffer_sizes_.reserve(fbs_buffers->size());
+
+    for (const auto* fbs_buffer : *fbs_buffers) {
+      ORT_RETURN_IF(nullptr == fbs_buffer, "PrePackedBuffer is null. Invalid ORT format model.");
+
+      const auto* fbs_data = fbs_buffer->data();
+      const size_t size = fbs_data ? fbs_data->size() : 0;
+      if (size == 0) {
+        weights.buffers_.emplace_back(nullptr, BufferDeleter(nullptr));
+        weights.buffer_sizes_.push_back(0);
+        continue;
+      }
+
+      const uint8_t* data = fbs_data->data();
+      if (can_use_flatbuffer_for_buffers && reinterpret_cast<uintptr_t>(data) % kPrePackedBufferAlignment == 0) {
+        // kernels only read from the pre-packed buffers so it's safe to refer to the flatbuffer data.
+        // the deleter is nullptr as the buffer is owned by the flatbuffer.
+        weights.buffers_.emplace_back(const_cast<uint8_t*>(data), BufferDeleter(nullptr));
+      } else {
+        if (!allocator_) {
+          allocator_ = std::make_shared<CPUAllocator>();
+        }
+
+        void* buffer = allocator_->Alloc(size);
+        std::memcpy(buffer, data, size);
+        weights.buffers_.emplace_back(buffer, BufferDeleter(allocator_));
+      }
+
+      weights.buffer_sizes_.push_back(size);
+    }
+
+    auto key = MakeKey(entry.graph_id, entry.node_index, entry.input_idx);
+    const auto [it, inserted] = entries_.try_emplace(std::move(key), std::move(entry));
+    ORT_RETURN_IF_NOT(inserted, "Duplicate PrePackedWeightsEntry for ", it->first, ". Invalid ORT format model.");
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
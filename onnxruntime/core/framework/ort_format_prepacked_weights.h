@@ -0,0 +1,132 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/status.h"
+#include "core/framework/allocator.h"
+#include "core/framework/prepacked_weights.h"
+#include "core/graph/basic_types.h"
+#include "core/graph/op_identifier.h"
+
+namespace flatbuffers {
+class FlatBufferBuilder;
+template <typename T>
+struct Offset;
+}  // namespace flatbuffers
+
+namespace onnxruntime {
+
+namespace fbs {
+struct PrePackedWeightsInfo;
+}  // namespace fbs
+
+struct ConfigOptions;
+class Node;
+
+/**
+ * Pre-packed weights that are stored in an ORT format model.
+ *
+ * When saving an ORT format model with the session option "session.save_prepacked_weights" set to "1", the pre-packed
+ * buffers produced by the CPU EP kernels are collected here and written alongside the model. When that model is loaded
+ * on a platform with a matching fingerprint, kernels that support it can use the stored buffers directly instead of
+ * repeating the packing work on every session creation.
+ *
+ * An entry is identified by the graph it belongs to, the node index and the input index. The op identifier and the
+ * initializer name are stored to validate that the loaded graph matches the one the buffers were produced for.
+ */
+class OrtFormatPrePackedWeights {
+ public:
+  struct Entry {
+    std::string graph_id;
+    NodeIndex node_index{};
+    int input_idx{};
+    OpIdentifier op_id;
+    std::string initializer_name;
+    PrePackedWeights weights;
+  };
+
+  OrtFormatPrePackedWeights() = default;
+
+  /**
+   * Gets a string describing the properties of the current platform that the layout of pre-packed weights may depend
+   * on. Pre-packed weights are only loaded if the fingerprint they were saved with matches.
+   * @param config_options The session configuration options.
+   */
+  static std::string GetPlatformFingerprint(const ConfigOptions& config_options);
+
+  /**
+   * Gets the identifier of a subgraph for use in the entry lookup.
+   * The main graph has an empty identifier.
+   * @param parent_graph_id The identifier of the graph containing the node that owns the subgraph.
+   * @param parent_node_index The index of the node that owns the subgraph.
+   * @param attribute_name The name of the subgraph attribute.
+   */
+  static std::string GetSubgraphId(const std::string& parent_graph_id, NodeIndex parent_node_index,
+                                   const std::string& attribute_name);
+
+  const Entry* GetEntry(const std::string& graph_id, const Node& node, int input_idx,
+                        const std::string& initializer_name) const;
+
+  size_t NumEntries() const { return entries_.size(); }
+
+  /**
+   * Adds the pre-packed weights for an initializer.
+   * @param prepacked_weights The pre-packed weights. Ownership of the buffers is transferred to this instance.
+   * @param save If true, the pre-packed weights are saved with the model. Otherwise they are only held for use by
+   *             the kernel, e.g. because the kernel does not support using stored pre-packed weights.
+   * @return The held pre-packed weights.
+   */
+  const PrePackedWeights& AddEntry(const std::string& graph_id, const Node& node, int input_idx,
+                                   const std::string& initializer_name, PrePackedWeights&& prepacked_weights,
+                                   bool save);
+
+#if !defined(ORT_MINIMAL_BUILD)
+  /**
+   * Saves to an ORT format model representation.
+   * @param builder The flatbuffers builder.
+   * @param config_options The session configuration options, used to generate the platform fingerprint.
+   * @param[out] fbs_prepacked_weights The saved flatbuffers representation offset.
+   */
+  Status SaveToOrtFormat(flatbuffers::FlatBufferBuilder& builder, const ConfigOptions& config_options,
+                         flatbuffers::Offset<fbs::PrePackedWeightsInfo>& fbs_prepacked_weights) const;
+#endif  // !defined(ORT_MINIMAL_BUILD)
+
+  /**
+   * Checks whether the pre-packed weights stored in an ORT format model can be used on the current platform.
+   */
+  static bool IsCompatible(const fbs::PrePackedWeightsInfo& fbs_prepacked_weights,
+                           const ConfigOptions& config_options);
+
+  /**
+   * Loads from an ORT format model representation.
+   * @param fbs_prepacked_weights The flatbuffers representation to load.
+   * @param can_use_flatbuffer_for_buffers If true, suitably aligned buffers refer to the flatbuffer data directly.
+   *                                       The flatbuffer must then remain valid for the lifetime of this instance.
+   *                                       Otherwise the buffers are copied.
+   */
+  Status LoadFromOrtFormat(const fbs::PrePackedWeightsInfo& fbs_prepacked_weights,
+                           bool can_use_flatbuffer_for_buffers);
+
+ private:
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OrtFormatPrePackedWeights);
+
+  static std::string MakeKey(const std::string& graph_id, NodeIndex node_index, int input_idx);
+
+  // ordered so the saved output is deterministic
+  std::map<std::string, Entry> entries_;
+
+  // pre-packed weights that are in use by a kernel but are not saved
+  std::vector<std::unique_ptr<PrePackedWeights>> unsaved_weights_;
+
+  // allocator for buffers that are copied out of the flatbuffer
+  AllocatorPtr allocator_;
+};
+
+}  // namespace onnxruntime
@@ -2,10 +2,135 @@
 // Licensed under the MIT License.
 
 #include "core/framework/prepacked_weights_container.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include "core/common/logging/logging.h"
+#include "core/common/safeint.h"
 #include "core/framework/allocatormgr.h"
+#include "core/platform/path_lib.h"
 
 namespace onnxruntime {
 
+namespace {
+// Layout of a file containing the pre-packed buffers of a PrePackedWeights instance:
+//   SharedWeightFileHeader
+//   SharedWeightFileBufferInfo[num_buffers]
+//   buffer data, each buffer starting at an offset that is a multiple of kSharedWeightBufferAlignment
+// A buffer that is a place-holder (nullptr) has a size of 0 and is_null set.
+constexpr char kSharedWeightFileMagic[8] = {'O', 'R', 'T', 'P', 'P', 'W', '0', '1'};
+constexpr size_t kSharedWeightBufferAlignment = 64;
+
+struct SharedWeightFileHeader {
+  char magic[8];
+  uint64_t num_buffers;
+};
+
+struct SharedWeightFileBufferInfo {
+  uint64_t offset;
+  uint64_t size;
+  uint64_t is_null;
+};
+
+size_t AlignSharedWeightOffset(size_t offset) {
+  return (offset + kSharedWeightBufferAlignment - 1) & ~(kSharedWeightBufferAlignment - 1);
+}
+
+PathString GetSharedWeightFilePath(const PathString& shared_directory, const std::string& key) {
+  // the key is op_type + "+" + hash. replace anything that may not be valid in a file name.
+  std::string file_name;
+  file_name.reserve(key.size() + 6);
+  for (const char c : key) {
+    const bool is_valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                          c == '_' || c == '-' || c == '+';
+    file_name.push_back(is_valid ? c : '_');
+  }
+  file_name += ".ortpw";
+
+  return ConcatPathComponent<ORTCHAR_T>(shared_directory, ToPathString(file_name));
+}
+
+int RenameFile(const PathString& from, const PathString& to) {
+#ifdef _WIN32
+  return _wrename(from.c_str(), to.c_str());
+#else
+  return std::rename(from.c_str(), to.c_str());
+#endif
+}
+
+void RemoveFile(const PathString& path) {
+#ifdef _WIN32
+  _wremove(path.c_str());
+#else
+  std::remove(path.c_str());
+#endif
+}
+
+Status WriteSharedWeightFile(const PathString& file_path, const PrePackedWeights& packed_weight) {
+  const size_t num_buffers = packed_weight.buffers_.size();
+
+  std::vector<SharedWeightFileBufferInfo> buffer_infos(num_buffers);
+  size_t offset = sizeof(SharedWeightFileHeader) + num_buffers * sizeof(SharedWeightFileBufferInfo);
+  for (size_t i = 0; i < num_buffers; ++i) {
+    const bool is_null = packed_weight.buffers_[i] == nullptr;
+    offset = AlignSharedWeightOffset(offset);
+    buffer_infos[i].offset = offset;
+    buffer_infos[i].size = is_null ? 0 : packed_weight.buffer_sizes_[i];
+    buffer_infos[i].is_null = is_null ? 1 : 0;
+    offset = SafeInt<size_t>(offset) + buffer_infos[i].size;
+  }
+
+  // write to a file that is unique to this process and rename it once complete, so other processes never see a
+  // partially written file.
+  const PathString temp_file_path = file_path + ToPathString(MakeString(".", Env::Default().GetSelfPid(), ".tmp"));
+  {
+    std::ofstream file(temp_file_path, std::ios::binary | std::ios::trunc);
+    ORT_RETURN_IF_NOT(file, "Failed to create file for shared pre-packed weight: ", PathToUTF8String(temp_file_path));
+
+    SharedWeightFileHeader header{};
+    std::memcpy(header.magic, kSharedWeightFileMagic, sizeof(header.magic));
+    header.num_buffers = num_buffers;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(buffer_infos.data()),
+               static_cast<std::streamsize>(num_buffers * sizeof(SharedWeightFileBufferInfo)));
+
+    static const char padding[kSharedWeightBufferAlignment] = {};
+    size_t written = sizeof(SharedWeightFileHeader) + num_buffers * sizeof(SharedWeightFileBufferInfo);
+    for (size_t i = 0; i < num_buffers; ++i) {
+      file.write(padding, static_cast<std::streamsize>(buffer_infos[i].offset - written));
+      file.write(static_cast<const char*>(packed_weight.buffers_[i].get()),
+                 static_cast<std::streamsize>(buffer_infos[i].size));
+      written = static_cast<size_t>(buffer_infos[i].offset + buffer_infos[i].size);
+    }
+
+    file.close();
+    if (!file) {
+      RemoveFile(temp_file_path);
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Failed to write shared pre-packed weight: ",
+                             PathToUTF8String(temp_file_path));
+    }
+  }
+
+  // if another process published the same file first the rename may fail on some platforms. that's fine as the
+  // content is verified when the file is mapped.
+  if (RenameFile(temp_file_path, file_path) != 0) {
+    RemoveFile(temp_file_path);
+  }
+
+  return Status::OK();
+}
+}  // namespace
+
+PrepackedWeightsContainer::PrepackedWeightsContainer(const PathString& shared_directory)
+    : shared_directory_(shared_directory) {
+  ORT_ENFORCE(!shared_directory_.empty(), "The directory for shared pre-packed weights must not be empty.");
+  if (!Env::Default().FolderExists(shared_directory_)) {
+    ORT_THROW_IF_ERROR(Env::Default().CreateFolder(shared_directory_));
+  }
+}
+
 AllocatorPtr PrepackedWeightsContainer::GetOrCreateAllocator(const std::string& device_name) {
   auto iter = allocators_.find(device_name);
 
@@ -36,10 +161,87 @@ const PrePackedWeights& PrepackedWeightsContainer::GetWeight(const std::string&
 }
 
 bool PrepackedWeightsContainer::WriteWeight(const std::string& key, PrePackedWeights&& packed_weight) {
+  if (HasWeight(key)) {
+    return false;
+  }
+
+  if (!shared_directory_.empty()) {
+    PrePackedWeights shared_weight;
+    auto status = MapSharedWeight(key, packed_weight, shared_weight);
+    if (status.IsOK()) {
+      // this frees the buffers owned by this process in favor of the ones shared across processes
+      packed_weight = std::move(shared_weight);
+    } else {
+      LOGS_DEFAULT(WARNING) << "Unable to share the pre-packed weight " << key
+                            << " across processes. It will only be shared within this process. "
+                            << status.ErrorMessage();
+    }
+  }
+
   auto ret = prepacked_weights_map_.insert(std::make_pair(key, std::move(packed_weight)));
   return ret.second;
 }
 
+Status PrepackedWeightsContainer::MapSharedWeight(const std::string& key, const PrePackedWeights& packed_weight,
+                                                  PrePackedWeights& shared_weight) {
+  ORT_RETURN_IF_NOT(packed_weight.buffers_.size() == packed_weight.buffer_sizes_.size(),
+                    "Mismatch in the number of pre-packed buffers and buffer sizes.");
+
+  const PathString file_path = GetSharedWeightFilePath(shared_directory_, key);
+
+  size_t file_length = 0;
+  if (!Env::Default().GetFileLength(file_path.c_str(), file_length).IsOK()) {
+    // not published yet
+    ORT_RETURN_IF_ERROR(WriteSharedWeightFile(file_path, packed_weight));
+    ORT_RETURN_IF_ERROR(Env::Default().GetFileLength(file_path.c_str(), file_length));
+  }
+
+  const size_t num_buffers = packed_weight.buffers_.size();
+  const size_t header_length = sizeof(SharedWeightFileHeader) + num_buffers * sizeof(SharedWeightFileBufferInfo);
+  ORT_RETURN_IF(file_length < header_length, "Shared pre-packed weight file is too small: ", PathToUTF8String(file_path));
+
+  Env::MappedMemoryPtr mapped_file;
+  ORT_RETURN_IF_ERROR(Env::Default().MapFileIntoMemory(file_path.c_str(), 0, file_length, mapped_file));
+  const char* file_data = mapped_file.get();
+
+  SharedWeightFileHeader header;
+  std::memcpy(&header, file_data, sizeof(header));
+  ORT_RETURN_IF(std::memcmp(header.magic, kSharedWeightFileMagic, sizeof(header.magic)) != 0 ||
+                    header.num_buffers != num_buffers,
+                "Unexpected header in shared pre-packed weight file: ", PathToUTF8String(file_path));
+
+  std::vector<SharedWeightFileBufferInfo> buffer_infos(num_buffers);
+  std::memcpy(buffer_infos.data(), file_data + sizeof(header), num_buffers * sizeof(SharedWeightFileBufferInfo));
+
+  // the key only contains a hash of the buffers so compare the content before using the shared copy
+  shared_weight.buffers_.reserve(num_buffers);
+  shared_weight.buffer_sizes_.reserve(num_buffers);
+  for (size_t i = 0; i < num_buffers; ++i) {
+    const auto& info = buffer_infos[i];
+    const bool is_null = packed_weight.buffers_[i] == nullptr;
+    const size_t size = is_null ? 0 : packed_weight.buffer_sizes_[i];
+    ORT_RETURN_IF(info.is_null != (is_null ? 1u : 0u) || info.size != size ||
+                      info.offset % kSharedWeightBufferAlignment != 0 || info.offset > file_length ||
+                      info.size > file_length - info.offset,
+                  "Unexpected buffer info in shared pre-packed weight file: ", PathToUTF8String(file_path));
+
+    if (is_null) {
+      shared_weight.buffers_.emplace_back(nullptr, BufferDeleter(nullptr));
+    } else {
+      char* data = mapped_file.get() + info.offset;
+      ORT_RETURN_IF(std::memcmp(data, packed_weight.buffers_[i].get(), size) != 0,
+                    "Content mismatch in shared pre-packed weight file: ", PathToUTF8String(file_path));
+      // BufferDeleter is nullptr as the buffer is owned by the mapped file
+      shared_weight.buffers_.emplace_back(data, BufferDeleter(nullptr));
+    }
+
+    shared_weight.buffer_sizes_.push_back(packed_weight.buffer_sizes_[i]);
+  }
+
+  mapped_files_.push_back(std::move(mapped_file));
+  return Status::OK();
+}
+
 bool PrepackedWeightsContainer::HasWeight(const std::string& key) const {
   return prepacked_weights_map_.find(key) !=
          prepacked_weights_map_.end();
@@ -7,10 +7,13 @@
 #include <unordered_set>
 #include <string>
 #include <cstdint>
+#include <vector>
 
+#include "core/common/path_string.h"
 #include "core/framework/buffer_deleter.h"
 
 #include "core/framework/allocator.h"
+#include "core/platform/env.h"
 #include "core/platform/ort_mutex.h"
 #include "prepacked_weights.h"
 
@@ -21,6 +24,14 @@ class PrepackedWeightsContainer final {
   PrepackedWeightsContainer() {
   }
 
+  // Creates a container that also shares the pre-packed weights with other processes.
+  // Each pre-packed weight written to the container is published to a file in shared_directory that is named
+  // using the key, which contains a hash of the pre-packed buffers. If the file was already published by another
+  // process it is used instead. The file is memory mapped and the pre-packed buffers refer to the mapped memory,
+  // so the physical memory for the pre-packed weights is shared by all processes using the same directory.
+  // The directory is created if it doesn't exist.
+  explicit PrepackedWeightsContainer(const PathString& shared_directory);
+
   ~PrepackedWeightsContainer() = default;
 
   // Returns an allocator keyed by device name.
@@ -47,6 +58,11 @@ class PrepackedWeightsContainer final {
   // Returns the number of elements in the container
   size_t GetNumberOfElements() const;
 
+  // Returns the number of elements in the container that refer to memory mapped files shared across processes
+  size_t GetNumberOfSharedFileElements() const {
+    return mapped_files_.size();
+  }
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PrepackedWeightsContainer);
 
   // Resource to be acquired by the method that is going to invoke calls to the kernels'
@@ -60,10 +76,25 @@ class PrepackedWeightsContainer final {
   // because the Tensor buffers will be de-allocated using these allocators
   std::unordered_map<std::string, AllocatorPtr> allocators_;
 
+  // Directory for the files containing the pre-packed weights that are shared across processes.
+  // Empty if the pre-packed weights are only shared within this process.
+  const PathString shared_directory_;
+
+  // Memory mapped files that pre-packed buffers in prepacked_weights_map_ refer to.
+  // Defined ahead of prepacked_weights_map_ so they are unmapped after it is destructed.
+  std::vector<Env::MappedMemoryPtr> mapped_files_;
+
   // This is an unordered map that holds a mapping between a composite key
   // to PrePackedWeights instances.
   // The key is : op_type + "+" + hash_of_prepacked_buffers_in_the_PrepackedWeights_instance.
   std::unordered_map<std::string, PrePackedWeights> prepacked_weights_map_;
+
+ private:
+  // Publishes the pre-packed weights to the file for key in shared_directory_ if it doesn't exist, and maps the file
+  // into memory. The file content is verified against packed_weight.
+  // On success, shared_weight contains buffers that refer to the mapped file.
+  Status MapSharedWeight(const std::string& key, const PrePackedWeights& packed_weight,
+                         PrePackedWeights& shared_weight);
 };
 
 }  // namespace onnxruntime
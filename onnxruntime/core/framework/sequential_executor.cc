@@ -578,16 +578,25 @@ onnxruntime::Status ExecuteThePlan(const SessionState& session_state, gsl::span<
 
   auto* tp = single_thread_mode ? nullptr : session_state.GetInterOpThreadPool();
 
-  for (size_t i = 0; i < execution_plan->execution_plan.size(); ++i) {
-    if (execution_plan->execution_plan[i]->steps_.empty()) {
-      // execution context is initialized with number of valid streams
-      // for invalid stream (0 steps), it doesn't count in number of tasks
-      // so don't need to invoke CompleteTask here
-      // ctx.CompleteTask();
-    } else {
-      concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope]() {
-        RunSince(i, ctx, session_scope, terminate_flag, 0);
-      });
+  const auto* critical_path_scheduler = session_state.GetCriticalPathScheduler();
+  if (critical_path_scheduler && !only_execute_path_to_fetches &&
+      concurrency::ThreadPool::DegreeOfParallelism(tp) > 1) {
+    auto status = critical_path_scheduler->Execute(ctx, session_scope, terminate_flag, tp);
+    ctx.SetStatus(status);
+    // the scheduler runs in place of the stream
+    ctx.CompleteTask();
+  } else {
+    for (size_t i = 0; i < execution_plan->execution_plan.size(); ++i) {
+      if (execution_plan->execution_plan[i]->steps_.empty()) {
+        // execution context is initialized with number of valid streams
+        // for invalid stream (0 steps), it doesn't count in number of tasks
+        // so don't need to invoke CompleteTask here
+        // ctx.CompleteTask();
+      } else {
+        concurrency::ThreadPool::Schedule(tp, [i, &ctx, &terminate_flag, &session_scope]() {
+          RunSince(i, ctx, session_scope, terminate_flag, 0);
+        });
+      }
     }
   }
 
@@ -7,6 +7,7 @@
 
 #include "core/platform/ort_mutex.h"
 #include "core/common/logging/logging.h"
+#include "core/common/parse_string.h"
 #include "core/common/safeint.h"
 #include "core/flatbuffers/schema/ort.fbs.h"
 #include "core/framework/allocator.h"
@@ -401,9 +402,38 @@ static std::string GenerateKeyForPrepackedWeightsMap(const std::string& op_type,
   return ss_1.str();
 }
 
+std::string SessionState::GetOrtFormatGraphId() const {
+  if (parent_ == nullptr) {
+    return std::string{};
+  }
+
+  for (const auto& [node_index, attribute_to_session_state] : parent_->subgraph_session_states_) {
+    for (const auto& [attribute_name, session_state] : attribute_to_session_state) {
+      if (session_state.get() == this) {
+        return OrtFormatPrePackedWeights::GetSubgraphId(parent_->GetOrtFormatGraphId(), node_index, attribute_name);
+      }
+    }
+  }
+
+  ORT_THROW("SessionState was not found in the subgraph session states of its parent.");
+}
+
 Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                                        const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map) {
-  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map](
+  // the pre-packed weights from, or to be saved to, an ORT format model are set on the main graph SessionState
+  const SessionState* root = this;
+  while (root->parent_ != nullptr) {
+    root = root->parent_;
+  }
+
+  OrtFormatPrePackedWeights* const ort_format_prepacked_weights = root->ort_format_prepacked_weights_;
+  const bool saving_ort_format_prepacked_weights = root->saving_ort_format_prepacked_weights_;
+  const std::string ort_format_graph_id = ort_format_prepacked_weights != nullptr ? GetOrtFormatGraphId()
+                                                                                  : std::string{};
+
+  auto prepacked_constant_weights = [this, &constant_initializers_use_count, &initializers_to_share_map,
+                                     ort_format_prepacked_weights, saving_ort_format_prepacked_weights,
+                                     &ort_format_graph_id](
                                         bool should_cache_prepacked_weights_for_shared_initializers) -> Status {
     for (auto& node : GetGraphViewer().Nodes()) {
       auto kernel = GetMutableKernel(node.Index());
@@ -421,14 +451,56 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
 
               if (constant_initialized_tensors.count(ort_value_idx)) {
                 bool is_packed = false;
+                bool is_restored = false;
                 const Tensor& const_initialized_tensor = constant_initialized_tensors[ort_value_idx].Get<Tensor>();
 
                 auto iter = initializers_to_share_map.find(input_name);
                 bool is_shared_initializer = (iter != initializers_to_share_map.end());
 
-                // Caching pre-packed weights is limited to shared initializers associated with the CPU EP for now
-                if (is_shared_initializer && should_cache_prepacked_weights_for_shared_initializers &&
-                    node.GetExecutionProviderType() == kCpuExecutionProvider) {  // caching of pre-packed weights' turned ON
+                // Storing pre-packed weights in an ORT format model is limited to the CPU EP
+                const bool use_ort_format_prepacked_weights =
+                    ort_format_prepacked_weights != nullptr && node.GetExecutionProviderType() == kCpuExecutionProvider;
+
+                if (use_ort_format_prepacked_weights && !saving_ort_format_prepacked_weights) {
+                  const auto* stored = ort_format_prepacked_weights->GetEntry(ort_format_graph_id, node, input_idx,
+                                                                             input_name);
+                  if (stored != nullptr) {
+                    ORT_RETURN_IF_ERROR(kernel->RestorePrePackState(const_initialized_tensor, input_idx,
+                                                                    stored->weights.buffer_sizes_, is_restored));
+                    if (is_restored) {
+                      ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx, stored->weights,
+                                                                          node.Name()));
+                    }
+                  }
+                }
+
+                if (is_restored) {
+                  LOGS(logger_, VERBOSE) << "Using pre-packed weight from the ORT format model for constant initializer: "
+                                         << input_name << " used in the node: " << node.Name();
+                } else if (use_ort_format_prepacked_weights && saving_ort_format_prepacked_weights) {
+                  AllocatorPtr session_cpu_alloc = kernel->Info().GetAllocator(OrtMemType::OrtMemTypeDefault);
+                  PrePackedWeights weights_to_be_saved;
+                  ORT_RETURN_IF_ERROR(kernel->PrePack(const_initialized_tensor, input_idx, session_cpu_alloc,
+                                                      is_packed, &weights_to_be_saved));
+
+                  if (is_packed) {
+                    ORT_ENFORCE(weights_to_be_saved.buffers_.size() > 0, "The kernel corresponding to the node ",
+                                node.Name(), " doesn't have an implementation that can cache computed pre-packed weights");
+
+                    // only save the pre-packed weights if the kernel is able to use them when the model is loaded.
+                    // RestorePrePackState sets the same state as PrePack did so it's safe to call it here.
+                    bool can_restore = false;
+                    ORT_RETURN_IF_ERROR(kernel->RestorePrePackState(const_initialized_tensor, input_idx,
+                                                                    weights_to_be_saved.buffer_sizes_, can_restore));
+
+                    const auto& held_weights = ort_format_prepacked_weights->AddEntry(
+                        ort_format_graph_id, node, input_idx, input_name, std::move(weights_to_be_saved), can_restore);
+                    ORT_RETURN_IF_ERROR(KernelUseSharedPrePackedBuffers(*kernel, input_idx, held_weights, node.Name()));
+                  }
+                } else if (is_shared_initializer && should_cache_prepacked_weights_for_shared_initializers &&
+                           node.GetExecutionProviderType() == kCpuExecutionProvider) {
+                  // Caching pre-packed weights is limited to shared initializers associated with the CPU EP for now
+                  // caching of pre-packed weights' turned ON
 
                   AllocatorPtr allocator_for_caching = prepacked_weights_container_->GetOrCreateAllocator(CPU);
                   ORT_ENFORCE(allocator_for_caching.get() != nullptr);
@@ -491,8 +563,12 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
                                                       nullptr  // no caching required
                                                       ));
                 }
-                if (is_packed) {
-                  ++number_of_prepacks_counter_;
+                if (is_packed || is_restored) {
+                  if (is_restored) {
+                    ++number_of_restored_prepacks_counter_;
+                  } else {
+                    ++number_of_prepacks_counter_;
+                  }
 
                   if (constant_initializers_use_count.count(input_name) && --constant_initializers_use_count[input_name] == 0) {
                     // release the constant initialized tensor
@@ -530,14 +606,6 @@ Status SessionState::PrepackConstantInitializedTensors(InlinedHashMap<std::strin
   }
 }
 
-static int64_t CalculateMemoryPatternsKey(const gsl::span<const OrtValue>& tensor_inputs) {
-  int64_t key = 0;
-  for (const auto& input : tensor_inputs) {
-    for (auto dim : input.Get<Tensor>().Shape().GetDims()) key ^= dim;
-  }
-  return key;
-}
-
 #ifdef ENABLE_TRAINING
 namespace {
 Status ResolveDimParams(const GraphViewer& graph,
@@ -772,38 +840,38 @@ Status SessionState::GeneratePatternGroupCache(gsl::span<const OrtValue> tensor_
 
 #endif
 
-// MemoryPatternGroup pointer is cached. It only inserted upon creation
-// and is not updated if already present.
-const MemoryPatternGroup* SessionState::GetMemoryPatternGroup(
+std::shared_ptr<const MemoryPatternCache::Entry> SessionState::GetMemoryPatternGroup(
     gsl::span<const OrtValue> tensor_inputs,
     gsl::span<const int> feed_mlvalue_idxs,
     const InlinedHashMap<int, TensorShape>*& out_inferred_shapes) const {
   out_inferred_shapes = nullptr;
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  auto it = mem_patterns_.find(key);
-  if (it == mem_patterns_.end()) {
+  if (static_mem_patterns_) {
+    return static_mem_patterns_;
+  }
+
+  if (!mem_pattern_cache_) {
+    return nullptr;
+  }
+
+  auto entry = mem_pattern_cache_->Find(tensor_inputs);
+  if (!entry) {
 #ifdef ENABLE_TRAINING
     MemoryPatternGroup mem_patterns;
     InlinedHashMap<int, TensorShape> inferred_shapes;
     if (GeneratePatternGroupCache(tensor_inputs, feed_mlvalue_idxs, mem_patterns, inferred_shapes).IsOK()) {
-      auto patt_insert = mem_patterns_.insert_or_assign(key, std::move(mem_patterns));
-      auto ptr = &patt_insert.first->second;
-      auto shape_insert = shape_patterns_.insert_or_assign(key, std::move(inferred_shapes));
-      out_inferred_shapes = &shape_insert.first->second;
-      return ptr;
+      entry = mem_pattern_cache_->Insert(tensor_inputs, std::move(mem_patterns), std::move(inferred_shapes));
     }
 #else
     ORT_UNUSED_PARAMETER(feed_mlvalue_idxs);
 #endif
-    return nullptr;
   }
 
-  auto patt_hit = shape_patterns_.find(key);
-  if (patt_hit != shape_patterns_.cend()) {
-    out_inferred_shapes = &patt_hit->second;
+  // the inferred shapes are only valid for the shapes the entry was generated for
+  if (entry && MemoryPatternCache::HasExactShapes(*entry, tensor_inputs)) {
+    out_inferred_shapes = &entry->inferred_shapes;
   }
-  return &it->second;
+
+  return entry;
 }
 
 void SessionState::ResolveMemoryPatternFlag() {
@@ -850,18 +918,46 @@ void SessionState::ResolveMemoryPatternFlag() {
       }
     }
   }
+
+  if (enable_mem_pattern_ && !static_memory_plan_dim_bounds_.empty()) {
+    StaticMemoryPlanner::Plan plan;
+    auto status = StaticMemoryPlanner::CreatePlan(*graph_viewer_, ort_value_name_idx_map_, *p_seq_exec_plan_,
+                                                  static_memory_plan_dim_bounds_, plan);
+    if (status.IsOK() && plan.stats.num_planned_values == 0) {
+      status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "None of the ", plan.stats.num_dynamic_values,
+                               " values to allocate have a shape that is bounded by the dim bounds.");
+    }
+
+    if (status.IsOK()) {
+      auto entry = std::make_shared<MemoryPatternCache::Entry>();
+      entry->mem_patterns = std::move(plan.mem_patterns);
+      static_mem_patterns_ = std::move(entry);
+      static_memory_plan_stats_ = plan.stats;
+
+      LOGS(logger_, INFO) << "Static memory plan of graph " << graph_viewer_->Name() << ": peak size "
+                          << plan.stats.peak_size << " bytes for " << plan.stats.num_planned_values
+                          << " values with a total size of " << plan.stats.total_size << " bytes. "
+                          << plan.stats.num_dynamic_values
+                          << " values without bounded shapes are allocated at runtime.";
+    } else {
+      LOGS(logger_, WARNING) << "Static memory planning is not possible for graph " << graph_viewer_->Name()
+                             << ". The memory patterns are traced at runtime. " << status.ErrorMessage();
+    }
+  }
 }
 
 Status SessionState::UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                                    MemoryPatternGroup mem_patterns) const {
-  int64_t key = CalculateMemoryPatternsKey(tensor_inputs);
-
-  std::lock_guard<OrtMutex> lock(mem_patterns_lock_);
-  // Do not update if present, as the pointer to the existing one is cached
-  mem_patterns_.emplace(key, std::move(mem_patterns));
+  if (mem_pattern_cache_) {
+    mem_pattern_cache_->Insert(tensor_inputs, std::move(mem_patterns));
+  }
   return Status::OK();
 }
 
+MemoryPatternCache::Stats SessionState::GetMemoryPatternCacheStats() const {
+  return mem_pattern_cache_ ? mem_pattern_cache_->GetStats() : MemoryPatternCache::Stats{};
+}
+
 bool SessionState::GetEnableMemoryPattern() const { return enable_mem_pattern_; }
 
 bool SessionState::GetEnableMemoryReuse() const { return sess_options_.enable_mem_reuse; }
@@ -1410,6 +1506,12 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
                                               p_seq_exec_plan_);
   ORT_RETURN_IF_ERROR(status);
 
+  if (session_options.execution_mode == ExecutionMode::ORT_PARALLEL &&
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigDisableCriticalPathScheduler,
+                                                        "0") != "1") {
+    critical_path_scheduler_ = CriticalPathScheduler::Create(*graph_viewer_, *p_seq_exec_plan_);
+  }
+
   // Record the allocation plan
 
   // Uncomment the below to dump the allocation plan to std::cout
@@ -1419,6 +1521,20 @@ Status SessionState::FinalizeSessionStateImpl(const std::basic_string<PATH_CHAR_
   GetMemoryProfiler()->Init(GetExecutionPlan(), GetOrtValueNameIdxMap());
 #endif
 
+  size_t mem_pattern_cache_size = 0;
+  ORT_RETURN_IF_ERROR(ParseStringWithClassicLocale(
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternCacheSize, "0"),
+      mem_pattern_cache_size));
+  std::vector<int64_t> mem_pattern_dim_buckets;
+  ORT_RETURN_IF_ERROR(MemoryPatternCache::ParseDimBuckets(
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigMemoryPatternDimBuckets, ""),
+      mem_pattern_dim_buckets));
+  mem_pattern_cache_ = std::make_unique<MemoryPatternCache>(mem_pattern_cache_size,
+                                                            std::move(mem_pattern_dim_buckets));
+  ORT_RETURN_IF_ERROR(StaticMemoryPlanner::ParseDimBounds(
+      session_options.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigStaticMemoryPlanDimBounds, ""),
+      static_memory_plan_dim_bounds_));
+
   // Note: For Training Prepacking should be always disabled.
   // For inference it is enabled by default, but users can choose to disable it via session options.
   const bool disable_prepacking =
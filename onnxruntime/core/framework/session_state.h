@@ -16,6 +16,7 @@
 #include "core/common/profiler.h"
 #include "core/framework/allocation_planner.h"
 #include "core/framework/callback.h"
+#include "core/framework/critical_path_scheduler.h"
 #include "core/framework/data_transfer_manager.h"
 #include "core/framework/execution_providers.h"
 #include "core/framework/stream_execution_context.h"
@@ -25,10 +26,13 @@
 #include "core/framework/fuse_nodes_funcs.h"
 #include "core/framework/kernel_registry_manager.h"
 #include "core/framework/mem_pattern.h"
+#include "core/framework/memory_pattern_cache.h"
 #include "core/framework/ort_value.h"
 #include "core/framework/node_index_info.h"
 #include "core/framework/op_kernel.h"
+#include "core/framework/ort_format_prepacked_weights.h"
 #include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/static_memory_planner.h"
 #include "core/graph/graph_viewer.h"
 #include "core/graph/onnx_protobuf.h"
 #include "core/platform/ort_mutex.h"
@@ -187,6 +191,10 @@ class SessionState {
 
   const std::vector<AllocPlanPerValue>& GetPerValueAllocPlan() const;
 
+  // scheduler for ORT_PARALLEL execution of a CPU only graph.
+  // nullptr if the graph uses the stream based executor.
+  const CriticalPathScheduler* GetCriticalPathScheduler() const { return critical_path_scheduler_.get(); }
+
   /**
   Get the logger for this session.
   Falls back to returning Logging::LoggingManager::DefaultLogger if SetLogger has not been called.
@@ -210,13 +218,12 @@ class SessionState {
   /**
   Get cached memory pattern based on input shapes
   Must be called only when all values contain tensors
-  In training scenarios, the cache may be updated so
-  the callers would receive a copy of inferred shapes
-  made under mutex being held. In inference scenarios,
-  it is not mutable, we do not obtain a lock and simply get a pointer
-  w/o copying a hashtable
+  The returned entry stays valid while it is held, even if it is
+  evicted from the cache. inferred_shapes points into the entry, and is
+  set only if the entry was generated for the exact input shapes, which
+  may not be the case if dim buckets are configured.
   */
-  const MemoryPatternGroup* GetMemoryPatternGroup(
+  std::shared_ptr<const MemoryPatternCache::Entry> GetMemoryPatternGroup(
       gsl::span<const OrtValue> tensor_inputs,
       gsl::span<const int> feed_mlvalue_idxs,
       const InlinedHashMap<int, TensorShape>*& inferred_shapes) const;
@@ -229,6 +236,20 @@ class SessionState {
   Status UpdateMemoryPatternGroupCache(gsl::span<const OrtValue> tensor_inputs,
                                        MemoryPatternGroup mem_patterns) const;
 
+  /**
+  Get the hit, miss and eviction counts of the memory pattern cache.
+  */
+  MemoryPatternCache::Stats GetMemoryPatternCacheStats() const;
+
+  /**
+  Get the statistics of the memory pattern planned when the session was initialized,
+  or nullptr if the memory pattern is traced at runtime.
+  See kOrtSessionOptionsConfigStaticMemoryPlanDimBounds.
+  */
+  const StaticMemoryPlanner::Stats* GetStaticMemoryPlanStats() const {
+    return static_mem_patterns_ ? &static_memory_plan_stats_ : nullptr;
+  }
+
   bool GetUseDeterministicCompute() const { return sess_options_.use_deterministic_compute; }
 
   /**
@@ -319,6 +340,23 @@ class SessionState {
     return used_shared_pre_packed_weights_counter_;
   }
 
+  size_t GetNumberOfRestoredPrepacksCounter() const {
+    return number_of_restored_prepacks_counter_;
+  }
+
+  /**
+   * Set the pre-packed weights associated with an ORT format model. Applies to subgraphs as well.
+   * Must be called on the main graph SessionState prior to FinalizeSessionState.
+   * @param ort_format_prepacked_weights The pre-packed weights. Must remain valid for the lifetime of the SessionState.
+   * @param saving If true, the pre-packed weights produced by the CPU EP kernels are added to
+   *               ort_format_prepacked_weights so they can be saved in the ORT format model.
+   *               Otherwise the kernels are provided with the stored pre-packed weights where possible.
+   */
+  void SetOrtFormatPrePackedWeights(OrtFormatPrePackedWeights* ort_format_prepacked_weights, bool saving) {
+    ort_format_prepacked_weights_ = ort_format_prepacked_weights;
+    saving_ort_format_prepacked_weights_ = saving;
+  }
+
   const KernelCreateInfoMap& GetKernelCreateInfoMap() const {
     return kernel_create_info_map_;
   }
@@ -372,6 +410,9 @@ class SessionState {
   Status PrepackConstantInitializedTensors(InlinedHashMap<std::string, size_t>& constant_initializers_use_count,
                                            const std::unordered_map<std::string, const OrtValue*>& initializers_to_share_map);
 
+  // Get the identifier of this graph for the pre-packed weights stored in an ORT format model.
+  std::string GetOrtFormatGraphId() const;
+
   SessionState* GetMutableSubgraphSessionState(onnxruntime::NodeIndex index, const std::string& attribute_name);
 
   Status CreateSubgraphSessionState();
@@ -486,18 +527,17 @@ class SessionState {
   // switch for enable memory pattern optimization or not.
   bool enable_mem_pattern_;
 
-  // lock for the mem_patterns_
-  mutable OrtMutex mem_patterns_lock_;
-  // cache for the generated mem_patterns. key is calculated based on input shapes.
-  // must be a node based container as a pointer is cached.
-  mutable NodeHashMap<int64_t, MemoryPatternGroup> mem_patterns_;
-  // This is mutable under mutex in training scenarios so execution frame would make a copy
-  // of the value when created.
-#ifdef ENABLE_TRAINING
-  mutable NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#else
-  NodeHashMap<int64_t, InlinedHashMap<int, TensorShape>> shape_patterns_;
-#endif
+  std::unique_ptr<CriticalPathScheduler> critical_path_scheduler_;
+
+  // cache for the generated mem_patterns, keyed on the input shapes.
+  // created with the configured size and dim buckets when the session state is finalized.
+  std::unique_ptr<MemoryPatternCache> mem_pattern_cache_;
+
+  // upper bounds of the symbolic dims used to plan the memory pattern when the session is initialized.
+  // if the plan is created it's used by every run instead of the cache.
+  StaticMemoryPlanner::DimBounds static_memory_plan_dim_bounds_;
+  std::shared_ptr<const MemoryPatternCache::Entry> static_mem_patterns_;
+  StaticMemoryPlanner::Stats static_memory_plan_stats_;
 
   NameNodeInfoMapType input_names_to_nodeinfo_mapping_;
   NameNodeInfoMapType output_names_to_nodeinfo_mapping_;
@@ -550,6 +590,14 @@ class SessionState {
   // a constant initialized weight was used by the session state
   size_t used_shared_pre_packed_weights_counter_ = 0;
 
+  // Counter for number of times a pre-packed weight stored in the ORT format model was used instead of
+  // calling PrePack
+  size_t number_of_restored_prepacks_counter_ = 0;
+
+  // Pre-packed weights from, or to be saved to, an ORT format model. Only set on the main graph SessionState.
+  OrtFormatPrePackedWeights* ort_format_prepacked_weights_ = nullptr;
+  bool saving_ort_format_prepacked_weights_ = false;
+
 #ifdef DEBUG_NODE_INPUTS_OUTPUTS
   // Counter for number of times the session graph has been executed
   size_t graph_executions_counter_ = 0;
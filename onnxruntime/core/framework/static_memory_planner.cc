@@ -0,0 +1,311 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/static_memory_planner.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "core/common/parse_string.h"
+#include "core/common/safeint.h"
+#include "core/common/string_utils.h"
+#include "core/framework/allocator.h"
+#include "core/framework/data_types.h"
+#include "core/framework/ort_value_name_idx_map.h"
+#include "core/framework/sequential_execution_plan.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+namespace {
+
+constexpr size_t kNoPosition = std::numeric_limits<size_t>::max();
+
+struct PlannedValue {
+  int ort_value_idx;
+  size_t location_idx;
+  size_t size;
+  // positions in the execution order of the first node that writes the buffer and the last node that reads it
+  size_t start;
+  size_t end;
+  size_t offset = 0;
+};
+
+// size of a tensor of the shape of node_arg, with its symbolic dims replaced by their bounds.
+// returns false if the shape has unknown dims or dims without a bound.
+bool TryGetBoundedSize(const NodeArg& node_arg, MLDataType value_type, const StaticMemoryPlanner::DimBounds& dim_bounds,
+                       size_t& size) {
+  const auto* shape = node_arg.Shape();
+  const auto* tensor_type = value_type ? value_type->AsTensorType() : nullptr;
+  if (shape == nullptr || tensor_type == nullptr) {
+    return false;
+  }
+
+  SafeInt<size_t> num_elements = 1;
+  for (const auto& dim : shape->dim()) {
+    int64_t dim_value = -1;
+    if (dim.has_dim_value()) {
+      dim_value = dim.dim_value();
+    } else if (dim.has_dim_param()) {
+      auto bound = dim_bounds.find(dim.dim_param());
+      if (bound != dim_bounds.end()) {
+        dim_value = bound->second;
+      }
+    }
+
+    if (dim_value < 0) {
+      return false;
+    }
+
+    num_elements *= static_cast<size_t>(dim_value);
+  }
+
+  return IAllocator::CalcMemSizeForArrayWithAlignment<kAllocAlignment>(
+      num_elements, tensor_type->GetElementType()->Size(), &size);
+}
+
+bool Overlaps(const PlannedValue& a, const PlannedValue& b) {
+  return a.start <= b.end && b.start <= a.end;
+}
+
+// place the values of one location. returns the peak size.
+size_t PlaceValues(std::vector<PlannedValue*>& values) {
+  // largest first, and of the values of the same size the one that lives longest, as those constrain the placement
+  // of the others the most
+  std::sort(values.begin(), values.end(), [](const PlannedValue* a, const PlannedValue* b) {
+    if (a->size != b->size) return a->size > b->size;
+    if (a->end - a->start != b->end - b->start) return a->end - a->start > b->end - b->start;
+    return a->ort_value_idx < b->ort_value_idx;
+  });
+
+  size_t peak_size = 0;
+  std::vector<const PlannedValue*> placed;
+  std::vector<const PlannedValue*> overlapping;
+  for (PlannedValue* value : values) {
+    overlapping.clear();
+    for (const PlannedValue* other : placed) {
+      if (Overlaps(*value, *other)) {
+        overlapping.push_back(other);
+      }
+    }
+
+    std::sort(overlapping.begin(), overlapping.end(), [](const PlannedValue* a, const PlannedValue* b) {
+      return a->offset < b->offset;
+    });
+
+    // find the smallest gap between the values alive at the same time that the value fits in, else place it after
+    // all of them
+    size_t best_offset = kNoPosition;
+    size_t best_gap = kNoPosition;
+    size_t gap_start = 0;
+    for (const PlannedValue* other : overlapping) {
+      if (other->offset > gap_start) {
+        const size_t gap = other->offset - gap_start;
+        if (gap >= value->size && gap < best_gap) {
+          best_gap = gap;
+          best_offset = gap_start;
+        }
+      }
+
+      gap_start = std::max(gap_start, other->offset + other->size);
+    }
+
+    value->offset = best_offset == kNoPosition ? gap_start : best_offset;
+    peak_size = std::max(peak_size, value->offset + value->size);
+    placed.push_back(value);
+  }
+
+  return peak_size;
+}
+
+}  // namespace
+
+Status StaticMemoryPlanner::ParseDimBounds(std::string_view str, DimBounds& dim_bounds) {
+  dim_bounds.clear();
+  if (str.empty()) {
+    return Status::OK();
+  }
+
+  for (const auto& entry : utils::SplitString(str, ",", true)) {
+    const auto separator = entry.rfind(':');
+    ORT_RETURN_IF(separator == std::string_view::npos || separator == 0,
+                  "Invalid dim bound '", entry, "' in '", str, "'. Expected dim_param:bound.");
+
+    int64_t bound = 0;
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(entry.substr(separator + 1), bound) && bound > 0,
+                      "Invalid dim bound '", entry, "' in '", str, "'. The bound must be a positive integer.");
+    ORT_RETURN_IF_NOT(dim_bounds.emplace(std::string{entry.substr(0, separator)}, bound).second,
+                      "Duplicate dim bound '", entry, "' in '", str, "'");
+  }
+
+  return Status::OK();
+}
+
+Status StaticMemoryPlanner::CreatePlan(const GraphViewer& graph_viewer,
+                                       const OrtValueNameIdxMap& ort_value_name_idx_map,
+                                       const SequentialExecutionPlan& execution_plan,
+                                       const DimBounds& dim_bounds,
+                                       Plan& plan) {
+  plan = Plan{};
+
+  // the lifetimes are positions in the execution order, which is only fixed if there is a single logic stream.
+  // every step of a single stream launches a kernel.
+  const SequentialExecutionPlan::LogicStream* stream = nullptr;
+  for (const auto& logic_stream : execution_plan.execution_plan) {
+    if (logic_stream && !logic_stream->steps_.empty()) {
+      ORT_RETURN_IF(stream != nullptr, "Static memory planning requires an execution plan with a single stream.");
+      stream = logic_stream.get();
+    }
+  }
+
+  if (stream == nullptr) {
+    return Status::OK();
+  }
+
+  ORT_RETURN_IF(stream->steps_.size() != static_cast<size_t>(graph_viewer.NumberOfNodes()),
+                "Static memory planning requires an execution plan where every step executes a node.");
+
+  const auto& allocation_plan = execution_plan.allocation_plan;
+  const size_t num_values = allocation_plan.size();
+  const size_t last_position = stream->steps_.size() - 1;
+
+  std::vector<size_t> def_position(num_values, kNoPosition);
+  std::vector<size_t> last_use_position(num_values, kNoPosition);
+
+  auto get_idx = [&ort_value_name_idx_map, num_values](const NodeArg* node_arg, int& idx) {
+    return node_arg->Exists() && ort_value_name_idx_map.GetIdx(node_arg->Name(), idx).IsOK() &&
+           idx >= 0 && static_cast<size_t>(idx) < num_values;
+  };
+
+  for (size_t pos = 0; pos < stream->steps_.size(); ++pos) {
+    const Node* node = graph_viewer.GetNode(stream->steps_[pos]->GetNodeIndex());
+    ORT_RETURN_IF(node == nullptr, "Node in the execution plan was not found in the graph.");
+
+    int idx = -1;
+    auto record_use = [&](const NodeArg* input) {
+      if (get_idx(input, idx)) {
+        last_use_position[idx] = last_use_position[idx] == kNoPosition ? pos : std::max(last_use_position[idx], pos);
+      }
+    };
+
+    for (const NodeArg* input : node->InputDefs()) {
+      record_use(input);
+    }
+
+    for (const NodeArg* input : node->ImplicitInputDefs()) {
+      record_use(input);
+    }
+
+    for (const NodeArg* output : node->OutputDefs()) {
+      if (get_idx(output, idx) && def_position[idx] == kNoPosition) {
+        def_position[idx] = pos;
+      }
+    }
+  }
+
+  // values that are never consumed, or are graph outputs, are only released when the execution frame is destroyed
+  int idx = -1;
+  for (const NodeArg* output : graph_viewer.GetOutputs()) {
+    if (get_idx(output, idx)) {
+      last_use_position[idx] = last_position;
+    }
+  }
+
+  for (size_t i = 0; i < num_values; ++i) {
+    if (def_position[i] != kNoPosition && last_use_position[i] == kNoPosition) {
+      last_use_position[i] = last_position;
+    }
+  }
+
+  // the buffer of a value is allocated by the first value of the values that reuse it, and is released after the last
+  // of them is consumed, so its lifetime covers all of theirs
+  auto get_root = [&allocation_plan, num_values](size_t value_idx) {
+    for (size_t i = 0; i < num_values; ++i) {
+      const auto& value_plan = allocation_plan[value_idx];
+      if (value_plan.alloc_kind != AllocKind::kReuse && value_plan.alloc_kind != AllocKind::kShare) {
+        break;
+      }
+      value_idx = static_cast<size_t>(value_plan.reused_buffer);
+    }
+    return value_idx;
+  };
+
+  std::vector<size_t> start(num_values, kNoPosition);
+  std::vector<size_t> end(num_values, kNoPosition);
+  for (size_t i = 0; i < num_values; ++i) {
+    if (def_position[i] == kNoPosition) {
+      continue;
+    }
+
+    const size_t root = get_root(i);
+    start[root] = start[root] == kNoPosition ? def_position[i] : std::min(start[root], def_position[i]);
+    end[root] = end[root] == kNoPosition ? last_use_position[i] : std::max(end[root], last_use_position[i]);
+  }
+
+  std::vector<PlannedValue> values;
+  for (size_t i = 0; i < num_values; ++i) {
+    const auto& value_plan = allocation_plan[i];
+    if (value_plan.alloc_kind != AllocKind::kAllocate || start[i] == kNoPosition ||
+        value_plan.location.mem_type != OrtMemTypeDefault) {
+      continue;
+    }
+
+#ifdef ENABLE_STRIDED_TENSORS
+    if (value_plan.is_strided_tensor) {
+      continue;
+    }
+#endif
+
+    if (value_plan.value_type == nullptr || !value_plan.value_type->IsTensorType()) {
+      continue;
+    }
+
+    std::string name;
+    ORT_RETURN_IF_ERROR(ort_value_name_idx_map.GetName(static_cast<int>(i), name));
+    const NodeArg* node_arg = graph_viewer.GetNodeArg(name);
+
+    size_t size = 0;
+    if (node_arg == nullptr || !TryGetBoundedSize(*node_arg, value_plan.value_type, dim_bounds, size)) {
+      ++plan.stats.num_dynamic_values;
+      continue;
+    }
+
+    if (size == 0) {
+      continue;
+    }
+
+    auto& locations = plan.mem_patterns.locations;
+    auto location = std::find(locations.begin(), locations.end(), value_plan.location);
+    if (location == locations.end()) {
+      location = locations.insert(locations.end(), value_plan.location);
+    }
+
+    values.push_back(PlannedValue{static_cast<int>(i), static_cast<size_t>(location - locations.begin()),
+                                  size, start[i], end[i]});
+  }
+
+  for (size_t location_idx = 0; location_idx < plan.mem_patterns.locations.size(); ++location_idx) {
+    std::vector<PlannedValue*> location_values;
+    for (auto& value : values) {
+      if (value.location_idx == location_idx) {
+        location_values.push_back(&value);
+      }
+    }
+
+    MemoryPattern pattern;
+    pattern.peak_size_ = PlaceValues(location_values);
+    pattern.patterns_.reserve(location_values.size());
+    for (const PlannedValue* value : location_values) {
+      pattern.patterns_.emplace(value->ort_value_idx, MemoryBlock(value->offset, value->size));
+      plan.stats.total_size += value->size;
+    }
+
+    plan.stats.peak_size += pattern.peak_size_;
+    plan.mem_patterns.patterns.push_back(std::move(pattern));
+  }
+
+  plan.stats.num_planned_values = values.size();
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
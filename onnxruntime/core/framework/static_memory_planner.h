@@ -0,0 +1,68 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/mem_pattern.h"
+
+namespace onnxruntime {
+class GraphViewer;
+class OrtValueNameIdxMap;
+struct SequentialExecutionPlan;
+
+/**
+ * Plans the memory pattern of a graph when the session is initialized, instead of tracing it at runtime.
+ *
+ * The size of each intermediate value that the allocation plan allocates is computed from its shape in the graph,
+ * with the symbolic dims replaced by user supplied upper bounds. Its lifetime is the range of nodes in the execution
+ * order from its producer to its last consumer, extended to cover the values that reuse its buffer. The values are
+ * then placed in a single block per location, largest first, each at the offset that leaves the smallest gap among
+ * the values that are alive at the same time (best-fit interval graph coloring).
+ *
+ * The resulting pattern has a fixed offset for every value and is used by every Run, so each Run allocates one
+ * buffer per location. Values that are larger than their planned block at runtime fall back to an individual
+ * allocation.
+ */
+class StaticMemoryPlanner {
+ public:
+  struct Stats {
+    // number of values placed in the pattern, and number of values left to dynamic allocation because their shape
+    // could not be bounded
+    size_t num_planned_values = 0;
+    size_t num_dynamic_values = 0;
+
+    // peak size of the pattern of each location summed, and the sum of the sizes of the planned values, which is
+    // what they would need without sharing memory
+    size_t peak_size = 0;
+    size_t total_size = 0;
+  };
+
+  struct Plan {
+    MemoryPatternGroup mem_patterns;
+    Stats stats;
+  };
+
+  using DimBounds = InlinedHashMap<std::string, int64_t>;
+
+  /**
+   * Parse a comma separated list of dim_param:bound pairs, e.g. "batch:8,sequence:512".
+   */
+  static Status ParseDimBounds(std::string_view str, DimBounds& dim_bounds);
+
+  /**
+   * Create the plan for the values of a graph.
+   * Fails if the execution plan has more than one logic stream, as the execution order is not fixed in that case.
+   */
+  static Status CreatePlan(const GraphViewer& graph_viewer,
+                           const OrtValueNameIdxMap& ort_value_name_idx_map,
+                           const SequentialExecutionPlan& execution_plan,
+                           const DimBounds& dim_bounds,
+                           Plan& plan);
+};
+
+}  // namespace onnxruntime
@@ -344,6 +344,7 @@ common::Status InitializeFeedFetchCopyInfo(const SessionState& session_state,
     ORT_RETURN_IF_ERROR(utils::CalculateStaticCopyInfoForFetches(session_state, info.output_names, fetch_copy_info));
   }
 
+  feeds_fetches_manager.SetStaticCopyInfoInitialized();
   return Status::OK();
 }
 
@@ -766,7 +767,9 @@ common::Status ExecuteGraph(const SessionState& session_state,
                             const logging::Logger& logger, bool sync_execution_provider,
                             bool only_execute_path_to_fetches,
                             Stream* parent_stream) {
-  ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state, feeds_fetches_manager));
+  if (!feeds_fetches_manager.IsStaticCopyInfoInitialized()) {
+    ORT_RETURN_IF_ERROR(utils::InitializeFeedFetchCopyInfo(session_state, feeds_fetches_manager));
+  }
 
   // finalize the copy info using the provided feeds and fetches. will update device_copy_checks in the background
   FinalizeFeedFetchCopyInfo(feeds_fetches_manager, feeds, fetches);
@@ -441,6 +441,70 @@ ONNX_MS_OPERATOR_SET_SCHEMA(
           ONNX_NAMESPACE::matmulShapeInference(ctx, 0, 1);
         }));
 
+constexpr const char* MatMulNBits_ver1_doc = R"DOC(
+MatMulNBits multiplies a float matrix A with a block-wise low bit quantized matrix B. B is quantized along
+its K dimension: every block of 'block_size' consecutive elements of a column shares a scale and a zero point.
+
+  dequantized_B[k][n] = (B[k][n] - zero_point[k / block_size][n]) * scale[k / block_size][n]
+  Y = A * dequantized_B
+
+Input B is a 3D uint8 tensor of shape [N, k_blocks, blob_size] where k_blocks = ceil(K / block_size) and
+blob_size = block_size * bits / 8. With bits = 4, two elements are packed in a byte, the element with the
+even index in the low nibble. The last block of a column is padded to block_size.
+
+Input scales has shape [N * k_blocks]. The optional input zero_points has shape [N * ceil(k_blocks * bits / 8)]
+and packs the zero points of a column the same way as the data. When it is not provided, the zero point is
+2^(bits - 1), which makes B a signed symmetric quantization.
+
+The attribute accuracy_level selects the minimum accuracy of the computation: 0 (unset) to 3 compute with float
+activations, 4 allows the activations to be quantized to int8 per block.
+)DOC";
+
+ONNX_MS_OPERATOR_SET_SCHEMA(
+    MatMulNBits, 1,
+    OpSchema()
+        .SetDoc(MatMulNBits_ver1_doc)
+        .Attr("K", "size of each input feature", AttributeProto::INT)
+        .Attr("N", "size of each output feature", AttributeProto::INT)
+        .Attr("bits", "number of bits used for weight quantization, only 4 is supported", AttributeProto::INT,
+              static_cast<int64_t>(4))
+        .Attr("block_size",
+              "number of elements of a column of B sharing a scale and a zero point, "
+              "a power of 2 and not smaller than 16",
+              AttributeProto::INT)
+        .Attr("accuracy_level",
+              "minimum accuracy level of the computation, 4 allows the activations to be quantized to int8",
+              AttributeProto::INT, static_cast<int64_t>(0))
+        .Input(0, "A", "The input tensor, its last dimension is K", "T1")
+        .Input(1, "B", "packed quantized weights of shape [N, k_blocks, blob_size]", "T2")
+        .Input(2, "scales", "block scales of shape [N * k_blocks]", "T1")
+        .Input(3, "zero_points", "packed block zero points of shape [N * ceil(k_blocks * bits / 8)]", "T2",
+               OpSchema::Optional)
+        .Output(0, "Y", "The output tensor, with the same rank as A and a last dimension of N", "T1")
+        .TypeConstraint("T1", {"tensor(float)"}, "Constrain input and output types to float tensors.")
+        .TypeConstraint("T2", {"tensor(uint8)"}, "Constrain quantized weight types to uint8.")
+        .TypeAndShapeInferenceFunction([](ONNX_NAMESPACE::InferenceContext& ctx) {
+          propagateElemTypeFromInputToOutput(ctx, 0, 0);
+
+          const int64_t bits = getAttribute(ctx, "bits", 4);
+          if (bits != 4) {
+            fail_shape_inference("MatMulNBits only supports 4 bits");
+          }
+
+          if (!hasInputShape(ctx, 0)) {
+            return;
+          }
+
+          const auto& a_shape = ctx.getInputType(0)->tensor_type().shape();
+          if (a_shape.dim_size() == 0) {
+            fail_shape_inference("Input A must have rank >= 1");
+          }
+
+          ONNX_NAMESPACE::TensorShapeProto y_shape(a_shape);
+          y_shape.mutable_dim(a_shape.dim_size() - 1)->set_dim_value(getAttribute(ctx, "N", 0));
+          updateOutputShape(ctx, 0, y_shape);
+        }));
+
 ONNX_MS_OPERATOR_SET_SCHEMA(
     QLinearAdd, 1,
     OpSchema().FillUsing(QLinearMathDocGenerator(
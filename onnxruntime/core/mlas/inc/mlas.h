@@ -91,6 +91,16 @@ Abstract:
 #endif // ARM64
 #endif // Visual Studio 16 or earlier does not support fp16 intrinsic
 
+//
+// Half precision GEMM kernels are available on ARM64 with fp16 vector
+// intrinsics, and on AMD64 with F16C or AVX512-FP16. The AMD64 kernels are
+// selected at runtime, check MlasFp16AccelerationSupported() before use.
+//
+
+#if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED) || defined(MLAS_TARGET_AMD64)
+#define MLAS_F16GEMM_SUPPORTED
+#endif
+
 //
 // Basic Linear Algebra Subprograms (BLAS) types.
 //
@@ -104,7 +114,8 @@ typedef enum { CblasLeft=141, CblasRight=142} CBLAS_SIDE;
 #endif
 
 //
-// Forward declare the thread pool implementation class and half precision floating point.
+// Forward declare the thread pool implementation class, half precision and
+// bfloat16 floating point.
 //
 // N.B. Avoid including ONNX Runtime headers here to keep the dependencies for
 // standalone MLAS test executables smaller.
@@ -115,6 +126,7 @@ namespace onnxruntime {
         class ThreadPool;
     };
     struct MLFloat16;
+    struct BFloat16;
 };  // namespace onnxruntime
 
 using MLAS_THREADPOOL = onnxruntime::concurrency::ThreadPool;
@@ -751,6 +763,7 @@ enum MLAS_CONV_ALGORITHM {
     MlasConvAlgorithmGemmDirect,
     MlasConvAlgorithmExpandThenGemm,
     MlasConvAlgorithmExpandThenGemmSegmented,
+    MlasConvAlgorithmWinograd,
 #if defined(MLAS_TARGET_WASM_SCALAR)
     MlasConvAlgorithmDepthwise,
 #endif
@@ -783,6 +796,11 @@ struct MLAS_CONV_PARAMETERS {
         struct {
             size_t ThreadStrideN;
         } ExpandThenGemmSegmented;
+        struct {
+            size_t OutputTileSize;
+            size_t TileBlockSize;
+            size_t FilterBlockSize;
+        } Winograd;
     } u;
 };
 
@@ -802,8 +820,40 @@ MlasConvPrepare(MLAS_CONV_PARAMETERS* Parameters,
                 const MLAS_ACTIVATION* Activation,
                 size_t* WorkingBufferSize,
                 float Beta,
+                bool WinogradFilterAvailable,
                 MLAS_THREADPOOL* ThreadPool);
 
+//
+// Winograd convolution routines. MlasConvWinogradPackFilterSize returns zero
+// unless the convolution is a 3x3 stride 1 convolution with enough channels
+// for the Winograd algorithm to be profitable. Otherwise, the filter packed by
+// MlasConvWinogradPackFilter is passed to MlasConv in place of the filter and
+// WinogradFilterAvailable is passed to MlasConvPrepare, which then always
+// selects MlasConvAlgorithmWinograd.
+//
+
+size_t
+MLASCALL
+MlasConvWinogradPackFilterSize(
+    size_t Dimensions,
+    size_t GroupCount,
+    size_t InputChannels,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* StrideShape,
+    size_t FilterCount
+    );
+
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter
+    );
+
 void
 MLASCALL
 MlasConv(
@@ -1083,6 +1133,25 @@ MlasTranspose(
     size_t N
     );
 
+//
+// Transposes a tensor of at most MLAS_TRANSPOSE_MAXIMUM_DIMENSIONS dimensions
+// with 1, 2, 4 or 8 byte elements. Output axis i is input axis Permutation[i].
+//
+
+#define MLAS_TRANSPOSE_MAXIMUM_DIMENSIONS 16
+
+void
+MLASCALL
+MlasTransposeNd(
+    const void* Input,
+    void* Output,
+    size_t ElementSize,
+    size_t Rank,
+    const size_t* InputShape,
+    const size_t* Permutation,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 //
 // Buffer reordering routines.
 //
@@ -1689,3 +1758,367 @@ MlasNhwcAvgPool(
     );
 
 #endif
+
+
+//
+// BFloat16 routines
+//
+
+using MLAS_BF16 = onnxruntime::BFloat16;
+
+/**
+ * @brief Data parameters for bfloat16 GEMM routine
+ *        C = alpha * A * B + beta * C
+ *        A and B are bfloat16, the products are accumulated and C is
+ *        stored in fp32. All except C are [in] parameters
+*/
+struct MLAS_BF16_GEMM_DATA_PARAMS {
+    const MLAS_BF16* A = nullptr;     /**< address of A */
+    size_t lda = 0;                   /**< leading dimension of A */
+    const void* B = nullptr;          /**< address of B, or the packed B */
+    size_t ldb = 0;                   /**< leading dimension of B, 0 when B is pre-packed */
+    float* C = nullptr;               /**< address of result matrix */
+    size_t ldc = 0;                   /**< leading dimension of C */
+    float alpha = 1.0f;
+    float beta = 0.0f;
+};
+
+/**
+ * @brief BFloat16 Batched GEMM:  C = alpha * op(A) * op(B) + beta * C
+ *
+ * Note:  We only support uniform batching, so shapes and types of the
+ *        input must be same across all parameter blocks. TransB is
+ *        ignored when B is pre-packed, the transpose is applied by
+ *        MlasBf16GemmPackB.
+ *
+ * @param[in]  TransA  Whether matrix A is transposed
+ * @param[in]  TransB  Whether matrix B is transposed
+ * @param[in]  M       row size of matrix op(A) and C
+ * @param[in]  N       column size of matrix op(B) and C
+ * @param[in]  K       column size of matrix op(A) and row size of matrix op(B)
+ * @param[inout]  DataParams  An array (size BatchN) of parameter blocks
+ * @param[in]  BatchN  number of batches
+ * @param[in]  ThreadPool
+*/
+void
+MLASCALL
+MlasBf16GemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_BF16_GEMM_DATA_PARAMS* DataParams,
+    size_t BatchN,
+    MLAS_THREADPOOL* ThreadPool = nullptr
+    );
+
+/**
+ * @brief For bfloat16 GEMM, returns size of the
+ *        packing buffer needed for right hand side
+ * @param[in] N   Number of columns
+ * @param[in] K   Number of rows
+ * @return  size of the packing buffer
+*/
+size_t
+MLASCALL
+MlasBf16GemmPackBSize(
+    size_t N,
+    size_t K
+    );
+
+/**
+ * @brief For bfloat16 GEMM, pack the right hand side matrix op(B)
+ *
+ * @param[in]  TransB   Whether matrix B is transposed
+ * @param[in]  N        Number of columns of op(B)
+ * @param[in]  K        Number of rows of op(B)
+ * @param[in]  B        Address of matrix B
+ * @param[in]  ldb      leading dimension of input matrix B
+ * @param[out] PackedB  Address of the packed matrix
+*/
+void
+MLASCALL
+MlasBf16GemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const MLAS_BF16* B,
+    size_t ldb,
+    void* PackedB
+    );
+
+
+//
+// Block-wise 4-bit quantized weight routines
+//
+
+/**
+ * @brief Compute type of the 4-bit block quantized GEMM, in order of
+ *        decreasing accuracy.
+ */
+typedef enum {
+    MlasQ4BitCompFp32 = 0,  /**< fp32 activations, fp32 accumulation */
+    MlasQ4BitCompInt8 = 1,  /**< activations quantized per block to int8, int32 accumulation */
+} MLAS_Q4BIT_COMPUTE_TYPE;
+
+/**
+ * @brief Data parameters for 4-bit block quantized GEMM routine
+ *        C = A * dequantize(B) + Bias
+ *
+ *        B is K x N and is stored column by column. Each column is divided
+ *        into BlockCountK = ceil(K / BlkLen) blocks of BlkLen elements, with a
+ *        float scale and a 4-bit zero point per block. The 4-bit values of a
+ *        block are packed two per byte, the element with the even index in
+ *        the low nibble. The last block of a column is padded to BlkLen.
+ *
+ *        dequantize(B)[k][n] = (QuantB[k][n] - ZeroPoint[k / BlkLen][n]) *
+ *                              Scale[k / BlkLen][n]
+ *
+ *        All except C are [in] parameters
+ */
+struct MLAS_Q4BIT_GEMM_DATA_PARAMS {
+    const float* A = nullptr;               /**< address of A (float32 matrix) */
+    size_t lda = 0;                         /**< leading dimension of A */
+    const uint8_t* QuantBData = nullptr;    /**< address of quantized B, [N][BlockCountK][BlkLen / 2] */
+    const float* QuantBScale = nullptr;     /**< address of the block scales of B, [N][BlockCountK] */
+    const uint8_t* QuantBZeroPoint = nullptr; /**< optional block zero points of B, [N][ceil(BlockCountK / 2)]
+                                                   packed like the data, 8 when not provided */
+    const float* Bias = nullptr;            /**< optional address of Bias, vector size N */
+    float* C = nullptr;                     /**< address of result matrix */
+    size_t ldc = 0;                         /**< leading dimension of C */
+};
+
+/**
+ * @brief Batched GEMM with block-wise 4-bit quantized B:
+ *        C = A * dequantize(B) + Bias
+ *
+ *        Small M, down to the M = 1 GEMV of token generation, is computed by
+ *        kernels that dequantize B in registers. Larger M dequantizes tiles
+ *        of B and uses the single precision GEMM.
+ *
+ * @param[in]  M            row size of matrix A and C
+ * @param[in]  N            column size of matrix B and C
+ * @param[in]  K            column size of matrix A and row size of matrix B
+ * @param[in]  BatchN       number of batches
+ * @param[in]  BlkLen       number of elements of B sharing a scale, a power
+ *                          of 2 in [16, 256]
+ * @param[in]  ComputeType  requested compute type. MlasQ4BitCompInt8 falls
+ *                          back to MlasQ4BitCompFp32 when the platform has
+ *                          no kernel for it
+ * @param[inout]  DataParams  An array (size BatchN) of parameter blocks
+ * @param[in]  Workspace    Address of a buffer of the size returned by
+ *                          MlasQ4BitGemmBatchWorkspaceSize, may be nullptr
+ *                          when that size is 0
+ * @param[in]  ThreadPool
+ */
+void
+MLASCALL
+MlasQ4BitGemmBatch(
+    size_t M,
+    size_t N,
+    size_t K,
+    size_t BatchN,
+    size_t BlkLen,
+    MLAS_Q4BIT_COMPUTE_TYPE ComputeType,
+    const MLAS_Q4BIT_GEMM_DATA_PARAMS* DataParams,
+    void* Workspace,
+    MLAS_THREADPOOL* ThreadPool = nullptr
+    );
+
+/**
+ * @brief Returns the size of the workspace needed by MlasQ4BitGemmBatch,
+ *        0 when no workspace is needed.
+ *
+ * @param[in]  M            row size of matrix A and C
+ * @param[in]  N            column size of matrix B and C
+ * @param[in]  K            column size of matrix A and row size of matrix B
+ * @param[in]  BatchN       number of batches
+ * @param[in]  BlkLen       number of elements of B sharing a scale
+ * @param[in]  ComputeType  requested compute type
+ */
+size_t
+MLASCALL
+MlasQ4BitGemmBatchWorkspaceSize(
+    size_t M,
+    size_t N,
+    size_t K,
+    size_t BatchN,
+    size_t BlkLen,
+    MLAS_Q4BIT_COMPUTE_TYPE ComputeType
+    );
+
+/**
+ * @brief Returns whether the platform has kernels for the block length and
+ *        compute type, rather than a portable fallback.
+ *
+ * @param[in]  BlkLen       number of elements of B sharing a scale
+ * @param[in]  ComputeType  compute type
+ */
+bool
+MLASCALL
+MlasIsQ4BitGemmAvailable(
+    size_t BlkLen,
+    MLAS_Q4BIT_COMPUTE_TYPE ComputeType
+    );
+
+//
+// Fused attention routines.
+//
+
+/**
+ * @brief Parameters of the fused attention routine
+ *
+ *        Output = Softmax(Scale * Query * Key' + Mask + Bias) * Value
+ *
+ *        Query is S x QkHeadSize, Key is T x QkHeadSize and Value is
+ *        T x VHeadSize for every batch and head. The query at row s sits at
+ *        position s + T - S of the key sequence, so that T - S is the length
+ *        of a past sequence.
+ *
+ *        All except Output are [in] parameters
+ */
+struct MLAS_FLASH_ATTENTION_PARAMS {
+    size_t BatchSize = 0;                   /**< batch size (B) */
+    size_t NumHeads = 0;                    /**< number of heads (N) */
+    size_t SequenceLength = 0;              /**< query sequence length (S) */
+    size_t KvSequenceLength = 0;            /**< key and value sequence length including past (T), not smaller than S */
+    size_t QkHeadSize = 0;                  /**< head size of Query and Key */
+    size_t VHeadSize = 0;                   /**< head size of Value */
+    float Scale = 1.0f;                     /**< scale applied to Query * Key' */
+    const float* Query = nullptr;           /**< address of Query, [B][N][S][QkHeadSize] */
+    const float* Key = nullptr;             /**< address of Key, [B][N][T][QkHeadSize] */
+    const float* Value = nullptr;           /**< address of Value, [B][N][T][VHeadSize] */
+    size_t KvBufferSequenceLength = 0;      /**< number of positions held per head by the Key and Value buffers,
+                                                 such as a preallocated cache of which the first T are used,
+                                                 0 when equal to T */
+    const float* Mask = nullptr;            /**< optional additive mask, rows of T elements shared by the heads */
+    size_t MaskBatchStride = 0;             /**< distance between the masks of two batches */
+    size_t MaskRowStride = 0;               /**< distance between the mask rows of two queries, 0 to use one
+                                                 row for all queries as a key padding mask */
+    const float* Bias = nullptr;            /**< optional additive bias such as a relative position bias,
+                                                 [B][N][S][T] */
+    size_t BiasBatchStride = 0;             /**< distance between the biases of two batches, 0 to broadcast */
+    bool Causal = false;                    /**< whether the query at position p only attends keys up to p */
+    float CausalMaskValue = 0.0f;           /**< value that replaces the scaled score of a key hidden by the
+                                                 causal mask, before Mask and Bias are added */
+    float* Output = nullptr;                /**< address of Output, [B][S][N][VHeadSize] */
+};
+
+/**
+ * @brief Compute attention without materializing the S x T score matrix.
+ *
+ *        The queries are processed in tiles against blocks of keys with an
+ *        online softmax that keeps a running maximum and sum per query, so
+ *        the memory used is independent of the sequence lengths. Work is
+ *        partitioned across batches, heads and query tiles.
+ *
+ * @param[in]  Params       parameters of the operation
+ * @param[in]  ThreadPool   optional thread pool for parallel processing
+ */
+void
+MLASCALL
+MlasFlashAttention(
+    const MLAS_FLASH_ATTENTION_PARAMS* Params,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Layer normalization routines.
+//
+
+/**
+ * @brief Parameters of the layer normalization routine
+ *
+ *        X = Input + Skip + Bias
+ *        Output = (X - Mean(X)) * InvStdDev(X) * Scale + Shift
+ *
+ *        where InvStdDev(X) = 1 / sqrt(Var(X) + Epsilon). The simplified (RMS)
+ *        normalization does not subtract the mean and uses Mean(X * X) in
+ *        place of the variance. Statistics are always accumulated in float.
+ *
+ *        All except Output, SkipOutput, Mean and InvStdDev are [in] parameters
+ */
+template <typename T>
+struct MLAS_LAYER_NORM_PARAMS {
+    size_t RowCount = 0;            /**< number of rows to normalize (N) */
+    size_t RowSize = 0;             /**< number of elements of a row (D) */
+    float Epsilon = 0.0f;           /**< value added to the variance */
+    bool Simplified = false;        /**< whether to apply the simplified (RMS) normalization */
+    const T* Input = nullptr;       /**< address of Input, [N][D] */
+    const T* Skip = nullptr;        /**< optional address of Skip added to Input, [N][D] */
+    const T* Bias = nullptr;        /**< optional address of Bias added to Input, [D] */
+    const T* Scale = nullptr;       /**< address of Scale, [D] */
+    const T* Shift = nullptr;       /**< optional address of Shift, [D] */
+    T* Output = nullptr;            /**< address of Output, [N][D], may alias Input */
+    T* SkipOutput = nullptr;        /**< optional address of X = Input + Skip + Bias, [N][D] */
+    float* Mean = nullptr;          /**< optional address of the mean of each row, [N] */
+    float* InvStdDev = nullptr;     /**< optional address of the inverse standard deviation of each row, [N] */
+};
+
+/**
+ * @brief Normalize each row of the input.
+ *
+ *        The skip and bias additions are fused with the accumulation of the
+ *        statistics, so that a row is read once to compute its mean and
+ *        variance and once more to normalize it. Work is partitioned across
+ *        rows.
+ *
+ * @tparam T    float or MLAS_FP16. Half precision rows are converted to
+ *              float in a thread local buffer.
+ *
+ * @param[in]  Params       parameters of the operation
+ * @param[in]  ThreadPool   optional thread pool for parallel processing
+ */
+template <typename T>
+void
+MLASCALL
+MlasLayerNorm(
+    const MLAS_LAYER_NORM_PARAMS<T>* Params,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+//
+// Reduction routines.
+//
+
+enum MLAS_REDUCTION_KIND {
+    MlasSumReduction,
+    MlasSumSquareReduction,
+    MlasMaximumReduction,
+    MlasMinimumReduction,
+    MlasProductReduction,
+    MlasLogSumExpReduction,
+};
+
+/**
+ * @brief Reduce the middle dimension of a tensor viewed as [Outer][Reduce][Inner].
+ *
+ *        Output[o][i] = Reduce(Input[o][r][i] for r in [0, ReduceCount))
+ *
+ *        Adjacent reduced axes collapse to this form: reducing the trailing
+ *        axes (KR) has InnerCount == 1, reducing the leading axes (RK) has
+ *        OuterCount == 1. A caller partitions work by splitting the outer
+ *        slices or by selecting a range of inner columns with InnerCount <
+ *        InnerStride. The log sum exp reduction subtracts the maximum of the
+ *        reduced elements before exponentiation.
+ *
+ * @param[in]  Kind         reduction to apply
+ * @param[in]  Input        address of Input, element (o, r, i) is at (o * ReduceCount + r) * InnerStride + i
+ * @param[out] Output       address of Output, element (o, i) is at o * InnerStride + i
+ * @param[in]  OuterCount   number of outer slices
+ * @param[in]  ReduceCount  number of elements to reduce
+ * @param[in]  InnerCount   number of inner elements to compute for each outer slice
+ * @param[in]  InnerStride  size of the inner dimension, at least InnerCount
+ */
+void
+MLASCALL
+MlasReduce(
+    MLAS_REDUCTION_KIND Kind,
+    const float* Input,
+    float* Output,
+    size_t OuterCount,
+    size_t ReduceCount,
+    size_t InnerCount,
+    size_t InnerStride
+    );
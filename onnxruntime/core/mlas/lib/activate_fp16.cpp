@@ -857,17 +857,18 @@ MLAS_HALF_GEMM_ACTIVATION_PROCESSOR::Process(
     size_t ldc
     ) const
 {
+    _mlas_fp16_* Output = reinterpret_cast<_mlas_fp16_*>(C) + StartM * ldc + StartN;
+
+    // The buffer only holds this tile, so convert the tile from its origin.
     std::vector<float> buffer(CountM*CountN);
     MLAS_HALF_GEMM_2FLOAT_PROCESSOR proc(this->Activation_, buffer.data(), CountN);
-    proc.Process(C, StartM, StartN, CountM, CountN, ldc);
+    proc.Process(reinterpret_cast<MLAS_FP16*>(Output), 0, 0, CountM, CountN, ldc);
 
-    _mlas_fp16_* Output = reinterpret_cast<_mlas_fp16_*>(C);
     auto* CRow = buffer.data();
     const _mlas_fp16_* CAdd = nullptr;
     if (SumBuf_) {
         CAdd = reinterpret_cast<const _mlas_fp16_*>(SumBuf_) + StartM * ldc + StartN;
     }
-    Output += StartM * ldc + StartN;
 
     while (CountM-- > 0) {
         if (CAdd) {
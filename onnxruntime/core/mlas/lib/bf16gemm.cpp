@@ -0,0 +1,411 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    bf16gemm.cpp
+
+Abstract:
+
+    This module implements the bfloat16 matrix/matrix multiply operation.
+
+    The driver packs blocks of A and B into the layout described in
+    bf16gemm.h and invokes the platform kernel. Products are accumulated in
+    fp32 and the result matrix is fp32.
+
+--*/
+
+#include "bf16gemm.h"
+
+/**
+ * @brief Pack a block of op(A) into rows of AlignedK elements, padding the
+ *        row count to a multiple of PackedM.
+ */
+static
+void
+MlasBf16GemmPackA(
+    uint16_t* D,
+    const uint16_t* A,
+    size_t lda,
+    bool TransA,
+    size_t CountM,
+    size_t CountK,
+    size_t AlignedK,
+    size_t PackedM
+    )
+{
+    const size_t AlignedM = MlasDivRoundup(CountM, PackedM) * PackedM;
+
+    if (!TransA) {
+        for (size_t m = 0; m < CountM; m++) {
+            std::copy_n(A + m * lda, CountK, D);
+            std::fill_n(D + CountK, AlignedK - CountK, uint16_t(0));
+            D += AlignedK;
+        }
+    } else {
+        for (size_t m = 0; m < CountM; m++) {
+            const uint16_t* a = A + m;
+            for (size_t k = 0; k < CountK; k++) {
+                D[k] = *a;
+                a += lda;
+            }
+            std::fill_n(D + CountK, AlignedK - CountK, uint16_t(0));
+            D += AlignedK;
+        }
+    }
+
+    std::fill_n(D, (AlignedM - CountM) * AlignedK, uint16_t(0));
+}
+
+/**
+ * @brief Pack a block of op(B) into panels of MLAS_BF16GEMM_PACKED_N columns
+ *        with interleaved row pairs, see bf16gemm.h.
+ */
+static
+void
+MlasBf16GemmPackBPanels(
+    uint16_t* D,
+    const uint16_t* B,
+    size_t ldb,
+    bool TransB,
+    size_t CountN,
+    size_t CountK,
+    size_t AlignedK
+    )
+{
+    constexpr size_t PackedN = MLAS_BF16GEMM_PACKED_N;
+
+    for (size_t n = 0; n < CountN; n += PackedN) {
+
+        const size_t cols = std::min(CountN - n, PackedN);
+
+        for (size_t k = 0; k < AlignedK; k += 2) {
+
+            for (size_t c = 0; c < PackedN; c++) {
+
+                uint16_t v0 = 0;
+                uint16_t v1 = 0;
+
+                if (c < cols) {
+                    if (TransB) {
+                        const uint16_t* b = B + (n + c) * ldb + k;
+                        if (k < CountK) {
+                            v0 = b[0];
+                        }
+                        if (k + 1 < CountK) {
+                            v1 = b[1];
+                        }
+                    } else {
+                        const uint16_t* b = B + k * ldb + n + c;
+                        if (k < CountK) {
+                            v0 = b[0];
+                        }
+                        if (k + 1 < CountK) {
+                            v1 = b[ldb];
+                        }
+                    }
+                }
+
+                D[0] = v0;
+                D[1] = v1;
+                D += 2;
+            }
+        }
+    }
+}
+
+/**
+ * @brief Compute the rectangle [RangeStartM, RangeStartM + RangeCountM) x
+ *        [RangeStartN, RangeStartN + RangeCountN) of one GEMM.
+ */
+static
+void
+MlasBf16GemmOperation(
+    const MLAS_BF16GEMM_DISPATCH* Dispatch,
+    bool TransA,
+    bool TransB,
+    size_t K,
+    const MLAS_BF16_GEMM_DATA_PARAMS* Data,
+    size_t RangeStartM,
+    size_t RangeCountM,
+    size_t RangeStartN,
+    size_t RangeCountN
+    )
+{
+    const size_t PackedK = Dispatch->PackedK;
+    const size_t StrideM = Dispatch->StrideM;
+    const size_t StrideN = Dispatch->StrideN;
+    const size_t StrideK = Dispatch->StrideK;
+
+    const size_t PanelASize = UpAlignSize(StrideM * StrideK * sizeof(uint16_t));
+    const size_t PanelBSize = UpAlignSize(StrideN * StrideK * sizeof(uint16_t));
+
+    MlasThreadedBufAlloc(PanelASize + PanelBSize);
+    uint16_t* PanelA = reinterpret_cast<uint16_t*>(ThreadedBufHolder.get());
+    uint16_t* PanelB = reinterpret_cast<uint16_t*>(ThreadedBufHolder.get() + PanelASize);
+
+    const uint16_t* A = reinterpret_cast<const uint16_t*>(Data->A);
+    const size_t lda = Data->lda;
+    const bool BIsPacked = (Data->ldb == 0);
+    const uint16_t* B = reinterpret_cast<const uint16_t*>(Data->B);
+    const size_t ldb = Data->ldb;
+    const size_t PackedAlignedK = (K + PackedK - 1) & ~(PackedK - 1);
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = std::min(K - k, StrideK);
+        const size_t AlignedK = (CountK + PackedK - 1) & ~(PackedK - 1);
+
+        //
+        // Accumulate into the output after the first block of K.
+        //
+
+        const float beta = (k == 0) ? Data->beta : 1.0f;
+
+        size_t CountN;
+
+        for (size_t n = 0; n < RangeCountN; n += CountN) {
+
+            CountN = std::min(RangeCountN - n, StrideN);
+
+            const uint16_t* b;
+            size_t PanelStride;
+
+            if (BIsPacked) {
+                b = B + (RangeStartN + n) * PackedAlignedK + k * MLAS_BF16GEMM_PACKED_N;
+                PanelStride = PackedAlignedK * MLAS_BF16GEMM_PACKED_N;
+            } else {
+                const uint16_t* src = TransB ? B + (RangeStartN + n) * ldb + k
+                                             : B + k * ldb + RangeStartN + n;
+                MlasBf16GemmPackBPanels(PanelB, src, ldb, TransB, CountN, CountK, AlignedK);
+                b = PanelB;
+                PanelStride = AlignedK * MLAS_BF16GEMM_PACKED_N;
+            }
+
+            size_t CountM;
+
+            for (size_t m = 0; m < RangeCountM; m += CountM) {
+
+                CountM = std::min(RangeCountM - m, StrideM);
+
+                const uint16_t* a = TransA ? A + k * lda + RangeStartM + m
+                                           : A + (RangeStartM + m) * lda + k;
+                size_t PanelLda = lda;
+
+                if (TransA || CountK != AlignedK || CountM % Dispatch->PackedM != 0) {
+                    MlasBf16GemmPackA(PanelA, a, lda, TransA, CountM, CountK, AlignedK,
+                                      Dispatch->PackedM);
+                    a = PanelA;
+                    PanelLda = AlignedK;
+                }
+
+                float* c = Data->C + (RangeStartM + m) * Data->ldc + RangeStartN + n;
+
+                Dispatch->Kernel(a, b, c, CountM, CountN, AlignedK, PanelLda, PanelStride,
+                                 Data->ldc, Data->alpha, beta);
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasBf16GemmBatch(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    const MLAS_BF16_GEMM_DATA_PARAMS* DataParams,
+    size_t BatchN,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    const MLAS_BF16GEMM_DISPATCH* dispatch = MlasBf16GemmGetDispatch();
+    const bool transA = (TransA != CblasNoTrans);
+    const bool transB = (TransB != CblasNoTrans);
+
+    //
+    // Nothing is accumulated when K is zero, only scale the output.
+    //
+
+    if (K == 0) {
+        for (size_t gemm_i = 0; gemm_i < BatchN; gemm_i++) {
+            const auto* Data = &DataParams[gemm_i];
+            for (size_t m = 0; m < M; m++) {
+                float* c = Data->C + m * Data->ldc;
+                for (size_t n = 0; n < N; n++) {
+                    c[n] = (Data->beta == 0.0f) ? 0.0f : c[n] * Data->beta;
+                }
+            }
+        }
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the GEMM
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K) * double(BatchN);
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    if (TargetThreadCount == 1) {
+        for (size_t gemm_i = 0; gemm_i < BatchN; gemm_i++) {
+            MlasBf16GemmOperation(dispatch, transA, transB, K, &DataParams[gemm_i], 0, M, 0, N);
+        }
+        return;
+    }
+
+    ptrdiff_t ThreadsPerGemm = TargetThreadCount / BatchN;
+    if (ThreadsPerGemm < 1) {
+        ThreadsPerGemm = 1;
+    }
+
+    const size_t StrideM = dispatch->StrideM;
+
+    //
+    // Partition N along the boundaries of the packed B panels.
+    //
+
+    const size_t StrideNAlign = std::max<size_t>(MLAS_SGEMM_STRIDEN_THREAD_ALIGN, MLAS_BF16GEMM_PACKED_N);
+
+    size_t nc = N;
+    if (size_t(ThreadsPerGemm) > 1) {
+        const size_t BlockedM = MlasDivRoundup(M, StrideM);
+        const size_t max_nc = MlasDivRoundup(N * BlockedM, ThreadsPerGemm);
+        if (max_nc < nc) {
+            nc = std::min(nc, MlasDivRoundup(max_nc, StrideNAlign) * StrideNAlign);
+        }
+    }
+    const size_t StrideN = nc;
+
+    const size_t ThreadCountM = MlasDivRoundup(M, StrideM);
+    const size_t ThreadCountN = MlasDivRoundup(N, StrideN);
+    ThreadsPerGemm = ThreadCountM * ThreadCountN;
+
+    MlasTrySimpleParallel(ThreadPool, ThreadsPerGemm * BatchN, [&](ptrdiff_t tid) {
+        const auto gemm_i = tid / ThreadsPerGemm;
+        const auto blk_i = tid % ThreadsPerGemm;
+
+        const ptrdiff_t ThreadIdN = blk_i / ThreadCountM;
+        const ptrdiff_t ThreadIdM = blk_i % ThreadCountM;
+
+        const size_t RangeStartM = ThreadIdM * StrideM;
+        const size_t RangeCountM = std::min(M - RangeStartM, StrideM);
+
+        const size_t RangeStartN = ThreadIdN * StrideN;
+        const size_t RangeCountN = std::min(N - RangeStartN, StrideN);
+
+        MlasBf16GemmOperation(dispatch, transA, transB, K, &DataParams[gemm_i],
+                              RangeStartM, RangeCountM, RangeStartN, RangeCountN);
+    });
+}
+
+size_t
+MLASCALL
+MlasBf16GemmPackBSize(
+    size_t N,
+    size_t K
+    )
+{
+    const auto* dispatch = MlasBf16GemmGetDispatch();
+    const size_t PackedK = dispatch->PackedK;
+
+    const size_t AlignedK = (K + PackedK - 1) & ~(PackedK - 1);
+    const size_t AlignedN = MlasDivRoundup(N, MLAS_BF16GEMM_PACKED_N) * MLAS_BF16GEMM_PACKED_N;
+    const size_t BytesRequired = AlignedN * AlignedK * sizeof(uint16_t);
+    const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
+    const size_t AlignedBytesRequired =
+        (BytesRequired + BufferAlignment - 1) & ~(BufferAlignment - 1);
+    return AlignedBytesRequired;
+}
+
+void
+MLASCALL
+MlasBf16GemmPackB(
+    CBLAS_TRANSPOSE TransB,
+    size_t N,
+    size_t K,
+    const MLAS_BF16* B,
+    size_t ldb,
+    void* PackedB
+    )
+{
+    const auto* dispatch = MlasBf16GemmGetDispatch();
+    const size_t PackedK = dispatch->PackedK;
+    const size_t AlignedK = (K + PackedK - 1) & ~(PackedK - 1);
+
+    MlasBf16GemmPackBPanels(reinterpret_cast<uint16_t*>(PackedB),
+                            reinterpret_cast<const uint16_t*>(B), ldb,
+                            TransB != CblasNoTrans, N, K, AlignedK);
+}
+
+//
+// Portable kernel that widens bfloat16 to fp32, used when the platform has
+// no vectorized kernel.
+//
+
+static
+void
+MlasBf16GemmKernelDefault(
+    const uint16_t* A,
+    const uint16_t* B,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    float alpha,
+    float beta
+    )
+{
+    constexpr size_t PackedN = MLAS_BF16GEMM_PACKED_N;
+
+    for (size_t m = 0; m < CountM; m++) {
+
+        const uint16_t* a = A + m * lda;
+        float* c = C + m * ldc;
+
+        for (size_t n = 0; n < CountN; n++) {
+
+            const uint16_t* b = B + (n / PackedN) * ldb + (n % PackedN) * 2;
+            float Accumulator = 0.0f;
+
+            for (size_t k = 0; k < CountK; k += 2) {
+                Accumulator += MlasBf16ToFloat(a[k]) * MlasBf16ToFloat(b[0]);
+                Accumulator += MlasBf16ToFloat(a[k + 1]) * MlasBf16ToFloat(b[1]);
+                b += PackedN * 2;
+            }
+
+            Accumulator *= alpha;
+            if (beta != 0.0f) {
+                Accumulator += beta * c[n];
+            }
+            c[n] = Accumulator;
+        }
+    }
+}
+
+const MLAS_BF16GEMM_DISPATCH MlasBf16GemmDispatchDefault = {
+    MlasBf16GemmKernelDefault,
+    2,
+    1,
+    128,
+    128,
+    128,
+};
@@ -0,0 +1,111 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    bf16gemm.h
+
+Abstract:
+
+    This module defines the dispatch structure and the shared packing format
+    of the bfloat16 matrix/matrix multiply operation.
+
+    Matrix B is packed into panels of MLAS_BF16GEMM_PACKED_N columns. Inside a
+    panel, each pair of consecutive rows (k, k+1) is interleaved so that the
+    two values of a column are adjacent:
+
+        Panel[k / 2][n][k % 2] = B[k][n]
+
+    This is the layout consumed by both the AVX512-BF16 dot product
+    instruction and the AMX-BF16 tile multiply, and is cheap to split into
+    even and odd rows for kernels that widen bfloat16 to fp32. The rows of a
+    panel are zero padded to a multiple of the dispatch PackedK, and the
+    columns are zero padded to a whole panel.
+
+    Matrix A is packed row major with the row length padded to PackedK and
+    the number of rows padded to PackedM, all padding being zero. A block of
+    A that is not transposed and needs no padding is used in place.
+
+    A kernel computes C = alpha * A * B + beta * C for a block of packed A
+    and packed B. C is not read when beta is zero.
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+constexpr size_t MLAS_BF16GEMM_PACKED_N = 16;
+
+/**
+ * @brief Widen a bfloat16 value to fp32.
+ */
+MLAS_FORCEINLINE
+float
+MlasBf16ToFloat(
+    uint16_t Value
+    )
+{
+    const uint32_t Bits = uint32_t(Value) << 16;
+    float Result;
+    memcpy(&Result, &Bits, sizeof(Result));
+    return Result;
+}
+
+/**
+ * @brief Compute a block of the bfloat16 GEMM.
+ *
+ * @param A        Supplies the packed A matrix.
+ * @param B        Supplies the packed B matrix, starting at the first panel
+ *                 of the block.
+ * @param C        Supplies the address of the output block.
+ * @param CountM   Supplies the number of rows to compute.
+ * @param CountN   Supplies the number of columns to compute.
+ * @param CountK   Supplies the packed K dimension, a multiple of PackedK.
+ * @param lda      Supplies the leading dimension of A.
+ * @param ldb      Supplies the number of elements between two panels of B.
+ * @param ldc      Supplies the leading dimension of C.
+ * @param alpha    Supplies the scale of the product.
+ * @param beta     Supplies the scale of the existing C, 0 to overwrite C.
+ */
+typedef
+void
+(MLAS_BF16GEMM_KERNEL)(
+    const uint16_t* A,
+    const uint16_t* B,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    float alpha,
+    float beta
+    );
+
+struct MLAS_BF16GEMM_DISPATCH {
+    MLAS_BF16GEMM_KERNEL* Kernel;
+    size_t PackedK;      /**< K alignment of packed A and B, a power of 2 */
+    size_t PackedM;      /**< row alignment of packed A */
+    size_t StrideM;
+    size_t StrideN;      /**< multiple of MLAS_BF16GEMM_PACKED_N */
+    size_t StrideK;      /**< multiple of PackedK */
+};
+
+extern const MLAS_BF16GEMM_DISPATCH MlasBf16GemmDispatchDefault;
+
+MLAS_FORCEINLINE
+const MLAS_BF16GEMM_DISPATCH*
+MlasBf16GemmGetDispatch()
+{
+#if defined(MLAS_TARGET_AMD64)
+    const MLAS_BF16GEMM_DISPATCH* dispatch = GetMlasPlatform().Bf16GemmDispatch;
+    return dispatch != nullptr ? dispatch : &MlasBf16GemmDispatchDefault;
+#else
+    return &MlasBf16GemmDispatchDefault;
+#endif
+}
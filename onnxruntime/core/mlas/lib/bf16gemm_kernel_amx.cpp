@@ -0,0 +1,231 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    bf16gemm_kernel_amx.cpp
+
+Abstract:
+
+    This module implements the bfloat16 GEMM kernel for AMX-BF16.
+
+    A tile of packed A holds 16 rows by 32 bfloat16 values, and a tile of
+    packed B holds 16 row pairs of one B panel, which is the layout
+    expected by tdpbf16ps. The kernel computes up to 32x32 of the output
+    with two A tiles, two B tiles and four fp32 accumulator tiles.
+
+--*/
+
+#include "mlasi.h"
+#include "bf16gemm.h"
+
+#define TMM0 0
+#define TMM1 1
+#define TMM2 2
+#define TMM3 3
+#define TMM4 4
+#define TMM5 5
+#define TMM6 6
+#define TMM7 7
+
+#define TILE_M 16
+#define TILE_N 16
+#define TILE_K 32
+
+// Tile configure structure
+struct tileconfig_t {
+    uint8_t palette_id = 0;
+    uint8_t reserved[15] = {0};
+    uint16_t colb[16] = {0};
+    uint8_t rows[16] = {0};
+};
+
+static
+void
+MlasBf16GemmConfigureTilesAmx()
+{
+    static thread_local bool tile_configured = false;
+    static thread_local struct tileconfig_t tc = {0};
+    if (!tile_configured) {
+        // Filling tile configure structure.
+        tc.palette_id = 1;
+        for (int t = 0; t < 8; t++) {
+            tc.rows[t] = 16;
+            tc.colb[t] = 64;
+        }
+        _tile_loadconfig(&tc);
+        tile_configured = true;
+    }
+}
+
+/**
+ * @brief Scale a 16x16 fp32 accumulator tile by alpha, add beta times the
+ *        existing output and store the valid rows and columns.
+ */
+MLAS_FORCEINLINE
+void
+MlasBf16GemmStoreTileAmx(
+    const float* Tile,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    float alpha,
+    float beta
+    )
+{
+    const __mmask16 Mask = (CountN >= TILE_N) ? __mmask16(0xFFFF) : __mmask16((1u << CountN) - 1);
+    const __m512 Alpha = _mm512_set1_ps(alpha);
+    const __m512 Beta = _mm512_set1_ps(beta);
+
+    CountM = std::min<size_t>(CountM, TILE_M);
+
+    for (size_t m = 0; m < CountM; m++) {
+        __m512 Result = _mm512_mul_ps(_mm512_load_ps(Tile + m * TILE_N), Alpha);
+        if (beta != 0.0f) {
+            Result = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(Mask, C), Beta, Result);
+        }
+        _mm512_mask_storeu_ps(C, Mask, Result);
+        C += ldc;
+    }
+}
+
+/**
+ * @brief Compute up to 32 rows by 32 columns of the result.
+ *
+ * @tparam TwoM  Whether there are more than 16 rows.
+ * @tparam TwoN  Whether there are more than 16 columns.
+ */
+template<bool TwoM, bool TwoN>
+MLAS_FORCEINLINE
+void
+MlasBf16GemmKernelAmxBlock(
+    const uint16_t* A,
+    const uint16_t* B,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    float alpha,
+    float beta
+    )
+{
+    const int StrideA = static_cast<int>(lda * sizeof(uint16_t));
+    constexpr int StrideB = TILE_N * 2 * sizeof(uint16_t);
+
+    _tile_zero(TMM4);
+    if constexpr (TwoN) {
+        _tile_zero(TMM5);
+    }
+    if constexpr (TwoM) {
+        _tile_zero(TMM6);
+        if constexpr (TwoN) {
+            _tile_zero(TMM7);
+        }
+    }
+
+    for (size_t k = 0; k < CountK; k += TILE_K) {
+        _tile_loadd(TMM0, A + k, StrideA);
+        _tile_loadd(TMM2, B + k * TILE_N, StrideB);
+        _tile_dpbf16ps(TMM4, TMM0, TMM2);
+        if constexpr (TwoN) {
+            _tile_loadd(TMM3, B + ldb + k * TILE_N, StrideB);
+            _tile_dpbf16ps(TMM5, TMM0, TMM3);
+        }
+        if constexpr (TwoM) {
+            _tile_loadd(TMM1, A + TILE_M * lda + k, StrideA);
+            _tile_dpbf16ps(TMM6, TMM1, TMM2);
+            if constexpr (TwoN) {
+                _tile_dpbf16ps(TMM7, TMM1, TMM3);
+            }
+        }
+    }
+
+    MLAS_DECLSPEC_ALIGN(float Tile[TILE_M * TILE_N], 64);
+
+    _tile_stored(TMM4, Tile, TILE_N * sizeof(float));
+    MlasBf16GemmStoreTileAmx(Tile, C, ldc, CountM, CountN, alpha, beta);
+    if constexpr (TwoN) {
+        _tile_stored(TMM5, Tile, TILE_N * sizeof(float));
+        MlasBf16GemmStoreTileAmx(Tile, C + TILE_N, ldc, CountM, CountN - TILE_N, alpha, beta);
+    }
+    if constexpr (TwoM) {
+        float* c = C + TILE_M * ldc;
+        _tile_stored(TMM6, Tile, TILE_N * sizeof(float));
+        MlasBf16GemmStoreTileAmx(Tile, c, ldc, CountM - TILE_M, CountN, alpha, beta);
+        if constexpr (TwoN) {
+            _tile_stored(TMM7, Tile, TILE_N * sizeof(float));
+            MlasBf16GemmStoreTileAmx(Tile, c + TILE_N, ldc, CountM - TILE_M, CountN - TILE_N, alpha, beta);
+        }
+    }
+}
+
+static
+void
+MlasBf16GemmKernelAmx(
+    const uint16_t* A,
+    const uint16_t* B,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    float alpha,
+    float beta
+    )
+{
+    MlasBf16GemmConfigureTilesAmx();
+
+    //
+    // Packed A is padded to whole tiles of rows, and packed B to whole
+    // panels of columns, so the tile loads stay inside the buffers.
+    //
+
+    for (size_t n = 0; n < CountN; n += 2 * TILE_N) {
+
+        const size_t cols = std::min<size_t>(CountN - n, 2 * TILE_N);
+        const uint16_t* a = A;
+        float* c = C + n;
+
+        for (size_t m = 0; m < CountM; m += 2 * TILE_M) {
+
+            const size_t rows = std::min<size_t>(CountM - m, 2 * TILE_M);
+
+            if (rows > TILE_M) {
+                if (cols > TILE_N) {
+                    MlasBf16GemmKernelAmxBlock<true, true>(a, B, c, rows, cols, CountK, lda, ldb, ldc, alpha, beta);
+                } else {
+                    MlasBf16GemmKernelAmxBlock<true, false>(a, B, c, rows, cols, CountK, lda, ldb, ldc, alpha, beta);
+                }
+            } else {
+                if (cols > TILE_N) {
+                    MlasBf16GemmKernelAmxBlock<false, true>(a, B, c, rows, cols, CountK, lda, ldb, ldc, alpha, beta);
+                } else {
+                    MlasBf16GemmKernelAmxBlock<false, false>(a, B, c, rows, cols, CountK, lda, ldb, ldc, alpha, beta);
+                }
+            }
+
+            a += 2 * TILE_M * lda;
+            c += 2 * TILE_M * ldc;
+        }
+
+        B += 2 * ldb;
+    }
+}
+
+const MLAS_BF16GEMM_DISPATCH MlasBf16GemmDispatchAmx = {
+    MlasBf16GemmKernelAmx,
+    TILE_K,
+    TILE_M,
+    64,
+    128,
+    512,
+};
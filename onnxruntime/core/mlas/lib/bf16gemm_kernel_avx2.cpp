@@ -0,0 +1,263 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    bf16gemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the bfloat16 GEMM kernel for AVX2/FMA3.
+
+    There is no bfloat16 arithmetic on these processors, so the kernel widens
+    the bfloat16 operands to fp32, which is exact, and accumulates in fp32. A
+    row pair of a packed B panel holds the even row in the low half and the odd
+    row in the high half of each 32-bit element, so a shift and a mask split
+    it into two fp32 vectors.
+
+--*/
+
+#include "mlasi.h"
+#include "bf16gemm.h"
+
+//
+// Templates used with loop unrolling to perform an action on one row of the
+// output, so that the accumulators stay in registers.
+//
+
+constexpr size_t MlasBf16GemmAvx2BlockK = 8;
+constexpr size_t MlasBf16GemmAvx2MaxM = 6;
+
+struct MlasBf16GemmAvx2ZeroRow
+{
+    template<size_t RowCount, size_t Row>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iteration(
+        __m256 Accumulators[RowCount][2]
+        )
+    {
+        Accumulators[Row][0] = _mm256_setzero_ps();
+        Accumulators[Row][1] = _mm256_setzero_ps();
+    }
+};
+
+struct MlasBf16GemmAvx2ConvertARow
+{
+    template<size_t RowCount, size_t Row>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iteration(
+        float ABlock[RowCount][MlasBf16GemmAvx2BlockK],
+        const uint16_t* A,
+        size_t lda,
+        size_t CountBlockK
+        )
+    {
+        const uint16_t* a = A + Row * lda;
+        __m128i bf16;
+        if (CountBlockK == MlasBf16GemmAvx2BlockK) {
+            bf16 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+        } else {
+            MLAS_DECLSPEC_ALIGN(uint16_t buf[MlasBf16GemmAvx2BlockK], 16) = {};
+            std::memcpy(buf, a, CountBlockK * sizeof(uint16_t));
+            bf16 = _mm_load_si128(reinterpret_cast<const __m128i*>(buf));
+        }
+        __m256i fp32 = _mm256_slli_epi32(_mm256_cvtepu16_epi32(bf16), 16);
+        _mm256_store_ps(ABlock[Row], _mm256_castsi256_ps(fp32));
+    }
+};
+
+struct MlasBf16GemmAvx2MultiplyAddRow
+{
+    template<size_t RowCount, size_t Row>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iteration(
+        __m256 Accumulators[RowCount][2],
+        const float ABlock[RowCount][MlasBf16GemmAvx2BlockK],
+        size_t kk,
+        __m256 b0,
+        __m256 b1
+        )
+    {
+        __m256 a = _mm256_broadcast_ss(&ABlock[Row][kk]);
+        Accumulators[Row][0] = _mm256_fmadd_ps(a, b0, Accumulators[Row][0]);
+        Accumulators[Row][1] = _mm256_fmadd_ps(a, b1, Accumulators[Row][1]);
+    }
+};
+
+struct MlasBf16GemmAvx2StoreRow
+{
+    template<size_t RowCount, size_t Row>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iteration(
+        __m256 Accumulators[RowCount][2],
+        float* C,
+        size_t ldc,
+        size_t cols,
+        __m256 Alpha,
+        float beta
+        )
+    {
+        float* c = C + Row * ldc;
+
+        __m256 lo = _mm256_mul_ps(Accumulators[Row][0], Alpha);
+        __m256 hi = _mm256_mul_ps(Accumulators[Row][1], Alpha);
+
+        MLAS_DECLSPEC_ALIGN(float buf[16], 32);
+        float* dest = (cols == 16) ? c : buf;
+
+        if (beta != 0.0f) {
+            if (cols < 16) {
+                std::memcpy(buf, c, cols * sizeof(float));
+            }
+            __m256 Beta = _mm256_set1_ps(beta);
+            lo = _mm256_fmadd_ps(_mm256_loadu_ps(dest), Beta, lo);
+            hi = _mm256_fmadd_ps(_mm256_loadu_ps(dest + 8), Beta, hi);
+        }
+
+        _mm256_storeu_ps(dest, lo);
+        _mm256_storeu_ps(dest + 8, hi);
+
+        if (cols < 16) {
+            std::memcpy(c, buf, cols * sizeof(float));
+        }
+    }
+};
+
+/**
+ * @brief Compute RowCount rows of the result, one panel of B at a time
+*/
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasBf16GemmKernelAvx2Rows(
+    const uint16_t* A,
+    const uint16_t* B,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    float alpha,
+    float beta
+    )
+{
+    constexpr size_t PackedN = MLAS_BF16GEMM_PACKED_N;
+    constexpr size_t BlockK = MlasBf16GemmAvx2BlockK;
+
+    const __m256i OddMask = _mm256_set1_epi32(int32_t(0xFFFF0000));
+    const __m256 Alpha = _mm256_set1_ps(alpha);
+
+    for (size_t n = 0; n < CountN; n += PackedN) {
+
+        __m256 Accumulators[RowCount][2];
+        MlasLoopUnroll<RowCount, MlasBf16GemmAvx2ZeroRow>()(Accumulators);
+
+        const uint16_t* b = B;
+
+        for (size_t k = 0; k < CountK; k += BlockK) {
+
+            //
+            // Widen a block of each row of A to fp32 so that each element
+            // can be broadcast with a single load.
+            //
+
+            const size_t CountBlockK = std::min(CountK - k, BlockK);
+            MLAS_DECLSPEC_ALIGN(float ABlock[RowCount][BlockK], 32);
+            MlasLoopUnroll<RowCount, MlasBf16GemmAvx2ConvertARow>()(ABlock, A + k, lda, CountBlockK);
+
+            for (size_t kk = 0; kk < CountBlockK; kk += 2) {
+                __m256i pair0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b));
+                __m256i pair1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + 16));
+
+                __m256 b0 = _mm256_castsi256_ps(_mm256_slli_epi32(pair0, 16));
+                __m256 b1 = _mm256_castsi256_ps(_mm256_slli_epi32(pair1, 16));
+                MlasLoopUnroll<RowCount, MlasBf16GemmAvx2MultiplyAddRow>()(Accumulators, ABlock, kk, b0, b1);
+
+                b0 = _mm256_castsi256_ps(_mm256_and_si256(pair0, OddMask));
+                b1 = _mm256_castsi256_ps(_mm256_and_si256(pair1, OddMask));
+                MlasLoopUnroll<RowCount, MlasBf16GemmAvx2MultiplyAddRow>()(Accumulators, ABlock, kk + 1, b0, b1);
+
+                b += PackedN * 2;
+            }
+        }
+
+        const size_t cols = std::min(CountN - n, PackedN);
+        MlasLoopUnroll<RowCount, MlasBf16GemmAvx2StoreRow>()(Accumulators, C + n, ldc, cols, Alpha, beta);
+
+        B += ldb;
+    }
+}
+
+static
+void
+MlasBf16GemmKernelAvx2(
+    const uint16_t* A,
+    const uint16_t* B,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    float alpha,
+    float beta
+    )
+{
+    while (CountM > 0) {
+
+        size_t RowCount;
+
+        switch (std::min(CountM, MlasBf16GemmAvx2MaxM)) {
+            case 1:
+                MlasBf16GemmKernelAvx2Rows<1>(A, B, C, CountN, CountK, lda, ldb, ldc, alpha, beta);
+                RowCount = 1;
+                break;
+            case 2:
+                MlasBf16GemmKernelAvx2Rows<2>(A, B, C, CountN, CountK, lda, ldb, ldc, alpha, beta);
+                RowCount = 2;
+                break;
+            case 3:
+                MlasBf16GemmKernelAvx2Rows<3>(A, B, C, CountN, CountK, lda, ldb, ldc, alpha, beta);
+                RowCount = 3;
+                break;
+            case 4:
+                MlasBf16GemmKernelAvx2Rows<4>(A, B, C, CountN, CountK, lda, ldb, ldc, alpha, beta);
+                RowCount = 4;
+                break;
+            case 5:
+                MlasBf16GemmKernelAvx2Rows<5>(A, B, C, CountN, CountK, lda, ldb, ldc, alpha, beta);
+                RowCount = 5;
+                break;
+            default:
+                MlasBf16GemmKernelAvx2Rows<6>(A, B, C, CountN, CountK, lda, ldb, ldc, alpha, beta);
+                RowCount = 6;
+                break;
+        }
+
+        A += RowCount * lda;
+        C += RowCount * ldc;
+        CountM -= RowCount;
+    }
+}
+
+const MLAS_BF16GEMM_DISPATCH MlasBf16GemmDispatchAvx2 = {
+    MlasBf16GemmKernelAvx2,
+    2,
+    1,
+    24,
+    128,
+    512,
+};
@@ -0,0 +1,279 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    bf16gemm_kernel_avx512bf16.cpp
+
+Abstract:
+
+    This module implements the bfloat16 GEMM kernel for AVX512-BF16.
+
+    The vdpbf16ps instruction multiplies the bfloat16 pairs of its two
+    sources and accumulates both products into the fp32 destination, which
+    is the row pair interleaved layout of a packed B panel. Each pair of A
+    elements is broadcast to all the lanes.
+
+--*/
+
+#include "mlasi.h"
+#include "bf16gemm.h"
+
+constexpr size_t MlasBf16GemmAvx512Bf16MaxM = 8;
+
+MLAS_FORCEINLINE
+__m512bh
+MlasBf16GemmCastToBf16(
+    __m512i Vector
+    )
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    return Vector;
+#else
+    return (__m512bh)Vector;
+#endif
+}
+
+MLAS_FORCEINLINE
+__mmask16
+MlasBf16GemmColumnMask(
+    size_t CountN
+    )
+{
+    return (CountN >= 16) ? __mmask16(0xFFFF) : __mmask16((1u << CountN) - 1);
+}
+
+//
+// Templates used with loop unrolling to perform an action on one row of the
+// output, so that the accumulators stay in registers.
+//
+
+template<size_t PanelCount>
+struct MlasBf16GemmAvx512Bf16ZeroRow
+{
+    template<size_t RowCount, size_t Row>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iteration(
+        __m512 Accumulators[RowCount][PanelCount]
+        )
+    {
+        Accumulators[Row][0] = _mm512_setzero_ps();
+        if constexpr (PanelCount > 1) {
+            Accumulators[Row][1] = _mm512_setzero_ps();
+        }
+    }
+};
+
+template<size_t PanelCount>
+struct MlasBf16GemmAvx512Bf16MultiplyAddRow
+{
+    template<size_t RowCount, size_t Row>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iteration(
+        __m512 Accumulators[RowCount][PanelCount],
+        const __m512bh BElements[PanelCount],
+        const uint16_t* A,
+        size_t lda
+        )
+    {
+        int32_t pair;
+        std::memcpy(&pair, A + Row * lda, sizeof(pair));
+        __m512bh AElements = MlasBf16GemmCastToBf16(_mm512_set1_epi32(pair));
+        Accumulators[Row][0] = _mm512_dpbf16_ps(Accumulators[Row][0], AElements, BElements[0]);
+        if constexpr (PanelCount > 1) {
+            Accumulators[Row][1] = _mm512_dpbf16_ps(Accumulators[Row][1], AElements, BElements[1]);
+        }
+    }
+};
+
+template<size_t PanelCount>
+struct MlasBf16GemmAvx512Bf16StoreRow
+{
+    template<size_t RowCount, size_t Row>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iteration(
+        __m512 Accumulators[RowCount][PanelCount],
+        const __mmask16 Masks[PanelCount],
+        float* C,
+        size_t ldc,
+        __m512 Alpha,
+        float beta
+        )
+    {
+        constexpr size_t PackedN = MLAS_BF16GEMM_PACKED_N;
+
+        float* c = C + Row * ldc;
+
+        for (size_t p = 0; p < PanelCount; p++) {
+            __m512 Result = _mm512_mul_ps(Accumulators[Row][p], Alpha);
+            if (beta != 0.0f) {
+                Result = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(Masks[p], c + p * PackedN),
+                                         _mm512_set1_ps(beta), Result);
+            }
+            _mm512_mask_storeu_ps(c + p * PackedN, Masks[p], Result);
+        }
+    }
+};
+
+/**
+ * @brief Compute RowCount rows by PanelCount (1 or 2) panels of the result
+ *
+ * @param B     Address of the first panel of packed B
+ * @param ldb   Distance between two adjacent panels of packed B
+*/
+template<size_t RowCount, size_t PanelCount>
+MLAS_FORCEINLINE
+void
+MlasBf16GemmKernelAvx512Bf16Block(
+    const uint16_t* A,
+    const uint16_t* B,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    float alpha,
+    float beta
+    )
+{
+    static_assert(PanelCount == 1 || PanelCount == 2, "unsupported panel count");
+    constexpr size_t PackedN = MLAS_BF16GEMM_PACKED_N;
+
+    __mmask16 Masks[PanelCount];
+    for (size_t p = 0; p < PanelCount; p++) {
+        Masks[p] = MlasBf16GemmColumnMask(CountN - p * PackedN);
+    }
+
+    __m512 Accumulators[RowCount][PanelCount];
+    MlasLoopUnroll<RowCount, MlasBf16GemmAvx512Bf16ZeroRow<PanelCount>>()(Accumulators);
+
+    for (size_t k = 0; k < CountK; k += 2) {
+        __m512bh BElements[PanelCount];
+        BElements[0] = MlasBf16GemmCastToBf16(_mm512_loadu_si512(B + k * PackedN));
+        if constexpr (PanelCount > 1) {
+            BElements[1] = MlasBf16GemmCastToBf16(_mm512_loadu_si512(B + ldb + k * PackedN));
+        }
+
+        MlasLoopUnroll<RowCount, MlasBf16GemmAvx512Bf16MultiplyAddRow<PanelCount>>()(
+            Accumulators, BElements, A + k, lda);
+    }
+
+    MlasLoopUnroll<RowCount, MlasBf16GemmAvx512Bf16StoreRow<PanelCount>>()(
+        Accumulators, Masks, C, ldc, _mm512_set1_ps(alpha), beta);
+}
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasBf16GemmKernelAvx512Bf16Rows(
+    const uint16_t* A,
+    const uint16_t* B,
+    float* C,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    float alpha,
+    float beta
+    )
+{
+    constexpr size_t PackedN = MLAS_BF16GEMM_PACKED_N;
+
+    //
+    // Process two panels at a time so that each broadcast of A is used by
+    // two multiplies.
+    //
+
+    while (CountN > PackedN) {
+        MlasBf16GemmKernelAvx512Bf16Block<RowCount, 2>(A, B, C, CountN, CountK, lda, ldb, ldc, alpha, beta);
+
+        CountN -= std::min(CountN, 2 * PackedN);
+        C += 2 * PackedN;
+        B += 2 * ldb;
+    }
+
+    if (CountN > 0) {
+        MlasBf16GemmKernelAvx512Bf16Block<RowCount, 1>(A, B, C, CountN, CountK, lda, ldb, ldc, alpha, beta);
+    }
+}
+
+static
+void
+MlasBf16GemmKernelAvx512Bf16(
+    const uint16_t* A,
+    const uint16_t* B,
+    float* C,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t lda,
+    size_t ldb,
+    size_t ldc,
+    float alpha,
+    float beta
+    )
+{
+    while (CountM > 0) {
+
+        size_t RowCount;
+
+        switch (std::min(CountM, MlasBf16GemmAvx512Bf16MaxM)) {
+            case 1:
+                MlasBf16GemmKernelAvx512Bf16Rows<1>(A, B, C, CountN, CountK, lda, ldb, ldc, alpha, beta);
+                RowCount = 1;
+                break;
+            case 2:
+                MlasBf16GemmKernelAvx512Bf16Rows<2>(A, B, C, CountN, CountK, lda, ldb, ldc, alpha, beta);
+                RowCount = 2;
+                break;
+            case 3:
+                MlasBf16GemmKernelAvx512Bf16Rows<3>(A, B, C, CountN, CountK, lda, ldb, ldc, alpha, beta);
+                RowCount = 3;
+                break;
+            case 4:
+                MlasBf16GemmKernelAvx512Bf16Rows<4>(A, B, C, CountN, CountK, lda, ldb, ldc, alpha, beta);
+                RowCount = 4;
+                break;
+            case 5:
+                MlasBf16GemmKernelAvx512Bf16Rows<5>(A, B, C, CountN, CountK, lda, ldb, ldc, alpha, beta);
+                RowCount = 5;
+                break;
+            case 6:
+                MlasBf16GemmKernelAvx512Bf16Rows<6>(A, B, C, CountN, CountK, lda, ldb, ldc, alpha, beta);
+                RowCount = 6;
+                break;
+            case 7:
+                MlasBf16GemmKernelAvx512Bf16Rows<7>(A, B, C, CountN, CountK, lda, ldb, ldc, alpha, beta);
+                RowCount = 7;
+                break;
+            default:
+                MlasBf16GemmKernelAvx512Bf16Rows<8>(A, B, C, CountN, CountK, lda, ldb, ldc, alpha, beta);
+                RowCount = 8;
+                break;
+        }
+
+        A += RowCount * lda;
+        C += RowCount * ldc;
+        CountM -= RowCount;
+    }
+}
+
+const MLAS_BF16GEMM_DISPATCH MlasBf16GemmDispatchAvx512Bf16 = {
+    MlasBf16GemmKernelAvx512Bf16,
+    2,
+    1,
+    32,
+    128,
+    512,
+};
@@ -843,7 +843,9 @@ Arguments:
 
     Input - Supplies the input tensor.
 
-    Filter - Supplies the filter tensor.
+    Filter - Supplies the filter tensor, or the filter packed by
+        MlasConvWinogradPackFilter if MlasConvPrepare selected the Winograd
+        algorithm.
 
     Bias - Optionally supplies the bias vector.
 
@@ -874,6 +876,15 @@ Return Value:
 
     const MLAS_CONV_ALGORITHM Algorithm = Parameters->Algorithm;
 
+    //
+    // The Winograd algorithm schedules the batches and groups itself.
+    //
+
+    if (Algorithm == MlasConvAlgorithmWinograd) {
+        MlasConvWinograd(Parameters, Input, Filter, Bias, WorkingBuffer, Output, ThreadPool);
+        return;
+    }
+
     //
     // Schedule batches of GEMMs across multiple threads.
     //
@@ -1002,6 +1013,9 @@ Return Value:
 
                     break;
                 }
+
+                case MlasConvAlgorithmWinograd:
+                    break;
             }
 
             //
@@ -1041,6 +1055,7 @@ MlasConvPrepare(
     const MLAS_ACTIVATION* Activation,
     size_t* WorkingBufferSize,
     float Beta,
+    bool WinogradFilterAvailable,
     MLAS_THREADPOOL* ThreadPool
     )
 /*++
@@ -1085,6 +1100,12 @@ Arguments:
     WorkingBufferSize - Receives the number of elements to allocate for the
         working buffer for intermediate results.
 
+    Beta - Supplies the scalar beta multiplier of the existing output.
+
+    WinogradFilterAvailable - Supplies true if the caller has packed the filter
+        with MlasConvWinogradPackFilter, allowing the Winograd algorithm to be
+        selected.
+
     ThreadPool - Supplies the thread pool object to use, else nullptr if the
         base library threading support should be used.
 
@@ -1168,6 +1189,10 @@ Return Value:
 
     *WorkingBufferSize = 0;
 
+    if (WinogradFilterAvailable && MlasConvWinogradTryPrepare(Parameters, WorkingBufferSize, ThreadPool)) {
+        return;
+    }
+
     if (AllStridesAreOne && AllPaddingIsZero) {
 
         //
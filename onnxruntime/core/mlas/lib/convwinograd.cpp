@@ -0,0 +1,887 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    convwinograd.cpp
+
+Abstract:
+
+    This module implements the 3x3 stride 1 convolution operation using the
+    Winograd minimal filtering algorithms F(2x2,3x3) and F(4x4,3x3).
+
+    The output image is split into tiles of m x m outputs that are computed
+    from overlapping tiles of (m+2) x (m+2) inputs. The filter and the input
+    tiles are transformed so that the convolution of a tile becomes an
+    element wise product in the transformed domain. Summed over the input
+    channels, the element wise products of a block of tiles become (m+2)^2
+    independent GEMMs of [FilterCount x InputChannels] by [InputChannels x
+    TileCount]. The products are then transformed back to output tiles.
+
+    The filter transform is done once by MlasConvWinogradPackFilter. The
+    input and output transforms are vectorized across four tiles at a time.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Transforms of Winograd F(2x2,3x3) with the interpolation points 0, 1, -1.
+//
+
+struct MLAS_WINOGRAD_F2 {
+
+    static constexpr size_t OutputTileSize = 2;
+    static constexpr size_t InputTileSize = 4;
+
+    static constexpr float FilterTransform[InputTileSize][3] = {
+        {1.0f, 0.0f, 0.0f},
+        {0.5f, 0.5f, 0.5f},
+        {0.5f, -0.5f, 0.5f},
+        {0.0f, 0.0f, 1.0f},
+    };
+
+    static
+    MLAS_FORCEINLINE
+    void
+    InputTransform(
+        const MLAS_FLOAT32X4* d,
+        size_t ds,
+        MLAS_FLOAT32X4* r,
+        size_t rs
+        )
+    {
+        const MLAS_FLOAT32X4 d0 = d[ds * 0];
+        const MLAS_FLOAT32X4 d1 = d[ds * 1];
+        const MLAS_FLOAT32X4 d2 = d[ds * 2];
+        const MLAS_FLOAT32X4 d3 = d[ds * 3];
+
+        r[rs * 0] = MlasSubtractFloat32x4(d0, d2);
+        r[rs * 1] = MlasAddFloat32x4(d1, d2);
+        r[rs * 2] = MlasSubtractFloat32x4(d2, d1);
+        r[rs * 3] = MlasSubtractFloat32x4(d1, d3);
+    }
+
+    static
+    MLAS_FORCEINLINE
+    void
+    OutputTransform(
+        const MLAS_FLOAT32X4* m,
+        size_t ms,
+        MLAS_FLOAT32X4* r,
+        size_t rs
+        )
+    {
+        const MLAS_FLOAT32X4 m0 = m[ms * 0];
+        const MLAS_FLOAT32X4 m1 = m[ms * 1];
+        const MLAS_FLOAT32X4 m2 = m[ms * 2];
+        const MLAS_FLOAT32X4 m3 = m[ms * 3];
+
+        r[rs * 0] = MlasAddFloat32x4(MlasAddFloat32x4(m0, m1), m2);
+        r[rs * 1] = MlasSubtractFloat32x4(MlasSubtractFloat32x4(m1, m2), m3);
+    }
+};
+
+//
+// Transforms of Winograd F(4x4,3x3) with the interpolation points 0, 1, -1,
+// 2, -2.
+//
+
+struct MLAS_WINOGRAD_F4 {
+
+    static constexpr size_t OutputTileSize = 4;
+    static constexpr size_t InputTileSize = 6;
+
+    static constexpr float FilterTransform[InputTileSize][3] = {
+        {1.0f / 4.0f, 0.0f, 0.0f},
+        {-1.0f / 6.0f, -1.0f / 6.0f, -1.0f / 6.0f},
+        {-1.0f / 6.0f, 1.0f / 6.0f, -1.0f / 6.0f},
+        {1.0f / 24.0f, 1.0f / 12.0f, 1.0f / 6.0f},
+        {1.0f / 24.0f, -1.0f / 12.0f, 1.0f / 6.0f},
+        {0.0f, 0.0f, 1.0f},
+    };
+
+    static
+    MLAS_FORCEINLINE
+    void
+    InputTransform(
+        const MLAS_FLOAT32X4* d,
+        size_t ds,
+        MLAS_FLOAT32X4* r,
+        size_t rs
+        )
+    {
+        const MLAS_FLOAT32X4 d0 = d[ds * 0];
+        const MLAS_FLOAT32X4 d1 = d[ds * 1];
+        const MLAS_FLOAT32X4 d2 = d[ds * 2];
+        const MLAS_FLOAT32X4 d3 = d[ds * 3];
+        const MLAS_FLOAT32X4 d4 = d[ds * 4];
+        const MLAS_FLOAT32X4 d5 = d[ds * 5];
+
+        // r1 = (d3 + d4) - 4 * (d1 + d2), r2 = (d4 - d3) + 4 * (d1 - d2)
+        const MLAS_FLOAT32X4 t12a = MlasMultiplyAddFloat32x4(d2, -4.0f, d4);
+        const MLAS_FLOAT32X4 t12b = MlasMultiplyAddFloat32x4(d1, -4.0f, d3);
+
+        // r3 = (d4 - d2) + 2 * (d3 - d1), r4 = (d4 - d2) - 2 * (d3 - d1)
+        const MLAS_FLOAT32X4 t34a = MlasSubtractFloat32x4(d4, d2);
+        const MLAS_FLOAT32X4 t34b = MlasMultiplyFloat32x4(MlasSubtractFloat32x4(d3, d1), MlasBroadcastFloat32x4(2.0f));
+
+        r[rs * 0] = MlasAddFloat32x4(MlasMultiplyAddFloat32x4(d2, -5.0f, MlasMultiplyFloat32x4(d0, MlasBroadcastFloat32x4(4.0f))), d4);
+        r[rs * 1] = MlasAddFloat32x4(t12a, t12b);
+        r[rs * 2] = MlasSubtractFloat32x4(t12a, t12b);
+        r[rs * 3] = MlasAddFloat32x4(t34a, t34b);
+        r[rs * 4] = MlasSubtractFloat32x4(t34a, t34b);
+        r[rs * 5] = MlasAddFloat32x4(MlasMultiplyAddFloat32x4(d3, -5.0f, MlasMultiplyFloat32x4(d1, MlasBroadcastFloat32x4(4.0f))), d5);
+    }
+
+    static
+    MLAS_FORCEINLINE
+    void
+    OutputTransform(
+        const MLAS_FLOAT32X4* m,
+        size_t ms,
+        MLAS_FLOAT32X4* r,
+        size_t rs
+        )
+    {
+        const MLAS_FLOAT32X4 m0 = m[ms * 0];
+        const MLAS_FLOAT32X4 m1 = m[ms * 1];
+        const MLAS_FLOAT32X4 m2 = m[ms * 2];
+        const MLAS_FLOAT32X4 m3 = m[ms * 3];
+        const MLAS_FLOAT32X4 m4 = m[ms * 4];
+        const MLAS_FLOAT32X4 m5 = m[ms * 5];
+
+        const MLAS_FLOAT32X4 a12 = MlasAddFloat32x4(m1, m2);
+        const MLAS_FLOAT32X4 s12 = MlasSubtractFloat32x4(m1, m2);
+        const MLAS_FLOAT32X4 a34 = MlasAddFloat32x4(m3, m4);
+        const MLAS_FLOAT32X4 s34 = MlasSubtractFloat32x4(m3, m4);
+
+        r[rs * 0] = MlasAddFloat32x4(MlasAddFloat32x4(m0, a12), a34);
+        r[rs * 1] = MlasMultiplyAddFloat32x4(s34, 2.0f, s12);
+        r[rs * 2] = MlasMultiplyAddFloat32x4(a34, 4.0f, a12);
+        r[rs * 3] = MlasAddFloat32x4(MlasMultiplyAddFloat32x4(s34, 8.0f, s12), m5);
+    }
+};
+
+static
+size_t
+MlasConvWinogradOutputTileSize(
+    size_t InputChannels,
+    size_t FilterCount
+    )
+/*++
+
+Routine Description:
+
+    This routine selects the Winograd algorithm for the channel counts of a
+    convolution.
+
+    The transforms cost a fixed amount of work per tile and channel while
+    the GEMMs scale with the product of the channel counts, so small channel
+    counts are left to the other algorithms. F(4x4,3x3) saves the most
+    multiplications but has larger transforms, so it is used once both
+    channel counts are large enough to amortize them.
+
+Arguments:
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+Return Value:
+
+    Returns the size of the output tiles, 2 or 4, or 0 if the Winograd
+    algorithm is not profitable.
+
+--*/
+{
+    if (InputChannels < 16 || FilterCount < 16) {
+        return 0;
+    }
+
+    if (InputChannels >= 32 && FilterCount >= 32) {
+        return MLAS_WINOGRAD_F4::OutputTileSize;
+    }
+
+    return MLAS_WINOGRAD_F2::OutputTileSize;
+}
+
+size_t
+MLASCALL
+MlasConvWinogradPackFilterSize(
+    size_t Dimensions,
+    size_t GroupCount,
+    size_t InputChannels,
+    const int64_t* KernelShape,
+    const int64_t* DilationShape,
+    const int64_t* StrideShape,
+    size_t FilterCount
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the number of elements of the filter packed by
+    MlasConvWinogradPackFilter.
+
+Arguments:
+
+    Dimensions - Supplies the number of dimensions of the convolution.
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    KernelShape - Supplies the shape of the kernel.
+
+    DilationShape - Supplies the shape of the dilation.
+
+    StrideShape - Supplies the shape of the stride.
+
+    FilterCount - Supplies the number of filters per group.
+
+Return Value:
+
+    Returns the number of elements of the packed filter, or 0 if the
+    convolution cannot use the Winograd algorithm.
+
+--*/
+{
+    if (Dimensions != 2) {
+        return 0;
+    }
+
+    for (size_t dim = 0; dim < 2; dim++) {
+        if (KernelShape[dim] != 3 || DilationShape[dim] != 1 || StrideShape[dim] != 1) {
+            return 0;
+        }
+    }
+
+    const size_t OutputTileSize = MlasConvWinogradOutputTileSize(InputChannels, FilterCount);
+
+    if (OutputTileSize == 0) {
+        return 0;
+    }
+
+    const size_t InputTileSize = OutputTileSize + 2;
+
+    return GroupCount * InputTileSize * InputTileSize * FilterCount * InputChannels;
+}
+
+template<typename Winograd>
+void
+MlasConvWinogradPackFilterTemplate(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter
+    )
+{
+    constexpr size_t InputTileSize = Winograd::InputTileSize;
+    constexpr size_t TransformedSize = InputTileSize * InputTileSize;
+
+    const size_t MatrixSize = FilterCount * InputChannels;
+
+    for (size_t g = 0; g < GroupCount; g++) {
+
+        for (size_t k = 0; k < FilterCount; k++) {
+
+            for (size_t c = 0; c < InputChannels; c++) {
+
+                //
+                // Compute G * filter * G^T.
+                //
+
+                float Temp[InputTileSize][3];
+
+                for (size_t i = 0; i < InputTileSize; i++) {
+                    for (size_t j = 0; j < 3; j++) {
+                        Temp[i][j] = Winograd::FilterTransform[i][0] * Filter[0 * 3 + j] +
+                                     Winograd::FilterTransform[i][1] * Filter[1 * 3 + j] +
+                                     Winograd::FilterTransform[i][2] * Filter[2 * 3 + j];
+                    }
+                }
+
+                for (size_t i = 0; i < InputTileSize; i++) {
+                    for (size_t j = 0; j < InputTileSize; j++) {
+                        PackedFilter[(i * InputTileSize + j) * MatrixSize + k * InputChannels + c] =
+                            Temp[i][0] * Winograd::FilterTransform[j][0] +
+                            Temp[i][1] * Winograd::FilterTransform[j][1] +
+                            Temp[i][2] * Winograd::FilterTransform[j][2];
+                    }
+                }
+
+                Filter += 9;
+            }
+        }
+
+        PackedFilter += TransformedSize * MatrixSize;
+    }
+}
+
+void
+MLASCALL
+MlasConvWinogradPackFilter(
+    size_t GroupCount,
+    size_t InputChannels,
+    size_t FilterCount,
+    const float* Filter,
+    float* PackedFilter
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms the filter of a 3x3 convolution for the Winograd
+    algorithm selected for the channel counts.
+
+    The packed filter of a group is stored as (m+2)^2 matrices of
+    [FilterCount x InputChannels], one per element of the transformed tile.
+
+Arguments:
+
+    GroupCount - Supplies the number of channel groups.
+
+    InputChannels - Supplies the number of input channels per group.
+
+    FilterCount - Supplies the number of filters per group.
+
+    Filter - Supplies the filter tensor, [GroupCount * FilterCount]
+        [InputChannels][3][3].
+
+    PackedFilter - Supplies the buffer of MlasConvWinogradPackFilterSize
+        elements that receives the packed filter.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (MlasConvWinogradOutputTileSize(InputChannels, FilterCount)) {
+        case MLAS_WINOGRAD_F2::OutputTileSize:
+            MlasConvWinogradPackFilterTemplate<MLAS_WINOGRAD_F2>(GroupCount, InputChannels, FilterCount, Filter, PackedFilter);
+            break;
+        case MLAS_WINOGRAD_F4::OutputTileSize:
+            MlasConvWinogradPackFilterTemplate<MLAS_WINOGRAD_F4>(GroupCount, InputChannels, FilterCount, Filter, PackedFilter);
+            break;
+        default:
+            MLAS_THROW_EX(std::invalid_argument, "Channel counts of convolution are not supported by Winograd");
+    }
+}
+
+bool
+MlasConvWinogradTryPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine selects the Winograd algorithm for a convolution if the
+    convolution supports it. The conditions match those of
+    MlasConvWinogradPackFilterSize, so a convolution with a packed filter
+    always uses the Winograd algorithm.
+
+    The tiles are processed in blocks sized so that the transformed inputs
+    and products of a block stay in the cache. When there are fewer blocks
+    than threads, the filters are also split into blocks.
+
+Arguments:
+
+    Parameters - Supplies the structure that stores the provided and computed
+        parameters for the convolution operation.
+
+    WorkingBufferSize - Receives the number of elements to allocate for the
+        working buffer for intermediate results.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    Returns true if the Winograd algorithm was selected.
+
+--*/
+{
+    if (Parameters->Dimensions != 2) {
+        return false;
+    }
+
+    for (size_t dim = 0; dim < 2; dim++) {
+        if (Parameters->KernelShape[dim] != 3 || Parameters->DilationShape[dim] != 1 ||
+            Parameters->StrideShape[dim] != 1) {
+            return false;
+        }
+    }
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t OutputTileSize = MlasConvWinogradOutputTileSize(InputChannels, FilterCount);
+
+    if (OutputTileSize == 0) {
+        return false;
+    }
+
+    const size_t InputTileSize = OutputTileSize + 2;
+    const size_t TransformedSize = InputTileSize * InputTileSize;
+
+    const size_t TileCount = MlasDivRoundup(Parameters->OutputShape[0], OutputTileSize) *
+                             MlasDivRoundup(Parameters->OutputShape[1], OutputTileSize);
+
+    //
+    // Size the block of tiles so that the transformed inputs and products of
+    // the block use about 1MB. The block is a multiple of the four tiles of a
+    // vector.
+    //
+
+    constexpr size_t BlockElements = 256 * 1024;
+
+    size_t TileBlockSize = BlockElements / (TransformedSize * (InputChannels + FilterCount));
+
+    TileBlockSize = std::max(std::min(TileBlockSize, size_t(64)), size_t(8)) & ~size_t(3);
+    TileBlockSize = std::min(TileBlockSize, (TileCount + 3) & ~size_t(3));
+
+    const size_t TileBlockCount = MlasDivRoundup(TileCount, TileBlockSize);
+    const size_t TileWorkCount = Parameters->BatchCount * Parameters->GroupCount * TileBlockCount;
+
+    //
+    // Split the filters when there are not enough blocks of tiles for the
+    // threads, keeping at least 16 filters per block.
+    //
+
+    const size_t MaximumThreadCount = size_t(MlasGetMaximumThreadCount(ThreadPool));
+
+    size_t FilterBlockSize = FilterCount;
+
+    if (TileWorkCount < MaximumThreadCount) {
+        const size_t FilterBlockCount = std::min(MlasDivRoundup(MaximumThreadCount, TileWorkCount),
+                                                 FilterCount / 16);
+        if (FilterBlockCount > 1) {
+            FilterBlockSize = MlasDivRoundup(FilterCount, FilterBlockCount);
+        }
+    }
+
+    const size_t WorkCount = TileWorkCount * MlasDivRoundup(FilterCount, FilterBlockSize);
+    const size_t ThreadCount = std::min(WorkCount, MaximumThreadCount);
+
+    Parameters->Algorithm = MlasConvAlgorithmWinograd;
+    Parameters->ThreadCount = ptrdiff_t(ThreadCount);
+    Parameters->u.Winograd.OutputTileSize = OutputTileSize;
+    Parameters->u.Winograd.TileBlockSize = TileBlockSize;
+    Parameters->u.Winograd.FilterBlockSize = FilterBlockSize;
+
+    *WorkingBufferSize = ThreadCount * TransformedSize * (InputChannels + FilterBlockSize) * TileBlockSize;
+
+    return true;
+}
+
+template<typename Winograd>
+void
+MlasConvWinogradTransformInput(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    size_t TileIndex,
+    size_t TileCount,
+    float* TransformedInput
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms the input tiles of a block for every input
+    channel. The transformed input is stored as (m+2)^2 matrices of
+    [InputChannels x TileBlockSize].
+
+--*/
+{
+    constexpr size_t OutputTileSize = Winograd::OutputTileSize;
+    constexpr size_t InputTileSize = Winograd::InputTileSize;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t InputHeight = Parameters->InputShape[0];
+    const size_t InputWidth = Parameters->InputShape[1];
+    const size_t InputSize = Parameters->InputSize;
+    const size_t PaddingTop = Parameters->Padding[0];
+    const size_t PaddingLeft = Parameters->Padding[1];
+    const size_t TilesPerRow = MlasDivRoundup(Parameters->OutputShape[1], OutputTileSize);
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
+    const size_t MatrixSize = InputChannels * TileBlockSize;
+
+    for (size_t c = 0; c < InputChannels; c++) {
+
+        for (size_t t = 0; t < TileCount; t += 4) {
+
+            //
+            // Gather the input tiles of four output tiles with the elements of
+            // the four tiles interleaved, zero filling the padding and the
+            // lanes past the end of the block.
+            //
+
+            MLAS_DECLSPEC_ALIGN(float Tiles[InputTileSize][InputTileSize][4], 16);
+
+            for (size_t l = 0; l < 4; l++) {
+
+                if (t + l >= TileCount) {
+                    for (size_t i = 0; i < InputTileSize; i++) {
+                        for (size_t j = 0; j < InputTileSize; j++) {
+                            Tiles[i][j][l] = 0.0f;
+                        }
+                    }
+                    continue;
+                }
+
+                const size_t Tile = TileIndex + t + l;
+                const size_t ih0 = (Tile / TilesPerRow) * OutputTileSize - PaddingTop;
+                const size_t iw0 = (Tile % TilesPerRow) * OutputTileSize - PaddingLeft;
+
+                //
+                // The unsigned coordinates of tiles that start in the padding
+                // wrap around, so these fail the first comparisons.
+                //
+
+                if (ih0 < InputHeight && ih0 + InputTileSize <= InputHeight &&
+                    iw0 < InputWidth && iw0 + InputTileSize <= InputWidth) {
+
+                    const float* input = Input + ih0 * InputWidth + iw0;
+
+                    for (size_t i = 0; i < InputTileSize; i++) {
+                        for (size_t j = 0; j < InputTileSize; j++) {
+                            Tiles[i][j][l] = input[j];
+                        }
+                        input += InputWidth;
+                    }
+
+                } else {
+
+                    //
+                    // The tile crosses the padding.
+                    //
+
+                    for (size_t i = 0; i < InputTileSize; i++) {
+                        const size_t ih = ih0 + i;
+                        for (size_t j = 0; j < InputTileSize; j++) {
+                            const size_t iw = iw0 + j;
+                            Tiles[i][j][l] = (ih < InputHeight && iw < InputWidth) ? Input[ih * InputWidth + iw] : 0.0f;
+                        }
+                    }
+                }
+            }
+
+            //
+            // Compute B^T * tile * B.
+            //
+
+            MLAS_FLOAT32X4 d[InputTileSize][InputTileSize];
+            MLAS_FLOAT32X4 Temp[InputTileSize][InputTileSize];
+
+            for (size_t i = 0; i < InputTileSize; i++) {
+                for (size_t j = 0; j < InputTileSize; j++) {
+                    d[i][j] = MlasLoadFloat32x4(Tiles[i][j]);
+                }
+            }
+
+            for (size_t j = 0; j < InputTileSize; j++) {
+                Winograd::InputTransform(&d[0][j], InputTileSize, &Temp[0][j], InputTileSize);
+            }
+
+            for (size_t i = 0; i < InputTileSize; i++) {
+                Winograd::InputTransform(&Temp[i][0], 1, &d[i][0], 1);
+            }
+
+            float* output = TransformedInput + c * TileBlockSize + t;
+
+            for (size_t i = 0; i < InputTileSize; i++) {
+                for (size_t j = 0; j < InputTileSize; j++) {
+                    MlasStoreFloat32x4(output, d[i][j]);
+                    output += MatrixSize;
+                }
+            }
+        }
+
+        Input += InputSize;
+    }
+}
+
+template<typename Winograd>
+void
+MlasConvWinogradTransformOutput(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Products,
+    size_t TileIndex,
+    size_t TileCount,
+    size_t FilterCount,
+    const float* Bias,
+    float* Output
+    )
+/*++
+
+Routine Description:
+
+    This routine transforms the products of a block back to output tiles for
+    a block of filters, accumulating with the existing output if Beta is not
+    zero, and then applies the bias and activation to the output rows of the
+    block. The products are stored as (m+2)^2 matrices of [FilterBlockSize x
+    TileBlockSize].
+
+--*/
+{
+    constexpr size_t OutputTileSize = Winograd::OutputTileSize;
+    constexpr size_t InputTileSize = Winograd::InputTileSize;
+
+    const size_t OutputHeight = Parameters->OutputShape[0];
+    const size_t OutputWidth = Parameters->OutputShape[1];
+    const size_t OutputSize = Parameters->OutputSize;
+    const size_t TilesPerRow = MlasDivRoundup(OutputWidth, OutputTileSize);
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
+    const size_t MatrixSize = Parameters->u.Winograd.FilterBlockSize * TileBlockSize;
+    const float Beta = Parameters->Beta;
+
+    for (size_t k = 0; k < FilterCount; k++) {
+
+        float* output = Output + k * OutputSize;
+
+        for (size_t t = 0; t < TileCount; t += 4) {
+
+            //
+            // Compute A^T * products * A for four tiles.
+            //
+
+            MLAS_FLOAT32X4 m[InputTileSize][InputTileSize];
+            MLAS_FLOAT32X4 Temp[OutputTileSize][InputTileSize];
+            MLAS_FLOAT32X4 y[OutputTileSize][OutputTileSize];
+
+            const float* products = Products + k * TileBlockSize + t;
+
+            for (size_t i = 0; i < InputTileSize; i++) {
+                for (size_t j = 0; j < InputTileSize; j++) {
+                    m[i][j] = MlasLoadFloat32x4(products);
+                    products += MatrixSize;
+                }
+            }
+
+            for (size_t j = 0; j < InputTileSize; j++) {
+                Winograd::OutputTransform(&m[0][j], InputTileSize, &Temp[0][j], InputTileSize);
+            }
+
+            for (size_t i = 0; i < OutputTileSize; i++) {
+                Winograd::OutputTransform(&Temp[i][0], 1, &y[i][0], 1);
+            }
+
+            //
+            // Scatter the tiles to the output, clipping the tiles that cross
+            // the right or bottom edge.
+            //
+
+            MLAS_DECLSPEC_ALIGN(float Tiles[OutputTileSize][OutputTileSize][4], 16);
+
+            for (size_t i = 0; i < OutputTileSize; i++) {
+                for (size_t j = 0; j < OutputTileSize; j++) {
+                    MlasStoreFloat32x4(Tiles[i][j], y[i][j]);
+                }
+            }
+
+            const size_t LaneCount = std::min(TileCount - t, size_t(4));
+
+            for (size_t l = 0; l < LaneCount; l++) {
+
+                const size_t Tile = TileIndex + t + l;
+                const size_t oh0 = (Tile / TilesPerRow) * OutputTileSize;
+                const size_t ow0 = (Tile % TilesPerRow) * OutputTileSize;
+                const size_t RowCount = std::min(OutputHeight - oh0, OutputTileSize);
+                const size_t ColumnCount = std::min(OutputWidth - ow0, OutputTileSize);
+
+                for (size_t i = 0; i < RowCount; i++) {
+
+                    float* row = output + (oh0 + i) * OutputWidth + ow0;
+
+                    if (Beta == 0.0f) {
+                        for (size_t j = 0; j < ColumnCount; j++) {
+                            row[j] = Tiles[i][j][l];
+                        }
+                    } else {
+                        for (size_t j = 0; j < ColumnCount; j++) {
+                            row[j] = Tiles[i][j][l] + Beta * row[j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    //
+    // Apply the activation with optional bias to the runs of output rows
+    // covered by each row of tiles of the block.
+    //
+
+    size_t Tile = TileIndex;
+    const size_t TileEnd = TileIndex + TileCount;
+
+    while (Tile < TileEnd) {
+
+        const size_t TileRow = Tile / TilesPerRow;
+        const size_t TileRowEnd = std::min((TileRow + 1) * TilesPerRow, TileEnd);
+
+        const size_t oh0 = TileRow * OutputTileSize;
+        const size_t ow0 = (Tile % TilesPerRow) * OutputTileSize;
+        const size_t ow1 = std::min(((TileRowEnd - 1) % TilesPerRow + 1) * OutputTileSize, OutputWidth);
+        const size_t RowCount = std::min(OutputHeight - oh0, OutputTileSize);
+
+        for (size_t i = 0; i < RowCount; i++) {
+            MlasActivation(Parameters->Activation, Output + (oh0 + i) * OutputWidth + ow0, Bias, FilterCount,
+                ow1 - ow0, OutputSize);
+        }
+
+        Tile = TileRowEnd;
+    }
+}
+
+template<typename Winograd>
+void
+MlasConvWinogradTemplate(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* PackedFilter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    constexpr size_t OutputTileSize = Winograd::OutputTileSize;
+    constexpr size_t InputTileSize = Winograd::InputTileSize;
+    constexpr size_t TransformedSize = InputTileSize * InputTileSize;
+
+    const size_t InputChannels = Parameters->InputChannels;
+    const size_t FilterCount = Parameters->FilterCount;
+    const size_t GroupCount = Parameters->GroupCount;
+    const size_t TileBlockSize = Parameters->u.Winograd.TileBlockSize;
+    const size_t FilterBlockSize = Parameters->u.Winograd.FilterBlockSize;
+
+    const size_t TileCount = MlasDivRoundup(Parameters->OutputShape[0], OutputTileSize) *
+                             MlasDivRoundup(Parameters->OutputShape[1], OutputTileSize);
+    const size_t TileBlockCount = MlasDivRoundup(TileCount, TileBlockSize);
+    const size_t FilterBlockCount = MlasDivRoundup(FilterCount, FilterBlockSize);
+    const size_t WorkCount = Parameters->BatchCount * GroupCount * TileBlockCount * FilterBlockCount;
+
+    const size_t FilterMatrixSize = FilterCount * InputChannels;
+    const size_t WorkingBufferSizePerThread = TransformedSize * (InputChannels + FilterBlockSize) * TileBlockSize;
+
+    const ptrdiff_t ThreadCount = Parameters->ThreadCount;
+
+    MlasTrySimpleParallel(ThreadPool, ThreadCount, [&](ptrdiff_t tid) {
+
+        size_t WorkIndex;
+        size_t WorkRemaining;
+
+        MlasPartitionWork(tid, ThreadCount, WorkCount, &WorkIndex, &WorkRemaining);
+
+        float* TransformedInput = WorkingBuffer + tid * WorkingBufferSizePerThread;
+        float* Products = TransformedInput + TransformedSize * InputChannels * TileBlockSize;
+
+        //
+        // The work items of a block of tiles are adjacent, so the transformed
+        // input is reused across the blocks of filters of a thread.
+        //
+
+        size_t TransformedTileWork = SIZE_MAX;
+
+        for (; WorkRemaining > 0; WorkIndex++, WorkRemaining--) {
+
+            const size_t FilterBlock = WorkIndex % FilterBlockCount;
+            const size_t TileWork = WorkIndex / FilterBlockCount;
+            const size_t TileBlock = TileWork % TileBlockCount;
+            const size_t BatchGroup = TileWork / TileBlockCount;
+            const size_t Group = BatchGroup % GroupCount;
+
+            const size_t TileIndex = TileBlock * TileBlockSize;
+            const size_t TileBlockCountN = std::min(TileCount - TileIndex, TileBlockSize);
+            const size_t FilterIndex = FilterBlock * FilterBlockSize;
+            const size_t FilterBlockCountM = std::min(FilterCount - FilterIndex, FilterBlockSize);
+
+            if (TileWork != TransformedTileWork) {
+                MlasConvWinogradTransformInput<Winograd>(Parameters,
+                    Input + BatchGroup * InputChannels * Parameters->InputSize, TileIndex, TileBlockCountN,
+                    TransformedInput);
+                TransformedTileWork = TileWork;
+            }
+
+            //
+            // Multiply each element of the transformed filters by the same
+            // element of the transformed input tiles.
+            //
+
+            const float* filter = PackedFilter + Group * TransformedSize * FilterMatrixSize +
+                                  FilterIndex * InputChannels;
+            const size_t CountN = (TileBlockCountN + 3) & ~size_t(3);
+
+            for (size_t e = 0; e < TransformedSize; e++) {
+                MlasSgemmOperation(CblasNoTrans, CblasNoTrans, FilterBlockCountM, CountN, InputChannels, 1.0f,
+                    filter + e * FilterMatrixSize, InputChannels,
+                    TransformedInput + e * InputChannels * TileBlockSize, TileBlockSize, 0.0f,
+                    Products + e * FilterBlockSize * TileBlockSize, TileBlockSize);
+            }
+
+            MlasConvWinogradTransformOutput<Winograd>(Parameters, Products, TileIndex, TileBlockCountN,
+                FilterBlockCountM, (Bias != nullptr) ? Bias + Group * FilterCount + FilterIndex : nullptr,
+                Output + (BatchGroup * FilterCount + FilterIndex) * Parameters->OutputSize);
+        }
+    });
+}
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* PackedFilter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the convolution operation with the Winograd
+    algorithm selected by MlasConvPrepare.
+
+Arguments:
+
+    Parameters - Supplies the structure that contains the convolution
+        parameters.
+
+    Input - Supplies the input tensor.
+
+    PackedFilter - Supplies the filter packed by MlasConvWinogradPackFilter.
+
+    Bias - Optionally supplies the bias vector.
+
+    WorkingBuffer - Supplies a working buffer sized to the number of elements
+        returned by MlasConvPrepare.
+
+    Output - Supplies the output tensor.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Parameters->u.Winograd.OutputTileSize == MLAS_WINOGRAD_F4::OutputTileSize) {
+        MlasConvWinogradTemplate<MLAS_WINOGRAD_F4>(Parameters, Input, PackedFilter, Bias, WorkingBuffer, Output,
+            ThreadPool);
+    } else {
+        MlasConvWinogradTemplate<MLAS_WINOGRAD_F2>(Parameters, Input, PackedFilter, Bias, WorkingBuffer, Output,
+            ThreadPool);
+    }
+}
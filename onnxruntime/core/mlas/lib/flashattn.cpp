@@ -0,0 +1,329 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    flashattn.cpp
+
+Abstract:
+
+    This module implements a fused attention routine that never materializes
+    the S x T score matrix.
+
+    A tile of queries is multiplied with one block of keys at a time. The
+    scores of the block are exponentiated against the running maximum of each
+    query, and the partial output and running sum are rescaled whenever the
+    maximum grows:
+
+        m' = max(m, max(s))
+        l' = l * exp(m - m') + sum(exp(s - m'))
+        O' = O * exp(m - m') + exp(s - m') * V
+
+    The output is divided by the running sum once all key blocks are done.
+    Only a score block and the output accumulators of a tile are kept in the
+    thread local buffer.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Number of queries of a tile and number of keys of a block. A tile is the
+// unit of work scheduled to a thread.
+//
+
+constexpr size_t MLAS_FLASH_ATTENTION_TILE_S = 128;
+constexpr size_t MLAS_FLASH_ATTENTION_BLOCK_T = 256;
+
+MLAS_FORCEINLINE
+float
+MlasFlashAttentionReduceMaximum(
+    const float* Input,
+    size_t N
+    )
+{
+#if defined(MLAS_TARGET_AMD64)
+    return GetMlasPlatform().ReduceMaximumF32Kernel(Input, N);
+#else
+    return MlasReduceMaximumF32Kernel(Input, N);
+#endif
+}
+
+MLAS_FORCEINLINE
+float
+MlasFlashAttentionComputeSumExp(
+    float* Buffer,
+    size_t N,
+    float Maximum
+    )
+{
+    const float NegativeMaximum = -Maximum;
+#if defined(MLAS_TARGET_AMD64)
+    return GetMlasPlatform().ComputeSumExpF32Kernel(Buffer, Buffer, N, &NegativeMaximum);
+#else
+    return MlasComputeSumExpF32Kernel(Buffer, Buffer, N, &NegativeMaximum);
+#endif
+}
+
+static
+void
+MlasFlashAttentionTile(
+    const MLAS_FLASH_ATTENTION_PARAMS* Params,
+    size_t BatchIdx,
+    size_t HeadIdx,
+    size_t StartS,
+    size_t CountS,
+    float* Scores,
+    float* Accumulators,
+    float* RowMaximum,
+    float* RowSum
+    )
+/*++
+
+Routine Description:
+
+    This routine computes the output of CountS queries of one head.
+
+Arguments:
+
+    Params - Supplies the parameters of the operation.
+
+    BatchIdx - Supplies the batch index.
+
+    HeadIdx - Supplies the head index.
+
+    StartS - Supplies the first query of the tile.
+
+    CountS - Supplies the number of queries of the tile.
+
+    Scores - Supplies a buffer of TILE_S x BLOCK_T elements.
+
+    Accumulators - Supplies a buffer of TILE_S x VHeadSize elements.
+
+    RowMaximum - Supplies a buffer of TILE_S elements.
+
+    RowSum - Supplies a buffer of TILE_S elements.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t S = Params->SequenceLength;
+    const size_t T = Params->KvSequenceLength;
+    const size_t N = Params->NumHeads;
+    const size_t QkHeadSize = Params->QkHeadSize;
+    const size_t VHeadSize = Params->VHeadSize;
+    const size_t PastLength = T - S;
+    const size_t HeadOffset = BatchIdx * N + HeadIdx;
+    const size_t KvBufferLength = (Params->KvBufferSequenceLength != 0) ? Params->KvBufferSequenceLength : T;
+
+    const float* Query = Params->Query + (HeadOffset * S + StartS) * QkHeadSize;
+    const float* Key = Params->Key + HeadOffset * KvBufferLength * QkHeadSize;
+    const float* Value = Params->Value + HeadOffset * KvBufferLength * VHeadSize;
+
+    const float* Mask = nullptr;
+    if (Params->Mask != nullptr) {
+        Mask = Params->Mask + BatchIdx * Params->MaskBatchStride + StartS * Params->MaskRowStride;
+    }
+
+    const float* Bias = nullptr;
+    if (Params->Bias != nullptr) {
+        Bias = Params->Bias + BatchIdx * Params->BiasBatchStride + (HeadIdx * S + StartS) * T;
+    }
+
+    //
+    // Without an additive mask, the keys past the causal limit of the last
+    // query of the tile have no weight and their blocks are skipped. A mask
+    // may hide every visible key of a query, in which case the hidden keys
+    // take part in the softmax as they do in the unfused computation.
+    //
+
+    size_t EndT = T;
+    if (Params->Causal && Mask == nullptr) {
+        EndT = std::min(T, PastLength + StartS + CountS);
+    }
+
+    size_t CountT;
+
+    for (size_t t = 0; t < EndT; t += CountT) {
+
+        CountT = std::min(EndT - t, MLAS_FLASH_ATTENTION_BLOCK_T);
+
+        MlasGemm(CblasNoTrans, CblasTrans, CountS, CountT, QkHeadSize,
+                 Params->Scale, Query, QkHeadSize, Key + t * QkHeadSize, QkHeadSize,
+                 0.0f, Scores, MLAS_FLASH_ATTENTION_BLOCK_T, nullptr);
+
+        for (size_t s = 0; s < CountS; s++) {
+
+            float* Row = Scores + s * MLAS_FLASH_ATTENTION_BLOCK_T;
+
+            if (Params->Causal) {
+                const size_t VisibleT = PastLength + StartS + s + 1;
+                for (size_t i = (VisibleT > t) ? VisibleT - t : 0; i < CountT; i++) {
+                    Row[i] = Params->CausalMaskValue;
+                }
+            }
+
+            if (Mask != nullptr) {
+                const float* MaskRow = Mask + s * Params->MaskRowStride + t;
+                for (size_t i = 0; i < CountT; i++) {
+                    Row[i] += MaskRow[i];
+                }
+            }
+
+            if (Bias != nullptr) {
+                const float* BiasRow = Bias + s * T + t;
+                for (size_t i = 0; i < CountT; i++) {
+                    Row[i] += BiasRow[i];
+                }
+            }
+
+            //
+            // Update the running maximum and sum, and rescale the output
+            // accumulated from the previous blocks.
+            //
+
+            const float Maximum = std::max(RowMaximum[s], MlasFlashAttentionReduceMaximum(Row, CountT));
+            const float Sum = MlasFlashAttentionComputeSumExp(Row, CountT, Maximum);
+
+            if (t == 0) {
+                RowSum[s] = Sum;
+            } else {
+                const float Correction = std::exp(RowMaximum[s] - Maximum);
+                RowSum[s] = RowSum[s] * Correction + Sum;
+                if (Correction != 1.0f) {
+                    float* AccumulatorRow = Accumulators + s * VHeadSize;
+                    for (size_t i = 0; i < VHeadSize; i++) {
+                        AccumulatorRow[i] *= Correction;
+                    }
+                }
+            }
+
+            RowMaximum[s] = Maximum;
+        }
+
+        MlasGemm(CblasNoTrans, CblasNoTrans, CountS, VHeadSize, CountT,
+                 1.0f, Scores, MLAS_FLASH_ATTENTION_BLOCK_T, Value + t * VHeadSize, VHeadSize,
+                 (t == 0) ? 0.0f : 1.0f, Accumulators, VHeadSize, nullptr);
+    }
+
+    //
+    // Normalize and store the output rows, which are interleaved by head.
+    //
+
+    for (size_t s = 0; s < CountS; s++) {
+
+        float* Output = Params->Output + ((BatchIdx * S + StartS + s) * N + HeadIdx) * VHeadSize;
+
+        if (EndT == 0) {
+            std::fill_n(Output, VHeadSize, 0.0f);
+            continue;
+        }
+
+        const float* AccumulatorRow = Accumulators + s * VHeadSize;
+        const float Reciprocal = 1.0f / RowSum[s];
+
+        for (size_t i = 0; i < VHeadSize; i++) {
+            Output[i] = AccumulatorRow[i] * Reciprocal;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasFlashAttention(
+    const MLAS_FLASH_ATTENTION_PARAMS* Params,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine computes attention for every batch and head, see
+    MLAS_FLASH_ATTENTION_PARAMS.
+
+Arguments:
+
+    Params - Supplies the parameters of the operation.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t S = Params->SequenceLength;
+
+    if (Params->KvSequenceLength < S) {
+        MLAS_THROW_EX(std::invalid_argument, "Key sequence length of attention is shorter than the query");
+    }
+
+    if (Params->KvBufferSequenceLength != 0 && Params->KvBufferSequenceLength < Params->KvSequenceLength) {
+        MLAS_THROW_EX(std::invalid_argument, "Key buffer of attention is shorter than the key sequence");
+    }
+
+    const size_t TileCountS = MlasDivRoundup(S, MLAS_FLASH_ATTENTION_TILE_S);
+    const size_t TileCount = Params->BatchSize * Params->NumHeads * TileCountS;
+
+    if (TileCount == 0) {
+        return;
+    }
+
+    //
+    // Assign contiguous ranges of tiles to threads, so that a thread visits
+    // the keys of a head once for all its tiles as long as possible.
+    //
+
+    const double Complexity = double(S) * double(Params->KvSequenceLength) *
+                              double(Params->QkHeadSize + Params->VHeadSize) *
+                              double(Params->BatchSize * Params->NumHeads);
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+    if (size_t(TargetThreadCount) > TileCount) {
+        TargetThreadCount = ptrdiff_t(TileCount);
+    }
+
+    const size_t VHeadSize = Params->VHeadSize;
+
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+
+        size_t StartTile;
+        size_t CountTile;
+
+        MlasPartitionWork(tid, TargetThreadCount, TileCount, &StartTile, &CountTile);
+
+        constexpr size_t ScoresSize = MLAS_FLASH_ATTENTION_TILE_S * MLAS_FLASH_ATTENTION_BLOCK_T;
+        const size_t AccumulatorsSize = MLAS_FLASH_ATTENTION_TILE_S * VHeadSize;
+
+        MlasThreadedBufAlloc((ScoresSize + AccumulatorsSize + 2 * MLAS_FLASH_ATTENTION_TILE_S) * sizeof(float));
+        float* Scores = reinterpret_cast<float*>(ThreadedBufHolder.get());
+        float* Accumulators = Scores + ScoresSize;
+        float* RowMaximum = Accumulators + AccumulatorsSize;
+        float* RowSum = RowMaximum + MLAS_FLASH_ATTENTION_TILE_S;
+
+        for (size_t tile = StartTile; tile < StartTile + CountTile; tile++) {
+
+            const size_t HeadOffset = tile / TileCountS;
+            const size_t StartS = (tile % TileCountS) * MLAS_FLASH_ATTENTION_TILE_S;
+            const size_t CountS = std::min(S - StartS, MLAS_FLASH_ATTENTION_TILE_S);
+
+            std::fill_n(RowMaximum, CountS, std::numeric_limits<float>::lowest());
+
+            MlasFlashAttentionTile(Params, HeadOffset / Params->NumHeads, HeadOffset % Params->NumHeads,
+                                   StartS, CountS, Scores, Accumulators, RowMaximum, RowSum);
+        }
+    });
+}
@@ -25,8 +25,10 @@ Abstract:
 bool MLASCALL
 MlasFp16AccelerationSupported()
 {
-#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
+#if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED)
     return MLAS_CPUIDINFO::GetCPUIDInfo().HasFp16VectorAcceleration();
+#elif defined(MLAS_TARGET_AMD64)
+    return GetMlasPlatform().HalfGemmDispatch != nullptr;
 #else
     return false;
 #endif
@@ -77,6 +79,12 @@ MlasHalfGemmBatch(
 
     const size_t StrideM = dispatch->StrideM;
 
+    //
+    // Partition N along the boundaries of the packed B panels.
+    //
+
+    const size_t StrideNAlign = std::max<size_t>(MLAS_QGEMM_STRIDEN_THREAD_ALIGN, dispatch->PackedN);
+
     size_t nc = N;
     if ((size_t)MlasGetMaximumThreadCount(ThreadPool) > BatchN) {
         // more than one thread per GEMM
@@ -84,8 +92,7 @@ MlasHalfGemmBatch(
         const size_t BlockedM = MlasDivRoundup(M, StrideM);
         const size_t max_nc = MlasDivRoundup(N * BlockedM, ThreadsPerGemm);
         if (max_nc < nc) {
-            nc = std::min(nc, MlasDivRoundup(nc, max_nc * MLAS_QGEMM_STRIDEN_THREAD_ALIGN) *
-                                  MLAS_QGEMM_STRIDEN_THREAD_ALIGN);
+            nc = std::min(nc, MlasDivRoundup(nc, max_nc * StrideNAlign) * StrideNAlign);
         }
     }
     const size_t StrideN = nc;
@@ -124,12 +131,14 @@ MlasHalfGemmPackBSize(
     const auto* dispatch = MlasHalfGemmGetDispatch();
     const auto padding = dispatch->BufOverRead;
     const auto PackedK = dispatch->PackededK;
+    const auto PackedN = dispatch->PackedN;
     if (!float2half && dispatch->CopyPackBRoutine == nullptr) {
         // No packing routine provided
         return 0;
     }
     const size_t AlignedK = (K + PackedK - 1) & ~(PackedK - 1);
-    const size_t BytesRequired = N * AlignedK * FP16_SIZE + padding;
+    const size_t AlignedN = MlasDivRoundup(N, PackedN) * PackedN;
+    const size_t BytesRequired = AlignedN * AlignedK * FP16_SIZE + padding;
     const size_t BufferAlignment = MlasGetPreferredBufferAlignment();
     const size_t AlignedBytesRequired =
         (BytesRequired + BufferAlignment - 1) & ~(BufferAlignment - 1);
@@ -244,6 +253,7 @@ struct MLAS_HALF_GEMM_KERNEL_DEFAULT {
     static constexpr bool PackNeeded = false;
     static constexpr size_t KernelMaxM = 128; // max # rows the vectorized kernel can process
     static constexpr size_t PackedK = 1;
+    static constexpr size_t PackedN = 1;
 
     static constexpr MLAS_HALF_GEMM_STRIDES Strides{8, 16, 32};
 };
@@ -330,6 +340,7 @@ const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchDefault = {
     nullptr,
     MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_DEFAULT>,
     MLAS_HALF_GEMM_KERNEL_DEFAULT::PackedK,
+    MLAS_HALF_GEMM_KERNEL_DEFAULT::PackedN,
     MLAS_HALF_GEMM_KERNEL_DEFAULT::KernelMaxM,
     0
 };
@@ -28,6 +28,11 @@ Abstract:
         size_t KernelMaxM;       Max # rows the vectorized kernel can process
         size_t PackedK;          Packed alignment on the K dim (power of 2)
         MLAS_HALF_GEMM_STRIDES Strides{128, 128, 128};
+
+    A kernel that packs B into panels of columns should also define
+        size_t PackedN;          # columns of a packed B panel
+    and report it in its dispatch structure, so that the packing buffer is
+    padded to whole panels and the threads partition N along panel boundaries.
 --*/
 
 #pragma once
@@ -493,6 +498,7 @@ struct MLAS_HALFGEMM_DISPATCH {
     MLAS_HALFGEMM_COPYPACKB_ROUTINE* CopyPackBRoutine;  /**< Pack function for B */
     MLAS_HALFGEMM_CONVERTPACKB_ROUTINE* ConvertPackBRoutine; /**< Convert and pack function for B */
     size_t PackededK;
+    size_t PackedN;   /**< Width of the packed B panels, 1 if B is not packed into panels */
     size_t StrideM;
     size_t BufOverRead;
 };
@@ -509,6 +515,9 @@ MlasHalfGemmGetDispatch()
 {
 #if defined(MLAS_F16VEC_INTRINSICS_SUPPORTED) && defined(MLAS_TARGET_ARM64)
     return &MlasHalfGemmDispatchNeon;
+#elif defined(MLAS_TARGET_AMD64)
+    const MLAS_HALFGEMM_DISPATCH* dispatch = GetMlasPlatform().HalfGemmDispatch;
+    return dispatch != nullptr ? dispatch : &MlasHalfGemmDispatchDefault;
 #else
     return &MlasHalfGemmDispatchDefault;
 #endif
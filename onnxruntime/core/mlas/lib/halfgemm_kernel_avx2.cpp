@@ -0,0 +1,446 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements half precision GEMM kernel for AVX2/FMA3 with F16C.
+
+    There is no fp16 arithmetic on these processors, so the kernel converts the
+    fp16 operands to fp32 with F16C and accumulates in fp32. Matrix B is packed
+    into panels of 16 columns, so that each row of a panel is converted to two
+    fp32 vectors with two loads.
+
+--*/
+
+#include "mlasi.h"
+#include "halfgemm.h"
+
+struct MLAS_HALF_GEMM_KERNEL_AVX2 {
+    static constexpr bool PackNeeded = true;
+    static constexpr size_t KernelMaxM = 6;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 1;
+    static constexpr size_t PackedN = 16;  // # columns of a packed B panel
+
+    static constexpr MLAS_HALF_GEMM_STRIDES Strides{24, 128, 512};
+};
+
+
+MLAS_FORCEINLINE
+void
+CvtFloat2Half(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t len
+    )
+{
+    while (len >= 8) {
+        __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(src), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), half);
+        src += 8;
+        dest += 8;
+        len -= 8;
+    }
+
+    if (len > 0) {
+        MLAS_DECLSPEC_ALIGN(float buf[8], 32) = {};
+        MLAS_DECLSPEC_ALIGN(_mlas_fp16_ res[8], 16);
+        std::memcpy(buf, src, len * sizeof(float));
+        __m128i half = _mm256_cvtps_ph(_mm256_load_ps(buf), _MM_FROUND_TO_NEAREST_INT);
+        _mm_store_si128(reinterpret_cast<__m128i*>(res), half);
+        std::memcpy(dest, res, len * FP16_SIZE);
+    }
+}
+
+/**
+ * @brief Load up to 16 fp16 values and convert them to two fp32 vectors,
+ *        the values beyond len are zero.
+*/
+MLAS_FORCEINLINE
+void
+LoadHalf16(
+    const _mlas_fp16_* src,
+    size_t len,
+    __m256& lo,
+    __m256& hi
+    )
+{
+    if (len == 16) {
+        lo = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)));
+        hi = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 8)));
+        return;
+    }
+
+    MLAS_DECLSPEC_ALIGN(_mlas_fp16_ buf[16], 32) = {};
+    std::memcpy(buf, src, len * FP16_SIZE);
+    lo = _mm256_cvtph_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(buf)));
+    hi = _mm256_cvtph_ps(_mm_load_si128(reinterpret_cast<const __m128i*>(buf + 8)));
+}
+
+/**
+ * @brief Convert two fp32 vectors to fp16 and store the first len values
+*/
+MLAS_FORCEINLINE
+void
+StoreHalf16(
+    _mlas_fp16_* dest,
+    size_t len,
+    __m256 lo,
+    __m256 hi
+    )
+{
+    __m128i half_lo = _mm256_cvtps_ph(lo, _MM_FROUND_TO_NEAREST_INT);
+    __m128i half_hi = _mm256_cvtps_ph(hi, _MM_FROUND_TO_NEAREST_INT);
+
+    if (len == 16) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), half_lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 8), half_hi);
+        return;
+    }
+
+    MLAS_DECLSPEC_ALIGN(_mlas_fp16_ buf[16], 32);
+    _mm_store_si128(reinterpret_cast<__m128i*>(buf), half_lo);
+    _mm_store_si128(reinterpret_cast<__m128i*>(buf + 8), half_hi);
+    std::memcpy(dest, buf, len * FP16_SIZE);
+}
+
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmCopyPackB<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    _mlas_fp16_* D,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+)
+{
+    constexpr size_t PackedN = MLAS_HALF_GEMM_KERNEL_AVX2::PackedN;
+
+    for (size_t n = 0; n < CountN; n += PackedN) {
+        const size_t cols = std::min(CountN - n, PackedN);
+        const _mlas_fp16_* b = B + n;
+
+        for (size_t k = 0; k < CountK; k++) {
+            if (cols == PackedN) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(D),
+                                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)));
+            } else {
+                std::memcpy(D, b, cols * FP16_SIZE);
+                std::memset(D + cols, 0, (PackedN - cols) * FP16_SIZE);
+            }
+            D += PackedN;
+            b += ldb;
+        }
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackA<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    _mlas_fp16_* D,
+    const float* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK
+)
+{
+    for (size_t m = 0; m < CountM; m++) {
+        CvtFloat2Half(D, A, CountK);
+        A += lda;
+        D += CountK;
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    _mlas_fp16_* D,
+    const float* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+)
+{
+    constexpr size_t PackedN = MLAS_HALF_GEMM_KERNEL_AVX2::PackedN;
+
+    for (size_t n = 0; n < CountN; n += PackedN) {
+        const size_t cols = std::min(CountN - n, PackedN);
+        const float* b = B + n;
+
+        for (size_t k = 0; k < CountK; k++) {
+            CvtFloat2Half(D, b, cols);
+            if (cols < PackedN) {
+                std::memset(D + cols, 0, (PackedN - cols) * FP16_SIZE);
+            }
+            D += PackedN;
+            b += ldb;
+        }
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+const _mlas_fp16_*
+MlasHalfGemmPackedBOffset<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    const _mlas_fp16_* PackedB,
+    size_t DimN,
+    size_t DimK,
+    size_t StartN,
+    size_t StartK)
+{
+    // Packed B is a sequence of panels of PackedN columns by DimK rows,
+    // StartN is always aligned to the panel width.
+    MLAS_UNREFERENCED_PARAMETER(DimN);
+    constexpr size_t PackedN = MLAS_HALF_GEMM_KERNEL_AVX2::PackedN;
+    return PackedB + StartN * DimK + StartK * PackedN;
+}
+
+template<>
+MLAS_FORCEINLINE
+size_t
+MlasHalfGemmPackedBLeadingDim<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    size_t DimN,
+    size_t DimK)
+{
+    // Distance between two adjacent panels
+    MLAS_UNREFERENCED_PARAMETER(DimN);
+    return DimK * MLAS_HALF_GEMM_KERNEL_AVX2::PackedN;
+}
+
+
+//
+// Templates used with loop unrolling to perform an action on one row of the
+// output, so that the accumulators stay in registers.
+//
+
+constexpr size_t MlasHalfGemmAvx2BlockK = 8;
+
+struct MlasHalfGemmAvx2ZeroRow
+{
+    template<size_t RowCount, size_t Row>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iteration(
+        __m256 Accumulators[RowCount][2]
+        )
+    {
+        Accumulators[Row][0] = _mm256_setzero_ps();
+        Accumulators[Row][1] = _mm256_setzero_ps();
+    }
+};
+
+struct MlasHalfGemmAvx2ConvertARow
+{
+    template<size_t RowCount, size_t Row>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iteration(
+        float ABlock[RowCount][MlasHalfGemmAvx2BlockK],
+        const _mlas_fp16_* A,
+        size_t lda,
+        size_t CountBlockK
+        )
+    {
+        const _mlas_fp16_* a = A + Row * lda;
+        __m128i half;
+        if (CountBlockK == MlasHalfGemmAvx2BlockK) {
+            half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a));
+        } else {
+            MLAS_DECLSPEC_ALIGN(_mlas_fp16_ buf[MlasHalfGemmAvx2BlockK], 16) = {};
+            std::memcpy(buf, a, CountBlockK * FP16_SIZE);
+            half = _mm_load_si128(reinterpret_cast<const __m128i*>(buf));
+        }
+        _mm256_store_ps(ABlock[Row], _mm256_cvtph_ps(half));
+    }
+};
+
+struct MlasHalfGemmAvx2MultiplyAddRow
+{
+    template<size_t RowCount, size_t Row>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iteration(
+        __m256 Accumulators[RowCount][2],
+        const float ABlock[RowCount][MlasHalfGemmAvx2BlockK],
+        size_t kk,
+        __m256 b0,
+        __m256 b1
+        )
+    {
+        __m256 a = _mm256_broadcast_ss(&ABlock[Row][kk]);
+        Accumulators[Row][0] = _mm256_fmadd_ps(a, b0, Accumulators[Row][0]);
+        Accumulators[Row][1] = _mm256_fmadd_ps(a, b1, Accumulators[Row][1]);
+    }
+};
+
+struct MlasHalfGemmAvx2AddBiasRow
+{
+    template<size_t RowCount, size_t Row>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iteration(
+        __m256 Accumulators[RowCount][2],
+        __m256 BiasLo,
+        __m256 BiasHi
+        )
+    {
+        Accumulators[Row][0] = _mm256_add_ps(Accumulators[Row][0], BiasLo);
+        Accumulators[Row][1] = _mm256_add_ps(Accumulators[Row][1], BiasHi);
+    }
+};
+
+struct MlasHalfGemmAvx2StoreRow
+{
+    template<size_t RowCount, size_t Row>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iteration(
+        __m256 Accumulators[RowCount][2],
+        _mlas_fp16_* C,
+        size_t ldc,
+        size_t cols,
+        bool ZeroMode
+        )
+    {
+        _mlas_fp16_* c = C + Row * ldc;
+        if (!ZeroMode) {
+            __m256 CLo, CHi;
+            LoadHalf16(c, cols, CLo, CHi);
+            Accumulators[Row][0] = _mm256_add_ps(Accumulators[Row][0], CLo);
+            Accumulators[Row][1] = _mm256_add_ps(Accumulators[Row][1], CHi);
+        }
+        StoreHalf16(c, cols, Accumulators[Row][0], Accumulators[Row][1]);
+    }
+};
+
+/**
+ * @brief Compute RowCount rows of the result, 16 columns at a time
+ *
+ * @param B     Address of the first panel of packed B
+ * @param ldb   Distance between two adjacent panels of packed B
+*/
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernelAvx2Rows(
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode)
+{
+    constexpr size_t PackedN = MLAS_HALF_GEMM_KERNEL_AVX2::PackedN;
+    constexpr size_t BlockK = MlasHalfGemmAvx2BlockK;
+
+    for (size_t n = 0; n < CountN; n += PackedN) {
+
+        __m256 Accumulators[RowCount][2];
+        MlasLoopUnroll<RowCount, MlasHalfGemmAvx2ZeroRow>()(Accumulators);
+
+        const _mlas_fp16_* b = B;
+
+        for (size_t k = 0; k < CountK; k += BlockK) {
+
+            //
+            // Convert a block of each row of A to fp32 so that each element
+            // can be broadcast with a single load.
+            //
+
+            const size_t CountBlockK = std::min(CountK - k, BlockK);
+            MLAS_DECLSPEC_ALIGN(float ABlock[RowCount][BlockK], 32);
+            MlasLoopUnroll<RowCount, MlasHalfGemmAvx2ConvertARow>()(ABlock, A + k, lda, CountBlockK);
+
+            for (size_t kk = 0; kk < CountBlockK; kk++) {
+                __m256 b0 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b)));
+                __m256 b1 = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(b + 8)));
+                MlasLoopUnroll<RowCount, MlasHalfGemmAvx2MultiplyAddRow>()(Accumulators, ABlock, kk, b0, b1);
+                b += PackedN;
+            }
+        }
+
+        //
+        // Add the bias or the existing output, and store the result.
+        //
+
+        const size_t cols = std::min(CountN - n, PackedN);
+
+        if (Bias != nullptr) {
+            __m256 BiasLo, BiasHi;
+            LoadHalf16(Bias + n, cols, BiasLo, BiasHi);
+            MlasLoopUnroll<RowCount, MlasHalfGemmAvx2AddBiasRow>()(Accumulators, BiasLo, BiasHi);
+        }
+
+        MlasLoopUnroll<RowCount, MlasHalfGemmAvx2StoreRow>()(Accumulators, C + n, ldc, cols, ZeroMode);
+
+        B += ldb;
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernel<MLAS_HALF_GEMM_KERNEL_AVX2>(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode)
+{
+    switch (std::min(CountM, MLAS_HALF_GEMM_KERNEL_AVX2::KernelMaxM)) {
+        case 1:
+            MlasHalfGemmKernelAvx2Rows<1>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 2:
+            MlasHalfGemmKernelAvx2Rows<2>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 3:
+            MlasHalfGemmKernelAvx2Rows<3>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 4:
+            MlasHalfGemmKernelAvx2Rows<4>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 5:
+            MlasHalfGemmKernelAvx2Rows<5>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        default:
+            MlasHalfGemmKernelAvx2Rows<6>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+    }
+}
+
+
+const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx2 = {
+    MlasHalfGemmOperation<MLAS_HALF_GEMM_KERNEL_AVX2>,
+    MlasHalfGemmCopyPackB<MLAS_HALF_GEMM_KERNEL_AVX2>,
+    MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX2>,
+    MLAS_HALF_GEMM_KERNEL_AVX2::PackedK,
+    MLAS_HALF_GEMM_KERNEL_AVX2::PackedN,
+    MLAS_HALF_GEMM_KERNEL_AVX2::KernelMaxM,
+    0
+};
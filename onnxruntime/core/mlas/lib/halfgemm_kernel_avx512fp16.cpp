@@ -0,0 +1,402 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    halfgemm_kernel_avx512fp16.cpp
+
+Abstract:
+
+    This module implements half precision GEMM kernel for AVX512-FP16.
+
+    Like the NEON kernel, this kernel multiplies and accumulates in fp16.
+    Matrix B is packed into panels of 32 columns, one ZMM register per
+    panel row.
+
+--*/
+
+#include "mlasi.h"
+#include "halfgemm.h"
+
+struct MLAS_HALF_GEMM_KERNEL_AVX512FP16 {
+    static constexpr bool PackNeeded = true;
+    static constexpr size_t KernelMaxM = 8;  // max # rows the vectorized kernel can process
+    static constexpr size_t PackedK = 1;
+    static constexpr size_t PackedN = 32;  // # columns of a packed B panel
+
+    static constexpr MLAS_HALF_GEMM_STRIDES Strides{32, 128, 512};
+};
+
+
+MLAS_FORCEINLINE
+__mmask32
+MlasHalfGemmColumnMask(
+    size_t len
+    )
+{
+    return (len >= 32) ? __mmask32(0xFFFFFFFF) : __mmask32((1u << len) - 1);
+}
+
+MLAS_FORCEINLINE
+void
+CvtFloat2Half(
+    _mlas_fp16_* dest,
+    const float* src,
+    size_t len
+    )
+{
+    while (len >= 16) {
+        __m256i half = _mm512_cvtps_ph(_mm512_loadu_ps(src), _MM_FROUND_TO_NEAREST_INT);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest), half);
+        src += 16;
+        dest += 16;
+        len -= 16;
+    }
+
+    if (len > 0) {
+        const __mmask16 mask = __mmask16((1u << len) - 1);
+        __m256i half = _mm512_cvtps_ph(_mm512_maskz_loadu_ps(mask, src), _MM_FROUND_TO_NEAREST_INT);
+        _mm256_mask_storeu_epi16(dest, mask, half);
+    }
+}
+
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmCopyPackB<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    _mlas_fp16_* D,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+)
+{
+    constexpr size_t PackedN = MLAS_HALF_GEMM_KERNEL_AVX512FP16::PackedN;
+
+    for (size_t n = 0; n < CountN; n += PackedN) {
+        const __mmask32 mask = MlasHalfGemmColumnMask(CountN - n);
+        const _mlas_fp16_* b = B + n;
+
+        for (size_t k = 0; k < CountK; k++) {
+            _mm512_storeu_si512(D, _mm512_maskz_loadu_epi16(mask, b));
+            D += PackedN;
+            b += ldb;
+        }
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackA<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    _mlas_fp16_* D,
+    const float* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK
+)
+{
+    for (size_t m = 0; m < CountM; m++) {
+        CvtFloat2Half(D, A, CountK);
+        A += lda;
+        D += CountK;
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    _mlas_fp16_* D,
+    const float* B,
+    size_t ldb,
+    size_t CountN,
+    size_t CountK
+)
+{
+    constexpr size_t PackedN = MLAS_HALF_GEMM_KERNEL_AVX512FP16::PackedN;
+
+    for (size_t n = 0; n < CountN; n += PackedN) {
+        const size_t cols = std::min(CountN - n, PackedN);
+        const float* b = B + n;
+
+        for (size_t k = 0; k < CountK; k++) {
+            if (cols < PackedN) {
+                _mm512_storeu_si512(D, _mm512_setzero_si512());
+            }
+            CvtFloat2Half(D, b, cols);
+            D += PackedN;
+            b += ldb;
+        }
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+const _mlas_fp16_*
+MlasHalfGemmPackedBOffset<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    const _mlas_fp16_* PackedB,
+    size_t DimN,
+    size_t DimK,
+    size_t StartN,
+    size_t StartK)
+{
+    // Packed B is a sequence of panels of PackedN columns by DimK rows,
+    // StartN is always aligned to the panel width.
+    MLAS_UNREFERENCED_PARAMETER(DimN);
+    constexpr size_t PackedN = MLAS_HALF_GEMM_KERNEL_AVX512FP16::PackedN;
+    return PackedB + StartN * DimK + StartK * PackedN;
+}
+
+template<>
+MLAS_FORCEINLINE
+size_t
+MlasHalfGemmPackedBLeadingDim<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    size_t DimN,
+    size_t DimK)
+{
+    // Distance between two adjacent panels
+    MLAS_UNREFERENCED_PARAMETER(DimN);
+    return DimK * MLAS_HALF_GEMM_KERNEL_AVX512FP16::PackedN;
+}
+
+
+//
+// Templates used with loop unrolling to perform an action on one row of the
+// output, so that the accumulators stay in registers.
+//
+
+template<size_t PanelCount>
+struct MlasHalfGemmAvx512Fp16InitRow
+{
+    template<size_t RowCount, size_t Row>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iteration(
+        __m512h Accumulators[RowCount][PanelCount],
+        const __m512h BiasVectors[PanelCount],
+        const __mmask32 Masks[PanelCount],
+        const _mlas_fp16_* C,
+        size_t ldc,
+        bool ZeroMode
+        )
+    {
+        constexpr size_t PackedN = MLAS_HALF_GEMM_KERNEL_AVX512FP16::PackedN;
+
+        Accumulators[Row][0] = BiasVectors[0];
+        if constexpr (PanelCount > 1) {
+            Accumulators[Row][1] = BiasVectors[1];
+        }
+
+        if (!ZeroMode) {
+            const _mlas_fp16_* c = C + Row * ldc;
+            Accumulators[Row][0] = _mm512_add_ph(Accumulators[Row][0],
+                _mm512_castsi512_ph(_mm512_maskz_loadu_epi16(Masks[0], c)));
+            if constexpr (PanelCount > 1) {
+                Accumulators[Row][1] = _mm512_add_ph(Accumulators[Row][1],
+                    _mm512_castsi512_ph(_mm512_maskz_loadu_epi16(Masks[1], c + PackedN)));
+            }
+        }
+    }
+};
+
+template<size_t PanelCount>
+struct MlasHalfGemmAvx512Fp16MultiplyAddRow
+{
+    template<size_t RowCount, size_t Row>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iteration(
+        __m512h Accumulators[RowCount][PanelCount],
+        const __m512h BElements[PanelCount],
+        const _mlas_fp16_* A,
+        size_t lda
+        )
+    {
+        __m512h AElement = _mm512_set1_ph(reinterpret_cast<const _Float16*>(A)[Row * lda]);
+        Accumulators[Row][0] = _mm512_fmadd_ph(AElement, BElements[0], Accumulators[Row][0]);
+        if constexpr (PanelCount > 1) {
+            Accumulators[Row][1] = _mm512_fmadd_ph(AElement, BElements[1], Accumulators[Row][1]);
+        }
+    }
+};
+
+template<size_t PanelCount>
+struct MlasHalfGemmAvx512Fp16StoreRow
+{
+    template<size_t RowCount, size_t Row>
+    MLAS_FORCEINLINE
+    static
+    void
+    Iteration(
+        __m512h Accumulators[RowCount][PanelCount],
+        const __mmask32 Masks[PanelCount],
+        _mlas_fp16_* C,
+        size_t ldc
+        )
+    {
+        constexpr size_t PackedN = MLAS_HALF_GEMM_KERNEL_AVX512FP16::PackedN;
+
+        _mlas_fp16_* c = C + Row * ldc;
+        _mm512_mask_storeu_epi16(c, Masks[0], _mm512_castph_si512(Accumulators[Row][0]));
+        if constexpr (PanelCount > 1) {
+            _mm512_mask_storeu_epi16(c + PackedN, Masks[1], _mm512_castph_si512(Accumulators[Row][1]));
+        }
+    }
+};
+
+/**
+ * @brief Compute RowCount rows by PanelCount (1 or 2) panels of the result
+ *
+ * @param B     Address of the first panel of packed B
+ * @param ldb   Distance between two adjacent panels of packed B
+*/
+template<size_t RowCount, size_t PanelCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernelAvx512Fp16Block(
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode)
+{
+    static_assert(PanelCount == 1 || PanelCount == 2, "unsupported panel count");
+    constexpr size_t PackedN = MLAS_HALF_GEMM_KERNEL_AVX512FP16::PackedN;
+
+    __mmask32 Masks[PanelCount];
+    __m512h BiasVectors[PanelCount];
+    for (size_t p = 0; p < PanelCount; p++) {
+        Masks[p] = MlasHalfGemmColumnMask(CountN - p * PackedN);
+        BiasVectors[p] = (Bias == nullptr)
+            ? _mm512_setzero_ph()
+            : _mm512_castsi512_ph(_mm512_maskz_loadu_epi16(Masks[p], Bias + p * PackedN));
+    }
+
+    //
+    // Start from the bias or the existing output.
+    //
+
+    __m512h Accumulators[RowCount][PanelCount];
+    MlasLoopUnroll<RowCount, MlasHalfGemmAvx512Fp16InitRow<PanelCount>>()(
+        Accumulators, BiasVectors, Masks, C, ldc, ZeroMode);
+
+    for (size_t k = 0; k < CountK; k++) {
+        __m512h BElements[PanelCount];
+        BElements[0] = _mm512_loadu_ph(B + k * PackedN);
+        if constexpr (PanelCount > 1) {
+            BElements[1] = _mm512_loadu_ph(B + ldb + k * PackedN);
+        }
+
+        MlasLoopUnroll<RowCount, MlasHalfGemmAvx512Fp16MultiplyAddRow<PanelCount>>()(
+            Accumulators, BElements, A + k, lda);
+    }
+
+    MlasLoopUnroll<RowCount, MlasHalfGemmAvx512Fp16StoreRow<PanelCount>>()(Accumulators, Masks, C, ldc);
+}
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernelAvx512Fp16Rows(
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode)
+{
+    constexpr size_t PackedN = MLAS_HALF_GEMM_KERNEL_AVX512FP16::PackedN;
+
+    //
+    // Process two panels at a time so that each broadcast of A is used by
+    // two multiplies.
+    //
+
+    while (CountN > PackedN) {
+        MlasHalfGemmKernelAvx512Fp16Block<RowCount, 2>(
+            CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+
+        CountN -= std::min(CountN, 2 * PackedN);
+        C += 2 * PackedN;
+        if (Bias != nullptr) {
+            Bias += 2 * PackedN;
+        }
+        B += 2 * ldb;
+    }
+
+    if (CountN > 0) {
+        MlasHalfGemmKernelAvx512Fp16Block<RowCount, 1>(
+            CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+    }
+}
+
+template<>
+MLAS_FORCEINLINE
+void
+MlasHalfGemmKernel<MLAS_HALF_GEMM_KERNEL_AVX512FP16>(
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    _mlas_fp16_* C,
+    size_t ldc,
+    const _mlas_fp16_* Bias,
+    const _mlas_fp16_* A,
+    size_t lda,
+    const _mlas_fp16_* B,
+    size_t ldb,
+    const bool ZeroMode)
+{
+    switch (std::min(CountM, MLAS_HALF_GEMM_KERNEL_AVX512FP16::KernelMaxM)) {
+        case 1:
+            MlasHalfGemmKernelAvx512Fp16Rows<1>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 2:
+            MlasHalfGemmKernelAvx512Fp16Rows<2>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 3:
+            MlasHalfGemmKernelAvx512Fp16Rows<3>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 4:
+            MlasHalfGemmKernelAvx512Fp16Rows<4>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 5:
+            MlasHalfGemmKernelAvx512Fp16Rows<5>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 6:
+            MlasHalfGemmKernelAvx512Fp16Rows<6>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        case 7:
+            MlasHalfGemmKernelAvx512Fp16Rows<7>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+        default:
+            MlasHalfGemmKernelAvx512Fp16Rows<8>(CountN, CountK, C, ldc, Bias, A, lda, B, ldb, ZeroMode);
+            break;
+    }
+}
+
+
+const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx512Fp16 = {
+    MlasHalfGemmOperation<MLAS_HALF_GEMM_KERNEL_AVX512FP16>,
+    MlasHalfGemmCopyPackB<MLAS_HALF_GEMM_KERNEL_AVX512FP16>,
+    MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_AVX512FP16>,
+    MLAS_HALF_GEMM_KERNEL_AVX512FP16::PackedK,
+    MLAS_HALF_GEMM_KERNEL_AVX512FP16::PackedN,
+    MLAS_HALF_GEMM_KERNEL_AVX512FP16::KernelMaxM,
+    0
+};
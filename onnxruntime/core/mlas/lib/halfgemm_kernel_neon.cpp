@@ -50,6 +50,7 @@ struct MLAS_HALF_GEMM_KERNEL_NEON {
     static constexpr bool PackNeeded = false;
     static constexpr size_t KernelMaxM = 6;  // max # rows the vectorized kernel can process
     static constexpr size_t PackedK = 1;
+    static constexpr size_t PackedN = 1;
 
     static constexpr MLAS_HALF_GEMM_STRIDES Strides{24, 128, 512};
 };
@@ -182,6 +183,7 @@ const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchNeon = {
     nullptr,
     MlasHalfGemmConvertPackB<MLAS_HALF_GEMM_KERNEL_NEON>,
     MLAS_HALF_GEMM_KERNEL_NEON::PackedK,
+    MLAS_HALF_GEMM_KERNEL_NEON::PackedN,
     MLAS_HALF_GEMM_KERNEL_NEON::KernelMaxM,
     32 // kernel may read beyond buffer end by 32 bytes
 };
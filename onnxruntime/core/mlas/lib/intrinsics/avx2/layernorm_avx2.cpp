@@ -0,0 +1,280 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_avx2.cpp
+
+Abstract:
+
+    This module implements the layer normalization kernel using AVX2 and FMA3
+    intrinsics. See layernorm.cpp for a description of the two passes.
+
+--*/
+
+#include "../../mlasi.h"
+
+//
+// Table to build the mask of the partial vector at the end of a row.
+//
+
+MLAS_DECLSPEC_ALIGN(static const int32_t MlasLayerNormMaskTableAvx2[16], 32) = {
+    -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+MLAS_FORCEINLINE
+float
+MlasLayerNormReduceAddAvx2(
+    __m256 Vector
+    )
+{
+    __m128 Vector128 = _mm_add_ps(_mm256_castps256_ps128(Vector), _mm256_extractf128_ps(Vector, 1));
+    Vector128 = _mm_add_ps(Vector128, _mm_movehl_ps(Vector128, Vector128));
+    Vector128 = _mm_add_ss(Vector128, _mm_movehdup_ps(Vector128));
+    return _mm_cvtss_f32(Vector128);
+}
+
+template <bool HasSkip, bool HasBias, bool HasStaged>
+MLAS_FORCEINLINE
+__m256
+MlasLayerNormLoadAvx2(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    float* Staged
+    )
+{
+    __m256 Vector = _mm256_loadu_ps(Input);
+
+    if (HasSkip) {
+        Vector = _mm256_add_ps(Vector, _mm256_loadu_ps(Skip));
+    }
+
+    if (HasBias) {
+        Vector = _mm256_add_ps(Vector, _mm256_loadu_ps(Bias));
+    }
+
+    if (HasStaged) {
+        _mm256_storeu_ps(Staged, Vector);
+    }
+
+    return Vector;
+}
+
+template <bool HasSkip, bool HasBias, bool HasStaged>
+MLAS_FORCEINLINE
+__m256
+MlasLayerNormMaskLoadAvx2(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    float* Staged,
+    __m256i Mask
+    )
+{
+    __m256 Vector = _mm256_maskload_ps(Input, Mask);
+
+    if (HasSkip) {
+        Vector = _mm256_add_ps(Vector, _mm256_maskload_ps(Skip, Mask));
+    }
+
+    if (HasBias) {
+        Vector = _mm256_add_ps(Vector, _mm256_maskload_ps(Bias, Mask));
+    }
+
+    if (HasStaged) {
+        _mm256_maskstore_ps(Staged, Mask, Vector);
+    }
+
+    return Vector;
+}
+
+template <bool HasSkip, bool HasBias, bool HasStaged, bool HasShift>
+void
+MlasLayerNormRowAvx2(
+    const MLAS_LAYER_NORM_PARAMS<float>* Params,
+    size_t Row
+    )
+{
+    const size_t D = Params->RowSize;
+    const float* Input = Params->Input + Row * D;
+    float* Output = Params->Output + Row * D;
+
+    //
+    // Unused optional inputs alias the input so that offsetting them is valid.
+    //
+
+    const float* Skip = HasSkip ? Params->Skip + Row * D : Input;
+    const float* Bias = HasBias ? Params->Bias : Input;
+    const float* Scale = Params->Scale;
+    const float* Shift = HasShift ? Params->Shift : Input;
+    float* Staged = HasStaged ? MlasLayerNormStagingBuffer(Params, Row) : Output;
+    const float Offset = MlasLayerNormOffset(Params, Row);
+    const __m256 OffsetVector = _mm256_set1_ps(Offset);
+
+    const size_t Remainder = D % 8;
+    const __m256i Mask = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i*>(&MlasLayerNormMaskTableAvx2[8 - Remainder]));
+
+    //
+    // Accumulate the sum and the sum of squares of X.
+    //
+
+    __m256 SumVector0 = _mm256_setzero_ps();
+    __m256 SumVector1 = _mm256_setzero_ps();
+    __m256 SumSquaresVector0 = _mm256_setzero_ps();
+    __m256 SumSquaresVector1 = _mm256_setzero_ps();
+
+    size_t d = 0;
+
+    for (; d + 16 <= D; d += 16) {
+
+        __m256 Vector0 = MlasLayerNormLoadAvx2<HasSkip, HasBias, HasStaged>(
+            Input + d, Skip + d, Bias + d, Staged + d);
+        __m256 Vector1 = MlasLayerNormLoadAvx2<HasSkip, HasBias, HasStaged>(
+            Input + d + 8, Skip + d + 8, Bias + d + 8, Staged + d + 8);
+
+        Vector0 = _mm256_sub_ps(Vector0, OffsetVector);
+        Vector1 = _mm256_sub_ps(Vector1, OffsetVector);
+
+        SumVector0 = _mm256_add_ps(SumVector0, Vector0);
+        SumVector1 = _mm256_add_ps(SumVector1, Vector1);
+        SumSquaresVector0 = _mm256_fmadd_ps(Vector0, Vector0, SumSquaresVector0);
+        SumSquaresVector1 = _mm256_fmadd_ps(Vector1, Vector1, SumSquaresVector1);
+    }
+
+    if (d + 8 <= D) {
+
+        __m256 Vector = MlasLayerNormLoadAvx2<HasSkip, HasBias, HasStaged>(
+            Input + d, Skip + d, Bias + d, Staged + d);
+
+        Vector = _mm256_sub_ps(Vector, OffsetVector);
+
+        SumVector0 = _mm256_add_ps(SumVector0, Vector);
+        SumSquaresVector0 = _mm256_fmadd_ps(Vector, Vector, SumSquaresVector0);
+
+        d += 8;
+    }
+
+    if (Remainder > 0) {
+
+        __m256 Vector = MlasLayerNormMaskLoadAvx2<HasSkip, HasBias, HasStaged>(
+            Input + d, Skip + d, Bias + d, Staged + d, Mask);
+
+        Vector = _mm256_and_ps(_mm256_sub_ps(Vector, OffsetVector), _mm256_castsi256_ps(Mask));
+
+        SumVector1 = _mm256_add_ps(SumVector1, Vector);
+        SumSquaresVector1 = _mm256_fmadd_ps(Vector, Vector, SumSquaresVector1);
+    }
+
+    float Mean;
+    float InvStdDev;
+
+    MlasLayerNormComputeStatistics(Params, Row, Offset,
+                                   MlasLayerNormReduceAddAvx2(_mm256_add_ps(SumVector0, SumVector1)),
+                                   MlasLayerNormReduceAddAvx2(_mm256_add_ps(SumSquaresVector0, SumSquaresVector1)),
+                                   &Mean, &InvStdDev);
+
+    //
+    // Output = X * InvStdDev - Mean * InvStdDev, then scale and shift.
+    //
+
+    const float* X = HasStaged ? Staged : Input;
+
+    const __m256 InvStdDevVector = _mm256_set1_ps(InvStdDev);
+    const __m256 NegativeMeanVector = _mm256_set1_ps(-Mean * InvStdDev);
+
+    d = 0;
+
+    for (; d + 8 <= D; d += 8) {
+
+        __m256 Vector = _mm256_fmadd_ps(_mm256_loadu_ps(X + d), InvStdDevVector, NegativeMeanVector);
+
+        if (HasShift) {
+            Vector = _mm256_fmadd_ps(Vector, _mm256_loadu_ps(Scale + d), _mm256_loadu_ps(Shift + d));
+        } else {
+            Vector = _mm256_mul_ps(Vector, _mm256_loadu_ps(Scale + d));
+        }
+
+        _mm256_storeu_ps(Output + d, Vector);
+    }
+
+    if (Remainder > 0) {
+
+        __m256 Vector = _mm256_fmadd_ps(_mm256_maskload_ps(X + d, Mask), InvStdDevVector, NegativeMeanVector);
+
+        if (HasShift) {
+            Vector = _mm256_fmadd_ps(Vector, _mm256_maskload_ps(Scale + d, Mask), _mm256_maskload_ps(Shift + d, Mask));
+        } else {
+            Vector = _mm256_mul_ps(Vector, _mm256_maskload_ps(Scale + d, Mask));
+        }
+
+        _mm256_maskstore_ps(Output + d, Mask, Vector);
+    }
+}
+
+template <bool HasSkip, bool HasBias, bool HasStaged>
+MLAS_FORCEINLINE
+void
+MlasLayerNormRowsAvx2(
+    const MLAS_LAYER_NORM_PARAMS<float>* Params,
+    size_t StartRow,
+    size_t CountRow
+    )
+{
+    for (size_t Row = StartRow; Row < StartRow + CountRow; Row++) {
+        if (Params->Shift != nullptr) {
+            MlasLayerNormRowAvx2<HasSkip, HasBias, HasStaged, true>(Params, Row);
+        } else {
+            MlasLayerNormRowAvx2<HasSkip, HasBias, HasStaged, false>(Params, Row);
+        }
+    }
+}
+
+void
+MLASCALL
+MlasLayerNormF32KernelAvx2(
+    const MLAS_LAYER_NORM_PARAMS<float>* Params,
+    size_t StartRow,
+    size_t CountRow
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX2 kernel for layer normalization. The
+    optional inputs are resolved once per call, so the inner loops do not
+    test them.
+
+Arguments:
+
+    Params - Supplies the parameters of the operation.
+
+    StartRow - Supplies the index of the first row to process.
+
+    CountRow - Supplies the number of rows to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const bool HasSkip = (Params->Skip != nullptr);
+    const bool HasBias = (Params->Bias != nullptr);
+
+    if (HasSkip && HasBias) {
+        MlasLayerNormRowsAvx2<true, true, true>(Params, StartRow, CountRow);
+    } else if (HasSkip) {
+        MlasLayerNormRowsAvx2<true, false, true>(Params, StartRow, CountRow);
+    } else if (HasBias) {
+        MlasLayerNormRowsAvx2<false, true, true>(Params, StartRow, CountRow);
+    } else if (Params->SkipOutput != nullptr) {
+        MlasLayerNormRowsAvx2<false, false, true>(Params, StartRow, CountRow);
+    } else {
+        MlasLayerNormRowsAvx2<false, false, false>(Params, StartRow, CountRow);
+    }
+}
@@ -0,0 +1,332 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    reduce_avx2.cpp
+
+Abstract:
+
+    This module implements the reduction kernels using AVX2 and FMA3
+    intrinsics. See reduce.cpp for a description of the kernels.
+
+--*/
+
+#include "../../mlasi.h"
+
+//
+// Table to build the mask of the partial vector at the end of a row.
+//
+
+MLAS_DECLSPEC_ALIGN(static const int32_t MlasReduceMaskTableAvx2[16], 32) = {
+    -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+//
+// Reduction operators. Apply folds an input vector into an accumulator and
+// Combine merges two accumulators.
+//
+
+struct MLAS_REDUCTION_SUM_AVX2 {
+
+    static float Identity() { return 0.0f; }
+    static __m256 Apply(__m256 Accumulator, __m256 Vector) { return _mm256_add_ps(Accumulator, Vector); }
+    static __m256 Combine(__m256 Accumulator, __m256 Vector) { return _mm256_add_ps(Accumulator, Vector); }
+    static __m128 Combine(__m128 Accumulator, __m128 Vector) { return _mm_add_ps(Accumulator, Vector); }
+};
+
+struct MLAS_REDUCTION_SUM_SQUARE_AVX2 {
+
+    static float Identity() { return 0.0f; }
+    static __m256 Apply(__m256 Accumulator, __m256 Vector) { return _mm256_fmadd_ps(Vector, Vector, Accumulator); }
+    static __m256 Combine(__m256 Accumulator, __m256 Vector) { return _mm256_add_ps(Accumulator, Vector); }
+    static __m128 Combine(__m128 Accumulator, __m128 Vector) { return _mm_add_ps(Accumulator, Vector); }
+};
+
+struct MLAS_REDUCTION_MAXIMUM_AVX2 {
+
+    static float Identity() { return -std::numeric_limits<float>::infinity(); }
+    static __m256 Apply(__m256 Accumulator, __m256 Vector) { return _mm256_max_ps(Accumulator, Vector); }
+    static __m256 Combine(__m256 Accumulator, __m256 Vector) { return _mm256_max_ps(Accumulator, Vector); }
+    static __m128 Combine(__m128 Accumulator, __m128 Vector) { return _mm_max_ps(Accumulator, Vector); }
+};
+
+struct MLAS_REDUCTION_MINIMUM_AVX2 {
+
+    static float Identity() { return std::numeric_limits<float>::infinity(); }
+    static __m256 Apply(__m256 Accumulator, __m256 Vector) { return _mm256_min_ps(Accumulator, Vector); }
+    static __m256 Combine(__m256 Accumulator, __m256 Vector) { return _mm256_min_ps(Accumulator, Vector); }
+    static __m128 Combine(__m128 Accumulator, __m128 Vector) { return _mm_min_ps(Accumulator, Vector); }
+};
+
+struct MLAS_REDUCTION_PRODUCT_AVX2 {
+
+    static float Identity() { return 1.0f; }
+    static __m256 Apply(__m256 Accumulator, __m256 Vector) { return _mm256_mul_ps(Accumulator, Vector); }
+    static __m256 Combine(__m256 Accumulator, __m256 Vector) { return _mm256_mul_ps(Accumulator, Vector); }
+    static __m128 Combine(__m128 Accumulator, __m128 Vector) { return _mm_mul_ps(Accumulator, Vector); }
+};
+
+template <typename Reduction>
+MLAS_FORCEINLINE
+float
+MlasReduceHorizontalAvx2(
+    __m256 Vector
+    )
+{
+    __m128 Vector128 = Reduction::Combine(_mm256_castps256_ps128(Vector), _mm256_extractf128_ps(Vector, 1));
+    Vector128 = Reduction::Combine(Vector128, _mm_movehl_ps(Vector128, Vector128));
+    Vector128 = Reduction::Combine(Vector128, _mm_movehdup_ps(Vector128));
+    return _mm_cvtss_f32(Vector128);
+}
+
+template <typename Reduction>
+float
+MlasReduceRowAvx2(
+    const float* Input,
+    size_t N
+    )
+{
+    const __m256 IdentityVector = _mm256_set1_ps(Reduction::Identity());
+
+    __m256 AccumulatorVector0 = IdentityVector;
+    __m256 AccumulatorVector1 = IdentityVector;
+    __m256 AccumulatorVector2 = IdentityVector;
+    __m256 AccumulatorVector3 = IdentityVector;
+
+    while (N >= 32) {
+
+        AccumulatorVector0 = Reduction::Apply(AccumulatorVector0, _mm256_loadu_ps(Input));
+        AccumulatorVector1 = Reduction::Apply(AccumulatorVector1, _mm256_loadu_ps(Input + 8));
+        AccumulatorVector2 = Reduction::Apply(AccumulatorVector2, _mm256_loadu_ps(Input + 16));
+        AccumulatorVector3 = Reduction::Apply(AccumulatorVector3, _mm256_loadu_ps(Input + 24));
+
+        Input += 32;
+        N -= 32;
+    }
+
+    while (N >= 8) {
+
+        AccumulatorVector0 = Reduction::Apply(AccumulatorVector0, _mm256_loadu_ps(Input));
+
+        Input += 8;
+        N -= 8;
+    }
+
+    if (N > 0) {
+
+        const __m256i Mask = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(&MlasReduceMaskTableAvx2[8 - N]));
+
+        __m256 Vector = _mm256_blendv_ps(IdentityVector, _mm256_maskload_ps(Input, Mask), _mm256_castsi256_ps(Mask));
+
+        AccumulatorVector1 = Reduction::Apply(AccumulatorVector1, Vector);
+    }
+
+    AccumulatorVector0 = Reduction::Combine(AccumulatorVector0, AccumulatorVector1);
+    AccumulatorVector2 = Reduction::Combine(AccumulatorVector2, AccumulatorVector3);
+    AccumulatorVector0 = Reduction::Combine(AccumulatorVector0, AccumulatorVector2);
+
+    return MlasReduceHorizontalAvx2<Reduction>(AccumulatorVector0);
+}
+
+template <typename Reduction>
+void
+MlasReduceRowsAvx2(
+    const float* Input,
+    float* Output,
+    size_t RowCount,
+    size_t RowSize
+    )
+{
+    for (size_t Row = 0; Row < RowCount; Row++) {
+        Output[Row] = MlasReduceRowAvx2<Reduction>(Input + Row * RowSize, RowSize);
+    }
+}
+
+template <typename Reduction>
+void
+MlasReduceColumnsAvx2(
+    const float* Input,
+    float* Output,
+    size_t ReduceCount,
+    size_t ColumnCount,
+    size_t ldInput
+    )
+{
+    const __m256 IdentityVector = _mm256_set1_ps(Reduction::Identity());
+
+    size_t c = 0;
+
+    for (; c + 32 <= ColumnCount; c += 32) {
+
+        __m256 AccumulatorVector0 = IdentityVector;
+        __m256 AccumulatorVector1 = IdentityVector;
+        __m256 AccumulatorVector2 = IdentityVector;
+        __m256 AccumulatorVector3 = IdentityVector;
+        const float* input = Input + c;
+
+        for (size_t r = 0; r < ReduceCount; r++) {
+
+            AccumulatorVector0 = Reduction::Apply(AccumulatorVector0, _mm256_loadu_ps(input));
+            AccumulatorVector1 = Reduction::Apply(AccumulatorVector1, _mm256_loadu_ps(input + 8));
+            AccumulatorVector2 = Reduction::Apply(AccumulatorVector2, _mm256_loadu_ps(input + 16));
+            AccumulatorVector3 = Reduction::Apply(AccumulatorVector3, _mm256_loadu_ps(input + 24));
+
+            input += ldInput;
+        }
+
+        _mm256_storeu_ps(Output + c, AccumulatorVector0);
+        _mm256_storeu_ps(Output + c + 8, AccumulatorVector1);
+        _mm256_storeu_ps(Output + c + 16, AccumulatorVector2);
+        _mm256_storeu_ps(Output + c + 24, AccumulatorVector3);
+    }
+
+    for (; c + 8 <= ColumnCount; c += 8) {
+
+        __m256 AccumulatorVector = IdentityVector;
+        const float* input = Input + c;
+
+        for (size_t r = 0; r < ReduceCount; r++) {
+            AccumulatorVector = Reduction::Apply(AccumulatorVector, _mm256_loadu_ps(input));
+            input += ldInput;
+        }
+
+        _mm256_storeu_ps(Output + c, AccumulatorVector);
+    }
+
+    if (c < ColumnCount) {
+
+        const __m256i Mask = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(&MlasReduceMaskTableAvx2[8 - (ColumnCount - c)]));
+
+        __m256 AccumulatorVector = IdentityVector;
+        const float* input = Input + c;
+
+        for (size_t r = 0; r < ReduceCount; r++) {
+            AccumulatorVector = Reduction::Apply(AccumulatorVector, _mm256_maskload_ps(input, Mask));
+            input += ldInput;
+        }
+
+        _mm256_maskstore_ps(Output + c, Mask, AccumulatorVector);
+    }
+}
+
+void
+MLASCALL
+MlasReduceRowsF32KernelAvx2(
+    MLAS_REDUCTION_KIND Kind,
+    const float* Input,
+    float* Output,
+    size_t RowCount,
+    size_t RowSize
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX2 kernel to reduce each row of a matrix to
+    a scalar.
+
+Arguments:
+
+    Kind - Supplies the reduction to apply. The log sum exp reduction is not
+        handled by the kernel.
+
+    Input - Supplies the input matrix, [RowCount][RowSize].
+
+    Output - Supplies the output vector, [RowCount].
+
+    RowCount - Supplies the number of rows to reduce.
+
+    RowSize - Supplies the number of elements of a row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (Kind) {
+        case MlasSumReduction:
+            MlasReduceRowsAvx2<MLAS_REDUCTION_SUM_AVX2>(Input, Output, RowCount, RowSize);
+            break;
+        case MlasSumSquareReduction:
+            MlasReduceRowsAvx2<MLAS_REDUCTION_SUM_SQUARE_AVX2>(Input, Output, RowCount, RowSize);
+            break;
+        case MlasMaximumReduction:
+            MlasReduceRowsAvx2<MLAS_REDUCTION_MAXIMUM_AVX2>(Input, Output, RowCount, RowSize);
+            break;
+        case MlasMinimumReduction:
+            MlasReduceRowsAvx2<MLAS_REDUCTION_MINIMUM_AVX2>(Input, Output, RowCount, RowSize);
+            break;
+        case MlasProductReduction:
+            MlasReduceRowsAvx2<MLAS_REDUCTION_PRODUCT_AVX2>(Input, Output, RowCount, RowSize);
+            break;
+        default:
+            MLAS_THROW_EX(std::runtime_error, "bad mlas reduction kind");
+    }
+}
+
+void
+MLASCALL
+MlasReduceColumnsF32KernelAvx2(
+    MLAS_REDUCTION_KIND Kind,
+    const float* Input,
+    float* Output,
+    size_t ReduceCount,
+    size_t ColumnCount,
+    size_t ldInput
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX2 kernel to reduce the rows of a matrix to
+    a single row.
+
+Arguments:
+
+    Kind - Supplies the reduction to apply. The log sum exp reduction is not
+        handled by the kernel.
+
+    Input - Supplies the input matrix, [ReduceCount][ldInput].
+
+    Output - Supplies the output vector, [ColumnCount].
+
+    ReduceCount - Supplies the number of rows to reduce.
+
+    ColumnCount - Supplies the number of columns to reduce.
+
+    ldInput - Supplies the number of elements between consecutive rows of the
+        input matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (Kind) {
+        case MlasSumReduction:
+            MlasReduceColumnsAvx2<MLAS_REDUCTION_SUM_AVX2>(Input, Output, ReduceCount, ColumnCount, ldInput);
+            break;
+        case MlasSumSquareReduction:
+            MlasReduceColumnsAvx2<MLAS_REDUCTION_SUM_SQUARE_AVX2>(Input, Output, ReduceCount, ColumnCount, ldInput);
+            break;
+        case MlasMaximumReduction:
+            MlasReduceColumnsAvx2<MLAS_REDUCTION_MAXIMUM_AVX2>(Input, Output, ReduceCount, ColumnCount, ldInput);
+            break;
+        case MlasMinimumReduction:
+            MlasReduceColumnsAvx2<MLAS_REDUCTION_MINIMUM_AVX2>(Input, Output, ReduceCount, ColumnCount, ldInput);
+            break;
+        case MlasProductReduction:
+            MlasReduceColumnsAvx2<MLAS_REDUCTION_PRODUCT_AVX2>(Input, Output, ReduceCount, ColumnCount, ldInput);
+            break;
+        default:
+            MLAS_THROW_EX(std::runtime_error, "bad mlas reduction kind");
+    }
+}
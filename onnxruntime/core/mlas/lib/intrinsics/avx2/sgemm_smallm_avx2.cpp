@@ -0,0 +1,428 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_smallm_avx2.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation (SGEMM) for a small number of rows of matrix A using AVX2 and
+    FMA3 intrinsics.
+
+    When matrix A has few rows, the elements of matrix B are used only a few
+    times each, so copying matrix B to the packed panel of the generic SGEMM
+    costs about as much as the multiply. These kernels instead stream matrix B
+    directly, computing all of the rows of the output for each block of
+    columns. Matrix B is consumed in slices of rows, so that a sweep over the
+    columns reads each cache line of the slice once and in address order.
+
+--*/
+
+#include "../../mlasi.h"
+
+//
+// Table to build the mask of the partial vector at the end of a row.
+//
+
+MLAS_DECLSPEC_ALIGN(static const int32_t MlasSgemmSmallMMaskTableAvx2[16], 32) = {
+    -1, -1, -1, -1, -1, -1, -1, -1, 0, 0, 0, 0, 0, 0, 0, 0,
+};
+
+MLAS_FORCEINLINE
+__m256i
+MlasSgemmSmallMMaskAvx2(
+    size_t Count
+    )
+{
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&MlasSgemmSmallMMaskTableAvx2[8 - std::min(Count, size_t(8))]));
+}
+
+MLAS_FORCEINLINE
+float
+MlasSgemmSmallMReduceAddAvx2(
+    __m256 Vector
+    )
+{
+    __m128 Vector128 = _mm_add_ps(_mm256_castps256_ps128(Vector), _mm256_extractf128_ps(Vector, 1));
+    Vector128 = _mm_add_ps(Vector128, _mm_movehl_ps(Vector128, Vector128));
+    Vector128 = _mm_add_ss(Vector128, _mm_movehdup_ps(Vector128));
+    return _mm_cvtss_f32(Vector128);
+}
+
+template <size_t RowCount>
+void
+MlasSgemmSmallMBlockAvx2(
+    size_t CountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t StrideAM,
+    size_t StrideAK,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a RowCount by CountN block of the output for matrix
+    B not transposed, where CountN is at most 16. Each row of the block of
+    matrix B is multiplied by every row of matrix A.
+
+--*/
+{
+    const __m256i Mask0 = MlasSgemmSmallMMaskAvx2(CountN);
+    const __m256i Mask1 = MlasSgemmSmallMMaskAvx2(CountN > 8 ? CountN - 8 : 0);
+
+    __m256 Accumulators[RowCount][2];
+
+    for (size_t r = 0; r < RowCount; r++) {
+        Accumulators[r][0] = _mm256_setzero_ps();
+        Accumulators[r][1] = _mm256_setzero_ps();
+    }
+
+    if (CountN == 16) {
+
+        for (size_t k = 0; k < K; k++) {
+
+            const __m256 BElements0 = _mm256_loadu_ps(B);
+            const __m256 BElements1 = _mm256_loadu_ps(B + 8);
+
+            for (size_t r = 0; r < RowCount; r++) {
+                const __m256 ABroadcast = _mm256_broadcast_ss(A + r * StrideAM);
+                Accumulators[r][0] = _mm256_fmadd_ps(ABroadcast, BElements0, Accumulators[r][0]);
+                Accumulators[r][1] = _mm256_fmadd_ps(ABroadcast, BElements1, Accumulators[r][1]);
+            }
+
+            A += StrideAK;
+            B += ldb;
+        }
+
+    } else {
+
+        for (size_t k = 0; k < K; k++) {
+
+            const __m256 BElements0 = _mm256_maskload_ps(B, Mask0);
+            const __m256 BElements1 = _mm256_maskload_ps(B + 8, Mask1);
+
+            for (size_t r = 0; r < RowCount; r++) {
+                const __m256 ABroadcast = _mm256_broadcast_ss(A + r * StrideAM);
+                Accumulators[r][0] = _mm256_fmadd_ps(ABroadcast, BElements0, Accumulators[r][0]);
+                Accumulators[r][1] = _mm256_fmadd_ps(ABroadcast, BElements1, Accumulators[r][1]);
+            }
+
+            A += StrideAK;
+            B += ldb;
+        }
+    }
+
+    const __m256 AlphaBroadcast = _mm256_set1_ps(alpha);
+    const __m256 BetaBroadcast = _mm256_set1_ps(beta);
+
+    for (size_t r = 0; r < RowCount; r++) {
+
+        __m256 Output0 = _mm256_mul_ps(Accumulators[r][0], AlphaBroadcast);
+        __m256 Output1 = _mm256_mul_ps(Accumulators[r][1], AlphaBroadcast);
+
+        if (CountN == 16) {
+
+            if (beta != 0.0f) {
+                Output0 = _mm256_fmadd_ps(_mm256_loadu_ps(C), BetaBroadcast, Output0);
+                Output1 = _mm256_fmadd_ps(_mm256_loadu_ps(C + 8), BetaBroadcast, Output1);
+            }
+
+            _mm256_storeu_ps(C, Output0);
+            _mm256_storeu_ps(C + 8, Output1);
+
+        } else {
+
+            if (beta != 0.0f) {
+                Output0 = _mm256_fmadd_ps(_mm256_maskload_ps(C, Mask0), BetaBroadcast, Output0);
+                Output1 = _mm256_fmadd_ps(_mm256_maskload_ps(C + 8, Mask1), BetaBroadcast, Output1);
+            }
+
+            _mm256_maskstore_ps(C, Mask0, Output0);
+            _mm256_maskstore_ps(C + 8, Mask1, Output1);
+        }
+
+        C += ldc;
+    }
+}
+
+template <size_t RowCount, size_t ColumnCount>
+void
+MlasSgemmSmallMTransposeBBlockAvx2(
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a RowCount by ColumnCount block of the output for
+    matrix B transposed as dot products of the rows of matrix A and matrix B.
+
+--*/
+{
+    __m256 Accumulators[RowCount][ColumnCount];
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t c = 0; c < ColumnCount; c++) {
+            Accumulators[r][c] = _mm256_setzero_ps();
+        }
+    }
+
+    size_t k = 0;
+
+    for (; k + 8 <= K; k += 8) {
+
+        __m256 BElements[ColumnCount];
+
+        for (size_t c = 0; c < ColumnCount; c++) {
+            BElements[c] = _mm256_loadu_ps(B + c * ldb + k);
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            const __m256 AElements = _mm256_loadu_ps(A + r * lda + k);
+            for (size_t c = 0; c < ColumnCount; c++) {
+                Accumulators[r][c] = _mm256_fmadd_ps(AElements, BElements[c], Accumulators[r][c]);
+            }
+        }
+    }
+
+    if (k < K) {
+
+        const __m256i Mask = MlasSgemmSmallMMaskAvx2(K - k);
+
+        __m256 BElements[ColumnCount];
+
+        for (size_t c = 0; c < ColumnCount; c++) {
+            BElements[c] = _mm256_maskload_ps(B + c * ldb + k, Mask);
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            const __m256 AElements = _mm256_maskload_ps(A + r * lda + k, Mask);
+            for (size_t c = 0; c < ColumnCount; c++) {
+                Accumulators[r][c] = _mm256_fmadd_ps(AElements, BElements[c], Accumulators[r][c]);
+            }
+        }
+    }
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t c = 0; c < ColumnCount; c++) {
+            float Output = MlasSgemmSmallMReduceAddAvx2(Accumulators[r][c]) * alpha;
+            if (beta != 0.0f) {
+                Output += C[r * ldc + c] * beta;
+            }
+            C[r * ldc + c] = Output;
+        }
+    }
+}
+
+static
+void
+MlasSgemmSmallMRowsAvx2(
+    size_t M,
+    size_t CountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t StrideAM,
+    size_t StrideAK,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine computes an M by CountN block of the output for matrix B not
+    transposed, where CountN is at most 16.
+
+    The rows are processed in groups of six to keep the accumulators and the
+    elements of matrix B in the sixteen vector registers. The block of matrix
+    B is still in the cache for the second group.
+
+--*/
+{
+    for (size_t m = 0; m < M; m += 6) {
+
+        const float* a = A + m * StrideAM;
+        float* c = C + m * ldc;
+
+        switch (std::min(M - m, size_t(6))) {
+            case 1:
+                MlasSgemmSmallMBlockAvx2<1>(CountN, K, alpha, a, StrideAM, StrideAK, B, ldb, beta, c, ldc);
+                break;
+            case 2:
+                MlasSgemmSmallMBlockAvx2<2>(CountN, K, alpha, a, StrideAM, StrideAK, B, ldb, beta, c, ldc);
+                break;
+            case 3:
+                MlasSgemmSmallMBlockAvx2<3>(CountN, K, alpha, a, StrideAM, StrideAK, B, ldb, beta, c, ldc);
+                break;
+            case 4:
+                MlasSgemmSmallMBlockAvx2<4>(CountN, K, alpha, a, StrideAM, StrideAK, B, ldb, beta, c, ldc);
+                break;
+            case 5:
+                MlasSgemmSmallMBlockAvx2<5>(CountN, K, alpha, a, StrideAM, StrideAK, B, ldb, beta, c, ldc);
+                break;
+            default:
+                MlasSgemmSmallMBlockAvx2<6>(CountN, K, alpha, a, StrideAM, StrideAK, B, ldb, beta, c, ldc);
+                break;
+        }
+    }
+}
+
+typedef
+void
+(MLAS_SGEMM_SMALL_M_TRANSPOSE_B_BLOCK_AVX2)(
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc
+    );
+
+//
+// Table of the transposed B kernels indexed by the number of rows and columns
+// of the output block minus one.
+//
+
+static MLAS_SGEMM_SMALL_M_TRANSPOSE_B_BLOCK_AVX2* const MlasSgemmSmallMTransposeBBlockTableAvx2[4][2] = {
+    {MlasSgemmSmallMTransposeBBlockAvx2<1, 1>, MlasSgemmSmallMTransposeBBlockAvx2<1, 2>},
+    {MlasSgemmSmallMTransposeBBlockAvx2<2, 1>, MlasSgemmSmallMTransposeBBlockAvx2<2, 2>},
+    {MlasSgemmSmallMTransposeBBlockAvx2<3, 1>, MlasSgemmSmallMTransposeBBlockAvx2<3, 2>},
+    {MlasSgemmSmallMTransposeBBlockAvx2<4, 1>, MlasSgemmSmallMTransposeBBlockAvx2<4, 2>},
+};
+
+void
+MLASCALL
+MlasSgemmSmallMKernelAvx2(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX2 kernel for the single precision matrix/
+    matrix multiply operation (SGEMM) with at most MLAS_SGEMM_SMALL_M_MAXIMUM
+    rows of matrix A.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B. Matrix B can only
+        be transposed if matrix A is not transposed.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (TransB == CblasNoTrans) {
+
+        const size_t StrideAM = (TransA == CblasNoTrans) ? lda : 1;
+        const size_t StrideAK = (TransA == CblasNoTrans) ? 1 : lda;
+
+        //
+        // Step through slices of matrix B along the K dimension. The output
+        // accumulates the slices after the first one.
+        //
+
+        size_t CountK;
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = std::min(K - k, size_t(MLAS_SGEMM_SMALL_M_STRIDEK));
+
+            const float BetaSlice = (k == 0) ? beta : 1.0f;
+
+            for (size_t n = 0; n < N; n += 16) {
+
+                const size_t CountN = std::min(N - n, size_t(16));
+
+                MlasSgemmSmallMRowsAvx2(M, CountN, CountK, alpha, A + k * StrideAK, StrideAM, StrideAK,
+                    B + k * ldb + n, ldb, BetaSlice, C + n, ldc);
+            }
+        }
+
+    } else {
+
+        //
+        // Process pairs of rows of matrix B with the rows of matrix A in
+        // groups of four.
+        //
+
+        for (size_t n = 0; n < N; n += 2) {
+
+            const size_t ColumnCount = std::min(N - n, size_t(2));
+
+            for (size_t m = 0; m < M; m += 4) {
+
+                const size_t RowCount = std::min(M - m, size_t(4));
+
+                MlasSgemmSmallMTransposeBBlockTableAvx2[RowCount - 1][ColumnCount - 1](
+                    K, alpha, A + m * lda, lda, B + n * ldb, ldb, beta, C + m * ldc + n, ldc);
+            }
+        }
+    }
+}
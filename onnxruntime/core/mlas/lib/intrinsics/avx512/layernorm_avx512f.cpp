@@ -0,0 +1,259 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm_avx512f.cpp
+
+Abstract:
+
+    This module implements the layer normalization kernel using AVX512F
+    intrinsics. See layernorm.cpp for a description of the two passes.
+
+--*/
+
+#include "../../mlasi.h"
+
+template <bool HasSkip, bool HasBias, bool HasStaged>
+MLAS_FORCEINLINE
+__m512
+MlasLayerNormLoadAvx512F(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    float* Staged
+    )
+{
+    __m512 Vector = _mm512_loadu_ps(Input);
+
+    if (HasSkip) {
+        Vector = _mm512_add_ps(Vector, _mm512_loadu_ps(Skip));
+    }
+
+    if (HasBias) {
+        Vector = _mm512_add_ps(Vector, _mm512_loadu_ps(Bias));
+    }
+
+    if (HasStaged) {
+        _mm512_storeu_ps(Staged, Vector);
+    }
+
+    return Vector;
+}
+
+template <bool HasSkip, bool HasBias, bool HasStaged>
+MLAS_FORCEINLINE
+__m512
+MlasLayerNormMaskLoadAvx512F(
+    const float* Input,
+    const float* Skip,
+    const float* Bias,
+    float* Staged,
+    __mmask16 Mask
+    )
+{
+    __m512 Vector = _mm512_maskz_loadu_ps(Mask, Input);
+
+    if (HasSkip) {
+        Vector = _mm512_add_ps(Vector, _mm512_maskz_loadu_ps(Mask, Skip));
+    }
+
+    if (HasBias) {
+        Vector = _mm512_add_ps(Vector, _mm512_maskz_loadu_ps(Mask, Bias));
+    }
+
+    if (HasStaged) {
+        _mm512_mask_storeu_ps(Staged, Mask, Vector);
+    }
+
+    return Vector;
+}
+
+template <bool HasSkip, bool HasBias, bool HasStaged, bool HasShift>
+void
+MlasLayerNormRowAvx512F(
+    const MLAS_LAYER_NORM_PARAMS<float>* Params,
+    size_t Row
+    )
+{
+    const size_t D = Params->RowSize;
+    const float* Input = Params->Input + Row * D;
+    float* Output = Params->Output + Row * D;
+
+    //
+    // Unused optional inputs alias the input so that offsetting them is valid.
+    //
+
+    const float* Skip = HasSkip ? Params->Skip + Row * D : Input;
+    const float* Bias = HasBias ? Params->Bias : Input;
+    const float* Scale = Params->Scale;
+    const float* Shift = HasShift ? Params->Shift : Input;
+    float* Staged = HasStaged ? MlasLayerNormStagingBuffer(Params, Row) : Output;
+    const float Offset = MlasLayerNormOffset(Params, Row);
+    const __m512 OffsetVector = _mm512_set1_ps(Offset);
+
+    const size_t Remainder = D % 16;
+    const __mmask16 Mask = __mmask16((1u << Remainder) - 1);
+
+    //
+    // Accumulate the sum and the sum of squares of X.
+    //
+
+    __m512 SumVector0 = _mm512_setzero_ps();
+    __m512 SumVector1 = _mm512_setzero_ps();
+    __m512 SumSquaresVector0 = _mm512_setzero_ps();
+    __m512 SumSquaresVector1 = _mm512_setzero_ps();
+
+    size_t d = 0;
+
+    for (; d + 32 <= D; d += 32) {
+
+        __m512 Vector0 = MlasLayerNormLoadAvx512F<HasSkip, HasBias, HasStaged>(
+            Input + d, Skip + d, Bias + d, Staged + d);
+        __m512 Vector1 = MlasLayerNormLoadAvx512F<HasSkip, HasBias, HasStaged>(
+            Input + d + 16, Skip + d + 16, Bias + d + 16, Staged + d + 16);
+
+        Vector0 = _mm512_sub_ps(Vector0, OffsetVector);
+        Vector1 = _mm512_sub_ps(Vector1, OffsetVector);
+
+        SumVector0 = _mm512_add_ps(SumVector0, Vector0);
+        SumVector1 = _mm512_add_ps(SumVector1, Vector1);
+        SumSquaresVector0 = _mm512_fmadd_ps(Vector0, Vector0, SumSquaresVector0);
+        SumSquaresVector1 = _mm512_fmadd_ps(Vector1, Vector1, SumSquaresVector1);
+    }
+
+    if (d + 16 <= D) {
+
+        __m512 Vector = MlasLayerNormLoadAvx512F<HasSkip, HasBias, HasStaged>(
+            Input + d, Skip + d, Bias + d, Staged + d);
+
+        Vector = _mm512_sub_ps(Vector, OffsetVector);
+
+        SumVector0 = _mm512_add_ps(SumVector0, Vector);
+        SumSquaresVector0 = _mm512_fmadd_ps(Vector, Vector, SumSquaresVector0);
+
+        d += 16;
+    }
+
+    if (Remainder > 0) {
+
+        __m512 Vector = MlasLayerNormMaskLoadAvx512F<HasSkip, HasBias, HasStaged>(
+            Input + d, Skip + d, Bias + d, Staged + d, Mask);
+
+        Vector = _mm512_maskz_sub_ps(Mask, Vector, OffsetVector);
+
+        SumVector1 = _mm512_add_ps(SumVector1, Vector);
+        SumSquaresVector1 = _mm512_fmadd_ps(Vector, Vector, SumSquaresVector1);
+    }
+
+    float Mean;
+    float InvStdDev;
+
+    MlasLayerNormComputeStatistics(Params, Row, Offset,
+                                   _mm512_reduce_add_ps(_mm512_add_ps(SumVector0, SumVector1)),
+                                   _mm512_reduce_add_ps(_mm512_add_ps(SumSquaresVector0, SumSquaresVector1)),
+                                   &Mean, &InvStdDev);
+
+    //
+    // Output = X * InvStdDev - Mean * InvStdDev, then scale and shift.
+    //
+
+    const float* X = HasStaged ? Staged : Input;
+
+    const __m512 InvStdDevVector = _mm512_set1_ps(InvStdDev);
+    const __m512 NegativeMeanVector = _mm512_set1_ps(-Mean * InvStdDev);
+
+    d = 0;
+
+    for (; d + 16 <= D; d += 16) {
+
+        __m512 Vector = _mm512_fmadd_ps(_mm512_loadu_ps(X + d), InvStdDevVector, NegativeMeanVector);
+
+        if (HasShift) {
+            Vector = _mm512_fmadd_ps(Vector, _mm512_loadu_ps(Scale + d), _mm512_loadu_ps(Shift + d));
+        } else {
+            Vector = _mm512_mul_ps(Vector, _mm512_loadu_ps(Scale + d));
+        }
+
+        _mm512_storeu_ps(Output + d, Vector);
+    }
+
+    if (Remainder > 0) {
+
+        __m512 Vector = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(Mask, X + d), InvStdDevVector, NegativeMeanVector);
+
+        if (HasShift) {
+            Vector = _mm512_fmadd_ps(Vector, _mm512_maskz_loadu_ps(Mask, Scale + d), _mm512_maskz_loadu_ps(Mask, Shift + d));
+        } else {
+            Vector = _mm512_mul_ps(Vector, _mm512_maskz_loadu_ps(Mask, Scale + d));
+        }
+
+        _mm512_mask_storeu_ps(Output + d, Mask, Vector);
+    }
+}
+
+template <bool HasSkip, bool HasBias, bool HasStaged>
+MLAS_FORCEINLINE
+void
+MlasLayerNormRowsAvx512F(
+    const MLAS_LAYER_NORM_PARAMS<float>* Params,
+    size_t StartRow,
+    size_t CountRow
+    )
+{
+    for (size_t Row = StartRow; Row < StartRow + CountRow; Row++) {
+        if (Params->Shift != nullptr) {
+            MlasLayerNormRowAvx512F<HasSkip, HasBias, HasStaged, true>(Params, Row);
+        } else {
+            MlasLayerNormRowAvx512F<HasSkip, HasBias, HasStaged, false>(Params, Row);
+        }
+    }
+}
+
+void
+MLASCALL
+MlasLayerNormF32KernelAvx512F(
+    const MLAS_LAYER_NORM_PARAMS<float>* Params,
+    size_t StartRow,
+    size_t CountRow
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX512F kernel for layer normalization. The
+    optional inputs are resolved once per call, so the inner loops do not
+    test them.
+
+Arguments:
+
+    Params - Supplies the parameters of the operation.
+
+    StartRow - Supplies the index of the first row to process.
+
+    CountRow - Supplies the number of rows to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const bool HasSkip = (Params->Skip != nullptr);
+    const bool HasBias = (Params->Bias != nullptr);
+
+    if (HasSkip && HasBias) {
+        MlasLayerNormRowsAvx512F<true, true, true>(Params, StartRow, CountRow);
+    } else if (HasSkip) {
+        MlasLayerNormRowsAvx512F<true, false, true>(Params, StartRow, CountRow);
+    } else if (HasBias) {
+        MlasLayerNormRowsAvx512F<false, true, true>(Params, StartRow, CountRow);
+    } else if (Params->SkipOutput != nullptr) {
+        MlasLayerNormRowsAvx512F<false, false, true>(Params, StartRow, CountRow);
+    } else {
+        MlasLayerNormRowsAvx512F<false, false, false>(Params, StartRow, CountRow);
+    }
+}
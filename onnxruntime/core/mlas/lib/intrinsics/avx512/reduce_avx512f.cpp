@@ -0,0 +1,308 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    reduce_avx512f.cpp
+
+Abstract:
+
+    This module implements the reduction kernels using AVX512F intrinsics.
+    See reduce.cpp for a description of the kernels.
+
+--*/
+
+#include "../../mlasi.h"
+
+//
+// Reduction operators. Apply folds an input vector into an accumulator,
+// Combine merges two accumulators and Reduce combines the lanes of an
+// accumulator.
+//
+
+struct MLAS_REDUCTION_SUM_AVX512F {
+
+    static float Identity() { return 0.0f; }
+    static __m512 Apply(__m512 Accumulator, __m512 Vector) { return _mm512_add_ps(Accumulator, Vector); }
+    static __m512 Combine(__m512 Accumulator, __m512 Vector) { return _mm512_add_ps(Accumulator, Vector); }
+    static float Reduce(__m512 Vector) { return _mm512_reduce_add_ps(Vector); }
+};
+
+struct MLAS_REDUCTION_SUM_SQUARE_AVX512F {
+
+    static float Identity() { return 0.0f; }
+    static __m512 Apply(__m512 Accumulator, __m512 Vector) { return _mm512_fmadd_ps(Vector, Vector, Accumulator); }
+    static __m512 Combine(__m512 Accumulator, __m512 Vector) { return _mm512_add_ps(Accumulator, Vector); }
+    static float Reduce(__m512 Vector) { return _mm512_reduce_add_ps(Vector); }
+};
+
+struct MLAS_REDUCTION_MAXIMUM_AVX512F {
+
+    static float Identity() { return -std::numeric_limits<float>::infinity(); }
+    static __m512 Apply(__m512 Accumulator, __m512 Vector) { return _mm512_max_ps(Accumulator, Vector); }
+    static __m512 Combine(__m512 Accumulator, __m512 Vector) { return _mm512_max_ps(Accumulator, Vector); }
+    static float Reduce(__m512 Vector) { return _mm512_reduce_max_ps(Vector); }
+};
+
+struct MLAS_REDUCTION_MINIMUM_AVX512F {
+
+    static float Identity() { return std::numeric_limits<float>::infinity(); }
+    static __m512 Apply(__m512 Accumulator, __m512 Vector) { return _mm512_min_ps(Accumulator, Vector); }
+    static __m512 Combine(__m512 Accumulator, __m512 Vector) { return _mm512_min_ps(Accumulator, Vector); }
+    static float Reduce(__m512 Vector) { return _mm512_reduce_min_ps(Vector); }
+};
+
+struct MLAS_REDUCTION_PRODUCT_AVX512F {
+
+    static float Identity() { return 1.0f; }
+    static __m512 Apply(__m512 Accumulator, __m512 Vector) { return _mm512_mul_ps(Accumulator, Vector); }
+    static __m512 Combine(__m512 Accumulator, __m512 Vector) { return _mm512_mul_ps(Accumulator, Vector); }
+    static float Reduce(__m512 Vector) { return _mm512_reduce_mul_ps(Vector); }
+};
+
+template <typename Reduction>
+float
+MlasReduceRowAvx512F(
+    const float* Input,
+    size_t N
+    )
+{
+    const __m512 IdentityVector = _mm512_set1_ps(Reduction::Identity());
+
+    __m512 AccumulatorVector0 = IdentityVector;
+    __m512 AccumulatorVector1 = IdentityVector;
+    __m512 AccumulatorVector2 = IdentityVector;
+    __m512 AccumulatorVector3 = IdentityVector;
+
+    while (N >= 64) {
+
+        AccumulatorVector0 = Reduction::Apply(AccumulatorVector0, _mm512_loadu_ps(Input));
+        AccumulatorVector1 = Reduction::Apply(AccumulatorVector1, _mm512_loadu_ps(Input + 16));
+        AccumulatorVector2 = Reduction::Apply(AccumulatorVector2, _mm512_loadu_ps(Input + 32));
+        AccumulatorVector3 = Reduction::Apply(AccumulatorVector3, _mm512_loadu_ps(Input + 48));
+
+        Input += 64;
+        N -= 64;
+    }
+
+    while (N >= 16) {
+
+        AccumulatorVector0 = Reduction::Apply(AccumulatorVector0, _mm512_loadu_ps(Input));
+
+        Input += 16;
+        N -= 16;
+    }
+
+    if (N > 0) {
+
+        const __mmask16 Mask = __mmask16((1u << N) - 1);
+
+        AccumulatorVector1 = Reduction::Apply(AccumulatorVector1, _mm512_mask_loadu_ps(IdentityVector, Mask, Input));
+    }
+
+    AccumulatorVector0 = Reduction::Combine(AccumulatorVector0, AccumulatorVector1);
+    AccumulatorVector2 = Reduction::Combine(AccumulatorVector2, AccumulatorVector3);
+    AccumulatorVector0 = Reduction::Combine(AccumulatorVector0, AccumulatorVector2);
+
+    return Reduction::Reduce(AccumulatorVector0);
+}
+
+template <typename Reduction>
+void
+MlasReduceRowsAvx512F(
+    const float* Input,
+    float* Output,
+    size_t RowCount,
+    size_t RowSize
+    )
+{
+    for (size_t Row = 0; Row < RowCount; Row++) {
+        Output[Row] = MlasReduceRowAvx512F<Reduction>(Input + Row * RowSize, RowSize);
+    }
+}
+
+template <typename Reduction>
+void
+MlasReduceColumnsAvx512F(
+    const float* Input,
+    float* Output,
+    size_t ReduceCount,
+    size_t ColumnCount,
+    size_t ldInput
+    )
+{
+    const __m512 IdentityVector = _mm512_set1_ps(Reduction::Identity());
+
+    size_t c = 0;
+
+    for (; c + 64 <= ColumnCount; c += 64) {
+
+        __m512 AccumulatorVector0 = IdentityVector;
+        __m512 AccumulatorVector1 = IdentityVector;
+        __m512 AccumulatorVector2 = IdentityVector;
+        __m512 AccumulatorVector3 = IdentityVector;
+        const float* input = Input + c;
+
+        for (size_t r = 0; r < ReduceCount; r++) {
+
+            AccumulatorVector0 = Reduction::Apply(AccumulatorVector0, _mm512_loadu_ps(input));
+            AccumulatorVector1 = Reduction::Apply(AccumulatorVector1, _mm512_loadu_ps(input + 16));
+            AccumulatorVector2 = Reduction::Apply(AccumulatorVector2, _mm512_loadu_ps(input + 32));
+            AccumulatorVector3 = Reduction::Apply(AccumulatorVector3, _mm512_loadu_ps(input + 48));
+
+            input += ldInput;
+        }
+
+        _mm512_storeu_ps(Output + c, AccumulatorVector0);
+        _mm512_storeu_ps(Output + c + 16, AccumulatorVector1);
+        _mm512_storeu_ps(Output + c + 32, AccumulatorVector2);
+        _mm512_storeu_ps(Output + c + 48, AccumulatorVector3);
+    }
+
+    for (; c + 16 <= ColumnCount; c += 16) {
+
+        __m512 AccumulatorVector = IdentityVector;
+        const float* input = Input + c;
+
+        for (size_t r = 0; r < ReduceCount; r++) {
+            AccumulatorVector = Reduction::Apply(AccumulatorVector, _mm512_loadu_ps(input));
+            input += ldInput;
+        }
+
+        _mm512_storeu_ps(Output + c, AccumulatorVector);
+    }
+
+    if (c < ColumnCount) {
+
+        const __mmask16 Mask = __mmask16((1u << (ColumnCount - c)) - 1);
+
+        __m512 AccumulatorVector = IdentityVector;
+        const float* input = Input + c;
+
+        for (size_t r = 0; r < ReduceCount; r++) {
+            AccumulatorVector = Reduction::Apply(AccumulatorVector, _mm512_maskz_loadu_ps(Mask, input));
+            input += ldInput;
+        }
+
+        _mm512_mask_storeu_ps(Output + c, Mask, AccumulatorVector);
+    }
+}
+
+void
+MLASCALL
+MlasReduceRowsF32KernelAvx512F(
+    MLAS_REDUCTION_KIND Kind,
+    const float* Input,
+    float* Output,
+    size_t RowCount,
+    size_t RowSize
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX512F kernel to reduce each row of a matrix
+    to a scalar.
+
+Arguments:
+
+    Kind - Supplies the reduction to apply. The log sum exp reduction is not
+        handled by the kernel.
+
+    Input - Supplies the input matrix, [RowCount][RowSize].
+
+    Output - Supplies the output vector, [RowCount].
+
+    RowCount - Supplies the number of rows to reduce.
+
+    RowSize - Supplies the number of elements of a row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (Kind) {
+        case MlasSumReduction:
+            MlasReduceRowsAvx512F<MLAS_REDUCTION_SUM_AVX512F>(Input, Output, RowCount, RowSize);
+            break;
+        case MlasSumSquareReduction:
+            MlasReduceRowsAvx512F<MLAS_REDUCTION_SUM_SQUARE_AVX512F>(Input, Output, RowCount, RowSize);
+            break;
+        case MlasMaximumReduction:
+            MlasReduceRowsAvx512F<MLAS_REDUCTION_MAXIMUM_AVX512F>(Input, Output, RowCount, RowSize);
+            break;
+        case MlasMinimumReduction:
+            MlasReduceRowsAvx512F<MLAS_REDUCTION_MINIMUM_AVX512F>(Input, Output, RowCount, RowSize);
+            break;
+        case MlasProductReduction:
+            MlasReduceRowsAvx512F<MLAS_REDUCTION_PRODUCT_AVX512F>(Input, Output, RowCount, RowSize);
+            break;
+        default:
+            MLAS_THROW_EX(std::runtime_error, "bad mlas reduction kind");
+    }
+}
+
+void
+MLASCALL
+MlasReduceColumnsF32KernelAvx512F(
+    MLAS_REDUCTION_KIND Kind,
+    const float* Input,
+    float* Output,
+    size_t ReduceCount,
+    size_t ColumnCount,
+    size_t ldInput
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX512F kernel to reduce the rows of a matrix
+    to a single row.
+
+Arguments:
+
+    Kind - Supplies the reduction to apply. The log sum exp reduction is not
+        handled by the kernel.
+
+    Input - Supplies the input matrix, [ReduceCount][ldInput].
+
+    Output - Supplies the output vector, [ColumnCount].
+
+    ReduceCount - Supplies the number of rows to reduce.
+
+    ColumnCount - Supplies the number of columns to reduce.
+
+    ldInput - Supplies the number of elements between consecutive rows of the
+        input matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (Kind) {
+        case MlasSumReduction:
+            MlasReduceColumnsAvx512F<MLAS_REDUCTION_SUM_AVX512F>(Input, Output, ReduceCount, ColumnCount, ldInput);
+            break;
+        case MlasSumSquareReduction:
+            MlasReduceColumnsAvx512F<MLAS_REDUCTION_SUM_SQUARE_AVX512F>(Input, Output, ReduceCount, ColumnCount, ldInput);
+            break;
+        case MlasMaximumReduction:
+            MlasReduceColumnsAvx512F<MLAS_REDUCTION_MAXIMUM_AVX512F>(Input, Output, ReduceCount, ColumnCount, ldInput);
+            break;
+        case MlasMinimumReduction:
+            MlasReduceColumnsAvx512F<MLAS_REDUCTION_MINIMUM_AVX512F>(Input, Output, ReduceCount, ColumnCount, ldInput);
+            break;
+        case MlasProductReduction:
+            MlasReduceColumnsAvx512F<MLAS_REDUCTION_PRODUCT_AVX512F>(Input, Output, ReduceCount, ColumnCount, ldInput);
+            break;
+        default:
+            MLAS_THROW_EX(std::runtime_error, "bad mlas reduction kind");
+    }
+}
@@ -0,0 +1,490 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    sgemm_smallm_avx512f.cpp
+
+Abstract:
+
+    This module implements the single precision matrix/matrix multiply
+    operation (SGEMM) for a small number of rows of matrix A using AVX512F
+    intrinsics. See sgemm_smallm_avx2.cpp for a description of the kernels.
+
+    A block spans 32 columns, two panels of matrix B packed by MlasGemmPackB,
+    so the block kernel takes the offset of the second 16 columns.
+
+--*/
+
+#include "../../mlasi.h"
+
+template <size_t RowCount>
+void
+MlasSgemmSmallMBlockAvx512F(
+    size_t CountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t StrideAM,
+    size_t StrideAK,
+    const float* B,
+    size_t ldb,
+    size_t OffsetB1,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a RowCount by CountN block of the output for matrix
+    B not transposed, where CountN is at most 32. Each row of the block of
+    matrix B is multiplied by every row of matrix A. Columns 16 to 31 of a row
+    of matrix B are at OffsetB1 elements from the first column.
+
+--*/
+{
+    const __mmask16 Mask0 = __mmask16((CountN >= 16) ? 0xFFFF : (1u << CountN) - 1);
+    const __mmask16 Mask1 = __mmask16((CountN >= 32) ? 0xFFFF : (CountN > 16) ? (1u << (CountN - 16)) - 1 : 0);
+
+    __m512 Accumulators[RowCount][2];
+
+    for (size_t r = 0; r < RowCount; r++) {
+        Accumulators[r][0] = _mm512_setzero_ps();
+        Accumulators[r][1] = _mm512_setzero_ps();
+    }
+
+    if (CountN == 32) {
+
+        for (size_t k = 0; k < K; k++) {
+
+            const __m512 BElements0 = _mm512_loadu_ps(B);
+            const __m512 BElements1 = _mm512_loadu_ps(B + OffsetB1);
+
+            for (size_t r = 0; r < RowCount; r++) {
+                const __m512 ABroadcast = _mm512_set1_ps(A[r * StrideAM]);
+                Accumulators[r][0] = _mm512_fmadd_ps(ABroadcast, BElements0, Accumulators[r][0]);
+                Accumulators[r][1] = _mm512_fmadd_ps(ABroadcast, BElements1, Accumulators[r][1]);
+            }
+
+            A += StrideAK;
+            B += ldb;
+        }
+
+    } else {
+
+        for (size_t k = 0; k < K; k++) {
+
+            const __m512 BElements0 = _mm512_maskz_loadu_ps(Mask0, B);
+            const __m512 BElements1 = _mm512_maskz_loadu_ps(Mask1, B + OffsetB1);
+
+            for (size_t r = 0; r < RowCount; r++) {
+                const __m512 ABroadcast = _mm512_set1_ps(A[r * StrideAM]);
+                Accumulators[r][0] = _mm512_fmadd_ps(ABroadcast, BElements0, Accumulators[r][0]);
+                Accumulators[r][1] = _mm512_fmadd_ps(ABroadcast, BElements1, Accumulators[r][1]);
+            }
+
+            A += StrideAK;
+            B += ldb;
+        }
+    }
+
+    const __m512 AlphaBroadcast = _mm512_set1_ps(alpha);
+    const __m512 BetaBroadcast = _mm512_set1_ps(beta);
+
+    for (size_t r = 0; r < RowCount; r++) {
+
+        __m512 Output0 = _mm512_mul_ps(Accumulators[r][0], AlphaBroadcast);
+        __m512 Output1 = _mm512_mul_ps(Accumulators[r][1], AlphaBroadcast);
+
+        if (beta != 0.0f) {
+            Output0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(Mask0, C), BetaBroadcast, Output0);
+            Output1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(Mask1, C + 16), BetaBroadcast, Output1);
+        }
+
+        _mm512_mask_storeu_ps(C, Mask0, Output0);
+        _mm512_mask_storeu_ps(C + 16, Mask1, Output1);
+
+        C += ldc;
+    }
+}
+
+template <size_t RowCount, size_t ColumnCount>
+void
+MlasSgemmSmallMTransposeBBlockAvx512F(
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine computes a RowCount by ColumnCount block of the output for
+    matrix B transposed as dot products of the rows of matrix A and matrix B.
+
+--*/
+{
+    __m512 Accumulators[RowCount][ColumnCount];
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t c = 0; c < ColumnCount; c++) {
+            Accumulators[r][c] = _mm512_setzero_ps();
+        }
+    }
+
+    size_t k = 0;
+
+    for (; k + 16 <= K; k += 16) {
+
+        __m512 BElements[ColumnCount];
+
+        for (size_t c = 0; c < ColumnCount; c++) {
+            BElements[c] = _mm512_loadu_ps(B + c * ldb + k);
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            const __m512 AElements = _mm512_loadu_ps(A + r * lda + k);
+            for (size_t c = 0; c < ColumnCount; c++) {
+                Accumulators[r][c] = _mm512_fmadd_ps(AElements, BElements[c], Accumulators[r][c]);
+            }
+        }
+    }
+
+    if (k < K) {
+
+        const __mmask16 Mask = __mmask16((1u << (K - k)) - 1);
+
+        __m512 BElements[ColumnCount];
+
+        for (size_t c = 0; c < ColumnCount; c++) {
+            BElements[c] = _mm512_maskz_loadu_ps(Mask, B + c * ldb + k);
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            const __m512 AElements = _mm512_maskz_loadu_ps(Mask, A + r * lda + k);
+            for (size_t c = 0; c < ColumnCount; c++) {
+                Accumulators[r][c] = _mm512_fmadd_ps(AElements, BElements[c], Accumulators[r][c]);
+            }
+        }
+    }
+
+    for (size_t r = 0; r < RowCount; r++) {
+        for (size_t c = 0; c < ColumnCount; c++) {
+            float Output = _mm512_reduce_add_ps(Accumulators[r][c]) * alpha;
+            if (beta != 0.0f) {
+                Output += C[r * ldc + c] * beta;
+            }
+            C[r * ldc + c] = Output;
+        }
+    }
+}
+
+static
+void
+MlasSgemmSmallMRowsAvx512F(
+    size_t M,
+    size_t CountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t StrideAM,
+    size_t StrideAK,
+    const float* B,
+    size_t ldb,
+    size_t OffsetB1,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine computes an M by CountN block of the output for matrix B not
+    transposed, where CountN is at most 32. All of the rows fit in the thirty
+    two vector registers, so the block of matrix B is read once.
+
+--*/
+{
+    switch (M) {
+        case 1:
+            MlasSgemmSmallMBlockAvx512F<1>(CountN, K, alpha, A, StrideAM, StrideAK, B, ldb, OffsetB1, beta, C, ldc);
+            break;
+        case 2:
+            MlasSgemmSmallMBlockAvx512F<2>(CountN, K, alpha, A, StrideAM, StrideAK, B, ldb, OffsetB1, beta, C, ldc);
+            break;
+        case 3:
+            MlasSgemmSmallMBlockAvx512F<3>(CountN, K, alpha, A, StrideAM, StrideAK, B, ldb, OffsetB1, beta, C, ldc);
+            break;
+        case 4:
+            MlasSgemmSmallMBlockAvx512F<4>(CountN, K, alpha, A, StrideAM, StrideAK, B, ldb, OffsetB1, beta, C, ldc);
+            break;
+        case 5:
+            MlasSgemmSmallMBlockAvx512F<5>(CountN, K, alpha, A, StrideAM, StrideAK, B, ldb, OffsetB1, beta, C, ldc);
+            break;
+        case 6:
+            MlasSgemmSmallMBlockAvx512F<6>(CountN, K, alpha, A, StrideAM, StrideAK, B, ldb, OffsetB1, beta, C, ldc);
+            break;
+        case 7:
+            MlasSgemmSmallMBlockAvx512F<7>(CountN, K, alpha, A, StrideAM, StrideAK, B, ldb, OffsetB1, beta, C, ldc);
+            break;
+        default:
+            MlasSgemmSmallMBlockAvx512F<8>(CountN, K, alpha, A, StrideAM, StrideAK, B, ldb, OffsetB1, beta, C, ldc);
+            break;
+    }
+}
+
+typedef
+void
+(MLAS_SGEMM_SMALL_M_TRANSPOSE_B_BLOCK_AVX512F)(
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc
+    );
+
+//
+// Table of the transposed B kernels indexed by the number of rows and columns
+// of the output block minus one.
+//
+
+static MLAS_SGEMM_SMALL_M_TRANSPOSE_B_BLOCK_AVX512F* const MlasSgemmSmallMTransposeBBlockTableAvx512F[4][4] = {
+    {
+        MlasSgemmSmallMTransposeBBlockAvx512F<1, 1>,
+        MlasSgemmSmallMTransposeBBlockAvx512F<1, 2>,
+        MlasSgemmSmallMTransposeBBlockAvx512F<1, 3>,
+        MlasSgemmSmallMTransposeBBlockAvx512F<1, 4>,
+    },
+    {
+        MlasSgemmSmallMTransposeBBlockAvx512F<2, 1>,
+        MlasSgemmSmallMTransposeBBlockAvx512F<2, 2>,
+        MlasSgemmSmallMTransposeBBlockAvx512F<2, 3>,
+        MlasSgemmSmallMTransposeBBlockAvx512F<2, 4>,
+    },
+    {
+        MlasSgemmSmallMTransposeBBlockAvx512F<3, 1>,
+        MlasSgemmSmallMTransposeBBlockAvx512F<3, 2>,
+        MlasSgemmSmallMTransposeBBlockAvx512F<3, 3>,
+        MlasSgemmSmallMTransposeBBlockAvx512F<3, 4>,
+    },
+    {
+        MlasSgemmSmallMTransposeBBlockAvx512F<4, 1>,
+        MlasSgemmSmallMTransposeBBlockAvx512F<4, 2>,
+        MlasSgemmSmallMTransposeBBlockAvx512F<4, 3>,
+        MlasSgemmSmallMTransposeBBlockAvx512F<4, 4>,
+    },
+};
+
+void
+MLASCALL
+MlasSgemmSmallMKernelAvx512F(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX512F kernel for the single precision
+    matrix/matrix multiply operation (SGEMM) with at most
+    MLAS_SGEMM_SMALL_M_MAXIMUM rows of matrix A.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    TransB - Supplies the transpose operation for matrix B. Matrix B can only
+        be transposed if matrix A is not transposed.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    N - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    B - Supplies the address of matrix B.
+
+    ldb - Supplies the first dimension of matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (TransB == CblasNoTrans) {
+
+        const size_t StrideAM = (TransA == CblasNoTrans) ? lda : 1;
+        const size_t StrideAK = (TransA == CblasNoTrans) ? 1 : lda;
+
+        //
+        // Step through slices of matrix B along the K dimension. The output
+        // accumulates the slices after the first one.
+        //
+
+        size_t CountK;
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = std::min(K - k, size_t(MLAS_SGEMM_SMALL_M_STRIDEK));
+
+            const float BetaSlice = (k == 0) ? beta : 1.0f;
+
+            for (size_t n = 0; n < N; n += 32) {
+
+                const size_t CountN = std::min(N - n, size_t(32));
+
+                MlasSgemmSmallMRowsAvx512F(M, CountN, CountK, alpha, A + k * StrideAK, StrideAM, StrideAK,
+                    B + k * ldb + n, ldb, 16, BetaSlice, C + n, ldc);
+            }
+        }
+
+    } else {
+
+        //
+        // Process groups of four rows of matrix B with the rows of matrix A in
+        // groups of four.
+        //
+
+        for (size_t n = 0; n < N; n += 4) {
+
+            const size_t ColumnCount = std::min(N - n, size_t(4));
+
+            for (size_t m = 0; m < M; m += 4) {
+
+                const size_t RowCount = std::min(M - m, size_t(4));
+
+                MlasSgemmSmallMTransposeBBlockTableAvx512F[RowCount - 1][ColumnCount - 1](
+                    K, alpha, A + m * lda, lda, B + n * ldb, ldb, beta, C + m * ldc + n, ldc);
+            }
+        }
+    }
+}
+
+void
+MLASCALL
+MlasSgemmSmallMPackedKernelAvx512F(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    size_t AlignedN,
+    float beta,
+    float* C,
+    size_t ldc
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the AVX512F kernel for the single precision
+    matrix/matrix multiply operation (SGEMM) with at most
+    MLAS_SGEMM_SMALL_M_MAXIMUM rows of matrix A and matrix B packed by
+    MlasGemmPackB.
+
+Arguments:
+
+    TransA - Supplies the transpose operation for matrix A.
+
+    M - Supplies the number of rows of matrix A and matrix C.
+
+    RangeStartN - Supplies the starting column from packed matrix B.
+
+    RangeCountN - Supplies the number of columns of matrix B and matrix C.
+
+    K - Supplies the number of columns of matrix A and the number of rows of
+        matrix B.
+
+    alpha - Supplies the scalar alpha multiplier (see SGEMM definition).
+
+    A - Supplies the address of matrix A.
+
+    lda - Supplies the first dimension of matrix A.
+
+    PackedB - Supplies the address of packed matrix B.
+
+    AlignedN - Supplies the total number of aligned columns for packed matrix B.
+
+    beta - Supplies the scalar beta multiplier (see SGEMM definition).
+
+    C - Supplies the address of matrix C.
+
+    ldc - Supplies the first dimension of matrix C.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t StrideAM = (TransA == CblasNoTrans) ? lda : 1;
+    const size_t StrideAK = (TransA == CblasNoTrans) ? 1 : lda;
+
+    //
+    // Step through the slices of packed matrix B along the K dimension. Each
+    // panel of 16 columns of a slice is contiguous.
+    //
+
+    size_t CountK;
+
+    for (size_t k = 0; k < K; k += CountK) {
+
+        CountK = std::min(K - k, size_t(MLAS_SGEMM_PACKED_STRIDEK));
+
+        const float* pb = (const float*)PackedB + AlignedN * k + CountK * RangeStartN;
+        const float BetaSlice = (k == 0) ? beta : 1.0f;
+
+        for (size_t n = 0; n < RangeCountN; n += 32) {
+
+            const size_t CountN = std::min(RangeCountN - n, size_t(32));
+
+            MlasSgemmSmallMRowsAvx512F(M, CountN, CountK, alpha, A + k * StrideAK, StrideAM, StrideAK,
+                pb + n * CountK, 16, 16 * CountK, BetaSlice, C + n, ldc);
+        }
+    }
+}
@@ -0,0 +1,418 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    layernorm.cpp
+
+Abstract:
+
+    This module implements routines to compute layer normalization, optionally
+    fused with the skip and bias additions of SkipLayerNormalization.
+
+    A row is read once to form X = Input + Skip + Bias and to accumulate the
+    sum and the sum of squares of X minus its first element, which keeps the
+    one pass variance accurate when the mean is large, then once more to
+    normalize it:
+
+        Output = (X - Mean) * InvStdDev * Scale + Shift
+
+    When anything is added to the input, X is staged in SkipOutput or else in
+    Output, so the second pass does not recompute the additions.
+
+--*/
+
+#include "mlasi.h"
+
+void
+MLASCALL
+MlasLayerNormF32Kernel(
+    const MLAS_LAYER_NORM_PARAMS<float>* Params,
+    size_t StartRow,
+    size_t CountRow
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel for layer normalization.
+
+Arguments:
+
+    Params - Supplies the parameters of the operation.
+
+    StartRow - Supplies the index of the first row to process.
+
+    CountRow - Supplies the number of rows to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t D = Params->RowSize;
+    const float* Bias = Params->Bias;
+    const float* Scale = Params->Scale;
+    const float* Shift = Params->Shift;
+
+    for (size_t Row = StartRow; Row < StartRow + CountRow; Row++) {
+
+        const float* Input = Params->Input + Row * D;
+        const float* Skip = (Params->Skip != nullptr) ? Params->Skip + Row * D : nullptr;
+        float* Output = Params->Output + Row * D;
+        float* Staged = MlasLayerNormStagingBuffer(Params, Row);
+        const float Offset = MlasLayerNormOffset(Params, Row);
+        const MLAS_FLOAT32X4 OffsetVector = MlasBroadcastFloat32x4(Offset);
+
+        MLAS_FLOAT32X4 SumVector0 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 SumVector1 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 SumSquaresVector0 = MlasZeroFloat32x4();
+        MLAS_FLOAT32X4 SumSquaresVector1 = MlasZeroFloat32x4();
+
+        size_t d = 0;
+
+        for (; d + 8 <= D; d += 8) {
+
+            MLAS_FLOAT32X4 Vector0 = MlasLoadFloat32x4(Input + d);
+            MLAS_FLOAT32X4 Vector1 = MlasLoadFloat32x4(Input + d + 4);
+
+            if (Skip != nullptr) {
+                Vector0 = MlasAddFloat32x4(Vector0, MlasLoadFloat32x4(Skip + d));
+                Vector1 = MlasAddFloat32x4(Vector1, MlasLoadFloat32x4(Skip + d + 4));
+            }
+
+            if (Bias != nullptr) {
+                Vector0 = MlasAddFloat32x4(Vector0, MlasLoadFloat32x4(Bias + d));
+                Vector1 = MlasAddFloat32x4(Vector1, MlasLoadFloat32x4(Bias + d + 4));
+            }
+
+            if (Staged != nullptr) {
+                MlasStoreFloat32x4(Staged + d, Vector0);
+                MlasStoreFloat32x4(Staged + d + 4, Vector1);
+            }
+
+            Vector0 = MlasSubtractFloat32x4(Vector0, OffsetVector);
+            Vector1 = MlasSubtractFloat32x4(Vector1, OffsetVector);
+
+            SumVector0 = MlasAddFloat32x4(SumVector0, Vector0);
+            SumVector1 = MlasAddFloat32x4(SumVector1, Vector1);
+            SumSquaresVector0 = MlasMultiplyAddFloat32x4(Vector0, Vector0, SumSquaresVector0);
+            SumSquaresVector1 = MlasMultiplyAddFloat32x4(Vector1, Vector1, SumSquaresVector1);
+        }
+
+        for (; d + 4 <= D; d += 4) {
+
+            MLAS_FLOAT32X4 Vector = MlasLoadFloat32x4(Input + d);
+
+            if (Skip != nullptr) {
+                Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(Skip + d));
+            }
+
+            if (Bias != nullptr) {
+                Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(Bias + d));
+            }
+
+            if (Staged != nullptr) {
+                MlasStoreFloat32x4(Staged + d, Vector);
+            }
+
+            Vector = MlasSubtractFloat32x4(Vector, OffsetVector);
+
+            SumVector0 = MlasAddFloat32x4(SumVector0, Vector);
+            SumSquaresVector0 = MlasMultiplyAddFloat32x4(Vector, Vector, SumSquaresVector0);
+        }
+
+        float Sum = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumVector0, SumVector1));
+        float SumSquares = MlasReduceAddFloat32x4(MlasAddFloat32x4(SumSquaresVector0, SumSquaresVector1));
+
+        for (; d < D; d++) {
+
+            float Value = Input[d];
+
+            if (Skip != nullptr) {
+                Value += Skip[d];
+            }
+
+            if (Bias != nullptr) {
+                Value += Bias[d];
+            }
+
+            if (Staged != nullptr) {
+                Staged[d] = Value;
+            }
+
+            Value -= Offset;
+
+            Sum += Value;
+            SumSquares += Value * Value;
+        }
+
+        float Mean;
+        float InvStdDev;
+
+        MlasLayerNormComputeStatistics(Params, Row, Offset, Sum, SumSquares, &Mean, &InvStdDev);
+
+        //
+        // Output = X * InvStdDev - Mean * InvStdDev, then scale and shift.
+        //
+
+        const float* X = (Staged != nullptr) ? Staged : Input;
+
+        MLAS_FLOAT32X4 InvStdDevVector = MlasBroadcastFloat32x4(InvStdDev);
+        MLAS_FLOAT32X4 NegativeMeanVector = MlasBroadcastFloat32x4(-Mean * InvStdDev);
+
+        d = 0;
+
+        for (; d + 4 <= D; d += 4) {
+
+            MLAS_FLOAT32X4 Vector = MlasMultiplyAddFloat32x4(MlasLoadFloat32x4(X + d), InvStdDevVector, NegativeMeanVector);
+            Vector = MlasMultiplyFloat32x4(Vector, MlasLoadFloat32x4(Scale + d));
+
+            if (Shift != nullptr) {
+                Vector = MlasAddFloat32x4(Vector, MlasLoadFloat32x4(Shift + d));
+            }
+
+            MlasStoreFloat32x4(Output + d, Vector);
+        }
+
+        for (; d < D; d++) {
+
+            float Value = (X[d] * InvStdDev - Mean * InvStdDev) * Scale[d];
+
+            if (Shift != nullptr) {
+                Value += Shift[d];
+            }
+
+            Output[d] = Value;
+        }
+    }
+}
+
+MLAS_FORCEINLINE
+void
+MlasLayerNormRowsF32(
+    const MLAS_LAYER_NORM_PARAMS<float>* Params,
+    size_t StartRow,
+    size_t CountRow
+    )
+{
+#if defined(MLAS_TARGET_AMD64)
+    GetMlasPlatform().LayerNormF32Kernel(Params, StartRow, CountRow);
+#else
+    MlasLayerNormF32Kernel(Params, StartRow, CountRow);
+#endif
+}
+
+MLAS_FORCEINLINE
+void
+MlasLayerNormConvertHalfToFloat(
+    const MLAS_FP16* Source,
+    float* Destination,
+    size_t Count
+    )
+{
+#if defined(_M_AMD64) && !defined(_M_ARM64EC)
+    MlasConvertHalfToFloatBuffer(reinterpret_cast<const unsigned short*>(Source), Destination, Count);
+#else
+    for (size_t i = 0; i < Count; i++) {
+        Destination[i] = MLAS_Half2Float(Source[i].val);
+    }
+#endif
+}
+
+MLAS_FORCEINLINE
+void
+MlasLayerNormRows(
+    const MLAS_LAYER_NORM_PARAMS<float>* Params,
+    size_t StartRow,
+    size_t CountRow
+    )
+{
+    MlasLayerNormRowsF32(Params, StartRow, CountRow);
+}
+
+static
+void
+MlasLayerNormRows(
+    const MLAS_LAYER_NORM_PARAMS<MLAS_FP16>* Params,
+    size_t StartRow,
+    size_t CountRow
+    )
+/*++
+
+Routine Description:
+
+    This routine normalizes half precision rows by converting one row at a
+    time to float in the thread local buffer.
+
+Arguments:
+
+    Params - Supplies the parameters of the operation.
+
+    StartRow - Supplies the index of the first row to process.
+
+    CountRow - Supplies the number of rows to process.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t D = Params->RowSize;
+
+    //
+    // The buffer holds the converted bias, scale and shift, which are shared
+    // by all rows, followed by the input, skip, output and skip output rows.
+    //
+
+    MlasThreadedBufAlloc(7 * D * sizeof(float));
+    float* Bias = reinterpret_cast<float*>(ThreadedBufHolder.get());
+    float* Scale = Bias + D;
+    float* Shift = Scale + D;
+    float* Input = Shift + D;
+    float* Skip = Input + D;
+    float* Output = Skip + D;
+    float* SkipOutput = Output + D;
+
+    MLAS_LAYER_NORM_PARAMS<float> RowParams;
+    RowParams.RowCount = 1;
+    RowParams.RowSize = D;
+    RowParams.Epsilon = Params->Epsilon;
+    RowParams.Simplified = Params->Simplified;
+    RowParams.Input = Input;
+    RowParams.Scale = Scale;
+    RowParams.Output = Output;
+
+    if (Params->Skip != nullptr) {
+        RowParams.Skip = Skip;
+    }
+
+    if (Params->Bias != nullptr) {
+        MlasLayerNormConvertHalfToFloat(Params->Bias, Bias, D);
+        RowParams.Bias = Bias;
+    }
+
+    MlasLayerNormConvertHalfToFloat(Params->Scale, Scale, D);
+
+    if (Params->Shift != nullptr) {
+        MlasLayerNormConvertHalfToFloat(Params->Shift, Shift, D);
+        RowParams.Shift = Shift;
+    }
+
+    if (Params->SkipOutput != nullptr) {
+        RowParams.SkipOutput = SkipOutput;
+    }
+
+    for (size_t Row = StartRow; Row < StartRow + CountRow; Row++) {
+
+        MlasLayerNormConvertHalfToFloat(Params->Input + Row * D, Input, D);
+
+        if (Params->Skip != nullptr) {
+            MlasLayerNormConvertHalfToFloat(Params->Skip + Row * D, Skip, D);
+        }
+
+        RowParams.Mean = (Params->Mean != nullptr) ? Params->Mean + Row : nullptr;
+        RowParams.InvStdDev = (Params->InvStdDev != nullptr) ? Params->InvStdDev + Row : nullptr;
+
+        MlasLayerNormRowsF32(&RowParams, 0, 1);
+
+        MLAS_FP16* RowOutput = Params->Output + Row * D;
+
+        for (size_t d = 0; d < D; d++) {
+            RowOutput[d] = MLAS_FP16(Output[d]);
+        }
+
+        if (Params->SkipOutput != nullptr) {
+
+            MLAS_FP16* RowSkipOutput = Params->SkipOutput + Row * D;
+
+            for (size_t d = 0; d < D; d++) {
+                RowSkipOutput[d] = MLAS_FP16(SkipOutput[d]);
+            }
+        }
+    }
+}
+
+template <typename T>
+void
+MLASCALL
+MlasLayerNorm(
+    const MLAS_LAYER_NORM_PARAMS<T>* Params,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine normalizes the rows of the input, see the description of
+    MLAS_LAYER_NORM_PARAMS.
+
+Arguments:
+
+    Params - Supplies the parameters of the operation.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    const size_t N = Params->RowCount;
+
+    if (N == 0) {
+        return;
+    }
+
+    //
+    // Limit the number of threads to the number of rows and keep each thread
+    // processing a minimum number of elements before using another thread.
+    //
+
+    constexpr size_t MinimumElementsPerThread = 16384;
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t((N * Params->RowSize) / MinimumElementsPerThread) + 1;
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+    if (size_t(TargetThreadCount) > N) {
+        TargetThreadCount = ptrdiff_t(N);
+    }
+
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+
+        size_t StartRow;
+        size_t CountRow;
+
+        MlasPartitionWork(tid, TargetThreadCount, N, &StartRow, &CountRow);
+
+        if (CountRow > 0) {
+            MlasLayerNormRows(Params, StartRow, CountRow);
+        }
+    });
+}
+
+template
+void
+MLASCALL
+MlasLayerNorm<float>(
+    const MLAS_LAYER_NORM_PARAMS<float>* Params,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+template
+void
+MLASCALL
+MlasLayerNorm<MLAS_FP16>(
+    const MLAS_LAYER_NORM_PARAMS<MLAS_FP16>* Params,
+    MLAS_THREADPOOL* ThreadPool
+    );
@@ -297,6 +297,15 @@ static_assert(sizeof(MLAS_FP16) == FP16_SIZE);
 //
 
 #define MLAS_SGEMM_STRIDEN_THREAD_ALIGN             16
+
+//
+// Define the maximum number of rows of matrix A handled by the SGEMM kernels
+// that stream matrix B, and the number of rows of matrix B in a slice read
+// by these kernels when matrix B is not packed.
+//
+
+#define MLAS_SGEMM_SMALL_M_MAXIMUM                  8
+#define MLAS_SGEMM_SMALL_M_STRIDEK                  32
 #define MLAS_DGEMM_STRIDEN_THREAD_ALIGN             8
 #define MLAS_QGEMM_STRIDEN_THREAD_ALIGN             16
 
@@ -392,6 +401,42 @@ void
     float beta
     );
 
+typedef
+void
+(MLASCALL MLAS_SGEMM_SMALL_M_KERNEL)(
+    CBLAS_TRANSPOSE TransA,
+    CBLAS_TRANSPOSE TransB,
+    size_t M,
+    size_t N,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const float* B,
+    size_t ldb,
+    float beta,
+    float* C,
+    size_t ldc
+    );
+
+typedef
+void
+(MLASCALL MLAS_SGEMM_SMALL_M_PACKED_KERNEL)(
+    CBLAS_TRANSPOSE TransA,
+    size_t M,
+    size_t RangeStartN,
+    size_t RangeCountN,
+    size_t K,
+    float alpha,
+    const float* A,
+    size_t lda,
+    const void* PackedB,
+    size_t AlignedN,
+    float beta,
+    float* C,
+    size_t ldc
+    );
+
 typedef
 void
 (MLASCALL MLAS_SGEMM_TRANSPOSE_PACKB_BLOCK_ROUTINE)(
@@ -574,6 +619,35 @@ void
     size_t N
     );
 
+typedef
+void
+(MLASCALL MLAS_REDUCE_ROWS_FLOAT_KERNEL)(
+    MLAS_REDUCTION_KIND Kind,
+    const float* Input,
+    float* Output,
+    size_t RowCount,
+    size_t RowSize
+    );
+
+typedef
+void
+(MLASCALL MLAS_REDUCE_COLUMNS_FLOAT_KERNEL)(
+    MLAS_REDUCTION_KIND Kind,
+    const float* Input,
+    float* Output,
+    size_t ReduceCount,
+    size_t ColumnCount,
+    size_t ldInput
+    );
+
+typedef
+void
+(MLASCALL MLAS_LAYER_NORM_FLOAT_KERNEL)(
+    const MLAS_LAYER_NORM_PARAMS<float>* Params,
+    size_t StartRow,
+    size_t CountRow
+    );
+
 typedef
 void
 (MLASCALL MLAS_QLINEAR_BINARY_OP_S8_KERNEL)(
@@ -673,6 +747,9 @@ extern "C" {
 #if defined(MLAS_TARGET_AMD64)
     MLAS_SGEMM_KERNEL_M1_ROUTINE MlasSgemmKernelM1Avx;
     MLAS_SGEMM_KERNEL_M1_ROUTINE MlasSgemmKernelM1TransposeBAvx;
+    MLAS_SGEMM_SMALL_M_KERNEL MlasSgemmSmallMKernelAvx2;
+    MLAS_SGEMM_SMALL_M_KERNEL MlasSgemmSmallMKernelAvx512F;
+    MLAS_SGEMM_SMALL_M_PACKED_KERNEL MlasSgemmSmallMPackedKernelAvx512F;
 #elif defined(MLAS_TARGET_ARM64) || defined(MLAS_TARGET_WASM)
     MLAS_GEMV_FLOAT_KERNEL MlasGemvFloatKernel;
 #endif
@@ -765,6 +842,21 @@ extern "C" {
     MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL MlasReduceMinimumMaximumF32KernelAvx;
 #endif
 
+    MLAS_LAYER_NORM_FLOAT_KERNEL MlasLayerNormF32Kernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_LAYER_NORM_FLOAT_KERNEL MlasLayerNormF32KernelAvx2;
+    MLAS_LAYER_NORM_FLOAT_KERNEL MlasLayerNormF32KernelAvx512F;
+#endif
+
+    MLAS_REDUCE_ROWS_FLOAT_KERNEL MlasReduceRowsF32Kernel;
+    MLAS_REDUCE_COLUMNS_FLOAT_KERNEL MlasReduceColumnsF32Kernel;
+#if defined(MLAS_TARGET_AMD64)
+    MLAS_REDUCE_ROWS_FLOAT_KERNEL MlasReduceRowsF32KernelAvx2;
+    MLAS_REDUCE_ROWS_FLOAT_KERNEL MlasReduceRowsF32KernelAvx512F;
+    MLAS_REDUCE_COLUMNS_FLOAT_KERNEL MlasReduceColumnsF32KernelAvx2;
+    MLAS_REDUCE_COLUMNS_FLOAT_KERNEL MlasReduceColumnsF32KernelAvx512F;
+#endif
+
 }
 
 //
@@ -857,6 +949,35 @@ extern const MLAS_CONV_SYM_DISPATCH MlasConvSymS8DispatchNeon;
 extern const MLAS_CONV_SYM_DISPATCH MlasConvSymU8DispatchDot;
 extern const MLAS_CONV_SYM_DISPATCH MlasConvSymS8DispatchDot;
 
+//
+// Half precision gemm dispatch structure.
+//
+
+struct MLAS_HALFGEMM_DISPATCH;
+
+extern const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx2;
+extern const MLAS_HALFGEMM_DISPATCH MlasHalfGemmDispatchAvx512Fp16;
+
+//
+// BFloat16 gemm dispatch structure.
+//
+
+struct MLAS_BF16GEMM_DISPATCH;
+
+extern const MLAS_BF16GEMM_DISPATCH MlasBf16GemmDispatchAvx2;
+extern const MLAS_BF16GEMM_DISPATCH MlasBf16GemmDispatchAvx512Bf16;
+extern const MLAS_BF16GEMM_DISPATCH MlasBf16GemmDispatchAmx;
+
+//
+// Block-wise 4-bit quantized gemm dispatch structure.
+//
+
+struct MLAS_Q4BIT_GEMM_DISPATCH;
+
+extern const MLAS_Q4BIT_GEMM_DISPATCH MlasQ4BitGemmDispatchAvx2;
+extern const MLAS_Q4BIT_GEMM_DISPATCH MlasQ4BitGemmDispatchAvx512;
+extern const MLAS_Q4BIT_GEMM_DISPATCH MlasQ4BitGemmDispatchAvx512Vnni;
+
 //
 // Quantized depthwise convolution kernels.
 //
@@ -948,6 +1069,8 @@ struct MLAS_PLATFORM {
 #if defined(MLAS_TARGET_AMD64)
     MLAS_SGEMM_KERNEL_M1_ROUTINE* KernelM1Routine;
     MLAS_SGEMM_KERNEL_M1_ROUTINE* KernelM1TransposeBRoutine;
+    MLAS_SGEMM_SMALL_M_KERNEL* SgemmSmallMKernel;
+    MLAS_SGEMM_SMALL_M_PACKED_KERNEL* SgemmSmallMPackedKernel;
     MLAS_SGEMM_TRANSPOSE_PACKB_BLOCK_ROUTINE* TransposePackB16x4Routine;
     MLAS_GEMM_DOUBLE_KERNEL* GemmDoubleKernel;
     MLAS_GEMM_U8S8_KERNEL* GemmU8S8Kernel;
@@ -969,8 +1092,14 @@ struct MLAS_PLATFORM {
     MLAS_COMPUTE_LOGSOFTMAX_OUTPUT_FLOAT_KERNEL* ComputeLogSoftmaxOutputF32Kernel;
     MLAS_REDUCE_MAXIMUM_FLOAT_KERNEL* ReduceMaximumF32Kernel;
     MLAS_REDUCE_MINIMUM_MAXIMUM_FLOAT_KERNEL* ReduceMinimumMaximumF32Kernel;
+    MLAS_LAYER_NORM_FLOAT_KERNEL* LayerNormF32Kernel;
+    MLAS_REDUCE_ROWS_FLOAT_KERNEL* ReduceRowsF32Kernel;
+    MLAS_REDUCE_COLUMNS_FLOAT_KERNEL* ReduceColumnsF32Kernel;
     MLAS_QUANTIZE_LINEAR_S8_KERNEL* QuantizeLinearS8Kernel;
     MLAS_QUANTIZE_LINEAR_U8_KERNEL* QuantizeLinearU8Kernel;
+    const MLAS_HALFGEMM_DISPATCH* HalfGemmDispatch{nullptr};
+    const MLAS_BF16GEMM_DISPATCH* Bf16GemmDispatch{nullptr};
+    const MLAS_Q4BIT_GEMM_DISPATCH* Q4BitGemmDispatch{nullptr};
     uint32_t NchwcBlockSize;
     uint32_t PreferredBufferAlignment;
     int32_t MaximumThreadCount;
@@ -1064,6 +1193,55 @@ MlasPartitionWork(
     }
 }
 
+//
+// Templates to ensure that a loop is unrolled.
+//
+
+template<size_t Count, size_t Index>
+struct MlasLoopUnrollStep
+{
+    template<typename IterationType, typename... IterationArgs>
+    MLAS_FORCEINLINE
+    static
+    void
+    Step(
+        IterationArgs&&... Arguments
+        )
+    {
+        IterationType::template Iteration<Count, Index>(Arguments...);
+        MlasLoopUnrollStep<Count, Index + 1>::template Step<IterationType>(Arguments...);
+    }
+};
+
+template<size_t Count>
+struct MlasLoopUnrollStep<Count, Count>
+{
+    template<typename IterationType, typename... IterationArgs>
+    MLAS_FORCEINLINE
+    static
+    void
+    Step(
+        IterationArgs&&...
+        )
+    {
+        // Terminate the loop.
+    }
+};
+
+template<size_t Count, typename IteratorType>
+struct MlasLoopUnroll
+{
+    template<typename... IterationArgs>
+    MLAS_FORCEINLINE
+    void
+    operator()(
+        IterationArgs&&... Arguments
+        )
+    {
+        MlasLoopUnrollStep<Count, 0>::template Step<IteratorType>(Arguments...);
+    }
+};
+
 //
 // Define the minimum floating point value (and its bit value equivalent) that
 // has no fractional bits. This number can be used for fast rounding of floating
@@ -1113,6 +1291,28 @@ MlasFp32FromBits(
 #pragma warning(pop)
 #endif
 
+//
+// Winograd convolution routines.
+//
+
+bool
+MlasConvWinogradTryPrepare(
+    MLAS_CONV_PARAMETERS* Parameters,
+    size_t* WorkingBufferSize,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
+void
+MlasConvWinograd(
+    const MLAS_CONV_PARAMETERS* Parameters,
+    const float* Input,
+    const float* PackedFilter,
+    const float* Bias,
+    float* WorkingBuffer,
+    float* Output,
+    MLAS_THREADPOOL* ThreadPool
+    );
+
 #if defined(MLAS_TARGET_WASM_SCALAR)
 
 void
@@ -2155,6 +2355,112 @@ MlasReadTimeStampCounter(void)
 #endif
 }
 
+//
+// Layer normalization helpers shared by the kernels.
+//
+
+MLAS_FORCEINLINE
+float*
+MlasLayerNormStagingBuffer(
+    const MLAS_LAYER_NORM_PARAMS<float>* Params,
+    size_t Row
+    )
+{
+    //
+    // Returns the row that holds X = Input + Skip + Bias for the second pass,
+    // or nullptr when X is the input itself.
+    //
+
+    const size_t D = Params->RowSize;
+
+    if (Params->SkipOutput != nullptr) {
+        return Params->SkipOutput + Row * D;
+    }
+
+    if (Params->Skip != nullptr || Params->Bias != nullptr) {
+        return Params->Output + Row * D;
+    }
+
+    return nullptr;
+}
+
+MLAS_FORCEINLINE
+float
+MlasLayerNormOffset(
+    const MLAS_LAYER_NORM_PARAMS<float>* Params,
+    size_t Row
+    )
+{
+    //
+    // Returns the value subtracted from X before accumulating the sums. Using
+    // the first element of the row avoids the cancellation of the one pass
+    // variance when the mean is large compared to the deviation. The
+    // simplified normalization does not subtract the mean, so no offset is
+    // used.
+    //
+
+    const size_t D = Params->RowSize;
+
+    if (Params->Simplified || D == 0) {
+        return 0.0f;
+    }
+
+    float Offset = Params->Input[Row * D];
+
+    if (Params->Skip != nullptr) {
+        Offset += Params->Skip[Row * D];
+    }
+
+    if (Params->Bias != nullptr) {
+        Offset += Params->Bias[0];
+    }
+
+    return Offset;
+}
+
+MLAS_FORCEINLINE
+void
+MlasLayerNormComputeStatistics(
+    const MLAS_LAYER_NORM_PARAMS<float>* Params,
+    size_t Row,
+    float Offset,
+    float Sum,
+    float SumSquares,
+    float* Mean,
+    float* InvStdDev
+    )
+{
+    //
+    // Returns the mean to subtract, which is zero for the simplified
+    // normalization, and the inverse standard deviation of a row given the
+    // sums of X - Offset. The variance is clamped as rounding can still make
+    // it slightly negative.
+    //
+
+    const float D = float(Params->RowSize);
+    const float OffsetMean = Sum / D;
+    const float RowMean = Offset + OffsetMean;
+    float Variance;
+
+    if (Params->Simplified) {
+        *Mean = 0.0f;
+        Variance = SumSquares / D;
+    } else {
+        *Mean = RowMean;
+        Variance = std::max(SumSquares / D - OffsetMean * OffsetMean, 0.0f);
+    }
+
+    *InvStdDev = 1.0f / std::sqrt(Variance + Params->Epsilon);
+
+    if (Params->Mean != nullptr) {
+        Params->Mean[Row] = RowMean;
+    }
+
+    if (Params->InvStdDev != nullptr) {
+        Params->InvStdDev[Row] = *InvStdDev;
+    }
+}
+
 //
 // Aligned buffer for GEMM packing, etc.
 //
@@ -226,6 +226,9 @@ Return Value:
     this->ComputeLogSoftmaxOutputF32Kernel = MlasComputeLogSoftmaxOutputF32Kernel;
     this->ReduceMaximumF32Kernel = MlasReduceMaximumF32Kernel;
     this->ReduceMinimumMaximumF32Kernel = MlasReduceMinimumMaximumF32Kernel;
+    this->LayerNormF32Kernel = MlasLayerNormF32Kernel;
+    this->ReduceRowsF32Kernel = MlasReduceRowsF32Kernel;
+    this->ReduceColumnsF32Kernel = MlasReduceColumnsF32Kernel;
     this->QLinearAddS8Kernel = MlasQLinearAddS8Kernel;
     this->QLinearAddU8Kernel = MlasQLinearAddU8Kernel;
     this->QuantizeLinearS8Kernel = MlasQuantizeLinearS8Kernel;
@@ -329,6 +332,22 @@ Return Value:
                 this->ConvDepthwiseS8S8Kernel = MlasConvDepthwiseKernelAvx2<int8_t, int8_t>;
                 this->ConvDepthwiseS8U8Kernel = MlasConvDepthwiseKernelAvx2<int8_t, uint8_t>;
                 this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelFma3;
+                this->LayerNormF32Kernel = MlasLayerNormF32KernelAvx2;
+                this->ReduceRowsF32Kernel = MlasReduceRowsF32KernelAvx2;
+                this->ReduceColumnsF32Kernel = MlasReduceColumnsF32KernelAvx2;
+                this->SgemmSmallMKernel = MlasSgemmSmallMKernelAvx2;
+
+                //
+                // Check if the processor supports F16C features for the half
+                // precision GEMM kernel.
+                //
+
+                if ((Cpuid1[2] & 0x20000000) != 0) {
+                    this->HalfGemmDispatch = &MlasHalfGemmDispatchAvx2;
+                }
+
+                this->Bf16GemmDispatch = &MlasBf16GemmDispatchAvx2;
+                this->Q4BitGemmDispatch = &MlasQ4BitGemmDispatchAvx2;
 
                 //
                 // Check if the processor supports Hybrid core architecture.
@@ -377,6 +396,11 @@ Return Value:
                     this->PoolFloatKernel[MlasAveragePoolingIncludePad] = MlasPoolAverageIncludePadFloatKernelAvx512F;
                     this->ComputeExpF32Kernel = MlasComputeExpF32KernelAvx512F;
                     this->ComputeSumExpF32Kernel = MlasComputeSumExpF32KernelAvx512F;
+                    this->LayerNormF32Kernel = MlasLayerNormF32KernelAvx512F;
+                    this->ReduceRowsF32Kernel = MlasReduceRowsF32KernelAvx512F;
+                    this->ReduceColumnsF32Kernel = MlasReduceColumnsF32KernelAvx512F;
+                    this->SgemmSmallMKernel = MlasSgemmSmallMKernelAvx512F;
+                    this->SgemmSmallMPackedKernel = MlasSgemmSmallMPackedKernelAvx512F;
                     this->QuantizeLinearS8Kernel = MlasQuantizeLinearS8KernelAvx512F;
                     this->QuantizeLinearU8Kernel = MlasQuantizeLinearU8KernelAvx512F;
                     this->NchwcBlockSize = 16;
@@ -393,6 +417,7 @@ Return Value:
                         this->GemvU8S8Kernel = MlasGemvU8S8KernelAvx512Core;
                         this->GemmU8U8Kernel = MlasGemmU8U8KernelAvx512Core;
                         this->ConvSymU8S8Dispatch = &MlasConvSymDispatchAvx512Core;
+                        this->Q4BitGemmDispatch = &MlasQ4BitGemmDispatchAvx512;
 
                         //
                         // Check if the processor supports AVX512VNNI.
@@ -404,7 +429,28 @@ Return Value:
                             this->GemmU8S8Kernel = MlasGemmU8S8KernelAvx512Vnni;
                             this->GemvU8S8Kernel = MlasGemvU8S8KernelAvx512Vnni;
                             this->ConvSymU8S8Dispatch = &MlasConvSymDispatchAvx512Vnni;
+                            this->Q4BitGemmDispatch = &MlasQ4BitGemmDispatchAvx512Vnni;
                         }
+
+#ifdef MLAS_AVX512FP16_SUPPORTED
+                        //
+                        // Check if the processor supports AVX512-FP16.
+                        //
+
+                        if ((Cpuid7[3] & 0x800000) != 0) {
+                            this->HalfGemmDispatch = &MlasHalfGemmDispatchAvx512Fp16;
+                        }
+#endif // MLAS_AVX512FP16_SUPPORTED
+
+#ifdef MLAS_AMX_SUPPORTED
+                        //
+                        // Check if the processor supports AVX512-BF16.
+                        //
+
+                        if ((Cpuid7_1[0] & 0x20) != 0) {
+                            this->Bf16GemmDispatch = &MlasBf16GemmDispatchAvx512Bf16;
+                        }
+#endif // MLAS_AMX_SUPPORTED
                     }
                 }
 
@@ -419,6 +465,16 @@ Return Value:
                         this->GemmU8S8Dispatch = &MlasGemmU8S8DispatchAmx;
                     }
                 }
+
+                //
+                // Check if the processor supports AMX-TILE and AMX-BF16
+                // features.
+                //
+                if ((Cpuid7[3] & 0b1 << 24) != 0 && (Cpuid7[3] & 0b1 << 22) != 0) {
+                    if (MlasInitAMX()) {
+                        this->Bf16GemmDispatch = &MlasBf16GemmDispatchAmx;
+                    }
+                }
 #endif // MLAS_AMX_SUPPORTED
 
 #endif // ORT_MINIMAL_BUILD
@@ -0,0 +1,550 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    q4bitgemm.cpp
+
+Abstract:
+
+    This module implements the matrix multiply of fp32 A with block-wise
+    4-bit quantized B.
+
+    Small M is computed by platform kernels that read the packed 4-bit data
+    directly and dequantize it in registers, which keeps the memory traffic
+    of B at half a byte per element. For the int8 compute type, the rows of A
+    are first quantized per block into the workspace.
+
+    Larger M dequantizes tiles of B into a thread local buffer and uses the
+    single precision GEMM, where the cost of dequantization is amortized over
+    the rows of A.
+
+--*/
+
+#include "q4bitgemm.h"
+
+//
+// Rows of A up to which the register dequantizing kernels are used for the
+// fp32 compute type.
+//
+
+constexpr size_t MLAS_Q4BIT_GEMM_SMALL_M = 8;
+
+//
+// Tile of B dequantized at a time when falling back to SGEMM. StrideK is a
+// multiple of every supported block length.
+//
+
+constexpr size_t MLAS_Q4BIT_GEMM_STRIDEN = 128;
+constexpr size_t MLAS_Q4BIT_GEMM_STRIDEK = 1024;
+
+static
+bool
+MlasQ4BitGemmIsValidBlkLen(
+    size_t BlkLen
+    )
+{
+    return BlkLen >= MLAS_Q4BIT_GEMM_MIN_BLKLEN && BlkLen <= MLAS_Q4BIT_GEMM_MAX_BLKLEN &&
+           (BlkLen & (BlkLen - 1)) == 0;
+}
+
+static
+bool
+MlasQ4BitGemmUseInt8(
+    const MLAS_Q4BIT_GEMM_DISPATCH* Dispatch,
+    size_t BlkLen,
+    MLAS_Q4BIT_COMPUTE_TYPE ComputeType
+    )
+{
+    return ComputeType == MlasQ4BitCompInt8 && Dispatch->Int8Kernel != nullptr && BlkLen % 32 == 0;
+}
+
+/**
+ * @brief Layout of the quantized A of one GEMM inside the workspace.
+ */
+struct MLAS_Q4BIT_QUANT_A_LAYOUT {
+    size_t DataSize;
+    size_t ScaleSize;
+    size_t GemmSize;
+
+    MLAS_Q4BIT_QUANT_A_LAYOUT(size_t M, size_t K, size_t BlkLen)
+    {
+        const size_t BlockCountK = MlasQ4BitBlockCountK(K, BlkLen);
+        const size_t Alignment = MlasGetPreferredBufferAlignment();
+
+        DataSize = (M * BlockCountK * BlkLen + Alignment - 1) & ~(Alignment - 1);
+        ScaleSize = (M * BlockCountK * sizeof(float) + Alignment - 1) & ~(Alignment - 1);
+        GemmSize = DataSize + 2 * ScaleSize;
+    }
+};
+
+/**
+ * @brief Quantize rows of A per block to symmetric int8.
+ */
+static
+void
+MlasQ4BitGemmQuantizeA(
+    size_t BlkLen,
+    const float* A,
+    size_t lda,
+    size_t CountM,
+    size_t CountK,
+    int8_t* QuantAData,
+    float* QuantAScale,
+    float* QuantAScaledSum
+    )
+{
+    const size_t BlockCountK = MlasQ4BitBlockCountK(CountK, BlkLen);
+
+    for (size_t m = 0; m < CountM; m++) {
+
+        const float* a = A + m * lda;
+
+        for (size_t blk = 0; blk < BlockCountK; blk++) {
+
+            const size_t k = blk * BlkLen;
+            const size_t len = std::min(CountK - k, BlkLen);
+
+            float amax = 0.0f;
+            for (size_t kk = 0; kk < len; kk++) {
+                amax = std::max(amax, std::fabs(a[k + kk]));
+            }
+
+            const float scale = amax / 127.0f;
+            const float inverse_scale = (amax != 0.0f) ? 127.0f / amax : 0.0f;
+
+            int32_t sum = 0;
+            for (size_t kk = 0; kk < len; kk++) {
+                const int32_t q = static_cast<int32_t>(std::nearbyintf(a[k + kk] * inverse_scale));
+                QuantAData[kk] = static_cast<int8_t>(q);
+                sum += q;
+            }
+            std::fill_n(QuantAData + len, BlkLen - len, int8_t(0));
+
+            QuantAData += BlkLen;
+            *QuantAScale++ = scale;
+            *QuantAScaledSum++ = scale * static_cast<float>(sum);
+        }
+    }
+}
+
+/**
+ * @brief Dequantize the blocks of CountN columns of B covering
+ *        [StartK, StartK + CountK) into D, one row of CountK elements per
+ *        column. StartK is a multiple of BlkLen.
+ */
+static
+void
+MlasQ4BitGemmDequantizeB(
+    size_t BlkLen,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    size_t CountN,
+    size_t StartK,
+    size_t CountK,
+    size_t BlockCountK,
+    float* D
+    )
+{
+    const size_t BlkDataSize = BlkLen / 2;
+    const size_t ZeroPointStride = MlasDivRoundup(BlockCountK, 2);
+    const size_t StartBlk = StartK / BlkLen;
+
+    for (size_t n = 0; n < CountN; n++) {
+
+        const uint8_t* b = QuantBData + n * BlockCountK * BlkDataSize;
+        const float* s = QuantBScale + n * BlockCountK;
+        const uint8_t* zp = (QuantBZeroPoint != nullptr) ? QuantBZeroPoint + n * ZeroPointStride : nullptr;
+
+        for (size_t k = 0; k < CountK; k += BlkLen) {
+
+            const size_t blk = StartBlk + k / BlkLen;
+            const size_t len = std::min(CountK - k, BlkLen);
+            const float scale = s[blk];
+            const float offset = -scale * float(MlasQ4BitZeroPoint(zp, blk));
+            const uint8_t* bb = b + blk * BlkDataSize;
+            float* d = D + k;
+
+            for (size_t kk = 0; kk < len; kk += 2) {
+                const uint8_t packed = bb[kk / 2];
+                d[kk] = float(packed & 0x0F) * scale + offset;
+                if (kk + 1 < len) {
+                    d[kk + 1] = float(packed >> 4) * scale + offset;
+                }
+            }
+        }
+
+        D += CountK;
+    }
+}
+
+/**
+ * @brief Compute the rectangle [RangeStartM, RangeStartM + RangeCountM) x
+ *        [RangeStartN, RangeStartN + RangeCountN) of one GEMM.
+ */
+static
+void
+MlasQ4BitGemmOperation(
+    const MLAS_Q4BIT_GEMM_DISPATCH* Dispatch,
+    bool UseInt8,
+    size_t M,
+    size_t K,
+    size_t BlkLen,
+    const MLAS_Q4BIT_GEMM_DATA_PARAMS* Data,
+    const uint8_t* QuantA,
+    size_t RangeStartM,
+    size_t RangeCountM,
+    size_t RangeStartN,
+    size_t RangeCountN
+    )
+{
+    const size_t BlockCountK = MlasQ4BitBlockCountK(K, BlkLen);
+    const size_t BlkDataSize = BlkLen / 2;
+    const size_t ZeroPointStride = MlasDivRoundup(BlockCountK, 2);
+
+    const uint8_t* QuantBData = Data->QuantBData + RangeStartN * BlockCountK * BlkDataSize;
+    const float* QuantBScale = Data->QuantBScale + RangeStartN * BlockCountK;
+    const uint8_t* QuantBZeroPoint = (Data->QuantBZeroPoint != nullptr)
+                                         ? Data->QuantBZeroPoint + RangeStartN * ZeroPointStride
+                                         : nullptr;
+    const float* Bias = (Data->Bias != nullptr) ? Data->Bias + RangeStartN : nullptr;
+    float* C = Data->C + RangeStartM * Data->ldc + RangeStartN;
+
+    if (UseInt8) {
+
+        const MLAS_Q4BIT_QUANT_A_LAYOUT Layout(M, K, BlkLen);
+        const int8_t* QuantAData = reinterpret_cast<const int8_t*>(QuantA) +
+                                   RangeStartM * BlockCountK * BlkLen;
+        const float* QuantAScale = reinterpret_cast<const float*>(QuantA + Layout.DataSize) +
+                                   RangeStartM * BlockCountK;
+        const float* QuantAScaledSum = reinterpret_cast<const float*>(QuantA + Layout.DataSize + Layout.ScaleSize) +
+                                       RangeStartM * BlockCountK;
+
+        size_t CountM;
+
+        for (size_t m = 0; m < RangeCountM; m += CountM) {
+
+            CountM = std::min(RangeCountM - m, MLAS_Q4BIT_GEMM_KERNEL_M);
+
+            Dispatch->Int8Kernel(BlkLen,
+                                 QuantAData + m * BlockCountK * BlkLen,
+                                 QuantAScale + m * BlockCountK,
+                                 QuantAScaledSum + m * BlockCountK,
+                                 QuantBData, QuantBScale, QuantBZeroPoint,
+                                 C + m * Data->ldc, Data->ldc, CountM, RangeCountN, BlockCountK, Bias);
+        }
+
+        return;
+    }
+
+    const float* A = Data->A + RangeStartM * Data->lda;
+
+    if (M <= MLAS_Q4BIT_GEMM_SMALL_M) {
+
+        size_t CountM;
+
+        for (size_t m = 0; m < RangeCountM; m += CountM) {
+
+            CountM = std::min(RangeCountM - m, MLAS_Q4BIT_GEMM_KERNEL_M);
+
+            Dispatch->Fp32Kernel(BlkLen, A + m * Data->lda, Data->lda,
+                                 QuantBData, QuantBScale, QuantBZeroPoint,
+                                 C + m * Data->ldc, Data->ldc, CountM, RangeCountN, K, BlockCountK, Bias);
+        }
+
+        return;
+    }
+
+    //
+    // Dequantize tiles of B and multiply with SGEMM, accumulating into C
+    // after the first tile of K.
+    //
+
+    MlasThreadedBufAlloc(MLAS_Q4BIT_GEMM_STRIDEN * MLAS_Q4BIT_GEMM_STRIDEK * sizeof(float));
+    float* PanelB = reinterpret_cast<float*>(ThreadedBufHolder.get());
+
+    size_t CountN;
+
+    for (size_t n = 0; n < RangeCountN; n += CountN) {
+
+        CountN = std::min(RangeCountN - n, MLAS_Q4BIT_GEMM_STRIDEN);
+
+        float beta = 0.0f;
+
+        if (Bias != nullptr) {
+            for (size_t m = 0; m < RangeCountM; m++) {
+                std::copy_n(Bias + n, CountN, C + m * Data->ldc + n);
+            }
+            beta = 1.0f;
+        }
+
+        size_t CountK;
+
+        for (size_t k = 0; k < K; k += CountK) {
+
+            CountK = std::min(K - k, MLAS_Q4BIT_GEMM_STRIDEK);
+
+            MlasQ4BitGemmDequantizeB(BlkLen,
+                                     QuantBData + n * BlockCountK * BlkDataSize,
+                                     QuantBScale + n * BlockCountK,
+                                     (QuantBZeroPoint != nullptr) ? QuantBZeroPoint + n * ZeroPointStride : nullptr,
+                                     CountN, k, CountK, BlockCountK, PanelB);
+
+            MlasGemm(CblasNoTrans, CblasTrans, RangeCountM, CountN, CountK,
+                     1.0f, A + k, Data->lda, PanelB, CountK,
+                     beta, C + n, Data->ldc, nullptr);
+
+            beta = 1.0f;
+        }
+    }
+}
+
+void
+MLASCALL
+MlasQ4BitGemmBatch(
+    size_t M,
+    size_t N,
+    size_t K,
+    size_t BatchN,
+    size_t BlkLen,
+    MLAS_Q4BIT_COMPUTE_TYPE ComputeType,
+    const MLAS_Q4BIT_GEMM_DATA_PARAMS* DataParams,
+    void* Workspace,
+    MLAS_THREADPOOL* ThreadPool
+    )
+{
+    if (!MlasQ4BitGemmIsValidBlkLen(BlkLen)) {
+        MLAS_THROW_EX(std::invalid_argument, "Unsupported block length for 4-bit quantized GEMM");
+    }
+
+    const MLAS_Q4BIT_GEMM_DISPATCH* dispatch = MlasQ4BitGemmGetDispatch();
+    const bool UseInt8 = MlasQ4BitGemmUseInt8(dispatch, BlkLen, ComputeType);
+
+    //
+    // Nothing is accumulated when K is zero, only the bias is stored.
+    //
+
+    if (K == 0) {
+        for (size_t gemm_i = 0; gemm_i < BatchN; gemm_i++) {
+            const auto* Data = &DataParams[gemm_i];
+            for (size_t m = 0; m < M; m++) {
+                float* c = Data->C + m * Data->ldc;
+                if (Data->Bias != nullptr) {
+                    std::copy_n(Data->Bias, N, c);
+                } else {
+                    std::fill_n(c, N, 0.0f);
+                }
+            }
+        }
+        return;
+    }
+
+    //
+    // Compute the number of target threads given the complexity of the GEMM
+    // operation. Small requests should run using the single threaded path.
+    //
+
+    const double Complexity = double(M) * double(N) * double(K) * double(BatchN);
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t(Complexity / double(MLAS_SGEMM_THREAD_COMPLEXITY)) + 1;
+
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+
+    uint8_t* QuantA = reinterpret_cast<uint8_t*>(Workspace);
+    size_t QuantAGemmSize = 0;
+
+    if (UseInt8) {
+
+        const MLAS_Q4BIT_QUANT_A_LAYOUT QuantALayout(M, K, BlkLen);
+        const size_t BlockCountK = MlasQ4BitBlockCountK(K, BlkLen);
+        QuantAGemmSize = QuantALayout.GemmSize;
+
+        auto QuantizeRow = [&](ptrdiff_t tid) {
+            const size_t gemm_i = size_t(tid) / M;
+            const size_t m = size_t(tid) % M;
+            const auto* Data = &DataParams[gemm_i];
+            uint8_t* q = QuantA + gemm_i * QuantAGemmSize;
+
+            MlasQ4BitGemmQuantizeA(BlkLen, Data->A + m * Data->lda, Data->lda, 1, K,
+                                   reinterpret_cast<int8_t*>(q) + m * BlockCountK * BlkLen,
+                                   reinterpret_cast<float*>(q + QuantALayout.DataSize) + m * BlockCountK,
+                                   reinterpret_cast<float*>(q + QuantALayout.DataSize + QuantALayout.ScaleSize) +
+                                       m * BlockCountK);
+        };
+
+        if (TargetThreadCount == 1) {
+            for (size_t i = 0; i < M * BatchN; i++) {
+                QuantizeRow(ptrdiff_t(i));
+            }
+        } else {
+            MlasTrySimpleParallel(ThreadPool, ptrdiff_t(M * BatchN), QuantizeRow);
+        }
+    }
+
+    if (TargetThreadCount == 1) {
+        for (size_t gemm_i = 0; gemm_i < BatchN; gemm_i++) {
+            MlasQ4BitGemmOperation(dispatch, UseInt8, M, K, BlkLen, &DataParams[gemm_i],
+                                   QuantA + gemm_i * QuantAGemmSize, 0, M, 0, N);
+        }
+        return;
+    }
+
+    ptrdiff_t ThreadsPerGemm = TargetThreadCount / BatchN;
+    if (ThreadsPerGemm < 1) {
+        ThreadsPerGemm = 1;
+    }
+
+    //
+    // Partition N first, so that each block of B is read or dequantized by
+    // a single thread, and only split M when N is too narrow to keep the
+    // threads busy.
+    //
+
+    size_t StrideN = N;
+    if (size_t(ThreadsPerGemm) > 1) {
+        StrideN = MlasDivRoundup(MlasDivRoundup(N, ThreadsPerGemm), MLAS_SGEMM_STRIDEN_THREAD_ALIGN) *
+                  MLAS_SGEMM_STRIDEN_THREAD_ALIGN;
+        StrideN = std::min(StrideN, N);
+    }
+
+    const size_t ThreadCountN = MlasDivRoundup(N, StrideN);
+    size_t ThreadCountM = 1;
+    if (size_t(ThreadsPerGemm) > ThreadCountN) {
+        ThreadCountM = std::min(size_t(ThreadsPerGemm) / ThreadCountN,
+                                MlasDivRoundup(M, MLAS_Q4BIT_GEMM_KERNEL_M));
+    }
+
+    const size_t StrideM = MlasDivRoundup(MlasDivRoundup(M, ThreadCountM), MLAS_Q4BIT_GEMM_KERNEL_M) *
+                           MLAS_Q4BIT_GEMM_KERNEL_M;
+    ThreadCountM = MlasDivRoundup(M, StrideM);
+    ThreadsPerGemm = ThreadCountM * ThreadCountN;
+
+    MlasTrySimpleParallel(ThreadPool, ThreadsPerGemm * BatchN, [&](ptrdiff_t tid) {
+        const auto gemm_i = tid / ThreadsPerGemm;
+        const auto blk_i = tid % ThreadsPerGemm;
+
+        const ptrdiff_t ThreadIdN = blk_i / ThreadCountM;
+        const ptrdiff_t ThreadIdM = blk_i % ThreadCountM;
+
+        const size_t RangeStartM = ThreadIdM * StrideM;
+        const size_t RangeCountM = std::min(M - RangeStartM, StrideM);
+
+        const size_t RangeStartN = ThreadIdN * StrideN;
+        const size_t RangeCountN = std::min(N - RangeStartN, StrideN);
+
+        MlasQ4BitGemmOperation(dispatch, UseInt8, M, K, BlkLen, &DataParams[gemm_i],
+                               QuantA + gemm_i * QuantAGemmSize,
+                               RangeStartM, RangeCountM, RangeStartN, RangeCountN);
+    });
+}
+
+size_t
+MLASCALL
+MlasQ4BitGemmBatchWorkspaceSize(
+    size_t M,
+    size_t N,
+    size_t K,
+    size_t BatchN,
+    size_t BlkLen,
+    MLAS_Q4BIT_COMPUTE_TYPE ComputeType
+    )
+{
+    MLAS_UNREFERENCED_PARAMETER(N);
+
+    if (!MlasQ4BitGemmIsValidBlkLen(BlkLen) ||
+        !MlasQ4BitGemmUseInt8(MlasQ4BitGemmGetDispatch(), BlkLen, ComputeType)) {
+        return 0;
+    }
+
+    const MLAS_Q4BIT_QUANT_A_LAYOUT Layout(M, K, BlkLen);
+    return Layout.GemmSize * BatchN;
+}
+
+bool
+MLASCALL
+MlasIsQ4BitGemmAvailable(
+    size_t BlkLen,
+    MLAS_Q4BIT_COMPUTE_TYPE ComputeType
+    )
+{
+    const MLAS_Q4BIT_GEMM_DISPATCH* dispatch = MlasQ4BitGemmGetDispatch();
+
+    if (!MlasQ4BitGemmIsValidBlkLen(BlkLen) || dispatch == &MlasQ4BitGemmDispatchDefault) {
+        return false;
+    }
+
+    return ComputeType == MlasQ4BitCompFp32 || MlasQ4BitGemmUseInt8(dispatch, BlkLen, ComputeType);
+}
+
+//
+// Portable kernel, used when the platform has no vectorized kernel.
+//
+
+static
+void
+MlasQ4BitGemmFp32KernelDefault(
+    size_t BlkLen,
+    const float* A,
+    size_t lda,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK,
+    const float* Bias
+    )
+{
+    const size_t BlkDataSize = BlkLen / 2;
+    const size_t ZeroPointStride = MlasDivRoundup(BlockCountK, 2);
+
+    for (size_t n = 0; n < CountN; n++) {
+
+        const uint8_t* b = QuantBData + n * BlockCountK * BlkDataSize;
+        const float* s = QuantBScale + n * BlockCountK;
+        const uint8_t* zp = (QuantBZeroPoint != nullptr) ? QuantBZeroPoint + n * ZeroPointStride : nullptr;
+
+        for (size_t m = 0; m < CountM; m++) {
+
+            const float* a = A + m * lda;
+            float Accumulator = (Bias != nullptr) ? Bias[n] : 0.0f;
+
+            for (size_t blk = 0; blk < BlockCountK; blk++) {
+
+                const size_t k = blk * BlkLen;
+                const size_t len = std::min(CountK - k, BlkLen);
+                const uint8_t* bb = b + blk * BlkDataSize;
+
+                float Dot = 0.0f;
+                float Sum = 0.0f;
+
+                for (size_t kk = 0; kk < len; kk++) {
+                    const uint8_t packed = bb[kk / 2];
+                    const uint8_t q = (kk & 1) ? (packed >> 4) : (packed & 0x0F);
+                    Dot += a[k + kk] * float(q);
+                    Sum += a[k + kk];
+                }
+
+                Accumulator += s[blk] * (Dot - float(MlasQ4BitZeroPoint(zp, blk)) * Sum);
+            }
+
+            C[m * ldc + n] = Accumulator;
+        }
+    }
+}
+
+const MLAS_Q4BIT_GEMM_DISPATCH MlasQ4BitGemmDispatchDefault = {
+    MlasQ4BitGemmFp32KernelDefault,
+    nullptr,
+};
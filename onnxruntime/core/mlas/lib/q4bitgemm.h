@@ -0,0 +1,175 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    q4bitgemm.h
+
+Abstract:
+
+    This module defines the dispatch structure and the shared data layouts of
+    the block-wise 4-bit quantized GEMM.
+
+    Quantized B is stored as described for MLAS_Q4BIT_GEMM_DATA_PARAMS: each
+    column holds BlockCountK blocks of BlkLen / 2 bytes, one scale per block
+    and optionally one 4-bit zero point per block.
+
+    For the int8 compute type, each row of A is quantized per block of BlkLen
+    elements to symmetric int8 with its own scale. A quantized row holds
+    BlockCountK blocks of BlkLen int8 values, zero padded past K. Each block
+    also keeps the product of its scale and the sum of its int8 values, so
+    that the zero point of B can be applied once per block:
+
+        sum(a * (b - zp)) = ScaleA * (dot(QuantA, QuantB) - zp * sum(QuantA))
+
+--*/
+
+#pragma once
+
+#include "mlasi.h"
+
+//
+// Maximum number of rows of A computed by a kernel call. The kernels keep
+// one accumulator per row and reuse each dequantized piece of B across the
+// rows.
+//
+
+constexpr size_t MLAS_Q4BIT_GEMM_KERNEL_M = 4;
+
+//
+// Minimum and maximum supported block lengths.
+//
+
+constexpr size_t MLAS_Q4BIT_GEMM_MIN_BLKLEN = 16;
+constexpr size_t MLAS_Q4BIT_GEMM_MAX_BLKLEN = 256;
+
+//
+// Zero point used for blocks without an explicit zero point.
+//
+
+constexpr uint8_t MLAS_Q4BIT_DEFAULT_ZERO_POINT = 8;
+
+MLAS_FORCEINLINE
+constexpr size_t
+MlasQ4BitBlockCountK(
+    size_t K,
+    size_t BlkLen
+    )
+{
+    return MlasDivRoundup(K, BlkLen);
+}
+
+/**
+ * @brief Returns the zero point of block BlockIdx of a column of B.
+ */
+MLAS_FORCEINLINE
+uint8_t
+MlasQ4BitZeroPoint(
+    const uint8_t* QuantBZeroPoint,
+    size_t BlockIdx
+    )
+{
+    if (QuantBZeroPoint == nullptr) {
+        return MLAS_Q4BIT_DEFAULT_ZERO_POINT;
+    }
+    const uint8_t Packed = QuantBZeroPoint[BlockIdx / 2];
+    return (BlockIdx & 1) ? (Packed >> 4) : (Packed & 0x0F);
+}
+
+/**
+ * @brief Compute up to MLAS_Q4BIT_GEMM_KERNEL_M rows of C from fp32 A.
+ *
+ * @param BlkLen            Supplies the block length of B.
+ * @param A                 Supplies the address of the first row of A.
+ * @param lda               Supplies the leading dimension of A.
+ * @param QuantBData        Supplies the quantized data of the first column.
+ * @param QuantBScale       Supplies the block scales of the first column.
+ * @param QuantBZeroPoint   Supplies the zero points of the first column, or
+ *                          nullptr to use the default zero point.
+ * @param C                 Supplies the address of the first output.
+ * @param ldc               Supplies the leading dimension of C.
+ * @param CountM            Supplies the number of rows, at most
+ *                          MLAS_Q4BIT_GEMM_KERNEL_M.
+ * @param CountN            Supplies the number of columns.
+ * @param CountK            Supplies the number of columns of A.
+ * @param BlockCountK       Supplies the number of blocks of a column of B.
+ * @param Bias              Supplies the bias of the first column, or nullptr.
+ */
+typedef
+void
+(MLAS_Q4BIT_GEMM_FP32_KERNEL)(
+    size_t BlkLen,
+    const float* A,
+    size_t lda,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK,
+    const float* Bias
+    );
+
+/**
+ * @brief Compute up to MLAS_Q4BIT_GEMM_KERNEL_M rows of C from quantized A.
+ *
+ * @param BlkLen            Supplies the block length of A and B, a multiple
+ *                          of 32.
+ * @param QuantAData        Supplies the first quantized row of A, rows are
+ *                          BlockCountK * BlkLen bytes apart.
+ * @param QuantAScale       Supplies the block scales of the first row of A,
+ *                          rows are BlockCountK apart.
+ * @param QuantAScaledSum   Supplies the scaled block sums of the first row of
+ *                          A, rows are BlockCountK apart.
+ *
+ * The remaining parameters are as for MLAS_Q4BIT_GEMM_FP32_KERNEL.
+ */
+typedef
+void
+(MLAS_Q4BIT_GEMM_INT8_KERNEL)(
+    size_t BlkLen,
+    const int8_t* QuantAData,
+    const float* QuantAScale,
+    const float* QuantAScaledSum,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t BlockCountK,
+    const float* Bias
+    );
+
+struct MLAS_Q4BIT_GEMM_DISPATCH {
+    MLAS_Q4BIT_GEMM_FP32_KERNEL* Fp32Kernel;
+    MLAS_Q4BIT_GEMM_INT8_KERNEL* Int8Kernel;    /**< nullptr when not supported */
+};
+
+extern const MLAS_Q4BIT_GEMM_DISPATCH MlasQ4BitGemmDispatchDefault;
+
+//
+// The AVX2 int8 kernel is shared with the AVX512 dispatch of processors
+// without AVX512VNNI.
+//
+
+MLAS_Q4BIT_GEMM_INT8_KERNEL MlasQ4BitGemmInt8KernelAvx2;
+
+MLAS_FORCEINLINE
+const MLAS_Q4BIT_GEMM_DISPATCH*
+MlasQ4BitGemmGetDispatch()
+{
+#if defined(MLAS_TARGET_AMD64)
+    const MLAS_Q4BIT_GEMM_DISPATCH* dispatch = GetMlasPlatform().Q4BitGemmDispatch;
+    return dispatch != nullptr ? dispatch : &MlasQ4BitGemmDispatchDefault;
+#else
+    return &MlasQ4BitGemmDispatchDefault;
+#endif
+}
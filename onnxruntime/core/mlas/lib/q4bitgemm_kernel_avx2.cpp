@@ -0,0 +1,328 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    q4bitgemm_kernel_avx2.cpp
+
+Abstract:
+
+    This module implements the block-wise 4-bit quantized GEMM kernels for
+    AVX2/FMA3.
+
+    Eight bytes of a block of B expand to sixteen 4-bit values: the low and
+    high nibbles are split with a shift and a mask and interleaved back into
+    element order. The fp32 kernel widens them and applies the block scale
+    and zero point with a single multiply add, the int8 kernel multiplies
+    them directly with the quantized A using vpmaddubsw.
+
+--*/
+
+#include "q4bitgemm.h"
+
+/**
+ * @brief Expand 8 bytes of packed 4-bit data into 16 unsigned bytes in
+ *        element order.
+ */
+MLAS_FORCEINLINE
+__m128i
+MlasQ4BitUnpack16(
+    const uint8_t* QuantBData
+    )
+{
+    const __m128i LowMask = _mm_set1_epi8(0x0F);
+    const __m128i Packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(QuantBData));
+    const __m128i Low = _mm_and_si128(Packed, LowMask);
+    const __m128i High = _mm_and_si128(_mm_srli_epi16(Packed, 4), LowMask);
+    return _mm_unpacklo_epi8(Low, High);
+}
+
+/**
+ * @brief Expand 16 bytes of packed 4-bit data into 32 unsigned bytes in
+ *        element order.
+ */
+MLAS_FORCEINLINE
+__m256i
+MlasQ4BitUnpack32(
+    const uint8_t* QuantBData
+    )
+{
+    const __m128i LowMask = _mm_set1_epi8(0x0F);
+    const __m128i Packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(QuantBData));
+    const __m128i Low = _mm_and_si128(Packed, LowMask);
+    const __m128i High = _mm_and_si128(_mm_srli_epi16(Packed, 4), LowMask);
+    return _mm256_set_m128i(_mm_unpackhi_epi8(Low, High), _mm_unpacklo_epi8(Low, High));
+}
+
+MLAS_FORCEINLINE
+float
+MlasQ4BitReduceAdd(
+    __m256 Vector
+    )
+{
+    __m128 Sum = _mm_add_ps(_mm256_castps256_ps128(Vector), _mm256_extractf128_ps(Vector, 1));
+    Sum = _mm_add_ps(Sum, _mm_movehl_ps(Sum, Sum));
+    Sum = _mm_add_ss(Sum, _mm_movehdup_ps(Sum));
+    return _mm_cvtss_f32(Sum);
+}
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasQ4BitGemmFp32KernelAvx2Rows(
+    size_t BlkLen,
+    const float* A,
+    size_t lda,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK,
+    const float* Bias
+    )
+{
+    const size_t BlkDataSize = BlkLen / 2;
+    const size_t ZeroPointStride = MlasDivRoundup(BlockCountK, 2);
+    const __m256i ElementIndex = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+    for (size_t n = 0; n < CountN; n++) {
+
+        const uint8_t* b = QuantBData + n * BlockCountK * BlkDataSize;
+        const float* s = QuantBScale + n * BlockCountK;
+        const uint8_t* zp = (QuantBZeroPoint != nullptr) ? QuantBZeroPoint + n * ZeroPointStride : nullptr;
+
+        __m256 Accumulators[RowCount][2];
+
+        for (size_t r = 0; r < RowCount; r++) {
+            Accumulators[r][0] = _mm256_setzero_ps();
+            Accumulators[r][1] = _mm256_setzero_ps();
+        }
+
+        for (size_t blk = 0; blk < BlockCountK; blk++) {
+
+            const size_t k = blk * BlkLen;
+            const size_t len = std::min(CountK - k, BlkLen);
+            const uint8_t* bb = b + blk * BlkDataSize;
+
+            const __m256 Scale = _mm256_broadcast_ss(&s[blk]);
+            const __m256 Offset = _mm256_set1_ps(-s[blk] * float(MlasQ4BitZeroPoint(zp, blk)));
+
+            for (size_t kk = 0; kk < len; kk += 16) {
+
+                const __m128i Bytes = MlasQ4BitUnpack16(bb + kk / 2);
+
+                const __m256 b0 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(Bytes)),
+                                                  Scale, Offset);
+                const __m256 b1 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(Bytes, 8))),
+                                                  Scale, Offset);
+
+                const float* a = A + k + kk;
+
+                if (kk + 16 <= len) {
+                    for (size_t r = 0; r < RowCount; r++) {
+                        Accumulators[r][0] = _mm256_fmadd_ps(_mm256_loadu_ps(a + r * lda), b0, Accumulators[r][0]);
+                        Accumulators[r][1] = _mm256_fmadd_ps(_mm256_loadu_ps(a + r * lda + 8), b1, Accumulators[r][1]);
+                    }
+                } else {
+                    //
+                    // Mask the loads of A past the end of the row. The padded
+                    // elements of B are finite so the products are zero.
+                    //
+
+                    const int Remaining = int(len - kk);
+                    const __m256i Mask0 = _mm256_cmpgt_epi32(_mm256_set1_epi32(Remaining), ElementIndex);
+                    const __m256i Mask1 = _mm256_cmpgt_epi32(_mm256_set1_epi32(Remaining - 8), ElementIndex);
+
+                    for (size_t r = 0; r < RowCount; r++) {
+                        Accumulators[r][0] = _mm256_fmadd_ps(_mm256_maskload_ps(a + r * lda, Mask0), b0,
+                                                             Accumulators[r][0]);
+                        Accumulators[r][1] = _mm256_fmadd_ps(_mm256_maskload_ps(a + r * lda + 8, Mask1), b1,
+                                                             Accumulators[r][1]);
+                    }
+                }
+            }
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            float Sum = MlasQ4BitReduceAdd(_mm256_add_ps(Accumulators[r][0], Accumulators[r][1]));
+            if (Bias != nullptr) {
+                Sum += Bias[n];
+            }
+            C[r * ldc + n] = Sum;
+        }
+    }
+}
+
+static
+void
+MlasQ4BitGemmFp32KernelAvx2(
+    size_t BlkLen,
+    const float* A,
+    size_t lda,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK,
+    const float* Bias
+    )
+{
+    switch (CountM) {
+        case 1:
+            MlasQ4BitGemmFp32KernelAvx2Rows<1>(BlkLen, A, lda, QuantBData, QuantBScale, QuantBZeroPoint,
+                                               C, ldc, CountN, CountK, BlockCountK, Bias);
+            break;
+        case 2:
+            MlasQ4BitGemmFp32KernelAvx2Rows<2>(BlkLen, A, lda, QuantBData, QuantBScale, QuantBZeroPoint,
+                                               C, ldc, CountN, CountK, BlockCountK, Bias);
+            break;
+        case 3:
+            MlasQ4BitGemmFp32KernelAvx2Rows<3>(BlkLen, A, lda, QuantBData, QuantBScale, QuantBZeroPoint,
+                                               C, ldc, CountN, CountK, BlockCountK, Bias);
+            break;
+        default:
+            MlasQ4BitGemmFp32KernelAvx2Rows<4>(BlkLen, A, lda, QuantBData, QuantBScale, QuantBZeroPoint,
+                                               C, ldc, CountN, CountK, BlockCountK, Bias);
+            break;
+    }
+}
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasQ4BitGemmInt8KernelAvx2Rows(
+    size_t BlkLen,
+    const int8_t* QuantAData,
+    const float* QuantAScale,
+    const float* QuantAScaledSum,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    size_t BlockCountK,
+    const float* Bias
+    )
+{
+    const size_t BlkDataSize = BlkLen / 2;
+    const size_t ZeroPointStride = MlasDivRoundup(BlockCountK, 2);
+    const size_t QuantARowSize = BlockCountK * BlkLen;
+    const __m256i Ones = _mm256_set1_epi16(1);
+
+    for (size_t n = 0; n < CountN; n++) {
+
+        const uint8_t* b = QuantBData + n * BlockCountK * BlkDataSize;
+        const float* s = QuantBScale + n * BlockCountK;
+        const uint8_t* zp = (QuantBZeroPoint != nullptr) ? QuantBZeroPoint + n * ZeroPointStride : nullptr;
+
+        __m256 Accumulators[RowCount];
+        float Correction[RowCount];
+
+        for (size_t r = 0; r < RowCount; r++) {
+            Accumulators[r] = _mm256_setzero_ps();
+            Correction[r] = 0.0f;
+        }
+
+        for (size_t blk = 0; blk < BlockCountK; blk++) {
+
+            const uint8_t* bb = b + blk * BlkDataSize;
+            const int8_t* a = QuantAData + blk * BlkLen;
+
+            __m256i BlockAccumulators[RowCount];
+
+            for (size_t r = 0; r < RowCount; r++) {
+                BlockAccumulators[r] = _mm256_setzero_si256();
+            }
+
+            //
+            // The 4-bit values are at most 15, so the pairwise sums of
+            // vpmaddubsw cannot saturate.
+            //
+
+            for (size_t kk = 0; kk < BlkLen; kk += 32) {
+
+                const __m256i Bytes = MlasQ4BitUnpack32(bb + kk / 2);
+
+                for (size_t r = 0; r < RowCount; r++) {
+                    const __m256i av = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + r * QuantARowSize + kk));
+                    const __m256i Dot = _mm256_madd_epi16(_mm256_maddubs_epi16(Bytes, av), Ones);
+                    BlockAccumulators[r] = _mm256_add_epi32(BlockAccumulators[r], Dot);
+                }
+            }
+
+            const float ScaleB = s[blk];
+            const float ZeroPointScaleB = ScaleB * float(MlasQ4BitZeroPoint(zp, blk));
+
+            for (size_t r = 0; r < RowCount; r++) {
+                const __m256 Scale = _mm256_set1_ps(QuantAScale[r * BlockCountK + blk] * ScaleB);
+                Accumulators[r] = _mm256_fmadd_ps(_mm256_cvtepi32_ps(BlockAccumulators[r]), Scale, Accumulators[r]);
+                Correction[r] += ZeroPointScaleB * QuantAScaledSum[r * BlockCountK + blk];
+            }
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            float Sum = MlasQ4BitReduceAdd(Accumulators[r]) - Correction[r];
+            if (Bias != nullptr) {
+                Sum += Bias[n];
+            }
+            C[r * ldc + n] = Sum;
+        }
+    }
+}
+
+void
+MlasQ4BitGemmInt8KernelAvx2(
+    size_t BlkLen,
+    const int8_t* QuantAData,
+    const float* QuantAScale,
+    const float* QuantAScaledSum,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t BlockCountK,
+    const float* Bias
+    )
+{
+    switch (CountM) {
+        case 1:
+            MlasQ4BitGemmInt8KernelAvx2Rows<1>(BlkLen, QuantAData, QuantAScale, QuantAScaledSum,
+                                               QuantBData, QuantBScale, QuantBZeroPoint,
+                                               C, ldc, CountN, BlockCountK, Bias);
+            break;
+        case 2:
+            MlasQ4BitGemmInt8KernelAvx2Rows<2>(BlkLen, QuantAData, QuantAScale, QuantAScaledSum,
+                                               QuantBData, QuantBScale, QuantBZeroPoint,
+                                               C, ldc, CountN, BlockCountK, Bias);
+            break;
+        case 3:
+            MlasQ4BitGemmInt8KernelAvx2Rows<3>(BlkLen, QuantAData, QuantAScale, QuantAScaledSum,
+                                               QuantBData, QuantBScale, QuantBZeroPoint,
+                                               C, ldc, CountN, BlockCountK, Bias);
+            break;
+        default:
+            MlasQ4BitGemmInt8KernelAvx2Rows<4>(BlkLen, QuantAData, QuantAScale, QuantAScaledSum,
+                                               QuantBData, QuantBScale, QuantBZeroPoint,
+                                               C, ldc, CountN, BlockCountK, Bias);
+            break;
+    }
+}
+
+const MLAS_Q4BIT_GEMM_DISPATCH MlasQ4BitGemmDispatchAvx2 = {
+    MlasQ4BitGemmFp32KernelAvx2,
+    MlasQ4BitGemmInt8KernelAvx2,
+};
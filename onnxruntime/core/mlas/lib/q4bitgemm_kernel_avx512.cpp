@@ -0,0 +1,298 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    q4bitgemm_kernel_avx512.cpp
+
+Abstract:
+
+    This module implements the block-wise 4-bit quantized GEMM kernels for
+    AVX512F and AVX512VNNI.
+
+    The fp32 kernel widens sixteen 4-bit values of B to a full register and
+    handles the tail of a row with a masked load of A. The int8 kernel uses
+    vpdpbusd, which multiplies the unsigned 4-bit values of B with the signed
+    quantized A and accumulates into int32 in a single instruction.
+
+--*/
+
+#include "q4bitgemm.h"
+
+/**
+ * @brief Expand 8 bytes of packed 4-bit data into 16 unsigned bytes in
+ *        element order.
+ */
+MLAS_FORCEINLINE
+__m128i
+MlasQ4BitUnpack16Avx512(
+    const uint8_t* QuantBData
+    )
+{
+    const __m128i LowMask = _mm_set1_epi8(0x0F);
+    const __m128i Packed = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(QuantBData));
+    const __m128i Low = _mm_and_si128(Packed, LowMask);
+    const __m128i High = _mm_and_si128(_mm_srli_epi16(Packed, 4), LowMask);
+    return _mm_unpacklo_epi8(Low, High);
+}
+
+/**
+ * @brief Expand 16 bytes of packed 4-bit data into 32 unsigned bytes in
+ *        element order.
+ */
+MLAS_FORCEINLINE
+__m256i
+MlasQ4BitUnpack32Avx512(
+    const uint8_t* QuantBData
+    )
+{
+    const __m128i LowMask = _mm_set1_epi8(0x0F);
+    const __m128i Packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(QuantBData));
+    const __m128i Low = _mm_and_si128(Packed, LowMask);
+    const __m128i High = _mm_and_si128(_mm_srli_epi16(Packed, 4), LowMask);
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi8(Low, High)),
+                                   _mm_unpackhi_epi8(Low, High), 1);
+}
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasQ4BitGemmFp32KernelAvx512Rows(
+    size_t BlkLen,
+    const float* A,
+    size_t lda,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK,
+    const float* Bias
+    )
+{
+    const size_t BlkDataSize = BlkLen / 2;
+    const size_t ZeroPointStride = MlasDivRoundup(BlockCountK, 2);
+
+    for (size_t n = 0; n < CountN; n++) {
+
+        const uint8_t* b = QuantBData + n * BlockCountK * BlkDataSize;
+        const float* s = QuantBScale + n * BlockCountK;
+        const uint8_t* zp = (QuantBZeroPoint != nullptr) ? QuantBZeroPoint + n * ZeroPointStride : nullptr;
+
+        __m512 Accumulators[RowCount];
+
+        for (size_t r = 0; r < RowCount; r++) {
+            Accumulators[r] = _mm512_setzero_ps();
+        }
+
+        for (size_t blk = 0; blk < BlockCountK; blk++) {
+
+            const size_t k = blk * BlkLen;
+            const size_t len = std::min(CountK - k, BlkLen);
+            const uint8_t* bb = b + blk * BlkDataSize;
+
+            const __m512 Scale = _mm512_set1_ps(s[blk]);
+            const __m512 Offset = _mm512_set1_ps(-s[blk] * float(MlasQ4BitZeroPoint(zp, blk)));
+
+            for (size_t kk = 0; kk < len; kk += 16) {
+
+                const __m128i Bytes = MlasQ4BitUnpack16Avx512(bb + kk / 2);
+                const __m512 bv = _mm512_fmadd_ps(_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(Bytes)), Scale, Offset);
+
+                const float* a = A + k + kk;
+
+                if (kk + 16 <= len) {
+                    for (size_t r = 0; r < RowCount; r++) {
+                        Accumulators[r] = _mm512_fmadd_ps(_mm512_loadu_ps(a + r * lda), bv, Accumulators[r]);
+                    }
+                } else {
+                    const __mmask16 Mask = __mmask16((1u << (len - kk)) - 1);
+                    for (size_t r = 0; r < RowCount; r++) {
+                        Accumulators[r] = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(Mask, a + r * lda), bv,
+                                                          Accumulators[r]);
+                    }
+                }
+            }
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            float Sum = _mm512_reduce_add_ps(Accumulators[r]);
+            if (Bias != nullptr) {
+                Sum += Bias[n];
+            }
+            C[r * ldc + n] = Sum;
+        }
+    }
+}
+
+static
+void
+MlasQ4BitGemmFp32KernelAvx512(
+    size_t BlkLen,
+    const float* A,
+    size_t lda,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t CountK,
+    size_t BlockCountK,
+    const float* Bias
+    )
+{
+    switch (CountM) {
+        case 1:
+            MlasQ4BitGemmFp32KernelAvx512Rows<1>(BlkLen, A, lda, QuantBData, QuantBScale, QuantBZeroPoint,
+                                                 C, ldc, CountN, CountK, BlockCountK, Bias);
+            break;
+        case 2:
+            MlasQ4BitGemmFp32KernelAvx512Rows<2>(BlkLen, A, lda, QuantBData, QuantBScale, QuantBZeroPoint,
+                                                 C, ldc, CountN, CountK, BlockCountK, Bias);
+            break;
+        case 3:
+            MlasQ4BitGemmFp32KernelAvx512Rows<3>(BlkLen, A, lda, QuantBData, QuantBScale, QuantBZeroPoint,
+                                                 C, ldc, CountN, CountK, BlockCountK, Bias);
+            break;
+        default:
+            MlasQ4BitGemmFp32KernelAvx512Rows<4>(BlkLen, A, lda, QuantBData, QuantBScale, QuantBZeroPoint,
+                                                 C, ldc, CountN, CountK, BlockCountK, Bias);
+            break;
+    }
+}
+
+template<size_t RowCount>
+MLAS_FORCEINLINE
+void
+MlasQ4BitGemmInt8KernelAvx512VnniRows(
+    size_t BlkLen,
+    const int8_t* QuantAData,
+    const float* QuantAScale,
+    const float* QuantAScaledSum,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    float* C,
+    size_t ldc,
+    size_t CountN,
+    size_t BlockCountK,
+    const float* Bias
+    )
+{
+    const size_t BlkDataSize = BlkLen / 2;
+    const size_t ZeroPointStride = MlasDivRoundup(BlockCountK, 2);
+    const size_t QuantARowSize = BlockCountK * BlkLen;
+
+    for (size_t n = 0; n < CountN; n++) {
+
+        const uint8_t* b = QuantBData + n * BlockCountK * BlkDataSize;
+        const float* s = QuantBScale + n * BlockCountK;
+        const uint8_t* zp = (QuantBZeroPoint != nullptr) ? QuantBZeroPoint + n * ZeroPointStride : nullptr;
+
+        __m256 Accumulators[RowCount];
+        float Correction[RowCount];
+
+        for (size_t r = 0; r < RowCount; r++) {
+            Accumulators[r] = _mm256_setzero_ps();
+            Correction[r] = 0.0f;
+        }
+
+        for (size_t blk = 0; blk < BlockCountK; blk++) {
+
+            const uint8_t* bb = b + blk * BlkDataSize;
+            const int8_t* a = QuantAData + blk * BlkLen;
+
+            __m256i BlockAccumulators[RowCount];
+
+            for (size_t r = 0; r < RowCount; r++) {
+                BlockAccumulators[r] = _mm256_setzero_si256();
+            }
+
+            for (size_t kk = 0; kk < BlkLen; kk += 32) {
+
+                const __m256i Bytes = MlasQ4BitUnpack32Avx512(bb + kk / 2);
+
+                for (size_t r = 0; r < RowCount; r++) {
+                    const __m256i av = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + r * QuantARowSize + kk));
+                    BlockAccumulators[r] = _mm256_dpbusd_epi32(BlockAccumulators[r], Bytes, av);
+                }
+            }
+
+            const float ScaleB = s[blk];
+            const float ZeroPointScaleB = ScaleB * float(MlasQ4BitZeroPoint(zp, blk));
+
+            for (size_t r = 0; r < RowCount; r++) {
+                const __m256 Scale = _mm256_set1_ps(QuantAScale[r * BlockCountK + blk] * ScaleB);
+                Accumulators[r] = _mm256_fmadd_ps(_mm256_cvtepi32_ps(BlockAccumulators[r]), Scale, Accumulators[r]);
+                Correction[r] += ZeroPointScaleB * QuantAScaledSum[r * BlockCountK + blk];
+            }
+        }
+
+        for (size_t r = 0; r < RowCount; r++) {
+            float Sum = _mm512_reduce_add_ps(_mm512_zextps256_ps512(Accumulators[r])) - Correction[r];
+            if (Bias != nullptr) {
+                Sum += Bias[n];
+            }
+            C[r * ldc + n] = Sum;
+        }
+    }
+}
+
+static
+void
+MlasQ4BitGemmInt8KernelAvx512Vnni(
+    size_t BlkLen,
+    const int8_t* QuantAData,
+    const float* QuantAScale,
+    const float* QuantAScaledSum,
+    const uint8_t* QuantBData,
+    const float* QuantBScale,
+    const uint8_t* QuantBZeroPoint,
+    float* C,
+    size_t ldc,
+    size_t CountM,
+    size_t CountN,
+    size_t BlockCountK,
+    const float* Bias
+    )
+{
+    switch (CountM) {
+        case 1:
+            MlasQ4BitGemmInt8KernelAvx512VnniRows<1>(BlkLen, QuantAData, QuantAScale, QuantAScaledSum,
+                                                     QuantBData, QuantBScale, QuantBZeroPoint,
+                                                     C, ldc, CountN, BlockCountK, Bias);
+            break;
+        case 2:
+            MlasQ4BitGemmInt8KernelAvx512VnniRows<2>(BlkLen, QuantAData, QuantAScale, QuantAScaledSum,
+                                                     QuantBData, QuantBScale, QuantBZeroPoint,
+                                                     C, ldc, CountN, BlockCountK, Bias);
+            break;
+        case 3:
+            MlasQ4BitGemmInt8KernelAvx512VnniRows<3>(BlkLen, QuantAData, QuantAScale, QuantAScaledSum,
+                                                     QuantBData, QuantBScale, QuantBZeroPoint,
+                                                     C, ldc, CountN, BlockCountK, Bias);
+            break;
+        default:
+            MlasQ4BitGemmInt8KernelAvx512VnniRows<4>(BlkLen, QuantAData, QuantAScale, QuantAScaledSum,
+                                                     QuantBData, QuantBScale, QuantBZeroPoint,
+                                                     C, ldc, CountN, BlockCountK, Bias);
+            break;
+    }
+}
+
+const MLAS_Q4BIT_GEMM_DISPATCH MlasQ4BitGemmDispatchAvx512 = {
+    MlasQ4BitGemmFp32KernelAvx512,
+    MlasQ4BitGemmInt8KernelAvx2,
+};
+
+const MLAS_Q4BIT_GEMM_DISPATCH MlasQ4BitGemmDispatchAvx512Vnni = {
+    MlasQ4BitGemmFp32KernelAvx512,
+    MlasQ4BitGemmInt8KernelAvx512Vnni,
+};
@@ -0,0 +1,531 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    reduce.cpp
+
+Abstract:
+
+    This module implements routines to reduce the middle dimension of a tensor
+    viewed as [Outer][Reduce][Inner].
+
+    When the inner dimension is one, each row is reduced to a scalar by the
+    rows kernel. Otherwise the columns kernel keeps a block of columns in
+    registers and applies the reduction while walking down the rows, so the
+    input is read once with unit stride.
+
+    The log sum exp reduction is computed in two passes, first the maximum and
+    then the sum of the exponentials of the differences to the maximum.
+
+--*/
+
+#include "mlasi.h"
+
+//
+// Reduction operators for the generic kernels. Apply folds an input value into
+// an accumulator and Combine merges two accumulators.
+//
+
+struct MLAS_REDUCTION_SUM {
+
+    static float Identity() { return 0.0f; }
+    static float Apply(float Accumulator, float Value) { return Accumulator + Value; }
+    static float Combine(float Accumulator, float Value) { return Accumulator + Value; }
+
+    static MLAS_FLOAT32X4 Apply(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        return MlasAddFloat32x4(Accumulator, Vector);
+    }
+};
+
+struct MLAS_REDUCTION_SUM_SQUARE {
+
+    static float Identity() { return 0.0f; }
+    static float Apply(float Accumulator, float Value) { return Accumulator + Value * Value; }
+    static float Combine(float Accumulator, float Value) { return Accumulator + Value; }
+
+    static MLAS_FLOAT32X4 Apply(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        return MlasMultiplyAddFloat32x4(Vector, Vector, Accumulator);
+    }
+};
+
+struct MLAS_REDUCTION_MAXIMUM {
+
+    static float Identity() { return -std::numeric_limits<float>::infinity(); }
+    static float Apply(float Accumulator, float Value) { return std::max(Accumulator, Value); }
+    static float Combine(float Accumulator, float Value) { return std::max(Accumulator, Value); }
+
+    static MLAS_FLOAT32X4 Apply(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        return MlasMaximumFloat32x4(Accumulator, Vector);
+    }
+};
+
+struct MLAS_REDUCTION_MINIMUM {
+
+    static float Identity() { return std::numeric_limits<float>::infinity(); }
+    static float Apply(float Accumulator, float Value) { return std::min(Accumulator, Value); }
+    static float Combine(float Accumulator, float Value) { return std::min(Accumulator, Value); }
+
+    static MLAS_FLOAT32X4 Apply(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        return MlasMinimumFloat32x4(Accumulator, Vector);
+    }
+};
+
+struct MLAS_REDUCTION_PRODUCT {
+
+    static float Identity() { return 1.0f; }
+    static float Apply(float Accumulator, float Value) { return Accumulator * Value; }
+    static float Combine(float Accumulator, float Value) { return Accumulator * Value; }
+
+    static MLAS_FLOAT32X4 Apply(MLAS_FLOAT32X4 Accumulator, MLAS_FLOAT32X4 Vector)
+    {
+        return MlasMultiplyFloat32x4(Accumulator, Vector);
+    }
+};
+
+template <typename Reduction>
+float
+MlasReduceRowF32(
+    const float* Input,
+    size_t N
+    )
+{
+    float Accumulator = Reduction::Identity();
+
+    if (N >= 4) {
+
+        const MLAS_FLOAT32X4 IdentityVector = MlasBroadcastFloat32x4(Reduction::Identity());
+        MLAS_FLOAT32X4 AccumulatorVector0 = IdentityVector;
+        MLAS_FLOAT32X4 AccumulatorVector1 = IdentityVector;
+
+        while (N >= 8) {
+
+            AccumulatorVector0 = Reduction::Apply(AccumulatorVector0, MlasLoadFloat32x4(Input));
+            AccumulatorVector1 = Reduction::Apply(AccumulatorVector1, MlasLoadFloat32x4(Input + 4));
+
+            Input += 8;
+            N -= 8;
+        }
+
+        if (N >= 4) {
+
+            AccumulatorVector0 = Reduction::Apply(AccumulatorVector0, MlasLoadFloat32x4(Input));
+
+            Input += 4;
+            N -= 4;
+        }
+
+        float Lanes[8];
+        MlasStoreFloat32x4(Lanes, AccumulatorVector0);
+        MlasStoreFloat32x4(Lanes + 4, AccumulatorVector1);
+
+        for (size_t i = 0; i < 8; i++) {
+            Accumulator = Reduction::Combine(Accumulator, Lanes[i]);
+        }
+    }
+
+    while (N > 0) {
+        Accumulator = Reduction::Apply(Accumulator, *Input++);
+        N -= 1;
+    }
+
+    return Accumulator;
+}
+
+template <typename Reduction>
+void
+MlasReduceRowsF32(
+    const float* Input,
+    float* Output,
+    size_t RowCount,
+    size_t RowSize
+    )
+{
+    for (size_t Row = 0; Row < RowCount; Row++) {
+        Output[Row] = MlasReduceRowF32<Reduction>(Input + Row * RowSize, RowSize);
+    }
+}
+
+template <typename Reduction>
+void
+MlasReduceColumnsF32(
+    const float* Input,
+    float* Output,
+    size_t ReduceCount,
+    size_t ColumnCount,
+    size_t ldInput
+    )
+{
+    const MLAS_FLOAT32X4 IdentityVector = MlasBroadcastFloat32x4(Reduction::Identity());
+
+    size_t c = 0;
+
+    for (; c + 8 <= ColumnCount; c += 8) {
+
+        MLAS_FLOAT32X4 AccumulatorVector0 = IdentityVector;
+        MLAS_FLOAT32X4 AccumulatorVector1 = IdentityVector;
+        const float* input = Input + c;
+
+        for (size_t r = 0; r < ReduceCount; r++) {
+
+            AccumulatorVector0 = Reduction::Apply(AccumulatorVector0, MlasLoadFloat32x4(input));
+            AccumulatorVector1 = Reduction::Apply(AccumulatorVector1, MlasLoadFloat32x4(input + 4));
+
+            input += ldInput;
+        }
+
+        MlasStoreFloat32x4(Output + c, AccumulatorVector0);
+        MlasStoreFloat32x4(Output + c + 4, AccumulatorVector1);
+    }
+
+    for (; c + 4 <= ColumnCount; c += 4) {
+
+        MLAS_FLOAT32X4 AccumulatorVector = IdentityVector;
+        const float* input = Input + c;
+
+        for (size_t r = 0; r < ReduceCount; r++) {
+            AccumulatorVector = Reduction::Apply(AccumulatorVector, MlasLoadFloat32x4(input));
+            input += ldInput;
+        }
+
+        MlasStoreFloat32x4(Output + c, AccumulatorVector);
+    }
+
+    for (; c < ColumnCount; c++) {
+
+        float Accumulator = Reduction::Identity();
+        const float* input = Input + c;
+
+        for (size_t r = 0; r < ReduceCount; r++) {
+            Accumulator = Reduction::Apply(Accumulator, *input);
+            input += ldInput;
+        }
+
+        Output[c] = Accumulator;
+    }
+}
+
+void
+MLASCALL
+MlasReduceRowsF32Kernel(
+    MLAS_REDUCTION_KIND Kind,
+    const float* Input,
+    float* Output,
+    size_t RowCount,
+    size_t RowSize
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to reduce each row of a matrix
+    to a scalar.
+
+Arguments:
+
+    Kind - Supplies the reduction to apply. The log sum exp reduction is not
+        handled by the kernel.
+
+    Input - Supplies the input matrix, [RowCount][RowSize].
+
+    Output - Supplies the output vector, [RowCount].
+
+    RowCount - Supplies the number of rows to reduce.
+
+    RowSize - Supplies the number of elements of a row.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (Kind) {
+        case MlasSumReduction:
+            MlasReduceRowsF32<MLAS_REDUCTION_SUM>(Input, Output, RowCount, RowSize);
+            break;
+        case MlasSumSquareReduction:
+            MlasReduceRowsF32<MLAS_REDUCTION_SUM_SQUARE>(Input, Output, RowCount, RowSize);
+            break;
+        case MlasMaximumReduction:
+            MlasReduceRowsF32<MLAS_REDUCTION_MAXIMUM>(Input, Output, RowCount, RowSize);
+            break;
+        case MlasMinimumReduction:
+            MlasReduceRowsF32<MLAS_REDUCTION_MINIMUM>(Input, Output, RowCount, RowSize);
+            break;
+        case MlasProductReduction:
+            MlasReduceRowsF32<MLAS_REDUCTION_PRODUCT>(Input, Output, RowCount, RowSize);
+            break;
+        default:
+            MLAS_THROW_EX(std::runtime_error, "bad mlas reduction kind");
+    }
+}
+
+void
+MLASCALL
+MlasReduceColumnsF32Kernel(
+    MLAS_REDUCTION_KIND Kind,
+    const float* Input,
+    float* Output,
+    size_t ReduceCount,
+    size_t ColumnCount,
+    size_t ldInput
+    )
+/*++
+
+Routine Description:
+
+    This routine implements the generic kernel to reduce the rows of a matrix
+    to a single row.
+
+Arguments:
+
+    Kind - Supplies the reduction to apply. The log sum exp reduction is not
+        handled by the kernel.
+
+    Input - Supplies the input matrix, [ReduceCount][ldInput].
+
+    Output - Supplies the output vector, [ColumnCount].
+
+    ReduceCount - Supplies the number of rows to reduce.
+
+    ColumnCount - Supplies the number of columns to reduce.
+
+    ldInput - Supplies the number of elements between consecutive rows of the
+        input matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    switch (Kind) {
+        case MlasSumReduction:
+            MlasReduceColumnsF32<MLAS_REDUCTION_SUM>(Input, Output, ReduceCount, ColumnCount, ldInput);
+            break;
+        case MlasSumSquareReduction:
+            MlasReduceColumnsF32<MLAS_REDUCTION_SUM_SQUARE>(Input, Output, ReduceCount, ColumnCount, ldInput);
+            break;
+        case MlasMaximumReduction:
+            MlasReduceColumnsF32<MLAS_REDUCTION_MAXIMUM>(Input, Output, ReduceCount, ColumnCount, ldInput);
+            break;
+        case MlasMinimumReduction:
+            MlasReduceColumnsF32<MLAS_REDUCTION_MINIMUM>(Input, Output, ReduceCount, ColumnCount, ldInput);
+            break;
+        case MlasProductReduction:
+            MlasReduceColumnsF32<MLAS_REDUCTION_PRODUCT>(Input, Output, ReduceCount, ColumnCount, ldInput);
+            break;
+        default:
+            MLAS_THROW_EX(std::runtime_error, "bad mlas reduction kind");
+    }
+}
+
+MLAS_FORCEINLINE
+float
+MlasReduceLogSumExpOffset(
+    float Maximum
+    )
+{
+    //
+    // An infinite maximum cannot be subtracted from the inputs, so the
+    // exponentials are computed without an offset. The sum then correctly
+    // saturates to infinity or underflows to zero.
+    //
+
+    return std::isfinite(Maximum) ? Maximum : 0.0f;
+}
+
+void
+MlasReduceLogSumExpRows(
+    const float* Input,
+    float* Output,
+    size_t RowCount,
+    size_t RowSize
+    )
+{
+    for (size_t Row = 0; Row < RowCount; Row++) {
+
+        const float* input = Input + Row * RowSize;
+
+#if defined(MLAS_TARGET_AMD64)
+        float Maximum = GetMlasPlatform().ReduceMaximumF32Kernel(input, RowSize);
+#else
+        float Maximum = MlasReduceMaximumF32Kernel(input, RowSize);
+#endif
+
+        Maximum = MlasReduceLogSumExpOffset(Maximum);
+        const float NegativeMaximum = -Maximum;
+
+#if defined(MLAS_TARGET_AMD64)
+        float Accumulation = GetMlasPlatform().ComputeSumExpF32Kernel(input, nullptr, RowSize, &NegativeMaximum);
+#else
+        float Accumulation = MlasComputeSumExpF32Kernel(input, nullptr, RowSize, &NegativeMaximum);
+#endif
+
+        Output[Row] = std::log(Accumulation) + Maximum;
+    }
+}
+
+void
+MlasReduceLogSumExpColumns(
+    const float* Input,
+    float* Output,
+    size_t ReduceCount,
+    size_t ColumnCount,
+    size_t ldInput
+    )
+{
+    //
+    // Store the maximum of each column in the output.
+    //
+
+#if defined(MLAS_TARGET_AMD64)
+    GetMlasPlatform().ReduceColumnsF32Kernel(MlasMaximumReduction, Input, Output, ReduceCount, ColumnCount, ldInput);
+#else
+    MlasReduceColumnsF32Kernel(MlasMaximumReduction, Input, Output, ReduceCount, ColumnCount, ldInput);
+#endif
+
+    //
+    // Accumulate the exponentials by blocks of columns that stay in the L1
+    // cache while walking down the rows.
+    //
+
+    constexpr size_t BlockSize = 256;
+
+    MLAS_DECLSPEC_ALIGN(float Exponentials[BlockSize], 64);
+    MLAS_DECLSPEC_ALIGN(float Accumulators[BlockSize], 64);
+
+    for (size_t c = 0; c < ColumnCount; c += BlockSize) {
+
+        const size_t CountC = std::min(ColumnCount - c, BlockSize);
+        float* Maximums = Output + c;
+
+        for (size_t i = 0; i < CountC; i++) {
+            Maximums[i] = MlasReduceLogSumExpOffset(Maximums[i]);
+            Accumulators[i] = 0.0f;
+        }
+
+        const float* input = Input + c;
+
+        for (size_t r = 0; r < ReduceCount; r++) {
+
+            size_t i = 0;
+
+            for (; i + 4 <= CountC; i += 4) {
+                MlasStoreAlignedFloat32x4(Exponentials + i,
+                    MlasSubtractFloat32x4(MlasLoadFloat32x4(input + i), MlasLoadFloat32x4(Maximums + i)));
+            }
+
+            for (; i < CountC; i++) {
+                Exponentials[i] = input[i] - Maximums[i];
+            }
+
+#if defined(MLAS_TARGET_AMD64)
+            GetMlasPlatform().ComputeExpF32Kernel(Exponentials, Exponentials, CountC);
+#else
+            MlasComputeExpF32Kernel(Exponentials, Exponentials, CountC);
+#endif
+
+            i = 0;
+
+            for (; i + 4 <= CountC; i += 4) {
+                MlasStoreAlignedFloat32x4(Accumulators + i,
+                    MlasAddFloat32x4(MlasLoadFloat32x4(Accumulators + i), MlasLoadFloat32x4(Exponentials + i)));
+            }
+
+            for (; i < CountC; i++) {
+                Accumulators[i] += Exponentials[i];
+            }
+
+            input += ldInput;
+        }
+
+        for (size_t i = 0; i < CountC; i++) {
+            Maximums[i] = std::log(Accumulators[i]) + Maximums[i];
+        }
+    }
+}
+
+void
+MLASCALL
+MlasReduce(
+    MLAS_REDUCTION_KIND Kind,
+    const float* Input,
+    float* Output,
+    size_t OuterCount,
+    size_t ReduceCount,
+    size_t InnerCount,
+    size_t InnerStride
+    )
+/*++
+
+Routine Description:
+
+    This routine reduces the middle dimension of a tensor viewed as
+    [Outer][Reduce][Inner].
+
+Arguments:
+
+    Kind - Supplies the reduction to apply.
+
+    Input - Supplies the input tensor. Element (o, r, i) is at offset
+        (o * ReduceCount + r) * InnerStride + i.
+
+    Output - Supplies the output tensor. Element (o, i) is at offset
+        o * InnerStride + i.
+
+    OuterCount - Supplies the number of outer slices.
+
+    ReduceCount - Supplies the number of elements to reduce.
+
+    InnerCount - Supplies the number of inner elements to compute for each
+        outer slice.
+
+    InnerStride - Supplies the size of the inner dimension of the tensor,
+        which must be at least InnerCount.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (InnerCount == 1 && InnerStride == 1) {
+
+        if (Kind == MlasLogSumExpReduction) {
+            MlasReduceLogSumExpRows(Input, Output, OuterCount, ReduceCount);
+        } else {
+#if defined(MLAS_TARGET_AMD64)
+            GetMlasPlatform().ReduceRowsF32Kernel(Kind, Input, Output, OuterCount, ReduceCount);
+#else
+            MlasReduceRowsF32Kernel(Kind, Input, Output, OuterCount, ReduceCount);
+#endif
+        }
+
+        return;
+    }
+
+    for (size_t o = 0; o < OuterCount; o++) {
+
+        const float* input = Input + o * ReduceCount * InnerStride;
+        float* output = Output + o * InnerStride;
+
+        if (Kind == MlasLogSumExpReduction) {
+            MlasReduceLogSumExpColumns(input, output, ReduceCount, InnerCount, InnerStride);
+        } else {
+#if defined(MLAS_TARGET_AMD64)
+            GetMlasPlatform().ReduceColumnsF32Kernel(Kind, input, output, ReduceCount, InnerCount, InnerStride);
+#else
+            MlasReduceColumnsF32Kernel(Kind, input, output, ReduceCount, InnerCount, InnerStride);
+#endif
+        }
+    }
+}
@@ -1212,6 +1212,26 @@ Return Value:
 
     }
 
+    //
+    // Handle the remaining cases of a small M, including M equals one when the
+    // above kernels do not apply, by streaming matrix B through the small M
+    // kernels.
+    //
+
+#if defined(MLAS_TARGET_AMD64)
+
+    if (M <= MLAS_SGEMM_SMALL_M_MAXIMUM && (TransA == CblasNoTrans || TransB == CblasNoTrans)) {
+
+        MLAS_SGEMM_SMALL_M_KERNEL* SgemmSmallMKernel = GetMlasPlatform().SgemmSmallMKernel;
+
+        if (SgemmSmallMKernel != nullptr) {
+            SgemmSmallMKernel(TransA, TransB, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+            return;
+        }
+    }
+
+#endif
+
     //
     // Compute the strides to step through slices of the input matrices.
     //
@@ -1380,6 +1400,27 @@ Return Value:
 {
     float PanelA[MLAS_SGEMM_TRANSA_ROWS * MLAS_SGEMM_PACKED_STRIDEK];
 
+    //
+    // Handle the special case of a small M. The packed panels of matrix B are
+    // streamed through the small M kernels, which keep all of the rows of the
+    // output in registers.
+    //
+
+#if defined(MLAS_TARGET_AMD64)
+
+    if (M <= MLAS_SGEMM_SMALL_M_MAXIMUM) {
+
+        MLAS_SGEMM_SMALL_M_PACKED_KERNEL* SgemmSmallMPackedKernel = GetMlasPlatform().SgemmSmallMPackedKernel;
+
+        if (SgemmSmallMPackedKernel != nullptr) {
+            SgemmSmallMPackedKernel(TransA, M, RangeStartN, RangeCountN, K, alpha, A, lda, PackedB, AlignedN,
+                beta, C, ldc);
+            return;
+        }
+    }
+
+#endif
+
     //
     // Step through each slice of matrix B along the N dimension.
     //
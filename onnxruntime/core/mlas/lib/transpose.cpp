@@ -810,3 +810,584 @@ MlasTranspose(
         M,
         N);
 }
+
+//
+// Kernels used by the N-dimensional transpose to transpose a block of
+// BlockSize x BlockSize elements and a single row of BlockSize elements.
+//
+
+template<typename ElementType>
+struct MLAS_TRANSPOSE_KERNEL;
+
+template<>
+struct MLAS_TRANSPOSE_KERNEL<uint8_t>
+{
+#if defined(MLAS_TARGET_POWER)
+    static constexpr size_t BlockSize = 16;
+#else
+    static constexpr size_t BlockSize = 8;
+#endif
+
+    static void Block(const uint8_t* Input, size_t InputStride, uint8_t* Output, size_t OutputStride)
+    {
+#if defined(MLAS_TARGET_POWER)
+        MlasTranspose16x16Block(Input, InputStride, Output, OutputStride);
+#elif defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS)
+        MlasTranspose8x8Block(Input, InputStride, Output, OutputStride);
+#else
+        for (size_t i = 0; i < BlockSize; i++) {
+            Vector(Input + i, InputStride, Output + OutputStride * i, 1);
+        }
+#endif
+    }
+
+    static void Vector(const uint8_t* Input, size_t InputStride, uint8_t* Output, size_t OutputStride)
+    {
+#if defined(MLAS_TARGET_POWER)
+        MlasTranspose16xNVector(Input, InputStride, Output, OutputStride);
+#else
+        MlasTranspose8xNVector(Input, InputStride, Output, OutputStride);
+#endif
+    }
+};
+
+template<>
+struct MLAS_TRANSPOSE_KERNEL<uint16_t>
+{
+    static constexpr size_t BlockSize = 4;
+
+    static void Block(const uint16_t* Input, size_t InputStride, uint16_t* Output, size_t OutputStride)
+    {
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS)
+        MlasTranspose4x4Block(Input, InputStride, Output, OutputStride);
+#else
+        for (size_t i = 0; i < BlockSize; i++) {
+            Vector(Input + i, InputStride, Output + OutputStride * i, 1);
+        }
+#endif
+    }
+
+    static void Vector(const uint16_t* Input, size_t InputStride, uint16_t* Output, size_t OutputStride)
+    {
+        MlasTranspose4xNVector(Input, InputStride, Output, OutputStride);
+    }
+};
+
+template<>
+struct MLAS_TRANSPOSE_KERNEL<uint32_t>
+{
+    static constexpr size_t BlockSize = 4;
+
+    static void Block(const uint32_t* Input, size_t InputStride, uint32_t* Output, size_t OutputStride)
+    {
+#if defined(MLAS_SSE2_INTRINSICS) || defined(MLAS_NEON_INTRINSICS) || defined(MLAS_TARGET_POWER)
+        MlasTranspose4x4Block(Input, InputStride, Output, OutputStride);
+#else
+        for (size_t i = 0; i < BlockSize; i++) {
+            Vector(Input + i, InputStride, Output + OutputStride * i, 1);
+        }
+#endif
+    }
+
+    static void Vector(const uint32_t* Input, size_t InputStride, uint32_t* Output, size_t OutputStride)
+    {
+        MlasTranspose4xNVector(Input, InputStride, Output, OutputStride);
+    }
+};
+
+template<>
+struct MLAS_TRANSPOSE_KERNEL<uint64_t>
+{
+    static constexpr size_t BlockSize = 4;
+
+    static void Block(const uint64_t* Input, size_t InputStride, uint64_t* Output, size_t OutputStride)
+    {
+#if defined(MLAS_SSE2_INTRINSICS)
+        for (size_t i = 0; i < BlockSize; i += 2) {
+            for (size_t j = 0; j < BlockSize; j += 2) {
+                const uint64_t* s = &Input[InputStride * i + j];
+                uint64_t* d = &Output[OutputStride * j + i];
+                __m128i a0 = _mm_loadu_si128((const __m128i*)&s[InputStride * 0]);
+                __m128i a1 = _mm_loadu_si128((const __m128i*)&s[InputStride * 1]);
+                _mm_storeu_si128((__m128i*)&d[OutputStride * 0], _mm_unpacklo_epi64(a0, a1));
+                _mm_storeu_si128((__m128i*)&d[OutputStride * 1], _mm_unpackhi_epi64(a0, a1));
+            }
+        }
+#else
+        for (size_t i = 0; i < BlockSize; i++) {
+            Vector(Input + i, InputStride, Output + OutputStride * i, 1);
+        }
+#endif
+    }
+
+    static void Vector(const uint64_t* Input, size_t InputStride, uint64_t* Output, size_t OutputStride)
+    {
+        MlasTranspose4xNVector(Input, InputStride, Output, OutputStride);
+    }
+};
+
+template<typename ElementType>
+void
+MlasTransposeTile(
+    const ElementType* Input,
+    size_t InputStride,
+    ElementType* Output,
+    size_t OutputStride,
+    size_t M,
+    size_t N
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes a strided input matrix (M rows by N columns) to a
+    strided output matrix (N rows by M columns).
+
+Arguments:
+
+    Input - Supplies the input buffer.
+
+    InputStride - Supplies the number of elements between rows of the input
+        matrix.
+
+    Output - Supplies the output buffer.
+
+    OutputStride - Supplies the number of elements between rows of the output
+        matrix.
+
+    M - Supplies the number of rows for the input matrix and the number of
+        columns for the output matrix.
+
+    N - Supplies the number of columns for the input matrix and the number of
+        rows for the output matrix.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    using Kernel = MLAS_TRANSPOSE_KERNEL<ElementType>;
+
+    constexpr size_t BlockSize = Kernel::BlockSize;
+
+    size_t n = N;
+
+    while (n >= BlockSize) {
+
+        const ElementType* s = Input;
+        ElementType* d = Output;
+        size_t m = M;
+
+        while (m >= BlockSize) {
+
+            Kernel::Block(s, InputStride, d, OutputStride);
+
+            s += InputStride * BlockSize;
+            d += BlockSize;
+            m -= BlockSize;
+        }
+
+        while (m > 0) {
+
+            Kernel::Vector(s, 1, d, OutputStride);
+
+            s += InputStride;
+            d += 1;
+            m -= 1;
+        }
+
+        Input += BlockSize;
+        Output += OutputStride * BlockSize;
+        n -= BlockSize;
+    }
+
+    while (n > 0) {
+
+        const ElementType* s = Input;
+        ElementType* d = Output;
+        size_t m = M;
+
+        while (m >= BlockSize) {
+
+            Kernel::Vector(s, InputStride, d, 1);
+
+            s += InputStride * BlockSize;
+            d += BlockSize;
+            m -= BlockSize;
+        }
+
+        while (m > 0) {
+
+            d[0] = s[0];
+
+            s += InputStride;
+            d += 1;
+            m -= 1;
+        }
+
+        Input += 1;
+        Output += OutputStride;
+        n -= 1;
+    }
+}
+
+//
+// Returns the number of rows and columns of a tile of the N-dimensional
+// transpose, so that the input and output of a tile stay in the L1 cache.
+//
+
+constexpr
+size_t
+MlasTransposeNdTileSize(
+    size_t ElementSize
+    )
+{
+    return (ElementSize == 8) ? 32 : 64;
+}
+
+//
+// Describes a transpose after removing the unit axes and merging the axes
+// that stay adjacent in the output. The axes are in output order, so the
+// output strides decrease and the last axis is contiguous in the output.
+//
+
+struct MLAS_TRANSPOSE_ND_SHAPE {
+    size_t Rank;
+    size_t Dims[MLAS_TRANSPOSE_MAXIMUM_DIMENSIONS];
+    size_t InputStrides[MLAS_TRANSPOSE_MAXIMUM_DIMENSIONS];
+    size_t OutputStrides[MLAS_TRANSPOSE_MAXIMUM_DIMENSIONS];
+};
+
+void
+MlasTransposeNdCanonicalize(
+    size_t Rank,
+    const size_t* InputShape,
+    const size_t* Permutation,
+    MLAS_TRANSPOSE_ND_SHAPE* Shape
+    )
+{
+    size_t InputStrides[MLAS_TRANSPOSE_MAXIMUM_DIMENSIONS];
+
+    size_t Stride = 1;
+
+    for (size_t i = Rank; i > 0; i--) {
+        InputStrides[i - 1] = Stride;
+        Stride *= InputShape[i - 1];
+    }
+
+    //
+    // Walk the axes in output order, skipping the unit axes and folding an
+    // axis into the previous one when it is the next input axis.
+    //
+
+    size_t r = 0;
+    size_t PreviousAxis = 0;
+
+    for (size_t i = 0; i < Rank; i++) {
+
+        const size_t Axis = Permutation[i];
+
+        if (InputShape[Axis] == 1) {
+            continue;
+        }
+
+        bool Adjacent = (r > 0);
+
+        for (size_t a = PreviousAxis + 1; Adjacent && a < Axis; a++) {
+            Adjacent = (InputShape[a] == 1);
+        }
+
+        if (Adjacent && Axis > PreviousAxis) {
+            Shape->Dims[r - 1] *= InputShape[Axis];
+            Shape->InputStrides[r - 1] = InputStrides[Axis];
+        } else {
+            Shape->Dims[r] = InputShape[Axis];
+            Shape->InputStrides[r] = InputStrides[Axis];
+            r++;
+        }
+
+        PreviousAxis = Axis;
+    }
+
+    Stride = 1;
+
+    for (size_t i = r; i > 0; i--) {
+        Shape->OutputStrides[i - 1] = Stride;
+        Stride *= Shape->Dims[i - 1];
+    }
+
+    Shape->Rank = r;
+}
+
+void
+MlasTransposeNdCopyRuns(
+    const MLAS_TRANSPOSE_ND_SHAPE& Shape,
+    const uint8_t* Input,
+    uint8_t* Output,
+    size_t ElementSize,
+    size_t RunIndex,
+    size_t RunCount
+    )
+/*++
+
+Routine Description:
+
+    This routine copies the contiguous runs of a transpose that keeps the last
+    input axis in place. A run is the last axis of the shape.
+
+--*/
+{
+    const size_t OuterRank = Shape.Rank - 1;
+    const size_t RunBytes = Shape.Dims[OuterRank] * ElementSize;
+
+    size_t Index[MLAS_TRANSPOSE_MAXIMUM_DIMENSIONS];
+    size_t InputOffset = 0;
+
+    size_t Remainder = RunIndex;
+
+    for (size_t i = OuterRank; i > 0; i--) {
+        Index[i - 1] = Remainder % Shape.Dims[i - 1];
+        Remainder /= Shape.Dims[i - 1];
+        InputOffset += Index[i - 1] * Shape.InputStrides[i - 1];
+    }
+
+    Output += RunIndex * RunBytes;
+
+    while (RunCount-- > 0) {
+
+        std::memcpy(Output, Input + InputOffset * ElementSize, RunBytes);
+        Output += RunBytes;
+
+        for (size_t i = OuterRank; i > 0; i--) {
+            InputOffset += Shape.InputStrides[i - 1];
+            if (++Index[i - 1] < Shape.Dims[i - 1]) {
+                break;
+            }
+            InputOffset -= Shape.InputStrides[i - 1] * Index[i - 1];
+            Index[i - 1] = 0;
+        }
+    }
+}
+
+template<typename ElementType>
+void
+MlasTransposeNdTiles(
+    const MLAS_TRANSPOSE_ND_SHAPE& Shape,
+    const ElementType* Input,
+    ElementType* Output,
+    size_t TileIndex,
+    size_t TileCount
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes the tiles of a transpose that moves the last input
+    axis. Each tile is a strided 2-D transpose between the axis that is
+    contiguous in the input and the axis that is contiguous in the output. The
+    tiles are ordered by the other output axes, then by the rows of the output
+    and then by the columns of the output.
+
+--*/
+{
+    constexpr size_t TileSize = MlasTransposeNdTileSize(sizeof(ElementType));
+
+    const size_t Rank = Shape.Rank;
+
+    //
+    // The input matrix of a tile has rows along the last output axis and
+    // columns along the axis that is contiguous in the input.
+    //
+
+    size_t ColumnAxis = 0;
+
+    while (Shape.InputStrides[ColumnAxis] != 1) {
+        ColumnAxis++;
+    }
+
+    const size_t M = Shape.Dims[Rank - 1];
+    const size_t N = Shape.Dims[ColumnAxis];
+    const size_t InputStride = Shape.InputStrides[Rank - 1];
+    const size_t OutputStride = Shape.OutputStrides[ColumnAxis];
+
+    const size_t TileCountM = MlasDivRoundup(M, TileSize);
+    const size_t TileCountN = MlasDivRoundup(N, TileSize);
+
+    for (size_t t = TileIndex; t < TileIndex + TileCount; t++) {
+
+        const size_t tm = t % TileCountM;
+        const size_t tn = (t / TileCountM) % TileCountN;
+
+        size_t Remainder = t / (TileCountM * TileCountN);
+        size_t InputOffset = tm * TileSize * InputStride + tn * TileSize;
+        size_t OutputOffset = tn * TileSize * OutputStride + tm * TileSize;
+
+        for (size_t i = Rank - 1; i > 0; i--) {
+            if (i - 1 != ColumnAxis) {
+                const size_t Index = Remainder % Shape.Dims[i - 1];
+                Remainder /= Shape.Dims[i - 1];
+                InputOffset += Index * Shape.InputStrides[i - 1];
+                OutputOffset += Index * Shape.OutputStrides[i - 1];
+            }
+        }
+
+        MlasTransposeTile(Input + InputOffset, InputStride, Output + OutputOffset, OutputStride,
+                          std::min(TileSize, M - tm * TileSize), std::min(TileSize, N - tn * TileSize));
+    }
+}
+
+void
+MLASCALL
+MlasTransposeNd(
+    const void* Input,
+    void* Output,
+    size_t ElementSize,
+    size_t Rank,
+    const size_t* InputShape,
+    const size_t* Permutation,
+    MLAS_THREADPOOL* ThreadPool
+    )
+/*++
+
+Routine Description:
+
+    This routine transposes an N-dimensional tensor.
+
+    The unit axes are removed and the axes that stay adjacent in the output
+    are merged. When the last input axis stays the last output axis, the
+    output is a sequence of contiguous runs of the input that are copied.
+    Otherwise, the output is built from cache sized tiles of strided 2-D
+    transposes between the axis contiguous in the input and the axis
+    contiguous in the output. The runs or the tiles are split among the
+    threads.
+
+Arguments:
+
+    Input - Supplies the input tensor.
+
+    Output - Supplies the output tensor.
+
+    ElementSize - Supplies the size in bytes of an element, one of 1, 2, 4 or
+        8 bytes.
+
+    Rank - Supplies the number of dimensions of the tensor, at most
+        MLAS_TRANSPOSE_MAXIMUM_DIMENSIONS.
+
+    InputShape - Supplies the shape of the input tensor.
+
+    Permutation - Supplies the input axis of each output axis.
+
+    ThreadPool - Supplies the thread pool object to use, else nullptr if the
+        base library threading support should be used.
+
+Return Value:
+
+    None.
+
+--*/
+{
+    if (Rank > MLAS_TRANSPOSE_MAXIMUM_DIMENSIONS) {
+        MLAS_THROW_EX(std::invalid_argument, "Rank of transpose exceeds MLAS_TRANSPOSE_MAXIMUM_DIMENSIONS");
+    }
+
+    size_t TotalElements = 1;
+
+    for (size_t i = 0; i < Rank; i++) {
+        TotalElements *= InputShape[i];
+    }
+
+    if (TotalElements == 0) {
+        return;
+    }
+
+    MLAS_TRANSPOSE_ND_SHAPE Shape;
+
+    MlasTransposeNdCanonicalize(Rank, InputShape, Permutation, &Shape);
+
+    const bool CopyRuns = (Shape.Rank <= 1) || (Shape.InputStrides[Shape.Rank - 1] == 1);
+
+    size_t WorkCount;
+
+    if (CopyRuns) {
+
+        if (Shape.Rank == 0) {
+            Shape.Rank = 1;
+            Shape.Dims[0] = 1;
+            Shape.InputStrides[0] = 1;
+            Shape.OutputStrides[0] = 1;
+        }
+
+        WorkCount = TotalElements / Shape.Dims[Shape.Rank - 1];
+
+    } else {
+
+        const size_t TileSize = MlasTransposeNdTileSize(ElementSize);
+
+        WorkCount = 1;
+
+        for (size_t i = 0; i < Shape.Rank; i++) {
+            if (i == Shape.Rank - 1 || Shape.InputStrides[i] == 1) {
+                WorkCount *= MlasDivRoundup(Shape.Dims[i], TileSize);
+            } else {
+                WorkCount *= Shape.Dims[i];
+            }
+        }
+    }
+
+    //
+    // Keep each thread copying a minimum number of bytes before using another
+    // thread.
+    //
+
+    constexpr size_t MinimumBytesPerThread = 65536;
+
+    ptrdiff_t TargetThreadCount = ptrdiff_t((TotalElements * ElementSize) / MinimumBytesPerThread) + 1;
+    ptrdiff_t MaximumThreadCount = MlasGetMaximumThreadCount(ThreadPool);
+
+    if (TargetThreadCount >= MaximumThreadCount) {
+        TargetThreadCount = MaximumThreadCount;
+    }
+    if (size_t(TargetThreadCount) > WorkCount) {
+        TargetThreadCount = ptrdiff_t(WorkCount);
+    }
+
+    MlasTrySimpleParallel(ThreadPool, TargetThreadCount, [&](ptrdiff_t tid) {
+
+        size_t WorkIndex;
+        size_t WorkRemaining;
+
+        MlasPartitionWork(tid, TargetThreadCount, WorkCount, &WorkIndex, &WorkRemaining);
+
+        if (WorkRemaining == 0) {
+            return;
+        }
+
+        if (CopyRuns) {
+            MlasTransposeNdCopyRuns(Shape, static_cast<const uint8_t*>(Input), static_cast<uint8_t*>(Output),
+                                    ElementSize, WorkIndex, WorkRemaining);
+            return;
+        }
+
+        switch (ElementSize) {
+            case 1:
+                MlasTransposeNdTiles(Shape, static_cast<const uint8_t*>(Input), static_cast<uint8_t*>(Output),
+                                     WorkIndex, WorkRemaining);
+                break;
+            case 2:
+                MlasTransposeNdTiles(Shape, static_cast<const uint16_t*>(Input), static_cast<uint16_t*>(Output),
+                                     WorkIndex, WorkRemaining);
+                break;
+            case 4:
+                MlasTransposeNdTiles(Shape, static_cast<const uint32_t*>(Input), static_cast<uint32_t*>(Output),
+                                     WorkIndex, WorkRemaining);
+                break;
+            case 8:
+                MlasTransposeNdTiles(Shape, static_cast<const uint64_t*>(Input), static_cast<uint64_t*>(Output),
+                                     WorkIndex, WorkRemaining);
+                break;
+            default:
+                MLAS_THROW_EX(std::invalid_argument, "Element size of transpose must be 1, 2, 4 or 8 bytes");
+        }
+    });
+}
@@ -0,0 +1,114 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/optimizer/zipmap_columnar_output.h"
+
+#include "core/common/common.h"
+#include "core/graph/graph_utils.h"
+#include "core/graph/graph_viewer.h"
+
+namespace onnxruntime {
+
+namespace {
+
+constexpr auto* kTransformerName = "ZipMapColumnarOutput";
+
+// Returns the labels of a ZipMap node as a 1-D tensor.
+ONNX_NAMESPACE::TensorProto GetLabels(const Node& zipmap, const std::string& name) {
+  ONNX_NAMESPACE::TensorProto labels;
+  labels.set_name(name);
+
+  const auto* strings = graph_utils::GetNodeAttribute(zipmap, "classlabels_strings");
+  if (strings != nullptr && strings->strings_size() > 0) {
+    labels.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_STRING);
+    labels.add_dims(strings->strings_size());
+    *labels.mutable_string_data() = strings->strings();
+  } else {
+    const auto* ints = graph_utils::GetNodeAttribute(zipmap, "classlabels_int64s");
+    labels.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_INT64);
+    labels.add_dims(ints != nullptr ? ints->ints_size() : 0);
+    if (ints != nullptr) {
+      *labels.mutable_int64_data() = ints->ints();
+    }
+  }
+
+  return labels;
+}
+
+}  // namespace
+
+Status ZipMapColumnarOutput::ApplyImpl(Graph& graph, bool& modified, int /*graph_level*/,
+                                       const logging::Logger& logger) const {
+  // the outputs of a subgraph are typed by the node that owns it, only the outputs of the main graph are rewritten.
+  // the rewritten graph uses Identity, so the model must import the ONNX domain as well as the ML one.
+  const auto& domain_to_version = graph.DomainToVersionMap();
+  if (domain_to_version.find(kOnnxDomain) == domain_to_version.end()) {
+    LOGS(logger, WARNING) << kTransformerName << " was not applied as the model does not import the ONNX domain.";
+    return Status::OK();
+  }
+
+  std::vector<const NodeArg*> graph_outputs = graph.GetOutputs();
+  std::vector<const NodeArg*> labels_outputs;
+
+  GraphViewer graph_viewer(graph);
+  for (NodeIndex node_index : graph_viewer.GetNodesInTopologicalOrder()) {
+    Node* node = graph.GetNode(node_index);
+    if (node == nullptr ||
+        !graph_utils::IsSupportedOptypeVersionAndDomain(*node, "ZipMap", {1}, kMLDomain) ||
+        !graph.NodeProducesGraphOutput(*node) || node->GetOutputEdgesCount() != 0) {
+      continue;
+    }
+
+    NodeArg* probabilities = node->MutableInputDefs()[0];
+    NodeArg* output = node->MutableOutputDefs()[0];
+    const std::string node_name = node->Name();
+    const ONNX_NAMESPACE::TensorProto labels =
+        GetLabels(*node, graph.GenerateNodeArgName(output->Name() + "_labels_values"));
+
+    // the producer of X, if any, becomes the producer of the input of the Identity that replaces ZipMap.
+    const bool has_input_edge = node->GetInputEdgesCount() != 0;
+    const NodeIndex src_node_index = has_input_edge ? node->InputEdgesBegin()->GetNode().Index() : 0;
+    const int src_arg_index = has_input_edge ? node->InputEdgesBegin()->GetSrcArgIndex() : 0;
+
+    graph.RemoveNode(node_index);
+
+    // the output keeps its name, so the fetches of the callers are unchanged, and takes the type and shape of X.
+    if (probabilities->TypeAsProto() != nullptr) {
+      graph.SetNodeArgType(*output, *probabilities->TypeAsProto());
+    } else {
+      ONNX_NAMESPACE::TypeProto float_tensor;
+      float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+      graph.SetNodeArgType(*output, float_tensor);
+    }
+
+    Node& identity = graph.AddNode(graph.GenerateNodeName(node_name + "_columnar"), "Identity",
+                                   MakeString("Added by ", kTransformerName), {probabilities}, {output});
+    if (has_input_edge) {
+      graph.AddEdge(src_node_index, identity.Index(), src_arg_index, 0);
+    }
+
+    ONNX_NAMESPACE::TypeProto labels_type;
+    labels_type.mutable_tensor_type()->set_elem_type(labels.data_type());
+    labels_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(labels.dims(0));
+
+    NodeArg& labels_initializer = graph_utils::AddInitializer(graph, labels);
+    NodeArg& labels_output = graph.GetOrCreateNodeArg(graph.GenerateNodeArgName(output->Name() + "_labels"),
+                                                      &labels_type);
+    graph.AddNode(graph.GenerateNodeName(node_name + "_labels"), "Identity",
+                  MakeString("Added by ", kTransformerName), {&labels_initializer}, {&labels_output});
+    labels_outputs.push_back(&labels_output);
+
+    LOGS(logger, VERBOSE) << kTransformerName << " replaced " << node_name << " by the columnar outputs "
+                          << output->Name() << " and " << labels_output.Name();
+  }
+
+  if (!labels_outputs.empty()) {
+    graph_outputs.insert(graph_outputs.end(), labels_outputs.begin(), labels_outputs.end());
+    graph.SetOutputs(graph_outputs);
+    modified = true;
+  }
+
+  return Status::OK();
+}
+
+}  // namespace onnxruntime
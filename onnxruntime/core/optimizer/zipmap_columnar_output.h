@@ -0,0 +1,39 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include "core/optimizer/graph_transformer.h"
+
+namespace onnxruntime {
+
+/**
+ * Graph transformer that makes the ZipMap nodes producing graph outputs return their probabilities in columnar form,
+ * as a dense float tensor and a tensor with the class labels, instead of a sequence of maps.
+ *
+ * It is applied when kOrtSessionOptionsConfigZipMapColumnarOutput is set, as it changes the outputs of the model.
+ * Only a ZipMap whose output has no consumer in the graph is rewritten.
+ *
+ * Before:
+ *
+ *   X -> ZipMap -> Z                    (Z: seq(map(string|int64, float)))
+ *
+ * After:
+ *
+ *   X -> Identity -> Z                  (Z: tensor(float) with the shape of X)
+ *
+ *   labels -> Identity -> Z_labels      (Z_labels: tensor(string|int64) [C], labels is an initializer)
+ *
+ * The labels output is appended to the graph outputs. Its name is the name of the ZipMap output followed by
+ * "_labels", with a unique suffix if the model already has a value with that name. The labels are in the column
+ * order of X, a label repeated in the ZipMap attributes is repeated in the labels output.
+ */
+class ZipMapColumnarOutput : public GraphTransformer {
+ public:
+  ZipMapColumnarOutput() noexcept : GraphTransformer("ZipMapColumnarOutput") {}
+
+ private:
+  Status ApplyImpl(Graph& graph, bool& modified, int graph_level, const logging::Logger& logger) const override;
+};
+
+}  // namespace onnxruntime
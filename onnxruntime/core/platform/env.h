@@ -84,6 +84,12 @@ struct ThreadOptions {
   // The process that owns the thread may consider setting its affinity.
   std::vector<LogicalProcessors> affinities;
 
+  // The NUMA node of each thread, with the same indexing as affinities. A value of -1 means the node is unknown.
+  // If the vector is not empty, the thread pool groups its threads by node. Work submitted by a thread that is bound
+  // to a node (see ThreadPool::NumaNodeBinding) is queued on the threads of that node, and idle threads prefer to
+  // steal work from threads on the same node.
+  std::vector<int> numa_nodes;
+
   // Set or unset denormal as zero.
   bool set_denormal_as_zero = false;
 
@@ -141,6 +147,22 @@ class Env {
 
   virtual std::vector<LogicalProcessors> GetDefaultThreadAffinities() const = 0;
 
+  /// <summary>
+  /// Returns the logical processors of each NUMA node, indexed by node id.
+  /// </summary>
+  /// <returns>The NUMA topology, or an empty vector if it is not available on this platform</returns>
+  virtual std::vector<LogicalProcessors> GetNumaTopology() const { return {}; }
+
+  /// \brief Gets the logical processors the calling thread is allowed to run on.
+  virtual common::Status GetCurrentThreadAffinity(LogicalProcessors& /*affinity*/) const {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Getting thread affinity is not implemented on this platform.");
+  }
+
+  /// \brief Restricts the calling thread to run on the given logical processors.
+  virtual common::Status SetCurrentThreadAffinity(const LogicalProcessors& /*affinity*/) const {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, NOT_IMPLEMENTED, "Setting thread affinity is not implemented on this platform.");
+  }
+
   /// \brief Returns the number of micro-seconds since the Unix epoch.
   virtual uint64_t NowMicros() const {
     return env_time_->NowMicros();
@@ -0,0 +1,107 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/numa_topology.h"
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+
+#include "core/common/common.h"
+#include "core/common/parse_string.h"
+#include "core/common/string_utils.h"
+
+namespace onnxruntime {
+
+namespace {
+std::string_view TrimWhitespace(std::string_view str) {
+  const auto begin = str.find_first_not_of(" \t\r\n");
+  if (begin == std::string_view::npos) {
+    return {};
+  }
+  const auto end = str.find_last_not_of(" \t\r\n");
+  return str.substr(begin, end - begin + 1);
+}
+
+common::Status ReadFirstLine(const std::string& file_path, std::string& line) {
+  std::ifstream file(file_path);
+  ORT_RETURN_IF_NOT(file, "Failed to open ", file_path);
+  std::getline(file, line);
+  ORT_RETURN_IF(file.bad(), "Failed to read ", file_path);
+  return common::Status::OK();
+}
+}  // namespace
+
+common::Status ParseCpuList(std::string_view cpu_list, LogicalProcessors& processors) {
+  processors.clear();
+
+  for (const auto& range_str : utils::SplitString(TrimWhitespace(cpu_list), ",")) {
+    const auto range = utils::SplitString(TrimWhitespace(range_str), "-", true);
+    ORT_RETURN_IF(range.empty() || range.size() > 2, "Invalid processor range \"", range_str, "\" in cpu list.");
+
+    int first = 0;
+    int last = 0;
+    ORT_RETURN_IF_NOT(TryParseStringWithClassicLocale(range.front(), first) &&
+                          TryParseStringWithClassicLocale(range.back(), last) &&
+                          first >= 0 && first <= last,
+                      "Invalid processor range \"", range_str, "\" in cpu list.");
+
+    const size_t begin = processors.size();
+    processors.resize(begin + static_cast<size_t>(last - first) + 1);
+    std::iota(processors.begin() + begin, processors.end(), first);
+  }
+
+  return common::Status::OK();
+}
+
+common::Status ParseNumaTopology(std::string_view topology_str, NumaTopology& topology) {
+  topology.clear();
+
+  for (const auto& node_str : utils::SplitString(topology_str, ";", true)) {
+    LogicalProcessors processors;
+    ORT_RETURN_IF_ERROR(ParseCpuList(node_str, processors));
+    topology.push_back(std::move(processors));
+  }
+
+  ORT_RETURN_IF(topology.empty(), "NUMA topology must contain at least one node.");
+  return common::Status::OK();
+}
+
+common::Status ReadNumaTopologyFromSysfs(const std::string& node_dir, NumaTopology& topology) {
+  topology.clear();
+
+  std::string online_nodes_str;
+  ORT_RETURN_IF_ERROR(ReadFirstLine(node_dir + "/online", online_nodes_str));
+
+  // the node id list uses the same format as a cpu list
+  LogicalProcessors online_nodes;
+  ORT_RETURN_IF_ERROR(ParseCpuList(online_nodes_str, online_nodes));
+  ORT_RETURN_IF(online_nodes.empty(), "No online NUMA nodes in ", node_dir);
+
+  topology.resize(static_cast<size_t>(online_nodes.back()) + 1);
+  for (const int node : online_nodes) {
+    std::string cpu_list;
+    ORT_RETURN_IF_ERROR(ReadFirstLine(MakeString(node_dir, "/node", node, "/cpulist"), cpu_list));
+    ORT_RETURN_IF_ERROR(ParseCpuList(cpu_list, topology[node]));
+  }
+
+  return common::Status::OK();
+}
+
+size_t GetNumberOfNumaNodesWithProcessors(const NumaTopology& topology) {
+  return static_cast<size_t>(std::count_if(topology.begin(), topology.end(),
+                                           [](const LogicalProcessors& processors) { return !processors.empty(); }));
+}
+
+int GetNumaNodeOfProcessor(const NumaTopology& topology, int processor) {
+  for (size_t node = 0; node < topology.size(); ++node) {
+    const auto& processors = topology[node];
+    if (std::find(processors.begin(), processors.end(), processor) != processors.end()) {
+      return static_cast<int>(node);
+    }
+  }
+
+  return -1;
+}
+
+}  // namespace onnxruntime
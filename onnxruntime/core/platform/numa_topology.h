@@ -0,0 +1,47 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "core/common/status.h"
+#include "core/platform/env.h"
+
+namespace onnxruntime {
+
+/// The logical processors of each NUMA node, indexed by node id.
+/// A node without processors (e.g. a memory-only node) has an empty entry.
+using NumaTopology = std::vector<LogicalProcessors>;
+
+/**
+ * Parses a list of logical processors in the Linux cpulist format, e.g. "0-3,8-11".
+ * Processor ids start from 0.
+ */
+common::Status ParseCpuList(std::string_view cpu_list, LogicalProcessors& processors);
+
+/**
+ * Parses a NUMA topology from a string of the form "<node 0 cpulist>;<node 1 cpulist>;...", e.g. "0-3;4-7".
+ * This allows a NUMA topology to be emulated on a machine with a single node.
+ */
+common::Status ParseNumaTopology(std::string_view topology_str, NumaTopology& topology);
+
+/**
+ * Reads the NUMA topology from a sysfs node directory, e.g. "/sys/devices/system/node".
+ * The node ids are read from "<node_dir>/online" and the processors of node N from "<node_dir>/nodeN/cpulist".
+ */
+common::Status ReadNumaTopologyFromSysfs(const std::string& node_dir, NumaTopology& topology);
+
+/**
+ * Gets the number of NUMA nodes that have processors.
+ */
+size_t GetNumberOfNumaNodesWithProcessors(const NumaTopology& topology);
+
+/**
+ * Gets the id of the NUMA node containing the given logical processor, or -1 if it is not in the topology.
+ */
+int GetNumaNodeOfProcessor(const NumaTopology& topology, int processor);
+
+}  // namespace onnxruntime
@@ -47,6 +47,7 @@ limitations under the License.
 #include "core/common/gsl.h"
 #include "core/common/logging/logging.h"
 #include "core/common/narrow.h"
+#include "core/platform/numa_topology.h"
 #include "core/platform/scoped_resource.h"
 #include "core/platform/EigenNonBlockingThreadPool.h"
 
@@ -324,6 +325,56 @@ class PosixEnv : public Env {
     return ret;
   }
 
+  std::vector<LogicalProcessors> GetNumaTopology() const override {
+    NumaTopology topology;
+#if defined(__linux__) && !defined(__ANDROID__)
+    auto status = ReadNumaTopologyFromSysfs("/sys/devices/system/node", topology);
+    if (!status.IsOK()) {
+      LOGS_DEFAULT(VERBOSE) << "Unable to read the NUMA topology: " << status.ErrorMessage();
+      topology.clear();
+    }
+#endif
+    return topology;
+  }
+
+#if !defined(__APPLE__) && !defined(__ANDROID__) && !defined(__wasm__) && !defined(_AIX)
+  common::Status GetCurrentThreadAffinity(LogicalProcessors& affinity) const override {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    auto ret = pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+    if (ret != 0) {
+      auto [err_no, err_msg] = GetSystemError(ret);
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "pthread_getaffinity_np failed, error code: ", err_no,
+                             " error msg: ", err_msg);
+    }
+
+    affinity.clear();
+    for (int id = 0; id < CPU_SETSIZE; ++id) {
+      if (CPU_ISSET(id, &cpuset)) {
+        affinity.push_back(id);
+      }
+    }
+    return Status::OK();
+  }
+
+  common::Status SetCurrentThreadAffinity(const LogicalProcessors& affinity) const override {
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (auto id : affinity) {
+      if (id > -1 && id < CPU_SETSIZE) {
+        CPU_SET(id, &cpuset);
+      }
+    }
+    auto ret = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset);
+    if (ret != 0) {
+      auto [err_no, err_msg] = GetSystemError(ret);
+      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "pthread_setaffinity_np failed, error code: ", err_no,
+                             " error msg: ", err_msg);
+    }
+    return Status::OK();
+  }
+#endif
+
   void SleepForMicroseconds(int64_t micros) const override {
     while (micros > 0) {
       timespec sleep_time;
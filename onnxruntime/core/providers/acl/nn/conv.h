@@ -49,6 +49,14 @@ class Conv : public onnxruntime::Conv<T> {
 
   Status Compute(OpKernelContext* context) const override;
 
+  // The filter is read directly, so the CPU Winograd pre-packing is disabled.
+  Status PrePack(const Tensor& /*tensor*/, int /*input_idx*/, AllocatorPtr /*alloc*/,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* /*prepacked_weights*/) override {
+    is_packed = false;
+    return Status::OK();
+  }
+
  protected:
   static thread_local std::map<OpKernel*, ACLNEConv> convLayers;
   ConvAttributes conv_attrs_;
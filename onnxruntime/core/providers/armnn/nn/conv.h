@@ -32,6 +32,14 @@ class Conv : public onnxruntime::Conv<T> {
 
   Status Compute(OpKernelContext* context) const override;
 
+  // The filter is read directly, so the CPU Winograd pre-packing is disabled.
+  Status PrePack(const Tensor& /*tensor*/, int /*input_idx*/, AllocatorPtr /*alloc*/,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* /*prepacked_weights*/) override {
+    is_packed = false;
+    return Status::OK();
+  }
+
   static armnn::IRuntimePtr initRuntime(){
     if(Conv::run)
       return std::move(Conv::run);
@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+//
+// This file contains implementation of a bfloat16 Gemm operator.
+//
+
+#include "core/common/safeint.h"
+#include "core/framework/float16.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/gemm_base.h"
+#include "core/providers/cpu/math/gemm_helper.h"
+
+namespace onnxruntime {
+
+/**
+ * @brief Gemm Operator for BFloat16 tensors, computed by the MLAS bfloat16 GEMM.
+ *
+ * The bias is broadcast and the products are accumulated in fp32, and the result
+ * is converted to bfloat16 at the end. A constant matrix B is packed once in PrePack.
+*/
+class GemmBf16 final : protected GemmBase, public OpKernel {
+ public:
+  GemmBf16(const OpKernelInfo& info) : GemmBase(info), OpKernel(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
+ private:
+  TensorShape b_shape_;
+  BufferUniquePtr packed_b_;
+};
+
+Status GemmBf16::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                         /*out*/ bool& is_packed,
+                         /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  // only pack Matrix B
+  if (input_idx != 1 || tensor.Shape().NumDimensions() != 2) {
+    return Status::OK();
+  }
+
+  const bool trans_b = trans_B_ != CblasNoTrans;
+  const size_t K = static_cast<size_t>(trans_b ? tensor.Shape()[1] : tensor.Shape()[0]);
+  const size_t N = static_cast<size_t>(trans_b ? tensor.Shape()[0] : tensor.Shape()[1]);
+
+  const size_t packed_b_size = MlasBf16GemmPackBSize(N, K);
+  if (packed_b_size == 0) {
+    return Status::OK();
+  }
+
+  auto* packed_b_data = alloc->Alloc(packed_b_size);
+
+  // Initialize memory to 0 as there could be some padding associated with pre-packed
+  // buffer memory and we don not want it uninitialized and generate different hashes
+  // if and when we try to cache this pre-packed buffer for sharing between sessions.
+  memset(packed_b_data, 0, packed_b_size);
+
+  packed_b_ = BufferUniquePtr(packed_b_data, BufferDeleter(std::move(alloc)));
+  MlasBf16GemmPackB(trans_B_, N, K, tensor.Data<BFloat16>(), trans_b ? K : N, packed_b_data);
+  b_shape_ = tensor.Shape();
+  is_packed = true;
+
+  if (prepacked_weights != nullptr) {
+    prepacked_weights->buffers_.push_back(std::move(packed_b_));
+    prepacked_weights->buffer_sizes_.push_back(packed_b_size);
+  }
+
+  return Status::OK();
+}
+
+Status GemmBf16::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                           /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    used_shared_buffers = true;
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
+Status GemmBf16::Compute(OpKernelContext* context) const {
+  concurrency::ThreadPool* thread_pool = context->GetOperatorThreadPool();
+
+  const auto* A = context->Input<Tensor>(0);
+  const auto* B = packed_b_ ? nullptr : context->Input<Tensor>(1);
+  const auto* C = context->Input<Tensor>(2);
+
+  // Bias could be missing. Treat as scalar 0 if that is the case.
+  GemmHelper helper(A->Shape(), trans_A_ != CblasNoTrans, B ? B->Shape() : b_shape_, trans_B_ != CblasNoTrans,
+                    C != nullptr ? C->Shape() : TensorShape({}));
+
+  if (!helper.State().IsOK())
+    return helper.State();
+
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+
+  auto Y = context->Output(0, {helper.M(), helper.N()});
+
+  // if input is empty tensor, return as nothing need to be calculated and we've set the shape for the output
+  if (M == 0 || N == 0)
+    return Status::OK();
+
+  const size_t y_size = SafeInt<size_t>(M) * N;
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(context->GetTempSpaceAllocator(&alloc));
+  auto y_fp32 = IAllocator::MakeUniquePtr<float>(alloc, y_size);
+
+  // Widen the bias to fp32 and broadcast it into the output buffer.
+  const bool use_bias = C != nullptr && beta_ != 0.0f;
+  if (use_bias) {
+    const size_t c_size = SafeInt<size_t>(C->Shape().Size());
+    auto c_fp32 = IAllocator::MakeUniquePtr<float>(alloc, c_size);
+    BFloat16ToFloat(C->Data<BFloat16>(), c_fp32.get(), c_size);
+    GemmBroadcastBias(helper.M(), helper.N(), beta_, c_fp32.get(), &C->Shape(), y_fp32.get());
+  }
+
+  MLAS_BF16_GEMM_DATA_PARAMS data;
+  data.A = A->Data<BFloat16>();
+  data.lda = trans_A_ != CblasNoTrans ? M : K;
+  if (packed_b_) {
+    data.B = packed_b_.get();
+    data.ldb = 0;
+  } else {
+    data.B = B->Data<BFloat16>();
+    data.ldb = trans_B_ != CblasNoTrans ? K : N;
+  }
+  data.C = y_fp32.get();
+  data.ldc = N;
+  data.alpha = alpha_;
+  data.beta = use_bias ? beta_ : 0.0f;
+
+  MlasBf16GemmBatch(trans_A_, trans_B_, M, N, K, &data, 1, thread_pool);
+
+  FloatToBFloat16(y_fp32.get(), Y->MutableData<BFloat16>(), y_size);
+
+  return Status::OK();
+}
+
+//
+// Operator definitions
+//
+
+// opset 13 adds BFloat16 to the Gemm types
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    Gemm,
+    13,
+    BFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<BFloat16>()),
+    GemmBf16);
+
+}  // namespace onnxruntime
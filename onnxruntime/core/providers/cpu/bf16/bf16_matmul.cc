@@ -0,0 +1,153 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+//
+// This file contains implementation of a bfloat16 MatMul operator.
+//
+
+#include "core/common/safeint.h"
+#include "core/framework/float16.h"
+#include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
+#include "core/providers/cpu/math/matmul_helper.h"
+
+namespace onnxruntime {
+
+/**
+ * @brief MatMul Operator for BFloat16 tensors, computed by the MLAS bfloat16 GEMM.
+ *
+ * The products are accumulated in fp32 and the result is converted to bfloat16
+ * at the end. A constant 2D matrix B is packed once in PrePack.
+*/
+class MatMulBf16 final : public OpKernel {
+ public:
+  MatMulBf16(const OpKernelInfo& info) : OpKernel(info) {}
+
+  Status Compute(OpKernelContext* context) const override;
+
+  Status PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                 /*out*/ bool& is_packed,
+                 /*out*/ PrePackedWeights* prepacked_weights) override;
+
+  Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                   /*out*/ bool& used_shared_buffers) override;
+
+ private:
+  TensorShape b_shape_;
+  BufferUniquePtr packed_b_;
+};
+
+Status MatMulBf16::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                           /*out*/ bool& is_packed,
+                           /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  // only pack Matrix B, and only when it is a 2D matrix shared by all the batches
+  if (input_idx != 1 || tensor.Shape().NumDimensions() != 2) {
+    return Status::OK();
+  }
+
+  const size_t K = static_cast<size_t>(tensor.Shape()[0]);
+  const size_t N = static_cast<size_t>(tensor.Shape()[1]);
+
+  const size_t packed_b_size = MlasBf16GemmPackBSize(N, K);
+  if (packed_b_size == 0) {
+    return Status::OK();
+  }
+
+  auto* packed_b_data = alloc->Alloc(packed_b_size);
+
+  // Initialize memory to 0 as there could be some padding associated with pre-packed
+  // buffer memory and we don not want it uninitialized and generate different hashes
+  // if and when we try to cache this pre-packed buffer for sharing between sessions.
+  memset(packed_b_data, 0, packed_b_size);
+
+  packed_b_ = BufferUniquePtr(packed_b_data, BufferDeleter(std::move(alloc)));
+  MlasBf16GemmPackB(CblasNoTrans, N, K, tensor.Data<BFloat16>(), N, packed_b_data);
+  b_shape_ = tensor.Shape();
+  is_packed = true;
+
+  if (prepacked_weights != nullptr) {
+    prepacked_weights->buffers_.push_back(std::move(packed_b_));
+    prepacked_weights->buffer_sizes_.push_back(packed_b_size);
+  }
+
+  return Status::OK();
+}
+
+Status MatMulBf16::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers, int input_idx,
+                                             /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    used_shared_buffers = true;
+    packed_b_ = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
+Status MatMulBf16::Compute(OpKernelContext* ctx) const {
+  concurrency::ThreadPool* thread_pool = ctx->GetOperatorThreadPool();
+
+  const Tensor* a = ctx->Input<Tensor>(0);
+  const Tensor* b = packed_b_ ? nullptr : ctx->Input<Tensor>(1);
+  const auto& b_shape = b ? b->Shape() : b_shape_;
+
+  MatMulComputeHelper helper;
+  ORT_RETURN_IF_ERROR(helper.Compute(a->Shape(), b_shape));
+  Tensor* y = ctx->Output(0, helper.OutputShape());
+
+  // Bail out early if the output is going to be empty
+  if (y->Shape().Size() == 0)
+    return Status::OK();
+
+  const size_t y_size = SafeInt<size_t>(y->Shape().Size());
+
+  AllocatorPtr alloc;
+  ORT_RETURN_IF_ERROR(ctx->GetTempSpaceAllocator(&alloc));
+  auto y_fp32 = IAllocator::MakeUniquePtr<float>(alloc, y_size);
+
+  const auto* a_data = a->Data<BFloat16>();
+  const auto* b_data = b ? b->Data<BFloat16>() : nullptr;
+
+  const size_t max_len = helper.OutputOffsets().size();
+  const size_t M = static_cast<size_t>(helper.M());
+  const size_t N = static_cast<size_t>(helper.N());
+  const size_t K = static_cast<size_t>(helper.K());
+
+  std::vector<MLAS_BF16_GEMM_DATA_PARAMS> data(max_len);
+  for (size_t i = 0; i < max_len; i++) {
+    data[i].A = a_data + helper.LeftOffsets()[i];
+    data[i].lda = K;
+    if (packed_b_) {
+      data[i].B = packed_b_.get();
+      data[i].ldb = 0;
+    } else {
+      data[i].B = b_data + helper.RightOffsets()[i];
+      data[i].ldb = N;
+    }
+    data[i].C = y_fp32.get() + helper.OutputOffsets()[i];
+    data[i].ldc = N;
+  }
+
+  MlasBf16GemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, data.data(), max_len, thread_pool);
+
+  FloatToBFloat16(y_fp32.get(), y->MutableData<BFloat16>(), y_size);
+
+  return Status::OK();
+}
+
+//
+// Operator definitions
+//
+
+// opset 13 adds BFloat16 to the MatMul types
+ONNX_CPU_OPERATOR_TYPED_KERNEL(
+    MatMul,
+    13,
+    BFloat16,
+    KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<BFloat16>()),
+    MatMulBf16);
+
+}  // namespace onnxruntime
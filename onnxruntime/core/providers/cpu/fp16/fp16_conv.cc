@@ -7,7 +7,7 @@
 
 #include "core/mlas/inc/mlas.h"
 
-#ifdef MLAS_F16VEC_INTRINSICS_SUPPORTED
+#ifdef MLAS_F16GEMM_SUPPORTED
 
 #include "core/common/safeint.h"
 #include "core/framework/float16.h"
@@ -146,7 +146,7 @@ Status FusedConvFp16::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr
     packed_W_size_ = MlasHalfGemmPackBSize(group_output_channels, kernel_dim, false);
     if (packed_W_size_ != 0) {
       size_t packed_W_data_size = SafeInt<size_t>(group_count) * packed_W_size_;
-      auto* packed_W = static_cast<MLFloat16*>(alloc->Alloc(packed_W_data_size));
+      auto* packed_W = static_cast<uint8_t*>(alloc->Alloc(packed_W_data_size));
 
       // Initialize memory to 0 as there could be some padding associated with pre-packed
       // buffer memory and we don not want it uninitialized and generate different hashes
@@ -549,7 +549,7 @@ Status FusedConvFp16::Compute(OpKernelContext* context) const {
           gemm_params.A = AData;
           gemm_params.lda = lda;
           if (packed_W_buffer_) {
-            gemm_params.B = static_cast<const MLFloat16*>(packed_W_buffer_.get()) + group_id * packed_W_size_,
+            gemm_params.B = static_cast<const uint8_t*>(packed_W_buffer_.get()) + group_id * packed_W_size_,
             gemm_params.ldb = 0;
           } else {
             gemm_params.B = reordered_W + group_id * group_output_channels,
@@ -640,4 +640,4 @@ ONNX_OPERATOR_TYPED_KERNEL_EX(
 
 }  // namespace onnxruntime
 
-#endif  // MLAS_F16VEC_INTRINSICS_SUPPORTED
+#endif  // MLAS_F16GEMM_SUPPORTED
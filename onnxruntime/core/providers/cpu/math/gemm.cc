@@ -73,15 +73,27 @@ ONNX_CPU_OPERATOR_TYPED_KERNEL(
     KernelDefBuilder().TypeConstraint("T", DataTypeImpl::GetTensorType<double>()),
     Gemm<double>);
 
+size_t GemmPackBFp32Size(const TensorShape& b_shape, bool trans_b) {
+  // Only handle the common case of a 2D weight matrix. Additional matrices
+  // could be handled by stacking the packed buffers.
+  if (b_shape.NumDimensions() != 2) {
+    return 0;
+  }
+
+  const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
+  const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
+
+  return MlasGemmPackBSize(N, K);
+}
+
 bool GemmPackBFp32(AllocatorPtr& alloc,
                    const Tensor& tensor_b,
                    bool trans_b,
                    BufferUniquePtr& packed_b,
                    size_t& packed_b_size,
                    TensorShape& b_shape) {
-  // Only handle the common case of a 2D weight matrix. Additional matrices
-  // could be handled by stacking the packed buffers.
-  if (tensor_b.Shape().NumDimensions() != 2) {
+  packed_b_size = GemmPackBFp32Size(tensor_b.Shape(), trans_b);
+  if (packed_b_size == 0) {
     return false;
   }
   b_shape = tensor_b.Shape();
@@ -89,11 +101,6 @@ bool GemmPackBFp32(AllocatorPtr& alloc,
   const size_t K = trans_b ? static_cast<size_t>(b_shape[1]) : static_cast<size_t>(b_shape[0]);
   const size_t N = trans_b ? static_cast<size_t>(b_shape[0]) : static_cast<size_t>(b_shape[1]);
 
-  packed_b_size = MlasGemmPackBSize(N, K);
-  if (packed_b_size == 0) {
-    return false;
-  }
-
   auto* packed_b_data = alloc->Alloc(packed_b_size);
 
   // Initialize memory to 0 as there could be some padding associated with pre-packed
@@ -175,6 +182,31 @@ Status Gemm<float>::PrePack(const Tensor& tensor, int input_idx,
   return Status::OK();
 }
 
+template <typename T>
+Status Gemm<T>::RestorePrePackState(const Tensor& /*tensor*/, int /*input_idx*/,
+                                    gsl::span<const size_t> /*prepacked_buffer_sizes*/,
+                                    /*out*/ bool& is_restored) {
+  is_restored = false;
+  return Status::OK();
+}
+
+template <>
+Status Gemm<float>::RestorePrePackState(const Tensor& tensor, int input_idx,
+                                        gsl::span<const size_t> prepacked_buffer_sizes,
+                                        /*out*/ bool& is_restored) {
+  is_restored = false;
+
+  // only Matrix B is packed
+  if (input_idx == 1 && prepacked_buffer_sizes.size() == 1) {
+    const size_t packed_b_size = GemmPackBFp32Size(tensor.Shape(), trans_B_ != CblasNoTrans);
+    if (packed_b_size != 0 && packed_b_size == prepacked_buffer_sizes[0]) {
+      b_shape_ = tensor.Shape();
+      is_restored = true;
+    }
+  }
+  return Status::OK();
+}
+
 template <typename T>
 Status Gemm<T>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& /*prepacked_buffers*/,
                                           int /*input_idx*/,
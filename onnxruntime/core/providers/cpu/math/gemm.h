@@ -24,6 +24,10 @@ class Gemm : protected GemmBase, public OpKernel {
                  /*out*/ bool& is_packed,
                  /*out*/ PrePackedWeights* prepacked_weights) override;
 
+  Status RestorePrePackState(const Tensor& tensor, int input_idx,
+                             gsl::span<const size_t> prepacked_buffer_sizes,
+                             /*out*/ bool& is_restored) override;
+
   Status UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
                                    int input_idx,
                                    /*out*/ bool& used_shared_buffers) override;
@@ -7,6 +7,10 @@
 
 namespace onnxruntime {
 
+// Returns the size in bytes of the buffer GemmPackBFp32 produces for a B matrix with the given shape,
+// or 0 if the matrix would not be packed.
+size_t GemmPackBFp32Size(const TensorShape& b_shape, bool trans_b);
+
 bool GemmPackBFp32(AllocatorPtr& alloc,
                    const Tensor& tensor_b,
                    bool trans_b,
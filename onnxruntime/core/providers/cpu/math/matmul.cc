@@ -144,6 +144,22 @@ Status MatMul<float>::PrePack(const Tensor& tensor, int input_idx, /*out*/ Alloc
   return Status::OK();
 }
 
+Status MatMul<float>::RestorePrePackState(const Tensor& tensor, int input_idx,
+                                          gsl::span<const size_t> prepacked_buffer_sizes,
+                                          /*out*/ bool& is_restored) {
+  is_restored = false;
+
+  // only Matrix B is packed
+  if (input_idx == 1 && prepacked_buffer_sizes.size() == 1) {
+    const size_t packed_b_size = GemmPackBFp32Size(tensor.Shape(), trans_b_attr_ != 0);
+    if (packed_b_size != 0 && packed_b_size == prepacked_buffer_sizes[0]) {
+      b_shape_ = tensor.Shape();
+      is_restored = true;
+    }
+  }
+  return Status::OK();
+}
+
 Status MatMul<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
                                                 int input_idx,
                                                 /*out*/ bool& used_shared_buffers) {
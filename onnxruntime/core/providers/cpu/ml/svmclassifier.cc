@@ -12,6 +12,10 @@
 namespace onnxruntime {
 namespace ml {
 
+// The RBF distance of an input and a support vector is computed from their difference when it is below this ratio
+// of the sum of their squared norms, see batched_kernel_dot_support_vectors.
+static constexpr double kRbfExactDistanceRatio = 1e-2;
+
 ONNX_CPU_OPERATOR_ML_KERNEL(
     SVMClassifier,
     1,
@@ -24,6 +28,115 @@ ONNX_CPU_OPERATOR_ML_KERNEL(
         .TypeConstraint("T2", {DataTypeImpl::GetTensorType<int64_t>(), DataTypeImpl::GetTensorType<std::string>()}),
     SVMClassifier);
 
+BufferUniquePtr SVMCommon::pack_gemm_b(const OpKernelInfo& info, gsl::span<const float> b, size_t n, size_t k) {
+  ORT_ENFORCE(b.size() >= n * k);
+
+  const size_t packed_size = MlasGemmPackBSize(n, k);
+  if (packed_size == 0) {
+    return nullptr;
+  }
+
+  AllocatorPtr alloc = info.GetAllocator(OrtMemType::OrtMemTypeDefault);
+  void* packed_data = alloc->Alloc(packed_size);
+  memset(packed_data, 0, packed_size);
+  BufferUniquePtr packed_b(packed_data, BufferDeleter(std::move(alloc)));
+  MlasGemmPackB(CblasTrans, n, k, b.data(), k, packed_data);
+  return packed_b;
+}
+
+void SVMCommon::pack_support_vectors(const OpKernelInfo& info, gsl::span<const float> support_vectors,
+                                     int64_t vector_count, int64_t feature_count) {
+  if (vector_count <= 0 || feature_count <= 0) {
+    return;
+  }
+
+  const size_t N = onnxruntime::narrow<size_t>(vector_count);
+  const size_t K = onnxruntime::narrow<size_t>(feature_count);
+  packed_support_vectors_ = pack_gemm_b(info, support_vectors, N, K);
+  if (!packed_support_vectors_) {
+    return;
+  }
+
+  if (kernel_type_ == KERNEL::RBF) {
+    support_vector_norms_.resize(N);
+    for (size_t i = 0; i < N; ++i) {
+      auto support_vector = ConstEigenVectorMap<float>(support_vectors.data() + i * K, K);
+      support_vector_norms_[i] = support_vector.cast<double>().squaredNorm();
+    }
+  }
+}
+
+void SVMCommon::batched_kernel_dot_support_vectors(gsl::span<const float> a, gsl::span<const float> support_vectors,
+                                                   int64_t m, int64_t n, int64_t k,
+                                                   gsl::span<float> out,
+                                                   concurrency::ThreadPool* threadpool) const {
+  if (!packed_support_vectors_) {
+    batched_kernel_dot<float>(a, support_vectors, m, n, k, 0.f, out, threadpool);
+    return;
+  }
+
+  assert(a.size() == size_t(m * k) && out.size() == size_t(m * n));
+  const size_t M = onnxruntime::narrow<size_t>(m);
+  const size_t N = onnxruntime::narrow<size_t>(n);
+  const size_t K = onnxruntime::narrow<size_t>(k);
+
+  float alpha = 1.f;
+  if (kernel_type_ == KERNEL::RBF) {
+    alpha = -2.f;
+  } else if (kernel_type_ != KERNEL::LINEAR) {
+    alpha = gamma_;
+  }
+
+  MlasGemm(CblasNoTrans, M, N, K, alpha, a.data(), K, packed_support_vectors_.get(), 0.f, out.data(), N, threadpool);
+
+  if (kernel_type_ == KERNEL::LINEAR) {
+    return;
+  }
+
+  // apply the kernel function to each row of the GEMM output
+  auto apply_kernel = [this, &a, &support_vectors, &out, N, K](std::ptrdiff_t first, std::ptrdiff_t last) {
+    for (std::ptrdiff_t row = first; row < last; ++row) {
+      float* cur_out = out.data() + row * N;
+      auto map_out = EigenVectorArrayMap<float>(cur_out, N);
+
+      if (kernel_type_ == KERNEL::RBF) {
+        auto x = ConstEigenVectorMap<float>(a.data() + row * K, K).cast<double>();
+        const double x_norm = x.squaredNorm();
+        for (size_t i = 0; i < N; ++i) {
+          const double norms = x_norm + support_vector_norms_[i];
+          double distance = static_cast<double>(cur_out[i]) + norms;
+          // the error of the float GEMM is relative to the norms, when the vectors are close it can be larger than
+          // their distance so the distance is computed from their difference instead.
+          if (distance < kRbfExactDistanceRatio * norms) {
+            auto support_vector = ConstEigenVectorMap<float>(support_vectors.data() + i * K, K).cast<double>();
+            distance = (x - support_vector).squaredNorm();
+          }
+          cur_out[i] = static_cast<float>(distance * -gamma_);
+        }
+        MlasComputeExp(cur_out, cur_out, N);
+      } else if (kernel_type_ == KERNEL::POLY) {
+        map_out += coef0_;
+        if (degree_ == 2)
+          map_out = map_out.square();
+        else if (degree_ == 3)
+          map_out = map_out.cube();
+        else
+          map_out = map_out.pow(degree_);
+      } else {  // KERNEL::SIGMOID
+        map_out += coef0_;
+        MlasComputeTanh(cur_out, cur_out, N);
+      }
+    }
+  };
+
+  const double cost = kernel_type_ == KERNEL::RBF ? static_cast<double>(K + 2 * N) : static_cast<double>(N);
+  concurrency::ThreadPool::TryParallelFor(threadpool, m,
+                                          TensorOpCost{static_cast<double>(N * sizeof(float)),
+                                                       static_cast<double>(N * sizeof(float)),
+                                                       cost * 4},
+                                          apply_kernel);
+}
+
 SVMClassifier::SVMClassifier(const OpKernelInfo& info)
     : OpKernel(info),
       SVMCommon(info),
@@ -74,6 +187,61 @@ SVMClassifier::SVMClassifier(const OpKernelInfo& info)
   ORT_ENFORCE(coefficients_.size() > 0);
   weights_are_all_positive_ = std::all_of(coefficients_.cbegin(), coefficients_.cend(),
                                           [](float value) { return value >= 0.f; });
+
+  if (mode_ == SVM_TYPE::SVM_SVC) {
+    pack_support_vectors(info, support_vectors_, vector_count_, feature_count_);
+
+    // Rearrange the coefficients as the weights of the one-vs-one classifiers.
+    // coefficients: [num_classes - 1, vector_count_]
+    //
+    // e.g. say you have 3 classes, with 3 x 3 coefficients
+    //
+    // AA AB AC
+    // BA BB BC
+    // CA CB CC
+    //
+    // you can remove the diagonal line of items comparing a class with itself leaving one less row.
+    //
+    // BA AB AC
+    // CA CB BC
+    //
+    // for each class there is a coefficient per support vector, and a class has one or more support vectors.
+    //
+    // The classifier for two classes combines their two blocks of coefficients. e.g. AB combines with BA.
+    // If A has 3 support vectors and B has 2, the weights of the AB classifier are the 3 coefficients of BA for the
+    // support vectors of A, the 2 coefficients of AB for the support vectors of B and 0 for the other classes.
+    const int64_t num_classifiers = class_count_ * (class_count_ - 1) / 2;
+    if (num_classifiers > 0 && vector_count_ > 0) {
+      ORT_ENFORCE(vectors_per_class_.size() >= static_cast<size_t>(class_count_));
+      ORT_ENFORCE(coefficients_.size() >= SafeInt<size_t>(class_count_ - 1) * vector_count_);
+
+      std::vector<float> weights(SafeInt<size_t>(num_classifiers) * vector_count_, 0.f);
+      float* cur_weights = weights.data();
+      for (int64_t i = 0; i < class_count_ - 1; i++) {
+        const size_t start_index_i = onnxruntime::narrow<size_t>(starting_vector_[onnxruntime::narrow<size_t>(i)]);
+        const size_t class_i_support_count = onnxruntime::narrow<size_t>(vectors_per_class_[onnxruntime::narrow<size_t>(i)]);
+        const size_t i_coeff_row_offset = onnxruntime::narrow<size_t>(vector_count_ * i);
+
+        for (int64_t j = i + 1; j < class_count_; j++) {
+          const size_t start_index_j = onnxruntime::narrow<size_t>(starting_vector_[onnxruntime::narrow<size_t>(j)]);
+          const size_t class_j_support_count = onnxruntime::narrow<size_t>(vectors_per_class_[onnxruntime::narrow<size_t>(j)]);
+          const size_t j_coeff_row_offset = onnxruntime::narrow<size_t>(vector_count_ * (j - 1));
+
+          std::copy_n(coefficients_.data() + j_coeff_row_offset + start_index_i, class_i_support_count,
+                      cur_weights + start_index_i);
+          std::copy_n(coefficients_.data() + i_coeff_row_offset + start_index_j, class_j_support_count,
+                      cur_weights + start_index_j);
+          cur_weights += vector_count_;
+        }
+      }
+
+      packed_classifier_weights_ = pack_gemm_b(info, weights, onnxruntime::narrow<size_t>(num_classifiers),
+                                               onnxruntime::narrow<size_t>(vector_count_));
+      if (!packed_classifier_weights_) {
+        classifier_weights_ = std::move(weights);
+      }
+    }
+  }
 }
 
 template <typename LabelType>
@@ -240,70 +408,33 @@ Status SVMClassifier::ComputeImpl(OpKernelContext& ctx,
     votes_data.resize(num_batches * class_count_, 0);
 
     auto kernels_span = gsl::make_span<float>(kernels_data.data(), kernels_data.size());
-    auto votes_span = gsl::make_span<int64_t>(votes_data.data(), votes_data.size());
 
     // combine the input data with the support vectors and apply the kernel type
     // output is {num_batches, vector_count_}
-    batched_kernel_dot<float>(x_data, support_vectors_, num_batches, vector_count_, feature_count_, 0.f, kernels_span,
-                              threadpool);
-
-    for (int64_t n = 0; n < num_batches; n++) {
-      // reduce scores from kernels using coefficients, taking into account the varying number of support vectors
-      // per class.
-      // coefficients: [num_classes - 1, vector_count_]
-      //
-      // e.g. say you have 3 classes, with 3 x 3 coefficients
-      //
-      // AA AB AC
-      // BA BB BC
-      // CA CB CC
-      //
-      // you can remove the diagonal line of items comparing a class with itself leaving one less row.
-      //
-      // BA AB AC
-      // CA CB BC
-      //
-      // for each class there is a coefficient per support vector, and a class has one or more support vectors.
-      //
-      // Combine the scores for the two combinations for two classes with their coefficient.
-      // e.g. AB combines with BA.
-      // If A has 3 support vectors and B has 2, there's a 3x2 block for AB and a 2x3 block for BA to combine
-
-      auto cur_kernels = kernels_span.subspan(n * SafeInt<size_t>(vector_count_), onnxruntime::narrow<size_t>(vector_count_));
-      auto cur_scores = classifier_scores.subspan(n * SafeInt<size_t>(num_slots_per_iteration), onnxruntime::narrow<size_t>(num_classifiers));
-      auto cur_votes = votes_span.subspan(n * SafeInt<size_t>(class_count_), onnxruntime::narrow<size_t>(class_count_));
-      auto scores_iter = cur_scores.begin();
-
-      size_t classifier_idx = 0;
-      for (int64_t i = 0; i < class_count_ - 1; i++) {
-        int64_t start_index_i = starting_vector_[onnxruntime::narrow<size_t>(i)];  // start of support vectors for class i
-        int64_t class_i_support_count = vectors_per_class_[onnxruntime::narrow<size_t>(i)];
-        int64_t i_coeff_row_offset = vector_count_ * i;
-
-        for (int64_t j = i + 1; j < class_count_; j++) {
-          int64_t start_index_j = starting_vector_[onnxruntime::narrow<size_t>(j)];  // start of support vectors for class j
-          int64_t class_j_support_count = vectors_per_class_[onnxruntime::narrow<size_t>(j)];
-          int64_t j_coeff_row_offset = vector_count_ * (j - 1);
-
-          double sum = 0;
-
-          const float* val1 = &(coefficients_[j_coeff_row_offset + SafeInt<size_t>(start_index_i)]);
-          const float* val2 = &(cur_kernels[onnxruntime::narrow<size_t>(start_index_i)]);
-          for (int64_t m = 0; m < class_i_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          val1 = &(coefficients_[i_coeff_row_offset + SafeInt<size_t>(start_index_j)]);
-          val2 = &(cur_kernels[onnxruntime::narrow<size_t>(start_index_j)]);
-
-          for (int64_t m = 0; m < class_j_support_count; ++m, ++val1, ++val2)
-            sum += *val1 * *val2;
-
-          sum += rho_[classifier_idx++];
-
-          *scores_iter++ = static_cast<float>(sum);
-          ++(cur_votes[onnxruntime::narrow<size_t>(sum > 0 ? i : j)]);
-        }
-      }
+    batched_kernel_dot_support_vectors(x_data, support_vectors_, num_batches, vector_count_, feature_count_,
+                                       kernels_span, threadpool);
+
+    // combine the kernels with the weights of each classifier, see the constructor for their layout.
+    // output is {num_batches, num_classifiers} with a row stride of num_slots_per_iteration.
+    // rho is added and the votes are counted per batch in finalize_batch.
+    if (packed_classifier_weights_) {
+      MlasGemm(CblasNoTrans,
+               onnxruntime::narrow<size_t>(num_batches),
+               onnxruntime::narrow<size_t>(num_classifiers),
+               onnxruntime::narrow<size_t>(vector_count_),
+               1.f, kernels_data.data(), onnxruntime::narrow<size_t>(vector_count_),
+               packed_classifier_weights_.get(),
+               0.f, classifier_scores.data(), onnxruntime::narrow<size_t>(num_slots_per_iteration),
+               threadpool);
+    } else if (!classifier_weights_.empty()) {
+      MlasGemm(CblasNoTrans, CblasTrans,
+               onnxruntime::narrow<size_t>(num_batches),
+               onnxruntime::narrow<size_t>(num_classifiers),
+               onnxruntime::narrow<size_t>(vector_count_),
+               1.f, kernels_data.data(), onnxruntime::narrow<size_t>(vector_count_),
+               classifier_weights_.data(), onnxruntime::narrow<size_t>(vector_count_),
+               0.f, classifier_scores.data(), onnxruntime::narrow<size_t>(num_slots_per_iteration),
+               threadpool);
     }
   }
 
@@ -314,6 +445,22 @@ Status SVMClassifier::ComputeImpl(OpKernelContext& ctx,
     int n = SafeInt<int32_t>(idx);  // convert to a usable sized type
     auto cur_scores = final_scores.subspan(n * SafeInt<size_t>(final_scores_per_batch), onnxruntime::narrow<size_t>(final_scores_per_batch));
 
+    if (mode_ == SVM_TYPE::SVM_SVC) {
+      // add rho to the scores of the classifiers and vote for the winning class of each of them
+      float* classifier_scores = have_proba ? classifier_scores_data.data() + (n * num_classifiers)
+                                            : cur_scores.data();
+      int64_t* votes = votes_data.data() + (n * class_count_);
+
+      size_t classifier_idx = 0;
+      for (int64_t i = 0; i < class_count_ - 1; i++) {
+        for (int64_t j = i + 1; j < class_count_; j++, classifier_idx++) {
+          float score = classifier_scores[classifier_idx] + rho_[classifier_idx];
+          classifier_scores[classifier_idx] = score;
+          ++votes[score > 0 ? i : j];
+        }
+      }
+    }
+
     if (mode_ == SVM_TYPE::SVM_SVC && have_proba) {
       auto probsp2 = gsl::make_span<float>(probsp2_data.data() + (n * class_count_squared), onnxruntime::narrow<size_t>(class_count_squared));
 
@@ -4,6 +4,7 @@
 #pragma once
 
 #include "core/common/common.h"
+#include "core/framework/buffer_deleter.h"
 #include "core/framework/op_kernel.h"
 #include "core/util/math_cpuonly.h"
 #include "ml_common.h"
@@ -95,15 +96,39 @@ class SVMCommon {
     }
   }
 
+  // Packs b [n, k] as the transposed B matrix of MlasGemm. Returns an empty buffer if MLAS has no packed format.
+  static BufferUniquePtr pack_gemm_b(const OpKernelInfo& info, gsl::span<const float> b, size_t n, size_t k);
+
+  // Packs the support vectors [vector_count, feature_count] as the B matrix of MlasGemm so that
+  // batched_kernel_dot_support_vectors computes the kernels of a batch with a single GEMM.
+  // For the RBF kernel the squared norms of the support vectors are also computed.
+  void pack_support_vectors(const OpKernelInfo& info, gsl::span<const float> support_vectors,
+                            int64_t vector_count, int64_t feature_count);
+
+  // Same as batched_kernel_dot with b being the support vectors and scalar_C 0, using the buffer
+  // from pack_support_vectors if there is one. The RBF kernel is evaluated from the GEMM as
+  // exp(-gamma * (||a||^2 + ||b||^2 - 2 a.b)), or from the difference of the vectors when they are close
+  // relative to their norms and most of the digits of the float GEMM cancel out.
+  void batched_kernel_dot_support_vectors(gsl::span<const float> a, gsl::span<const float> support_vectors,
+                                          int64_t m, int64_t n, int64_t k,
+                                          gsl::span<float> out,
+                                          concurrency::ThreadPool* threadpool) const;
+
  private:
   KERNEL kernel_type_;
   float gamma_{0.f};
   float coef0_{0.f};
   float degree_{0.f};
+
+  BufferUniquePtr packed_support_vectors_;
+  std::vector<double> support_vector_norms_;
 };
 
 class SVMClassifier final : public OpKernel, private SVMCommon {
   using SVMCommon::batched_kernel_dot;
+  using SVMCommon::batched_kernel_dot_support_vectors;
+  using SVMCommon::pack_gemm_b;
+  using SVMCommon::pack_support_vectors;
   using SVMCommon::set_kernel_type;
   using SVMCommon::get_kernel_type;
 
@@ -126,6 +151,11 @@ class SVMClassifier final : public OpKernel, private SVMCommon {
   std::vector<float> probb_;
   std::vector<float> coefficients_;
   std::vector<float> support_vectors_;
+  // coefficients_ rearranged as the [num_classifiers, vector_count_] weights of the one-vs-one
+  // classifiers and packed for MlasGemm, so that all the classifier scores of a batch are one GEMM.
+  // classifier_weights_ holds them unpacked if MLAS has no packed format.
+  BufferUniquePtr packed_classifier_weights_;
+  std::vector<float> classifier_weights_;
   std::vector<int64_t> classlabels_ints_;
   std::vector<std::string> classlabels_strings_;
   POST_EVAL_TRANSFORM post_transform_;
@@ -15,6 +15,8 @@ namespace ml {
 template <typename T>
 class SVMRegressor final : public OpKernel, private SVMCommon {
   using SVMCommon::batched_kernel_dot;
+  using SVMCommon::batched_kernel_dot_support_vectors;
+  using SVMCommon::pack_support_vectors;
   using SVMCommon::set_kernel_type;
   using SVMCommon::get_kernel_type;
 
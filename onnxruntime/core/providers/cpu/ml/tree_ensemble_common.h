@@ -4,6 +4,7 @@
 #pragma once
 
 #include "tree_ensemble_aggregator.h"
+#include "tree_ensemble_predicated.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
 #include "tree_ensemble_helper.h"
@@ -47,6 +48,10 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
   // `ThresholdType` is used as well for output type (double as well for lightgbm) and not `OutputType`.
   std::vector<SparseValue<ThresholdType>> weights_;
   std::vector<TreeNodeElement<ThresholdType>*> roots_;
+  // Branch free layout of the trees used instead of ProcessTreeNodeLeave
+  // on blocks of rows when the ensemble allows it.
+  TreeEnsemblePredicated<InputType, ThresholdType> predicated_;
+  bool use_predicated_ = false;
 
  public:
   TreeEnsembleCommon() {}
@@ -85,6 +90,10 @@ class TreeEnsembleCommon : public TreeEnsembleCommonAttributes {
 
   template <typename AGG>
   void ComputeAgg(concurrency::ThreadPool* ttp, const Tensor* X, Tensor* Y, Tensor* label, const AGG& agg) const;
+
+  template <typename AGG>
+  void ComputeAggPredicated(concurrency::ThreadPool* ttp, const InputType* x_data, OutputType* z_data,
+                             int64_t* label_data, int64_t N, int64_t stride, const AGG& agg) const;
 };
 
 template <typename InputType, typename ThresholdType, typename OutputType>
@@ -361,6 +370,8 @@ Status TreeEnsembleCommon<InputType, ThresholdType, OutputType>::Init(
       break;
     }
   }
+
+  use_predicated_ = predicated_.Init(nodes_, roots_);
   return Status::OK();
 }
 
@@ -421,6 +432,12 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
 
   const InputType* x_data = X->Data<InputType>();
   int64_t* label_data = label == nullptr ? nullptr : label->MutableData<int64_t>();
+
+  if (use_predicated_ && N >= static_cast<int64_t>(TreeEnsemblePredicated<InputType, ThresholdType>::kRowBlock)) {
+    ComputeAggPredicated(ttp, x_data, z_data, label_data, N, stride, agg);
+    return;
+  }
+
   auto max_num_threads = concurrency::ThreadPool::DegreeOfParallelism(ttp);
 
   if (n_targets_or_classes_ == 1) {
@@ -637,6 +654,115 @@ void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAgg(concur
   }
 }  // namespace detail
 
+template <typename InputType, typename ThresholdType, typename OutputType>
+template <typename AGG>
+void TreeEnsembleCommon<InputType, ThresholdType, OutputType>::ComputeAggPredicated(concurrency::ThreadPool* ttp,
+                                                                                    const InputType* x_data,
+                                                                                    OutputType* z_data,
+                                                                                    int64_t* label_data,
+                                                                                    int64_t N,
+                                                                                    int64_t stride,
+                                                                                    const AGG& agg) const {
+  constexpr size_t kRowBlock = TreeEnsemblePredicated<InputType, ThresholdType>::kRowBlock;
+  auto max_num_threads = concurrency::ThreadPool::DegreeOfParallelism(ttp);
+
+  // The blocks of rows are independent and split between the threads. The trees of
+  // a row are aggregated in the order used by ComputeAgg for the same inputs so that
+  // the scores are bit identical: sections D and D2 aggregate the trees in one
+  // partition per thread and merge the partitions, sections C, E, C2 and E2 aggregate
+  // them one by one.
+  int32_t tree_partitions = 1;
+  if (max_num_threads > 1 && N > parallel_N_ &&
+      (n_targets_or_classes_ == 1 ? n_trees_ > max_num_threads : n_trees_ >= max_num_threads)) {
+    tree_partitions = std::min<int32_t>(max_num_threads, SafeInt<int32_t>(n_trees_));
+  }
+
+  const ptrdiff_t n_blocks = onnxruntime::narrow<ptrdiff_t>((N + static_cast<int64_t>(kRowBlock) - 1) /
+                                                             static_cast<int64_t>(kRowBlock));
+  auto num_threads = std::min<int32_t>(max_num_threads, SafeInt<int32_t>(n_blocks));
+  concurrency::ThreadPool::TrySimpleParallelFor(
+      ttp,
+      num_threads,
+      [this, &agg, num_threads, tree_partitions, n_blocks, x_data, z_data, label_data, N, stride](ptrdiff_t batch_num) {
+        const TreeNodeElement<ThresholdType>* leaves[kRowBlock];
+        auto work = concurrency::ThreadPool::PartitionWork(batch_num, num_threads, n_blocks);
+
+        if (n_targets_or_classes_ == 1) {
+          ScoreValue<ThresholdType> scores[kRowBlock];
+          ScoreValue<ThresholdType> partials[kRowBlock];
+          for (auto block = work.start; block < work.end; ++block) {
+            const int64_t begin = block * static_cast<int64_t>(kRowBlock);
+            const size_t count = static_cast<size_t>(std::min(N - begin, static_cast<int64_t>(kRowBlock)));
+            for (size_t r = 0; r < count; ++r) {
+              scores[r] = {0, 0};
+            }
+            for (int32_t p = 0; p < tree_partitions; ++p) {
+              auto trees = concurrency::ThreadPool::PartitionWork(p, tree_partitions, onnxruntime::narrow<size_t>(n_trees_));
+              ScoreValue<ThresholdType>* target = p == 0 ? scores : partials;
+              if (p > 0) {
+                for (size_t r = 0; r < count; ++r) {
+                  partials[r] = {0, 0};
+                }
+              }
+              for (auto j = trees.start; j < trees.end; ++j) {
+                predicated_.ComputeLeaves(static_cast<size_t>(j), x_data + begin * stride, stride, count, leaves);
+                for (size_t r = 0; r < count; ++r) {
+                  agg.ProcessTreeNodePrediction1(target[r], *leaves[r]);
+                }
+              }
+              if (p > 0) {
+                for (size_t r = 0; r < count; ++r) {
+                  agg.MergePrediction1(scores[r], partials[r]);
+                }
+              }
+            }
+            for (size_t r = 0; r < count; ++r) {
+              agg.FinalizeScores1(z_data + begin + r, scores[r],
+                                  label_data == nullptr ? nullptr : (label_data + begin + r));
+            }
+          }
+        } else {
+          std::vector<InlinedVector<ScoreValue<ThresholdType>>> scores(kRowBlock);
+          std::vector<InlinedVector<ScoreValue<ThresholdType>>> partials(kRowBlock);
+          for (size_t r = 0; r < kRowBlock; ++r) {
+            scores[r].resize(onnxruntime::narrow<size_t>(n_targets_or_classes_));
+            partials[r].resize(onnxruntime::narrow<size_t>(n_targets_or_classes_));
+          }
+          for (auto block = work.start; block < work.end; ++block) {
+            const int64_t begin = block * static_cast<int64_t>(kRowBlock);
+            const size_t count = static_cast<size_t>(std::min(N - begin, static_cast<int64_t>(kRowBlock)));
+            for (size_t r = 0; r < count; ++r) {
+              std::fill(scores[r].begin(), scores[r].end(), ScoreValue<ThresholdType>({0, 0}));
+            }
+            for (int32_t p = 0; p < tree_partitions; ++p) {
+              auto trees = concurrency::ThreadPool::PartitionWork(p, tree_partitions, onnxruntime::narrow<size_t>(n_trees_));
+              auto& target = p == 0 ? scores : partials;
+              if (p > 0) {
+                for (size_t r = 0; r < count; ++r) {
+                  std::fill(partials[r].begin(), partials[r].end(), ScoreValue<ThresholdType>({0, 0}));
+                }
+              }
+              for (auto j = trees.start; j < trees.end; ++j) {
+                predicated_.ComputeLeaves(static_cast<size_t>(j), x_data + begin * stride, stride, count, leaves);
+                for (size_t r = 0; r < count; ++r) {
+                  agg.ProcessTreeNodePrediction(target[r], *leaves[r], weights_);
+                }
+              }
+              if (p > 0) {
+                for (size_t r = 0; r < count; ++r) {
+                  agg.MergePrediction(scores[r], partials[r]);
+                }
+              }
+            }
+            for (size_t r = 0; r < count; ++r) {
+              agg.FinalizeScores(scores[r], z_data + (begin + r) * n_targets_or_classes_, -1,
+                                 label_data == nullptr ? nullptr : (label_data + begin + r));
+            }
+          }
+        }
+      });
+}
+
 #define TREE_FIND_VALUE(CMP)                                    \
   if (has_missing_tracks_) {                                    \
     while (root->is_not_leaf()) {                               \
@@ -0,0 +1,270 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+#include "tree_ensemble_aggregator.h"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+namespace onnxruntime {
+namespace ml {
+namespace detail {
+
+// Evaluates one tree on a block of rows with a predicated traversal.
+//
+// Every tree is stored as a perfect binary tree in breadth first order: the children of
+// node k are 2k+1 (true) and 2k+2 (false) and every leaf is at the same depth. A leaf of
+// the original tree above that depth fills all the leaves of its subtree, the branch
+// nodes below it are never relevant. The traversal then takes exactly depth steps,
+// each step is a comparison turned into an index without any branch, and the rows of
+// a block are interleaved so that the loads of different rows overlap.
+//
+// A branch node only keeps what the traversal reads: the threshold, the feature as a
+// 16 bit index and the missing value flag, 8 bytes when the thresholds are floats.
+// The nodes of every tree start on a cache line so that the first levels of a tree
+// share one line.
+//
+// The engine returns the same leaves as TreeEnsembleCommon::ProcessTreeNodeLeave,
+// the aggregation is left to the caller. It can only be used if every branch node has
+// the same mode, if no tree is deeper than kMaxDepth and if every feature index fits
+// in 16 bits.
+template <typename InputType, typename ThresholdType>
+class TreeEnsemblePredicated {
+ public:
+  static constexpr size_t kMaxDepth = 10;
+  static constexpr size_t kRowBlock = 16;
+
+  struct Node {
+    ThresholdType threshold;
+    int16_t feature;
+    uint8_t missing_tracks_true;
+  };
+
+  // Builds the layout of the ensemble. Returns false if the trees cannot be
+  // evaluated by this engine, the object must not be used in that case.
+  bool Init(const std::vector<TreeNodeElement<ThresholdType>>& nodes,
+            const std::vector<TreeNodeElement<ThresholdType>*>& roots);
+
+  // Stores in leaves[r] the leaf of tree `tree` reached by row x_data + r * stride,
+  // for r < count <= kRowBlock.
+  void ComputeLeaves(size_t tree,
+                     const InputType* x_data,
+                     int64_t stride,
+                     size_t count,
+                     const TreeNodeElement<ThresholdType>** leaves) const;
+
+ private:
+  static size_t Depth(const TreeNodeElement<ThresholdType>* node, size_t depth);
+
+  void Fill(const TreeNodeElement<ThresholdType>* node, size_t tree, size_t index, size_t depth);
+
+  template <bool HasMissingTracks, typename Compare>
+  void Traverse(size_t tree, const InputType* x_data, int64_t stride, size_t count,
+                const TreeNodeElement<ThresholdType>** leaves, Compare cmp) const;
+
+  static inline bool IsNaN(InputType val) {
+    if constexpr (std::is_floating_point<InputType>::value) {
+      return std::isnan(val);
+    } else {
+      return false;
+    }
+  }
+
+  NODE_MODE mode_;
+  bool has_missing_tracks_;
+
+  static constexpr size_t kCacheLineSize = 64;
+  static constexpr size_t kNodesPerCacheLine = kCacheLineSize / sizeof(Node);
+
+  const Node* TreeNodes(size_t tree) const {
+    return reinterpret_cast<const Node*>(
+               (reinterpret_cast<uintptr_t>(nodes_.data()) + kCacheLineSize - 1) & ~uintptr_t(kCacheLineSize - 1)) +
+           node_offsets_[tree];
+  }
+
+  Node* TreeNodes(size_t tree) {
+    return const_cast<Node*>(static_cast<const TreeEnsemblePredicated*>(this)->TreeNodes(tree));
+  }
+
+  // Tree j has depths_[j] levels of branch nodes stored from node_offsets_[j]
+  // and 2^depths_[j] leaves stored from leaf_offsets_[j]. nodes_ has room for one
+  // more cache line so that the first node can be aligned.
+  std::vector<size_t> depths_;
+  std::vector<size_t> node_offsets_;
+  std::vector<size_t> leaf_offsets_;
+  std::vector<Node> nodes_;
+  std::vector<const TreeNodeElement<ThresholdType>*> leaves_;
+};
+
+template <typename InputType, typename ThresholdType>
+size_t TreeEnsemblePredicated<InputType, ThresholdType>::Depth(const TreeNodeElement<ThresholdType>* node,
+                                                               size_t depth) {
+  if (!node->is_not_leaf() || depth > kMaxDepth) {
+    return depth;
+  }
+  return std::max(Depth(node + node->truenode_inc_or_first_weight, depth + 1),
+                  Depth(node + node->falsenode_inc_or_n_weights, depth + 1));
+}
+
+template <typename InputType, typename ThresholdType>
+void TreeEnsemblePredicated<InputType, ThresholdType>::Fill(const TreeNodeElement<ThresholdType>* node,
+                                                            size_t tree,
+                                                            size_t index,
+                                                            size_t depth) {
+  if (!node->is_not_leaf()) {
+    // The leaf fills the 2^(depths_[tree] - depth) leaves of its subtree.
+    const size_t levels = depths_[tree] - depth;
+    const size_t first = (index + 1) * (size_t(1) << levels) - 1;
+    const size_t internal_count = (size_t(1) << depths_[tree]) - 1;
+    std::fill_n(leaves_.begin() + leaf_offsets_[tree] + (first - internal_count), size_t(1) << levels, node);
+    return;
+  }
+  Node& packed = TreeNodes(tree)[index];
+  packed.threshold = node->value_or_unique_weight;
+  packed.feature = static_cast<int16_t>(node->feature_id);
+  packed.missing_tracks_true = node->is_missing_track_true() ? 1 : 0;
+  Fill(node + node->truenode_inc_or_first_weight, tree, 2 * index + 1, depth + 1);
+  Fill(node + node->falsenode_inc_or_n_weights, tree, 2 * index + 2, depth + 1);
+}
+
+template <typename InputType, typename ThresholdType>
+bool TreeEnsemblePredicated<InputType, ThresholdType>::Init(const std::vector<TreeNodeElement<ThresholdType>>& nodes,
+                                                            const std::vector<TreeNodeElement<ThresholdType>*>& roots) {
+  mode_ = NODE_MODE::LEAF;
+  has_missing_tracks_ = false;
+  for (const auto& node : nodes) {
+    if (!node.is_not_leaf()) {
+      continue;
+    }
+    if (mode_ == NODE_MODE::LEAF) {
+      mode_ = node.mode();
+    } else if (node.mode() != mode_) {
+      return false;
+    }
+    if (node.is_missing_track_true()) {
+      has_missing_tracks_ = true;
+    }
+    if (node.feature_id > std::numeric_limits<int16_t>::max()) {
+      return false;
+    }
+  }
+
+  depths_.clear();
+  node_offsets_.clear();
+  leaf_offsets_.clear();
+  depths_.reserve(roots.size());
+  node_offsets_.reserve(roots.size());
+  leaf_offsets_.reserve(roots.size());
+  size_t node_count = 0;
+  size_t leaf_count = 0;
+  for (const auto* root : roots) {
+    const size_t depth = Depth(root, 0);
+    if (depth > kMaxDepth) {
+      return false;
+    }
+    depths_.push_back(depth);
+    node_offsets_.push_back(node_count);
+    leaf_offsets_.push_back(leaf_count);
+    // Rounded up to start the next tree on a cache line.
+    node_count += ((size_t(1) << depth) - 1 + kNodesPerCacheLine - 1) / kNodesPerCacheLine * kNodesPerCacheLine;
+    leaf_count += size_t(1) << depth;
+  }
+
+  // The branch nodes below a leaf are never relevant, they test feature 0
+  // which always exists.
+  nodes_.assign(node_count + kNodesPerCacheLine, Node{ThresholdType(0), 0, 0});
+  leaves_.assign(leaf_count, nullptr);
+  for (size_t j = 0; j < roots.size(); ++j) {
+    Fill(roots[j], j, 0, 0);
+  }
+  return true;
+}
+
+template <typename InputType, typename ThresholdType>
+template <bool HasMissingTracks, typename Compare>
+void TreeEnsemblePredicated<InputType, ThresholdType>::Traverse(size_t tree,
+                                                                const InputType* x_data,
+                                                                int64_t stride,
+                                                                size_t count,
+                                                                const TreeNodeElement<ThresholdType>** leaves,
+                                                                Compare cmp) const {
+  const Node* nodes = TreeNodes(tree);
+  const size_t depth = depths_[tree];
+
+  size_t index[kRowBlock];
+  for (size_t r = 0; r < count; ++r) {
+    index[r] = 0;
+  }
+  for (size_t d = 0; d < depth; ++d) {
+    for (size_t r = 0; r < count; ++r) {
+      const size_t k = index[r];
+      const Node& node = nodes[k];
+      const InputType val = x_data[r * stride + node.feature];
+      bool is_true = cmp(val, node.threshold);
+      if constexpr (HasMissingTracks) {
+        is_true = is_true || (node.missing_tracks_true && IsNaN(val));
+      }
+      index[r] = 2 * k + 2 - static_cast<size_t>(is_true);
+    }
+  }
+
+  const TreeNodeElement<ThresholdType>* const* tree_leaves =
+      leaves_.data() + leaf_offsets_[tree] - ((size_t(1) << depth) - 1);
+  for (size_t r = 0; r < count; ++r) {
+    leaves[r] = tree_leaves[index[r]];
+  }
+}
+
+#define TREE_PREDICATED_TRAVERSE(CMP)                                                                  \
+  if (has_missing_tracks_) {                                                                           \
+    Traverse<true>(tree, x_data, stride, count, leaves, [](InputType val, ThresholdType threshold) {  \
+      return val CMP threshold;                                                                        \
+    });                                                                                                \
+  } else {                                                                                             \
+    Traverse<false>(tree, x_data, stride, count, leaves, [](InputType val, ThresholdType threshold) { \
+      return val CMP threshold;                                                                        \
+    });                                                                                                \
+  }
+
+template <typename InputType, typename ThresholdType>
+void TreeEnsemblePredicated<InputType, ThresholdType>::ComputeLeaves(
+    size_t tree,
+    const InputType* x_data,
+    int64_t stride,
+    size_t count,
+    const TreeNodeElement<ThresholdType>** leaves) const {
+  switch (mode_) {
+    case NODE_MODE::BRANCH_LEQ:
+      TREE_PREDICATED_TRAVERSE(<=)
+      break;
+    case NODE_MODE::BRANCH_LT:
+      TREE_PREDICATED_TRAVERSE(<)
+      break;
+    case NODE_MODE::BRANCH_GTE:
+      TREE_PREDICATED_TRAVERSE(>=)
+      break;
+    case NODE_MODE::BRANCH_GT:
+      TREE_PREDICATED_TRAVERSE(>)
+      break;
+    case NODE_MODE::BRANCH_EQ:
+      TREE_PREDICATED_TRAVERSE(==)
+      break;
+    case NODE_MODE::BRANCH_NEQ:
+      TREE_PREDICATED_TRAVERSE(!=)
+      break;
+    case NODE_MODE::LEAF:
+      // Every tree is a single leaf.
+      for (size_t r = 0; r < count; ++r) {
+        leaves[r] = leaves_[leaf_offsets_[tree]];
+      }
+      break;
+  }
+}
+
+#undef TREE_PREDICATED_TRAVERSE
+
+}  // namespace detail
+}  // namespace ml
+}  // namespace onnxruntime
@@ -2,6 +2,11 @@
 // Licensed under the MIT License.
 
 #include "core/providers/cpu/ml/zipmap.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "core/platform/threadpool.h"
 #include "core/util/math_cpuonly.h"
 /**
 https://github.com/onnx/onnx/blob/main/onnx/defs/traditionalml/defs.cc
@@ -35,6 +40,53 @@ ONNX_CPU_OPERATOR_ML_KERNEL(
                                             DataTypeImpl::GetType<std::vector<std::map<std::int64_t, float>>>()}),
     ZipMapOp);
 
+// Returns the indices of the labels sorted by key, keeping only the last occurrence of a repeated key
+// as assigning the values of a row in label order would.
+template <typename TKey>
+static std::vector<size_t> GetKeyOrder(const std::vector<TKey>& labels) {
+  std::vector<size_t> order(labels.size());
+  std::iota(order.begin(), order.end(), size_t{0});
+  std::stable_sort(order.begin(), order.end(),
+                   [&labels](size_t a, size_t b) { return labels[a] < labels[b]; });
+
+  std::vector<size_t> key_order;
+  key_order.reserve(order.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    if (i + 1 < order.size() && labels[order[i]] == labels[order[i + 1]]) {
+      continue;
+    }
+    key_order.push_back(order[i]);
+  }
+  return key_order;
+}
+
+// Builds the map of each row. The keys are inserted in increasing order at the end of the map,
+// which does not need to search the tree, and the rows are built in parallel.
+template <typename TKey>
+static void ZipMapRows(concurrency::ThreadPool* threadpool, const float* x_data,
+                       int64_t batch_size, int64_t features_per_batch,
+                       const std::vector<TKey>& labels, const std::vector<size_t>& key_order,
+                       std::vector<std::map<TKey, float>>& y_data) {
+  y_data.resize(onnxruntime::narrow<size_t>(batch_size));
+
+  const double entry_cost = static_cast<double>(sizeof(TKey) + sizeof(float)) * 4;
+  concurrency::ThreadPool::TryParallelFor(
+      threadpool, batch_size,
+      TensorOpCost{static_cast<double>(features_per_batch * sizeof(float)),
+                   static_cast<double>(key_order.size() * (sizeof(TKey) + sizeof(float))),
+                   static_cast<double>(key_order.size()) * entry_cost},
+      [x_data, features_per_batch, &labels, &key_order, &y_data](std::ptrdiff_t first, std::ptrdiff_t last) {
+        for (std::ptrdiff_t n = first; n < last; ++n) {
+          const float* row = x_data + n * features_per_batch;
+          std::map<TKey, float> row_map;
+          for (size_t j : key_order) {
+            row_map.emplace_hint(row_map.end(), labels[j], row[j]);
+          }
+          y_data[static_cast<size_t>(n)] = std::move(row_map);
+        }
+      });
+}
+
 ZipMapOp::ZipMapOp(const OpKernelInfo& info)
     : OpKernel(info),
       classlabels_int64s_(info.GetAttrsOrDefault<int64_t>("classlabels_int64s")),
@@ -42,6 +94,7 @@ ZipMapOp::ZipMapOp(const OpKernelInfo& info)
   ORT_ENFORCE(classlabels_strings_.empty() ^ classlabels_int64s_.empty(),
               "Must provide classlabels_strings or classlabels_int64s but not both.");
   using_strings_ = !classlabels_strings_.empty();
+  key_order_ = using_strings_ ? GetKeyOrder(classlabels_strings_) : GetKeyOrder(classlabels_int64s_);
 }
 
 common::Status ZipMapOp::Compute(OpKernelContext* context) const {
@@ -77,17 +130,8 @@ common::Status ZipMapOp::Compute(OpKernelContext* context) const {
     auto* y_data = context->Output<std::vector<std::map<std::string, float>>>(0);
     if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
 
-    //auto* y_data = Y->MutableData<std::vector<std::map<std::string, float>>>();
-    y_data->resize(onnxruntime::narrow<size_t>(batch_size));
-    int64_t current_weight_0 = 0;
-    for (int64_t n = 0; n < batch_size; n++) {
-      std::map<std::string, float> map1;
-      for (int64_t j = 0; j < features_per_batch; j++) {
-        map1[classlabels_strings_[onnxruntime::narrow<size_t>(j)]] = x_data[current_weight_0 + j];
-      }
-      current_weight_0 += features_per_batch;
-      (*y_data)[onnxruntime::narrow<size_t>(n)] = std::move(map1);
-    }
+    ZipMapRows(context->GetOperatorThreadPool(), x_data, batch_size, features_per_batch,
+               classlabels_strings_, key_order_, *y_data);
   } else {
     if (features_per_batch != static_cast<int64_t>(classlabels_int64s_.size())) {
       return Status(ONNXRUNTIME,
@@ -97,17 +141,8 @@ common::Status ZipMapOp::Compute(OpKernelContext* context) const {
     }
     auto* y_data = context->Output<std::vector<std::map<std::int64_t, float>>>(0);
     if (y_data == nullptr) return Status(common::ONNXRUNTIME, common::FAIL, "input count mismatch");
-    //auto* y_data = Y->MutableData<std::vector<std::map<int64_t, float>>>();
-    y_data->resize(onnxruntime::narrow<size_t>(batch_size));
-    int64_t current_weight_0 = 0;
-    for (int n = 0; n < batch_size; n++) {
-      std::map<int64_t, float> map2;
-      for (int j = 0; j < features_per_batch; j++) {
-        map2[classlabels_int64s_[j]] = x_data[current_weight_0 + j];
-      }
-      current_weight_0 += features_per_batch;
-      (*y_data)[n] = std::move(map2);
-    }
+    ZipMapRows(context->GetOperatorThreadPool(), x_data, batch_size, features_per_batch,
+               classlabels_int64s_, key_order_, *y_data);
   }
   return common::Status::OK();
 }
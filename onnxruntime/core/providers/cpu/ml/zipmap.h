@@ -16,6 +16,9 @@ class ZipMapOp final : public OpKernel {
   bool using_strings_;
   std::vector<int64_t> classlabels_int64s_;
   std::vector<std::string> classlabels_strings_;
+  // Indices of the class labels in increasing key order. A label repeated in the attributes
+  // only appears once, with the index of its last occurrence.
+  std::vector<size_t> key_order_;
 };
 
 }  // namespace ml
@@ -153,20 +153,92 @@ Status Conv<T>::Compute(OpKernelContext* context) const {
   return Status::OK();
 }
 
+Status Conv<float>::PrePack(const Tensor& tensor, int input_idx, AllocatorPtr alloc,
+                            /*out*/ bool& is_packed,
+                            /*out*/ PrePackedWeights* prepacked_weights) {
+  is_packed = false;
+
+  // only pack the filter of convolutions that can use the Winograd algorithm
+  if (input_idx != 1 || tensor.Shape().NumDimensions() != 4) {
+    return Status::OK();
+  }
+
+  TensorShapeVector kernel_shape;
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(tensor.Shape(), kernel_shape));
+
+  TensorShapeVector dilations(conv_attrs_.dilations);
+  if (dilations.empty()) {
+    dilations.resize(kernel_shape.size(), 1);
+  }
+  TensorShapeVector strides(conv_attrs_.strides);
+  if (strides.empty()) {
+    strides.resize(kernel_shape.size(), 1);
+  }
+  if (dilations.size() != kernel_shape.size() || strides.size() != kernel_shape.size()) {
+    return Status::OK();
+  }
+
+  const size_t group_count = static_cast<size_t>(conv_attrs_.group);
+  const size_t input_channels = static_cast<size_t>(tensor.Shape()[1]);
+  const size_t filter_count = static_cast<size_t>(tensor.Shape()[0]) / group_count;
+  const size_t packed_filter_size = MlasConvWinogradPackFilterSize(kernel_shape.size(),
+                                                                   group_count,
+                                                                   input_channels,
+                                                                   kernel_shape.data(),
+                                                                   dilations.data(),
+                                                                   strides.data(),
+                                                                   filter_count);
+  if (packed_filter_size == 0) {
+    return Status::OK();
+  }
+
+  size_t packed_filter_data_size = SafeInt<size_t>(packed_filter_size) * sizeof(float);
+  auto* packed_filter_data = alloc->Alloc(packed_filter_data_size);
+  packed_filter_ = BufferUniquePtr(packed_filter_data, BufferDeleter(std::move(alloc)));
+
+  MlasConvWinogradPackFilter(group_count, input_channels, filter_count, tensor.Data<float>(),
+                             static_cast<float*>(packed_filter_data));
+  filter_shape_ = tensor.Shape();
+
+  bool share_prepacked_weights = (prepacked_weights != nullptr);
+  if (share_prepacked_weights) {
+    prepacked_weights->buffers_.push_back(std::move(packed_filter_));
+    prepacked_weights->buffer_sizes_.push_back(packed_filter_data_size);
+  }
+
+  is_packed = true;
+  return Status::OK();
+}
+
+Status Conv<float>::UseSharedPrePackedBuffers(std::vector<BufferUniquePtr>& prepacked_buffers,
+                                              int input_idx,
+                                              /*out*/ bool& used_shared_buffers) {
+  used_shared_buffers = false;
+
+  if (input_idx == 1) {
+    used_shared_buffers = true;
+    packed_filter_ = std::move(prepacked_buffers[0]);
+  }
+
+  return Status::OK();
+}
+
 Status Conv<float>::Compute(OpKernelContext* context) const {
   size_t num_inputs = OpKernel::Node().InputDefs().size();
   const Tensor* X = context->Input<Tensor>(0);
-  const Tensor* W = context->Input<Tensor>(1);
+  // the filter is only available in its Winograd packed form if it was pre-packed
+  const Tensor* W = packed_filter_ ? nullptr : context->Input<Tensor>(1);
+  const TensorShape& W_shape = W ? W->Shape() : filter_shape_;
   const Tensor* B = num_inputs >= 3 ? context->Input<Tensor>(2) : nullptr;
   const Tensor* Sum = num_inputs >= 4 ? context->Input<Tensor>(3) : nullptr;
   const int64_t N = X->Shape()[0];
   const int64_t C = X->Shape()[1];
-  const int64_t M = W->Shape()[0];
-  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X, W));
+  const int64_t M = W_shape[0];
+  ORT_RETURN_IF_ERROR(conv_attrs_.ValidateInputShape(X->Shape(), W_shape));
 
   // kernel_shape is an optional attribute and has to be inferred from W if not provided
   TensorShapeVector kernel_shape;
-  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W->Shape(), kernel_shape));
+  ORT_RETURN_IF_ERROR(conv_attrs_.ComputeKernelShape(W_shape, kernel_shape));
 
   ConvPadVector pads(conv_attrs_.pads);
   if (pads.empty()) {
@@ -231,6 +303,7 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
                     &activation_,
                     &WorkingBufferSize,
                     Beta,
+                    packed_filter_ != nullptr,
                     thread_pool);
 
     auto* working_data = WorkingBufferSize > 0 ? alloc->Alloc(sizeof(float) * SafeInt<size_t>(WorkingBufferSize))
@@ -239,7 +312,7 @@ Status Conv<float>::Compute(OpKernelContext* context) const {
 
     MlasConv(&Parameters,
              Xdata,
-             W->Data<float>(),
+             packed_filter_ ? static_cast<const float*>(packed_filter_.get()) : W->Data<float>(),
              Bdata,
              static_cast<float*>(working_buffer.get()),
              Ydata,
@@ -3,11 +3,12 @@
 
 #include "tfidfvectorizer.h"
 #include "core/common/common.h"
+#include "core/common/flat_hash_table.h"
 #include "core/framework/tensor.h"
 #include "core/platform/threadpool.h"
 
 #include <functional>
-#include <unordered_map>
+#include <limits>
 #include <core/common/safeint.h>
 
 namespace onnxruntime {
@@ -24,61 +25,75 @@ ONNX_CPU_OPERATOR_KERNEL(
 
 namespace ngram_details {
 
-// NgrampPart implements a Trie like structure
-// for a unigram (1) it would insert into a root map with a valid id.
-// for (1,2,3) node 2 would be a child of 1 but have id == 0
-// because (1,2) does not exists. Node 3 would have a valid id.
+// The pool of n-grams as a trie: a node is a prefix of some n-grams of the pool, node 0 is
+// the empty prefix. For (1,2,3) the node of (1,2) is a child of the node of (1) but has
+// id == 0 because (1,2) does not exist, the node of (1,2,3) has a valid id.
+//
+// The tokens of the pool are numbered by a flat hash table, and the children of all the
+// nodes are in a second flat hash table keyed by the parent node and the token number, so
+// that an input row is mapped to token numbers once and the n-grams are then walked
+// without hashing strings again.
 template <class T>
-struct NgramPart;
-
-template <>
-struct NgramPart<int64_t>;
-
-template <>
-struct NgramPart<std::string>;
-
-using NgramPartInt = NgramPart<int64_t>;
-using NgramPartString = NgramPart<std::string>;
+struct NgramTrie {
+  static constexpr size_t kNoToken = FlatHashTable<T, size_t>::npos;
+
+  // Token number of each token of the pool
+  FlatHashTable<T, size_t> tokens_;
+  // ngram id of each node, 0 - means no entry, search for a bigger N
+  std::vector<size_t> ids_{0};
+  // Child node of (parent node, token number)
+  FlatHashTable<uint64_t, size_t> children_;
+
+  static uint64_t ChildKey(size_t node, size_t token) {
+    return (static_cast<uint64_t>(node) << 32) | static_cast<uint64_t>(token);
+  }
 
-// Avoid recursive class definitions using unique_ptr + forward declaration
-using IntMap = std::unordered_map<int64_t, std::unique_ptr<NgramPartInt>>;
+  bool Empty() const { return tokens_.Empty(); }
 
-using StrMap = std::unordered_map<std::reference_wrapper<const std::string>, std::unique_ptr<NgramPartString>,
-                                  std::hash<std::string>, std::equal_to<std::string>>;
+  // Returns the child of node for token, 0 if there is none.
+  size_t Child(size_t node, size_t token) const {
+    const size_t* child = children_.Find(ChildKey(node, token));
+    return child == nullptr ? 0 : *child;
+  }
 
-template <>
-struct NgramPart<int64_t> {
-  size_t id_;  // 0 - means no entry, search for a bigger N
-  IntMap leafs_;
-  explicit NgramPart(size_t id) : id_(id) {}
+  size_t AddChild(size_t node, typename FlatHashTable<T, size_t>::KeyView key) {
+    // The entry index of a token is its number, an existing token must not be inserted again.
+    size_t token = tokens_.FindIndex(key);
+    if (token == kNoToken) {
+      token = tokens_.Insert(key, tokens_.Size());
+    }
+    const uint64_t child_key = ChildKey(node, token);
+    const size_t* child = children_.Find(child_key);
+    if (child != nullptr) {
+      return *child;
+    }
+    const size_t new_node = ids_.size();
+    ORT_ENFORCE(new_node <= std::numeric_limits<uint32_t>::max() && token <= std::numeric_limits<uint32_t>::max(),
+                "Too many n-grams in the pool");
+    ids_.push_back(0);
+    children_.Insert(child_key, new_node);
+    return new_node;
+  }
 };
 
-template <>
-struct NgramPart<std::string> {
-  size_t id_;  // 0 - means no entry, search for a bigger N
-  StrMap leafs_;
-  explicit NgramPart(size_t id) : id_(id) {}
-};
+using NgramTrieInt = NgramTrie<int64_t>;
+using NgramTrieString = NgramTrie<std::string>;
+
+inline int64_t PoolItem(int64_t item) { return item; }
+inline std::string_view PoolItem(const std::string& item) { return item; }
 
 // Returns next ngram_id
-template <class K, class ForwardIter, class Map>
+template <class ForwardIter, class Trie>
 inline size_t PopulateGrams(ForwardIter first, size_t ngrams, size_t ngram_size, size_t ngram_id,
-                            Map& c) {
+                            Trie& trie) {
   for (; ngrams > 0; --ngrams) {
-    size_t n = 1;
-    Map* m = &c;
-    while (true) {
-      auto p = m->emplace(*first, std::make_unique<NgramPart<K>>(0));
-      ++first;
-      if (n == ngram_size) {
-        ORT_ENFORCE(p.first->second->id_ == 0, "Duplicate ngram detected, size: ", ngram_size, " id: ", ngram_id);
-        p.first->second->id_ = ngram_id;
-        ++ngram_id;
-        break;
-      }
-      ++n;
-      m = &p.first->second->leafs_;
+    size_t node = 0;
+    for (size_t n = 1; n <= ngram_size; ++n, ++first) {
+      node = trie.AddChild(node, PoolItem(*first));
     }
+    ORT_ENFORCE(trie.ids_[node] == 0, "Duplicate ngram detected, size: ", ngram_size, " id: ", ngram_id);
+    trie.ids_[node] = ngram_id;
+    ++ngram_id;
   }
   return ngram_id;
 }
@@ -90,10 +105,6 @@ using namespace onnxruntime::ngram_details;
 
 namespace onnxruntime {
 
-inline const void* AdvanceElementPtr(const void* p, size_t elements, size_t element_size) {
-  return reinterpret_cast<const uint8_t*>(p) + elements * element_size;
-}
-
 // The weighting criteria.
 // "TF"(term frequency),
 //    the counts are propagated to output
@@ -128,11 +139,10 @@ struct TfIdfVectorizer::Impl {
   gsl::span<const int64_t> ngram_indexes_;
   gsl::span<const float> weights_;
 
-  // This map contains references to pool_string_ entries
-  // of pool_strings attribute
-  StrMap str_map_;
-  // This map contains pool_int64s entries
-  IntMap int64_map_;
+  // n-grams of the pool_strings attribute
+  NgramTrieString str_trie_;
+  // n-grams of the pool_int64s attribute
+  NgramTrieInt int64_trie_;
 
   size_t output_size_ = 0;
 
@@ -238,9 +248,9 @@ TfIdfVectorizer::TfIdfVectorizer(const OpKernelInfo& info) : OpKernel(info), imp
       // Skip loading into hash_set ngrams that are not in the range of [min_gram_length-max_gram_length]
       if (ngram_size >= min_gram_length && ngram_size <= max_gram_length) {
         if (pool_strings.empty()) {
-          ngram_id = PopulateGrams<int64_t>(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->int64_map_);
+          ngram_id = PopulateGrams(pool_int64s.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->int64_trie_);
         } else {
-          ngram_id = PopulateGrams<std::string>(pool_strings.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->str_map_);
+          ngram_id = PopulateGrams(pool_strings.begin() + start_idx, ngrams, ngram_size, ngram_id, impl_->str_trie_);
         }
       } else {
         ngram_id += ngrams;
@@ -314,71 +324,62 @@ void TfIdfVectorizer::OutputResult(OpKernelContext* ctx, size_t B, const std::ve
 void TfIdfVectorizer::ComputeImpl(OpKernelContext* ctx, ptrdiff_t row_num, size_t row_size,
                                   std::vector<uint32_t>& frequencies) const {
   auto X = ctx->Input<Tensor>(0);
-  const auto elem_size = X->DataType()->Size();
-
-  const void* const row_begin = AdvanceElementPtr(X->DataRaw(), row_num * row_size, elem_size);
-  const void* const row_end = AdvanceElementPtr(row_begin, row_size, elem_size);
-
   const auto& impl = *impl_;
-  const auto max_gram_length = impl.max_gram_length_;
-  const auto max_skip_distance = impl.max_skip_count_ + 1;  // Convert to distance
-  auto start_ngram_size = impl.min_gram_length_;
-
-  for (auto skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
-    auto ngram_start = row_begin;
-    auto const ngram_row_end = row_end;
-
-    while (ngram_start < ngram_row_end) {
-      // We went far enough so no n-grams of any size can be gathered
-      auto at_least_this = AdvanceElementPtr(ngram_start, SafeInt<size_t>(skip_distance) * (start_ngram_size - 1), elem_size);
-      if (at_least_this >= ngram_row_end) {
-        break;
-      }
 
-      auto ngram_item = ngram_start;
-      if (X->IsDataTypeString()) {
-        const std::string* str_item = reinterpret_cast<const std::string*>(ngram_item);
-        const StrMap* str_map = &impl.str_map_;
-        for (auto ngram_size = 1;
-             !str_map->empty() &&
-             ngram_size <= max_gram_length &&
-             str_item < ngram_row_end;
-             ++ngram_size, str_item += skip_distance) {
-          auto hit = str_map->find(*str_item);
-          if (hit == str_map->end()) {
+  // Number the items of the row with the tokens of the pool once, the n-grams of all
+  // sizes and skip distances are then looked up by number.
+  std::vector<size_t> tokens(row_size);
+  const size_t row_offset = SafeInt<size_t>(row_num) * row_size;
+  if (X->IsDataTypeString()) {
+    impl.str_trie_.tokens_.FindBatch(X->DataAsSpan<std::string>().subspan(row_offset, row_size),
+                                     NgramTrieString::kNoToken, gsl::make_span(tokens), nullptr);
+  } else if (X->IsDataType<int32_t>()) {
+    impl.int64_trie_.tokens_.FindBatch(X->DataAsSpan<int32_t>().subspan(row_offset, row_size),
+                                       NgramTrieInt::kNoToken, gsl::make_span(tokens), nullptr);
+  } else {
+    impl.int64_trie_.tokens_.FindBatch(X->DataAsSpan<int64_t>().subspan(row_offset, row_size),
+                                       NgramTrieInt::kNoToken, gsl::make_span(tokens), nullptr);
+  }
+  const size_t max_gram_length = onnxruntime::narrow<size_t>(impl.max_gram_length_);
+  const size_t max_skip_distance = onnxruntime::narrow<size_t>(impl.max_skip_count_ + 1);  // Convert to distance
+
+  auto count_ngrams = [&](const auto& trie) {
+    size_t start_ngram_size = onnxruntime::narrow<size_t>(impl.min_gram_length_);
+    for (size_t skip_distance = 1; skip_distance <= max_skip_distance; ++skip_distance) {
+      for (size_t ngram_start = 0; ngram_start < row_size; ++ngram_start) {
+        // We went far enough so no n-grams of any size can be gathered
+        if (ngram_start + SafeInt<size_t>(skip_distance) * (start_ngram_size - 1) >= row_size) {
+          break;
+        }
+
+        size_t node = 0;
+        for (size_t ngram_size = 1, item = ngram_start;
+             ngram_size <= max_gram_length && item < row_size;
+             ++ngram_size, item += skip_distance) {
+          if (tokens[item] == trie.kNoToken) {
             break;
           }
-          if (ngram_size >= start_ngram_size && hit->second->id_ != 0) {
-            impl.IncrementCount(hit->second->id_, row_num, frequencies);
-          }
-          str_map = &hit->second->leafs_;
-        }
-      } else {
-        const IntMap* int_map = &impl.int64_map_;
-        for (auto ngram_size = 1;
-             !int_map->empty() &&
-             ngram_size <= max_gram_length &&
-             ngram_item < ngram_row_end;
-             ++ngram_size, ngram_item = AdvanceElementPtr(ngram_item, skip_distance, elem_size)) {
-          int64_t val = (X->IsDataType<int32_t>()) ? int64_t{*reinterpret_cast<const int32_t*>(ngram_item)} : *reinterpret_cast<const int64_t*>(ngram_item);
-          auto hit = int_map->find(val);
-          if (hit == int_map->end()) {
+          node = trie.Child(node, tokens[item]);
+          if (node == 0) {
             break;
           }
-          if (ngram_size >= start_ngram_size && hit->second->id_ != 0) {
-            impl.IncrementCount(hit->second->id_, row_num, frequencies);
+          if (ngram_size >= start_ngram_size && trie.ids_[node] != 0) {
+            impl.IncrementCount(trie.ids_[node], row_num, frequencies);
           }
-          int_map = &hit->second->leafs_;
         }
       }
-      // Sliding window shift
-      ngram_start = AdvanceElementPtr(ngram_start, 1, elem_size);
-    }
-    // We count UniGrams only once since they are not affected
-    // by skip distance
-    if (start_ngram_size == 1 && ++start_ngram_size > max_gram_length) {
-      break;
+      // We count UniGrams only once since they are not affected
+      // by skip distance
+      if (start_ngram_size == 1 && ++start_ngram_size > max_gram_length) {
+        break;
+      }
     }
+  };
+
+  if (X->IsDataTypeString()) {
+    count_ngrams(impl.str_trie_);
+  } else {
+    count_ngrams(impl.int64_trie_);
   }
 }
 
@@ -418,8 +419,8 @@ Status TfIdfVectorizer::Compute(OpKernelContext* ctx) const {
   frequencies.resize(num_rows * impl_->output_size_, 0);
 
   if (total_items == 0 ||
-      (X->IsDataTypeString() && impl_->str_map_.empty()) ||
-      ((X->IsDataType<int32_t>() || X->IsDataType<int64_t>()) && impl_->int64_map_.empty())) {
+      (X->IsDataTypeString() && impl_->str_trie_.Empty()) ||
+      ((X->IsDataType<int32_t>() || X->IsDataType<int64_t>()) && impl_->int64_trie_.Empty())) {
     // TfidfVectorizer may receive an empty input when it follows a Tokenizer
     // (for example for a string containing only stopwords).
     // TfidfVectorizer returns a zero tensor of shape
@@ -327,6 +327,73 @@ void ReduceAggregatorBase::FastReduceRKR(const Tensor&, const gsl::span<const in
   ValidateMustBeOverloaded();
 }
 
+// Reduces a float tensor viewed as [outer, reduce, inner] with MlasReduce.
+// When inner == 1 the rows are split across threads, otherwise the work items
+// are blocks of inner columns of every outer slice, so that the threads stay
+// busy when the outer dimension is small, as in RK or KRK with few slices.
+static void ParallelReduceMlas(MLAS_REDUCTION_KIND kind, const float* data, float* out,
+                               int64_t outer, int64_t reduce, int64_t inner,
+                               concurrency::ThreadPool* tp) {
+  const int n_ops = kind == MlasLogSumExpReduction ? 8 : 1;
+
+  if (inner == 1) {
+    concurrency::ThreadPool::TryParallelFor(
+        tp, onnxruntime::narrow<std::ptrdiff_t>(outer), ParallelReduceFastCost(1, reduce, sizeof(float), n_ops),
+        [kind, data, out, reduce](std::ptrdiff_t first, std::ptrdiff_t last) {
+          MlasReduce(kind, data + first * reduce, out + first, static_cast<size_t>(last - first),
+                     static_cast<size_t>(reduce), 1, 1);
+        });
+    return;
+  }
+
+  constexpr int64_t block_size = 64;
+  const int64_t n_blocks = (inner + block_size - 1) / block_size;
+
+  concurrency::ThreadPool::TryParallelFor(
+      tp, onnxruntime::narrow<std::ptrdiff_t>(outer * n_blocks),
+      ParallelReduceFastCost(std::min(inner, block_size), reduce, sizeof(float), n_ops),
+      [kind, data, out, reduce, inner, n_blocks](std::ptrdiff_t first, std::ptrdiff_t last) {
+        // Adjacent blocks of the same outer slice are reduced by a single call.
+        for (int64_t o = first / n_blocks; o * n_blocks < last; ++o) {
+          int64_t begin = std::max<int64_t>(first - o * n_blocks, 0) * block_size;
+          int64_t end = std::min<int64_t>(std::min<int64_t>(last - o * n_blocks, n_blocks) * block_size, inner);
+          MlasReduce(kind, data + o * reduce * inner + begin, out + o * inner + begin, 1,
+                     static_cast<size_t>(reduce), static_cast<size_t>(end - begin), static_cast<size_t>(inner));
+        }
+      });
+}
+
+void ReduceAggregatorBase::FastReduceMlas(MLAS_REDUCTION_KIND kind, FastReduceKind fast_kind,
+                                          const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                                          Tensor& output, concurrency::ThreadPool* tp) {
+  const float* data = input.Data<float>();
+  float* out = output.MutableData<float>();
+
+  switch (fast_kind) {
+    case FastReduceKind::kKR:
+      ParallelReduceMlas(kind, data, out, fast_shape[0], fast_shape[1], 1, tp);
+      break;
+    case FastReduceKind::kRK:
+      ParallelReduceMlas(kind, data, out, 1, fast_shape[0], fast_shape[1], tp);
+      break;
+    case FastReduceKind::kKRK:
+      ParallelReduceMlas(kind, data, out, fast_shape[0], fast_shape[1], fast_shape[2], tp);
+      break;
+    case FastReduceKind::kRKR: {
+      // Reduces the leading axis then the trailing one. Partial sums of squares
+      // are added, the other reductions are associative.
+      std::vector<float> partial(SafeInt<size_t>(fast_shape[1]) * fast_shape[2]);
+      ParallelReduceMlas(kind, data, partial.data(), 1, fast_shape[0], fast_shape[1] * fast_shape[2], tp);
+      ParallelReduceMlas(kind == MlasSumSquareReduction ? MlasSumReduction : kind,
+                         partial.data(), out, fast_shape[1], fast_shape[2], 1, tp);
+      break;
+    }
+    default:
+      ValidateMustBeOverloaded();
+      break;
+  }
+}
+
 void NoTransposePrepareForReduce(const TensorShape& new_input_shape,
                                  gsl::span<const int64_t> reduced_axes,
                                  ResultsNoTransposePrepareForReduce& results) {
@@ -723,6 +790,7 @@ bool CommonFastReduceSwitch(OpKernelContext* ctx,
                             TensorShapeVector& output_shape,
                             TensorShapeVector& fast_axes,
                             FastReduceKind which_fast_reduce,
+                            bool fast_reduce_any_shape,
                             fast_reduce_fct* case_kr,
                             fast_reduce_fct* case_rk,
                             fast_reduce_fct* case_krk,
@@ -751,9 +819,10 @@ bool CommonFastReduceSwitch(OpKernelContext* ctx,
         }
         case FastReduceKind::kRK: {
           ValidateFastReduceRK(fast_shape, *output);
-          if ((fast_shape[0] > concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()) * 16) &&
-              (std::max(fast_shape[0], fast_shape[1]) >
-               concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()) * 256)) {
+          if (fast_reduce_any_shape ||
+              ((fast_shape[0] > concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()) * 16) &&
+               (std::max(fast_shape[0], fast_shape[1]) >
+                concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()) * 256))) {
             // See benchmarks in PR #7719.
             case_rk(*input, fast_shape, *output, ctx->GetOperatorThreadPool());
             return true;
@@ -763,7 +832,8 @@ bool CommonFastReduceSwitch(OpKernelContext* ctx,
         }
         case FastReduceKind::kKRK:
           ValidateFastReduceKRK(fast_shape, *output);
-          if (fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()))) {
+          if (fast_reduce_any_shape ||
+              fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()))) {
             // See benchmarks in PR #7719.
             case_krk(*input, fast_shape, *output, ctx->GetOperatorThreadPool());
             return true;
@@ -772,7 +842,8 @@ bool CommonFastReduceSwitch(OpKernelContext* ctx,
           }
         case FastReduceKind::kRKR:
           ValidateFastReduceRKR(fast_shape, *output);
-          if (fast_shape[1] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()))) {
+          if (fast_reduce_any_shape ||
+              fast_shape[1] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(ctx->GetOperatorThreadPool()))) {
             case_rkr(*input, fast_shape, *output, ctx->GetOperatorThreadPool());
             return true;
           } else {
@@ -801,7 +872,7 @@ bool CommonFastReduce(OpKernelContext* ctx,
                       TensorShapeVector& fast_axes) {
   return CommonFastReduceSwitch(ctx, axes_, keepdims_, noop_with_empty_axes,
                                 fast_kind, fast_shape, output_shape, fast_axes,
-                                AGG::WhichFastReduce(), &AGG::FastReduceKR, &AGG::FastReduceRK,
+                                AGG::WhichFastReduce(), AGG::FastReduceAnyShape(), &AGG::FastReduceKR, &AGG::FastReduceRK,
                                 &AGG::FastReduceKRK, &AGG::FastReduceRKR);
 }
 
@@ -972,8 +1043,8 @@ std::unique_ptr<Tensor> ReduceSum<T>::Impl(const Tensor& input, gsl::span<const
       }
       case FastReduceKind::kRK:
         ValidateFastReduceRK(fast_shape, *output);
-        if (std::max(fast_shape[0], fast_shape[1]) >
-            concurrency::ThreadPool::DegreeOfParallelism(tp) * 256) {
+        if (ReduceAggregatorSum<T>::FastReduceAnyShape() ||
+            std::max(fast_shape[0], fast_shape[1]) > concurrency::ThreadPool::DegreeOfParallelism(tp) * 256) {
           // See benchmarks in PR #7719.
           ReduceAggregatorSum<T>::FastReduceRK(input, fast_shape, *output, tp);
           return output;
@@ -982,7 +1053,8 @@ std::unique_ptr<Tensor> ReduceSum<T>::Impl(const Tensor& input, gsl::span<const
         }
       case FastReduceKind::kKRK:
         ValidateFastReduceKRK(fast_shape, *output);
-        if (fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(tp))) {
+        if (ReduceAggregatorSum<T>::FastReduceAnyShape() ||
+            fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(tp))) {
           // See benchmarks in PR #7719.
           ReduceAggregatorSum<T>::FastReduceKRK(input, fast_shape, *output, tp);
           return output;
@@ -991,7 +1063,8 @@ std::unique_ptr<Tensor> ReduceSum<T>::Impl(const Tensor& input, gsl::span<const
         }
       case FastReduceKind::kRKR:
         ValidateFastReduceRKR(fast_shape, *output);
-        if (fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(tp))) {
+        if (ReduceAggregatorSum<T>::FastReduceAnyShape() ||
+            fast_shape[0] >= std::max(2, concurrency::ThreadPool::DegreeOfParallelism(tp))) {
           ReduceAggregatorSum<T>::FastReduceRKR(input, fast_shape, *output, tp);
           return output;
         } else {
@@ -8,6 +8,7 @@
 #include "core/common/common.h"
 #include "core/common/optional.h"
 #include "core/framework/op_kernel.h"
+#include "core/mlas/inc/mlas.h"
 #include "core/providers/cpu/containers.h"
 #include "core/util/math.h"
 #endif
@@ -157,6 +158,16 @@ class ReduceAggregatorBase {
   static void FastReduceRK(const Tensor&, const gsl::span<const int64_t>&, Tensor&, concurrency::ThreadPool*);
   static void FastReduceKRK(const Tensor&, const gsl::span<const int64_t>&, Tensor&, concurrency::ThreadPool*);
   static void FastReduceRKR(const Tensor&, const gsl::span<const int64_t>&, Tensor&, concurrency::ThreadPool*);
+
+  // True when the fast reductions split the kept and the reduced dimensions
+  // across threads, in which case they are used whatever the fast shape is.
+  static inline bool FastReduceAnyShape() { return false; }
+
+ protected:
+  // Fast reduction of a float tensor with MlasReduce.
+  static void FastReduceMlas(MLAS_REDUCTION_KIND kind, FastReduceKind fast_kind,
+                             const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                             Tensor& output, concurrency::ThreadPool* tp);
 };
 
 template <typename T, typename TVAL = T>
@@ -221,64 +232,81 @@ class ReduceAggregatorSum : public ReduceAggregator<T, T> {
   static inline FastReduceKind WhichFastReduce() {
     return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR;
   }
+  static inline bool FastReduceAnyShape() { return std::is_same<T, float>::value; }
 
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    int64_t stridei = fast_shape[1];
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 6),
-        [data, stridei, out](ptrdiff_t first, ptrdiff_t last) {
-          for (ptrdiff_t d = first; d < last; ++d) {
-            out[d] = aggall(data + d * stridei, stridei);
-          }
-        });
+    if constexpr (std::is_same<T, float>::value) {
+      ReduceAggregatorBase::FastReduceMlas(MlasSumReduction, FastReduceKind::kKR, input, fast_shape, output, tp);
+    } else {
+      const T* data = input.Data<T>();
+      T* out = output.MutableData<T>();
+      int64_t stridei = fast_shape[1];
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 6),
+          [data, stridei, out](ptrdiff_t first, ptrdiff_t last) {
+            for (ptrdiff_t d = first; d < last; ++d) {
+              out[d] = aggall(data + d * stridei, stridei);
+            }
+          });
+    }
   }
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
-    int64_t N = fast_shape[1];
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-
-    int64_t n_rows = fast_shape[0];
-    memcpy(out, data, SafeInt<size_t>(N) * sizeof(T));
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
-        [data, out, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
-          for (int64_t row = 1; row < n_rows; ++row) {
-            EigenVectorArrayMap<T>(out + begin, end - begin) += ConstEigenVectorArrayMap<T>(
-                data + row * N + begin, end - begin);
-          }
-        });
+    if constexpr (std::is_same<T, float>::value) {
+      ReduceAggregatorBase::FastReduceMlas(MlasSumReduction, FastReduceKind::kRK, input, fast_shape, output, tp);
+    } else {
+      int64_t N = fast_shape[1];
+      const T* data = input.Data<T>();
+      T* out = output.MutableData<T>();
+
+      int64_t n_rows = fast_shape[0];
+      memcpy(out, data, SafeInt<size_t>(N) * sizeof(T));
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
+          [data, out, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
+            for (int64_t row = 1; row < n_rows; ++row) {
+              EigenVectorArrayMap<T>(out + begin, end - begin) += ConstEigenVectorArrayMap<T>(
+                  data + row * N + begin, end - begin);
+            }
+          });
+    }
   }
 
   static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
-    int64_t N = fast_shape[2];
-    const T* data = input.Data<T>();
-    int64_t stridei = fast_shape[1] * fast_shape[2];
-    int64_t strideo = fast_shape[2];
-    T* out = output.MutableData<T>();
-    std::vector<T> one(onnxruntime::narrow<size_t>(fast_shape[1]), 1);
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
-        [one, data, fast_shape, stridei, strideo, out, N](ptrdiff_t begin, ptrdiff_t last) {
-          for (ptrdiff_t d = begin; d < last; ++d) {
-            math::MatMul<T>(1, onnxruntime::narrow<ptrdiff_t>(N), onnxruntime::narrow<ptrdiff_t>(fast_shape[1]), one.data(), data + stridei * d, out + strideo * d, nullptr);
-          }
-        });
+    if constexpr (std::is_same<T, float>::value) {
+      ReduceAggregatorBase::FastReduceMlas(MlasSumReduction, FastReduceKind::kKRK, input, fast_shape, output, tp);
+    } else {
+      int64_t N = fast_shape[2];
+      const T* data = input.Data<T>();
+      int64_t stridei = fast_shape[1] * fast_shape[2];
+      int64_t strideo = fast_shape[2];
+      T* out = output.MutableData<T>();
+      std::vector<T> one(onnxruntime::narrow<size_t>(fast_shape[1]), 1);
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
+          [one, data, fast_shape, stridei, strideo, out, N](ptrdiff_t begin, ptrdiff_t last) {
+            for (ptrdiff_t d = begin; d < last; ++d) {
+              math::MatMul<T>(1, onnxruntime::narrow<ptrdiff_t>(N), onnxruntime::narrow<ptrdiff_t>(fast_shape[1]), one.data(), data + stridei * d, out + strideo * d, nullptr);
+            }
+          });
+    }
   }
 
   static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
-    ReduceAggregator<T, T>::CommonFastReduceRKR(
-        input, fast_shape, output, tp,
-        [=](const T*) -> T { return 0; },
-        [=](T& value, const T* p, int64_t size) {
-          value += aggall(p, size);
-        });
+    if constexpr (std::is_same<T, float>::value) {
+      ReduceAggregatorBase::FastReduceMlas(MlasSumReduction, FastReduceKind::kRKR, input, fast_shape, output, tp);
+    } else {
+      ReduceAggregator<T, T>::CommonFastReduceRKR(
+          input, fast_shape, output, tp,
+          [=](const T*) -> T { return 0; },
+          [=](T& value, const T* p, int64_t size) {
+            value += aggall(p, size);
+          });
+    }
   }
 };
 
@@ -290,6 +318,34 @@ class ReduceAggregatorSumSquare : public ReduceAggregator<T, TVAL> {
     return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(this->N_)).squaredNorm();
   }
   inline void update(const T& v) { this->accumulator_ += v * v; }
+
+  // Fast reduction
+  static inline FastReduceKind WhichFastReduce() {
+    return std::is_same<T, float>::value && std::is_same<TVAL, float>::value
+               ? FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR
+               : FastReduceKind::kNone;
+  }
+  static inline bool FastReduceAnyShape() { return std::is_same<T, float>::value && std::is_same<TVAL, float>::value; }
+
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorBase::FastReduceMlas(MlasSumSquareReduction, FastReduceKind::kKR, input, fast_shape, output, tp);
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorBase::FastReduceMlas(MlasSumSquareReduction, FastReduceKind::kRK, input, fast_shape, output, tp);
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorBase::FastReduceMlas(MlasSumSquareReduction, FastReduceKind::kKRK, input, fast_shape, output, tp);
+  }
+
+  static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorBase::FastReduceMlas(MlasSumSquareReduction, FastReduceKind::kRKR, input, fast_shape, output, tp);
+  }
 };
 
 template <typename T>
@@ -374,73 +430,90 @@ class ReduceAggregatorMax : public ReduceAggregator<T> {
   static inline FastReduceKind WhichFastReduce() {
     return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR;
   }
+  static inline bool FastReduceAnyShape() { return std::is_same<T, float>::value; }
 
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    int64_t stridei = fast_shape[1];
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 6),
-        [data, stridei, out](std::ptrdiff_t first, std::ptrdiff_t last) {
-          EigenVectorMap<T>(out + first, last - first) = ConstEigenMatrixMap<T>(
-                                                             data + first * stridei, onnxruntime::narrow<size_t>(stridei), last - first)
-                                                             .colwise()
-                                                             .maxCoeff();
-        });
+    if constexpr (std::is_same<T, float>::value) {
+      ReduceAggregatorBase::FastReduceMlas(MlasMaximumReduction, FastReduceKind::kKR, input, fast_shape, output, tp);
+    } else {
+      const T* data = input.Data<T>();
+      T* out = output.MutableData<T>();
+      int64_t stridei = fast_shape[1];
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 6),
+          [data, stridei, out](std::ptrdiff_t first, std::ptrdiff_t last) {
+            EigenVectorMap<T>(out + first, last - first) = ConstEigenMatrixMap<T>(
+                                                               data + first * stridei, onnxruntime::narrow<size_t>(stridei), last - first)
+                                                               .colwise()
+                                                               .maxCoeff();
+          });
+    }
   }
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
-    int64_t n_rows = fast_shape[0];
-    int64_t N = fast_shape[1];
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    memcpy(out, data, SafeInt<size_t>(N) * sizeof(T));
-
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
-        [data, out, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
-          const T* p;
-          for (int64_t row = 1; row < n_rows; ++row) {
-            p = data + row * N;
-            for (int64_t j = begin; j < end; ++j) {
-              if (out[j] < p[j])
-                out[j] = p[j];
+    if constexpr (std::is_same<T, float>::value) {
+      ReduceAggregatorBase::FastReduceMlas(MlasMaximumReduction, FastReduceKind::kRK, input, fast_shape, output, tp);
+    } else {
+      int64_t n_rows = fast_shape[0];
+      int64_t N = fast_shape[1];
+      const T* data = input.Data<T>();
+      T* out = output.MutableData<T>();
+      memcpy(out, data, SafeInt<size_t>(N) * sizeof(T));
+
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
+          [data, out, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
+            const T* p;
+            for (int64_t row = 1; row < n_rows; ++row) {
+              p = data + row * N;
+              for (int64_t j = begin; j < end; ++j) {
+                if (out[j] < p[j])
+                  out[j] = p[j];
+              }
             }
-          }
-        });
+          });
+    }
   }
 
   static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    int64_t stridei = fast_shape[1] * fast_shape[2];
-    int64_t strideo = fast_shape[2];
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
-        [data, fast_shape, stridei, strideo, out](ptrdiff_t begin, ptrdiff_t end) {
-          for (ptrdiff_t j = begin; j < end; ++j) {
-            EigenVectorMap<T>(out + j * strideo, onnxruntime::narrow<size_t>(strideo)) =
-                ConstEigenMatrixMap<T>(
-                    data + j * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
-                    .rowwise()
-                    .maxCoeff();
-          }
-        });
+    if constexpr (std::is_same<T, float>::value) {
+      ReduceAggregatorBase::FastReduceMlas(MlasMaximumReduction, FastReduceKind::kKRK, input, fast_shape, output, tp);
+    } else {
+      const T* data = input.Data<T>();
+      T* out = output.MutableData<T>();
+      int64_t stridei = fast_shape[1] * fast_shape[2];
+      int64_t strideo = fast_shape[2];
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
+          [data, fast_shape, stridei, strideo, out](ptrdiff_t begin, ptrdiff_t end) {
+            for (ptrdiff_t j = begin; j < end; ++j) {
+              EigenVectorMap<T>(out + j * strideo, onnxruntime::narrow<size_t>(strideo)) =
+                  ConstEigenMatrixMap<T>(
+                      data + j * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
+                      .rowwise()
+                      .maxCoeff();
+            }
+          });
+    }
   }
 
   static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
-    ReduceAggregator<T, T>::CommonFastReduceRKR(
-        input, fast_shape, output, tp,
-        [=](const T* p) -> T { return p[0]; },
-        [=](T& value, const T* p, int64_t size) {
-          T v = aggall(p, size);
-          if (v > value)
-            value = v;
-        });
+    if constexpr (std::is_same<T, float>::value) {
+      ReduceAggregatorBase::FastReduceMlas(MlasMaximumReduction, FastReduceKind::kRKR, input, fast_shape, output, tp);
+    } else {
+      ReduceAggregator<T, T>::CommonFastReduceRKR(
+          input, fast_shape, output, tp,
+          [=](const T* p) -> T { return p[0]; },
+          [=](T& value, const T* p, int64_t size) {
+            T v = aggall(p, size);
+            if (v > value)
+              value = v;
+          });
+    }
   }
 };
 
@@ -549,73 +622,90 @@ class ReduceAggregatorMin : public ReduceAggregator<T, T> {
   static inline FastReduceKind WhichFastReduce() {
     return FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR;
   }
+  static inline bool FastReduceAnyShape() { return std::is_same<T, float>::value; }
 
   static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    int64_t stridei = fast_shape[1];
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 6),
-        [data, stridei, out](std::ptrdiff_t first, std::ptrdiff_t last) {
-          EigenVectorMap<T>(out + first, last - first) = ConstEigenMatrixMap<T>(
-                                                             data + first * stridei, onnxruntime::narrow<size_t>(stridei), last - first)
-                                                             .colwise()
-                                                             .minCoeff();
-        });
+    if constexpr (std::is_same<T, float>::value) {
+      ReduceAggregatorBase::FastReduceMlas(MlasMinimumReduction, FastReduceKind::kKR, input, fast_shape, output, tp);
+    } else {
+      const T* data = input.Data<T>();
+      T* out = output.MutableData<T>();
+      int64_t stridei = fast_shape[1];
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(1, stridei, sizeof(T), 6),
+          [data, stridei, out](std::ptrdiff_t first, std::ptrdiff_t last) {
+            EigenVectorMap<T>(out + first, last - first) = ConstEigenMatrixMap<T>(
+                                                               data + first * stridei, onnxruntime::narrow<size_t>(stridei), last - first)
+                                                               .colwise()
+                                                               .minCoeff();
+          });
+    }
   }
 
   static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                            Tensor& output, concurrency::ThreadPool* tp) {
-    int64_t n_rows = fast_shape[0];
-    int64_t N = fast_shape[1];
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    memcpy(out, data, SafeInt<size_t>(N) * sizeof(T));
-
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
-        [data, out, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
-          const T* p;
-          for (int64_t row = 1; row < n_rows; ++row) {
-            p = data + row * N;
-            for (int64_t j = begin; j < end; ++j) {
-              if (out[j] > p[j])
-                out[j] = p[j];
+    if constexpr (std::is_same<T, float>::value) {
+      ReduceAggregatorBase::FastReduceMlas(MlasMinimumReduction, FastReduceKind::kRK, input, fast_shape, output, tp);
+    } else {
+      int64_t n_rows = fast_shape[0];
+      int64_t N = fast_shape[1];
+      const T* data = input.Data<T>();
+      T* out = output.MutableData<T>();
+      memcpy(out, data, SafeInt<size_t>(N) * sizeof(T));
+
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(N), ParallelReduceFastCost(1, n_rows, sizeof(T), 6),
+          [data, out, N, n_rows](ptrdiff_t begin, ptrdiff_t end) {
+            const T* p;
+            for (int64_t row = 1; row < n_rows; ++row) {
+              p = data + row * N;
+              for (int64_t j = begin; j < end; ++j) {
+                if (out[j] > p[j])
+                  out[j] = p[j];
+              }
             }
-          }
-        });
+          });
+    }
   }
 
   static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
-    const T* data = input.Data<T>();
-    T* out = output.MutableData<T>();
-    int64_t stridei = fast_shape[1] * fast_shape[2];
-    int64_t strideo = fast_shape[2];
-    concurrency::ThreadPool::TryParallelFor(
-        tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
-        [data, fast_shape, stridei, strideo, out](ptrdiff_t begin, ptrdiff_t end) {
-          for (ptrdiff_t j = begin; j < end; ++j) {
-            EigenVectorMap<T>(out + j * strideo, onnxruntime::narrow<size_t>(strideo)) =
-                ConstEigenMatrixMap<T>(
-                    data + j * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
-                    .rowwise()
-                    .minCoeff();
-          }
-        });
+    if constexpr (std::is_same<T, float>::value) {
+      ReduceAggregatorBase::FastReduceMlas(MlasMinimumReduction, FastReduceKind::kKRK, input, fast_shape, output, tp);
+    } else {
+      const T* data = input.Data<T>();
+      T* out = output.MutableData<T>();
+      int64_t stridei = fast_shape[1] * fast_shape[2];
+      int64_t strideo = fast_shape[2];
+      concurrency::ThreadPool::TryParallelFor(
+          tp, onnxruntime::narrow<std::ptrdiff_t>(fast_shape[0]), ParallelReduceFastCost(fast_shape[1], fast_shape[2], sizeof(T), 6),
+          [data, fast_shape, stridei, strideo, out](ptrdiff_t begin, ptrdiff_t end) {
+            for (ptrdiff_t j = begin; j < end; ++j) {
+              EigenVectorMap<T>(out + j * strideo, onnxruntime::narrow<size_t>(strideo)) =
+                  ConstEigenMatrixMap<T>(
+                      data + j * stridei, onnxruntime::narrow<size_t>(fast_shape[2]), onnxruntime::narrow<size_t>(fast_shape[1]))
+                      .rowwise()
+                      .minCoeff();
+            }
+          });
+    }
   }
 
   static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
                             Tensor& output, concurrency::ThreadPool* tp) {
-    ReduceAggregator<T, T>::CommonFastReduceRKR(
-        input, fast_shape, output, tp,
-        [=](const T* p) -> T { return p[0]; },
-        [=](T& value, const T* p, int64_t size) {
-          T v = aggall(p, size);
-          if (v < value)
-            value = v;
-        });
+    if constexpr (std::is_same<T, float>::value) {
+      ReduceAggregatorBase::FastReduceMlas(MlasMinimumReduction, FastReduceKind::kRKR, input, fast_shape, output, tp);
+    } else {
+      ReduceAggregator<T, T>::CommonFastReduceRKR(
+          input, fast_shape, output, tp,
+          [=](const T* p) -> T { return p[0]; },
+          [=](T& value, const T* p, int64_t size) {
+            T v = aggall(p, size);
+            if (v < value)
+              value = v;
+          });
+    }
   }
 };
 
@@ -627,6 +717,34 @@ class ReduceAggregatorProd : public ReduceAggregator<T, T> {
     return Eigen::Map<const Eigen::Matrix<T, Eigen::Dynamic, 1>>(from_data, onnxruntime::narrow<size_t>(this->N_)).prod();
   }
   inline void update(const T& v) { this->accumulator_ *= v; }
+
+  // Fast reduction
+  static inline FastReduceKind WhichFastReduce() {
+    return std::is_same<T, float>::value
+               ? FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR
+               : FastReduceKind::kNone;
+  }
+  static inline bool FastReduceAnyShape() { return std::is_same<T, float>::value; }
+
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorBase::FastReduceMlas(MlasProductReduction, FastReduceKind::kKR, input, fast_shape, output, tp);
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorBase::FastReduceMlas(MlasProductReduction, FastReduceKind::kRK, input, fast_shape, output, tp);
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorBase::FastReduceMlas(MlasProductReduction, FastReduceKind::kKRK, input, fast_shape, output, tp);
+  }
+
+  static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorBase::FastReduceMlas(MlasProductReduction, FastReduceKind::kRKR, input, fast_shape, output, tp);
+  }
 };
 
 template <typename T>
@@ -682,6 +800,34 @@ class ReduceAggregatorLogSumExp : public ReduceAggregator<T, T> {
   }
   inline void update(const T& v) { this->accumulator_ += reduce_exp(v - max_); }
   inline T get_value() { return reduce_log<T>(this->accumulator_) + max_; }
+
+  // Fast reduction
+  static inline FastReduceKind WhichFastReduce() {
+    return std::is_same<T, float>::value
+               ? FastReduceKind::kKR | FastReduceKind::kRK | FastReduceKind::kKRK | FastReduceKind::kRKR
+               : FastReduceKind::kNone;
+  }
+  static inline bool FastReduceAnyShape() { return std::is_same<T, float>::value; }
+
+  static void FastReduceKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorBase::FastReduceMlas(MlasLogSumExpReduction, FastReduceKind::kKR, input, fast_shape, output, tp);
+  }
+
+  static void FastReduceRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                           Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorBase::FastReduceMlas(MlasLogSumExpReduction, FastReduceKind::kRK, input, fast_shape, output, tp);
+  }
+
+  static void FastReduceKRK(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorBase::FastReduceMlas(MlasLogSumExpReduction, FastReduceKind::kKRK, input, fast_shape, output, tp);
+  }
+
+  static void FastReduceRKR(const Tensor& input, const gsl::span<const int64_t>& fast_shape,
+                            Tensor& output, concurrency::ThreadPool* tp) {
+    ReduceAggregatorBase::FastReduceMlas(MlasLogSumExpReduction, FastReduceKind::kRKR, input, fast_shape, output, tp);
+  }
 };
 
 void NoTransposePrepareForReduce(const TensorShape& new_input_shape,
@@ -322,6 +322,34 @@ static Status DoUntypedTranspose(const gsl::span<const size_t>& permutations, co
   return status;
 }
 
+// Transposes a tensor of fixed size elements with MlasTransposeNd, which merges the axes that stay adjacent and
+// either copies contiguous runs or transposes cache sized tiles, splitting the work across `tp`.
+// Returns false if MLAS does not handle the tensor, in which case nothing is written.
+//  `input_shape_override` overrides the shape of `input` for compute purposes.
+static bool TryMlasTranspose(const gsl::span<const size_t>& permutations, const Tensor& input, Tensor& output,
+                             const TensorShape* input_shape_override, concurrency::ThreadPool* tp) {
+  if (input.IsDataTypeString()) {
+    return false;
+  }
+
+  const auto& input_shape = input_shape_override ? *input_shape_override : input.Shape();
+  const size_t rank = input_shape.NumDimensions();
+  const size_t element_size = input.DataType()->Size();
+
+  if (rank > MLAS_TRANSPOSE_MAXIMUM_DIMENSIONS ||
+      (element_size != 1 && element_size != 2 && element_size != 4 && element_size != 8)) {
+    return false;
+  }
+
+  InlinedVector<size_t> input_dims(rank);
+  for (size_t i = 0; i < rank; ++i) {
+    input_dims[i] = onnxruntime::narrow<size_t>(input_shape[i]);
+  }
+
+  MlasTransposeNd(input.DataRaw(), output.MutableDataRaw(), element_size, rank, input_dims.data(),
+                  permutations.data(), tp);
+  return true;
+}
 
 bool IsTransposeReshape(const gsl::span<const size_t>& perm, gsl::span<const int64_t> input_dims) {
   // As long as the dims with values > 1 stay in the same order, it's a reshape.
@@ -357,6 +385,10 @@ Status TransposeBase::DoTranspose(const gsl::span<const size_t>& permutations, c
       return Status::OK();
     }
 
+    if (TryMlasTranspose(permutations, input, output, input_shape_override, nullptr)) {
+      return Status::OK();
+    }
+
     size_t from = 0, to = 0;
     bool moving_single_axis = IsTransposeMovingSingleAxis(permutations, from, to);
 
@@ -399,6 +431,10 @@ Status Transpose::Compute(OpKernelContext* ctx) const {
     return Status::OK();
   }
 
+  if (TryMlasTranspose(*p_perm, X, Y, nullptr, ctx->GetOperatorThreadPool())) {
+    return Status::OK();
+  }
+
   size_t from = 0, to = 0;
   bool moving_single_axis = IsTransposeMovingSingleAxis(*p_perm, from, to);
 
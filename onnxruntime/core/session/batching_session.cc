@@ -0,0 +1,406 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/batching_session.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "core/common/narrow.h"
+#include "core/framework/tensor.h"
+#include "core/framework/tensorprotoutils.h"
+#include "core/graph/node_arg.h"
+#include "core/session/inference_session.h"
+
+namespace onnxruntime {
+
+struct BatchingSession::Request {
+  const RunOptions& run_options;
+  gsl::span<const std::string> feed_names;
+  gsl::span<const OrtValue> feeds;
+  gsl::span<const std::string> output_names;
+  std::vector<OrtValue>* p_fetches;
+
+  int64_t batch_size;
+  std::chrono::steady_clock::time_point enqueue_time;
+
+  bool taken = false;  // included in a batch
+  bool done = false;   // the batch has completed and status/p_fetches are set
+  Status status;
+};
+
+namespace {
+
+// copy num_elements elements from src starting at src_offset to dst starting at dst_offset.
+void CopyElements(const Tensor& src, size_t src_offset, Tensor& dst, size_t dst_offset, size_t num_elements) {
+  if (src.IsDataTypeString()) {
+    const auto* src_data = src.Data<std::string>() + src_offset;
+    std::copy(src_data, src_data + num_elements, dst.MutableData<std::string>() + dst_offset);
+  } else {
+    const size_t element_size = src.DataType()->Size();
+    memcpy(static_cast<char*>(dst.MutableDataRaw()) + dst_offset * element_size,
+           static_cast<const char*>(src.DataRaw()) + src_offset * element_size,
+           num_elements * element_size);
+  }
+}
+
+// the input or output must be a tensor, and its batch dimension must be symbolic or unknown to accept a varying
+// batch size. returns false otherwise. dim_param is set to the symbol if there is one.
+bool HasSymbolicBatchDim(const NodeArg& node_arg, size_t batch_axis, std::string& dim_param) {
+  dim_param.clear();
+  const auto* type = node_arg.TypeAsProto();
+  if (type == nullptr || !type->has_tensor_type()) {
+    // Shape() is also nullptr for sequences and maps, e.g. the output of ZipMap, which can not be split.
+    return false;
+  }
+
+  const auto* shape = node_arg.Shape();
+  if (shape == nullptr) {
+    // unknown rank. validated against the actual shape in each Run.
+    return true;
+  }
+
+  if (static_cast<size_t>(shape->dim_size()) <= batch_axis) {
+    return false;
+  }
+
+  const auto& dim = shape->dim(static_cast<int>(batch_axis));
+  if (utils::HasDimValue(dim)) {
+    return false;
+  }
+
+  if (utils::HasDimParam(dim)) {
+    dim_param = dim.dim_param();
+  }
+
+  return true;
+}
+
+bool HaveSameNames(gsl::span<const std::string> lhs, gsl::span<const std::string> rhs) {
+  return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+}
+
+}  // namespace
+
+BatchingSession::BatchingSession(InferenceSession& session, const BatchingOptions& options)
+    : session_(session), options_(options), cpu_allocator_(std::make_shared<CPUAllocator>()) {
+  ORT_ENFORCE(options_.max_batch_size > 0, "max_batch_size must be greater than zero");
+  ORT_ENFORCE(session_.IsInitialized(), "The InferenceSession must be initialized before batching is enabled");
+
+  auto inputs = session_.GetModelInputs();
+  ORT_THROW_IF_ERROR(inputs.first);
+  auto outputs = session_.GetModelOutputs();
+  ORT_THROW_IF_ERROR(outputs.first);
+
+  InlinedHashSet<std::string> batch_dim_params;
+  std::string dim_param;
+  for (const auto* input : *inputs.second) {
+    if (HasSymbolicBatchDim(*input, options_.batch_axis, dim_param)) {
+      batchable_inputs_.insert(input->Name());
+      if (!dim_param.empty()) {
+        batch_dim_params.insert(dim_param);
+      }
+    }
+  }
+
+  for (const auto* output : *outputs.second) {
+    // a named output dimension that does not match any input batch dimension is not the batch dimension
+    if (HasSymbolicBatchDim(*output, options_.batch_axis, dim_param) &&
+        (dim_param.empty() || batch_dim_params.count(dim_param) > 0)) {
+      batchable_outputs_.insert(output->Name());
+    }
+  }
+
+  stats_.batch_size_histogram.resize(options_.max_batch_size + 1, 0);
+}
+
+bool BatchingSession::IsBatchable(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                  gsl::span<const std::string> output_names, int64_t& batch_size) const {
+  if (feeds.empty() || feed_names.size() != feeds.size()) {
+    return false;
+  }
+
+  batch_size = -1;
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    if (batchable_inputs_.count(feed_names[i]) == 0 || !feeds[i].IsTensor()) {
+      return false;
+    }
+
+    const auto& tensor = feeds[i].Get<Tensor>();
+    if (tensor.Location().device.Type() != OrtDevice::CPU || tensor.Shape().NumDimensions() <= options_.batch_axis) {
+      return false;
+    }
+
+    const int64_t feed_batch_size = tensor.Shape()[options_.batch_axis];
+    if (batch_size != -1 && feed_batch_size != batch_size) {
+      return false;
+    }
+
+    batch_size = feed_batch_size;
+  }
+
+  return std::all_of(output_names.begin(), output_names.end(),
+                     [this](const std::string& name) { return batchable_outputs_.count(name) > 0; });
+}
+
+Status BatchingSession::Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                            gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                            std::vector<OrtValue>* p_fetches) {
+  ORT_RETURN_IF(p_fetches == nullptr, "Output vector pointer is NULL");
+
+  int64_t batch_size = 0;
+  if (!p_fetches->empty() || !IsBatchable(feed_names, feeds, output_names, batch_size)) {
+    {
+      std::lock_guard<OrtMutex> lock(mutex_);
+      ++stats_.num_unbatched_requests;
+    }
+
+    return session_.Run(run_options, feed_names, feeds, output_names, p_fetches);
+  }
+
+  Request request{run_options, feed_names, feeds, output_names, p_fetches,
+                  batch_size, std::chrono::steady_clock::now()};
+
+  std::unique_lock<OrtMutex> lock(mutex_);
+  pending_.push_back(&request);
+  pending_batch_size_ += batch_size;
+  batch_cond_var_.notify_one();
+
+  while (!request.done) {
+    if (leader_active_ || request.taken) {
+      done_cond_var_.wait(lock);
+      continue;
+    }
+
+    // this request is pending and nobody is collecting a batch, so collect one. it starts with the oldest pending
+    // request which is not necessarily this one.
+    leader_active_ = true;
+    while (pending_batch_size_ < narrow<int64_t>(options_.max_batch_size)) {
+      const auto deadline = pending_.front()->enqueue_time + options_.max_latency;
+      const auto now = std::chrono::steady_clock::now();
+      if (now >= deadline) {
+        break;
+      }
+
+      batch_cond_var_.wait_for(lock, deadline - now);
+    }
+
+    std::vector<Request*> batch = TakeBatch();
+
+    // let another caller with a pending request collect the next batch while this one runs.
+    leader_active_ = false;
+    done_cond_var_.notify_all();
+
+    lock.unlock();
+    Status status;
+    ORT_TRY {
+      status = RunBatch(batch);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "Batched Run failed: ", ex.what());
+      });
+    }
+    lock.lock();
+
+    for (auto* batch_request : batch) {
+      if (!status.IsOK()) {
+        batch_request->status = status;
+        batch_request->p_fetches->clear();
+      }
+
+      batch_request->done = true;
+    }
+
+    done_cond_var_.notify_all();
+  }
+
+  return request.status;
+}
+
+std::vector<BatchingSession::Request*> BatchingSession::TakeBatch() {
+  const size_t queue_depth = pending_.size();
+  const Request& first = *pending_.front();
+
+  auto is_compatible = [&first, this](const Request& request) {
+    if (!HaveSameNames(first.feed_names, request.feed_names) ||
+        !HaveSameNames(first.output_names, request.output_names)) {
+      return false;
+    }
+
+    for (size_t i = 0, end = first.feeds.size(); i < end; ++i) {
+      const auto& lhs = first.feeds[i].Get<Tensor>();
+      const auto& rhs = request.feeds[i].Get<Tensor>();
+      if (lhs.DataType() != rhs.DataType()) {
+        return false;
+      }
+
+      auto lhs_dims = lhs.Shape().GetDims();
+      auto rhs_dims = rhs.Shape().GetDims();
+      if (lhs_dims.size() != rhs_dims.size()) {
+        return false;
+      }
+
+      for (size_t d = 0, d_end = lhs_dims.size(); d < d_end; ++d) {
+        if (d != options_.batch_axis && lhs_dims[d] != rhs_dims[d]) {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  };
+
+  // the oldest request is always taken, even if it exceeds max_batch_size by itself.
+  std::vector<Request*> batch;
+  int64_t batch_size = 0;
+  for (auto it = pending_.begin(); it != pending_.end();) {
+    Request* request = *it;
+    const bool take = batch.empty() ||
+                      (batch_size + request->batch_size <= narrow<int64_t>(options_.max_batch_size) &&
+                       is_compatible(*request));
+    if (!take) {
+      ++it;
+      continue;
+    }
+
+    request->taken = true;
+    batch.push_back(request);
+    batch_size += request->batch_size;
+    pending_batch_size_ -= request->batch_size;
+    it = pending_.erase(it);
+  }
+
+  RecordBatch(queue_depth, batch_size);
+  stats_.num_requests += batch.size();
+
+  return batch;
+}
+
+Status BatchingSession::RunBatch(gsl::span<Request* const> batch) {
+  const Request& first = *batch[0];
+  if (batch.size() == 1) {
+    return session_.Run(first.run_options, first.feed_names, first.feeds, first.output_names, first.p_fetches);
+  }
+
+  const size_t batch_axis = options_.batch_axis;
+  int64_t batch_size = 0;
+  for (const auto* request : batch) {
+    batch_size += request->batch_size;
+  }
+
+  // concatenate the feeds along the batch axis
+  std::vector<OrtValue> feeds(first.feeds.size());
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    const auto& first_feed = first.feeds[i].Get<Tensor>();
+    TensorShape shape = first_feed.Shape();
+    shape[batch_axis] = batch_size;
+    Tensor::InitOrtValue(first_feed.DataType(), shape, cpu_allocator_, feeds[i]);
+    auto& batched_feed = *feeds[i].GetMutable<Tensor>();
+
+    const size_t outer_size = narrow<size_t>(shape.SizeToDimension(batch_axis));
+    size_t dst_offset = 0;
+    for (size_t outer = 0; outer < outer_size; ++outer) {
+      for (const auto* request : batch) {
+        const auto& feed = request->feeds[i].Get<Tensor>();
+        const size_t block_size = narrow<size_t>(feed.Shape().SizeFromDimension(batch_axis));
+        CopyElements(feed, outer * block_size, batched_feed, dst_offset, block_size);
+        dst_offset += block_size;
+      }
+    }
+  }
+
+  std::vector<OrtValue> fetches;
+  ORT_RETURN_IF_ERROR(session_.Run(first.run_options, first.feed_names, feeds, first.output_names, &fetches));
+
+  // an output of unknown rank may not have the batch size at the batch axis, e.g. if the model reduces over it.
+  // the requests are then run one by one so that each caller gets the result of an unbatched Run.
+  const bool can_split = std::all_of(fetches.begin(), fetches.end(), [batch_axis, batch_size](const OrtValue& fetch) {
+    if (!fetch.IsTensor()) {
+      return false;
+    }
+
+    const auto& batched_shape = fetch.Get<Tensor>().Shape();
+    return batched_shape.NumDimensions() > batch_axis && batched_shape[batch_axis] == batch_size;
+  });
+
+  if (!can_split) {
+    for (auto* request : batch) {
+      request->status = session_.Run(request->run_options, request->feed_names, request->feeds,
+                                     request->output_names, request->p_fetches);
+    }
+
+    return Status::OK();
+  }
+
+  for (auto* request : batch) {
+    request->p_fetches->resize(fetches.size());
+  }
+
+  // split the fetches along the batch axis
+  for (size_t i = 0, end = fetches.size(); i < end; ++i) {
+    const auto& batched_fetch = fetches[i].Get<Tensor>();
+    const auto& batched_shape = batched_fetch.Shape();
+    const size_t outer_size = narrow<size_t>(batched_shape.SizeToDimension(batch_axis));
+    const size_t row_size = narrow<size_t>(batched_shape.SizeFromDimension(batch_axis + 1));
+
+    // each request's part of the output is contiguous if there is nothing outside the batch axis
+    const bool can_alias = outer_size == 1 && !batched_fetch.IsDataTypeString();
+
+    size_t src_offset = 0;
+    for (auto* request : batch) {
+      TensorShape shape = batched_shape;
+      shape[batch_axis] = request->batch_size;
+      OrtValue& fetch = (*request->p_fetches)[i];
+
+      if (can_alias) {
+        auto* data = static_cast<char*>(const_cast<void*>(batched_fetch.DataRaw())) +
+                     src_offset * batched_fetch.DataType()->Size();
+        auto tensor = std::make_unique<Tensor>(batched_fetch.DataType(), shape, data, batched_fetch.Location());
+        auto ml_tensor = DataTypeImpl::GetType<Tensor>();
+        // the deleter holds a reference to the batched output so the buffer lives as long as any part of it
+        fetch.Init(tensor.release(), ml_tensor,
+                   [batched = fetches[i]](void* p) { delete static_cast<Tensor*>(p); });
+        src_offset += narrow<size_t>(request->batch_size) * row_size;
+        continue;
+      }
+
+      Tensor::InitOrtValue(batched_fetch.DataType(), shape, cpu_allocator_, fetch);
+      auto& split_fetch = *fetch.GetMutable<Tensor>();
+      const size_t block_size = narrow<size_t>(request->batch_size) * row_size;
+      for (size_t outer = 0; outer < outer_size; ++outer) {
+        CopyElements(batched_fetch, outer * narrow<size_t>(batch_size) * row_size + src_offset,
+                     split_fetch, outer * block_size, block_size);
+      }
+
+      src_offset += block_size;
+    }
+  }
+
+  return Status::OK();
+}
+
+void BatchingSession::RecordBatch(size_t queue_depth, int64_t batch_size) {
+  ++stats_.num_batches;
+
+  const size_t size_bucket = std::min(narrow<size_t>(batch_size), stats_.batch_size_histogram.size() - 1);
+  ++stats_.batch_size_histogram[size_bucket];
+
+  size_t depth_bucket = 0;
+  while ((size_t{1} << depth_bucket) < queue_depth) {
+    ++depth_bucket;
+  }
+
+  if (stats_.queue_depth_histogram.size() <= depth_bucket) {
+    stats_.queue_depth_histogram.resize(depth_bucket + 1, 0);
+  }
+
+  ++stats_.queue_depth_histogram[depth_bucket];
+}
+
+BatchingSession::Stats BatchingSession::GetStats() const {
+  std::lock_guard<OrtMutex> lock(mutex_);
+  return stats_;
+}
+
+}  // namespace onnxruntime
@@ -0,0 +1,137 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/allocator.h"
+#include "core/framework/framework_common.h"
+#include "core/framework/ort_value.h"
+#include "core/platform/ort_mutex.h"
+
+namespace onnxruntime {
+class InferenceSession;
+
+struct BatchingOptions {
+  // maximum total size of the batch dimension of a coalesced Run.
+  size_t max_batch_size = 16;
+
+  // maximum time the oldest pending request waits for other requests to join its batch.
+  std::chrono::microseconds max_latency{1000};
+
+  // axis of the model inputs and outputs that requests are concatenated and split along.
+  size_t batch_axis = 0;
+};
+
+/**
+ * Front end to an initialized InferenceSession that coalesces concurrent Run calls into batched Run calls.
+ * Usage is as follows:
+ *
+ * InferenceSession session;
+ * session.Load();
+ * session.Initialize();
+ * ...
+ * BatchingSession batching_session(session, options);
+ *
+ * // from many threads. each call blocks until its own results are available.
+ * batching_session.Run(run_options, feed_names, feeds, output_names, &fetches);
+ *
+ * Pending requests with the same feed and output names, and the same input types and shapes apart from the batch
+ * dimension, are concatenated along options.batch_axis. The batch is run once the pending requests fill
+ * options.max_batch_size, or once the oldest of them has waited options.max_latency. There is no dispatcher
+ * thread: the batch is run on the thread of one of the waiting callers.
+ *
+ * The outputs are split back to the callers. If the batch axis is the outermost axis the split outputs alias the
+ * batched output buffer, which is kept alive until all of them are released, so no copy is made.
+ *
+ * Only tensor model inputs and outputs with a symbolic (or unknown) dimension at the batch axis can be batched, and
+ * the symbolic output dimensions must match a symbolic input batch dimension. Requests that can not be batched, e.g.
+ * because they use another input or output, a sequence or map output, or non-CPU tensors, are run directly on the
+ * session. If an output of unknown rank does not have the batch size at the batch axis, the requests of the batch
+ * are run one by one after the batched Run.
+ * A batch is run with the RunOptions of the request that opened it.
+ *
+ * The BatchingSession must not outlive the InferenceSession.
+ */
+class BatchingSession {
+ public:
+  struct Stats {
+    // number of batched Run calls, and the number of requests they served.
+    uint64_t num_batches = 0;
+    uint64_t num_requests = 0;
+
+    // number of requests that were run directly on the session as they can not be batched.
+    uint64_t num_unbatched_requests = 0;
+
+    // batch_size_histogram[n] is the number of batches with a total batch dimension size of n.
+    // a single request larger than max_batch_size is counted in the last bucket.
+    std::vector<uint64_t> batch_size_histogram;
+
+    // number of pending requests when a batch is formed, in power of two buckets.
+    // queue_depth_histogram[0] counts a depth of 1, and queue_depth_histogram[i] counts depths in (2^(i-1), 2^i].
+    std::vector<uint64_t> queue_depth_histogram;
+  };
+
+  BatchingSession(InferenceSession& session, const BatchingOptions& options);
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(BatchingSession);
+
+  /**
+   * Run a single request. May be called concurrently, and blocks until the batch that includes this request is done.
+   * All Run calls must have returned before the BatchingSession is destroyed.
+   * @param feeds the input values. Their size at the batch axis is the number of samples in the request.
+   * @param p_fetches output values in the order specified by output_names.
+   *        If not empty the values are used as pre-allocated outputs, and the request is not batched.
+   * @return OK if success. If the batch fails all requests in it receive the error.
+   */
+  [[nodiscard]] common::Status Run(const RunOptions& run_options, gsl::span<const std::string> feed_names,
+                                   gsl::span<const OrtValue> feeds, gsl::span<const std::string> output_names,
+                                   std::vector<OrtValue>* p_fetches);
+
+  Stats GetStats() const;
+
+  const BatchingOptions& GetOptions() const { return options_; }
+
+ private:
+  struct Request;
+
+  // returns false if the request must be run directly on the session.
+  // otherwise batch_size is set to the size of the batch dimension of the feeds.
+  bool IsBatchable(gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                   gsl::span<const std::string> output_names, int64_t& batch_size) const;
+
+  // take the oldest pending request, and the pending requests that are compatible with it, off the queue
+  std::vector<Request*> TakeBatch();
+
+  common::Status RunBatch(gsl::span<Request* const> batch);
+
+  void RecordBatch(size_t queue_depth, int64_t batch_size);
+
+  InferenceSession& session_;
+  const BatchingOptions options_;
+  AllocatorPtr cpu_allocator_;
+
+  // names of the model inputs and outputs that have a symbolic batch dimension
+  InlinedHashSet<std::string> batchable_inputs_;
+  InlinedHashSet<std::string> batchable_outputs_;
+
+  mutable OrtMutex mutex_;
+  OrtCondVar batch_cond_var_;  // signalled when a request is queued
+  OrtCondVar done_cond_var_;   // signalled when a batch completes
+  std::deque<Request*> pending_;
+  int64_t pending_batch_size_ = 0;
+
+  // true while a caller is collecting a batch. only one batch is collected at a time, but the batches that have been
+  // collected run concurrently.
+  bool leader_active_ = false;
+
+  Stats stats_;
+};
+}  // namespace onnxruntime
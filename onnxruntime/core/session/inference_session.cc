@@ -45,7 +45,9 @@
 #include "core/optimizer/selectors_actions/selector_action_transformer_apply_contexts.h"
 #include "core/optimizer/transformer_memcpy.h"
 #include "core/optimizer/transpose_optimizer/optimizer_utils.h"
+#include "core/optimizer/zipmap_columnar_output.h"
 #include "core/platform/Barrier.h"
+#include "core/platform/numa_topology.h"
 #include "core/platform/ort_mutex.h"
 #include "core/platform/threadpool.h"
 #include "core/providers/cpu/controlflow/utils.h"
@@ -58,6 +60,7 @@
 #include "core/session/environment.h"
 #include "core/session/IOBinding.h"
 #include "core/session/inference_session_utils.h"
+#include "core/session/prepared_run.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
 #include "core/util/protobuf_parsing_utils.h"
@@ -167,6 +170,47 @@ Status GetMinimalBuildOptimizationHandling(
 
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
+// Runs the calling thread on the processors of a NUMA node and binds the intra op work it submits to the node, for
+// the lifetime of the instance. Memory that is first touched by the thread is allocated in the node's local memory.
+// Does nothing if numa_node is negative.
+class NumaNodeScope {
+ public:
+  NumaNodeScope(int numa_node, const LogicalProcessors& processors, const logging::Logger& logger)
+      : binding_(numa_node) {
+    if (numa_node < 0 || processors.empty()) {
+      return;
+    }
+
+    const Env& env = Env::Default();
+    auto status = env.GetCurrentThreadAffinity(previous_affinity_);
+    if (status.IsOK()) {
+      status = env.SetCurrentThreadAffinity(processors);
+    }
+
+    if (status.IsOK()) {
+      restore_affinity_ = true;
+    } else {
+      LOGS(logger, WARNING) << "Unable to run on the processors of NUMA node " << numa_node << ". "
+                            << status.ErrorMessage();
+    }
+  }
+
+  ~NumaNodeScope() {
+    if (restore_affinity_) {
+      auto status = Env::Default().SetCurrentThreadAffinity(previous_affinity_);
+      if (!status.IsOK()) {
+        LOGS_DEFAULT(WARNING) << "Unable to restore the thread affinity. " << status.ErrorMessage();
+      }
+    }
+  }
+
+ private:
+  concurrency::ThreadPool::NumaNodeBinding binding_;
+  LogicalProcessors previous_affinity_;
+  bool restore_affinity_{false};
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(NumaNodeScope);
+};
+
 }  // namespace
 
 std::atomic<uint32_t> InferenceSession::global_session_id_{1};
@@ -303,6 +347,11 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
         if (session_options_.config_options.TryGetConfigEntry(kOrtSessionOptionsConfigIntraOpThreadAffinities, to.affinity_str)) {
           ORT_ENFORCE(!to.affinity_str.empty(), "Affinity string must not be empty");
         }
+        to.numa_aware =
+            session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigIntraOpNumaAware, "0") == "1";
+        if (to.numa_aware) {
+          session_options_.config_options.TryGetConfigEntry(kOrtSessionOptionsConfigNumaTopology, to.numa_topology_str);
+        }
         to.auto_set_affinity = to.thread_pool_size == 0 &&
                                session_options_.execution_mode == ExecutionMode::ORT_SEQUENTIAL &&
                                to.affinity_str.empty();
@@ -357,6 +406,57 @@ void InferenceSession::ConstructorCommon(const SessionOptions& session_options,
                 " threadpools, the env must be created with the the CreateEnvWithGlobalThreadPools API.");
   }
 
+  ORT_THROW_IF_ERROR(ParseStringWithClassicLocale(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigNumaNode, "-1"), numa_node_));
+  if (numa_node_ >= 0) {
+    NumaTopology topology;
+    std::string topology_str;
+    if (session_options_.config_options.TryGetConfigEntry(kOrtSessionOptionsConfigNumaTopology, topology_str)) {
+      ORT_THROW_IF_ERROR(ParseNumaTopology(topology_str, topology));
+    } else {
+      topology = Env::Default().GetNumaTopology();
+    }
+
+    ORT_ENFORCE(static_cast<size_t>(numa_node_) < topology.size() && !topology[numa_node_].empty(),
+                "NUMA node ", numa_node_, " does not exist or has no processors.");
+    numa_node_processors_ = topology[numa_node_];
+
+    LogicalProcessors current_affinity;
+    auto status = Env::Default().GetCurrentThreadAffinity(current_affinity);
+    if (!status.IsOK()) {
+      LOGS(*session_logger_, WARNING) << "The session will not run on the processors of NUMA node " << numa_node_
+                                      << ". " << status.ErrorMessage();
+      numa_node_processors_.clear();
+    }
+
+    LOGS(*session_logger_, INFO) << "Session is bound to NUMA node " << numa_node_;
+  }
+
+  int async_run_num_threads = 0;
+  ORT_THROW_IF_ERROR(ParseStringWithClassicLocale(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigAsyncRunNumThreads, "0"),
+      async_run_num_threads));
+  ORT_THROW_IF_ERROR(ParseStringWithClassicLocale(
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigAsyncRunMaxInFlight, "0"),
+      max_async_runs_in_flight_));
+  if (async_run_num_threads > 0) {
+    OrtThreadPoolParams to;
+    // the pool size includes the calling thread, which never executes the scheduled runs
+    to.thread_pool_size = async_run_num_threads + 1;
+    to.auto_set_affinity = false;
+    // the threads block in Run most of the time, so spinning would only compete with the intra op threads
+    to.allow_spinning = false;
+    to.set_denormal_as_zero = set_denormal_as_zero;
+    std::basic_stringstream<ORTCHAR_T> ss;
+    ss << ORT_TSTR("session-") << session_id_ << ORT_TSTR("-async-run");
+    async_run_thread_pool_name_ = ss.str();
+    to.name = async_run_thread_pool_name_.c_str();
+    to.custom_create_thread_fn = session_options_.custom_create_thread_fn;
+    to.custom_thread_creation_options = session_options.custom_thread_creation_options;
+    to.custom_join_thread_fn = session_options_.custom_join_thread_fn;
+    async_run_thread_pool_ = concurrency::CreateThreadPool(&Env::Default(), to, concurrency::ThreadPoolType::INTER_OP);
+  }
+
   session_profiler_.Initialize(session_logger_);
   if (session_options_.enable_profiling) {
     StartProfiling(session_options_.profile_file_prefix);
@@ -442,6 +542,22 @@ InferenceSession::InferenceSession(const SessionOptions& session_options, const
 #endif  // !defined(ORT_MINIMAL_BUILD)
 
 InferenceSession::~InferenceSession() {
+  {
+    // the runs started by RunAsync use the session and its thread pools
+    std::unique_lock<OrtMutex> lock(async_run_mutex_);
+    while (async_runs_in_flight_ > 0) {
+      async_run_cond_var_.wait(lock);
+    }
+  }
+
+  // A RunAsync callback may release the session from the thread of the pool that executed the run. A pool cannot
+  // join its own thread, so it is destroyed from another thread once the callback has returned.
+  for (auto* pool : {&async_run_thread_pool_, &thread_pool_}) {
+    if (*pool && (*pool)->CurrentThreadId() != -1) {
+      std::thread([released_pool = std::move(*pool)]() mutable { released_pool.reset(); }).detach();
+    }
+  }
+
   if (session_options_.enable_profiling) {
     ORT_TRY {
       EndProfiling();
@@ -600,10 +716,18 @@ common::Status InferenceSession::SaveToOrtFormat(const PathString& filepath) con
   ORT_RETURN_IF_ERROR(
       kernel_type_str_resolver.SaveToOrtFormat(builder, fbs_kernel_type_str_resolver));
 
+  flatbuffers::Offset<fbs::PrePackedWeightsInfo> fbs_prepacked_weights;
+  if (ort_format_prepacked_weights_ != nullptr &&
+      session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigSavePrePackedWeights, "0") == "1") {
+    ORT_RETURN_IF_ERROR(ort_format_prepacked_weights_->SaveToOrtFormat(builder, session_options_.config_options,
+                                                                        fbs_prepacked_weights));
+  }
+
   fbs::InferenceSessionBuilder sb(builder);
   sb.add_ort_version(ort_model_version);
   sb.add_model(fbs_model);
   sb.add_kernel_type_str_resolver(fbs_kernel_type_str_resolver);
+  sb.add_prepacked_weights(fbs_prepacked_weights);
   auto session = sb.Finish();
   builder.Finish(session, fbs::InferenceSessionIdentifier());
 
@@ -868,11 +992,13 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph, bool
   // 1. ensure potential QDQ node units have unique DQ nodes (required transformer).
   //    - This is a required transformer as the ORT code has a hard requirement there are no overlapping QDQ node units.
   //    - We run it here in case optimizers are disabled.
-  // 2. run level 1 optimizations. these only use ONNX operators.
-  // 3. partition nodes based on EP capabilities. EPs may fuse nodes during this process.
-  // 4. run level 2+ optimizations. level 2 and 3 optimizations use contrib ops.
-  // 5. insert cast nodes (required transformer).
-  // 6. insert copy nodes (required transformer).
+  // 2. return ZipMap outputs in columnar form if requested.
+  //    - This changes the model outputs, so it runs regardless of the optimization level.
+  // 3. run level 1 optimizations. these only use ONNX operators.
+  // 4. partition nodes based on EP capabilities. EPs may fuse nodes during this process.
+  // 5. run level 2+ optimizations. level 2 and 3 optimizations use contrib ops.
+  // 6. insert cast nodes (required transformer).
+  // 7. insert copy nodes (required transformer).
 
   auto apply_transformer_once = [](const GraphTransformer& transformer, const logging::Logger& logger,
                                    Graph& graph) {
@@ -888,6 +1014,11 @@ common::Status InferenceSession::TransformGraph(onnxruntime::Graph& graph, bool
     ORT_RETURN_IF_ERROR_SESSIONID_(apply_transformer_once(ensure_unique_dq_for_node_unit, *session_logger_, graph));
   }
 
+  if (session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigZipMapColumnarOutput, "0") == "1") {
+    ZipMapColumnarOutput zipmap_columnar_output{};
+    ORT_RETURN_IF_ERROR_SESSIONID_(apply_transformer_once(zipmap_columnar_output, *session_logger_, graph));
+  }
+
   // apply execution provider independent level 1 graph optimizations.
   ORT_RETURN_IF_ERROR_SESSIONID_(graph_transformer_mgr_.ApplyTransformers(graph, TransformerLevel::Level1, *session_logger_));
 
@@ -1157,6 +1288,18 @@ Status InferenceSession::LoadOrtModelWithLoader(std::function<Status()> load_ort
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
   kernel_registry_manager_.SetKernelTypeStrResolver(std::move(kernel_type_str_resolver));
 
+  if (const auto* fbs_prepacked_weights = fbs_session->prepacked_weights(); fbs_prepacked_weights != nullptr) {
+    if (OrtFormatPrePackedWeights::IsCompatible(*fbs_prepacked_weights, config_options)) {
+      auto ort_format_prepacked_weights = std::make_unique<OrtFormatPrePackedWeights>();
+      ORT_RETURN_IF_ERROR(ort_format_prepacked_weights->LoadFromOrtFormat(*fbs_prepacked_weights,
+                                                                          using_ort_model_bytes_for_initializers_));
+      ort_format_prepacked_weights_ = std::move(ort_format_prepacked_weights);
+    } else {
+      LOGS(*session_logger_, INFO) << "The pre-packed weights in the ORT format model were created on a different "
+                                      "platform and will not be used.";
+    }
+  }
+
   is_model_loaded_ = true;
 
   return Status::OK();
@@ -1532,11 +1675,25 @@ common::Status InferenceSession::Initialize() {
 #endif  // !defined(ORT_MINIMAL_BUILD) || defined(ORT_EXTENDED_MINIMAL_BUILD)
     }
 
-    ORT_RETURN_IF_ERROR_SESSIONID_(
-        session_state_->FinalizeSessionState(model_location_, kernel_registry_manager_,
-                                             // need to keep the initializers if saving the optimized model
-                                             !saving_model,
-                                             saving_ort_format));
+    if (saving_ort_format &&
+        session_options_.config_options.GetConfigOrDefault(kOrtSessionOptionsConfigSavePrePackedWeights, "0") == "1") {
+      // collect the pre-packed weights produced during FinalizeSessionState so they can be saved.
+      // any pre-packed weights loaded from the model are replaced.
+      ort_format_prepacked_weights_ = std::make_unique<OrtFormatPrePackedWeights>();
+      session_state_->SetOrtFormatPrePackedWeights(ort_format_prepacked_weights_.get(), /*saving*/ true);
+    } else if (ort_format_prepacked_weights_ != nullptr) {
+      session_state_->SetOrtFormatPrePackedWeights(ort_format_prepacked_weights_.get(), /*saving*/ false);
+    }
+
+    {
+      // allocate the initializers and pre-packed weights in the local memory of the NUMA node the session is bound to
+      NumaNodeScope numa_node_scope(numa_node_, numa_node_processors_, *session_logger_);
+      ORT_RETURN_IF_ERROR_SESSIONID_(
+          session_state_->FinalizeSessionState(model_location_, kernel_registry_manager_,
+                                               // need to keep the initializers if saving the optimized model
+                                               !saving_model,
+                                               saving_ort_format));
+    }
 
 #if !defined(ORT_MINIMAL_BUILD)
     if (saving_model) {
@@ -1729,85 +1886,89 @@ common::Status InferenceSession::ValidateInputs(gsl::span<const std::string> fee
       return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid Feed Input Name:", feed_name);
     }
 
-    auto expected_type = iter->second.ml_data_type;
-    auto& input_ml_value = feeds[i];
-    if (input_ml_value.IsTensor()) {
-      if (!expected_type->IsTensorType()
+    ORT_RETURN_IF_ERROR(ValidateInput(feed_name, iter->second.ml_data_type, iter->second.tensor_shape, feeds[i]));
+  }
+
+  return Status::OK();
+}
+
+common::Status InferenceSession::ValidateInput(const std::string& feed_name, MLDataType expected_type,
+                                               const TensorShape& expected_shape,
+                                               const OrtValue& input_ml_value) const {
+  if (input_ml_value.IsTensor()) {
+    if (!expected_type->IsTensorType()
 #if !defined(DISABLE_OPTIONAL_TYPE)
-          && !utils::IsOptionalTensor(expected_type)
+        && !utils::IsOptionalTensor(expected_type)
 #endif
-      ) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
-                               " is not expected to be of type tensor.");
-      }
+    ) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
+                             " is not expected to be of type tensor.");
+    }
 
-      // check for type
+    // check for type
 #if !defined(DISABLE_OPTIONAL_TYPE)
-      auto expected_element_type = expected_type->IsTensorType()
-                                       ? expected_type
-                                             ->AsTensorType()
-                                             ->GetElementType()
-                                       : utils::GetElementTypeFromOptionalTensor(expected_type);
+    auto expected_element_type = expected_type->IsTensorType()
+                                     ? expected_type
+                                           ->AsTensorType()
+                                           ->GetElementType()
+                                     : utils::GetElementTypeFromOptionalTensor(expected_type);
 #else
-      auto expected_element_type = expected_type->AsTensorType()->GetElementType();
+    auto expected_element_type = expected_type->AsTensorType()->GetElementType();
 #endif
 
-      auto input_element_type = input_ml_value.Get<Tensor>().DataType();
-      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type, "tensor"));
+    auto input_element_type = input_ml_value.Get<Tensor>().DataType();
+    ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type, "tensor"));
 
-      // check for shape
-      const auto& expected_shape = iter->second.tensor_shape;
-      if (expected_shape.NumDimensions() > 0) {
-        const auto& input_shape = input_ml_value.Get<Tensor>().Shape();
-        ORT_RETURN_IF_ERROR_SESSIONID_(CheckShapes(feed_name, input_shape, expected_shape));
-      }
-    } else if (input_ml_value.IsSparseTensor()) {
+    // check for shape
+    if (expected_shape.NumDimensions() > 0) {
+      const auto& input_shape = input_ml_value.Get<Tensor>().Shape();
+      ORT_RETURN_IF_ERROR_SESSIONID_(CheckShapes(feed_name, input_shape, expected_shape));
+    }
+  } else if (input_ml_value.IsSparseTensor()) {
 #if !defined(DISABLE_SPARSE_TENSORS)
-      if (!expected_type->IsSparseTensorType()) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
-                               " is not expected to be of type sparse tensor.");
-      }
-      auto expected_element_type = expected_type->AsSparseTensorType()->GetElementType();
-      const SparseTensor& sparse_tensor = input_ml_value.Get<SparseTensor>();
-      auto input_element_type = sparse_tensor.DataType();
-      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type, "sparse_tensor"));
-      // Check shape
-      const auto& expected_shape = iter->second.tensor_shape;
-      if (expected_shape.NumDimensions() > 0) {
-        const auto& input_shape = sparse_tensor.DenseShape();
-        ORT_RETURN_IF_ERROR_SESSIONID_(CheckShapes(feed_name, input_shape, expected_shape));
-      }
+    if (!expected_type->IsSparseTensorType()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
+                             " is not expected to be of type sparse tensor.");
+    }
+    auto expected_element_type = expected_type->AsSparseTensorType()->GetElementType();
+    const SparseTensor& sparse_tensor = input_ml_value.Get<SparseTensor>();
+    auto input_element_type = sparse_tensor.DataType();
+    ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type, "sparse_tensor"));
+    // Check shape
+    if (expected_shape.NumDimensions() > 0) {
+      const auto& input_shape = sparse_tensor.DenseShape();
+      ORT_RETURN_IF_ERROR_SESSIONID_(CheckShapes(feed_name, input_shape, expected_shape));
+    }
 #else
-      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name ", feed_name,
-                             " is a sparse tensor, which is not supported in this build.");
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name ", feed_name,
+                           " is a sparse tensor, which is not supported in this build.");
 #endif
 
-    } else if (input_ml_value.IsTensorSequence()) {
-      if (!expected_type->IsTensorSequenceType()
+  } else if (input_ml_value.IsTensorSequence()) {
+    if (!expected_type->IsTensorSequenceType()
 #if !defined(DISABLE_OPTIONAL_TYPE)
-          && !utils::IsOptionalSeqTensor(expected_type)
+        && !utils::IsOptionalSeqTensor(expected_type)
 #endif
-      ) {
-        return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
-                               " is not expected to be of type tensor sequence.");
-      }
+    ) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Input with name: ", feed_name,
+                             " is not expected to be of type tensor sequence.");
+    }
 
 #if !defined(DISABLE_OPTIONAL_TYPE)
-      auto expected_element_type = expected_type->IsTensorSequenceType()
-                                       ? expected_type
-                                             ->AsSequenceTensorType()
-                                             ->GetElementType()
-                                       : utils::GetElementTypeFromOptionalSeqTensor(expected_type);
+    auto expected_element_type = expected_type->IsTensorSequenceType()
+                                     ? expected_type
+                                           ->AsSequenceTensorType()
+                                           ->GetElementType()
+                                     : utils::GetElementTypeFromOptionalSeqTensor(expected_type);
 #else
-      auto expected_element_type = expected_type->AsSequenceTensorType()->GetElementType();
+    auto expected_element_type = expected_type->AsSequenceTensorType()->GetElementType();
 #endif
 
-      auto input_element_type = input_ml_value.Get<TensorSeq>().DataType();
-      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type, "seq"));
-    } else {
-      auto input_type = input_ml_value.Type();
-      ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_type, expected_type, ""));
-    }
+    auto input_element_type = input_ml_value.Get<TensorSeq>().DataType();
+    ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_element_type, expected_element_type, "seq"));
+  } else {
+    auto input_type = input_ml_value.Type();
+    ORT_RETURN_IF_ERROR_SESSIONID_(CheckTypes(input_type, expected_type, ""));
   }
 
   return Status::OK();
@@ -1946,6 +2107,79 @@ Status InferenceSession::Run(const RunOptions& run_options,
                              gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
                              gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
                              const std::vector<OrtDevice>* p_fetches_device_info) {
+  return RunImpl(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info, nullptr);
+}
+
+Status InferenceSession::Run(const RunOptions& run_options, PreparedRun& prepared_run,
+                             gsl::span<const OrtValue> feeds, std::vector<OrtValue>* p_fetches) {
+  return RunImpl(run_options, {}, feeds, {}, p_fetches, nullptr, &prepared_run);
+}
+
+Status InferenceSession::RunAsync(const RunOptions& run_options, std::vector<std::string>&& feed_names,
+                                  std::vector<OrtValue>&& feeds, std::vector<std::string>&& output_names,
+                                  std::vector<OrtValue>&& fetches, RunAsyncCallback&& callback) {
+  auto* executor = async_run_thread_pool_ ? async_run_thread_pool_.get() : GetIntraOpThreadPoolToUse();
+  // the calling thread counts towards the degree of parallelism but does not execute scheduled work
+  if (concurrency::ThreadPool::DegreeOfParallelism(executor) < 2) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL,
+                           "RunAsync requires the intra op thread pool to have at least one thread in addition to "
+                           "the caller, or a dedicated thread pool configured with ",
+                           kOrtSessionOptionsConfigAsyncRunNumThreads);
+  }
+
+  {
+    std::unique_lock<OrtMutex> lock(async_run_mutex_);
+    while (max_async_runs_in_flight_ > 0 && async_runs_in_flight_ >= max_async_runs_in_flight_) {
+      async_run_cond_var_.wait(lock);
+    }
+
+    ++async_runs_in_flight_;
+  }
+
+  std::function<void()> run_fn = [this, run_options, feed_names = std::move(feed_names), feeds = std::move(feeds),
+                                  output_names = std::move(output_names), fetches = std::move(fetches),
+                                  callback = std::move(callback)]() mutable {
+    Status status;
+    ORT_TRY {
+      status = Run(run_options, feed_names, feeds, output_names, &fetches, nullptr);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, ex.what());
+      });
+    }
+
+    if (!status.IsOK()) {
+      fetches.clear();
+    }
+
+    // the run is complete before the callback is called, so the callback may release the session.
+    // the session must not be used past this point.
+    {
+      std::lock_guard<OrtMutex> lock(async_run_mutex_);
+      --async_runs_in_flight_;
+      async_run_cond_var_.notify_all();
+    }
+
+    ORT_TRY {
+      callback(status, fetches);
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        LOGS_DEFAULT(ERROR) << "Exception thrown by the RunAsync callback: " << ex.what();
+      });
+    }
+  };
+
+  concurrency::ThreadPool::Schedule(executor, std::move(run_fn));
+  return Status::OK();
+}
+
+Status InferenceSession::RunImpl(const RunOptions& run_options,
+                                 gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                 gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
+                                 const std::vector<OrtDevice>* p_fetches_device_info,
+                                 PreparedRun* prepared_run) {
   TimePoint tp;
   if (session_profiler_.IsEnabled()) {
     tp = session_profiler_.Start();
@@ -1967,6 +2201,7 @@ Status InferenceSession::Run(const RunOptions& run_options,
   auto* intra_tp = (control_spinning) ? thread_pool_.get() : nullptr;
   auto* inter_tp = (control_spinning) ? inter_op_thread_pool_.get() : nullptr;
   ThreadPoolSpinningSwitch runs_refcounter_and_tp_spin_control(intra_tp, inter_tp, current_num_runs_);
+  NumaNodeScope numa_node_scope(numa_node_, numa_node_processors_, *session_logger_);
 
   // Check if this Run() is simply going to be a CUDA Graph replay.
   if (cached_execution_provider_for_graph_replay_.IsGraphCaptured()) {
@@ -1989,8 +2224,12 @@ Status InferenceSession::Run(const RunOptions& run_options,
       // log evaluation start to trace logging provider
       env.GetTelemetryProvider().LogEvaluationStart();
 
-      ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
-      ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
+      if (prepared_run != nullptr) {
+        ORT_RETURN_IF_ERROR_SESSIONID_(ValidatePreparedRun(*prepared_run, feeds, p_fetches));
+      } else {
+        ORT_RETURN_IF_ERROR_SESSIONID_(ValidateInputs(feed_names, feeds));
+        ORT_RETURN_IF_ERROR_SESSIONID_(ValidateOutputs(output_names, p_fetches));
+      }
 
       // shrink certain default memory arenas if the user has requested for it
       const std::string& shrink_memory_arenas =
@@ -2000,19 +2239,30 @@ Status InferenceSession::Run(const RunOptions& run_options,
         ORT_RETURN_IF_ERROR_SESSIONID_(ValidateAndParseShrinkArenaString(shrink_memory_arenas, arenas_to_shrink));
       }
 
-      FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
-      FeedsFetchesManager feeds_fetches_manager{std::move(info)};
+      std::optional<FeedsFetchesManager> owned_feeds_fetches_manager;
+      FeedsFetchesManager* p_feeds_fetches_manager;
+
+      if (prepared_run != nullptr) {
+        // names were resolved and the static copy info calculated when the PreparedRun was created
+        prepared_run->ResetForRun();
+        p_feeds_fetches_manager = &prepared_run->feeds_fetches_manager_;
+      } else {
+        FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
+        p_feeds_fetches_manager = &owned_feeds_fetches_manager.emplace(std::move(info));
 
-      if (p_fetches_device_info) {
-        // populate the target device info. ignored if pre-allocated fetches are provided
-        const auto& fetch_device_info = *p_fetches_device_info;
-        auto& fetch_info = feeds_fetches_manager.GetMutableFetchesDeviceCopyInfo();
+        if (p_fetches_device_info) {
+          // populate the target device info. ignored if pre-allocated fetches are provided
+          const auto& fetch_device_info = *p_fetches_device_info;
+          auto& fetch_info = p_feeds_fetches_manager->GetMutableFetchesDeviceCopyInfo();
 
-        for (size_t i = 0, end = output_names.size(); i < end; ++i) {
-          fetch_info[i].target_device = fetch_device_info[i];
+          for (size_t i = 0, end = output_names.size(); i < end; ++i) {
+            fetch_info[i].target_device = fetch_device_info[i];
+          }
         }
       }
 
+      FeedsFetchesManager& feeds_fetches_manager = *p_feeds_fetches_manager;
+
       if (!run_options.run_tag.empty()) {
         LOGS(*session_logger_, INFO) << "Running with tag: " << run_options.run_tag;
       }
@@ -2116,7 +2366,8 @@ Status InferenceSession::Run(const RunOptions& run_options,
     LOGS(*session_logger_, INFO) << "Start the second Run() to capture the graph. "
                                     "The first one is for necessary memory allocation;"
                                     "The second one is for capturing the graph.";
-    ORT_RETURN_IF_ERROR(Run(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info));
+    ORT_RETURN_IF_ERROR(RunImpl(run_options, feed_names, feeds, output_names, p_fetches, p_fetches_device_info,
+                                prepared_run));
   }
   return retval;
 }
@@ -2206,6 +2457,105 @@ common::Status InferenceSession::NewIOBinding(std::unique_ptr<IOBinding>* io_bin
   return Status::OK();
 }
 
+common::Status InferenceSession::PrepareRun(gsl::span<const std::string> feed_names,
+                                            gsl::span<const std::string> output_names,
+                                            const std::vector<OrtDevice>* p_fetches_device_info,
+                                            std::unique_ptr<PreparedRun>& prepared_run) {
+  {
+    std::lock_guard<onnxruntime::OrtMutex> l(session_mutex_);
+    if (!is_inited_) {
+      LOGS(*session_logger_, ERROR) << "Session was not initialized";
+      return common::Status(common::ONNXRUNTIME, common::FAIL, "Session not initialized.");
+    }
+  }
+
+  if (output_names.empty()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "At least one output should be requested.");
+  }
+
+  if (p_fetches_device_info && p_fetches_device_info->size() != output_names.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Size mismatch: output_names has ", output_names.size(),
+                           " elements, but fetches device info has ", p_fetches_device_info->size(), " elements.");
+  }
+
+  InlinedVector<PreparedRun::FeedDef> feed_defs;
+  feed_defs.reserve(feed_names.size());
+  for (const auto& feed_name : feed_names) {
+    auto iter = input_def_map_.find(feed_name);
+    if (input_def_map_.end() == iter) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid Feed Input Name:", feed_name);
+    }
+
+    feed_defs.push_back({iter->second.ml_data_type, &iter->second.tensor_shape});
+  }
+
+  for (const auto& name : output_names) {
+    if (model_output_names_.find(name) == model_output_names_.end()) {
+      return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Invalid Output Name:", name);
+    }
+  }
+
+  FeedsFetchesInfo info(feed_names, output_names, session_state_->GetOrtValueNameIdxMap());
+
+  // constructor is private so std::make_unique can't be used
+  std::unique_ptr<PreparedRun> new_prepared_run(new PreparedRun(*this, std::move(info)));
+  new_prepared_run->feed_defs_ = std::move(feed_defs);
+
+  auto& feeds_fetches_manager = new_prepared_run->feeds_fetches_manager_;
+  auto& fetch_info = feeds_fetches_manager.GetMutableFetchesDeviceCopyInfo();
+  if (p_fetches_device_info) {
+    // populate the target device info. ignored if pre-allocated fetches are provided
+    for (size_t i = 0, end = output_names.size(); i < end; ++i) {
+      fetch_info[i].target_device = (*p_fetches_device_info)[i];
+    }
+  }
+
+  ORT_RETURN_IF_ERROR_SESSIONID_(utils::InitializeFeedFetchCopyInfo(*session_state_, feeds_fetches_manager));
+
+  // with only CPU based execution providers the device copy checks are NoCopy for every execution.
+  // otherwise they depend on the location of the feeds and fetches, and are re-evaluated on each Run.
+  if (feeds_fetches_manager.GetDeviceCopyChecks().status != DeviceCopyCheck::NoCopy) {
+    new_prepared_run->copy_needed_possible_ = true;
+    new_prepared_run->fetch_target_devices_.reserve(fetch_info.size());
+    for (const auto& copy_info : fetch_info) {
+      new_prepared_run->fetch_target_devices_.push_back(copy_info.target_device);
+    }
+  }
+
+  prepared_run = std::move(new_prepared_run);
+  return Status::OK();
+}
+
+common::Status InferenceSession::ValidatePreparedRun(const PreparedRun& prepared_run,
+                                                     gsl::span<const OrtValue> feeds,
+                                                     const std::vector<OrtValue>* p_fetches) const {
+  if (&prepared_run.session_ != this) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "PreparedRun was created by a different session.");
+  }
+
+  const auto& feed_names = prepared_run.GetFeedsFetchesInfo().feed_names;
+  if (feed_names.size() != feeds.size()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Size mismatch: PreparedRun has ", feed_names.size(),
+                           " feeds, but ", feeds.size(), " values were provided.");
+  }
+
+  for (size_t i = 0, end = feeds.size(); i < end; ++i) {
+    const auto& feed_def = prepared_run.feed_defs_[i];
+    ORT_RETURN_IF_ERROR(ValidateInput(feed_names[i], feed_def.ml_data_type, *feed_def.tensor_shape, feeds[i]));
+  }
+
+  if (p_fetches == nullptr) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Output vector pointer is NULL");
+  }
+
+  if (!p_fetches->empty() && p_fetches->size() != prepared_run.NumFetches()) {
+    return ORT_MAKE_STATUS(ONNXRUNTIME, INVALID_ARGUMENT, "Output vector incorrectly sized: PreparedRun has ",
+                           prepared_run.NumFetches(), " fetches, but p_fetches->size() is ", p_fetches->size());
+  }
+
+  return Status::OK();
+}
+
 common::Status InferenceSession::Run(const RunOptions& run_options, IOBinding& io_binding) {
   // TODO should Run() call io_binding.SynchronizeInputs() or should it let the callers do it?
   // io_binding.SynchronizeInputs();
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 
@@ -16,6 +17,7 @@
 #include "core/framework/framework_common.h"
 #include "core/framework/iexecutor.h"
 #include "core/framework/kernel_registry_manager.h"
+#include "core/framework/ort_format_prepacked_weights.h"
 #include "core/framework/prepacked_weights_container.h"
 #include "core/framework/session_state.h"
 #include "core/framework/tuning_results.h"
@@ -47,6 +49,7 @@ class Environment;
 class GraphTransformer;
 class IExecutionProvider;
 class IOBinding;
+class PreparedRun;
 struct Notification;
 
 #ifdef ENABLE_TRAINING
@@ -341,6 +344,52 @@ class InferenceSession {
   [[nodiscard]] virtual common::Status Run(const RunOptions& run_options, IOBinding& io_binding);
   [[nodiscard]] common::Status Run(IOBinding& io_binding);
 
+  /**
+   * Bind feed and fetch names to this session ahead of time, so they are validated and resolved once instead of
+   * on every call to Run. See PreparedRun for details.
+   * @param feed_names names of the inputs, in the order the values will be provided to Run.
+   * @param output_names names of the outputs, in the order the values will be returned from Run.
+   * @param p_fetches_device_info optional device to return each output on. ignored for pre-allocated fetches.
+   * @param prepared_run the new PreparedRun instance.
+   * @return OK if success.
+   */
+  [[nodiscard]] common::Status PrepareRun(gsl::span<const std::string> feed_names,
+                                          gsl::span<const std::string> output_names,
+                                          const std::vector<OrtDevice>* p_fetches_device_info,
+                                          std::unique_ptr<PreparedRun>& prepared_run);
+
+  /**
+   * Run a pre-loaded and pre-initialized model using feed and fetch names bound by PrepareRun.
+   * @param prepared_run a PreparedRun created by this session. Must not be used by concurrent Run calls.
+   * @param feeds input values in the order of the feed names the PreparedRun was created with.
+   * @param p_fetches output values in the order of the output names the PreparedRun was created with.
+   *        If not empty the values are used as pre-allocated outputs.
+   * @return OK if success.
+   */
+  [[nodiscard]] common::Status Run(const RunOptions& run_options, PreparedRun& prepared_run,
+                                   gsl::span<const OrtValue> feeds, std::vector<OrtValue>* p_fetches);
+
+  /**
+   * Called when a run started by RunAsync completes, from the thread that executed it.
+   * fetches is empty if status is not OK. The run no longer counts as in flight, so the callback may release
+   * the session.
+   */
+  using RunAsyncCallback = std::function<void(const common::Status& status, std::vector<OrtValue>& fetches)>;
+
+  /**
+   * Run a pre-loaded and pre-initialized model without waiting for it to complete.
+   * The run executes on the async run thread pool if kOrtSessionOptionsConfigAsyncRunNumThreads is set, otherwise
+   * on the intra op thread pool. Blocks while the number of runs in flight is at the limit set by
+   * kOrtSessionOptionsConfigAsyncRunMaxInFlight.
+   * The destructor waits for the runs in flight to complete.
+   * @param fetches pre-allocated outputs, or empty OrtValue instances for the outputs to be allocated.
+   * @param callback called once with the result of the run. Not called if this returns an error.
+   * @return OK if the run was queued.
+   */
+  [[nodiscard]] common::Status RunAsync(const RunOptions& run_options, std::vector<std::string>&& feed_names,
+                                        std::vector<OrtValue>&& feeds, std::vector<std::string>&& output_names,
+                                        std::vector<OrtValue>&& fetches, RunAsyncCallback&& callback);
+
 #ifdef ENABLE_TRAINING
   /**
    * Partially run a pre-loaded and pre-intialized model.
@@ -623,6 +672,21 @@ class InferenceSession {
   [[nodiscard]] common::Status ValidateInputs(gsl::span<const std::string> feed_names,
                                               gsl::span<const OrtValue> feeds) const;
 
+  [[nodiscard]] common::Status ValidateInput(const std::string& feed_name, MLDataType expected_type,
+                                             const TensorShape& expected_shape,
+                                             const OrtValue& input_ml_value) const;
+
+  [[nodiscard]] common::Status ValidatePreparedRun(const PreparedRun& prepared_run,
+                                                   gsl::span<const OrtValue> feeds,
+                                                   const std::vector<OrtValue>* p_fetches) const;
+
+  // Implementation of Run. Uses the feed and fetch info from prepared_run if provided, otherwise the names.
+  [[nodiscard]] common::Status RunImpl(const RunOptions& run_options,
+                                       gsl::span<const std::string> feed_names, gsl::span<const OrtValue> feeds,
+                                       gsl::span<const std::string> output_names, std::vector<OrtValue>* p_fetches,
+                                       const std::vector<OrtDevice>* p_fetches_device_info,
+                                       PreparedRun* prepared_run);
+
   [[nodiscard]] common::Status ValidateOutputs(gsl::span<const std::string> output_names,
                                                const std::vector<OrtValue>* p_fetches) const;
 
@@ -684,6 +748,10 @@ class InferenceSession {
   MemoryProfiler memory_profiler_;
 #endif
 
+  // Pre-packed weights loaded from, or to be saved to, an ORT format model.
+  // The kernels in session_state_ may refer to the buffers so this must be declared before session_state_.
+  std::unique_ptr<OrtFormatPrePackedWeights> ort_format_prepacked_weights_;
+
   // Immutable state for each op in the model. Shared by all executors.
   // It has a dependency on execution_providers_.
   std::unique_ptr<SessionState> session_state_;
@@ -699,9 +767,22 @@ class InferenceSession {
   // Spinning is restarted on the next Run()
   bool force_spinning_stop_between_runs_ = false;
 
+  // The NUMA node the session is bound to, or -1, and the processors of that node.
+  // The processors are empty if the thread affinity cannot be set on this platform.
+  int numa_node_ = -1;
+  LogicalProcessors numa_node_processors_;
+
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> thread_pool_;
   std::unique_ptr<onnxruntime::concurrency::ThreadPool> inter_op_thread_pool_;
 
+  // Optional threadpool that executes the runs started with RunAsync, and the limit on the runs in flight.
+  std::basic_string<ORTCHAR_T> async_run_thread_pool_name_;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> async_run_thread_pool_;
+  size_t max_async_runs_in_flight_ = 0;  // 0 is unlimited
+  size_t async_runs_in_flight_ = 0;      // GUARDED_BY(async_run_mutex_)
+  onnxruntime::OrtMutex async_run_mutex_;
+  onnxruntime::OrtCondVar async_run_cond_var_;
+
   // Global threadpools. These are intialized and used when use_per_session_threads is false *and*
   // the environment is created with create_global_thread_pools = true.
   onnxruntime::concurrency::ThreadPool* intra_op_thread_pool_from_env_{};
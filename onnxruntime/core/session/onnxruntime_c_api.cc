@@ -5,6 +5,7 @@
 #include "core/session/allocator_adapters.h"
 #include "core/session/inference_session_utils.h"
 #include "core/session/IOBinding.h"
+#include "core/session/prepared_run.h"
 #include "core/framework/allocator.h"
 #include "core/framework/error_code_helper.h"
 #include "core/framework/execution_provider.h"
@@ -897,6 +898,199 @@ ORT_API_STATUS_IMPL(OrtApis::Run, _Inout_ OrtSession* sess, _In_opt_ const OrtRu
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::RunAsync, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _In_reads_(input_len) const char* const* input_names,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
+                    _Inout_updates_all_(output_names_len) OrtValue** output,
+                    _In_ RunAsyncCallbackFn run_async_callback, _In_opt_ void* user_data) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  if (run_async_callback == nullptr) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "run_async_callback cannot be null");
+  }
+
+  // the names and values are copied as the run outlives the arrays provided by the caller
+  std::vector<std::string> feed_names;
+  feed_names.reserve(input_len);
+  std::vector<OrtValue> feeds;
+  feeds.reserve(input_len);
+
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+
+    if (!input[i]) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT,
+        MakeString("NULL input supplied for input ", input_names[i]).c_str());
+    }
+
+    feed_names.emplace_back(input_names[i]);
+    feeds.emplace_back(*input[i]);
+  }
+
+  std::vector<std::string> output_names;
+  output_names.reserve(output_names_len);
+  std::vector<OrtValue> fetches;
+  fetches.reserve(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+
+    output_names.emplace_back(output_names1[i]);
+    if (output[i] != nullptr) {
+      fetches.emplace_back(*output[i]);
+    } else {
+      fetches.emplace_back();
+    }
+  }
+
+  std::vector<OrtValue*> outputs(output, output + output_names_len);
+  auto callback = [outputs = std::move(outputs), run_async_callback, user_data](
+                      const Status& status, std::vector<OrtValue>& run_fetches) mutable {
+    if (!status.IsOK()) {
+      run_async_callback(user_data, nullptr, 0, ToOrtStatus(status));
+      return;
+    }
+
+    for (size_t i = 0, end = outputs.size(); i != end; ++i) {
+      if (outputs[i] == nullptr) {
+        outputs[i] = std::make_unique<OrtValue>(run_fetches[i]).release();
+      }
+    }
+
+    run_async_callback(user_data, outputs.data(), outputs.size(), nullptr);
+  };
+
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->RunAsync(op, std::move(feed_names), std::move(feeds), std::move(output_names),
+                               std::move(fetches), std::move(callback));
+  } else {
+    status = session->RunAsync(*run_options, std::move(feed_names), std::move(feeds), std::move(output_names),
+                               std::move(fetches), std::move(callback));
+  }
+
+  return ToOrtStatus(status);
+  API_IMPL_END
+}
+
+struct OrtPreparedRun {
+  std::unique_ptr<::onnxruntime::PreparedRun> prepared_run_;
+  explicit OrtPreparedRun(std::unique_ptr<::onnxruntime::PreparedRun>&& prepared_run)
+      : prepared_run_(std::move(prepared_run)) {}
+  OrtPreparedRun(const OrtPreparedRun&) = delete;
+  OrtPreparedRun& operator=(const OrtPreparedRun&) = delete;
+};
+
+ORT_API_STATUS_IMPL(OrtApis::CreatePreparedRun, _Inout_ OrtSession* sess,
+                    _In_reads_(input_len) const char* const* input_names, size_t input_len,
+                    _In_reads_(output_names_len) const char* const* output_names1, size_t output_names_len,
+                    _Outptr_ OrtPreparedRun** out) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  InlinedVector<std::string> feed_names;
+  feed_names.reserve(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (input_names[i] == nullptr || input_names[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "input name cannot be empty");
+    }
+    feed_names.emplace_back(input_names[i]);
+  }
+
+  InlinedVector<std::string> output_names;
+  output_names.reserve(output_names_len);
+  for (size_t i = 0; i != output_names_len; ++i) {
+    if (output_names1[i] == nullptr || output_names1[i][0] == '\0') {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "output name cannot be empty");
+    }
+    output_names.emplace_back(output_names1[i]);
+  }
+
+  std::unique_ptr<::onnxruntime::PreparedRun> prepared_run;
+  auto status = session->PrepareRun(feed_names, output_names, nullptr, prepared_run);
+  if (!status.IsOK()) {
+    return ToOrtStatus(status);
+  }
+
+  *out = std::make_unique<OrtPreparedRun>(std::move(prepared_run)).release();
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API_STATUS_IMPL(OrtApis::RunPrepared, _Inout_ OrtSession* sess, _In_opt_ const OrtRunOptions* run_options,
+                    _Inout_ OrtPreparedRun* prepared_run,
+                    _In_reads_(input_len) const OrtValue* const* input, size_t input_len,
+                    _Inout_updates_all_(output_len) OrtValue** output, size_t output_len) {
+  API_IMPL_BEGIN
+  auto session = reinterpret_cast<::onnxruntime::InferenceSession*>(sess);
+
+  InlinedVector<OrtValue> feeds;
+  feeds.reserve(input_len);
+  for (size_t i = 0; i != input_len; ++i) {
+    if (!input[i]) {
+      return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, MakeString("NULL input supplied for input ", i).c_str());
+    }
+
+    feeds.emplace_back(*input[i]);
+  }
+
+  if (output_len != prepared_run->prepared_run_->NumFetches()) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT,
+                                 MakeString("Expected ", prepared_run->prepared_run_->NumFetches(),
+                                            " outputs but ", output_len, " were provided").c_str());
+  }
+
+  std::vector<OrtValue> fetches;
+  fetches.reserve(output_len);
+  for (size_t i = 0; i != output_len; ++i) {
+    if (output[i] != nullptr) {
+      fetches.emplace_back(*output[i]);
+    } else {
+      fetches.emplace_back();
+    }
+  }
+
+  Status status;
+  if (run_options == nullptr) {
+    OrtRunOptions op;
+    status = session->Run(op, *prepared_run->prepared_run_, feeds, &fetches);
+  } else {
+    status = session->Run(*run_options, *prepared_run->prepared_run_, feeds, &fetches);
+  }
+
+  if (!status.IsOK())
+    return ToOrtStatus(status);
+
+  // We do it in two loops to make sure copy __ctors does not throw
+  InlinedVector<std::unique_ptr<OrtValue>> output_unique_ptrs;
+  output_unique_ptrs.reserve(output_len);
+  for (size_t i = 0; i != output_len; ++i) {
+    if (output[i] == nullptr) {
+      output_unique_ptrs.emplace_back(std::make_unique<OrtValue>(fetches[i]));
+    } else {
+      output_unique_ptrs.emplace_back();
+    }
+  }
+
+  for (size_t i = 0; i != output_len; ++i) {
+    if (output[i] == nullptr) {
+      output[i] = output_unique_ptrs[i].release();
+    }
+  }
+  return nullptr;
+  API_IMPL_END
+}
+
+ORT_API(void, OrtApis::ReleasePreparedRun, _Frees_ptr_opt_ OrtPreparedRun* prepared_run) {
+  delete prepared_run;
+}
+
 struct OrtIoBinding {
   std::unique_ptr<::onnxruntime::IOBinding> binding_;
   explicit OrtIoBinding(std::unique_ptr<::onnxruntime::IOBinding>&& binding) : binding_(std::move(binding)) {}
@@ -2237,6 +2431,8 @@ ORT_API_STATUS_IMPL(OrtApis::CreateArenaCfgV2, _In_reads_(num_keys) const char*
       cfg->max_dead_bytes_per_chunk = static_cast<int>(arena_config_values[i]);
     } else if (strcmp(arena_config_keys[i], "initial_growth_chunk_size_bytes") == 0) {
       cfg->initial_growth_chunk_size_bytes = static_cast<int>(arena_config_values[i]);
+    } else if (strcmp(arena_config_keys[i], "thread_cache_size_bytes") == 0) {
+      cfg->thread_cache_size_bytes = static_cast<int>(arena_config_values[i]);
     } else {
       std::ostringstream oss;
       oss << "Invalid key found: " << arena_config_keys[i];
@@ -2263,6 +2459,20 @@ ORT_API_STATUS_IMPL(OrtApis::CreatePrepackedWeightsContainer, _Outptr_ OrtPrepac
   API_IMPL_END
 }
 
+ORT_API_STATUS_IMPL(OrtApis::CreatePrepackedWeightsContainerWithSharedDirectory,
+                    _In_ const ORTCHAR_T* shared_directory, _Outptr_ OrtPrepackedWeightsContainer** out) {
+  API_IMPL_BEGIN
+  if (shared_directory == nullptr || *shared_directory == 0) {
+    return OrtApis::CreateStatus(ORT_INVALID_ARGUMENT, "shared_directory must be a non-empty path.");
+  }
+
+  std::unique_ptr<PrepackedWeightsContainer> container =
+      std::make_unique<PrepackedWeightsContainer>(PathString(shared_directory));
+  *out = reinterpret_cast<OrtPrepackedWeightsContainer*>(container.release());
+  return nullptr;
+  API_IMPL_END
+}
+
 ORT_API(void, OrtApis::ReleasePrepackedWeightsContainer, _Frees_ptr_opt_ OrtPrepackedWeightsContainer* ptr) {
   delete reinterpret_cast<PrepackedWeightsContainer*>(ptr);
 }
@@ -2706,7 +2916,12 @@ static constexpr OrtApi ort_api_1_to_15 = {
     &OrtApis::Logger_GetLoggingSeverityLevel,
     &OrtApis::KernelInfoGetConstantInput_tensor,
     &OrtApis::CastTypeInfoToOptionalTypeInfo,
-    &OrtApis::GetOptionalContainedTypeInfo
+    &OrtApis::GetOptionalContainedTypeInfo,
+    &OrtApis::CreatePreparedRun,
+    &OrtApis::RunPrepared,
+    &OrtApis::ReleasePreparedRun,
+    &OrtApis::CreatePrepackedWeightsContainerWithSharedDirectory,
+    &OrtApis::RunAsync
 };
 
 // Asserts to do a some checks to ensure older Versions of the OrtApi never change (will detect an addition or deletion but not if they cancel out each other)
@@ -0,0 +1,86 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "core/common/common.h"
+#include "core/common/inlined_containers.h"
+#include "core/framework/data_types.h"
+#include "core/framework/feeds_fetches_manager.h"
+#include "core/framework/tensor_shape.h"
+
+namespace onnxruntime {
+class InferenceSession;
+
+/**
+ * A set of feed and fetch names that has been bound to a session ahead of time.
+ * Usage is as follows:
+ *
+ * InferenceSession session;
+ * session.Load();
+ * session.Initialize();
+ * ...
+ * std::unique_ptr<PreparedRun> prepared_run;
+ * session.PrepareRun(feed_names, output_names, nullptr, prepared_run);
+ *
+ * // hot path. only the OrtValue instances are provided.
+ * session.Run(run_options, *prepared_run, feeds, &fetches);
+ *
+ * The names are validated and resolved to OrtValue indices once, and the static device copy info is calculated
+ * once, instead of on every call to Run.
+ * A PreparedRun holds per-execution state so it must not be used by more than one concurrent Run call.
+ * Create one per thread if the session is run concurrently.
+ * It is only valid for the InferenceSession that created it, and must not outlive that session.
+ */
+class PreparedRun {
+ public:
+  const FeedsFetchesInfo& GetFeedsFetchesInfo() const {
+    return feeds_fetches_manager_.GetFeedsFetchesInfo();
+  }
+
+  size_t NumFeeds() const { return feed_defs_.size(); }
+  size_t NumFetches() const { return GetFeedsFetchesInfo().output_names.size(); }
+
+ private:
+  friend InferenceSession;
+
+  PreparedRun(const InferenceSession& session, FeedsFetchesInfo&& info)
+      : session_(session), feeds_fetches_manager_(std::move(info)) {
+  }
+
+  ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(PreparedRun);
+
+  // Restore the FeedsFetchesManager to the state it was in after the static copy info was calculated so the
+  // per-execution copy info can be finalized for the feeds and fetches of the next Run.
+  void ResetForRun() {
+    if (!copy_needed_possible_) {
+      return;
+    }
+
+    auto& fetch_copy_info = feeds_fetches_manager_.GetMutableFetchesDeviceCopyInfo();
+    for (size_t i = 0, end = fetch_copy_info.size(); i < end; ++i) {
+      fetch_copy_info[i].target_device = fetch_target_devices_[i];
+    }
+
+    feeds_fetches_manager_.ResetDeviceCopyChecks();
+  }
+
+  // the expected type and shape of each feed, resolved from the model input definitions.
+  struct FeedDef {
+    MLDataType ml_data_type;
+    const TensorShape* tensor_shape;  // not applicable if the input is non-tensor type
+  };
+
+  const InferenceSession& session_;
+  FeedsFetchesManager feeds_fetches_manager_;
+  InlinedVector<FeedDef> feed_defs_;
+
+  // false if the session only has CPU based execution providers, in which case the device copy checks are
+  // permanently NoCopy and there is no per-execution state to reset.
+  bool copy_needed_possible_ = false;
+  InlinedVector<OrtDevice> fetch_target_devices_;
+};
+}  // namespace onnxruntime
@@ -12,6 +12,7 @@
 #include "core/session/ort_apis.h"
 #include "core/common/string_utils.h"
 #include "core/common/logging/logging.h"
+#include "core/platform/numa_topology.h"
 
 namespace onnxruntime {
 namespace concurrency {
@@ -71,6 +72,45 @@ static std::vector<LogicalProcessors> ReadThreadAffinityConfig(const std::string
 }
 #endif
 
+// Set the NUMA node of each thread in the pool. Threads with an affinity are assigned to the node of their first
+// processor. Otherwise the threads are distributed across the nodes in proportion to the number of processors on
+// each node, and restricted to run on their node's processors.
+static void SetThreadNumaNodes(const NumaTopology& topology, int thread_pool_size, ThreadOptions& to) {
+  const bool has_affinities = !to.affinities.empty();
+
+  // the first entry is for the caller thread which the pool does not manage
+  to.numa_nodes.assign(static_cast<size_t>(thread_pool_size), -1);
+  if (!has_affinities) {
+    to.affinities.resize(static_cast<size_t>(thread_pool_size));
+  }
+
+  size_t total_processors = 0;
+  for (const auto& processors : topology) {
+    total_processors += processors.size();
+  }
+
+  const size_t num_workers = static_cast<size_t>(thread_pool_size) - 1;
+  size_t node = 0;
+  size_t node_end = topology[0].size();
+  for (size_t i = 1; i < static_cast<size_t>(thread_pool_size); ++i) {
+    if (has_affinities) {
+      if (i < to.affinities.size() && !to.affinities[i].empty()) {
+        to.numa_nodes[i] = GetNumaNodeOfProcessor(topology, to.affinities[i].front());
+      }
+      continue;
+    }
+
+    // position of this worker scaled to the total number of processors
+    const size_t position = (i - 1) * total_processors / num_workers;
+    while (position >= node_end) {
+      ++node;
+      node_end += topology[node].size();
+    }
+    to.numa_nodes[i] = static_cast<int>(node);
+    to.affinities[i] = topology[node];
+  }
+}
+
 static std::unique_ptr<ThreadPool>
 CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
   ThreadOptions to;
@@ -109,6 +149,22 @@ CreateThreadPoolHelper(Env* env, OrtThreadPoolParams options) {
 #endif
   }
 
+  if (options.numa_aware) {
+    NumaTopology topology;
+    if (!options.numa_topology_str.empty()) {
+      ORT_THROW_IF_ERROR(ParseNumaTopology(options.numa_topology_str, topology));
+    } else {
+      topology = Env::Default().GetNumaTopology();
+    }
+
+    if (GetNumberOfNumaNodesWithProcessors(topology) > 1) {
+      SetThreadNumaNodes(topology, options.thread_pool_size, to);
+    } else {
+      LOGS_DEFAULT(INFO) << "A NUMA-aware thread pool was requested but there is only one NUMA node. "
+                         << "The threads will not be grouped by node.";
+    }
+  }
+
   to.set_denormal_as_zero = options.set_denormal_as_zero;
   // set custom thread management members
   to.custom_create_thread_fn = options.custom_create_thread_fn;
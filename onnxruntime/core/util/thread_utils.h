@@ -37,6 +37,16 @@ struct OrtThreadPoolParams {
   // meaning ith thread will be attached to first 8 logical processors
   std::string affinity_str;
 
+  // If true, group the threads by NUMA node so that work is kept on one node where possible.
+  // Threads without an affinity setting are distributed across the nodes and restricted to the processors
+  // of their node.
+  bool numa_aware = false;
+
+  // The NUMA topology to use instead of the one discovered from the system, in the format
+  // "<node 0 processors>;<node 1 processors>;...", e.g. "0-3;4-7". Processor ids start from 0.
+  // Allows a NUMA system to be emulated, e.g. for testing.
+  std::string numa_topology_str;
+
   const ORTCHAR_T* name = nullptr;
 
   // Set or unset denormal as zero
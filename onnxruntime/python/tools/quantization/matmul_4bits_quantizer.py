@@ -0,0 +1,208 @@
+# -------------------------------------------------------------------------
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See License.txt in the project root for
+# license information.
+# --------------------------------------------------------------------------
+
+import argparse
+import logging
+import os
+from typing import Tuple
+
+import numpy as np
+import numpy.typing as npt
+import onnx
+from onnx.onnx_pb import ModelProto, NodeProto, TensorProto
+
+from .onnx_model import ONNXModel
+from .quant_utils import ms_domain
+
+logger = logging.getLogger(__name__)
+
+
+class MatMul4BitsQuantizer:
+    """Block-wise 4-bit weight only quantizer.
+
+    Replaces every MatMul whose second input is a 2D float initializer with a MatMulNBits node
+    (com.microsoft domain). The weights are quantized along K: every block of block_size elements of a
+    column of B shares a scale, and a zero point unless is_symmetric is set.
+    """
+
+    def __init__(
+        self,
+        model: ModelProto,
+        block_size: int,
+        is_symmetric: bool,
+        accuracy_level: int = 0,
+        nodes_to_exclude=None,
+    ):
+        if block_size < 16 or block_size > 256 or (block_size & (block_size - 1)) != 0:
+            raise ValueError(f"block_size must be a power of 2 in [16, 256], got {block_size}")
+        if accuracy_level < 0 or accuracy_level > 4:
+            raise ValueError(f"accuracy_level must be in [0, 4], got {accuracy_level}")
+
+        self.model = ONNXModel(model)
+        self.block_size = block_size
+        self.is_symmetric = is_symmetric
+        self.accuracy_level = accuracy_level
+        self.nodes_to_exclude = set(nodes_to_exclude or [])
+
+    def int4_block_quant(self, fp32weight: npt.ArrayLike) -> Tuple[np.ndarray, np.ndarray, np.ndarray]:
+        """Quantize a [K, N] weight. Returns the packed data [N, k_blocks, block_size / 2], the scales
+        [N * k_blocks] and the packed zero points [N * ceil(k_blocks / 2)]."""
+        if len(fp32weight.shape) != 2:
+            raise ValueError("Current int4 block quantization only supports 2D tensors!")
+        k, n = fp32weight.shape
+        block_size = self.block_size
+        k_blocks = (k + block_size - 1) // block_size
+
+        # [N, k_blocks, block_size], padded with zeros past K
+        padded = np.zeros((n, k_blocks * block_size), dtype=np.float32)
+        padded[:, :k] = fp32weight.T
+        blocks = padded.reshape(n, k_blocks, block_size)
+
+        if self.is_symmetric:
+            abs_max = np.abs(blocks).max(axis=2, keepdims=True)
+            scales = abs_max / 7.0
+            zero_points = np.full(scales.shape, 8, dtype=np.int32)
+        else:
+            min_value = np.minimum(blocks.min(axis=2, keepdims=True), 0.0)
+            max_value = np.maximum(blocks.max(axis=2, keepdims=True), 0.0)
+            scales = (max_value - min_value) / 15.0
+            safe_scales = np.where(scales == 0.0, 1.0, scales)
+            zero_points = np.clip(np.rint(-min_value / safe_scales), 0, 15).astype(np.int32)
+            zero_points = np.where(scales == 0.0, 8, zero_points)
+
+        reciprocal_scales = np.where(scales == 0.0, 0.0, 1.0 / np.where(scales == 0.0, 1.0, scales))
+        quant = np.clip(np.rint(blocks * reciprocal_scales) + zero_points, 0, 15).astype(np.uint8)
+
+        # two elements per byte, the even element in the low nibble
+        packed = quant[:, :, 0::2] | (quant[:, :, 1::2] << 4)
+
+        zero_points = zero_points.reshape(n, k_blocks).astype(np.uint8)
+        if k_blocks % 2 != 0:
+            zero_points = np.pad(zero_points, ((0, 0), (0, 1)), constant_values=0)
+        packed_zero_points = zero_points[:, 0::2] | (zero_points[:, 1::2] << 4)
+
+        return packed, scales.reshape(-1).astype(np.float32), packed_zero_points.reshape(-1)
+
+    def _q4_matmul_node_weight(self, node: NodeProto) -> NodeProto:
+        """If the second input of a MatMul is a 2D float initializer, quantize it and return the
+        MatMulNBits node that replaces the MatMul. Otherwise return the MatMul."""
+        if node.op_type != "MatMul" or node.name in self.nodes_to_exclude:
+            return node
+
+        b_initializer = self.model.get_initializer(node.input[1])
+        if b_initializer is None or b_initializer.data_type != TensorProto.FLOAT:
+            return node
+
+        b_array = onnx.numpy_helper.to_array(b_initializer)
+        if len(b_array.shape) != 2:
+            logger.info(f"MatMul weight is not 2D, skipping node {node.name}")
+            return node
+
+        packed, scales, zero_points = self.int4_block_quant(b_array)
+        k, n = b_array.shape
+
+        b_quant = onnx.numpy_helper.from_array(packed, b_initializer.name + "_Q4")
+        scales_tensor = onnx.numpy_helper.from_array(scales, b_initializer.name + "_scales")
+        self.model.add_initializer(b_quant)
+        self.model.add_initializer(scales_tensor)
+
+        inputs = [node.input[0], b_quant.name, scales_tensor.name]
+        if not self.is_symmetric:
+            zp_tensor = onnx.numpy_helper.from_array(zero_points, b_initializer.name + "_zero_points")
+            self.model.add_initializer(zp_tensor)
+            inputs.append(zp_tensor.name)
+
+        kwargs = {
+            "K": k,
+            "N": n,
+            "bits": 4,
+            "block_size": self.block_size,
+        }
+        if self.accuracy_level > 0:
+            kwargs["accuracy_level"] = self.accuracy_level
+
+        return onnx.helper.make_node(
+            "MatMulNBits",
+            inputs=inputs,
+            outputs=[node.output[0]],
+            name=node.name + "_Q4" if node.name else "",
+            domain=ms_domain,
+            **kwargs,
+        )
+
+    def process(self):
+        graph = self.model.graph()
+        new_nodes = []
+        for node in graph.node:
+            new_nodes.append(self._q4_matmul_node_weight(node))
+
+        graph.ClearField("node")
+        graph.node.extend(new_nodes)
+
+        if not any(opset.domain == ms_domain for opset in self.model.opset_import()):
+            self.model.opset_import().extend([onnx.helper.make_opsetid(ms_domain, 1)])
+
+        self.model.remove_unused_constant()
+        self.model.clean_initializers()
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(
+        description="""Blockwise int4 quantization for MatMul 2D weight matrices.
+
+A weight matrix is partitioned into blocks, where each block is a contiguous
+subset inside each column. Each block is quantized into a set of 4b integers
+with a scaling factor and an optional offset.
+"""
+    )
+
+    parser.add_argument("--input_model", required=True, help="Path to the input model file")
+    parser.add_argument("--output_model", required=True, help="Path to the output model file")
+    parser.add_argument("--block_size", required=False, default=32, type=int, help="Block size for quantization")
+    parser.add_argument(
+        "--symmetric",
+        required=False,
+        default=True,
+        type=lambda x: x.lower() in ("true", "1"),
+        help="Indicate whether to quantize the model symmetrically",
+    )
+    parser.add_argument(
+        "--accuracy_level",
+        required=False,
+        default=0,
+        type=int,
+        help="Accuracy level of the MatMulNBits nodes, 4 allows the activations to be quantized to int8",
+    )
+    parser.add_argument(
+        "--nodes_to_exclude",
+        nargs="+",
+        type=str,
+        required=False,
+        default=[],
+        help="Specify the nodes to be excluded from quantization with node names",
+    )
+    parser.add_argument("-v", "--verbose", required=False, action="store_true")
+    parser.set_defaults(verbose=False)
+
+    return parser.parse_args()
+
+
+if __name__ == "__main__":
+    args = parse_args()
+    if args.verbose:
+        logger.setLevel(logging.DEBUG)
+
+    input_model_path = args.input_model
+    output_model_path = args.output_model
+
+    if os.path.exists(output_model_path):
+        logger.error(f"file {output_model_path} already exists")
+        raise Exception(f"file {output_model_path} already exists")
+
+    model = onnx.load(input_model_path)
+    quant = MatMul4BitsQuantizer(model, args.block_size, args.symmetric, args.accuracy_level, args.nodes_to_exclude)
+    quant.process()
+    quant.model.save_model_to_file(output_model_path, True)
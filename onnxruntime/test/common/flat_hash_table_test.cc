@@ -0,0 +1,151 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/flat_hash_table.h"
+
+#include <limits>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "core/util/thread_utils.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(FlatHashTableTest, InsertFind) {
+  FlatHashTable<int64_t, float> table;
+  EXPECT_TRUE(table.Empty());
+  EXPECT_EQ(table.Find(1), nullptr);
+  EXPECT_EQ(table.FindIndex(1), (FlatHashTable<int64_t, float>::npos));
+
+  EXPECT_EQ(table.Insert(10, 1.f), 0u);
+  EXPECT_EQ(table.Insert(-3, 2.f), 1u);
+  // An existing key keeps its entry and gets the new value.
+  EXPECT_EQ(table.Insert(10, 3.f), 0u);
+
+  EXPECT_EQ(table.Size(), 2u);
+  ASSERT_NE(table.Find(10), nullptr);
+  EXPECT_EQ(*table.Find(10), 3.f);
+  ASSERT_NE(table.Find(-3), nullptr);
+  EXPECT_EQ(*table.Find(-3), 2.f);
+  EXPECT_EQ(table.Find(11), nullptr);
+  EXPECT_EQ(table.KeyAt(1), -3);
+  EXPECT_EQ(table.ValueAt(1), 2.f);
+}
+
+TEST(FlatHashTableTest, ReinsertKeepsIndex) {
+  // Numbering keys by insertion order must look up an existing key before inserting it,
+  // Insert replaces the value of a key that is already in the table.
+  FlatHashTable<std::string, size_t> table;
+  for (const char* key : {"5", "6", "5", "7", "6"}) {
+    size_t index = table.FindIndex(key);
+    if (index == table.npos) {
+      index = table.Insert(key, table.Size());
+    }
+    EXPECT_EQ(table.ValueAt(index), index);
+  }
+  EXPECT_EQ(table.Size(), 3u);
+  EXPECT_EQ(*table.Find("5"), 0u);
+  EXPECT_EQ(*table.Find("6"), 1u);
+  EXPECT_EQ(*table.Find("7"), 2u);
+
+  EXPECT_EQ(table.Insert("6", 10), 1u);
+  EXPECT_EQ(table.Size(), 3u);
+  EXPECT_EQ(*table.Find("6"), 10u);
+  EXPECT_EQ(table.KeyAt(1), "6");
+}
+
+TEST(FlatHashTableTest, StringKeys) {
+  FlatHashTable<std::string, int64_t> table;
+  table.Insert("a", 1);
+  table.Insert("", 2);
+  table.Insert("abc", 3);
+  table.Insert(std::string("a\0b", 3), 4);
+
+  EXPECT_EQ(table.Size(), 4u);
+  EXPECT_EQ(*table.Find("a"), 1);
+  EXPECT_EQ(*table.Find(""), 2);
+  EXPECT_EQ(*table.Find("abc"), 3);
+  EXPECT_EQ(*table.Find(std::string_view("a\0b", 3)), 4);
+  EXPECT_EQ(table.Find("ab"), nullptr);
+  EXPECT_EQ(table.Find("abcd"), nullptr);
+  EXPECT_EQ(table.KeyAt(2), "abc");
+  EXPECT_EQ(table.KeyAt(1), "");
+}
+
+TEST(FlatHashTableTest, FloatKeys) {
+  FlatHashTable<float, int64_t> table;
+  table.Insert(0.f, 1);
+  table.Insert(1.5f, 2);
+  table.Insert(std::numeric_limits<float>::quiet_NaN(), 3);
+
+  // 0 and -0 are the same key.
+  ASSERT_NE(table.Find(-0.f), nullptr);
+  EXPECT_EQ(*table.Find(-0.f), 1);
+  EXPECT_EQ(*table.Find(1.5f), 2);
+  // NaN is never equal to itself.
+  EXPECT_EQ(table.Find(std::numeric_limits<float>::quiet_NaN()), nullptr);
+}
+
+TEST(FlatHashTableTest, Growth) {
+  FlatHashTable<int64_t, int64_t> table;
+  // Keys that are multiples of a power of two must not collide.
+  for (int64_t i = 0; i < 10000; ++i) {
+    EXPECT_EQ(table.Insert(i << 20, i), static_cast<size_t>(i));
+  }
+  EXPECT_EQ(table.Size(), 10000u);
+  for (int64_t i = 0; i < 10000; ++i) {
+    ASSERT_NE(table.Find(i << 20), nullptr);
+    EXPECT_EQ(*table.Find(i << 20), i);
+    EXPECT_EQ(table.Find((i << 20) + 1), nullptr);
+  }
+}
+
+TEST(FlatHashTableTest, FindBatchMatchesUnorderedMap) {
+  std::default_random_engine generator(7);
+  std::uniform_int_distribution<int> letters('a', 'f');
+  std::uniform_int_distribution<size_t> lengths(0, 6);
+  auto random_string = [&]() {
+    std::string s(lengths(generator), ' ');
+    for (auto& c : s) {
+      c = static_cast<char>(letters(generator));
+    }
+    return s;
+  };
+
+  FlatHashTable<std::string, int64_t> table;
+  std::unordered_map<std::string, int64_t> expected_map;
+  table.Reserve(500);
+  for (int64_t i = 0; i < 500; ++i) {
+    std::string key = random_string();
+    table.Insert(key, i);
+    expected_map[key] = i;
+  }
+  EXPECT_EQ(table.Size(), expected_map.size());
+
+  std::vector<std::string> keys(5000);
+  for (auto& key : keys) {
+    key = random_string();
+  }
+  std::vector<int64_t> expected(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    auto it = expected_map.find(keys[i]);
+    expected[i] = it == expected_map.end() ? -1 : it->second;
+  }
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 4;
+  std::unique_ptr<concurrency::ThreadPool> tp(
+      concurrency::CreateThreadPool(&onnxruntime::Env::Default(), tpo, concurrency::ThreadPoolType::INTRA_OP));
+  for (concurrency::ThreadPool* pool : {static_cast<concurrency::ThreadPool*>(nullptr), tp.get()}) {
+    std::vector<int64_t> out(keys.size());
+    table.FindBatch(gsl::span<const std::string>(keys), int64_t{-1}, gsl::make_span(out), pool);
+    EXPECT_EQ(out, expected);
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -6,16 +6,19 @@
 #include "test/common/tensor_op_test_utils.h"
 #include "test/common/cuda_op_test_utils.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/util/include/default_providers.h"
 #include "test/util/include/scoped_env_vars.h"
 #include "contrib_ops/cpu/bert/attention_common.h"
 #include "test/contrib_ops/attention_op_test_helper.h"
+#include <algorithm>
+#include <cmath>
 #include <limits>
 
 namespace onnxruntime {
 
 namespace test {
 
-// This op is currently only supported on CUDA- so test it only for CUDA
+// The CUDA kernel reorders the key cache, which the CUDA tests below reproduce
 #ifdef USE_CUDA
 
 template <typename T>
@@ -863,5 +866,247 @@ TEST(DecoderMaskedSelfAttentionTest, Test_fp16) {
 
 #endif
 
+// Reference attention of a single query over caches of shape (B, N, M, H) that already hold the new token. With a
+// cache indirection, the key and value at position t < past_sequence_length of batch entry b are read from the beam
+// cache_indir[b * M + t] of the same batch.
+static std::vector<float> DecoderMaskedAttentionReference(const std::vector<float>& q,
+                                                          const std::vector<float>& k_cache,
+                                                          const std::vector<float>& v_cache,
+                                                          const std::vector<int32_t>& mask,
+                                                          const std::vector<int32_t>& cache_indir,
+                                                          int batch_size, int num_heads, int head_size,
+                                                          int past_sequence_length, int total_sequence_length,
+                                                          int max_sequence_length, int beam_width) {
+  std::vector<float> output(static_cast<size_t>(batch_size) * num_heads * head_size);
+  const double scale = 1.0 / std::sqrt(static_cast<double>(head_size));
+
+  for (int b = 0; b < batch_size; b++) {
+    for (int n = 0; n < num_heads; n++) {
+      const size_t q_offset = (static_cast<size_t>(b) * num_heads + n) * head_size;
+      std::vector<double> scores(total_sequence_length);
+      std::vector<size_t> rows(total_sequence_length);
+      for (int t = 0; t < total_sequence_length; t++) {
+        int source = b;
+        if (!cache_indir.empty() && t < past_sequence_length) {
+          source = (b / beam_width) * beam_width + cache_indir[static_cast<size_t>(b) * max_sequence_length + t];
+        }
+        rows[t] = ((static_cast<size_t>(source) * num_heads + n) * max_sequence_length + t) * head_size;
+
+        double dot = 0.0;
+        for (int h = 0; h < head_size; h++) {
+          dot += static_cast<double>(q[q_offset + h]) * k_cache[rows[t] + h];
+        }
+        scores[t] = dot * scale;
+        if (!mask.empty() && mask[static_cast<size_t>(b) * total_sequence_length + t] == 0) {
+          scores[t] += -10000.0;
+        }
+      }
+
+      double max = *std::max_element(scores.begin(), scores.end());
+      double sum = 0.0;
+      for (auto& score : scores) {
+        score = std::exp(score - max);
+        sum += score;
+      }
+
+      for (int h = 0; h < head_size; h++) {
+        double value = 0.0;
+        for (int t = 0; t < total_sequence_length; t++) {
+          value += scores[t] / sum * v_cache[rows[t] + h];
+        }
+        output[q_offset + h] = static_cast<float>(value);
+      }
+    }
+  }
+
+  return output;
+}
+
+// Writes the key or value of shape (B, 1, N x H) of the new token at position P of a cache of shape (B, N, M, H).
+static void AppendToCache(std::vector<float>& cache, const float* data, int batch_size, int num_heads, int head_size,
+                          int past_sequence_length, int max_sequence_length) {
+  for (int i = 0; i < batch_size * num_heads; i++) {
+    std::copy_n(data + static_cast<size_t>(i) * head_size, head_size,
+                cache.begin() + (static_cast<size_t>(i) * max_sequence_length + past_sequence_length) * head_size);
+  }
+}
+
+TEST(DecoderMaskedMultiHeadAttentionTest, CpuSelfAttentionWithBeams) {
+  constexpr int batch_size = 2;
+  constexpr int beam_width = 2;
+  constexpr int batch_beam_size = batch_size * beam_width;
+  constexpr int num_heads = 2;
+  constexpr int head_size = 16;
+  constexpr int hidden_size = num_heads * head_size;
+  constexpr int max_sequence_length = 8;
+
+  RandomValueGenerator random{};
+
+  for (int past_sequence_length : {0, 5}) {
+    const int total_sequence_length = past_sequence_length + 1;
+
+    std::vector<int64_t> qkv_dims = {batch_beam_size, 1, hidden_size};
+    std::vector<int64_t> cache_dims = {batch_beam_size, num_heads, max_sequence_length, head_size};
+
+    std::vector<float> query = random.Uniform<float>(qkv_dims, -1.0f, 1.0f);
+    std::vector<float> key = random.Uniform<float>(qkv_dims, -1.0f, 1.0f);
+    std::vector<float> value = random.Uniform<float>(qkv_dims, -1.0f, 1.0f);
+    std::vector<float> past_key = random.Uniform<float>(cache_dims, -1.0f, 1.0f);
+    std::vector<float> past_value = random.Uniform<float>(cache_dims, -1.0f, 1.0f);
+
+    std::vector<int32_t> mask(static_cast<size_t>(batch_beam_size) * total_sequence_length, 1);
+    mask[0] = 0;  // left padding of the first batch entry
+
+    // Mix the source beams of the past tokens so that the keys are read in several runs.
+    std::vector<int32_t> cache_indir(static_cast<size_t>(batch_beam_size) * max_sequence_length, 0);
+    for (size_t i = 0; i < cache_indir.size(); i++) {
+      cache_indir[i] = static_cast<int32_t>((i * 7 / 3) % beam_width);
+    }
+
+    std::vector<float> present_key = past_key;
+    std::vector<float> present_value = past_value;
+    AppendToCache(present_key, key.data(), batch_beam_size, num_heads, head_size,
+                  past_sequence_length, max_sequence_length);
+    AppendToCache(present_value, value.data(), batch_beam_size, num_heads, head_size,
+                  past_sequence_length, max_sequence_length);
+
+    std::vector<float> output = DecoderMaskedAttentionReference(query, present_key, present_value, mask, cache_indir,
+                                                                batch_beam_size, num_heads, head_size,
+                                                                past_sequence_length, total_sequence_length,
+                                                                max_sequence_length, beam_width);
+
+    OpTester tester("DecoderMaskedMultiHeadAttention", 1, onnxruntime::kMSDomain);
+    tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(num_heads));
+    tester.AddAttribute<int64_t>("past_present_share_buffer", static_cast<int64_t>(1));
+
+    tester.AddInput<float>("query", qkv_dims, query);
+    tester.AddInput<float>("key", qkv_dims, key);
+    tester.AddInput<float>("value", qkv_dims, value);
+    tester.AddInput<int32_t>("mask_index", {batch_beam_size, total_sequence_length}, mask);
+    tester.AddOptionalInputEdge<float>();
+    tester.AddInput<float>("past_key", cache_dims, past_key);
+    tester.AddInput<float>("past_value", cache_dims, past_value);
+    tester.AddInput<int32_t>("past_sequence_length", {1}, {past_sequence_length});
+    tester.AddInput<int32_t>("beam_width", {1}, {beam_width});
+    tester.AddInput<int32_t>("cache_indirection", {batch_size, beam_width, max_sequence_length}, cache_indir);
+
+    tester.AddOutput<float>("output", qkv_dims, output);
+    tester.AddOutput<float>("present_key", cache_dims, present_key);
+    tester.AddOutput<float>("present_value", cache_dims, present_value);
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  }
+}
+
+TEST(DecoderMaskedMultiHeadAttentionTest, CpuCrossAttention) {
+  constexpr int batch_size = 3;
+  constexpr int num_heads = 4;
+  constexpr int head_size = 8;
+  constexpr int hidden_size = num_heads * head_size;
+  constexpr int kv_sequence_length = 11;
+
+  RandomValueGenerator random{};
+
+  std::vector<int64_t> query_dims = {batch_size, 1, hidden_size};
+  std::vector<int64_t> kv_dims = {batch_size, num_heads, kv_sequence_length, head_size};
+
+  std::vector<float> query = random.Uniform<float>(query_dims, -1.0f, 1.0f);
+  std::vector<float> key = random.Uniform<float>(kv_dims, -1.0f, 1.0f);
+  std::vector<float> value = random.Uniform<float>(kv_dims, -1.0f, 1.0f);
+
+  std::vector<float> output = DecoderMaskedAttentionReference(query, key, value, {}, {},
+                                                              batch_size, num_heads, head_size,
+                                                              0, kv_sequence_length, kv_sequence_length, 1);
+
+  OpTester tester("DecoderMaskedMultiHeadAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(num_heads));
+  tester.AddAttribute<int64_t>("past_present_share_buffer", static_cast<int64_t>(1));
+
+  tester.AddInput<float>("query", query_dims, query);
+  tester.AddInput<float>("key", kv_dims, key);
+  tester.AddInput<float>("value", kv_dims, value);
+
+  tester.AddOutput<float>("output", query_dims, output);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
+TEST(DecoderMaskedSelfAttentionTest, Cpu_fp32) {
+  constexpr int batch_size = 2;
+  constexpr int num_heads = 3;
+  constexpr int head_size = 8;
+  constexpr int hidden_size = num_heads * head_size;
+  constexpr int input_hidden_size = 20;
+  constexpr int max_sequence_length = 6;
+  constexpr int past_sequence_length = 3;
+  constexpr int total_sequence_length = past_sequence_length + 1;
+
+  RandomValueGenerator random{};
+
+  std::vector<int64_t> input_dims = {batch_size, 1, input_hidden_size};
+  std::vector<int64_t> weights_dims = {input_hidden_size, 3 * hidden_size};
+  std::vector<int64_t> bias_dims = {3 * hidden_size};
+  std::vector<int64_t> output_dims = {batch_size, 1, hidden_size};
+  std::vector<int64_t> past_dims = {2, batch_size, num_heads, max_sequence_length, head_size};
+
+  std::vector<float> input = random.Uniform<float>(input_dims, -1.0f, 1.0f);
+  std::vector<float> weights = random.Uniform<float>(weights_dims, -0.5f, 0.5f);
+  std::vector<float> bias = random.Uniform<float>(bias_dims, -0.5f, 0.5f);
+  std::vector<float> past = random.Uniform<float>(past_dims, -1.0f, 1.0f);
+
+  std::vector<int32_t> mask(static_cast<size_t>(batch_size) * total_sequence_length, 1);
+  mask[total_sequence_length + 1] = 0;
+
+  // qkv(B, 3D) = input(B, D_i) x weights(D_i, 3D) + bias(3D)
+  std::vector<float> q, k, v;
+  for (int b = 0; b < batch_size; b++) {
+    for (int j = 0; j < 3 * hidden_size; j++) {
+      double sum = bias[j];
+      for (int i = 0; i < input_hidden_size; i++) {
+        sum += static_cast<double>(input[b * input_hidden_size + i]) * weights[i * 3 * hidden_size + j];
+      }
+      std::vector<float>& qkv = (j < hidden_size) ? q : (j < 2 * hidden_size) ? k : v;
+      qkv.push_back(static_cast<float>(sum));
+    }
+  }
+
+  const size_t cache_size = past.size() / 2;
+  std::vector<float> present_key(past.begin(), past.begin() + cache_size);
+  std::vector<float> present_value(past.begin() + cache_size, past.end());
+  AppendToCache(present_key, k.data(), batch_size, num_heads, head_size, past_sequence_length, max_sequence_length);
+  AppendToCache(present_value, v.data(), batch_size, num_heads, head_size, past_sequence_length, max_sequence_length);
+
+  std::vector<float> output = DecoderMaskedAttentionReference(q, present_key, present_value, mask, {},
+                                                              batch_size, num_heads, head_size,
+                                                              past_sequence_length, total_sequence_length,
+                                                              max_sequence_length, 1);
+
+  std::vector<float> present = present_key;
+  present.insert(present.end(), present_value.begin(), present_value.end());
+
+  OpTester tester("DecoderMaskedSelfAttention", 1, onnxruntime::kMSDomain);
+  tester.AddAttribute<int64_t>("num_heads", static_cast<int64_t>(num_heads));
+  tester.AddAttribute<int64_t>("past_present_share_buffer", static_cast<int64_t>(1));
+
+  tester.AddInput<float>("input", input_dims, input);
+  tester.AddInput<float>("weight", weights_dims, weights);
+  tester.AddInput<float>("bias", bias_dims, bias);
+  tester.AddInput<int32_t>("mask_index", {batch_size, total_sequence_length}, mask);
+  tester.AddInput<float>("past", past_dims, past);
+  tester.AddOptionalInputEdge<float>();
+  tester.AddInput<int32_t>("past_sequence_length", {1}, {past_sequence_length});
+
+  tester.AddOutput<float>("output", output_dims, output);
+  tester.AddOutput<float>("present", past_dims, present);
+
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  tester.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 }  // namespace test
-}  // namespace onnxruntime
\ No newline at end of file
+}  // namespace onnxruntime
@@ -0,0 +1,176 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/common/span_utils.h"
+#include "test/common/tensor_op_test_utils.h"
+#include "test/providers/provider_test_utils.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// Quantizes B ([K, N], row major) the way MatMulNBits expects it and returns the dequantized B that the
+// reference computes with.
+void QuantizeB(const std::vector<float>& B, int64_t K, int64_t N, int64_t block_size, bool has_zero_point,
+               std::vector<uint8_t>& quant_data, std::vector<float>& scales, std::vector<uint8_t>& zero_points,
+               std::vector<float>& dequant_B) {
+  const int64_t k_blocks = (K + block_size - 1) / block_size;
+  const int64_t blob_size = block_size / 2;
+  const int64_t zero_point_stride = (k_blocks + 1) / 2;
+
+  quant_data.assign(static_cast<size_t>(N * k_blocks * blob_size), 0);
+  scales.assign(static_cast<size_t>(N * k_blocks), 0.0f);
+  zero_points.assign(static_cast<size_t>(N * zero_point_stride), 0);
+  dequant_B.assign(static_cast<size_t>(K * N), 0.0f);
+
+  for (int64_t n = 0; n < N; n++) {
+    for (int64_t blk = 0; blk < k_blocks; blk++) {
+      const int64_t k_begin = blk * block_size;
+      const int64_t k_end = std::min(K, k_begin + block_size);
+
+      float min_value = 0.0f;
+      float max_value = 0.0f;
+      for (int64_t k = k_begin; k < k_end; k++) {
+        min_value = std::min(min_value, B[k * N + n]);
+        max_value = std::max(max_value, B[k * N + n]);
+      }
+
+      float scale;
+      int zp;
+      if (has_zero_point) {
+        scale = (max_value - min_value) / 15.0f;
+        zp = scale == 0.0f ? 8 : std::clamp(static_cast<int>(std::round(-min_value / scale)), 0, 15);
+      } else {
+        const float abs_max = std::max(-min_value, max_value);
+        scale = abs_max / 7.0f;
+        zp = 8;
+      }
+      const float reciprocal_scale = scale == 0.0f ? 0.0f : 1.0f / scale;
+
+      scales[n * k_blocks + blk] = scale;
+      if (has_zero_point) {
+        zero_points[n * zero_point_stride + blk / 2] |= static_cast<uint8_t>(zp << ((blk & 1) * 4));
+      }
+
+      uint8_t* blob = quant_data.data() + (n * k_blocks + blk) * blob_size;
+      for (int64_t k = k_begin; k < k_end; k++) {
+        const int q = std::clamp(static_cast<int>(std::round(B[k * N + n] * reciprocal_scale)) + zp, 0, 15);
+        const int64_t i = k - k_begin;
+        blob[i / 2] |= static_cast<uint8_t>(q << ((i & 1) * 4));
+        dequant_B[k * N + n] = static_cast<float>(q - zp) * scale;
+      }
+    }
+  }
+}
+
+void RunTest(int64_t M, int64_t N, int64_t K, int64_t block_size, bool has_zero_point, int64_t accuracy_level = 0,
+             std::vector<int64_t> batch_dims = {}) {
+  RandomValueGenerator random{1234};
+  std::vector<int64_t> a_dims(batch_dims);
+  a_dims.push_back(M);
+  a_dims.push_back(K);
+  std::vector<float> A = random.Uniform<float>(a_dims, -1.0f, 1.0f);
+  std::vector<float> B = random.Uniform<float>(AsSpan({K, N}), -1.0f, 1.0f);
+
+  std::vector<uint8_t> quant_data;
+  std::vector<float> scales;
+  std::vector<uint8_t> zero_points;
+  std::vector<float> dequant_B;
+  QuantizeB(B, K, N, block_size, has_zero_point, quant_data, scales, zero_points, dequant_B);
+
+  const int64_t rows = static_cast<int64_t>(A.size()) / K;
+  std::vector<float> expected(static_cast<size_t>(rows * N));
+  for (int64_t m = 0; m < rows; m++) {
+    for (int64_t n = 0; n < N; n++) {
+      double sum = 0.0;
+      for (int64_t k = 0; k < K; k++) {
+        sum += static_cast<double>(A[m * K + k]) * dequant_B[k * N + n];
+      }
+      expected[m * N + n] = static_cast<float>(sum);
+    }
+  }
+
+  const int64_t k_blocks = (K + block_size - 1) / block_size;
+  std::vector<int64_t> y_dims(batch_dims);
+  y_dims.push_back(M);
+  y_dims.push_back(N);
+
+  OpTester test("MatMulNBits", 1, kMSDomain);
+  test.AddAttribute<int64_t>("K", K);
+  test.AddAttribute<int64_t>("N", N);
+  test.AddAttribute<int64_t>("block_size", block_size);
+  test.AddAttribute<int64_t>("bits", 4);
+  test.AddAttribute<int64_t>("accuracy_level", accuracy_level);
+  test.AddInput<float>("A", a_dims, A);
+  test.AddInput<uint8_t>("B", {N, k_blocks, block_size / 2}, quant_data, true);
+  test.AddInput<float>("scales", {N * k_blocks}, scales, true);
+  if (has_zero_point) {
+    test.AddInput<uint8_t>("zero_points", {N * ((k_blocks + 1) / 2)}, zero_points, true);
+  }
+  test.AddOutput<float>("Y", y_dims, expected);
+
+  if (accuracy_level == 4) {
+    // The activations are quantized to int8 per block.
+    test.SetOutputAbsErr("Y", 0.1f);
+  } else {
+    test.SetOutputAbsErr("Y", 1e-3f);
+  }
+
+  test.Run();
+}
+
+}  // namespace
+
+TEST(MatMulNBits, Float32) {
+  for (auto M : {1, 2, 5, 32}) {
+    for (auto N : {1, 32, 288}) {
+      for (auto K : {16, 32, 256, 1024, 93, 1234}) {
+        for (auto block_size : {16, 32, 64, 128}) {
+          RunTest(M, N, K, block_size, false);
+          RunTest(M, N, K, block_size, true);
+        }
+      }
+    }
+  }
+}
+
+TEST(MatMulNBits, Float32_AccuracyLevel4) {
+  for (auto M : {1, 3, 32}) {
+    for (auto N : {1, 32, 288}) {
+      for (auto K : {16, 64, 256, 93}) {
+        for (auto block_size : {16, 32, 128}) {
+          RunTest(M, N, K, block_size, false, 4);
+          RunTest(M, N, K, block_size, true, 4);
+        }
+      }
+    }
+  }
+}
+
+TEST(MatMulNBits, Float32_Batched) {
+  RunTest(3, 64, 256, 32, true, 0, {2});
+  RunTest(1, 64, 100, 64, false, 0, {2, 3});
+  RunTest(4, 64, 256, 32, true, 4, {2});
+}
+
+TEST(MatMulNBits, InvalidKDim) {
+  OpTester test("MatMulNBits", 1, kMSDomain);
+  test.AddAttribute<int64_t>("K", 64);
+  test.AddAttribute<int64_t>("N", 4);
+  test.AddAttribute<int64_t>("block_size", 32);
+  test.AddInput<float>("A", {2, 32}, std::vector<float>(64, 1.0f));
+  test.AddInput<uint8_t>("B", {4, 2, 16}, std::vector<uint8_t>(128, 0x88));
+  test.AddInput<float>("scales", {8}, std::vector<float>(8, 1.0f));
+  test.AddOutput<float>("Y", {2, 4}, std::vector<float>(8, 0.0f));
+  test.Run(OpTester::ExpectResult::kExpectFailure, "The last dimension of input A must equal the attribute K");
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -76,9 +76,7 @@ static void RunTest(
     }
 
     test.Run();
-  } else if (HasCudaEnvironment(530 /*min_cuda_architecture*/) ||
-             dml_ep != nullptr ||
-             rocm_ep != nullptr) {
+  } else {
     OpTester test(op_type.c_str(), 1, onnxruntime::kMSDomain);
     test.AddInput<MLFloat16>("input", input_dims, ToFloat16(input_data));
     test.AddInput<MLFloat16>("skip", skip_dims, ToFloat16(skip_data));
@@ -112,10 +110,19 @@ static void RunTest(
       execution_providers.push_back(DefaultDmlExecutionProvider());
     } else if (rocm_ep != nullptr) {
       execution_providers.push_back(DefaultRocmExecutionProvider());
-    } else {
+    } else if (HasCudaEnvironment(530 /*min_cuda_architecture*/)) {
       execution_providers.push_back(DefaultCudaExecutionProvider());
     }
 
+    // The CPU kernel does not implement the simplified variant.
+    if (!simplified) {
+      execution_providers.push_back(DefaultCpuExecutionProvider());
+    }
+
+    if (execution_providers.empty()) {
+      return;
+    }
+
     test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
   }
 }
@@ -0,0 +1,201 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/session/batching_session.h"
+
+#include <thread>
+#include <variant>
+
+#include "core/common/narrow.h"
+#include "core/framework/tensor.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// Y = X + X where each dimension of X and Y is either a fixed value or a symbol.
+// if sequence_output is true the model has the additional output S = SequenceConstruct(Y).
+void LoadAddModel(InferenceSession& session, const std::vector<std::variant<int64_t, std::string>>& dims,
+                  bool sequence_output = false) {
+  onnxruntime::Model model("batching", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  for (const auto& dim : dims) {
+    auto* shape_dim = float_tensor.mutable_tensor_type()->mutable_shape()->add_dim();
+    if (std::holds_alternative<int64_t>(dim)) {
+      shape_dim->set_dim_value(std::get<int64_t>(dim));
+    } else {
+      shape_dim->set_dim_param(std::get<std::string>(dim));
+    }
+  }
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("add", "Add", "Y = X + X", {&x, &x}, {&y});
+  if (sequence_output) {
+    auto& s = graph.GetOrCreateNodeArg("S", nullptr);
+    graph.AddNode("sequence", "SequenceConstruct", "S = [Y]", {&y}, {&s});
+    // Y is consumed by SequenceConstruct, so it is only a graph output if it is set explicitly
+    graph.SetOutputs({&y, &s});
+  }
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+}
+
+// run the requests concurrently, each with its own thread. request i fills its input with i.
+// the first output must be Y.
+void RunConcurrently(BatchingSession& batching_session, const std::vector<std::vector<int64_t>>& request_dims,
+                     const std::vector<std::string>& output_names = {"Y"}) {
+  const std::vector<std::string> feed_names{"X"};
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(OrtMemTypeDefault);
+
+  std::vector<std::thread> threads;
+  std::vector<Status> statuses(request_dims.size());
+  std::vector<std::vector<OrtValue>> fetches(request_dims.size());
+  for (size_t i = 0; i < request_dims.size(); ++i) {
+    threads.emplace_back([&, i]() {
+      const auto& dims = request_dims[i];
+      std::vector<float> values(narrow<size_t>(TensorShape(dims).Size()), static_cast<float>(i));
+      std::vector<OrtValue> feeds(1);
+      CreateMLValue<float>(allocator, dims, values, &feeds[0]);
+      statuses[i] = batching_session.Run(RunOptions{}, feed_names, feeds, output_names, &fetches[i]);
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  for (size_t i = 0; i < request_dims.size(); ++i) {
+    ASSERT_STATUS_OK(statuses[i]);
+    ASSERT_EQ(fetches[i].size(), output_names.size());
+    const auto& y = fetches[i][0].Get<Tensor>();
+    ASSERT_EQ(y.Shape(), TensorShape(request_dims[i]));
+    for (float value : y.DataAsSpan<float>()) {
+      ASSERT_EQ(value, 2.f * i);
+    }
+  }
+}
+
+}  // namespace
+
+TEST(BatchingSessionTest, CoalesceConcurrentRequests) {
+  SessionOptions so;
+  InferenceSession session{so, GetEnvironment()};
+  LoadAddModel(session, {std::string("batch"), int64_t{3}});
+
+  // the latency window is long enough for all requests to join a single batch
+  BatchingOptions options;
+  options.max_batch_size = 8;
+  options.max_latency = std::chrono::seconds(10);
+  BatchingSession batching_session(session, options);
+
+  RunConcurrently(batching_session, std::vector<std::vector<int64_t>>(8, {1, 3}));
+
+  auto stats = batching_session.GetStats();
+  EXPECT_EQ(stats.num_batches, uint64_t{1});
+  EXPECT_EQ(stats.num_requests, uint64_t{8});
+  EXPECT_EQ(stats.num_unbatched_requests, uint64_t{0});
+  ASSERT_EQ(stats.batch_size_histogram.size(), size_t{9});
+  EXPECT_EQ(stats.batch_size_histogram[8], uint64_t{1});
+}
+
+TEST(BatchingSessionTest, MaxLatency) {
+  SessionOptions so;
+  InferenceSession session{so, GetEnvironment()};
+  LoadAddModel(session, {std::string("batch"), int64_t{3}});
+
+  // a single request never fills the batch, so it must be run once the latency window expires
+  BatchingOptions options;
+  options.max_batch_size = 4;
+  options.max_latency = std::chrono::milliseconds(1);
+  BatchingSession batching_session(session, options);
+
+  RunConcurrently(batching_session, {{2, 3}});
+
+  auto stats = batching_session.GetStats();
+  EXPECT_EQ(stats.num_batches, uint64_t{1});
+  EXPECT_EQ(stats.batch_size_histogram[2], uint64_t{1});
+  ASSERT_FALSE(stats.queue_depth_histogram.empty());
+  EXPECT_EQ(stats.queue_depth_histogram[0], uint64_t{1});
+}
+
+TEST(BatchingSessionTest, InnerBatchAxis) {
+  SessionOptions so;
+  InferenceSession session{so, GetEnvironment()};
+  LoadAddModel(session, {int64_t{2}, std::string("batch"), int64_t{2}});
+
+  // the outputs are copied out of the batched output as the parts of each request are not contiguous
+  BatchingOptions options;
+  options.max_batch_size = 3;
+  options.max_latency = std::chrono::seconds(10);
+  options.batch_axis = 1;
+  BatchingSession batching_session(session, options);
+
+  RunConcurrently(batching_session, {{2, 1, 2}, {2, 2, 2}});
+
+  auto stats = batching_session.GetStats();
+  EXPECT_EQ(stats.num_batches, uint64_t{1});
+  EXPECT_EQ(stats.batch_size_histogram[3], uint64_t{1});
+}
+
+TEST(BatchingSessionTest, FixedBatchDimIsNotBatched) {
+  SessionOptions so;
+  InferenceSession session{so, GetEnvironment()};
+  LoadAddModel(session, {int64_t{2}, int64_t{3}});
+
+  BatchingOptions options;
+  options.max_latency = std::chrono::seconds(10);
+  BatchingSession batching_session(session, options);
+
+  // run directly on the session without waiting for the latency window
+  RunConcurrently(batching_session, {{2, 3}, {2, 3}});
+
+  auto stats = batching_session.GetStats();
+  EXPECT_EQ(stats.num_batches, uint64_t{0});
+  EXPECT_EQ(stats.num_unbatched_requests, uint64_t{2});
+}
+
+TEST(BatchingSessionTest, SequenceOutputIsNotBatched) {
+  SessionOptions so;
+  InferenceSession session{so, GetEnvironment()};
+  LoadAddModel(session, {std::string("batch"), int64_t{3}}, true);
+
+  BatchingOptions options;
+  options.max_latency = std::chrono::seconds(10);
+  BatchingSession batching_session(session, options);
+
+  // a sequence can not be split along the batch axis, so the requests that fetch S run directly on the session
+  RunConcurrently(batching_session, {{1, 3}, {2, 3}}, {"Y", "S"});
+
+  auto stats = batching_session.GetStats();
+  EXPECT_EQ(stats.num_batches, uint64_t{0});
+  EXPECT_EQ(stats.num_unbatched_requests, uint64_t{2});
+
+  // the tensor output of the same model is still batched
+  options.max_batch_size = 2;
+  BatchingSession y_batching_session(session, options);
+  RunConcurrently(y_batching_session, {{1, 3}, {1, 3}});
+
+  stats = y_batching_session.GetStats();
+  EXPECT_EQ(stats.num_batches, uint64_t{1});
+  EXPECT_EQ(stats.num_requests, uint64_t{2});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
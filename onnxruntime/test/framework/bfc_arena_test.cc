@@ -5,6 +5,10 @@
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
 #include <cstdlib>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
 #include "core/framework/stream_handles.h"
 
 namespace onnxruntime {
@@ -316,6 +320,257 @@ TEST(BFCArenaTest, TestBackoffDoesntHang) {
   EXPECT_THROW(a.Alloc(1024), OnnxRuntimeException) << "Arena should be unable to allocate memory";
 }
 
+TEST(BFCArenaTest, ThreadCacheReuse) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30,
+             BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
+             BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+             64 * 1024);
+
+  void* p1 = a.Alloc(1000);
+  a.Free(p1);
+
+  // same size class and fits in the cached chunk so it is served from the cache
+  void* p2 = a.Alloc(900);
+  EXPECT_EQ(p1, p2);
+
+  // different size class
+  void* p3 = a.Alloc(2000);
+  EXPECT_NE(p3, p2);
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.num_cache_hits, 1);
+  EXPECT_EQ(stats.num_cache_misses, 2);
+  EXPECT_EQ(stats.num_allocs, 2) << "cache hits should not reach the arena";
+  EXPECT_EQ(a.RequestedSize(p2), 1000u) << "requested size is from when the chunk was taken from the arena";
+
+  a.Free(p2);
+  a.Free(p3);
+}
+
+TEST(BFCArenaTest, ThreadCacheFlushOnThreshold) {
+  const int cache_size = 4 * 1024;
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30,
+             BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
+             BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+             cache_size);
+
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 5; ++i) {
+    ptrs.push_back(a.Alloc(1024));
+  }
+
+  AllocatorStats stats;
+  for (int i = 0; i < 4; ++i) {
+    a.Free(ptrs[i]);
+  }
+
+  // the cached chunks are still in use from the point of view of the arena
+  constexpr int64_t chunk_size = 1024 + BFCArena::kThreadCacheHeaderSize;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 5 * chunk_size);
+
+  // exceeds the cache size so the cached chunks are returned to the arena
+  a.Free(ptrs[4]);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, chunk_size);
+
+  // larger than the cache size so it bypasses the cache
+  void* large = a.Alloc(cache_size + 1);
+  a.Free(large);
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, chunk_size);
+  EXPECT_EQ(stats.num_cache_misses, 5);
+  EXPECT_EQ(stats.num_cache_hits, 0);
+}
+
+TEST(BFCArenaTest, ThreadCacheShrink) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30, ArenaExtendStrategy::kSameAsRequested,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
+             BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+             64 * 1024);
+
+  void* p1k = a.Alloc(1024);
+  a.Free(p1k);
+
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0) << "Shrink should return cached chunks to the arena";
+  EXPECT_EQ(stats.num_arena_shrinkages, 1);
+  EXPECT_EQ(stats.total_allocated_bytes, 0);
+}
+
+TEST(BFCArenaTest, ThreadCacheConcurrentAllocations) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30,
+             BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
+             BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+             16 * 1024);
+
+  // pointers allocated on one thread are freed on another, into the cache of a different thread
+  constexpr int num_threads = 8;
+  constexpr int num_iterations = 200;
+  std::vector<std::vector<void*>> allocated(num_threads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&a, &allocated, t]() {
+      for (int i = 0; i < num_iterations; ++i) {
+        size_t size = 64 + ((t * num_iterations + i) % 64) * 64;
+        void* p = a.Alloc(size);
+        memset(p, t, size);
+        if (i % 2 == 0) {
+          a.Free(p);
+        } else {
+          allocated[t].push_back(p);
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  threads.clear();
+  for (int t = 0; t < num_threads; ++t) {
+    threads.emplace_back([&a, &allocated, t]() {
+      for (void* p : allocated[(t + 1) % num_threads]) {
+        a.Free(p);
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(a.Shrink(), Status::OK());
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.num_cache_hits + stats.num_cache_misses, num_threads * num_iterations);
+}
+
+TEST(BFCArenaTest, ThreadCacheReturnedOnThreadExit) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30,
+             BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
+             BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+             64 * 1024);
+
+  std::thread([&a]() {
+    void* p1 = a.Alloc(1000);
+    a.Free(p1);
+    void* p2 = a.Alloc(1000);
+    EXPECT_EQ(p1, p2);
+    a.Free(p2);
+  }).join();
+
+  // the cache of the thread was returned to the arena when it exited, and its counters were kept
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.num_cache_hits, 1);
+  EXPECT_EQ(stats.num_cache_misses, 1);
+}
+
+TEST(BFCArenaTest, ThreadCacheFreeAfterThreadLocalsDestroyed) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30,
+             BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
+             BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+             64 * 1024);
+
+  // frees an allocation when the thread exits, as a static tensor released during exit() does.
+  // it is created before the first allocation of the thread, so it is destroyed after the caches of the thread.
+  struct FreeOnThreadExit {
+    BFCArena* arena = nullptr;
+    void* p = nullptr;
+    ~FreeOnThreadExit() {
+      if (p != nullptr) {
+        arena->Free(p);
+      }
+    }
+  };
+
+  std::thread([&a]() {
+    thread_local FreeOnThreadExit free_on_exit;
+    free_on_exit.arena = &a;
+    free_on_exit.p = a.Alloc(1000);
+  }).join();
+
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+}
+
+TEST(BFCArenaTest, ThreadCacheArenaDestroyedFirst) {
+  auto a = std::make_unique<BFCArena>(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30,
+                                      BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+                                      BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
+                                      BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+                                      BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+                                      64 * 1024);
+  void* p = a->Alloc(1000);
+
+  // the thread keeps the chunk in its cache of the arena, and exits after the arena is destroyed
+  std::mutex mutex;
+  std::condition_variable cv;
+  bool freed = false;
+  bool arena_destroyed = false;
+  std::thread thread([&]() {
+    a->Free(p);
+    std::unique_lock<std::mutex> lock(mutex);
+    freed = true;
+    cv.notify_all();
+    cv.wait(lock, [&arena_destroyed]() { return arena_destroyed; });
+  });
+
+  {
+    std::unique_lock<std::mutex> lock(mutex);
+    cv.wait(lock, [&freed]() { return freed; });
+    a.reset();
+    arena_destroyed = true;
+    cv.notify_all();
+  }
+
+  thread.join();
+}
+
+TEST(BFCArenaTest, ThreadCacheReserve) {
+  BFCArena a(std::unique_ptr<IAllocator>(new CPUAllocator()), 1 << 30,
+             BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY,
+             BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
+             BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+             BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+             64 * 1024);
+
+  // reserved chunks and allocations too large for the cache go back to the arena when they are freed
+  void* reserved = a.Reserve(1000);
+  void* large = a.Alloc(128 * 1024);
+  memset(reserved, 0, 1000);
+  memset(large, 0, 128 * 1024);
+  EXPECT_EQ(a.RequestedSize(large), size_t{128 * 1024});
+  EXPECT_EQ(a.AllocatedSize(large), size_t{128 * 1024});
+
+  a.Free(reserved);
+  a.Free(large);
+  AllocatorStats stats;
+  a.GetStats(&stats);
+  EXPECT_EQ(stats.bytes_in_use, 0);
+  EXPECT_EQ(stats.num_cache_hits, 0);
+  EXPECT_EQ(stats.num_cache_misses, 0);
+}
+
 struct NotificationMock : public synchronize::Notification {
  public:
   NotificationMock(Stream& s) : Notification(s) {}
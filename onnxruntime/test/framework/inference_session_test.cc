@@ -45,6 +45,7 @@
 #include "core/session/environment.h"
 #include "core/session/IOBinding.h"
 #include "core/session/inference_session_utils.h"
+#include "core/session/prepared_run.h"
 #include "core/session/onnxruntime_session_options_config_keys.h"
 #include "core/session/onnxruntime_run_options_config_keys.h"
 #include "dummy_provider.h"
@@ -615,6 +616,27 @@ TEST(InferenceSessionTests, CheckRunLogger) {
 #endif
 }
 
+TEST(InferenceSessionTests, NumaNodeBinding) {
+  // emulate two NUMA nodes. both use processor 0 so the thread affinity can be set on any machine.
+  SessionOptions so;
+  so.session_logid = "InferenceSessionTests.NumaNodeBinding";
+  so.intra_op_param.thread_pool_size = 3;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigIntraOpNumaAware, "1"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigNumaTopology, "0;0"));
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigNumaNode, "1"));
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  RunOptions run_options;
+  RunModel(session_object, run_options);
+
+  // binding to a node that is not in the topology is an error
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigNumaNode, "2"));
+  EXPECT_THROW(std::make_unique<InferenceSession>(so, GetEnvironment()), OnnxRuntimeException);
+}
+
 // WebAssembly will emit profiling data into console
 #if !defined(__wasm__)
 TEST(InferenceSessionTests, CheckRunProfilerWithSessionOptions) {
@@ -837,6 +859,111 @@ TEST(InferenceSessionTests, PreAllocateOutputVector) {
   RunModel(session_object, run_options, is_preallocate_output_vec);
 }
 
+TEST(InferenceSessionTests, PreparedRun) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.PreparedRun";
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  std::vector<std::string> feed_names{"X"};
+  std::vector<std::string> output_names{"Y"};
+  std::unique_ptr<PreparedRun> prepared_run;
+  ASSERT_STATUS_OK(session_object.PrepareRun(feed_names, output_names, nullptr, prepared_run));
+  ASSERT_EQ(prepared_run->NumFeeds(), 1u);
+  ASSERT_EQ(prepared_run->NumFetches(), 1u);
+
+  RunOptions run_options;
+  run_options.run_tag = so.session_logid;
+
+  std::vector<int64_t> dims_mul_x = {3, 2};
+  std::vector<int64_t> expected_dims_mul_y = {3, 2};
+  std::vector<float> values_mul_x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  std::vector<float> expected_values_mul_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  // reuse the PreparedRun with different input values, and with pre-allocated outputs
+  for (int i = 0; i < 3; ++i) {
+    OrtValue ml_value;
+    CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                         &ml_value);
+    std::vector<OrtValue> feeds{ml_value};
+
+    std::vector<OrtValue> fetches;
+    if (i == 2) {
+      fetches.resize(1);
+      CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(OrtMemTypeDefault), dims_mul_x, values_mul_x,
+                           &fetches[0]);
+    }
+
+    ASSERT_STATUS_OK(session_object.Run(run_options, *prepared_run, feeds, &fetches));
+    VerifyOutputs(fetches, expected_dims_mul_y, expected_values_mul_y);
+
+    for (auto& value : values_mul_x) {
+      value += 1.0f;
+    }
+
+    for (size_t j = 0; j < values_mul_x.size(); ++j) {
+      expected_values_mul_y[j] = values_mul_x[j] * values_mul_x[j];
+    }
+  }
+}
+
+TEST(InferenceSessionTests, PreparedRunInvalidUsage) {
+  SessionOptions so;
+
+  so.session_logid = "InferenceSessionTests.PreparedRunInvalidUsage";
+
+  InferenceSession session_object{so, GetEnvironment()};
+  ASSERT_STATUS_OK(session_object.Load(MODEL_URI));
+
+  std::vector<std::string> feed_names{"X"};
+  std::vector<std::string> output_names{"Y"};
+  std::unique_ptr<PreparedRun> prepared_run;
+
+  // session must be initialized
+  ASSERT_FALSE(session_object.PrepareRun(feed_names, output_names, nullptr, prepared_run).IsOK());
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  // names are validated up front
+  std::vector<std::string> invalid_feed_names{"Z"};
+  auto status = session_object.PrepareRun(invalid_feed_names, output_names, nullptr, prepared_run);
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr("Invalid Feed Input Name"));
+
+  std::vector<std::string> invalid_output_names{"Z"};
+  status = session_object.PrepareRun(feed_names, invalid_output_names, nullptr, prepared_run);
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr("Invalid Output Name"));
+
+  ASSERT_STATUS_OK(session_object.PrepareRun(feed_names, output_names, nullptr, prepared_run));
+
+  RunOptions run_options;
+  std::vector<OrtValue> fetches;
+
+  // wrong number of feeds
+  std::vector<OrtValue> feeds;
+  ASSERT_FALSE(session_object.Run(run_options, *prepared_run, feeds, &fetches).IsOK());
+
+  // wrong input type is still detected on each run
+  OrtValue ml_value;
+  CreateMLValue<int64_t>(TestCPUExecutionProvider()->GetAllocator(OrtMemTypeDefault), {3, 2}, {1, 2, 3, 4, 5, 6},
+                         &ml_value);
+  feeds.push_back(ml_value);
+  ASSERT_FALSE(session_object.Run(run_options, *prepared_run, feeds, &fetches).IsOK());
+
+  // PreparedRun can only be used with the session that created it
+  InferenceSession other_session{so, GetEnvironment()};
+  ASSERT_STATUS_OK(other_session.Load(MODEL_URI));
+  ASSERT_STATUS_OK(other_session.Initialize());
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(OrtMemTypeDefault), {3, 2},
+                       {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f}, &feeds[0]);
+  status = other_session.Run(run_options, *prepared_run, feeds, &fetches);
+  ASSERT_FALSE(status.IsOK());
+  EXPECT_THAT(status.ErrorMessage(), testing::HasSubstr("different session"));
+}
+
 TEST(InferenceSessionTests, ConfigureVerbosityLevel) {
   SessionOptions so;
 
@@ -0,0 +1,208 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/memory_pattern_cache.h"
+
+#include "core/common/narrow.h"
+#include "core/common/span_utils.h"
+#include "core/framework/tensor.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+std::vector<OrtValue> CreateInputs(const std::vector<std::vector<int64_t>>& input_dims) {
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(OrtMemTypeDefault);
+  std::vector<OrtValue> inputs(input_dims.size());
+  for (size_t i = 0; i < input_dims.size(); ++i) {
+    std::vector<float> values(narrow<size_t>(TensorShape(input_dims[i]).Size()), 1.f);
+    CreateMLValue<float>(allocator, input_dims[i], values, &inputs[i]);
+  }
+  return inputs;
+}
+
+// Y = (X + X) + X with a symbolic batch dimension
+void LoadModel(InferenceSession& session) {
+  onnxruntime::Model model("mem_pattern_cache", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {},
+                           DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& t = graph.GetOrCreateNodeArg("T", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("add0", "Add", "T = X + X", {&x, &x}, {&t});
+  graph.AddNode("add1", "Add", "Y = T + X", {&t, &x}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+}
+
+void RunModel(InferenceSession& session, int64_t batch) {
+  auto feeds = CreateInputs({{batch, 3}});
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session.Run(RunOptions{}, AsSpan({std::string("X")}), feeds,
+                               AsSpan({std::string("Y")}), &fetches, nullptr));
+  ASSERT_EQ(fetches[0].Get<Tensor>().Shape(), TensorShape({batch, 3}));
+  for (float value : fetches[0].Get<Tensor>().DataAsSpan<float>()) {
+    ASSERT_EQ(value, 3.f);
+  }
+}
+
+}  // namespace
+
+TEST(MemoryPatternCacheTest, ParseDimBuckets) {
+  std::vector<int64_t> buckets;
+  ASSERT_STATUS_OK(MemoryPatternCache::ParseDimBuckets("16,32,64", buckets));
+  EXPECT_EQ(buckets, (std::vector<int64_t>{16, 32, 64}));
+
+  ASSERT_STATUS_OK(MemoryPatternCache::ParseDimBuckets("", buckets));
+  EXPECT_TRUE(buckets.empty());
+
+  EXPECT_FALSE(MemoryPatternCache::ParseDimBuckets("32,16", buckets).IsOK());
+  EXPECT_FALSE(MemoryPatternCache::ParseDimBuckets("16,16", buckets).IsOK());
+  EXPECT_FALSE(MemoryPatternCache::ParseDimBuckets("0", buckets).IsOK());
+  EXPECT_FALSE(MemoryPatternCache::ParseDimBuckets("16,,32", buckets).IsOK());
+  EXPECT_FALSE(MemoryPatternCache::ParseDimBuckets("a", buckets).IsOK());
+}
+
+TEST(MemoryPatternCacheTest, ExactShapes) {
+  MemoryPatternCache cache;
+
+  // the XOR of the dims is the same for both inputs, which must not make them share an entry
+  auto inputs_a = CreateInputs({{2, 3}, {4}});
+  auto inputs_b = CreateInputs({{3, 2}, {4}});
+  auto inputs_c = CreateInputs({{2}, {3, 4}});
+
+  EXPECT_EQ(cache.Find(inputs_a), nullptr);
+  auto entry_a = cache.Insert(inputs_a, MemoryPatternGroup{});
+  auto entry_b = cache.Insert(inputs_b, MemoryPatternGroup{});
+  auto entry_c = cache.Insert(inputs_c, MemoryPatternGroup{});
+  EXPECT_NE(entry_a, entry_b);
+  EXPECT_NE(entry_a, entry_c);
+
+  EXPECT_EQ(cache.Find(inputs_a), entry_a);
+  EXPECT_EQ(cache.Find(inputs_b), entry_b);
+  EXPECT_TRUE(MemoryPatternCache::HasExactShapes(*entry_a, inputs_a));
+  EXPECT_FALSE(MemoryPatternCache::HasExactShapes(*entry_a, inputs_b));
+
+  // an existing entry is not replaced
+  EXPECT_EQ(cache.Insert(inputs_a, MemoryPatternGroup{}), entry_a);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.hits, uint64_t{2});
+  EXPECT_EQ(stats.misses, uint64_t{1});
+  EXPECT_EQ(stats.evictions, uint64_t{0});
+  EXPECT_EQ(stats.num_entries, size_t{3});
+}
+
+TEST(MemoryPatternCacheTest, LruEviction) {
+  MemoryPatternCache cache(2);
+
+  auto inputs_1 = CreateInputs({{1, 3}});
+  auto inputs_2 = CreateInputs({{2, 3}});
+  auto inputs_3 = CreateInputs({{3, 3}});
+
+  auto entry_1 = cache.Insert(inputs_1, MemoryPatternGroup{});
+  cache.Insert(inputs_2, MemoryPatternGroup{});
+
+  // make inputs_2 the least recently used entry
+  EXPECT_EQ(cache.Find(inputs_1), entry_1);
+  cache.Insert(inputs_3, MemoryPatternGroup{});
+
+  EXPECT_EQ(cache.Find(inputs_2), nullptr);
+  EXPECT_EQ(cache.Find(inputs_1), entry_1);
+  EXPECT_NE(cache.Find(inputs_3), nullptr);
+
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.evictions, uint64_t{1});
+  EXPECT_EQ(stats.num_entries, size_t{2});
+
+  // an evicted entry remains valid while it's held
+  cache.Insert(inputs_2, MemoryPatternGroup{});
+  EXPECT_EQ(cache.Find(inputs_1), nullptr);
+  EXPECT_TRUE(MemoryPatternCache::HasExactShapes(*entry_1, inputs_1));
+}
+
+TEST(MemoryPatternCacheTest, DimBuckets) {
+  MemoryPatternCache cache(0, {4, 16});
+
+  auto inputs_1 = CreateInputs({{1, 3}});
+  auto inputs_2 = CreateInputs({{2, 3}});
+  auto inputs_3 = CreateInputs({{3, 4}});
+  auto inputs_large = CreateInputs({{17, 3}});
+
+  auto entry_2 = cache.Insert(inputs_2, MemoryPatternGroup{});
+
+  // a smaller shape in the same bucket can use the entry
+  EXPECT_EQ(cache.Find(inputs_1), entry_2);
+  EXPECT_FALSE(MemoryPatternCache::HasExactShapes(*entry_2, inputs_1));
+
+  // a smaller entry is not used for a larger shape in the same bucket, and is replaced by the larger one
+  EXPECT_EQ(cache.Find(inputs_3), nullptr);
+  auto entry_3 = cache.Insert(inputs_3, MemoryPatternGroup{});
+  EXPECT_NE(entry_3, entry_2);
+  EXPECT_EQ(cache.Find(inputs_2), entry_3);
+
+  // the larger entry is kept when the smaller shape is inserted
+  EXPECT_EQ(cache.Insert(inputs_1, MemoryPatternGroup{}), entry_3);
+
+  // dims larger than the last bucket are used as-is
+  EXPECT_EQ(cache.Find(inputs_large), nullptr);
+  cache.Insert(inputs_large, MemoryPatternGroup{});
+  EXPECT_EQ(cache.GetStats().num_entries, size_t{2});
+}
+
+TEST(MemoryPatternCacheTest, SessionCacheSize) {
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigMemoryPatternCacheSize, "2"));
+  InferenceSession session{so, GetEnvironment()};
+  LoadModel(session);
+
+  for (int64_t batch : {1, 2, 1, 3, 2}) {
+    RunModel(session, batch);
+  }
+
+  auto stats = session.GetSessionState().GetMemoryPatternCacheStats();
+  EXPECT_EQ(stats.hits, uint64_t{1});
+  EXPECT_EQ(stats.misses, uint64_t{4});
+  EXPECT_EQ(stats.evictions, uint64_t{2});
+  EXPECT_EQ(stats.num_entries, size_t{2});
+}
+
+TEST(MemoryPatternCacheTest, SessionDimBuckets) {
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigMemoryPatternDimBuckets, "4,8"));
+  InferenceSession session{so, GetEnvironment()};
+  LoadModel(session);
+
+  // the first run of 4 replaces the pattern generated for 2, which then covers all runs in the bucket
+  for (int64_t batch : {2, 4, 1, 3, 4, 6}) {
+    RunModel(session, batch);
+  }
+
+  auto stats = session.GetSessionState().GetMemoryPatternCacheStats();
+  EXPECT_EQ(stats.hits, uint64_t{3});
+  EXPECT_EQ(stats.misses, uint64_t{3});
+  EXPECT_EQ(stats.num_entries, size_t{2});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -468,6 +468,86 @@ TEST(OrtModelOnlyTests, UpdateOrtModelVersionWithSavedRuntimeOptimizations) {
                      });
 }
 
+static void LoadAndRunMatMulModelWithPrePackedWeights(const std::basic_string<ORTCHAR_T>& ort_file,
+                                                      const std::vector<std::pair<std::string, std::string>>& configs,
+                                                      bool use_buffer_for_initializers,
+                                                      size_t expected_prepacks, size_t expected_restored_prepacks) {
+  SessionOptions so;
+  so.session_logid = "SaveAndLoadPrePackedWeights";
+  for (const auto& config : configs) {
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(config.first.c_str(), config.second.c_str()));
+  }
+
+  if (use_buffer_for_initializers) {
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseORTModelBytesDirectly, "1"));
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigUseORTModelBytesForInitializers, "1"));
+  }
+
+  // the buffer must outlive the session if it is used directly
+  std::vector<char> model_data;
+  InferenceSessionWrapper session_object{so, GetEnvironment()};
+  if (use_buffer_for_initializers) {
+    size_t num_bytes = 0;
+    ASSERT_STATUS_OK(Env::Default().GetFileLength(ort_file.c_str(), num_bytes));
+    model_data.resize(num_bytes);
+    std::ifstream bytes_stream(ort_file, std::ifstream::in | std::ifstream::binary);
+    bytes_stream.read(model_data.data(), num_bytes);
+    bytes_stream.close();
+    ASSERT_STATUS_OK(session_object.Load(model_data.data(), static_cast<int>(num_bytes)));
+  } else {
+    ASSERT_STATUS_OK(session_object.Load(ort_file));
+  }
+
+  ASSERT_STATUS_OK(session_object.Initialize());
+
+  const auto& session_state = session_object.GetSessionState();
+  EXPECT_EQ(session_state.GetNumberOfPrepacksCounter(), expected_prepacks);
+  EXPECT_EQ(session_state.GetNumberOfRestoredPrepacksCounter(), expected_restored_prepacks);
+
+  OrtValue ml_value;
+  CreateMLValue<float>(TestCPUExecutionProvider()->GetAllocator(OrtMemTypeDefault), {3, 2},
+                       {1.f, 2.f, 3.f, 4.f, 5.f, 6.f}, &ml_value);
+  NameMLValMap feeds{{"X", ml_value}};
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session_object.Run(feeds, {"Y"}, &fetches));
+
+  const auto& output = fetches[0].Get<Tensor>();
+  ASSERT_EQ(output.Shape(), TensorShape({3, 1}));
+  EXPECT_THAT(output.DataAsSpan<float>(), ::testing::ElementsAre(5.f, 11.f, 17.f));
+}
+
+// test that the pre-packed weights can be saved in an ORT format model and are used instead of calling PrePack
+// when the model is loaded
+TEST(OrtModelOnlyTests, SaveAndLoadPrePackedWeights) {
+  const auto ort_file = std::basic_string<ORTCHAR_T>(ORT_TSTR("testdata/matmul_1.prepacked_weights.test_output.ort"));
+
+  {
+    SessionOptions so;
+    so.session_logid = "SaveAndLoadPrePackedWeights";
+    so.optimized_model_filepath = ort_file;
+    ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigSavePrePackedWeights, "1"));
+
+    InferenceSessionWrapper session_object{so, GetEnvironment()};
+    ASSERT_STATUS_OK(session_object.Load(ORT_TSTR("testdata/matmul_1.onnx")));
+    ASSERT_STATUS_OK(session_object.Initialize());
+    ASSERT_EQ(session_object.GetSessionState().GetNumberOfPrepacksCounter(), static_cast<size_t>(1));
+  }
+
+  // stored pre-packed weights are copied
+  LoadAndRunMatMulModelWithPrePackedWeights(ort_file, {}, /*use_buffer_for_initializers*/ false, 0, 1);
+
+  // stored pre-packed weights are used directly from the buffer if suitably aligned, otherwise copied
+  LoadAndRunMatMulModelWithPrePackedWeights(ort_file, {}, /*use_buffer_for_initializers*/ true, 0, 1);
+
+  // the platform fingerprint includes this setting so the stored pre-packed weights should be ignored
+  LoadAndRunMatMulModelWithPrePackedWeights(ort_file, {{kOrtSessionOptionsAvx2PrecisionMode, "1"}},
+                                            /*use_buffer_for_initializers*/ false, 1, 0);
+
+  // pre-packing disabled
+  LoadAndRunMatMulModelWithPrePackedWeights(ort_file, {{kOrtSessionOptionsConfigDisablePrepacking, "1"}},
+                                            /*use_buffer_for_initializers*/ false, 0, 0);
+}
+
 #if !defined(DISABLE_ML_OPS)
 TEST(OrtModelOnlyTests, SerializeToOrtFormatMLOps) {
   const auto ort_file = ORT_TSTR("testdata/sklearn_bin_voting_classifier_soft.onnx.test_output.ort");
@@ -1,12 +1,19 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 // Licensed under the MIT License.
 
+#include "core/common/span_utils.h"
+#include "core/framework/critical_path_scheduler.h"
 #include "core/framework/data_types.h"
 #include "core/framework/op_kernel.h"
+#include "core/graph/model.h"
 #include "test/providers/provider_test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
 #include "test_utils.h"
 #include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
 
+#include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
 using namespace ONNX_NAMESPACE;
@@ -145,5 +152,111 @@ TEST_P(ParallelExecutorThreadPoolTest, TestNullInterOpThreadPool) {
 
 INSTANTIATE_TEST_SUITE_P(ParallelExecutorThreadPoolTests, ParallelExecutorThreadPoolTest,
                          testing::Values(1, 0));
+
+// Y = Relu(Relu(Relu(Relu(X)))) + Relu(X)
+static void LoadTwoBranchModel(InferenceSession& session) {
+  onnxruntime::Model model("two_branches", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 12}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(4);
+
+  auto* long_branch = &graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto* x = long_branch;
+  for (int i = 0; i < 4; ++i) {
+    auto& out = graph.GetOrCreateNodeArg("long_" + std::to_string(i), &float_tensor);
+    graph.AddNode("long_relu_" + std::to_string(i), "Relu", "", {long_branch}, {&out});
+    long_branch = &out;
+  }
+  auto& short_branch = graph.GetOrCreateNodeArg("short", &float_tensor);
+  graph.AddNode("short_relu", "Relu", "", {x}, {&short_branch});
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("add", "Add", "", {long_branch, &short_branch}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+}
+
+TEST(CriticalPathScheduler, PrioritizesLongestPath) {
+  SessionOptions so;
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  so.inter_op_param.thread_pool_size = 4;
+  InferenceSession session{so, GetEnvironment()};
+  LoadTwoBranchModel(session);
+
+  const auto& session_state = session.GetSessionState();
+  const auto* scheduler = session_state.GetCriticalPathScheduler();
+  ASSERT_NE(scheduler, nullptr);
+
+  auto node_priority = [&](const std::string& name) {
+    auto priorities = scheduler->GetPriorities();
+    const auto nodes = scheduler->GetNodes();
+    for (size_t pos = 0; pos < nodes.size(); ++pos) {
+      if (session_state.GetGraphViewer().GetNode(nodes[pos])->Name() == name) {
+        return (*priorities)[pos];
+      }
+    }
+    return -1.;
+  };
+
+  // all the nodes have the same estimated cost, so the priority is the length of the path to the output
+  EXPECT_DOUBLE_EQ(node_priority("long_relu_0"), 5 * node_priority("add"));
+  EXPECT_DOUBLE_EQ(node_priority("short_relu"), 2 * node_priority("add"));
+
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(OrtMemTypeDefault);
+  std::vector<OrtValue> feeds(1);
+  CreateMLValue<float>(allocator, {4}, {-1.f, 0.f, 1.f, 2.f}, &feeds[0]);
+  for (int run = 0; run < 20; ++run) {
+    std::vector<OrtValue> fetches;
+    ASSERT_STATUS_OK(session.Run(RunOptions{}, AsSpan({std::string("X")}), feeds, AsSpan({std::string("Y")}),
+                                 &fetches, nullptr));
+    EXPECT_THAT(fetches[0].Get<Tensor>().DataAsSpan<float>(),
+                ::testing::ElementsAre(0.f, 0.f, 2.f, 4.f));
+  }
+
+  // the priorities are updated from the measured kernel times, which are positive
+  EXPECT_GT(node_priority("long_relu_0"), node_priority("long_relu_1"));
+  EXPECT_GT(node_priority("add"), 0.);
+}
+
+TEST(CriticalPathScheduler, Disabled) {
+  SessionOptions so;
+  so.execution_mode = ExecutionMode::ORT_PARALLEL;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigDisableCriticalPathScheduler, "1"));
+  InferenceSession session{so, GetEnvironment()};
+  LoadTwoBranchModel(session);
+  EXPECT_EQ(session.GetSessionState().GetCriticalPathScheduler(), nullptr);
+}
+
+TEST(CriticalPathScheduler, EstimateNodeCost) {
+  onnxruntime::Model model("cost", false, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  auto make_arg = [&](const std::string& name, std::initializer_list<int64_t> dims) -> NodeArg& {
+    TypeProto type;
+    type.mutable_tensor_type()->set_elem_type(TensorProto_DataType_FLOAT);
+    for (int64_t dim : dims) {
+      type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(dim);
+    }
+    return graph.GetOrCreateNodeArg(name, &type);
+  };
+
+  auto& matmul = graph.AddNode("matmul", "MatMul", "",
+                               {&make_arg("A", {2, 3}), &make_arg("B", {3, 4})}, {&make_arg("C", {2, 4})});
+  EXPECT_DOUBLE_EQ(CriticalPathScheduler::EstimateNodeCost(matmul), 2. * 2 * 4 * 3);
+
+  auto& conv = graph.AddNode("conv", "Conv", "",
+                             {&make_arg("X", {1, 3, 8, 8}), &make_arg("W", {16, 3, 3, 3})},
+                             {&make_arg("Y", {1, 16, 6, 6})});
+  EXPECT_DOUBLE_EQ(CriticalPathScheduler::EstimateNodeCost(conv), 2. * (16 * 6 * 6) * (3 * 3 * 3));
+
+  auto& relu = graph.AddNode("relu", "Relu", "", {&make_arg("R", {5, 7})}, {&make_arg("S", {5, 7})});
+  EXPECT_DOUBLE_EQ(CriticalPathScheduler::EstimateNodeCost(relu), 35.);
+}
 }  // namespace test
 }  // namespace onnxruntime
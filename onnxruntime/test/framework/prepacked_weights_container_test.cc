@@ -0,0 +1,93 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <cstring>
+#include <numeric>
+
+#include "core/framework/prepacked_weights_container.h"
+#include "core/platform/env.h"
+#include "core/platform/path_lib.h"
+#include "test/util/include/temp_dir.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+static PrePackedWeights CreatePrePackedWeights(AllocatorPtr alloc, const std::vector<size_t>& buffer_sizes,
+                                               uint8_t seed) {
+  PrePackedWeights weights;
+  for (size_t size : buffer_sizes) {
+    auto* data = static_cast<uint8_t*>(alloc->Alloc(size));
+    std::iota(data, data + size, seed);
+    weights.buffers_.emplace_back(data, BufferDeleter(alloc));
+    weights.buffer_sizes_.push_back(size);
+  }
+
+  return weights;
+}
+
+// two containers using the same directory stand in for two processes
+TEST(PrepackedWeightsContainerTest, SharedAcrossProcesses) {
+  TemporaryDirectory tmp_dir{ORT_TSTR("prepacked_weights_container_test_shared")};
+
+  PrepackedWeightsContainer container_1{tmp_dir.Path()};
+  PrepackedWeightsContainer container_2{tmp_dir.Path()};
+
+  const std::string key = "MatMul+1234";
+  const std::vector<size_t> buffer_sizes{100, 1000};
+
+  auto alloc_1 = container_1.GetOrCreateAllocator(CPU);
+  ASSERT_TRUE(container_1.WriteWeight(key, CreatePrePackedWeights(alloc_1, buffer_sizes, 1)));
+  ASSERT_EQ(container_1.GetNumberOfSharedFileElements(), size_t{1});
+
+  size_t file_length = 0;
+  ASSERT_TRUE(Env::Default().GetFileLength(
+                                 ConcatPathComponent<ORTCHAR_T>(tmp_dir.Path(), ORT_TSTR("MatMul+1234.ortpw")).c_str(),
+                                 file_length)
+                  .IsOK());
+
+  auto alloc_2 = container_2.GetOrCreateAllocator(CPU);
+  ASSERT_TRUE(container_2.WriteWeight(key, CreatePrePackedWeights(alloc_2, buffer_sizes, 1)));
+  ASSERT_EQ(container_2.GetNumberOfSharedFileElements(), size_t{1});
+
+  const auto& weight_1 = container_1.GetWeight(key);
+  const auto& weight_2 = container_2.GetWeight(key);
+  ASSERT_EQ(weight_1.buffers_.size(), buffer_sizes.size());
+  ASSERT_EQ(weight_2.buffers_.size(), buffer_sizes.size());
+  for (size_t i = 0; i < buffer_sizes.size(); ++i) {
+    ASSERT_EQ(weight_2.buffer_sizes_[i], buffer_sizes[i]);
+    // buffers refer to the mapped file so are suitably aligned for the kernels
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(weight_2.buffers_[i].get()) % 64, uintptr_t{0});
+    EXPECT_EQ(std::memcmp(weight_1.buffers_[i].get(), weight_2.buffers_[i].get(), buffer_sizes[i]), 0);
+  }
+
+  // a weight that is already in the container is not written again
+  ASSERT_FALSE(container_2.WriteWeight(key, CreatePrePackedWeights(alloc_2, buffer_sizes, 1)));
+}
+
+// the content of an existing file is verified before it is used
+TEST(PrepackedWeightsContainerTest, SharedFileContentMismatch) {
+  TemporaryDirectory tmp_dir{ORT_TSTR("prepacked_weights_container_test_mismatch")};
+
+  PrepackedWeightsContainer container_1{tmp_dir.Path()};
+  PrepackedWeightsContainer container_2{tmp_dir.Path()};
+
+  const std::string key = "Gemm+5678";
+  const std::vector<size_t> buffer_sizes{256};
+
+  auto alloc_1 = container_1.GetOrCreateAllocator(CPU);
+  ASSERT_TRUE(container_1.WriteWeight(key, CreatePrePackedWeights(alloc_1, buffer_sizes, 1)));
+
+  // same key with different content falls back to a weight that is only shared within the process
+  auto alloc_2 = container_2.GetOrCreateAllocator(CPU);
+  ASSERT_TRUE(container_2.WriteWeight(key, CreatePrePackedWeights(alloc_2, buffer_sizes, 2)));
+  ASSERT_EQ(container_2.GetNumberOfSharedFileElements(), size_t{0});
+  ASSERT_EQ(container_2.GetNumberOfElements(), size_t{1});
+
+  const auto& weight_2 = container_2.GetWeight(key);
+  EXPECT_EQ(static_cast<const uint8_t*>(weight_2.buffers_[0].get())[0], uint8_t{2});
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,136 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/framework/static_memory_planner.h"
+
+#include "core/common/narrow.h"
+#include "core/common/span_utils.h"
+#include "core/framework/tensor.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// Y = (((X + X) * X) + X) - X with X of shape {batch, 3}
+void LoadModel(InferenceSession& session) {
+  onnxruntime::Model model("static_memory_plan", false, ModelMetaData(), PathString(),
+                           IOnnxRuntimeOpSchemaRegistryList(), {{kOnnxDomain, 12}}, {},
+                           DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& a = graph.GetOrCreateNodeArg("A", &float_tensor);
+  auto& b = graph.GetOrCreateNodeArg("B", &float_tensor);
+  auto& c = graph.GetOrCreateNodeArg("C", &float_tensor);
+  auto& y = graph.GetOrCreateNodeArg("Y", &float_tensor);
+  graph.AddNode("add0", "Add", "A = X + X", {&x, &x}, {&a});
+  graph.AddNode("mul", "Mul", "B = A * X", {&a, &x}, {&b});
+  graph.AddNode("add1", "Add", "C = B + X", {&b, &x}, {&c});
+  graph.AddNode("sub", "Sub", "Y = C - X", {&c, &x}, {&y});
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+}
+
+void RunModel(InferenceSession& session, int64_t batch) {
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(OrtMemTypeDefault);
+  std::vector<float> values(narrow<size_t>(batch * 3), 1.f);
+  std::vector<OrtValue> feeds(1);
+  CreateMLValue<float>(allocator, {batch, 3}, values, &feeds[0]);
+
+  std::vector<OrtValue> fetches;
+  ASSERT_STATUS_OK(session.Run(RunOptions{}, AsSpan({std::string("X")}), feeds,
+                               AsSpan({std::string("Y")}), &fetches, nullptr));
+  ASSERT_EQ(fetches[0].Get<Tensor>().Shape(), TensorShape({batch, 3}));
+  for (float value : fetches[0].Get<Tensor>().DataAsSpan<float>()) {
+    ASSERT_EQ(value, 2.f);
+  }
+}
+
+}  // namespace
+
+TEST(StaticMemoryPlannerTest, ParseDimBounds) {
+  StaticMemoryPlanner::DimBounds dim_bounds;
+  ASSERT_STATUS_OK(StaticMemoryPlanner::ParseDimBounds("batch:8,sequence:512", dim_bounds));
+  ASSERT_EQ(dim_bounds.size(), size_t{2});
+  EXPECT_EQ(dim_bounds["batch"], 8);
+  EXPECT_EQ(dim_bounds["sequence"], 512);
+
+  ASSERT_STATUS_OK(StaticMemoryPlanner::ParseDimBounds("", dim_bounds));
+  EXPECT_TRUE(dim_bounds.empty());
+
+  EXPECT_FALSE(StaticMemoryPlanner::ParseDimBounds("batch", dim_bounds).IsOK());
+  EXPECT_FALSE(StaticMemoryPlanner::ParseDimBounds(":8", dim_bounds).IsOK());
+  EXPECT_FALSE(StaticMemoryPlanner::ParseDimBounds("batch:0", dim_bounds).IsOK());
+  EXPECT_FALSE(StaticMemoryPlanner::ParseDimBounds("batch:x", dim_bounds).IsOK());
+  EXPECT_FALSE(StaticMemoryPlanner::ParseDimBounds("batch:8,batch:16", dim_bounds).IsOK());
+  EXPECT_FALSE(StaticMemoryPlanner::ParseDimBounds("batch:8,,sequence:512", dim_bounds).IsOK());
+}
+
+TEST(StaticMemoryPlannerTest, PlannedAtInitialization) {
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigStaticMemoryPlanDimBounds, "batch:4"));
+  InferenceSession session{so, GetEnvironment()};
+  LoadModel(session);
+
+  const auto* stats = session.GetSessionState().GetStaticMemoryPlanStats();
+  ASSERT_NE(stats, nullptr);
+  EXPECT_GT(stats->num_planned_values, size_t{0});
+  EXPECT_EQ(stats->num_dynamic_values, size_t{0});
+  EXPECT_GT(stats->peak_size, size_t{0});
+  EXPECT_LE(stats->peak_size, stats->total_size);
+
+  // the planned pattern is used for every shape within the bounds, and the values of larger shapes are allocated
+  // individually
+  for (int64_t batch : {1, 4, 3, 6}) {
+    RunModel(session, batch);
+  }
+
+  auto cache_stats = session.GetSessionState().GetMemoryPatternCacheStats();
+  EXPECT_EQ(cache_stats.hits, uint64_t{0});
+  EXPECT_EQ(cache_stats.misses, uint64_t{0});
+  EXPECT_EQ(cache_stats.num_entries, size_t{0});
+}
+
+TEST(StaticMemoryPlannerTest, UnboundedDims) {
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigStaticMemoryPlanDimBounds, "sequence:4"));
+  InferenceSession session{so, GetEnvironment()};
+  LoadModel(session);
+
+  // nothing can be planned, so the memory pattern is traced at runtime
+  EXPECT_EQ(session.GetSessionState().GetStaticMemoryPlanStats(), nullptr);
+  RunModel(session, 2);
+  EXPECT_EQ(session.GetSessionState().GetMemoryPatternCacheStats().num_entries, size_t{1});
+}
+
+TEST(StaticMemoryPlannerTest, DisabledWithoutMemoryPattern) {
+  SessionOptions so;
+  so.enable_mem_pattern = false;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigStaticMemoryPlanDimBounds, "batch:4"));
+  InferenceSession session{so, GetEnvironment()};
+  LoadModel(session);
+
+  EXPECT_EQ(session.GetSessionState().GetStaticMemoryPlanStats(), nullptr);
+  RunModel(session, 2);
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <cstring>
+#include <stdexcept>
+
+static const std::vector<std::string> bf16gemm_bench_arg_names = {"M", "N", "K"};
+
+static std::vector<uint16_t> RandomVectorUniformBf16(size_t N, float min_value, float max_value) {
+  auto values = RandomVectorUniform(N, min_value, max_value);
+  std::vector<uint16_t> result(N);
+  for (size_t i = 0; i < N; i++) {
+    uint32_t bits;
+    std::memcpy(&bits, &values[i], sizeof(bits));
+    result[i] = static_cast<uint16_t>(bits >> 16);
+  }
+  return result;
+}
+
+void BF16GEMM(benchmark::State& state, bool pack_b) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+
+  auto A = RandomVectorUniformBf16(static_cast<size_t>(M * K), -1.0f, 1.0f);
+  auto B = RandomVectorUniformBf16(static_cast<size_t>(N * K), -1.0f, 1.0f);
+  std::vector<float> C(static_cast<size_t>(M * N));
+
+  std::vector<uint8_t> B_packed;
+  if (pack_b) {
+    B_packed.resize(MlasBf16GemmPackBSize(N, K));
+    MlasBf16GemmPackB(CblasNoTrans, N, K, reinterpret_cast<const MLAS_BF16*>(B.data()), N, B_packed.data());
+  }
+
+  MLAS_BF16_GEMM_DATA_PARAMS params;
+  params.A = reinterpret_cast<const MLAS_BF16*>(A.data());
+  params.lda = K;
+  params.B = pack_b ? static_cast<const void*>(B_packed.data()) : static_cast<const void*>(B.data());
+  params.ldb = pack_b ? 0 : N;
+  params.C = C.data();
+  params.ldc = N;
+
+  MlasBf16GemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, &params, 1, nullptr);
+
+  for (auto _ : state) {
+    MlasBf16GemmBatch(CblasNoTrans, CblasNoTrans, M, N, K, &params, 1, nullptr);
+  }
+}
+
+static void Bf16GemmSizeWithOne(benchmark::internal::Benchmark* b) {
+  b->ArgNames(bf16gemm_bench_arg_names);
+  ArgsProduct(b, {{1}, {63, 255, 1023}, {63, 255, 1023}});
+}
+
+static void Bf16GemmSizeProducts(benchmark::internal::Benchmark* b) {
+  b->ArgNames(bf16gemm_bench_arg_names);
+  ArgsProduct(b, {{63, 255, 1023}, {63, 255, 1023}, {63, 255, 1023}});
+}
+
+BENCHMARK_CAPTURE(BF16GEMM, NORMAL, false)->Apply(Bf16GemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(BF16GEMM, GEMV, false)->Apply(Bf16GemmSizeWithOne)->UseRealTime();
+
+BENCHMARK_CAPTURE(BF16GEMM, PACKB, true)->Apply(Bf16GemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(BF16GEMM, PACKB_GEMV, true)->Apply(Bf16GemmSizeWithOne)->UseRealTime();
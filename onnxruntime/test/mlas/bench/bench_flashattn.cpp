@@ -0,0 +1,63 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/util/thread_utils.h"
+
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+static const std::vector<std::string> flashattn_bench_arg_names = {"B", "N", "S", "H", "Causal", "Threads"};
+
+void FLASHATTN(benchmark::State& state) {
+  if (state.range(0) <= 0) throw std::invalid_argument("B must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("S must greater than 0!");
+  if (state.range(3) <= 0) throw std::invalid_argument("H must greater than 0!");
+  const size_t B = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t S = static_cast<size_t>(state.range(2));
+  const size_t H = static_cast<size_t>(state.range(3));
+
+  auto Query = RandomVectorUniform(static_cast<size_t>(B * N * S * H), -1.0f, 1.0f);
+  auto Key = RandomVectorUniform(static_cast<size_t>(B * N * S * H), -1.0f, 1.0f);
+  auto Value = RandomVectorUniform(static_cast<size_t>(B * N * S * H), -1.0f, 1.0f);
+  std::vector<float> Output(static_cast<size_t>(B * S * N * H));
+
+  MLAS_FLASH_ATTENTION_PARAMS params;
+  params.BatchSize = B;
+  params.NumHeads = N;
+  params.SequenceLength = S;
+  params.KvSequenceLength = S;
+  params.QkHeadSize = H;
+  params.VHeadSize = H;
+  params.Scale = 1.0f / std::sqrt(static_cast<float>(H));
+  params.Query = Query.data();
+  params.Key = Key.data();
+  params.Value = Value.data();
+  params.Causal = state.range(4) != 0;
+  params.CausalMaskValue = -10000.0f;
+  params.Output = Output.data();
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = static_cast<int>(state.range(5));
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  MlasFlashAttention(&params, tp.get());
+
+  for (auto _ : state) {
+    MlasFlashAttention(&params, tp.get());
+  }
+}
+
+static void FlashAttnSize(benchmark::internal::Benchmark* b) {
+  b->ArgNames(flashattn_bench_arg_names);
+  ArgsProduct(b, {{1}, {12}, {512, 1024, 2048, 4096}, {64}, {0, 1}, {1, 8}});
+}
+
+BENCHMARK(FLASHATTN)->Apply(FlashAttnSize)->UseRealTime();
@@ -0,0 +1,84 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/framework/float16.h"
+
+#include <stdexcept>
+#include <numeric>
+
+static const std::vector<std::string> halfgemm_bench_arg_names = {"M", "N", "K"};
+
+static std::vector<MLAS_FP16> RandomVectorUniformFp16(size_t N, float min_value, float max_value) {
+  auto values = RandomVectorUniform(N, min_value, max_value);
+  std::vector<MLAS_FP16> result;
+  result.reserve(N);
+  for (float value : values) {
+    result.push_back(MLAS_FP16(value));
+  }
+  return result;
+}
+
+void HALFGEMM(benchmark::State& state, bool pack_b, bool a_is_fp32) {
+  if (!MlasFp16AccelerationSupported()) {
+    state.SkipWithError("Half precision GEMM is not supported on this platform!");
+    return;
+  }
+
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+
+  auto A_fp32 = RandomVectorUniform(static_cast<size_t>(M * K), -1.0f, 1.0f);
+  auto A_fp16 = RandomVectorUniformFp16(static_cast<size_t>(M * K), -1.0f, 1.0f);
+  auto B = RandomVectorUniformFp16(static_cast<size_t>(N * K), -1.0f, 1.0f);
+  std::vector<MLAS_FP16> C(static_cast<size_t>(M * N));
+
+  std::vector<uint8_t> B_packed;
+  if (pack_b) {
+    size_t pack_b_size = MlasHalfGemmPackBSize(N, K, false);
+    if (pack_b_size == 0) {
+      state.SkipWithError("Half precision GEMM does not pack B on this platform!");
+      return;
+    }
+    B_packed.resize(pack_b_size);
+    MlasHalfGemmPackB(N, K, B.data(), N, B_packed.data());
+  }
+
+  MLAS_HALF_GEMM_DATA_PARAMS params;
+  params.A = a_is_fp32 ? static_cast<const void*>(A_fp32.data()) : static_cast<const void*>(A_fp16.data());
+  params.lda = K;
+  params.AIsfp32 = a_is_fp32;
+  params.B = pack_b ? static_cast<const void*>(B_packed.data()) : static_cast<const void*>(B.data());
+  params.ldb = pack_b ? 0 : N;
+  params.C = C.data();
+  params.ldc = N;
+
+  MlasHalfGemmBatch(M, N, K, 1, &params, nullptr);
+
+  for (auto _ : state) {
+    MlasHalfGemmBatch(M, N, K, 1, &params, nullptr);
+  }
+}
+
+static void HalfGemmSizeWithOne(benchmark::internal::Benchmark* b) {
+  b->ArgNames(halfgemm_bench_arg_names);
+  ArgsProduct(b, {{1}, {63, 255, 1023}, {63, 255, 1023}});
+}
+
+static void HalfGemmSizeProducts(benchmark::internal::Benchmark* b) {
+  b->ArgNames(halfgemm_bench_arg_names);
+  ArgsProduct(b, {{63, 255, 1023}, {63, 255, 1023}, {63, 255, 1023}});
+}
+
+BENCHMARK_CAPTURE(HALFGEMM, NORMAL, false, false)->Apply(HalfGemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(HALFGEMM, NORMAL_AFp32, false, true)->Apply(HalfGemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(HALFGEMM, GEMV, false, false)->Apply(HalfGemmSizeWithOne)->UseRealTime();
+
+BENCHMARK_CAPTURE(HALFGEMM, PACKB, true, false)->Apply(HalfGemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(HALFGEMM, PACKB_AFp32, true, true)->Apply(HalfGemmSizeProducts)->UseRealTime();
+BENCHMARK_CAPTURE(HALFGEMM, PACKB_GEMV, true, false)->Apply(HalfGemmSizeWithOne)->UseRealTime();
@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+#include "core/util/thread_utils.h"
+
+#include <memory>
+#include <stdexcept>
+
+static const std::vector<std::string> layernorm_bench_arg_names = {"N", "D", "Skip", "Threads"};
+
+void LAYERNORM(benchmark::State& state) {
+  if (state.range(0) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("D must greater than 0!");
+  const size_t N = static_cast<size_t>(state.range(0));
+  const size_t D = static_cast<size_t>(state.range(1));
+  const bool skip = state.range(2) != 0;
+
+  auto Input = RandomVectorUniform(N * D, -1.0f, 1.0f);
+  auto Skip = RandomVectorUniform(N * D, -1.0f, 1.0f);
+  auto Bias = RandomVectorUniform(D, -1.0f, 1.0f);
+  auto Scale = RandomVectorUniform(D, 0.5f, 1.5f);
+  auto Shift = RandomVectorUniform(D, -1.0f, 1.0f);
+  std::vector<float> Output(N * D);
+
+  MLAS_LAYER_NORM_PARAMS<float> params;
+  params.RowCount = N;
+  params.RowSize = D;
+  params.Epsilon = 1e-5f;
+  params.Input = Input.data();
+  params.Skip = skip ? Skip.data() : nullptr;
+  params.Bias = skip ? Bias.data() : nullptr;
+  params.Scale = Scale.data();
+  params.Shift = Shift.data();
+  params.Output = Output.data();
+
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = static_cast<int>(state.range(3));
+  tpo.auto_set_affinity = true;
+  std::unique_ptr<onnxruntime::concurrency::ThreadPool> tp(
+      onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(),
+                                                 tpo, onnxruntime::concurrency::ThreadPoolType::INTRA_OP));
+
+  MlasLayerNorm(&params, tp.get());
+
+  for (auto _ : state) {
+    MlasLayerNorm(&params, tp.get());
+  }
+}
+
+static void LayerNormSize(benchmark::internal::Benchmark* b) {
+  b->ArgNames(layernorm_bench_arg_names);
+  ArgsProduct(b, {{128, 2048}, {768, 1024, 4096}, {0, 1}, {1, 8}});
+}
+
+BENCHMARK(LAYERNORM)->Apply(LayerNormSize)->UseRealTime();
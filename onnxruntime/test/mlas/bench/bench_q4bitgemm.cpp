@@ -0,0 +1,70 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "mlas.h"
+#include "bench_util.h"
+
+#include <random>
+#include <stdexcept>
+
+static const std::vector<std::string> q4bitgemm_bench_arg_names = {"M", "N", "K", "BlkLen"};
+
+void Q4BITGEMM(benchmark::State& state, MLAS_Q4BIT_COMPUTE_TYPE compute_type) {
+  if (state.range(0) <= 0) throw std::invalid_argument("M must greater than 0!");
+  if (state.range(1) <= 0) throw std::invalid_argument("N must greater than 0!");
+  if (state.range(2) <= 0) throw std::invalid_argument("K must greater than 0!");
+  if (state.range(3) <= 0) throw std::invalid_argument("BlkLen must greater than 0!");
+  const size_t M = static_cast<size_t>(state.range(0));
+  const size_t N = static_cast<size_t>(state.range(1));
+  const size_t K = static_cast<size_t>(state.range(2));
+  const size_t BlkLen = static_cast<size_t>(state.range(3));
+  const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+
+  auto A = RandomVectorUniform(static_cast<size_t>(M * K), -1.0f, 1.0f);
+  auto QuantBScale = RandomVectorUniform(static_cast<size_t>(N * BlockCountK), 0.01f, 0.1f);
+  std::vector<float> C(static_cast<size_t>(M * N));
+
+  std::default_random_engine generator(static_cast<unsigned>(N * K));
+  std::uniform_int_distribution<int> distribution(0, 255);
+  std::vector<uint8_t> QuantBData(N * BlockCountK * BlkLen / 2);
+  for (auto& v : QuantBData) {
+    v = static_cast<uint8_t>(distribution(generator));
+  }
+  std::vector<uint8_t> QuantBZeroPoint(N * ((BlockCountK + 1) / 2));
+  for (auto& v : QuantBZeroPoint) {
+    v = static_cast<uint8_t>(distribution(generator));
+  }
+
+  std::vector<uint8_t> Workspace(MlasQ4BitGemmBatchWorkspaceSize(M, N, K, 1, BlkLen, compute_type));
+
+  MLAS_Q4BIT_GEMM_DATA_PARAMS params;
+  params.A = A.data();
+  params.lda = K;
+  params.QuantBData = QuantBData.data();
+  params.QuantBScale = QuantBScale.data();
+  params.QuantBZeroPoint = QuantBZeroPoint.data();
+  params.C = C.data();
+  params.ldc = N;
+
+  MlasQ4BitGemmBatch(M, N, K, 1, BlkLen, compute_type, &params, Workspace.data(), nullptr);
+
+  for (auto _ : state) {
+    MlasQ4BitGemmBatch(M, N, K, 1, BlkLen, compute_type, &params, Workspace.data(), nullptr);
+  }
+}
+
+static void Q4BitGemmSizeWithOne(benchmark::internal::Benchmark* b) {
+  b->ArgNames(q4bitgemm_bench_arg_names);
+  ArgsProduct(b, {{1}, {1024, 4096, 11008}, {1024, 4096, 11008}, {32, 64, 128}});
+}
+
+static void Q4BitGemmSizeSmallM(benchmark::internal::Benchmark* b) {
+  b->ArgNames(q4bitgemm_bench_arg_names);
+  ArgsProduct(b, {{4, 16, 64}, {4096}, {4096}, {32, 128}});
+}
+
+BENCHMARK_CAPTURE(Q4BITGEMM, GEMV_FP32, MlasQ4BitCompFp32)->Apply(Q4BitGemmSizeWithOne)->UseRealTime();
+BENCHMARK_CAPTURE(Q4BITGEMM, GEMV_INT8, MlasQ4BitCompInt8)->Apply(Q4BitGemmSizeWithOne)->UseRealTime();
+
+BENCHMARK_CAPTURE(Q4BITGEMM, FP32, MlasQ4BitCompFp32)->Apply(Q4BitGemmSizeSmallM)->UseRealTime();
+BENCHMARK_CAPTURE(Q4BITGEMM, INT8, MlasQ4BitCompInt8)->Apply(Q4BitGemmSizeSmallM)->UseRealTime();
@@ -110,6 +110,7 @@ void SCONV_NCHW(benchmark::State& state, const char* /*dummy*/) {
                   &activation,
                   &WorkingBufferSize,
                   0.0f,
+                  false,
                   nullptr);
 
   auto X = RandomVectorUniform(x_shape, -2.0, 2.0);
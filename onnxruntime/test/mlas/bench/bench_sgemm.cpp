@@ -106,6 +106,11 @@ static void GemmSizeProducts(benchmark::internal::Benchmark* b) {
   ArgsProduct(b, {{63, 255, 1023}, {63, 255, 1023}, {63, 255, 1023}});
 }
 
+static void GemmSizeSmallM(benchmark::internal::Benchmark* b) {
+  b->ArgNames(sgemm_bench_arg_names);
+  ArgsProduct(b, {{1, 2, 3, 4, 5, 6, 7, 8}, {1024, 4096}, {1024, 4096}});
+}
+
 BENCHMARK_CAPTURE(SGEMM, NORMAL_NoTrans, false, false, false)->Apply(GemmSizeProducts)->UseRealTime();
 BENCHMARK_CAPTURE(SGEMM, NORMAL_TransA, false, true, false)->Apply(GemmSizeProducts)->UseRealTime();
 BENCHMARK_CAPTURE(SGEMM, NORMAL_TransB, false, false, true)->Apply(GemmSizeProducts)->UseRealTime();
@@ -116,5 +121,11 @@ BENCHMARK_CAPTURE(SGEMM, GEMV_TransA, false, true, false)->Apply(GemmSizeWithOne
 BENCHMARK_CAPTURE(SGEMM, GEMV_TransB, false, false, true)->Apply(GemmSizeWithOne)->UseRealTime();
 BENCHMARK_CAPTURE(SGEMM, GEMV_ABTrans, false, true, true)->Apply(GemmSizeWithOne)->UseRealTime();
 
+BENCHMARK_CAPTURE(SGEMM, SMALLM_NoTrans, false, false, false)->Apply(GemmSizeSmallM)->UseRealTime();
+BENCHMARK_CAPTURE(SGEMM, SMALLM_TransA, false, true, false)->Apply(GemmSizeSmallM)->UseRealTime();
+BENCHMARK_CAPTURE(SGEMM, SMALLM_TransB, false, false, true)->Apply(GemmSizeSmallM)->UseRealTime();
+BENCHMARK_CAPTURE(SGEMM, SMALLM_PACKB_NoTransA, true, false, false)->Apply(GemmSizeSmallM)->UseRealTime();
+BENCHMARK_CAPTURE(SGEMM, SMALLM_PACKB_TransA, true, true, false)->Apply(GemmSizeSmallM)->UseRealTime();
+
 BENCHMARK_CAPTURE(SGEMM, PACKB_NoTransA, true, false, false)->Apply(GemmSizeProducts)->UseRealTime();
 BENCHMARK_CAPTURE(SGEMM, PACKB_TransA, true, true, false)->Apply(GemmSizeProducts)->UseRealTime();
@@ -0,0 +1,192 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    test_bf16gemm.cpp
+
+Abstract:
+
+    Tests for MLAS bfloat16 GEMM.
+
+    The inputs are small integers, so every product and partial sum is exact
+    in fp32 and the result does not depend on the order of accumulation. This
+    lets every kernel be compared exactly against the reference.
+
+--*/
+
+#include "test_util.h"
+
+template <bool Packed, bool Threaded>
+class MlasBf16GemmTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<uint16_t> BufferA;
+  MatrixGuardBuffer<uint16_t> BufferB;
+  MatrixGuardBuffer<uint8_t> BufferBPacked;
+  MatrixGuardBuffer<float> BufferC;
+  MatrixGuardBuffer<float> BufferCReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  static uint16_t FloatToBf16(float Value) {
+    uint32_t Bits;
+    memcpy(&Bits, &Value, sizeof(Bits));
+    return static_cast<uint16_t>(Bits >> 16);
+  }
+
+  static float Bf16ToFloat(uint16_t Value) {
+    uint32_t Bits = uint32_t(Value) << 16;
+    float Result;
+    memcpy(&Result, &Bits, sizeof(Result));
+    return Result;
+  }
+
+  void FillInteger(uint16_t* Buffer, size_t Elements, int Seed) {
+    for (size_t i = 0; i < Elements; i++) {
+      Buffer[i] = FloatToBf16(static_cast<float>(static_cast<int>((i * 7 + Seed) % 17) - 8));
+    }
+  }
+
+  void ReferenceGemm(CBLAS_TRANSPOSE TransA, CBLAS_TRANSPOSE TransB, size_t M, size_t N, size_t K,
+                     float alpha, const uint16_t* A, size_t lda, const uint16_t* B, size_t ldb,
+                     float beta, float* C, size_t ldc) {
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        float sum = 0.0f;
+        for (size_t k = 0; k < K; k++) {
+          const uint16_t a = (TransA == CblasNoTrans) ? A[m * lda + k] : A[k * lda + m];
+          const uint16_t b = (TransB == CblasNoTrans) ? B[k * ldb + n] : B[n * ldb + k];
+          sum += Bf16ToFloat(a) * Bf16ToFloat(b);
+        }
+        C[m * ldc + n] = alpha * sum + ((beta == 0.0f) ? 0.0f : beta * C[m * ldc + n]);
+      }
+    }
+  }
+
+ public:
+  MlasBf16GemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void Test(CBLAS_TRANSPOSE TransA, CBLAS_TRANSPOSE TransB, size_t M, size_t N, size_t K,
+            size_t BatchSize, float alpha, float beta) {
+    const size_t lda = (TransA == CblasNoTrans) ? K : M;
+    const size_t ldb = (TransB == CblasNoTrans) ? N : K;
+    const size_t ldc = N;
+
+    uint16_t* A = BufferA.GetBuffer(M * K * BatchSize);
+    uint16_t* B = BufferB.GetBuffer(K * N);
+    float* C = BufferC.GetBuffer(M * N * BatchSize);
+    float* CReference = BufferCReference.GetBuffer(M * N * BatchSize);
+
+    FillInteger(A, M * K * BatchSize, 3);
+    FillInteger(B, K * N, 11);
+    for (size_t i = 0; i < M * N * BatchSize; i++) {
+      C[i] = static_cast<float>(static_cast<int>(i % 13) - 6);
+      CReference[i] = C[i];
+    }
+
+    void* PackedB = nullptr;
+    if (Packed) {
+      const size_t PackedBSize = MlasBf16GemmPackBSize(N, K);
+      PackedB = BufferBPacked.GetBuffer(PackedBSize, true);
+      MlasBf16GemmPackB(TransB, N, K, reinterpret_cast<const MLAS_BF16*>(B), ldb, PackedB);
+    }
+
+    std::vector<MLAS_BF16_GEMM_DATA_PARAMS> Data(BatchSize);
+    for (size_t i = 0; i < BatchSize; i++) {
+      Data[i].A = reinterpret_cast<const MLAS_BF16*>(A + M * K * i);
+      Data[i].lda = lda;
+      Data[i].B = Packed ? PackedB : static_cast<const void*>(B);
+      Data[i].ldb = Packed ? 0 : ldb;
+      Data[i].C = C + M * N * i;
+      Data[i].ldc = ldc;
+      Data[i].alpha = alpha;
+      Data[i].beta = beta;
+    }
+
+    MlasBf16GemmBatch(TransA, TransB, M, N, K, Data.data(), BatchSize, threadpool_);
+
+    for (size_t i = 0; i < BatchSize; i++) {
+      ReferenceGemm(TransA, TransB, M, N, K, alpha, A + M * K * i, lda, B, ldb,
+                    beta, CReference + M * N * i, ldc);
+    }
+
+    for (size_t i = 0; i < M * N * BatchSize; i++) {
+      ASSERT_EQ(C[i], CReference[i]) << "@[" << i << "], "
+                                      << "Trans=" << TransA << "/" << TransB << " Batch=" << BatchSize
+                                      << " M=" << M << " N=" << N << " K=" << K
+                                      << " alpha=" << alpha << " beta=" << beta;
+    }
+  }
+
+  static const char* GetTestSuiteName() {
+    static std::string suite_name = std::string("Bf16Gemm") +
+                                    (Packed ? "_Packed" : "_NoPack") +
+                                    (Threaded ? "_Threaded" : "_SingleThread");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    static const CBLAS_TRANSPOSE Trans[] = {CblasNoTrans, CblasTrans};
+
+    for (auto TransA : Trans) {
+      for (auto TransB : Trans) {
+        for (size_t b = 1; b < 36; b++) {
+          Test(TransA, TransB, b, b, b, 1, 1.0f, 0.0f);
+          Test(TransA, TransB, b, 33, b, 1, 0.5f, 1.0f);
+          Test(TransA, TransB, 1, b, 67, 1, 1.0f, -2.0f);
+        }
+        for (size_t b = 64; b <= 256; b <<= 1) {
+          Test(TransA, TransB, b, b, b, 1, 1.0f, 0.0f);
+          Test(TransA, TransB, b + 1, b + 3, b + 5, 1, 0.5f, 1.0f);
+        }
+        Test(TransA, TransB, 43, 500, 1031, 1, 1.0f, 0.0f);
+        Test(TransA, TransB, 7, 37, 41, 3, 1.0f, 1.0f);
+        Test(TransA, TransB, 5, 7, 0, 2, 1.0f, 2.0f);
+      }
+    }
+  }
+
+  void ExecuteLong(void) override {
+    static const CBLAS_TRANSPOSE Trans[] = {CblasNoTrans, CblasTrans};
+
+    for (auto TransA : Trans) {
+      for (auto TransB : Trans) {
+        for (size_t M = 1; M < 80; M += 7) {
+          for (size_t N = 1; N < 300; N += 13) {
+            for (size_t K = 1; K < 600; K += 37) {
+              Test(TransA, TransB, M, N, K, 1, 1.0f, 0.0f);
+              Test(TransA, TransB, M, N, K, 2, 0.5f, 1.0f);
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+template <> MlasBf16GemmTest<false, false>* MlasTestFixture<MlasBf16GemmTest<false, false>>::mlas_tester(nullptr);
+template <> MlasBf16GemmTest<false, true>* MlasTestFixture<MlasBf16GemmTest<false, true>>::mlas_tester(nullptr);
+template <> MlasBf16GemmTest<true, false>* MlasTestFixture<MlasBf16GemmTest<true, false>>::mlas_tester(nullptr);
+template <> MlasBf16GemmTest<true, true>* MlasTestFixture<MlasBf16GemmTest<true, true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasBf16GemmTest<false, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasBf16GemmTest<true, false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasBf16GemmTest<false, true>>::RegisterShortExecute();
+      count += MlasDirectShortExecuteTests<MlasBf16GemmTest<true, true>>::RegisterShortExecute();
+    }
+  } else {
+    count += MlasLongExecuteTests<MlasBf16GemmTest<false, false>>::RegisterLongExecute();
+    count += MlasLongExecuteTests<MlasBf16GemmTest<true, false>>::RegisterLongExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasLongExecuteTests<MlasBf16GemmTest<false, true>>::RegisterLongExecute();
+      count += MlasLongExecuteTests<MlasBf16GemmTest<true, true>>::RegisterLongExecute();
+    }
+  }
+  return count;
+});
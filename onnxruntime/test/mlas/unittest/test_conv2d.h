@@ -58,6 +58,7 @@ class MlasConv2DTest : public MlasTestBase {
                     &Activation,
                     &WorkingBufferSize,
                     0.0f,
+                    false,
                     threadpool_);
 
     MlasConv(&Parameters,
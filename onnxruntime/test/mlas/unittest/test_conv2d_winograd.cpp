@@ -0,0 +1,204 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    test_conv2d_winograd.cpp
+
+Abstract:
+
+    Tests for MLAS 3x3 convolutions using the Winograd algorithm.
+
+    The Winograd transforms are not exact, so the reference is accumulated in
+    double and the tolerance scales with the convolution of the absolute
+    values of the input and filter.
+
+--*/
+
+#include "test_util.h"
+
+#include <cmath>
+
+template <bool Threaded>
+class MlasConv2DWinogradTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferFilter;
+  MatrixGuardBuffer<float> BufferPackedFilter;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferOutput;
+  MatrixGuardBuffer<float> BufferWorking;
+
+  MLAS_THREADPOOL* threadpool_;
+
+  void Test(size_t BatchCount,
+            size_t GroupCount,
+            size_t InputChannels,
+            size_t InputHeight,
+            size_t InputWidth,
+            size_t FilterCount,
+            size_t PaddingTop,
+            size_t PaddingLeft,
+            size_t PaddingBottom,
+            size_t PaddingRight,
+            float Beta) {
+    const size_t OutputHeight = InputHeight + PaddingTop + PaddingBottom - 2;
+    const size_t OutputWidth = InputWidth + PaddingLeft + PaddingRight - 2;
+
+    const size_t InputSize = InputHeight * InputWidth;
+    const size_t OutputSize = OutputHeight * OutputWidth;
+
+    const size_t InputElements = BatchCount * GroupCount * InputChannels * InputSize;
+    const size_t FilterElements = GroupCount * FilterCount * InputChannels * 9;
+    const size_t BiasElements = GroupCount * FilterCount;
+    const size_t OutputElements = BatchCount * GroupCount * FilterCount * OutputSize;
+
+    int64_t InputShape[] = {int64_t(InputHeight), int64_t(InputWidth)};
+    int64_t KernelShape[] = {3, 3};
+    int64_t DilationShape[] = {1, 1};
+    int64_t Padding[] = {int64_t(PaddingTop), int64_t(PaddingLeft), int64_t(PaddingBottom), int64_t(PaddingRight)};
+    int64_t StrideShape[] = {1, 1};
+    int64_t OutputShape[] = {int64_t(OutputHeight), int64_t(OutputWidth)};
+
+    const size_t PackedFilterElements = MlasConvWinogradPackFilterSize(2, GroupCount, InputChannels, KernelShape,
+                                                                       DilationShape, StrideShape, FilterCount);
+    ASSERT_NE(PackedFilterElements, size_t(0)) << "Cpg" << InputChannels << "/Fpg" << FilterCount;
+
+    float* Input = BufferInput.GetBuffer(InputElements);
+    float* Filter = BufferFilter.GetBuffer(FilterElements);
+    float* PackedFilter = BufferPackedFilter.GetBuffer(PackedFilterElements);
+    float* Bias = BufferBias.GetBuffer(BiasElements);
+    float* Output = BufferOutput.GetBuffer(OutputElements);
+
+    std::default_random_engine generator(static_cast<unsigned>(InputElements + FilterElements));
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+    for (size_t i = 0; i < InputElements; i++) {
+      Input[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < FilterElements; i++) {
+      Filter[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < BiasElements; i++) {
+      Bias[i] = distribution(generator);
+    }
+    for (size_t i = 0; i < OutputElements; i++) {
+      Output[i] = distribution(generator);
+    }
+
+    std::vector<float> OutputInitial(Output, Output + OutputElements);
+
+    MLAS_ACTIVATION Activation;
+    Activation.ActivationKind = MlasIdentityActivation;
+
+    MLAS_CONV_PARAMETERS Parameters;
+    size_t WorkingBufferSize;
+
+    MlasConvPrepare(&Parameters, 2, BatchCount, GroupCount, InputChannels, InputShape, KernelShape, DilationShape,
+                    Padding, StrideShape, OutputShape, FilterCount, &Activation, &WorkingBufferSize, Beta, true,
+                    threadpool_);
+
+    ASSERT_EQ(Parameters.Algorithm, MlasConvAlgorithmWinograd);
+
+    MlasConvWinogradPackFilter(GroupCount, InputChannels, FilterCount, Filter, PackedFilter);
+
+    MlasConv(&Parameters, Input, PackedFilter, Bias, BufferWorking.GetBuffer(WorkingBufferSize), Output,
+             threadpool_);
+
+    for (size_t b = 0; b < BatchCount; b++) {
+      for (size_t g = 0; g < GroupCount; g++) {
+        const float* input = Input + (b * GroupCount + g) * InputChannels * InputSize;
+
+        for (size_t f = 0; f < FilterCount; f++) {
+          const float* filter = Filter + (g * FilterCount + f) * InputChannels * 9;
+          const size_t OutputOffset = ((b * GroupCount + g) * FilterCount + f) * OutputSize;
+
+          for (size_t oh = 0; oh < OutputHeight; oh++) {
+            for (size_t ow = 0; ow < OutputWidth; ow++) {
+              double Expected = Bias[g * FilterCount + f] + Beta * OutputInitial[OutputOffset + oh * OutputWidth + ow];
+              double Magnitude = std::fabs(Expected);
+
+              for (size_t c = 0; c < InputChannels; c++) {
+                for (size_t ky = 0; ky < 3; ky++) {
+                  const size_t ih = oh + ky - PaddingTop;
+                  for (size_t kx = 0; kx < 3; kx++) {
+                    const size_t iw = ow + kx - PaddingLeft;
+                    if (ih < InputHeight && iw < InputWidth) {
+                      const double Product = double(input[c * InputSize + ih * InputWidth + iw]) *
+                                             filter[(c * 3 + ky) * 3 + kx];
+                      Expected += Product;
+                      Magnitude += std::fabs(Product);
+                    }
+                  }
+                }
+              }
+
+              ASSERT_NEAR(Output[OutputOffset + oh * OutputWidth + ow], Expected, 1e-5 * std::max(1.0, Magnitude))
+                  << "B" << BatchCount << "/G" << GroupCount << "/Cpg" << InputChannels << "/Fpg" << FilterCount
+                  << "/H" << InputHeight << "/W" << InputWidth << "/Pad" << PaddingTop << "," << PaddingLeft << ","
+                  << PaddingBottom << "," << PaddingRight << "/Beta" << Beta << " @" << b << "," << g << "," << f
+                  << "," << oh << "," << ow;
+            }
+          }
+        }
+      }
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name(Threaded ? "Conv2dWinograd_Threaded" : "Conv2dWinograd_SingleThread");
+    return suite_name.c_str();
+  }
+
+  MlasConv2DWinogradTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void ExecuteShort(void) override {
+    // F(2x2,3x3)
+    Test(1, 1, 16, 8, 8, 16, 1, 1, 1, 1, 0.0f);
+    Test(2, 1, 24, 13, 9, 20, 0, 0, 0, 0, 0.0f);
+    Test(1, 2, 16, 7, 11, 48, 1, 0, 2, 1, 1.0f);
+    // F(4x4,3x3)
+    Test(1, 1, 32, 8, 8, 32, 1, 1, 1, 1, 0.0f);
+    Test(1, 1, 64, 14, 14, 64, 1, 1, 1, 1, 0.0f);
+    Test(2, 1, 32, 17, 23, 40, 0, 1, 1, 0, 0.0f);
+    Test(1, 2, 48, 6, 5, 33, 1, 1, 1, 1, 1.0f);
+    Test(1, 1, 32, 3, 3, 32, 0, 0, 0, 0, 0.0f);
+  }
+
+  void ExecuteLong(void) override {
+    for (size_t Channels : {16, 24, 32, 40}) {
+      for (size_t Filters : {16, 32, 37}) {
+        for (size_t Height = 3; Height < 20; Height += 3) {
+          for (size_t Width = 3; Width < 20; Width += 4) {
+            Test(1, 1, Channels, Height, Width, Filters, 1, 1, 1, 1, 0.0f);
+            Test(2, 2, Channels, Height, Width, Filters, 0, 1, 2, 0, 1.0f);
+          }
+        }
+      }
+    }
+    Test(1, 1, 128, 56, 56, 128, 1, 1, 1, 1, 0.0f);
+  }
+};
+
+template <> MlasConv2DWinogradTest<false>* MlasTestFixture<MlasConv2DWinogradTest<false>>::mlas_tester(nullptr);
+template <> MlasConv2DWinogradTest<true>* MlasTestFixture<MlasConv2DWinogradTest<true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasConv2DWinogradTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasConv2DWinogradTest<true>>::RegisterShortExecute();
+    }
+  } else {
+    count += MlasLongExecuteTests<MlasConv2DWinogradTest<false>>::RegisterLongExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasLongExecuteTests<MlasConv2DWinogradTest<true>>::RegisterLongExecute();
+    }
+  }
+  return count;
+});
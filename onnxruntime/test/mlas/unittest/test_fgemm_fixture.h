@@ -70,6 +70,11 @@ class FgemmShortExecuteTest : public MlasTestFixture<MlasFgemmTest<T, Packed, Th
     test_registered += RegisterTestTransposeABProduct(128, 3072, 768, 1, 1.0f, 0.0f);
     test_registered += RegisterTestTransposeABProduct(128, 768, 3072, 1, 1.0f, 0.0f);
     test_registered += RegisterTestTransposeABProduct(25, 81, 79, 7, 1.0f, 0.0f);
+    for (size_t m = 1; m <= 9; m++) {
+      test_registered += RegisterTestTransposeABProduct(m, 97, 129, 1, 1.0f, 0.0f);
+      test_registered += RegisterTestTransposeABProduct(m, 1000, 65, 1, 0.5f, -1.0f);
+      test_registered += RegisterTestTransposeABProduct(m, 300, 600, 1, 1.5f, 0.5f);
+    }
     return test_registered;
   }
 
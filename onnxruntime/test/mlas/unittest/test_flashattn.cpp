@@ -0,0 +1,222 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    test_flashattn.cpp
+
+Abstract:
+
+    Tests for MLAS fused attention.
+
+    The reference materializes the scores of a head, applies the causal
+    mask, the additive mask and the bias in the same order as the library,
+    and computes the softmax and the output in double.
+
+--*/
+
+#include "test_util.h"
+
+#include <cmath>
+
+template <bool Threaded>
+class MlasFlashAttentionTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferQuery;
+  MatrixGuardBuffer<float> BufferKey;
+  MatrixGuardBuffer<float> BufferValue;
+  MatrixGuardBuffer<float> BufferMask;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<float> BufferOutput;
+  MLAS_THREADPOOL* threadpool_;
+
+  static void FillRandom(float* start, size_t size, float min_value, float max_value) {
+    std::default_random_engine generator(static_cast<unsigned>(size));
+    std::uniform_real_distribution<float> distribution(min_value, max_value);
+    for (size_t i = 0; i < size; i++) {
+      start[i] = distribution(generator);
+    }
+  }
+
+  void ReferenceAttention(const MLAS_FLASH_ATTENTION_PARAMS& Params, std::vector<double>& OutputReference) {
+    const size_t S = Params.SequenceLength;
+    const size_t T = Params.KvSequenceLength;
+    const size_t N = Params.NumHeads;
+    const size_t KvBufferLength = (Params.KvBufferSequenceLength != 0) ? Params.KvBufferSequenceLength : T;
+    std::vector<double> Scores(T);
+
+    for (size_t b = 0; b < Params.BatchSize; b++) {
+      for (size_t h = 0; h < N; h++) {
+        const size_t HeadOffset = b * N + h;
+        for (size_t s = 0; s < S; s++) {
+          const float* q = Params.Query + (HeadOffset * S + s) * Params.QkHeadSize;
+          double Maximum = -INFINITY;
+
+          for (size_t t = 0; t < T; t++) {
+            const float* k = Params.Key + (HeadOffset * KvBufferLength + t) * Params.QkHeadSize;
+            double sum = 0.0;
+            for (size_t i = 0; i < Params.QkHeadSize; i++) {
+              sum += double(q[i]) * double(k[i]);
+            }
+            double score = sum * Params.Scale;
+            if (Params.Causal && t > s + T - S) {
+              score = Params.CausalMaskValue;
+            }
+            if (Params.Mask != nullptr) {
+              score += Params.Mask[b * Params.MaskBatchStride + s * Params.MaskRowStride + t];
+            }
+            if (Params.Bias != nullptr) {
+              score += Params.Bias[b * Params.BiasBatchStride + (h * S + s) * T + t];
+            }
+            Scores[t] = score;
+            Maximum = std::max(Maximum, score);
+          }
+
+          double Sum = 0.0;
+          for (size_t t = 0; t < T; t++) {
+            Scores[t] = std::exp(Scores[t] - Maximum);
+            Sum += Scores[t];
+          }
+
+          for (size_t i = 0; i < Params.VHeadSize; i++) {
+            double out = 0.0;
+            for (size_t t = 0; t < T; t++) {
+              out += Scores[t] * Params.Value[(HeadOffset * KvBufferLength + t) * Params.VHeadSize + i];
+            }
+            OutputReference[((b * S + s) * N + h) * Params.VHeadSize + i] = out / Sum;
+          }
+        }
+      }
+    }
+  }
+
+ public:
+  MlasFlashAttentionTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  //
+  // MaskType: 0 for no mask, 1 for a key padding mask, 2 for a full S x T
+  // mask. BiasType: 0 for no bias, 1 for a bias per batch, 2 for a bias
+  // broadcast across batches. The key and value buffers hold TBuffer
+  // positions per head when it is not 0.
+  //
+
+  void Test(size_t B, size_t N, size_t S, size_t T, size_t QkHeadSize, size_t VHeadSize,
+            bool Causal, int MaskType, int BiasType, size_t TBuffer = 0) {
+    const size_t KvBufferLength = (TBuffer != 0) ? TBuffer : T;
+    MLAS_FLASH_ATTENTION_PARAMS Params;
+    Params.BatchSize = B;
+    Params.NumHeads = N;
+    Params.SequenceLength = S;
+    Params.KvSequenceLength = T;
+    Params.QkHeadSize = QkHeadSize;
+    Params.VHeadSize = VHeadSize;
+    Params.Scale = 1.0f / std::sqrt(float(QkHeadSize));
+    Params.Query = BufferQuery.GetFilledBuffer(B * N * S * QkHeadSize, [](float* start, size_t size) {
+      FillRandom(start, size, -2.0f, 2.0f);
+    });
+    Params.Key = BufferKey.GetFilledBuffer(B * N * KvBufferLength * QkHeadSize, [](float* start, size_t size) {
+      FillRandom(start, size, -2.0f, 2.0f);
+    });
+    Params.Value = BufferValue.GetFilledBuffer(B * N * KvBufferLength * VHeadSize, [](float* start, size_t size) {
+      FillRandom(start, size, -1.0f, 1.0f);
+    });
+    Params.KvBufferSequenceLength = TBuffer;
+
+    if (MaskType != 0) {
+      const size_t RowCount = (MaskType == 1) ? 1 : S;
+      float* Mask = BufferMask.GetBuffer(B * RowCount * T);
+      // Hide the keys at the end of each batch, and a few in the middle.
+      for (size_t b = 0; b < B; b++) {
+        for (size_t r = 0; r < RowCount; r++) {
+          for (size_t t = 0; t < T; t++) {
+            const bool hidden = (t >= T - (b % 3) * T / 4 && t > 0) || (t % 7 == 3 + r % 2);
+            Mask[(b * RowCount + r) * T + t] = hidden ? -10000.0f : 0.0f;
+          }
+        }
+      }
+      Params.Mask = Mask;
+      Params.MaskBatchStride = RowCount * T;
+      Params.MaskRowStride = (MaskType == 1) ? 0 : T;
+    }
+
+    if (BiasType != 0) {
+      const size_t BiasBatchCount = (BiasType == 1) ? B : 1;
+      Params.Bias = BufferBias.GetFilledBuffer(BiasBatchCount * N * S * T, [](float* start, size_t size) {
+        FillRandom(start, size, -1.0f, 1.0f);
+      });
+      Params.BiasBatchStride = (BiasType == 1) ? N * S * T : 0;
+    }
+
+    Params.Causal = Causal;
+    Params.CausalMaskValue = -10000.0f;
+    Params.Output = BufferOutput.GetBuffer(B * S * N * VHeadSize, true);
+
+    MlasFlashAttention(&Params, threadpool_);
+
+    std::vector<double> OutputReference(B * S * N * VHeadSize);
+    ReferenceAttention(Params, OutputReference);
+
+    for (size_t f = 0; f < OutputReference.size(); f++) {
+      ASSERT_NEAR(Params.Output[f], OutputReference[f], 1e-4)
+          << "@" << f << ", B=" << B << " N=" << N << " S=" << S << " T=" << T
+          << " QkHeadSize=" << QkHeadSize << " VHeadSize=" << VHeadSize << " TBuffer=" << TBuffer
+          << " Causal=" << Causal << " Mask=" << MaskType << " Bias=" << BiasType;
+    }
+  }
+
+  static const char* GetTestSuiteName() {
+    static std::string suite_name = std::string("FlashAttention") + (Threaded ? "_Threaded" : "_SingleThread");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (bool Causal : {false, true}) {
+      for (int MaskType : {0, 1, 2}) {
+        for (int BiasType : {0, 1, 2}) {
+          Test(1, 1, 1, 1, 8, 8, Causal, MaskType, BiasType);
+          Test(2, 3, 7, 7, 16, 16, Causal, MaskType, BiasType);
+          Test(2, 2, 33, 40, 32, 24, Causal, MaskType, BiasType);
+          Test(1, 2, 1, 300, 64, 64, Causal, MaskType, BiasType);
+          Test(3, 2, 65, 130, 64, 32, Causal, MaskType, BiasType);
+          Test(1, 4, 257, 257, 64, 64, Causal, MaskType, BiasType);
+          Test(2, 2, 17, 40, 32, 32, Causal, MaskType, BiasType, 64);
+        }
+      }
+    }
+  }
+
+  void ExecuteLong(void) override {
+    for (bool Causal : {false, true}) {
+      for (size_t S = 1; S < 300; S += 37) {
+        for (size_t Past : {0, 1, 31, 128}) {
+          for (size_t HeadSize : {1, 16, 40, 64, 128}) {
+            Test(2, 3, S, S + Past, HeadSize, HeadSize, Causal, 1, 0);
+            Test(1, 2, S, S + Past, HeadSize, HeadSize + 8, Causal, 2, 1);
+          }
+        }
+      }
+    }
+  }
+};
+
+template <> MlasFlashAttentionTest<false>* MlasTestFixture<MlasFlashAttentionTest<false>>::mlas_tester(nullptr);
+template <> MlasFlashAttentionTest<true>* MlasTestFixture<MlasFlashAttentionTest<true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasFlashAttentionTest<true>>::RegisterShortExecute();
+    }
+  } else {
+    count += MlasLongExecuteTests<MlasFlashAttentionTest<false>>::RegisterLongExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasLongExecuteTests<MlasFlashAttentionTest<true>>::RegisterLongExecute();
+    }
+  }
+  return count;
+});
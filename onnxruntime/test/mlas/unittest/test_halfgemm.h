@@ -47,6 +47,7 @@ private:
   MatrixGuardBuffer<MLFp16> BufferBias;
   MatrixGuardBuffer<MLFp16> BufferC;
   MatrixGuardBuffer<float> BufferCReference;
+  MatrixGuardBuffer<float> BufferCReferenceFp32;
   MatrixGuardBuffer<float> BufferFloatC;
   MLAS_THREADPOOL* threadpool_;
 
@@ -119,7 +120,8 @@ private:
                       const AType* A,
                       const BType* B,
                       const MLFp16* Bias,
-                      float* C) {
+                      float* C,
+                      float* CFp32) {
     // TODO!! deal with half precision accumulation error
     // Most CPUs does not support mixed precision accumulation,
     // only mul & add fuse. As a result, different striding
@@ -133,6 +135,10 @@ private:
     // 3. Change the test oracle to be exact match.
     // 4. Pass this test and then change it back :-(.
     //
+    // Kernels without fp16 arithmetic (e.g. x86 F16C) accumulate in fp32
+    // instead, and only round to fp16 at the end of each K stride. This
+    // is modeled by CFp32.
+    //
     constexpr size_t KStride = 512;
 
     for (size_t batch = 0; batch < BatchSize; batch++) {
@@ -141,23 +147,28 @@ private:
           const AType* a = A + M * K * batch + m * K;
           const BType* b = B + K * N * batch + n;
           float* c = C + (M * N * batch) + (m * N) + n;
+          float* c32 = CFp32 + (M * N * batch) + (m * N) + n;
 
           for (size_t k = 0; k < K; k+=KStride) {
             float sum = 0.0f;
+            float sum32 = 0.0f;
             if (k == 0 && Bias != nullptr) {
               sum = float(Bias[n]);
             }
             for (size_t kk = 0; kk < std::min(KStride, K - k); kk++) {
               MLFp16 down(float(*b) * float(*a) + sum);
               sum = float(down);
+              sum32 += float(*b) * float(*a);
               b += N;
               a += 1;
             }
             if (k == 0) {
               *c = sum;
+              *c32 = float(MLFp16(sum32 + (Bias != nullptr ? float(Bias[n]) : 0.0f)));
             } else {
               MLFp16 d(sum + *c);
               *c = float(d);
+              *c32 = float(MLFp16(sum32 + *c32));
             }
           }
         }
@@ -194,17 +205,20 @@ public:
         [](float* start, size_t size) {
           std::fill_n(start, size, -1.0f);
         });
+    float* CReferenceFp32 = BufferCReferenceFp32.GetBuffer(N * M * BatchSize, true);
 
     this->CallGemm(M, N, K, BatchSize, A, K, B, N, Bias, C, N, Cfloat);
-    ReferenceQgemm(M, N, K, BatchSize, A, B, Bias, CReference);
+    ReferenceQgemm(M, N, K, BatchSize, A, B, Bias, CReference, CReferenceFp32);
 
     for (size_t batch = 0, f = 0; batch < BatchSize; batch++) {
       for (size_t m = 0; m < M; m++) {
         for (size_t n = 0; n < N; n++, f++) {
-          ASSERT_TRUE(CloseEnough(float(C[f]), CReference[f])) << "@[" << batch << "x" << m << "x" << n << "], "
-                                                << "Batch=" << BatchSize << "M=" << M << ", N=" << N << ", K=" << K;
-          ASSERT_TRUE(CloseEnough(Cfloat[f], CReference[f])) << "Converted@[" << batch << "x" << m << "x" << n << "], "
-                                                << "Batch=" << BatchSize << "M=" << M << ", N=" << N << ", K=" << K;
+          ASSERT_TRUE(CloseEnough(float(C[f]), CReference[f]) || CloseEnough(float(C[f]), CReferenceFp32[f]))
+              << "@[" << batch << "x" << m << "x" << n << "], "
+              << "Batch=" << BatchSize << "M=" << M << ", N=" << N << ", K=" << K;
+          ASSERT_TRUE(CloseEnough(Cfloat[f], CReference[f]) || CloseEnough(Cfloat[f], CReferenceFp32[f]))
+              << "Converted@[" << batch << "x" << m << "x" << n << "], "
+              << "Batch=" << BatchSize << "M=" << M << ", N=" << N << ", K=" << K;
 
         }
       }
@@ -0,0 +1,209 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    test_layernorm.cpp
+
+Abstract:
+
+    Tests for MLAS layer normalization.
+
+    The reference forms X = Input + Skip + Bias from the same values as the
+    library and computes the statistics and the output in double.
+
+--*/
+
+#include "test_fp16.h"
+
+#include <cmath>
+#include <type_traits>
+
+template <typename T, bool Threaded>
+class MlasLayerNormTest : public MlasTestBase {
+ private:
+  using MlasType = typename std::conditional<std::is_same<T, float>::value, float, MLAS_FP16>::type;
+
+  MatrixGuardBuffer<T> BufferInput;
+  MatrixGuardBuffer<T> BufferSkip;
+  MatrixGuardBuffer<T> BufferBias;
+  MatrixGuardBuffer<T> BufferScale;
+  MatrixGuardBuffer<T> BufferShift;
+  MatrixGuardBuffer<T> BufferOutput;
+  MatrixGuardBuffer<T> BufferSkipOutput;
+  MatrixGuardBuffer<float> BufferMean;
+  MatrixGuardBuffer<float> BufferInvStdDev;
+  MLAS_THREADPOOL* threadpool_;
+
+  static void FillRandom(T* start, size_t size, float min_value, float max_value) {
+    std::default_random_engine generator(static_cast<unsigned>(size));
+    std::uniform_real_distribution<float> distribution(min_value, max_value);
+    for (size_t i = 0; i < size; i++) {
+      start[i] = T(distribution(generator));
+    }
+  }
+
+ public:
+  MlasLayerNormTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void Test(size_t N, size_t D, bool Simplified, bool HasSkip, bool HasBias, bool HasShift, bool HasSkipOutput,
+            bool InPlace = false) {
+    const float Epsilon = 1e-5f;
+    const T* Input = BufferInput.GetFilledBuffer(N * D, [](T* start, size_t size) {
+      FillRandom(start, size, -2.0f, 3.0f);
+    });
+    const T* Skip = HasSkip ? BufferSkip.GetFilledBuffer(N * D, [](T* start, size_t size) {
+      FillRandom(start, size, -1.0f, 1.0f);
+    })
+                            : nullptr;
+    const T* Bias = HasBias ? BufferBias.GetFilledBuffer(D, [](T* start, size_t size) {
+      FillRandom(start, size, -0.5f, 0.5f);
+    })
+                            : nullptr;
+    const T* Scale = BufferScale.GetFilledBuffer(D, [](T* start, size_t size) {
+      FillRandom(start, size, 0.5f, 1.5f);
+    });
+    const T* Shift = HasShift ? BufferShift.GetFilledBuffer(D, [](T* start, size_t size) {
+      FillRandom(start, size, -1.0f, 1.0f);
+    })
+                              : nullptr;
+
+    //
+    // Compute the reference before running in place overwrites the input.
+    //
+
+    std::vector<double> XReference(N * D);
+    std::vector<double> OutputReference(N * D);
+    std::vector<double> MeanReference(N);
+    std::vector<double> InvStdDevReference(N);
+
+    for (size_t n = 0; n < N; n++) {
+      double Sum = 0.0;
+      double SumSquares = 0.0;
+      for (size_t d = 0; d < D; d++) {
+        double x = double(float(Input[n * D + d]));
+        if (Skip != nullptr) {
+          x += double(float(Skip[n * D + d]));
+        }
+        if (Bias != nullptr) {
+          x += double(float(Bias[d]));
+        }
+        XReference[n * D + d] = x;
+        Sum += x;
+        SumSquares += x * x;
+      }
+      const double Mean = Sum / D;
+      const double Variance = Simplified ? SumSquares / D : SumSquares / D - Mean * Mean;
+      const double InvStdDev = 1.0 / std::sqrt(Variance + Epsilon);
+      MeanReference[n] = Mean;
+      InvStdDevReference[n] = InvStdDev;
+      for (size_t d = 0; d < D; d++) {
+        double y = (XReference[n * D + d] - (Simplified ? 0.0 : Mean)) * InvStdDev * double(float(Scale[d]));
+        if (Shift != nullptr) {
+          y += double(float(Shift[d]));
+        }
+        OutputReference[n * D + d] = y;
+      }
+    }
+
+    T* Output = InPlace ? const_cast<T*>(Input) : BufferOutput.GetBuffer(N * D, true);
+    T* SkipOutput = HasSkipOutput ? BufferSkipOutput.GetBuffer(N * D, true) : nullptr;
+
+    MLAS_LAYER_NORM_PARAMS<MlasType> Params;
+    Params.RowCount = N;
+    Params.RowSize = D;
+    Params.Epsilon = Epsilon;
+    Params.Simplified = Simplified;
+    Params.Input = reinterpret_cast<const MlasType*>(Input);
+    Params.Skip = reinterpret_cast<const MlasType*>(Skip);
+    Params.Bias = reinterpret_cast<const MlasType*>(Bias);
+    Params.Scale = reinterpret_cast<const MlasType*>(Scale);
+    Params.Shift = reinterpret_cast<const MlasType*>(Shift);
+    Params.Output = reinterpret_cast<MlasType*>(Output);
+    Params.SkipOutput = reinterpret_cast<MlasType*>(SkipOutput);
+    Params.Mean = BufferMean.GetBuffer(N, true);
+    Params.InvStdDev = BufferInvStdDev.GetBuffer(N, true);
+
+    MlasLayerNorm(&Params, threadpool_);
+
+    constexpr bool IsHalf = !std::is_same<T, float>::value;
+    const double Tolerance = IsHalf ? 2e-2 : 1e-4;
+
+    for (size_t n = 0; n < N; n++) {
+      ASSERT_NEAR(Params.Mean[n], MeanReference[n], 1e-4)
+          << "@" << n << ", N=" << N << " D=" << D << " Simplified=" << Simplified;
+      ASSERT_NEAR(Params.InvStdDev[n], InvStdDevReference[n], 1e-4 * InvStdDevReference[n])
+          << "@" << n << ", N=" << N << " D=" << D << " Simplified=" << Simplified;
+    }
+
+    for (size_t f = 0; f < N * D; f++) {
+      ASSERT_NEAR(float(Output[f]), OutputReference[f], Tolerance * std::max(1.0, std::abs(OutputReference[f])))
+          << "@" << f << ", N=" << N << " D=" << D << " Simplified=" << Simplified << " Skip=" << HasSkip
+          << " Bias=" << HasBias << " Shift=" << HasShift << " SkipOutput=" << HasSkipOutput
+          << " InPlace=" << InPlace;
+      if (SkipOutput != nullptr) {
+        ASSERT_NEAR(float(SkipOutput[f]), XReference[f], IsHalf ? 1e-2 : 1e-6)
+            << "@" << f << ", N=" << N << " D=" << D;
+      }
+    }
+  }
+
+  static const char* GetTestSuiteName() {
+    static std::string suite_name = std::string("LayerNorm") + (std::is_same<T, float>::value ? "_Fp32" : "_Fp16") +
+                                    (Threaded ? "_Threaded" : "_SingleThread");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t D : {1, 3, 8, 15, 16, 17, 33, 64, 100, 768}) {
+      for (bool Simplified : {false, true}) {
+        Test(5, D, Simplified, false, false, !Simplified, false);
+        Test(3, D, Simplified, false, false, false, false, true);
+        Test(4, D, Simplified, true, false, true, false);
+        Test(4, D, Simplified, true, true, true, true);
+        Test(2, D, Simplified, false, true, false, true);
+        Test(3, D, Simplified, false, false, true, true);
+        Test(2, D, Simplified, true, true, false, false, true);
+      }
+    }
+    Test(128, 1024, false, true, true, true, true);
+  }
+
+  void ExecuteLong(void) override {
+    for (size_t D = 1; D < 300; D += 7) {
+      for (bool Simplified : {false, true}) {
+        for (int Mask = 0; Mask < 16; Mask++) {
+          Test(7, D, Simplified, Mask & 1, Mask & 2, Mask & 4, Mask & 8);
+        }
+      }
+    }
+  }
+};
+
+template <> MlasLayerNormTest<float, false>* MlasTestFixture<MlasLayerNormTest<float, false>>::mlas_tester(nullptr);
+template <> MlasLayerNormTest<float, true>* MlasTestFixture<MlasLayerNormTest<float, true>>::mlas_tester(nullptr);
+template <> MlasLayerNormTest<MLFp16, false>* MlasTestFixture<MlasLayerNormTest<MLFp16, false>>::mlas_tester(nullptr);
+template <> MlasLayerNormTest<MLFp16, true>* MlasTestFixture<MlasLayerNormTest<MLFp16, true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasLayerNormTest<float, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasLayerNormTest<MLFp16, false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasLayerNormTest<float, true>>::RegisterShortExecute();
+      count += MlasDirectShortExecuteTests<MlasLayerNormTest<MLFp16, true>>::RegisterShortExecute();
+    }
+  } else {
+    count += MlasLongExecuteTests<MlasLayerNormTest<float, false>>::RegisterLongExecute();
+    count += MlasLongExecuteTests<MlasLayerNormTest<MLFp16, false>>::RegisterLongExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasLongExecuteTests<MlasLayerNormTest<float, true>>::RegisterLongExecute();
+      count += MlasLongExecuteTests<MlasLayerNormTest<MLFp16, true>>::RegisterLongExecute();
+    }
+  }
+  return count;
+});
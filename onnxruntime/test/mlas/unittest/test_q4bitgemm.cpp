@@ -0,0 +1,248 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    test_q4bitgemm.cpp
+
+Abstract:
+
+    Tests for MLAS block-wise 4-bit quantized GEMM.
+
+    The reference dequantizes B and, for the int8 compute type, quantizes A
+    the same way as the library, then accumulates in double. The results
+    are compared with a tolerance relative to the sum of the magnitudes of
+    the products.
+
+--*/
+
+#include "test_util.h"
+
+#include <cmath>
+
+template <MLAS_Q4BIT_COMPUTE_TYPE ComputeType, bool Threaded>
+class MlasQ4BitGemmTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferA;
+  MatrixGuardBuffer<uint8_t> BufferQuantBData;
+  MatrixGuardBuffer<float> BufferQuantBScale;
+  MatrixGuardBuffer<uint8_t> BufferQuantBZeroPoint;
+  MatrixGuardBuffer<float> BufferBias;
+  MatrixGuardBuffer<uint8_t> BufferWorkspace;
+  MatrixGuardBuffer<float> BufferC;
+  MLAS_THREADPOOL* threadpool_;
+
+  static uint8_t GetNibble(const uint8_t* Data, size_t Index) {
+    return (Index & 1) ? (Data[Index / 2] >> 4) : (Data[Index / 2] & 0x0F);
+  }
+
+  static void SetNibble(uint8_t* Data, size_t Index, uint8_t Value) {
+    if (Index & 1) {
+      Data[Index / 2] = static_cast<uint8_t>((Data[Index / 2] & 0x0F) | (Value << 4));
+    } else {
+      Data[Index / 2] = static_cast<uint8_t>((Data[Index / 2] & 0xF0) | Value);
+    }
+  }
+
+  //
+  // Fill the quantized B with random 4-bit values, scales and zero points.
+  //
+
+  void FillQuantB(size_t N, size_t BlockCountK, size_t BlkLen, bool HasZeroPoint,
+                  uint8_t* QuantBData, float* QuantBScale, uint8_t* QuantBZeroPoint) {
+    std::default_random_engine generator(static_cast<unsigned>(N * 131 + BlockCountK * 7 + BlkLen));
+    std::uniform_int_distribution<int> nibble_distribution(0, 15);
+    std::uniform_real_distribution<float> scale_distribution(0.01f, 0.1f);
+
+    for (size_t i = 0; i < N * BlockCountK * BlkLen / 2; i++) {
+      QuantBData[i] = static_cast<uint8_t>(nibble_distribution(generator) | (nibble_distribution(generator) << 4));
+    }
+    for (size_t i = 0; i < N * BlockCountK; i++) {
+      QuantBScale[i] = scale_distribution(generator);
+    }
+    if (HasZeroPoint) {
+      const size_t ZeroPointStride = (BlockCountK + 1) / 2;
+      std::fill_n(QuantBZeroPoint, N * ZeroPointStride, uint8_t(0));
+      for (size_t n = 0; n < N; n++) {
+        for (size_t blk = 0; blk < BlockCountK; blk++) {
+          SetNibble(QuantBZeroPoint + n * ZeroPointStride, blk, static_cast<uint8_t>(nibble_distribution(generator)));
+        }
+      }
+    }
+  }
+
+  void ReferenceQ4BitGemm(size_t M, size_t N, size_t K, size_t BlkLen,
+                          const float* A, const uint8_t* QuantBData, const float* QuantBScale,
+                          const uint8_t* QuantBZeroPoint, const float* Bias,
+                          std::vector<double>& CReference, std::vector<double>& CMagnitude) {
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+    const size_t ZeroPointStride = (BlockCountK + 1) / 2;
+
+    //
+    // Quantize A per block for the int8 compute type.
+    //
+
+    std::vector<float> AReference(A, A + M * K);
+
+    if (ComputeType == MlasQ4BitCompInt8 && MlasIsQ4BitGemmAvailable(BlkLen, ComputeType)) {
+      for (size_t m = 0; m < M; m++) {
+        for (size_t k = 0; k < K; k += BlkLen) {
+          const size_t len = std::min(K - k, BlkLen);
+          float amax = 0.0f;
+          for (size_t kk = 0; kk < len; kk++) {
+            amax = std::max(amax, std::fabs(A[m * K + k + kk]));
+          }
+          const float scale = amax / 127.0f;
+          const float inverse_scale = (amax != 0.0f) ? 127.0f / amax : 0.0f;
+          for (size_t kk = 0; kk < len; kk++) {
+            AReference[m * K + k + kk] = std::nearbyintf(A[m * K + k + kk] * inverse_scale) * scale;
+          }
+        }
+      }
+    }
+
+    for (size_t m = 0; m < M; m++) {
+      for (size_t n = 0; n < N; n++) {
+        double sum = (Bias != nullptr) ? Bias[n] : 0.0;
+        double magnitude = std::fabs(sum);
+        for (size_t k = 0; k < K; k++) {
+          const size_t blk = k / BlkLen;
+          const uint8_t q = GetNibble(QuantBData + (n * BlockCountK + blk) * (BlkLen / 2), k % BlkLen);
+          const uint8_t zp = (QuantBZeroPoint != nullptr) ? GetNibble(QuantBZeroPoint + n * ZeroPointStride, blk) : 8;
+          const double b = (double(q) - double(zp)) * double(QuantBScale[n * BlockCountK + blk]);
+          sum += double(AReference[m * K + k]) * b;
+          magnitude += std::fabs(double(A[m * K + k]) * b);
+        }
+        CReference[m * N + n] = sum;
+        CMagnitude[m * N + n] = magnitude;
+      }
+    }
+  }
+
+ public:
+  MlasQ4BitGemmTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  void Test(size_t M, size_t N, size_t K, size_t BlkLen, size_t BatchSize, bool HasZeroPoint, bool HasBias) {
+    const size_t BlockCountK = (K + BlkLen - 1) / BlkLen;
+    const size_t ZeroPointStride = (BlockCountK + 1) / 2;
+
+    const float* A = BufferA.GetFilledBuffer(M * K * BatchSize, [](float* start, size_t size) {
+      std::default_random_engine generator(static_cast<unsigned>(size));
+      std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+      for (size_t i = 0; i < size; i++) {
+        start[i] = distribution(generator);
+      }
+    });
+    uint8_t* QuantBData = BufferQuantBData.GetBuffer(N * BlockCountK * BlkLen / 2);
+    float* QuantBScale = BufferQuantBScale.GetBuffer(N * BlockCountK);
+    uint8_t* QuantBZeroPoint = HasZeroPoint ? BufferQuantBZeroPoint.GetBuffer(N * ZeroPointStride) : nullptr;
+    const float* Bias = HasBias ? BufferBias.GetBuffer(N) : nullptr;
+    float* C = BufferC.GetBuffer(M * N * BatchSize, true);
+
+    FillQuantB(N, BlockCountK, BlkLen, HasZeroPoint, QuantBData, QuantBScale, QuantBZeroPoint);
+
+    const size_t WorkspaceSize = MlasQ4BitGemmBatchWorkspaceSize(M, N, K, BatchSize, BlkLen, ComputeType);
+    void* Workspace = (WorkspaceSize != 0) ? BufferWorkspace.GetBuffer(WorkspaceSize) : nullptr;
+
+    std::vector<MLAS_Q4BIT_GEMM_DATA_PARAMS> Data(BatchSize);
+    for (size_t i = 0; i < BatchSize; i++) {
+      Data[i].A = A + M * K * i;
+      Data[i].lda = K;
+      Data[i].QuantBData = QuantBData;
+      Data[i].QuantBScale = QuantBScale;
+      Data[i].QuantBZeroPoint = QuantBZeroPoint;
+      Data[i].Bias = Bias;
+      Data[i].C = C + M * N * i;
+      Data[i].ldc = N;
+    }
+
+    MlasQ4BitGemmBatch(M, N, K, BatchSize, BlkLen, ComputeType, Data.data(), Workspace, threadpool_);
+
+    std::vector<double> CReference(M * N);
+    std::vector<double> CMagnitude(M * N);
+
+    for (size_t i = 0; i < BatchSize; i++) {
+      ReferenceQ4BitGemm(M, N, K, BlkLen, A + M * K * i, QuantBData, QuantBScale, QuantBZeroPoint, Bias,
+                         CReference, CMagnitude);
+
+      for (size_t f = 0; f < M * N; f++) {
+        const double tolerance = 1e-4 * CMagnitude[f] + 1e-5;
+        ASSERT_NEAR(C[M * N * i + f], CReference[f], tolerance)
+            << "@[" << i << "][" << f / N << "][" << f % N << "], "
+            << "M=" << M << " N=" << N << " K=" << K << " BlkLen=" << BlkLen
+            << " ZeroPoint=" << HasZeroPoint << " Bias=" << HasBias;
+      }
+    }
+  }
+
+  static const char* GetTestSuiteName() {
+    static std::string suite_name = std::string("Q4BitGemm") +
+                                    (ComputeType == MlasQ4BitCompInt8 ? "_CompInt8" : "_CompFp32") +
+                                    (Threaded ? "_Threaded" : "_SingleThread");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    static const size_t BlkLens[] = {16, 32, 64, 128, 256};
+
+    for (size_t BlkLen : BlkLens) {
+      for (size_t M : {1, 2, 3, 4, 5, 8, 9, 33}) {
+        Test(M, 1, 1, BlkLen, 1, false, false);
+        Test(M, 7, 15, BlkLen, 1, true, false);
+        Test(M, 16, 16, BlkLen, 1, false, true);
+        Test(M, 33, BlkLen + 17, BlkLen, 1, true, true);
+        Test(M, 65, 3 * BlkLen, BlkLen, 1, false, false);
+      }
+      Test(1, 511, 1031, BlkLen, 1, true, true);
+      Test(1, 4096, 1024, BlkLen, 1, true, false);
+      Test(4, 300, 2500, BlkLen, 1, false, true);
+      Test(67, 259, 1100, BlkLen, 1, true, true);
+      Test(5, 37, 129, BlkLen, 3, true, true);
+      Test(40, 37, 129, BlkLen, 3, false, false);
+      Test(3, 9, 0, BlkLen, 2, false, true);
+    }
+  }
+
+  void ExecuteLong(void) override {
+    static const size_t BlkLens[] = {16, 32, 64, 128, 256};
+
+    for (size_t BlkLen : BlkLens) {
+      for (size_t M = 1; M < 40; M += 3) {
+        for (size_t N = 1; N < 300; N += 37) {
+          for (size_t K = 1; K < 1200; K += 97) {
+            Test(M, N, K, BlkLen, 1, false, false);
+            Test(M, N, K, BlkLen, 2, true, true);
+          }
+        }
+      }
+    }
+  }
+};
+
+template <> MlasQ4BitGemmTest<MlasQ4BitCompFp32, false>* MlasTestFixture<MlasQ4BitGemmTest<MlasQ4BitCompFp32, false>>::mlas_tester(nullptr);
+template <> MlasQ4BitGemmTest<MlasQ4BitCompFp32, true>* MlasTestFixture<MlasQ4BitGemmTest<MlasQ4BitCompFp32, true>>::mlas_tester(nullptr);
+template <> MlasQ4BitGemmTest<MlasQ4BitCompInt8, false>* MlasTestFixture<MlasQ4BitGemmTest<MlasQ4BitCompInt8, false>>::mlas_tester(nullptr);
+template <> MlasQ4BitGemmTest<MlasQ4BitCompInt8, true>* MlasTestFixture<MlasQ4BitGemmTest<MlasQ4BitCompInt8, true>>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasQ4BitGemmTest<MlasQ4BitCompFp32, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasQ4BitGemmTest<MlasQ4BitCompInt8, false>>::RegisterShortExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasDirectShortExecuteTests<MlasQ4BitGemmTest<MlasQ4BitCompFp32, true>>::RegisterShortExecute();
+      count += MlasDirectShortExecuteTests<MlasQ4BitGemmTest<MlasQ4BitCompInt8, true>>::RegisterShortExecute();
+    }
+  } else {
+    count += MlasLongExecuteTests<MlasQ4BitGemmTest<MlasQ4BitCompFp32, false>>::RegisterLongExecute();
+    count += MlasLongExecuteTests<MlasQ4BitGemmTest<MlasQ4BitCompInt8, false>>::RegisterLongExecute();
+    if (GetMlasThreadPool() != nullptr) {
+      count += MlasLongExecuteTests<MlasQ4BitGemmTest<MlasQ4BitCompFp32, true>>::RegisterLongExecute();
+      count += MlasLongExecuteTests<MlasQ4BitGemmTest<MlasQ4BitCompInt8, true>>::RegisterLongExecute();
+    }
+  }
+  return count;
+});
@@ -0,0 +1,208 @@
+/*++
+
+Copyright (c) Microsoft Corporation. All rights reserved.
+
+Licensed under the MIT License.
+
+Module Name:
+
+    test_reduce.cpp
+
+Abstract:
+
+    Tests for MLAS reductions of a tensor viewed as [Outer][Reduce][Inner].
+
+    The reference is accumulated in double. The tolerance of the sums scales
+    with the sum of the absolute values of the reduced elements.
+
+--*/
+
+#include "test_util.h"
+
+#include <cmath>
+
+class MlasReduceTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<float> BufferInput;
+  MatrixGuardBuffer<float> BufferOutput;
+
+  static const char* KindName(MLAS_REDUCTION_KIND Kind) {
+    switch (Kind) {
+      case MlasSumReduction:
+        return "Sum";
+      case MlasSumSquareReduction:
+        return "SumSquare";
+      case MlasMaximumReduction:
+        return "Maximum";
+      case MlasMinimumReduction:
+        return "Minimum";
+      case MlasProductReduction:
+        return "Product";
+      case MlasLogSumExpReduction:
+        return "LogSumExp";
+      default:
+        return "?";
+    }
+  }
+
+  static void ReferenceReduce(MLAS_REDUCTION_KIND Kind, const float* Input, size_t ReduceCount, size_t ldInput,
+                              double* Value, double* Magnitude) {
+    double Accumulator = 0.0;
+    double AbsAccumulator = 0.0;
+
+    switch (Kind) {
+      case MlasSumReduction:
+        for (size_t r = 0; r < ReduceCount; r++) {
+          Accumulator += Input[r * ldInput];
+          AbsAccumulator += std::fabs(Input[r * ldInput]);
+        }
+        break;
+      case MlasSumSquareReduction:
+        for (size_t r = 0; r < ReduceCount; r++) {
+          Accumulator += double(Input[r * ldInput]) * Input[r * ldInput];
+        }
+        AbsAccumulator = Accumulator;
+        break;
+      case MlasMaximumReduction:
+        Accumulator = -std::numeric_limits<double>::infinity();
+        for (size_t r = 0; r < ReduceCount; r++) {
+          Accumulator = std::max(Accumulator, double(Input[r * ldInput]));
+        }
+        break;
+      case MlasMinimumReduction:
+        Accumulator = std::numeric_limits<double>::infinity();
+        for (size_t r = 0; r < ReduceCount; r++) {
+          Accumulator = std::min(Accumulator, double(Input[r * ldInput]));
+        }
+        break;
+      case MlasProductReduction:
+        Accumulator = 1.0;
+        for (size_t r = 0; r < ReduceCount; r++) {
+          Accumulator *= Input[r * ldInput];
+        }
+        AbsAccumulator = std::fabs(Accumulator) * ReduceCount;
+        break;
+      case MlasLogSumExpReduction: {
+        double Maximum = -std::numeric_limits<double>::infinity();
+        for (size_t r = 0; r < ReduceCount; r++) {
+          Maximum = std::max(Maximum, double(Input[r * ldInput]));
+        }
+        for (size_t r = 0; r < ReduceCount; r++) {
+          Accumulator += std::exp(Input[r * ldInput] - Maximum);
+        }
+        Accumulator = std::log(Accumulator) + Maximum;
+        AbsAccumulator = std::fabs(Accumulator);
+        break;
+      }
+      default:
+        break;
+    }
+
+    *Value = Accumulator;
+    *Magnitude = AbsAccumulator;
+  }
+
+  void Test(MLAS_REDUCTION_KIND Kind, size_t OuterCount, size_t ReduceCount, size_t InnerCount, size_t InnerStride) {
+    const size_t InputSize = OuterCount * ReduceCount * InnerStride;
+    const size_t OutputSize = OuterCount * InnerStride;
+
+    float* Input = BufferInput.GetBuffer(InputSize);
+    float* Output = BufferOutput.GetBuffer(OutputSize);
+
+    //
+    // Keep the products away from overflow and the exponentials in a range
+    // where the offset by the maximum matters.
+    //
+
+    float MinimumValue = -1.0f;
+    float MaximumValue = 1.0f;
+
+    if (Kind == MlasProductReduction) {
+      MinimumValue = 0.9f;
+      MaximumValue = 1.1f;
+    } else if (Kind == MlasLogSumExpReduction) {
+      MinimumValue = -50.0f;
+      MaximumValue = 100.0f;
+    }
+
+    std::default_random_engine generator(static_cast<unsigned>(InputSize + Kind));
+    std::uniform_real_distribution<float> distribution(MinimumValue, MaximumValue);
+
+    for (size_t i = 0; i < InputSize; i++) {
+      Input[i] = distribution(generator);
+    }
+
+    constexpr float Sentinel = -12345.0f;
+
+    for (size_t i = 0; i < OutputSize; i++) {
+      Output[i] = Sentinel;
+    }
+
+    MlasReduce(Kind, Input, Output, OuterCount, ReduceCount, InnerCount, InnerStride);
+
+    for (size_t o = 0; o < OuterCount; o++) {
+      for (size_t i = 0; i < InnerStride; i++) {
+        const float Actual = Output[o * InnerStride + i];
+
+        if (i >= InnerCount) {
+          ASSERT_EQ(Actual, Sentinel) << KindName(Kind) << " wrote past InnerCount @" << o << "," << i;
+          continue;
+        }
+
+        double Expected;
+        double Magnitude;
+        ReferenceReduce(Kind, Input + o * ReduceCount * InnerStride + i, ReduceCount, InnerStride,
+                        &Expected, &Magnitude);
+
+        ASSERT_NEAR(Actual, Expected, 1e-5 * std::max(1.0, Magnitude))
+            << KindName(Kind) << " @" << o << "," << i << ", Outer=" << OuterCount << " Reduce=" << ReduceCount
+            << " Inner=" << InnerCount << " InnerStride=" << InnerStride;
+      }
+    }
+  }
+
+  void TestAllKinds(size_t OuterCount, size_t ReduceCount, size_t InnerCount, size_t InnerStride) {
+    for (MLAS_REDUCTION_KIND Kind : {MlasSumReduction, MlasSumSquareReduction, MlasMaximumReduction,
+                                     MlasMinimumReduction, MlasProductReduction, MlasLogSumExpReduction}) {
+      Test(Kind, OuterCount, ReduceCount, InnerCount, InnerStride);
+    }
+  }
+
+ public:
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name("Reduce");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    for (size_t ReduceCount : {1, 3, 7, 8, 15, 16, 17, 31, 33, 64, 65, 100, 768}) {
+      TestAllKinds(5, ReduceCount, 1, 1);
+      TestAllKinds(1, ReduceCount, 3, 3);
+      TestAllKinds(2, ReduceCount, 17, 17);
+      TestAllKinds(3, ReduceCount, 80, 80);
+      TestAllKinds(2, ReduceCount, 5, 37);
+      TestAllKinds(1, ReduceCount, 300, 301);
+    }
+  }
+
+  void ExecuteLong(void) override {
+    for (size_t ReduceCount = 1; ReduceCount < 100; ReduceCount += 3) {
+      for (size_t InnerCount = 1; InnerCount < 150; InnerCount += 7) {
+        TestAllKinds(3, ReduceCount, InnerCount, InnerCount);
+        TestAllKinds(2, ReduceCount, InnerCount, InnerCount + 5);
+      }
+    }
+  }
+};
+
+template <> MlasReduceTest* MlasTestFixture<MlasReduceTest>::mlas_tester(nullptr);
+
+static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
+  size_t count = 0;
+  if (is_short_execute) {
+    count += MlasDirectShortExecuteTests<MlasReduceTest>::RegisterShortExecute();
+  } else {
+    count += MlasLongExecuteTests<MlasReduceTest>::RegisterLongExecute();
+  }
+  return count;
+});
@@ -3,6 +3,8 @@
 
 #include "test_util.h"
 
+#include <algorithm>
+
 template <typename ElementType>
 class MlasTransposeTest : public MlasTestBase {
  private:
@@ -45,9 +47,129 @@ class MlasTransposeTest : public MlasTestBase {
   }
 };
 
+template <typename ElementType, bool Threaded>
+class MlasTransposeNdTest : public MlasTestBase {
+ private:
+  MatrixGuardBuffer<ElementType> BufferInput;
+  MatrixGuardBuffer<ElementType> BufferOutput;
+  MatrixGuardBuffer<ElementType> BufferOutputReference;
+  MLAS_THREADPOOL* threadpool_;
+
+  void
+  Test(const std::vector<size_t>& Shape, const std::vector<size_t>& Permutation) {
+    const size_t Rank = Shape.size();
+    size_t Size = 1;
+    for (size_t d : Shape) {
+      Size *= d;
+    }
+
+    ElementType* Input = BufferInput.GetBuffer(Size);
+    ElementType* Output = BufferOutput.GetBuffer(Size);
+    ElementType* OutputReference = BufferOutputReference.GetBuffer(Size);
+
+    for (size_t i = 0; i < Size; i++) {
+      Input[i] = static_cast<ElementType>(i * 2654435761u);
+    }
+
+    MlasTransposeNd(Input, Output, sizeof(ElementType), Rank, Shape.data(), Permutation.data(), threadpool_);
+    ReferenceTransposeNd(Input, OutputReference, Shape, Permutation);
+
+    ASSERT_EQ(memcmp(Output, OutputReference, Size * sizeof(ElementType)), 0)
+        << " shape " << ToString(Shape) << " perm " << ToString(Permutation);
+  }
+
+  void ReferenceTransposeNd(const ElementType* Input, ElementType* Output,
+                            const std::vector<size_t>& Shape, const std::vector<size_t>& Permutation) {
+    const size_t Rank = Shape.size();
+    std::vector<size_t> InputStrides(Rank, 1);
+    for (size_t i = Rank - 1; i > 0; i--) {
+      InputStrides[i - 1] = InputStrides[i] * Shape[i];
+    }
+
+    std::vector<size_t> Index(Rank, 0);
+    size_t Size = 1;
+    for (size_t d : Shape) {
+      Size *= d;
+    }
+
+    for (size_t o = 0; o < Size; o++) {
+      size_t InputOffset = 0;
+      for (size_t i = 0; i < Rank; i++) {
+        InputOffset += Index[i] * InputStrides[Permutation[i]];
+      }
+      Output[o] = Input[InputOffset];
+      for (size_t i = Rank; i > 0; i--) {
+        if (++Index[i - 1] < Shape[Permutation[i - 1]]) {
+          break;
+        }
+        Index[i - 1] = 0;
+      }
+    }
+  }
+
+  static std::string ToString(const std::vector<size_t>& v) {
+    std::string s;
+    for (size_t d : v) {
+      s += std::to_string(d) + ",";
+    }
+    return s;
+  }
+
+  void TestAllPermutations(const std::vector<size_t>& Shape) {
+    std::vector<size_t> Permutation(Shape.size());
+    for (size_t i = 0; i < Shape.size(); i++) {
+      Permutation[i] = i;
+    }
+    do {
+      Test(Shape, Permutation);
+    } while (std::next_permutation(Permutation.begin(), Permutation.end()));
+  }
+
+ public:
+  MlasTransposeNdTest() : threadpool_(Threaded ? GetMlasThreadPool() : nullptr) {}
+
+  static const char* GetTestSuiteName() {
+    static const std::string suite_name = std::string("TransposeNd_Size") + std::to_string(int(sizeof(ElementType))) +
+                                          (Threaded ? "_Threaded" : "_SingleThread");
+    return suite_name.c_str();
+  }
+
+  void ExecuteShort(void) override {
+    TestAllPermutations({1});
+    TestAllPermutations({7});
+    TestAllPermutations({1, 1});
+    for (size_t m = 1; m <= 17; m += 4) {
+      for (size_t n = 1; n <= 70; n += 3) {
+        TestAllPermutations({m, n});
+      }
+    }
+    TestAllPermutations({65, 130});
+    TestAllPermutations({3, 5, 7});
+    TestAllPermutations({2, 70, 33});
+    TestAllPermutations({1, 17, 1, 9});
+    TestAllPermutations({2, 3, 4, 5});
+    TestAllPermutations({2, 8, 12, 64});
+    TestAllPermutations({3, 1, 67, 2, 5});
+  }
+
+  void ExecuteLong(void) override {
+    TestAllPermutations({2, 3, 2, 5, 3, 2});
+    TestAllPermutations({4, 128, 12, 64});
+    TestAllPermutations({2, 100, 3, 129});
+  }
+};
+
 template <> MlasTransposeTest<uint32_t>* MlasTestFixture<MlasTransposeTest<uint32_t>>::mlas_tester(nullptr);
 template <> MlasTransposeTest<uint16_t>* MlasTestFixture<MlasTransposeTest<uint16_t>>::mlas_tester(nullptr);
 template <> MlasTransposeTest<uint8_t>* MlasTestFixture<MlasTransposeTest<uint8_t>>::mlas_tester(nullptr);
+template <> MlasTransposeNdTest<uint64_t, false>* MlasTestFixture<MlasTransposeNdTest<uint64_t, false>>::mlas_tester(nullptr);
+template <> MlasTransposeNdTest<uint64_t, true>* MlasTestFixture<MlasTransposeNdTest<uint64_t, true>>::mlas_tester(nullptr);
+template <> MlasTransposeNdTest<uint32_t, false>* MlasTestFixture<MlasTransposeNdTest<uint32_t, false>>::mlas_tester(nullptr);
+template <> MlasTransposeNdTest<uint32_t, true>* MlasTestFixture<MlasTransposeNdTest<uint32_t, true>>::mlas_tester(nullptr);
+template <> MlasTransposeNdTest<uint16_t, false>* MlasTestFixture<MlasTransposeNdTest<uint16_t, false>>::mlas_tester(nullptr);
+template <> MlasTransposeNdTest<uint16_t, true>* MlasTestFixture<MlasTransposeNdTest<uint16_t, true>>::mlas_tester(nullptr);
+template <> MlasTransposeNdTest<uint8_t, false>* MlasTestFixture<MlasTransposeNdTest<uint8_t, false>>::mlas_tester(nullptr);
+template <> MlasTransposeNdTest<uint8_t, true>* MlasTestFixture<MlasTransposeNdTest<uint8_t, true>>::mlas_tester(nullptr);
 
 static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_execute) {
   size_t count = 0;
@@ -55,6 +177,19 @@ static UNUSED_VARIABLE bool added_to_main = AddTestRegister([](bool is_short_exe
     count += MlasDirectShortExecuteTests<MlasTransposeTest<uint32_t>>::RegisterShortExecute();
     count += MlasDirectShortExecuteTests<MlasTransposeTest<uint16_t>>::RegisterShortExecute();
     count += MlasDirectShortExecuteTests<MlasTransposeTest<uint8_t>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTransposeNdTest<uint64_t, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTransposeNdTest<uint64_t, true>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTransposeNdTest<uint32_t, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTransposeNdTest<uint32_t, true>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTransposeNdTest<uint16_t, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTransposeNdTest<uint16_t, true>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTransposeNdTest<uint8_t, false>>::RegisterShortExecute();
+    count += MlasDirectShortExecuteTests<MlasTransposeNdTest<uint8_t, true>>::RegisterShortExecute();
+  } else {
+    count += MlasLongExecuteTests<MlasTransposeNdTest<uint64_t, true>>::RegisterLongExecute();
+    count += MlasLongExecuteTests<MlasTransposeNdTest<uint32_t, true>>::RegisterLongExecute();
+    count += MlasLongExecuteTests<MlasTransposeNdTest<uint16_t, true>>::RegisterLongExecute();
+    count += MlasLongExecuteTests<MlasTransposeNdTest<uint8_t, true>>::RegisterLongExecute();
   }
   return count;
 });
@@ -0,0 +1,53 @@
+#include <benchmark/benchmark.h>
+#include <array>
+#include <memory>
+
+#include "core/framework/allocator.h"
+#include "core/framework/bfc_arena.h"
+
+using namespace onnxruntime;
+
+// Alloc and Free on one CPU arena from several threads, as done by concurrent Run calls on a session. The argument
+// is the size of the per-thread cache, 0 is the arena without the cache where every call takes the arena lock.
+
+static BFCArena* shared_arena = nullptr;
+
+static void BM_BFCArenaContention(benchmark::State& state) {
+  if (state.thread_index() == 0) {
+    shared_arena = new BFCArena(std::make_unique<CPUAllocator>(), BFCArena::DEFAULT_MAX_MEM,
+                                BFCArena::DEFAULT_ARENA_EXTEND_STRATEGY, BFCArena::DEFAULT_INITIAL_CHUNK_SIZE_BYTES,
+                                BFCArena::DEFAULT_MAX_DEAD_BYTES_PER_CHUNK,
+                                BFCArena::DEFAULT_INITIAL_GROWTH_CHUNK_SIZE_BYTES,
+                                static_cast<int>(state.range(0)));
+  }
+
+  // the sizes of the intermediate tensors of a small model
+  static constexpr std::array<size_t, 8> sizes{256, 1024, 4096, 512, 16384, 2048, 65536, 768};
+  std::array<void*, sizes.size()> ptrs{};
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < sizes.size(); ++i) {
+      ptrs[i] = shared_arena->Alloc(sizes[i]);
+    }
+    benchmark::DoNotOptimize(ptrs.data());
+    for (size_t i = sizes.size(); i-- > 0;) {
+      shared_arena->Free(ptrs[i]);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * sizes.size());
+
+  // all the threads have left the loop, the caches of the threads that still exist are released with the arena
+  if (state.thread_index() == 0) {
+    delete shared_arena;
+    shared_arena = nullptr;
+  }
+}
+
+BENCHMARK(BM_BFCArenaContention)
+    ->Arg(0)
+    ->Arg(1 << 20)
+    ->Threads(1)
+    ->Threads(4)
+    ->Threads(16)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kNanosecond);
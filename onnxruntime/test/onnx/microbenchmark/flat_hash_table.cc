@@ -0,0 +1,79 @@
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/common/flat_hash_table.h"
+
+using namespace onnxruntime;
+
+// Compares the lookups of LabelEncoder like vocabularies, strings to int64, in
+// std::unordered_map and in FlatHashTable. The argument is the vocabulary size, half of
+// the looked up strings are in the vocabulary.
+
+static std::vector<std::string> MakeStrings(size_t count, unsigned seed) {
+  std::default_random_engine generator(seed);
+  std::uniform_int_distribution<int> letters('a', 'z');
+  std::uniform_int_distribution<size_t> lengths(4, 16);
+  std::vector<std::string> strings(count);
+  for (auto& s : strings) {
+    s.resize(lengths(generator));
+    for (auto& c : s) {
+      c = static_cast<char>(letters(generator));
+    }
+  }
+  return strings;
+}
+
+static std::vector<std::string> MakeQueries(const std::vector<std::string>& vocabulary) {
+  constexpr size_t n_queries = 100000;
+  std::vector<std::string> misses = MakeStrings(n_queries / 2, 1234);
+  std::vector<std::string> queries;
+  queries.reserve(n_queries);
+  for (size_t i = 0; i < n_queries / 2; ++i) {
+    queries.push_back(vocabulary[(i * 7919) % vocabulary.size()]);
+    queries.push_back(misses[i]);
+  }
+  return queries;
+}
+
+static void BM_LookupUnorderedMap(benchmark::State& state) {
+  const std::vector<std::string> vocabulary = MakeStrings(static_cast<size_t>(state.range(0)), 42);
+  std::unordered_map<std::string, int64_t> map;
+  for (size_t i = 0; i < vocabulary.size(); ++i) {
+    map[vocabulary[i]] = static_cast<int64_t>(i);
+  }
+  const std::vector<std::string> queries = MakeQueries(vocabulary);
+  std::vector<int64_t> out(queries.size());
+
+  for (auto _ : state) {
+    for (size_t i = 0; i < queries.size(); ++i) {
+      auto found = map.find(queries[i]);
+      out[i] = found == map.end() ? -1 : found->second;
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+static void BM_LookupFlatHashTable(benchmark::State& state) {
+  const std::vector<std::string> vocabulary = MakeStrings(static_cast<size_t>(state.range(0)), 42);
+  FlatHashTable<std::string, int64_t> table;
+  table.Reserve(vocabulary.size());
+  for (size_t i = 0; i < vocabulary.size(); ++i) {
+    table.Insert(vocabulary[i], static_cast<int64_t>(i));
+  }
+  const std::vector<std::string> queries = MakeQueries(vocabulary);
+  std::vector<int64_t> out(queries.size());
+
+  for (auto _ : state) {
+    table.FindBatch(gsl::span<const std::string>(queries), int64_t{-1}, gsl::make_span(out), nullptr);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * queries.size());
+}
+
+BENCHMARK(BM_LookupUnorderedMap)->Arg(1000)->Arg(100000)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+BENCHMARK(BM_LookupFlatHashTable)->Arg(1000)->Arg(100000)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
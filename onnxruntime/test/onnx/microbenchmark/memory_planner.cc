@@ -0,0 +1,158 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+// Compares the memory pattern traced by the first Run for the input shapes with the pattern that is planned
+// statically from dim bounds when the session is initialized (session.static_memory_plan.dim_bounds).
+
+#include "common.h"
+
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "core/session/ort_env.h"
+#include <benchmark/benchmark.h>
+
+using namespace onnxruntime;
+extern OrtEnv* env;
+
+namespace {
+
+constexpr int64_t kHiddenSize = 256;
+constexpr int64_t kMaxBatch = 64;
+constexpr int kNumLayers = 8;
+
+// MLP with residual connections and a symbolic batch dim. layer i computes H_i+1 = Relu(H_i x W_i) + H_i.
+std::string CreateModel(const logging::Logger& logger) {
+  Model model("memory_planner", false, logger);
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto activation_type;
+  activation_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  activation_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_param("batch");
+  activation_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kHiddenSize);
+
+  ONNX_NAMESPACE::TypeProto weight_type;
+  weight_type.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  weight_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kHiddenSize);
+  weight_type.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(kHiddenSize);
+
+  std::vector<float> weight_values(static_cast<size_t>(kHiddenSize * kHiddenSize));
+  std::default_random_engine generator(0);
+  std::uniform_real_distribution<float> distribution(-0.05f, 0.05f);
+  std::generate(weight_values.begin(), weight_values.end(), [&]() { return distribution(generator); });
+
+  NodeArg* hidden = &graph.GetOrCreateNodeArg("X", &activation_type);
+  for (int i = 0; i < kNumLayers; ++i) {
+    const std::string layer = std::to_string(i);
+
+    ONNX_NAMESPACE::TensorProto weight;
+    weight.set_name("W" + layer);
+    weight.set_data_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+    weight.add_dims(kHiddenSize);
+    weight.add_dims(kHiddenSize);
+    weight.set_raw_data(weight_values.data(), weight_values.size() * sizeof(float));
+    graph.AddInitializedTensor(weight);
+
+    auto& weight_arg = graph.GetOrCreateNodeArg(weight.name(), &weight_type);
+    auto& matmul_out = graph.GetOrCreateNodeArg("matmul" + layer, &activation_type);
+    auto& relu_out = graph.GetOrCreateNodeArg("relu" + layer, &activation_type);
+    auto& add_out = graph.GetOrCreateNodeArg(i == kNumLayers - 1 ? "Y" : "add" + layer, &activation_type);
+    graph.AddNode("matmul" + layer, "MatMul", "", {hidden, &weight_arg}, {&matmul_out});
+    graph.AddNode("relu" + layer, "Relu", "", {&matmul_out}, {&relu_out});
+    graph.AddNode("add" + layer, "Add", "", {&relu_out, hidden}, {&add_out});
+    hidden = &add_out;
+  }
+
+  ORT_THROW_IF_ERROR(graph.Resolve());
+
+  std::string model_data;
+  model.ToProto().SerializeToString(&model_data);
+  return model_data;
+}
+
+size_t GetPeakSize(const MemoryPatternCache::Entry& entry) {
+  size_t peak_size = 0;
+  for (const auto& pattern : entry.mem_patterns.patterns) {
+    peak_size += pattern.PeakSize();
+  }
+  return peak_size;
+}
+
+void RunModel(benchmark::State& state, bool static_plan) {
+  const int64_t batch = state.range(0);
+  auto logger = env->GetLoggingManager()->CreateLogger("memory_planner");
+  const std::string model_data = CreateModel(*logger);
+
+  SessionOptions so;
+  so.intra_op_param.thread_pool_size = 1;
+  if (static_plan) {
+    ORT_THROW_IF_ERROR(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigStaticMemoryPlanDimBounds,
+                                                        ("batch:" + std::to_string(kMaxBatch)).c_str()));
+  }
+
+  InferenceSession session{so, env->GetEnvironment()};
+  ORT_THROW_IF_ERROR(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ORT_THROW_IF_ERROR(session.Initialize());
+
+  std::vector<OrtValue> feeds(1);
+  Tensor::InitOrtValue(DataTypeImpl::GetType<float>(), TensorShape({batch, kHiddenSize}),
+                       std::make_shared<CPUAllocator>(), feeds[0]);
+  auto input = feeds[0].GetMutable<Tensor>()->MutableDataAsSpan<float>();
+  std::fill(input.begin(), input.end(), 1.f);
+
+  const std::vector<std::string> feed_names{"X"};
+  const std::vector<std::string> output_names{"Y"};
+  RunOptions run_options;
+
+  // the first run traces the memory pattern if it's not planned statically
+  std::vector<OrtValue> fetches;
+  ORT_THROW_IF_ERROR(session.Run(run_options, feed_names, feeds, output_names, &fetches, nullptr));
+
+  const InlinedHashMap<int, TensorShape>* inferred_shapes = nullptr;
+  auto entry = session.GetSessionState().GetMemoryPatternGroup(feeds, {}, inferred_shapes);
+  if (!entry) {
+    state.SkipWithError("No memory pattern was generated.");
+    return;
+  }
+
+  for (auto _ : state) {
+    fetches.clear();
+    auto status = session.Run(run_options, feed_names, feeds, output_names, &fetches, nullptr);
+    if (!status.IsOK()) {
+      state.SkipWithError(status.ErrorMessage().c_str());
+      break;
+    }
+  }
+
+  state.counters["peak_bytes"] = static_cast<double>(GetPeakSize(*entry));
+  if (const auto* stats = session.GetSessionState().GetStaticMemoryPlanStats()) {
+    state.counters["planned_values"] = static_cast<double>(stats->num_planned_values);
+    state.counters["unshared_bytes"] = static_cast<double>(stats->total_size);
+  }
+}
+
+}  // namespace
+
+static void BM_TracedMemoryPattern(benchmark::State& state) {
+  RunModel(state, false);
+}
+
+BENCHMARK(BM_TracedMemoryPattern)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(kMaxBatch);
+
+static void BM_StaticMemoryPlan(benchmark::State& state) {
+  RunModel(state, true);
+}
+
+BENCHMARK(BM_StaticMemoryPlan)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Arg(1)
+    ->Arg(16)
+    ->Arg(kMaxBatch);
@@ -0,0 +1,155 @@
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include "core/mlas/inc/mlas.h"
+#include "core/util/math_cpuonly.h"
+
+// Compares the Eigen expressions used by the CPU Reduce kernels with MlasReduce.
+// The arguments are (outer, reduce, inner): KR is (K, R, 1), RK is (1, R, K) and
+// KRK is (K0, R, K1).
+
+static void ReduceShapes(benchmark::internal::Benchmark* b) {
+  // NLP: reduction over the hidden size of [batch * sequence, hidden].
+  for (int hidden : {768, 1024, 4096}) {
+    b->Args({128, hidden, 1});
+    b->Args({2048, hidden, 1});
+  }
+  // NLP: reduction over the sequence of [sequence, hidden].
+  b->Args({1, 128, 768});
+  b->Args({1, 512, 1024});
+  // Vision: global pooling of [N * C, H * W] and channel reduction of [N, C, H * W].
+  b->Args({64, 3136, 1});
+  b->Args({2048, 49, 1});
+  b->Args({1, 64, 3136});
+  b->Args({8, 256, 196});
+  b->Args({32, 2048, 49});
+}
+
+static void BM_ReduceSumEigen(benchmark::State& state) {
+  const int64_t outer = state.range(0);
+  const int64_t reduce = state.range(1);
+  const int64_t inner = state.range(2);
+  float* data = GenerateArrayWithRandomValue<float>(static_cast<size_t>(outer * reduce * inner), -1, 1);
+  float* output = GenerateArrayWithRandomValue<float>(static_cast<size_t>(outer * inner), -1, 1);
+
+  for (auto _ : state) {
+    if (inner == 1) {
+      // ReduceAggregatorSum::FastReduceKR
+      onnxruntime::EigenVectorMap<float>(output, outer) =
+          onnxruntime::ConstEigenMatrixMap<float>(data, reduce, outer).colwise().sum();
+    } else {
+      // ReduceAggregatorSum::FastReduceRK and FastReduceKRK
+      for (int64_t o = 0; o < outer; ++o) {
+        onnxruntime::EigenVectorMap<float>(output + o * inner, inner) =
+            onnxruntime::ConstEigenMatrixMap<float>(data + o * reduce * inner, inner, reduce).rowwise().sum();
+      }
+    }
+    benchmark::DoNotOptimize(output);
+  }
+  aligned_free(data);
+  aligned_free(output);
+}
+
+BENCHMARK(BM_ReduceSumEigen)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Apply(ReduceShapes);
+
+static void BM_ReduceMaxEigen(benchmark::State& state) {
+  const int64_t outer = state.range(0);
+  const int64_t reduce = state.range(1);
+  const int64_t inner = state.range(2);
+  float* data = GenerateArrayWithRandomValue<float>(static_cast<size_t>(outer * reduce * inner), -1, 1);
+  float* output = GenerateArrayWithRandomValue<float>(static_cast<size_t>(outer * inner), -1, 1);
+
+  for (auto _ : state) {
+    if (inner == 1) {
+      // ReduceAggregatorMax::FastReduceKR
+      onnxruntime::EigenVectorMap<float>(output, outer) =
+          onnxruntime::ConstEigenMatrixMap<float>(data, reduce, outer).colwise().maxCoeff();
+    } else {
+      // ReduceAggregatorMax::FastReduceRK and FastReduceKRK
+      for (int64_t o = 0; o < outer; ++o) {
+        onnxruntime::EigenVectorArrayMap<float> out(output + o * inner, inner);
+        out = onnxruntime::ConstEigenVectorArrayMap<float>(data + o * reduce * inner, inner);
+        for (int64_t r = 1; r < reduce; ++r) {
+          out = out.max(onnxruntime::ConstEigenVectorArrayMap<float>(data + (o * reduce + r) * inner, inner));
+        }
+      }
+    }
+    benchmark::DoNotOptimize(output);
+  }
+  aligned_free(data);
+  aligned_free(output);
+}
+
+BENCHMARK(BM_ReduceMaxEigen)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Apply(ReduceShapes);
+
+static void BM_ReduceLogSumExpLoop(benchmark::State& state) {
+  const int64_t outer = state.range(0);
+  const int64_t reduce = state.range(1);
+  const int64_t inner = state.range(2);
+  float* data = GenerateArrayWithRandomValue<float>(static_cast<size_t>(outer * reduce * inner), -1, 1);
+  float* output = GenerateArrayWithRandomValue<float>(static_cast<size_t>(outer * inner), -1, 1);
+
+  // ReduceAggregatorLogSumExp through the generic loop.
+  for (auto _ : state) {
+    for (int64_t o = 0; o < outer; ++o) {
+      for (int64_t i = 0; i < inner; ++i) {
+        const float* p = data + o * reduce * inner + i;
+        float max = p[0];
+        for (int64_t r = 1; r < reduce; ++r) {
+          max = std::max(max, p[r * inner]);
+        }
+        float sum = 0;
+        for (int64_t r = 0; r < reduce; ++r) {
+          sum += std::exp(p[r * inner] - max);
+        }
+        output[o * inner + i] = std::log(sum) + max;
+      }
+    }
+    benchmark::DoNotOptimize(output);
+  }
+  aligned_free(data);
+  aligned_free(output);
+}
+
+BENCHMARK(BM_ReduceLogSumExpLoop)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Apply(ReduceShapes);
+
+template <MLAS_REDUCTION_KIND Kind>
+static void BM_ReduceMlas(benchmark::State& state) {
+  const size_t outer = static_cast<size_t>(state.range(0));
+  const size_t reduce = static_cast<size_t>(state.range(1));
+  const size_t inner = static_cast<size_t>(state.range(2));
+  float* data = GenerateArrayWithRandomValue<float>(outer * reduce * inner, -1, 1);
+  float* output = GenerateArrayWithRandomValue<float>(outer * inner, -1, 1);
+
+  for (auto _ : state) {
+    MlasReduce(Kind, data, output, outer, reduce, inner, inner);
+    benchmark::DoNotOptimize(output);
+  }
+  aligned_free(data);
+  aligned_free(output);
+}
+
+BENCHMARK_TEMPLATE(BM_ReduceMlas, MlasSumReduction)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Apply(ReduceShapes);
+
+BENCHMARK_TEMPLATE(BM_ReduceMlas, MlasMaximumReduction)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Apply(ReduceShapes);
+
+BENCHMARK_TEMPLATE(BM_ReduceMlas, MlasLogSumExpReduction)
+    ->UseRealTime()
+    ->Unit(benchmark::TimeUnit::kMicrosecond)
+    ->Apply(ReduceShapes);
@@ -0,0 +1,113 @@
+#include "common.h"
+
+#include <benchmark/benchmark.h>
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "core/providers/cpu/ml/tree_ensemble_common.h"
+
+using namespace onnxruntime;
+
+// Compares the node by node traversal of TreeEnsembleCommon with the predicated
+// traversal of TreeEnsemblePredicated on a GBDT like ensemble: 500 complete trees of
+// depth 6 or 8 on 64 features, one target, summed. The arguments are (rows, depth).
+
+class TreeEnsembleBenchmark : public ml::detail::TreeEnsembleCommon<float, float, float> {
+ public:
+  TreeEnsembleBenchmark(int64_t n_trees, int depth, int64_t n_features) {
+    std::default_random_engine generator(static_cast<unsigned>(depth));
+    std::uniform_int_distribution<int64_t> features(0, n_features - 1);
+    std::normal_distribution<float> values(0.0f, 1.0f);
+    std::vector<int64_t> falsenodeids, featureids, nodeids, treeids, truenodeids;
+    std::vector<std::string> modes;
+    std::vector<float> thresholds;
+    std::vector<int64_t> target_ids, target_nodeids, target_treeids;
+    std::vector<float> target_weights;
+
+    // Node k of a tree has the children 2k+1 and 2k+2.
+    const int64_t n_branches = (int64_t(1) << depth) - 1;
+    const int64_t n_nodes = (int64_t(1) << (depth + 1)) - 1;
+    for (int64_t tree = 0; tree < n_trees; ++tree) {
+      for (int64_t node = 0; node < n_nodes; ++node) {
+        treeids.push_back(tree);
+        nodeids.push_back(node);
+        if (node < n_branches) {
+          modes.push_back("BRANCH_LEQ");
+          featureids.push_back(features(generator));
+          thresholds.push_back(values(generator));
+          truenodeids.push_back(2 * node + 1);
+          falsenodeids.push_back(2 * node + 2);
+        } else {
+          modes.push_back("LEAF");
+          featureids.push_back(0);
+          thresholds.push_back(0);
+          truenodeids.push_back(0);
+          falsenodeids.push_back(0);
+          target_treeids.push_back(tree);
+          target_nodeids.push_back(node);
+          target_ids.push_back(0);
+          target_weights.push_back(values(generator));
+        }
+      }
+    }
+    ORT_THROW_IF_ERROR(Init(80, 128, 50, "SUM", {}, {}, 1, falsenodeids, featureids, {}, {}, {}, modes, nodeids,
+                            treeids, truenodeids, thresholds, {}, "NONE", target_ids, target_nodeids,
+                            target_treeids, target_weights, {}));
+    if (!use_predicated_) {
+      ORT_THROW("The ensemble cannot use the predicated traversal.");
+    }
+  }
+
+  void DisablePredicated() { use_predicated_ = false; }
+
+  void Compute(const Tensor* X, Tensor* Y) const {
+    ComputeAgg(nullptr, X, Y, nullptr,
+               ml::detail::TreeAggregatorSum<float, float, float>(roots_.size(), n_targets_or_classes_,
+                                                                  post_transform_, base_values_));
+  }
+};
+
+static void RunTreeEnsemble(benchmark::State& state, bool predicated) {
+  const int64_t n_rows = state.range(0);
+  const int depth = static_cast<int>(state.range(1));
+  constexpr int64_t n_trees = 500;
+  constexpr int64_t n_features = 64;
+
+  TreeEnsembleBenchmark ensemble(n_trees, depth, n_features);
+  if (!predicated) {
+    ensemble.DisablePredicated();
+  }
+
+  AllocatorPtr alloc = std::make_shared<CPUAllocator>();
+  Tensor X(DataTypeImpl::GetType<float>(), TensorShape({n_rows, n_features}), alloc);
+  Tensor Y(DataTypeImpl::GetType<float>(), TensorShape({n_rows, 1}), alloc);
+  std::default_random_engine generator(static_cast<unsigned>(n_rows));
+  std::normal_distribution<float> values(0.0f, 1.0f);
+  float* x_data = X.MutableData<float>();
+  for (int64_t i = 0; i < n_rows * n_features; ++i) {
+    x_data[i] = values(generator);
+  }
+
+  for (auto _ : state) {
+    ensemble.Compute(&X, &Y);
+  }
+  state.SetItemsProcessed(state.iterations() * n_rows);
+}
+
+static void BM_TreeEnsembleTraversal(benchmark::State& state) {
+  RunTreeEnsemble(state, false);
+}
+
+static void BM_TreeEnsemblePredicated(benchmark::State& state) {
+  RunTreeEnsemble(state, true);
+}
+
+static void TreeEnsembleShapes(benchmark::internal::Benchmark* b) {
+  for (int depth : {6, 8}) {
+    for (int rows : {16, 128, 1024, 8192}) {
+      b->Args({rows, depth});
+    }
+  }
+}
+
+BENCHMARK(BM_TreeEnsembleTraversal)->Apply(TreeEnsembleShapes)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
+BENCHMARK(BM_TreeEnsemblePredicated)->Apply(TreeEnsembleShapes)->UseRealTime()->Unit(benchmark::TimeUnit::kMicrosecond);
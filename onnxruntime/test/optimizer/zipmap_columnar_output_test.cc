@@ -0,0 +1,143 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#if !defined(DISABLE_ML_OPS)
+
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "core/framework/tensor.h"
+#include "core/graph/model.h"
+#include "core/session/inference_session.h"
+#include "core/session/onnxruntime_session_options_config_keys.h"
+#include "test/framework/test_utils.h"
+#include "test/test_environment.h"
+#include "test/util/include/asserts.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+namespace {
+
+// Z = ZipMap(Relu(X)) where X is [2, 3], the labels are strings if TKey is std::string and int64 otherwise.
+template <typename TKey>
+void LoadZipMapModel(InferenceSession& session, const std::vector<TKey>& labels) {
+  onnxruntime::Model model("zipmap", false, ModelMetaData(), PathString(), IOnnxRuntimeOpSchemaRegistryList(),
+                           {{kOnnxDomain, 13}, {kMLDomain, 1}}, {}, DefaultLoggingManager().DefaultLogger());
+  auto& graph = model.MainGraph();
+
+  ONNX_NAMESPACE::TypeProto float_tensor;
+  float_tensor.mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(2);
+  float_tensor.mutable_tensor_type()->mutable_shape()->add_dim()->set_dim_value(3);
+
+  ONNX_NAMESPACE::TypeProto seq_map;
+  auto* map_type = seq_map.mutable_sequence_type()->mutable_elem_type()->mutable_map_type();
+  map_type->set_key_type(std::is_same_v<TKey, std::string> ? ONNX_NAMESPACE::TensorProto_DataType_STRING
+                                                            : ONNX_NAMESPACE::TensorProto_DataType_INT64);
+  map_type->mutable_value_type()->mutable_tensor_type()->set_elem_type(ONNX_NAMESPACE::TensorProto_DataType_FLOAT);
+
+  auto& x = graph.GetOrCreateNodeArg("X", &float_tensor);
+  auto& probabilities = graph.GetOrCreateNodeArg("probabilities", &float_tensor);
+  auto& z = graph.GetOrCreateNodeArg("Z", &seq_map);
+  graph.AddNode("relu", "Relu", "probabilities = Relu(X)", {&x}, {&probabilities});
+  auto& zipmap = graph.AddNode("zipmap", "ZipMap", "Z = ZipMap(probabilities)", {&probabilities}, {&z}, nullptr,
+                               kMLDomain);
+  if constexpr (std::is_same_v<TKey, std::string>) {
+    zipmap.AddAttribute("classlabels_strings", gsl::make_span(labels));
+  } else {
+    zipmap.AddAttribute("classlabels_int64s", gsl::make_span(labels));
+  }
+  ASSERT_STATUS_OK(graph.Resolve());
+
+  std::string model_data;
+  ASSERT_TRUE(model.ToProto().SerializeToString(&model_data));
+  ASSERT_STATUS_OK(session.Load(model_data.data(), static_cast<int>(model_data.size())));
+  ASSERT_STATUS_OK(session.Initialize());
+}
+
+std::vector<OrtValue> RunZipMapModel(InferenceSession& session, const std::vector<std::string>& output_names) {
+  auto allocator = TestCPUExecutionProvider()->GetAllocator(OrtMemTypeDefault);
+  std::vector<OrtValue> feeds(1);
+  CreateMLValue<float>(allocator, {2, 3}, {0.1f, 0.2f, 0.7f, 0.6f, 0.3f, 0.1f}, &feeds[0]);
+
+  std::vector<OrtValue> fetches;
+  EXPECT_STATUS_OK(session.Run(RunOptions{}, {"X"}, feeds, output_names, &fetches));
+  return fetches;
+}
+
+void ExpectColumnarProbabilities(const OrtValue& value) {
+  ASSERT_TRUE(value.IsTensor());
+  const auto& probabilities = value.Get<Tensor>();
+  EXPECT_EQ(probabilities.Shape(), TensorShape({2, 3}));
+  const auto data = probabilities.DataAsSpan<float>();
+  EXPECT_EQ(std::vector<float>(data.begin(), data.end()), (std::vector<float>{0.1f, 0.2f, 0.7f, 0.6f, 0.3f, 0.1f}));
+}
+
+}  // namespace
+
+TEST(ZipMapColumnarOutputTest, StringLabels) {
+  SessionOptions so;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigZipMapColumnarOutput, "1"));
+  InferenceSession session{so, GetEnvironment()};
+  LoadZipMapModel<std::string>(session, {"c", "a", "b"});
+
+  // the labels output is added after the outputs of the model
+  auto outputs = session.GetModelOutputs();
+  ASSERT_STATUS_OK(outputs.first);
+  ASSERT_EQ(outputs.second->size(), size_t{2});
+  EXPECT_EQ((*outputs.second)[0]->Name(), "Z");
+  EXPECT_EQ((*outputs.second)[1]->Name(), "Z_labels");
+
+  auto fetches = RunZipMapModel(session, {"Z", "Z_labels"});
+  ASSERT_EQ(fetches.size(), size_t{2});
+  ExpectColumnarProbabilities(fetches[0]);
+
+  // the labels are in the column order, not sorted as the keys of the maps
+  const auto& labels = fetches[1].Get<Tensor>();
+  EXPECT_EQ(labels.Shape(), TensorShape({3}));
+  const auto label_data = labels.DataAsSpan<std::string>();
+  EXPECT_EQ(std::vector<std::string>(label_data.begin(), label_data.end()), (std::vector<std::string>{"c", "a", "b"}));
+}
+
+TEST(ZipMapColumnarOutputTest, Int64LabelsWithoutOptimizations) {
+  // the outputs of the model must not depend on the optimization level
+  SessionOptions so;
+  so.graph_optimization_level = TransformerLevel::Default;
+  ASSERT_STATUS_OK(so.config_options.AddConfigEntry(kOrtSessionOptionsConfigZipMapColumnarOutput, "1"));
+  InferenceSession session{so, GetEnvironment()};
+  LoadZipMapModel<int64_t>(session, {10, 20, 10});
+
+  auto fetches = RunZipMapModel(session, {"Z_labels", "Z"});
+  ASSERT_EQ(fetches.size(), size_t{2});
+  ExpectColumnarProbabilities(fetches[1]);
+
+  // a repeated label is repeated in the labels output
+  const auto label_data = fetches[0].Get<Tensor>().DataAsSpan<int64_t>();
+  EXPECT_EQ(std::vector<int64_t>(label_data.begin(), label_data.end()), (std::vector<int64_t>{10, 20, 10}));
+}
+
+TEST(ZipMapColumnarOutputTest, DisabledByDefault) {
+  SessionOptions so;
+  InferenceSession session{so, GetEnvironment()};
+  LoadZipMapModel<std::string>(session, {"c", "a", "b"});
+
+  auto outputs = session.GetModelOutputs();
+  ASSERT_STATUS_OK(outputs.first);
+  ASSERT_EQ(outputs.second->size(), size_t{1});
+
+  auto fetches = RunZipMapModel(session, {"Z"});
+  ASSERT_EQ(fetches.size(), size_t{1});
+  const auto& rows = fetches[0].Get<std::vector<std::map<std::string, float>>>();
+  ASSERT_EQ(rows.size(), size_t{2});
+  EXPECT_EQ(rows[1], (std::map<std::string, float>{{"a", 0.3f}, {"b", 0.1f}, {"c", 0.6f}}));
+}
+
+}  // namespace test
+}  // namespace onnxruntime
+
+#endif  // !defined(DISABLE_ML_OPS)
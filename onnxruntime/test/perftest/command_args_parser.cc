@@ -104,6 +104,9 @@ namespace perftest {
       "\t\t The number of affinities must be equal to intra_op_num_threads - 1\n\n"
       "\t-D [Disable thread spinning]: disable spinning entirely for thread owned by onnxruntime intra-op thread pool.\n"
       "\t-Z [Force thread to stop spinning between runs]: disallow thread from spinning during runs to reduce cpu usage.\n"
+      "\t-Q [requests_per_second]: Issue asynchronous runs at a fixed rate, regardless of when earlier runs complete, and\n"
+      "\t\t report the latency of each run from the time it was scheduled. Uses the RunAsync API. The runs are executed on\n"
+      "\t\t the intra op thread pool, or on a dedicated thread pool with [parallel runs] threads if -c is greater than 1.\n"
       "\t-h: help\n");
 }
 #ifdef _WIN32
@@ -133,7 +136,7 @@ static bool ParseDimensionOverride(std::basic_string<ORTCHAR_T>& dim_identifier,
 
 /*static*/ bool CommandLineParser::ParseArguments(PerformanceTestConfig& test_config, int argc, ORTCHAR_T* argv[]) {
   int ch;
-  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:AMPIDZvhsqz"))) != -1) {
+  while ((ch = getopt(argc, argv, ORT_TSTR("b:m:e:r:t:p:x:y:c:d:o:u:i:f:F:S:T:Q:AMPIDZvhsqz"))) != -1) {
     switch (ch) {
       case 'f': {
         std::basic_string<ORTCHAR_T> dim_name;
@@ -308,6 +311,12 @@ static bool ParseDimensionOverride(std::basic_string<ORTCHAR_T>& dim_identifier,
       case 'Z':
         test_config.run_config.disable_spinning_between_run = true;
         break;
+      case 'Q':
+        test_config.run_config.target_qps = OrtStrtod<PATH_CHAR_TYPE>(optarg, nullptr);
+        if (test_config.run_config.target_qps <= 0) {
+          return false;
+        }
+        break;
       case '?':
       case 'h':
       default:
@@ -32,6 +32,37 @@ std::chrono::duration<double> OnnxRuntimeTestSession::Run() {
   return duration_seconds;
 }
 
+void OnnxRuntimeTestSession::RunAsync(std::function<void(const Status&)>&& on_completed) {
+  // Randomly pick one OrtValueArray from test_inputs_. (NOT ThreadSafe)
+  const std::uniform_int_distribution<int>::param_type p(0, static_cast<int>(test_inputs_.size() - 1));
+  const size_t id = static_cast<size_t>(dist_(rand_engine_, p));
+  auto& input = test_inputs_.at(id);
+
+  using OnCompleted = std::function<void(const Status&)>;
+  auto context = std::make_unique<OnCompleted>(std::move(on_completed));
+  RunAsyncCallbackFn callback = [](void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status) {
+    std::unique_ptr<OnCompleted> on_completed{static_cast<OnCompleted*>(user_data)};
+    for (size_t i = 0; i < num_outputs; ++i) {
+      Ort::Value output{outputs[i]};  // release the output
+    }
+
+    Ort::Status run_status{status};
+    (*on_completed)(run_status.IsOK() ? Status::OK()
+                                      : ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, run_status.GetErrorMessage()));
+  };
+
+  std::vector<Ort::Value> outputs;
+  outputs.reserve(output_names_raw_ptr.size());
+  for (size_t i = 0; i < output_names_raw_ptr.size(); ++i) {
+    outputs.emplace_back(nullptr);
+  }
+
+  session_.RunAsync(Ort::RunOptions{nullptr}, input_names_.data(), input.data(), input_names_.size(),
+                    output_names_raw_ptr.data(), outputs.data(), outputs.size(), callback, context.get());
+  // owned by the callback from here on
+  context.release();
+}
+
 OnnxRuntimeTestSession::OnnxRuntimeTestSession(Ort::Env& env, std::random_device& rd,
                                                const PerformanceTestConfig& performance_test_config,
                                                const TestModelInfo& m)
@@ -647,6 +678,13 @@ select from 'TF8', 'TF16', 'UINT8', 'FLOAT', 'ITENSOR'. \n)");
     session_options.AddConfigEntry(kOrtSessionOptionsConfigForceSpinningStop, "1");
   }
 
+  if (performance_test_config.run_config.target_qps > 0 &&
+      performance_test_config.run_config.concurrent_session_runs > 1) {
+    fprintf(stdout, "Setting async run threads to %zu\n", performance_test_config.run_config.concurrent_session_runs);
+    session_options.AddConfigEntry(kOrtSessionOptionsConfigAsyncRunNumThreads,
+                                   std::to_string(performance_test_config.run_config.concurrent_session_runs).c_str());
+  }
+
   if (performance_test_config.run_config.execution_mode == ExecutionMode::ORT_PARALLEL && performance_test_config.run_config.inter_op_num_threads > 0) {
     fprintf(stdout, "Setting inter_op_num_threads to %d\n", performance_test_config.run_config.inter_op_num_threads);
     session_options.SetInterOpNumThreads(performance_test_config.run_config.inter_op_num_threads);
@@ -31,6 +31,8 @@ class OnnxRuntimeTestSession : public TestSession {
 
   std::chrono::duration<double> Run() override;
 
+  void RunAsync(std::function<void(const Status&)>&& on_completed) override;
+
   ORT_DISALLOW_COPY_ASSIGNMENT_AND_MOVE(OnnxRuntimeTestSession);
 
  private:
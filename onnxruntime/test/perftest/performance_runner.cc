@@ -8,6 +8,7 @@
 
 #include "performance_runner.h"
 #include <iostream>
+#include <thread>
 
 #include "TestCase.h"
 #include "TFModelInfo.h"
@@ -123,15 +124,19 @@ Status PerformanceRunner::Run() {
   performance_result_.start = std::chrono::high_resolution_clock::now();
 
   std::unique_ptr<utils::ICPUUsage> p_ICPUUsage = utils::CreateICPUUsage();
-  switch (performance_test_config_.run_config.test_mode) {
-    case TestMode::kFixDurationMode:
-      ORT_RETURN_IF_ERROR(FixDurationTest());
-      break;
-    case TestMode::KFixRepeatedTimesMode:
-      ORT_RETURN_IF_ERROR(RepeatedTimesTest());
-      break;
-    default:
-      return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+  if (performance_test_config_.run_config.target_qps > 0) {
+    ORT_RETURN_IF_ERROR(RunOpenLoop());
+  } else {
+    switch (performance_test_config_.run_config.test_mode) {
+      case TestMode::kFixDurationMode:
+        ORT_RETURN_IF_ERROR(FixDurationTest());
+        break;
+      case TestMode::KFixRepeatedTimesMode:
+        ORT_RETURN_IF_ERROR(RepeatedTimesTest());
+        break;
+      default:
+        return ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "unknown test mode.");
+    }
   }
   performance_result_.end = std::chrono::high_resolution_clock::now();
 
@@ -247,6 +252,81 @@ Status PerformanceRunner::ForkJoinRepeat() {
   return Status::OK();
 }
 
+Status PerformanceRunner::RunOpenLoop() {
+  // Issue runs at a fixed rate without waiting for earlier runs to complete, so a session that falls behind builds up
+  // a queue instead of slowing down the request rate. The latency of each run is measured from the time it was
+  // scheduled, which includes the time it was delayed by the queue.
+  using Clock = std::chrono::high_resolution_clock;
+  const auto& run_config = performance_test_config_.run_config;
+  const std::chrono::duration<double> interval(1.0 / run_config.target_qps);
+  const std::chrono::duration<double> duration(static_cast<double>(run_config.duration_in_seconds));
+
+  OrtMutex m;
+  OrtCondVar cv;
+  size_t in_flight = 0;
+  Status status;
+
+  const auto start = Clock::now();
+  for (size_t i = 0;; ++i) {
+    const auto scheduled = start + std::chrono::duration_cast<Clock::duration>(interval * static_cast<double>(i));
+    if (run_config.test_mode == TestMode::KFixRepeatedTimesMode ? i >= run_config.repeated_times
+                                                                : scheduled - start >= duration) {
+      break;
+    }
+
+    std::this_thread::sleep_until(scheduled);
+
+    {
+      std::lock_guard<OrtMutex> lg(m);
+      ++in_flight;
+    }
+
+    auto on_completed = [this, scheduled, &m, &cv, &in_flight, &status](const Status& run_status) {
+      std::chrono::duration<double> latency = Clock::now() - scheduled;
+      if (run_status.IsOK()) {
+        std::lock_guard<OrtMutex> guard(results_mutex_);
+        performance_result_.time_costs.emplace_back(latency.count());
+        performance_result_.total_time_cost += latency.count();
+      }
+
+      std::lock_guard<OrtMutex> lg(m);
+      if (!run_status.IsOK() && status.IsOK()) {
+        status = run_status;
+      }
+
+      --in_flight;
+      cv.notify_all();
+    };
+
+    Status run_status;
+    ORT_TRY {
+      session_->RunAsync(std::move(on_completed));
+    }
+    ORT_CATCH(const std::exception& ex) {
+      ORT_HANDLE_EXCEPTION([&]() {
+        run_status = ORT_MAKE_STATUS(ONNXRUNTIME, FAIL, "PerformanceRunner::RunOpenLoop caught exception: ", ex.what());
+      });
+    }
+
+    std::lock_guard<OrtMutex> lg(m);
+    if (!run_status.IsOK()) {
+      status = run_status;
+      --in_flight;
+    }
+
+    if (!status.IsOK()) {
+      break;
+    }
+  }
+
+  // Join
+  std::unique_lock<OrtMutex> lock(m);
+  cv.wait(lock, [&in_flight]() { return in_flight == 0; });
+
+  std::cout << "Target number of inferences per second: " << run_config.target_qps << "\n";
+  return status;
+}
+
 static std::unique_ptr<TestModelInfo> CreateModelInfo(const PerformanceTestConfig& performance_test_config_) {
   if (CompareCString(performance_test_config_.backend.c_str(), ORT_TSTR("ort")) == 0) {
     const auto& file_path = performance_test_config_.model_info.model_file_path;
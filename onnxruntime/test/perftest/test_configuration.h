@@ -61,6 +61,7 @@ struct RunConfig {
   std::string intra_op_thread_affinities;
   bool disable_spinning = false;
   bool disable_spinning_between_run = false;
+  double target_qps{0};  // issue asynchronous runs at this rate if greater than 0
 };
 
 struct PerformanceTestConfig {
@@ -3,7 +3,9 @@
 
 #pragma once
 #include <stdlib.h>
+#include <functional>
 
+#include "core/common/common.h"
 #include "OrtValueList.h"
 
 namespace onnxruntime {
@@ -11,6 +13,10 @@ namespace perftest {
 class TestSession {
  public:
   virtual std::chrono::duration<double> Run() = 0;
+  // Start a run and return without waiting for it. on_completed is called from another thread when it completes.
+  virtual void RunAsync(std::function<void(const Status&)>&& /*on_completed*/) {
+    ORT_NOT_IMPLEMENTED("RunAsync is not supported by this backend");
+  }
   // TODO: implement it
   // This function won't return duration, because it may vary largely.
   // Please measure the perf at a higher level.
@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include "core/platform/numa_topology.h"
+
+#include <fstream>
+
+#include "core/platform/path_lib.h"
+#include "test/util/include/asserts.h"
+#include "test/util/include/temp_dir.h"
+
+#include "gtest/gtest.h"
+
+namespace onnxruntime {
+namespace test {
+
+TEST(NumaTopologyTest, ParseCpuList) {
+  LogicalProcessors processors;
+  ASSERT_STATUS_OK(ParseCpuList("0-3,8,10-11\n", processors));
+  EXPECT_EQ(processors, (LogicalProcessors{0, 1, 2, 3, 8, 10, 11}));
+
+  ASSERT_STATUS_OK(ParseCpuList("", processors));
+  EXPECT_TRUE(processors.empty());
+
+  EXPECT_FALSE(ParseCpuList("3-1", processors).IsOK());
+  EXPECT_FALSE(ParseCpuList("0-", processors).IsOK());
+  EXPECT_FALSE(ParseCpuList("a", processors).IsOK());
+  EXPECT_FALSE(ParseCpuList("-1", processors).IsOK());
+}
+
+TEST(NumaTopologyTest, ParseNumaTopology) {
+  NumaTopology topology;
+  ASSERT_STATUS_OK(ParseNumaTopology("0-3;;4-7", topology));
+  ASSERT_EQ(topology.size(), size_t{3});
+  EXPECT_EQ(topology[0], (LogicalProcessors{0, 1, 2, 3}));
+  EXPECT_TRUE(topology[1].empty());
+  EXPECT_EQ(topology[2], (LogicalProcessors{4, 5, 6, 7}));
+  EXPECT_EQ(GetNumberOfNumaNodesWithProcessors(topology), size_t{2});
+
+  EXPECT_EQ(GetNumaNodeOfProcessor(topology, 2), 0);
+  EXPECT_EQ(GetNumaNodeOfProcessor(topology, 5), 2);
+  EXPECT_EQ(GetNumaNodeOfProcessor(topology, 8), -1);
+
+  EXPECT_FALSE(ParseNumaTopology("0-3;x", topology).IsOK());
+}
+
+TEST(NumaTopologyTest, ReadNumaTopologyFromSysfs) {
+  // emulate the sysfs layout of a two node system
+  TemporaryDirectory tmp_dir{ORT_TSTR("numa_topology_test_sysfs")};
+  const std::string node_dir = PathToUTF8String(tmp_dir.Path());
+
+  auto write_file = [](const std::string& path, const std::string& content) {
+    std::ofstream file(path);
+    file << content << "\n";
+  };
+
+  write_file(node_dir + "/online", "0-1");
+  for (const auto& [node, cpu_list] : {std::make_pair(0, "0-1,4-5"), std::make_pair(1, "2-3,6-7")}) {
+    const std::string dir = MakeString(node_dir, "/node", node);
+    ASSERT_STATUS_OK(Env::Default().CreateFolder(dir));
+    write_file(dir + "/cpulist", cpu_list);
+  }
+
+  NumaTopology topology;
+  ASSERT_STATUS_OK(ReadNumaTopologyFromSysfs(node_dir, topology));
+  ASSERT_EQ(topology.size(), size_t{2});
+  EXPECT_EQ(topology[0], (LogicalProcessors{0, 1, 4, 5}));
+  EXPECT_EQ(topology[1], (LogicalProcessors{2, 3, 6, 7}));
+
+  EXPECT_FALSE(ReadNumaTopologyFromSysfs(node_dir + "/missing", topology).IsOK());
+}
+
+}  // namespace test
+}  // namespace onnxruntime
@@ -12,8 +12,10 @@
 
 #include "gtest/gtest.h"
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <functional>
+#include <thread>
 
 #ifdef _WIN32
 #include <Windows.h>
@@ -510,6 +512,67 @@ TEST(ThreadPoolTest, TestStagedMultiLoopSections_4Thread_100Loop) {
   TestStagedMultiLoopSections("TestStagedMultiLoopSections_4Thread_100Loop", 4, 100);
 }
 
+// Work scheduled by a thread bound to a NUMA node runs on the workers of that node
+TEST(ThreadPoolTest, TestNumaNodeBinding_Schedule) {
+  constexpr int num_tasks = 100;
+  onnxruntime::ThreadOptions to;
+  to.numa_nodes = {0, 0, 1, 1};
+
+  for (int numa_node : {0, 1}) {
+    // a new pool for each node so that no worker has been woken up and can steal from the other node
+    ThreadPoolTempl<onnxruntime::Env> tp(nullptr, 4, true, onnxruntime::Env::Default(), to);
+    ThreadPool::NumaNodeBinding numa_node_binding(numa_node);
+
+    std::vector<int> ran_on(num_tasks, -1);
+    std::atomic<int> num_done{0};
+    for (int i = 0; i < num_tasks; i++) {
+      tp.Schedule([&, i]() {
+        ran_on[i] = tp.CurrentThreadId();
+        num_done++;
+      });
+    }
+    while (num_done < num_tasks) {
+      std::this_thread::yield();
+    }
+
+    for (int thread_id : ran_on) {
+      ASSERT_GE(thread_id, 0);
+      EXPECT_EQ(to.numa_nodes[thread_id], numa_node);
+    }
+  }
+}
+
+TEST(ThreadPoolTest, TestNumaNodeBinding_ParallelFor) {
+  constexpr int num_tasks = 1000;
+  onnxruntime::ThreadOptions to;
+  // the first entry is for the main thread
+  to.numa_nodes = {-1, 0, 0, 1, 1};
+  auto tp = std::make_unique<ThreadPool>(&onnxruntime::Env::Default(), to, nullptr, 5, true);
+
+  for (int numa_node : {-1, 0, 1}) {
+    ThreadPool::NumaNodeBinding numa_node_binding(numa_node);
+    auto test_data = CreateTestData(num_tasks);
+    ThreadPool::TrySimpleParallelFor(tp.get(), num_tasks, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+    ValidateTestData(*test_data);
+  }
+}
+
+TEST(ThreadPoolTest, TestNumaAwareThreadPoolCreation) {
+  constexpr int num_tasks = 1000;
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 5;
+  tpo.numa_aware = true;
+  // both nodes use processor 0 so the thread affinity can be set on any machine
+  tpo.numa_topology_str = "0;0";
+  auto tp = onnxruntime::concurrency::CreateThreadPool(&onnxruntime::Env::Default(), tpo, ThreadPoolType::INTRA_OP);
+  ASSERT_NE(tp, nullptr);
+
+  ThreadPool::NumaNodeBinding numa_node_binding(1);
+  auto test_data = CreateTestData(num_tasks);
+  ThreadPool::TrySimpleParallelFor(tp.get(), num_tasks, [&](std::ptrdiff_t i) { IncrementElement(*test_data, i); });
+  ValidateTestData(*test_data);
+}
+
 #ifdef _WIN32
 #if WINAPI_FAMILY_PARTITION(WINAPI_PARTITION_DESKTOP)
 #pragma warning(push)
@@ -147,6 +147,23 @@ TEST(GemmOpTest, GemmNoTrans_bfloat16) {
 }
 #endif  // USE_CUDA USE_RCOM USE_DNNL
 
+TEST(GemmOpTest, GemmTransBroadcast_bfloat16_Cpu) {
+  // Integer values are exact in bfloat16 and in the fp32 accumulators.
+  OpTester test("Gemm", 13);
+  test.AddAttribute("transA", (int64_t)1);
+  test.AddAttribute("transB", (int64_t)1);
+  test.AddAttribute("alpha", 2.0f);
+  test.AddAttribute("beta", 0.5f);
+  test.AddInput<BFloat16>("A", {4, 2}, MakeBFloat16({1.0f, -1.0f, 2.0f, -2.0f, 3.0f, -3.0f, 4.0f, -4.0f}));
+  test.AddInput<BFloat16>("B", {3, 4}, MakeBFloat16({1.f, 1.f, 1.f, 1.f, 1.f, 0.f, 1.f, 0.f, 0.f, 0.f, 0.f, 2.f}),
+                          true);
+  test.AddInput<BFloat16>("C", {3}, MakeBFloat16({2.f, 4.f, -2.f}));
+  test.AddOutput<BFloat16>("Y", {2, 3}, MakeBFloat16({21.0f, 10.0f, 15.0f, -19.0f, -6.0f, -17.0f}));
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 template <typename T>
 void TestGemmBroadcast() {
   auto run_test = [](bool b_is_initializer, bool c_is_initializer) {
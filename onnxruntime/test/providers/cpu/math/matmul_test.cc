@@ -8,6 +8,7 @@
 #include "test/common/cuda_op_test_utils.h"
 #include "test/common/tensor_op_test_utils.h"
 #include "default_providers.h"
+#include "core/mlas/inc/mlas.h"
 
 namespace onnxruntime {
 namespace test {
@@ -220,6 +221,37 @@ TEST(MathOpTest, MatMulUint64Type) {
   RunMatMulTest<uint64_t>(9);
 }
 
+#ifdef MLAS_F16GEMM_SUPPORTED
+// Runs the float test cases as fp16 on the CPU EP. All the values are small integers that fp16 represents exactly.
+void RunMatMulFp16Test(int32_t opset_version, bool is_b_constant) {
+  for (auto t : GenerateTestCases<float>()) {
+    SCOPED_TRACE("test case: " + t.name);
+
+    OpTester test("MatMul", opset_version);
+
+    int64_t size0 = TensorShape::FromExistingBuffer(t.input0_dims).SizeHelper(0, t.input0_dims.size());
+    test.AddInput<MLFloat16>("A", t.input0_dims, ToFloat16(ValueRange<float>(size0)));
+
+    int64_t size1 = TensorShape::FromExistingBuffer(t.input1_dims).SizeHelper(0, t.input1_dims.size());
+    test.AddInput<MLFloat16>("B", t.input1_dims, ToFloat16(ValueRange<float>(size1)), is_b_constant);
+
+    test.AddOutput<MLFloat16>("Y", t.expected_dims, ToFloat16(t.expected_vals));
+
+    std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+    execution_providers.push_back(DefaultCpuExecutionProvider());
+    test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+  }
+}
+
+TEST(MathOpTest, MatMulFloat16Cpu) {
+  if (!MlasFp16AccelerationSupported()) {
+    GTEST_SKIP() << "Skipping because the CPU has no half precision GEMM kernel.";
+  }
+  RunMatMulFp16Test(13, false);
+  RunMatMulFp16Test(9, true);
+}
+#endif
+
 #if defined(USE_CUDA) || defined(USE_ROCM)
 TEST(MathOpTest, MatMul_Float16) {
 #ifdef USE_CUDA
@@ -292,6 +324,21 @@ TEST(MathOpTest, MatMul_bfloat16) {
 }
 #endif
 
+TEST(MathOpTest, MatMulBFloat16Cpu) {
+  // Integer values are exact in bfloat16 and in the fp32 accumulators.
+  OpTester test("MatMul", 13);
+
+  test.AddInput<BFloat16>("A", {2, 2, 4}, MakeBFloat16({1.0f, 2.0f, 3.0f, 4.0f, -1.0f, -2.0f, -3.0f, -4.0f,
+                                                        0.0f, 1.0f, 0.0f, 1.0f, 2.0f, 2.0f, 2.0f, 2.0f}));
+  test.AddInput<BFloat16>("B", {4, 3}, MakeBFloat16({1.f, 2.f, 0.f, 1.f, 2.f, 0.f, 1.f, 2.f, 0.f, 1.f, 2.f, 1.f}),
+                          true);
+  test.AddOutput<BFloat16>("Y", {2, 2, 3}, MakeBFloat16({10.0f, 20.0f, 4.0f, -10.0f, -20.0f, -4.0f,
+                                                         2.0f, 4.0f, 1.0f, 8.0f, 16.0f, 2.0f}));
+  std::vector<std::unique_ptr<IExecutionProvider>> execution_providers;
+  execution_providers.push_back(DefaultCpuExecutionProvider());
+  test.Run(OpTester::ExpectResult::kExpectSuccess, "", {}, nullptr, &execution_providers);
+}
+
 #ifndef ENABLE_TRAINING
 // Prepacking is disabled in full training build so no need to test the feature in a training build.
 TEST(MathOpTest, MatMulSharedPrepackedWeights) {
@@ -0,0 +1,222 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// Licensed under the MIT License.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+#include "gtest/gtest.h"
+#include "core/framework/allocator.h"
+#include "core/framework/tensor.h"
+#include "core/providers/cpu/ml/tree_ensemble_common.h"
+#include "core/util/thread_utils.h"
+#include "test/util/include/asserts.h"
+
+namespace onnxruntime {
+namespace test {
+
+// Gives access to both evaluation paths of TreeEnsembleCommon.
+template <typename T>
+class TreeEnsembleCommonTester : public ml::detail::TreeEnsembleCommon<T, T, float> {
+ public:
+  bool UsesPredicated() const { return this->use_predicated_; }
+  void DisablePredicated() { this->use_predicated_ = false; }
+
+  template <template <typename, typename, typename> class AGG>
+  void Compute(concurrency::ThreadPool* tp, const Tensor* X, Tensor* Y) const {
+    this->ComputeAgg(tp, X, Y, nullptr,
+                     AGG<T, T, float>(this->roots_.size(), this->n_targets_or_classes_,
+                                      this->post_transform_, this->base_values_));
+  }
+};
+
+struct RandomTreeEnsemble {
+  std::vector<int64_t> nodes_falsenodeids, nodes_featureids, nodes_missing_value_tracks_true;
+  std::vector<int64_t> nodes_nodeids, nodes_treeids, nodes_truenodeids;
+  std::vector<std::string> nodes_modes;
+  std::vector<float> nodes_values;
+  std::vector<int64_t> target_ids, target_nodeids, target_treeids;
+  std::vector<float> target_weights;
+  size_t tree_begin = 0;
+
+  // Adds a random subtree to tree `tree` and returns the id of its root.
+  int64_t AddNode(std::default_random_engine& generator, int64_t tree, int depth, const std::string& mode,
+                  int64_t n_features, int64_t n_targets, bool missing_tracks) {
+    std::uniform_real_distribution<float> distribution(0.0f, 1.0f);
+    const size_t index = nodes_nodeids.size();
+    const int64_t id = static_cast<int64_t>(index - tree_begin);
+    nodes_treeids.push_back(tree);
+    nodes_nodeids.push_back(id);
+    nodes_missing_value_tracks_true.push_back(missing_tracks && distribution(generator) < 0.3f ? 1 : 0);
+
+    if (depth == 0 || (depth < 4 && distribution(generator) < 0.3f)) {
+      nodes_modes.push_back("LEAF");
+      nodes_featureids.push_back(0);
+      nodes_values.push_back(0);
+      nodes_truenodeids.push_back(0);
+      nodes_falsenodeids.push_back(0);
+      for (int64_t t = 0; t < n_targets; ++t) {
+        target_treeids.push_back(tree);
+        target_nodeids.push_back(id);
+        target_ids.push_back(t);
+        target_weights.push_back(distribution(generator) * 2.0f - 1.0f);
+      }
+      return id;
+    }
+
+    nodes_modes.push_back(mode);
+    nodes_featureids.push_back(static_cast<int64_t>(distribution(generator) * n_features) % n_features);
+    // Few distinct thresholds so that features are often equal to them.
+    nodes_values.push_back(std::floor(distribution(generator) * 8.0f) / 4.0f);
+    nodes_truenodeids.push_back(0);
+    nodes_falsenodeids.push_back(0);
+    int64_t true_id = AddNode(generator, tree, depth - 1, mode, n_features, n_targets, missing_tracks);
+    int64_t false_id = AddNode(generator, tree, depth - 1, mode, n_features, n_targets, missing_tracks);
+    nodes_truenodeids[index] = true_id;
+    nodes_falsenodeids[index] = false_id;
+    return id;
+  }
+
+  RandomTreeEnsemble(int64_t n_trees, int depth, const std::string& mode, int64_t n_features, int64_t n_targets,
+                     bool missing_tracks) {
+    std::default_random_engine generator(static_cast<unsigned>(n_trees * 31 + depth));
+    for (int64_t tree = 0; tree < n_trees; ++tree) {
+      tree_begin = nodes_nodeids.size();
+      AddNode(generator, tree, depth, mode, n_features, n_targets, missing_tracks);
+    }
+  }
+};
+
+template <typename T>
+static void RunPredicatedTest(int64_t n_trees, int depth, const std::string& mode, int64_t n_targets,
+                              bool missing_tracks, int64_t n_rows, concurrency::ThreadPool* tp) {
+  constexpr int64_t n_features = 6;
+  RandomTreeEnsemble ensemble(n_trees, depth, mode, n_features, n_targets, missing_tracks);
+
+  TreeEnsembleCommonTester<T> predicated, traversal;
+  for (auto* tester : {&predicated, &traversal}) {
+    ASSERT_STATUS_OK(tester->Init(
+        80, 128, 50, "SUM", {}, {}, n_targets,
+        ensemble.nodes_falsenodeids, ensemble.nodes_featureids, {}, {},
+        ensemble.nodes_missing_value_tracks_true, ensemble.nodes_modes, ensemble.nodes_nodeids,
+        ensemble.nodes_treeids, ensemble.nodes_truenodeids, ensemble.nodes_values, {}, "NONE",
+        ensemble.target_ids, ensemble.target_nodeids, ensemble.target_treeids, ensemble.target_weights, {}));
+  }
+  ASSERT_TRUE(predicated.UsesPredicated());
+  traversal.DisablePredicated();
+
+  AllocatorPtr alloc = std::make_shared<CPUAllocator>();
+  Tensor X(DataTypeImpl::GetType<T>(), TensorShape({n_rows, n_features}), alloc);
+  std::default_random_engine generator(static_cast<unsigned>(n_rows));
+  std::uniform_real_distribution<float> distribution(-0.5f, 2.5f);
+  T* x_data = X.MutableData<T>();
+  for (int64_t i = 0; i < n_rows * n_features; ++i) {
+    x_data[i] = static_cast<T>(std::floor(distribution(generator) * 8.0f) / 4.0f);
+    if (missing_tracks && i % 7 == 3) {
+      x_data[i] = std::numeric_limits<T>::quiet_NaN();
+    }
+  }
+
+  auto check = [&](auto compute) {
+    Tensor Y(DataTypeImpl::GetType<float>(), TensorShape({n_rows, n_targets}), alloc);
+    Tensor Y_expected(DataTypeImpl::GetType<float>(), TensorShape({n_rows, n_targets}), alloc);
+    compute(predicated, &Y);
+    compute(traversal, &Y_expected);
+    // The scores must be bit identical.
+    ASSERT_EQ(std::memcmp(Y.Data<float>(), Y_expected.Data<float>(), Y.SizeInBytes()), 0)
+        << "trees=" << n_trees << " depth=" << depth << " mode=" << mode << " targets=" << n_targets
+        << " missing=" << missing_tracks << " rows=" << n_rows;
+  };
+  check([&](const TreeEnsembleCommonTester<T>& t, Tensor* Y) {
+    t.template Compute<ml::detail::TreeAggregatorSum>(tp, &X, Y);
+  });
+  check([&](const TreeEnsembleCommonTester<T>& t, Tensor* Y) {
+    t.template Compute<ml::detail::TreeAggregatorAverage>(tp, &X, Y);
+  });
+  check([&](const TreeEnsembleCommonTester<T>& t, Tensor* Y) {
+    t.template Compute<ml::detail::TreeAggregatorMin>(tp, &X, Y);
+  });
+  check([&](const TreeEnsembleCommonTester<T>& t, Tensor* Y) {
+    t.template Compute<ml::detail::TreeAggregatorMax>(tp, &X, Y);
+  });
+}
+
+TEST(MLOpTest, TreeEnsemblePredicatedBitIdentical) {
+  for (const char* mode : {"BRANCH_LEQ", "BRANCH_LT", "BRANCH_GTE", "BRANCH_GT", "BRANCH_EQ", "BRANCH_NEQ"}) {
+    for (int depth : {1, 4, 8}) {
+      for (int64_t n_targets : {1, 3}) {
+        for (bool missing_tracks : {false, true}) {
+          for (int64_t n_rows : {16, 37, 130}) {
+            RunPredicatedTest<float>(20, depth, mode, n_targets, missing_tracks, n_rows, nullptr);
+            RunPredicatedTest<double>(20, depth, mode, n_targets, missing_tracks, n_rows, nullptr);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(MLOpTest, TreeEnsemblePredicatedBitIdenticalThreaded) {
+  OrtThreadPoolParams tpo;
+  tpo.thread_pool_size = 4;
+  std::unique_ptr<concurrency::ThreadPool> tp(
+      concurrency::CreateThreadPool(&onnxruntime::Env::Default(), tpo, concurrency::ThreadPoolType::INTRA_OP));
+  // 2 trees: parallelization by rows, 40 trees: partitions of trees merged per row.
+  for (int64_t n_trees : {2, 40}) {
+    for (int64_t n_targets : {1, 3}) {
+      for (int64_t n_rows : {20, 100, 301}) {
+        RunPredicatedTest<float>(n_trees, 6, "BRANCH_LEQ", n_targets, false, n_rows, tp.get());
+        RunPredicatedTest<double>(n_trees, 6, "BRANCH_LT", n_targets, true, n_rows, tp.get());
+      }
+    }
+  }
+}
+
+TEST(MLOpTest, TreeEnsemblePredicatedNotUsed) {
+  // Mixed modes.
+  {
+    RandomTreeEnsemble ensemble(3, 3, "BRANCH_LEQ", 4, 1, false);
+    size_t branch = std::find(ensemble.nodes_modes.begin(), ensemble.nodes_modes.end(), "BRANCH_LEQ") -
+                    ensemble.nodes_modes.begin();
+    ensemble.nodes_modes[branch] = "BRANCH_GT";
+    TreeEnsembleCommonTester<float> tester;
+    ASSERT_STATUS_OK(tester.Init(
+        80, 128, 50, "SUM", {}, {}, 1,
+        ensemble.nodes_falsenodeids, ensemble.nodes_featureids, {}, {},
+        ensemble.nodes_missing_value_tracks_true, ensemble.nodes_modes, ensemble.nodes_nodeids,
+        ensemble.nodes_treeids, ensemble.nodes_truenodeids, ensemble.nodes_values, {}, "NONE",
+        ensemble.target_ids, ensemble.target_nodeids, ensemble.target_treeids, ensemble.target_weights, {}));
+    ASSERT_FALSE(tester.UsesPredicated());
+  }
+  // Trees deeper than the maximum depth.
+  {
+    RandomTreeEnsemble ensemble(1, 12, "BRANCH_LEQ", 4, 1, false);
+    TreeEnsembleCommonTester<float> tester;
+    ASSERT_STATUS_OK(tester.Init(
+        80, 128, 50, "SUM", {}, {}, 1,
+        ensemble.nodes_falsenodeids, ensemble.nodes_featureids, {}, {},
+        ensemble.nodes_missing_value_tracks_true, ensemble.nodes_modes, ensemble.nodes_nodeids,
+        ensemble.nodes_treeids, ensemble.nodes_truenodeids, ensemble.nodes_values, {}, "NONE",
+        ensemble.target_ids, ensemble.target_nodeids, ensemble.target_treeids, ensemble.target_weights, {}));
+    ASSERT_FALSE(tester.UsesPredicated());
+  }
+  // Feature indices that do not fit in 16 bits.
+  {
+    RandomTreeEnsemble ensemble(3, 3, "BRANCH_LEQ", 4, 1, false);
+    size_t branch = std::find(ensemble.nodes_modes.begin(), ensemble.nodes_modes.end(), "BRANCH_LEQ") -
+                    ensemble.nodes_modes.begin();
+    ensemble.nodes_featureids[branch] = 40000;
+    TreeEnsembleCommonTester<float> tester;
+    ASSERT_STATUS_OK(tester.Init(
+        80, 128, 50, "SUM", {}, {}, 1,
+        ensemble.nodes_falsenodeids, ensemble.nodes_featureids, {}, {},
+        ensemble.nodes_missing_value_tracks_true, ensemble.nodes_modes, ensemble.nodes_nodeids,
+        ensemble.nodes_treeids, ensemble.nodes_truenodeids, ensemble.nodes_values, {}, "NONE",
+        ensemble.target_ids, ensemble.target_nodeids, ensemble.target_treeids, ensemble.target_weights, {}));
+    ASSERT_FALSE(tester.UsesPredicated());
+  }
+}
+
+}  // namespace test
+}  // namespace onnxruntime
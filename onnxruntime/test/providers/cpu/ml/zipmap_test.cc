@@ -55,6 +55,27 @@ TEST(MLOpTest, ZipMapOpInt64Float1D) {
   TestHelper<int64_t>({10, 20, 30, 40, 50, 60}, "int64_t", {6});
 }
 
+// Labels out of order, with a repeated label taking the value of its last column.
+TEST(MLOpTest, ZipMapOpStringFloatUnsortedLabels) {
+  OpTester test("ZipMap", 1, onnxruntime::kMLDomain);
+  test.AddAttribute("classlabels_strings", std::vector<std::string>{"c", "a", "b", "a"});
+  test.AddInput<float>("X", {2, 4}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f});
+  std::vector<std::map<std::string, float>> expected_output{{{"a", 4.f}, {"b", 3.f}, {"c", 1.f}},
+                                                            {{"a", 8.f}, {"b", 7.f}, {"c", 5.f}}};
+  test.AddOutput<std::string, float>("Z", expected_output);
+  test.Run();
+}
+
+TEST(MLOpTest, ZipMapOpInt64FloatUnsortedLabels) {
+  OpTester test("ZipMap", 1, onnxruntime::kMLDomain);
+  test.AddAttribute("classlabels_int64s", std::vector<int64_t>{30, 10, 20, 10});
+  test.AddInput<float>("X", {2, 4}, {1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f});
+  std::vector<std::map<int64_t, float>> expected_output{{{10, 4.f}, {20, 3.f}, {30, 1.f}},
+                                                        {{10, 8.f}, {20, 7.f}, {30, 5.f}}};
+  test.AddOutput<int64_t, float>("Z", expected_output);
+  test.Run();
+}
+
 // Negative test cases
 TEST(MLOpTest, ZipMapOpStringFloatStrideMoreThanNumLabels) {
   TestHelper<string>({"class1", "class2", "class3"}, "string", {1, 6}, OpTester::ExpectResult::kExpectFailure);
@@ -690,6 +690,53 @@ TEST(TfIdfVectorizerTest, String_TFIDFWeights_onlyBigrams_Skip5_2rows) {
   test.Run(OpTester::ExpectResult::kExpectSuccess);
 }
 
+// The same items appear in n-grams of different sizes and twice in the same n-gram.
+TEST(TfIdfVectorizerTest, Int32_TF_RepeatedPoolItems_Skip1) {
+  OpTester test("TfIdfVectorizer", opset_ver);
+  // s=1, Min=1, Max=3, weights empty, int32
+  InitTestAttr(test, "TF", 1, 3, 1,
+               {0, 2, 6},
+               {0, 1, 2, 3, 4},  //5 output indexes
+               {},
+               {5, 6,        //1-grams
+                6, 5, 5, 5,  //bi-grams
+                5, 6, 5},    //tri-grams
+               {});
+
+  std::vector<int64_t> dims{5};
+  std::vector<int32_t> input = {5, 6, 5, 5, 6};
+  test.AddInput<int32_t>("T", dims, input);
+
+  std::vector<int64_t> out_dims{5};
+  std::vector<float> output = {3, 2, 2, 2, 1};
+  test.AddOutput<float>("Y", out_dims, output);
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
+TEST(TfIdfVectorizerTest, String_TF_RepeatedPoolItems_Skip1) {
+  OpTester test("TfIdfVectorizer", opset_ver);
+  // s=1, Min=1, Max=3, weights empty, string
+  InitTestAttr(test, "TF", 1, 3, 1,
+               {0, 2, 6},
+               {0, 1, 2, 3, 4},  //5 output indexes
+               {},
+               {},
+               {"five", "six",                  //1-grams
+                "six", "five", "five", "five",  //bi-grams
+                "five", "six", "five"});        //tri-grams
+
+  std::vector<int64_t> dims{5};
+  std::vector<std::string> input{"five", "six", "five", "five", "six"};
+  test.AddInput<std::string>("T", dims, input);
+
+  std::vector<int64_t> out_dims{5};
+  std::vector<float> output = {3, 2, 2, 2, 1};
+  test.AddOutput<float>("Y", out_dims, output);
+
+  test.Run(OpTester::ExpectResult::kExpectSuccess);
+}
+
 // This test runs the inference 100 times to test the improvement
 // It enables profiling while running inference multiple times.
 // So we can manually inspect the profiling output
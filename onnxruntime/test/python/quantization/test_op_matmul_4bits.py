@@ -0,0 +1,126 @@
+#!/usr/bin/env python
+# -------------------------------------------------------------------------
+# Copyright (c) Microsoft Corporation. All rights reserved.
+# Licensed under the MIT License. See License.txt in the project root for
+# license information.
+# --------------------------------------------------------------------------
+
+import tempfile
+import unittest
+from pathlib import Path
+
+import numpy as np
+import onnx
+from onnx import TensorProto, helper
+from op_test_utils import TestDataFeeds, check_model_correctness, check_op_type_count
+
+from onnxruntime.quantization import matmul_4bits_quantizer
+
+
+class TestOpMatMul4Bits(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        cls._tmp_model_dir = tempfile.TemporaryDirectory(prefix="test_matmul4bits.")
+
+    @classmethod
+    def tearDownClass(cls):
+        cls._tmp_model_dir.cleanup()
+
+    def input_feeds(self, n, name2shape):
+        input_data_list = []
+        for _i in range(n):
+            inputs = {}
+            for name, shape in name2shape.items():
+                inputs.update({name: np.random.uniform(-1.0, 1.0, shape).astype(np.float32)})
+            input_data_list.extend([inputs])
+        dr = TestDataFeeds(input_data_list)
+        return dr
+
+    def construct_model_matmul(self, output_model_path, k=33):
+        #      (input)
+        #         |
+        #       MatMul
+        #         |
+        #      (output)
+        input_name = "input"
+        output_name = "output"
+        initializers = []
+
+        def make_matmul(input_name, weight_shape, weight_name, output_name):
+            weight_data = np.random.normal(0, 0.01, weight_shape).astype(np.float32)
+            initializers.append(onnx.numpy_helper.from_array(weight_data, name=weight_name))
+            return onnx.helper.make_node("MatMul", [input_name, weight_name], [output_name], name="MatMul_0")
+
+        in_features = k
+        out_features = 64
+        matmul_node = make_matmul(input_name, [in_features, out_features], "linear1.weight", output_name)
+
+        input_tensor = helper.make_tensor_value_info(input_name, TensorProto.FLOAT, [-1, in_features])
+        output_tensor = helper.make_tensor_value_info(output_name, TensorProto.FLOAT, [-1, out_features])
+        graph = helper.make_graph([matmul_node], "matmul_test", [input_tensor], [output_tensor], initializer=initializers)
+        model = helper.make_model(graph, opset_imports=[helper.make_opsetid("", 13)])
+        model.ir_version = 7  # use stable onnx ir version
+
+        onnx.save(model, output_model_path)
+
+    def quant_test(self, model_fp32_path, data_reader, block_size, is_symmetric, accuracy_level=0):
+        model_int4_path = str(
+            Path(self._tmp_model_dir.name)
+            .joinpath(f"MatMulNBits_{block_size}_{is_symmetric}_{accuracy_level}.onnx")
+            .absolute()
+        )
+
+        model = onnx.load(model_fp32_path)
+        quant = matmul_4bits_quantizer.MatMul4BitsQuantizer(model, block_size, is_symmetric, accuracy_level)
+        quant.process()
+        quant.model.save_model_to_file(model_int4_path, False)
+
+        check_op_type_count(self, model_int4_path, MatMul=0, MatMulNBits=1)
+
+        nbits_node = next(node for node in onnx.load(model_int4_path).graph.node if node.op_type == "MatMulNBits")
+        self.assertEqual(len(nbits_node.input), 3 if is_symmetric else 4)
+
+        data_reader.rewind()
+        check_model_correctness(self, model_fp32_path, model_int4_path, data_reader.get_next())
+
+    def test_int4_block_quant_layout(self):
+        quant = matmul_4bits_quantizer.MatMul4BitsQuantizer(onnx.ModelProto(), 16, False)
+        weight = np.random.uniform(-1.0, 1.0, (40, 3)).astype(np.float32)
+        packed, scales, zero_points = quant.int4_block_quant(weight)
+
+        self.assertEqual(packed.shape, (3, 3, 8))
+        self.assertEqual(scales.shape, (9,))
+        self.assertEqual(zero_points.shape, (6,))
+
+        # dequantize and compare against the original weight
+        scales = scales.reshape(3, 3)
+        zero_points = np.stack([zero_points & 0x0F, zero_points >> 4], axis=-1).reshape(3, 4)[:, :3]
+        quant_values = np.stack([packed & 0x0F, packed >> 4], axis=-1).reshape(3, 3, 16).astype(np.float32)
+        dequant = (quant_values - zero_points[:, :, None]) * scales[:, :, None]
+        dequant = dequant.reshape(3, 48)[:, :40].T
+        np.testing.assert_allclose(dequant, weight, atol=scales.max())
+
+    def test_quantize_matmul_int4_symmetric(self):
+        np.random.seed(13)
+        model_fp32_path = str(Path(self._tmp_model_dir.name).joinpath("matmul_fp32_symmetric.onnx").absolute())
+        self.construct_model_matmul(model_fp32_path)
+        data_reader = self.input_feeds(1, {"input": [100, 33]})
+        self.quant_test(model_fp32_path, data_reader, 32, True)
+
+    def test_quantize_matmul_int4_offsets(self):
+        np.random.seed(13)
+        model_fp32_path = str(Path(self._tmp_model_dir.name).joinpath("matmul_fp32_offset.onnx").absolute())
+        self.construct_model_matmul(model_fp32_path)
+        data_reader = self.input_feeds(1, {"input": [100, 33]})
+        self.quant_test(model_fp32_path, data_reader, 32, False)
+
+    def test_quantize_matmul_int4_accuracy_level4(self):
+        np.random.seed(13)
+        model_fp32_path = str(Path(self._tmp_model_dir.name).joinpath("matmul_fp32_level4.onnx").absolute())
+        self.construct_model_matmul(model_fp32_path, k=256)
+        data_reader = self.input_feeds(1, {"input": [10, 256]})
+        self.quant_test(model_fp32_path, data_reader, 64, False, 4)
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -10,6 +10,7 @@
 #include <mutex>
 #include <algorithm>
 #include <thread>
+#include <future>
 
 #include "gtest/gtest.h"
 #include "gmock/gmock.h"
@@ -1635,6 +1636,178 @@ TEST(CApiTest, io_binding) {
   binding.ClearBoundOutputs();
 }
 
+TEST(CApiTest, prepared_run) {
+  Ort::SessionOptions session_options;
+  Ort::ThrowOnError(OrtSessionOptionsAppendExecutionProvider_CPU(session_options, 1));
+  Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+  Ort::PreparedRun prepared_run(session, input_names, 1, output_names, 1);
+
+  Ort::MemoryInfo info_cpu = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemTypeDefault);
+
+  const std::array<int64_t, 2> x_shape = {3, 2};
+  std::array<float, 3 * 2> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  Ort::Value x = Ort::Value::CreateTensor(info_cpu, x_values.data(), x_values.size(),
+                                          x_shape.data(), x_shape.size());
+
+  const std::array<float, 3 * 2> expected_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  // outputs allocated by ORT
+  {
+    std::vector<Ort::Value> output_values = session.Run(Ort::RunOptions(), prepared_run, &x, 1, 1);
+    ASSERT_EQ(output_values.size(), 1U);
+    const Ort::Value& Y_value = output_values[0];
+    ASSERT_TRUE(Y_value.IsTensor());
+    auto count = Y_value.GetTensorTypeAndShapeInfo().GetElementCount();
+    ASSERT_EQ(expected_y.size(), count);
+    const float* values = Y_value.GetTensorData<float>();
+    ASSERT_TRUE(std::equal(values, values + count, std::begin(expected_y)));
+  }
+
+  // pre-allocated outputs
+  {
+    std::array<float, 3 * 2> y_values;
+    Ort::Value y = Ort::Value::CreateTensor(info_cpu, y_values.data(), y_values.size(),
+                                            x_shape.data(), x_shape.size());
+    session.Run(Ort::RunOptions(), prepared_run, &x, 1, &y, 1);
+    ASSERT_TRUE(std::equal(std::begin(y_values), std::end(y_values), std::begin(expected_y)));
+  }
+
+  // invalid names are reported when the PreparedRun is created
+  {
+    const char* invalid_names[] = {"Z"};
+    try {
+      Ort::PreparedRun invalid_prepared_run(session, invalid_names, 1, output_names, 1);
+      FAIL() << "Creating a PreparedRun with an invalid input name should have failed";
+    } catch (const Ort::Exception& e) {
+      ASSERT_EQ(e.GetOrtErrorCode(), ORT_INVALID_ARGUMENT);
+    }
+  }
+}
+
+TEST(CApiTest, run_async) {
+  Ort::MemoryInfo info_cpu = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemTypeDefault);
+
+  const std::array<int64_t, 2> x_shape = {3, 2};
+  std::array<float, 3 * 2> x_values = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f};
+  Ort::Value x = Ort::Value::CreateTensor(info_cpu, x_values.data(), x_values.size(),
+                                          x_shape.data(), x_shape.size());
+  const std::array<float, 3 * 2> expected_y = {1.0f, 4.0f, 9.0f, 16.0f, 25.0f, 36.0f};
+
+  const char* input_names[] = {"X"};
+  const char* output_names[] = {"Y"};
+
+  // runs on the intra op thread pool, returning futures
+  {
+    Ort::SessionOptions session_options;
+    session_options.SetIntraOpNumThreads(2);
+    Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+    std::vector<std::future<std::vector<Ort::Value>>> futures;
+    for (int i = 0; i < 4; ++i) {
+      futures.push_back(session.RunAsync(Ort::RunOptions(), input_names, &x, 1, output_names, 1));
+    }
+
+    for (auto& future : futures) {
+      std::vector<Ort::Value> output_values = future.get();
+      ASSERT_EQ(output_values.size(), 1U);
+      const float* values = output_values[0].GetTensorData<float>();
+      ASSERT_TRUE(std::equal(values, values + expected_y.size(), std::begin(expected_y)));
+    }
+  }
+
+  // runs on a dedicated thread pool with at most one run in flight, calling a callback
+  {
+    Ort::SessionOptions session_options;
+    session_options.SetIntraOpNumThreads(1);
+    session_options.AddConfigEntry(kOrtSessionOptionsConfigAsyncRunNumThreads, "2");
+    session_options.AddConfigEntry(kOrtSessionOptionsConfigAsyncRunMaxInFlight, "1");
+    Ort::Session session(*ort_env, MODEL_URI, session_options);
+
+    struct RunResult {
+      std::atomic<int> num_completed{0};
+      std::atomic<int> num_failed{0};
+    } result;
+
+    RunAsyncCallbackFn callback = [](void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status) {
+      auto& run_result = *static_cast<RunResult*>(user_data);
+      Ort::Status run_status{status};
+      if (!run_status.IsOK() || num_outputs != 1) {
+        ++run_result.num_failed;
+      } else {
+        Ort::Value y{outputs[0]};
+        if (y.GetTensorData<float>()[5] != 36.0f) {
+          ++run_result.num_failed;
+        }
+      }
+
+      ++run_result.num_completed;
+    };
+
+    for (int i = 0; i < 4; ++i) {
+      Ort::Value y{nullptr};
+      session.RunAsync(Ort::RunOptions(), input_names, &x, 1, output_names, &y, 1, callback, &result);
+    }
+
+    // a run is no longer in flight when its callback is called, so the last callbacks may still be running
+    while (result.num_completed.load() < 4) {
+      std::this_thread::yield();
+    }
+
+    ASSERT_EQ(result.num_failed.load(), 0);
+  }
+
+  // the callback releases the session from the thread of the pool that executed the run
+  for (const char* num_threads : {"1", "0"}) {
+    Ort::SessionOptions session_options;
+    session_options.SetIntraOpNumThreads(2);
+    session_options.AddConfigEntry(kOrtSessionOptionsConfigAsyncRunNumThreads, num_threads);
+
+    struct ReleaseResult {
+      std::unique_ptr<Ort::Session> session;
+      std::atomic<bool> queued{false};
+      std::promise<bool> released;
+    } result;
+    result.session = std::make_unique<Ort::Session>(*ort_env, MODEL_URI, session_options);
+
+    RunAsyncCallbackFn callback = [](void* user_data, OrtValue** outputs, size_t num_outputs, OrtStatusPtr status) {
+      auto& release_result = *static_cast<ReleaseResult*>(user_data);
+      Ort::Status run_status{status};
+      for (size_t i = 0; i < num_outputs; ++i) {
+        Ort::Value output{outputs[i]};
+      }
+      // RunAsync must have returned before the session is released
+      while (!release_result.queued.load()) {
+        std::this_thread::yield();
+      }
+      release_result.session.reset();
+      release_result.released.set_value(run_status.IsOK());
+    };
+
+    std::future<bool> released = result.released.get_future();
+    Ort::Value y{nullptr};
+    result.session->RunAsync(Ort::RunOptions(), input_names, &x, 1, output_names, &y, 1, callback, &result);
+    result.queued = true;
+    ASSERT_EQ(released.wait_for(std::chrono::seconds(60)), std::future_status::ready);
+    ASSERT_TRUE(released.get());
+  }
+
+  // without a thread to execute the run
+  {
+    Ort::SessionOptions session_options;
+    session_options.SetIntraOpNumThreads(1);
+    Ort::Session session(*ort_env, MODEL_URI, session_options);
+    try {
+      session.RunAsync(Ort::RunOptions(), input_names, &x, 1, output_names, 1);
+      FAIL() << "RunAsync should have failed without a thread pool to run on";
+    } catch (const Ort::Exception& e) {
+      ASSERT_EQ(e.GetOrtErrorCode(), ORT_FAIL);
+    }
+  }
+}
+
 #if defined(USE_CUDA) || defined(USE_TENSORRT)
 TEST(CApiTest, io_binding_cuda) {
   Ort::SessionOptions session_options;